@@ -0,0 +1,63 @@
+# Profile-guided optimization support.
+#
+# CONTOUR_PGO selects the build phase:
+#
+#   OFF       - regular build (default)
+#   generate  - instrumented build; running any binary drops raw profiles
+#               into CONTOUR_PGO_PROFILE_DIR
+#   use       - optimized build consuming the profiles trained before,
+#               additionally enabling LTO when the toolchain supports it
+#
+# The two phases are orchestrated by scripts/pgo-build.sh, which trains the
+# instrumented binaries on bench-headless workloads plus any PTY stream
+# recordings found in test/pgo-corpus/ (see the README there). With Clang
+# the raw profiles are merged via llvm-profdata into
+# ${CONTOUR_PGO_PROFILE_DIR}/contour.profdata; GCC reads its .gcda files
+# from the profile directory directly.
+
+set(CONTOUR_PGO "OFF" CACHE STRING "Profile-guided optimization phase: OFF, generate, use")
+set_property(CACHE CONTOUR_PGO PROPERTY STRINGS OFF generate use)
+set(CONTOUR_PGO_PROFILE_DIR "${CMAKE_BINARY_DIR}/pgo-profiles" CACHE PATH
+    "Directory the instrumented binaries write their profiles to and the optimized build reads them from.")
+
+if(NOT CONTOUR_PGO STREQUAL "OFF")
+    file(MAKE_DIRECTORY "${CONTOUR_PGO_PROFILE_DIR}")
+
+    if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+        if(CONTOUR_PGO STREQUAL "generate")
+            add_compile_options(-fprofile-instr-generate=${CONTOUR_PGO_PROFILE_DIR}/%m.profraw)
+            add_link_options(-fprofile-instr-generate=${CONTOUR_PGO_PROFILE_DIR}/%m.profraw)
+        else()
+            add_compile_options(
+                -fprofile-instr-use=${CONTOUR_PGO_PROFILE_DIR}/contour.profdata
+                -Wno-profile-instr-unprofiled
+                -Wno-profile-instr-out-of-date)
+            add_link_options(-fprofile-instr-use=${CONTOUR_PGO_PROFILE_DIR}/contour.profdata)
+        endif()
+    elseif(CMAKE_CXX_COMPILER_ID MATCHES "GNU")
+        if(CONTOUR_PGO STREQUAL "generate")
+            add_compile_options(-fprofile-generate=${CONTOUR_PGO_PROFILE_DIR})
+            add_link_options(-fprofile-generate=${CONTOUR_PGO_PROFILE_DIR})
+        else()
+            add_compile_options(
+                -fprofile-use=${CONTOUR_PGO_PROFILE_DIR}
+                -fprofile-correction
+                -Wno-missing-profile)
+            add_link_options(-fprofile-use=${CONTOUR_PGO_PROFILE_DIR})
+        endif()
+    else()
+        message(FATAL_ERROR "CONTOUR_PGO is only supported with GCC or Clang (have: ${CMAKE_CXX_COMPILER_ID}).")
+    endif()
+
+    if(CONTOUR_PGO STREQUAL "use")
+        include(CheckIPOSupported)
+        check_ipo_supported(RESULT CONTOUR_PGO_IPO_SUPPORTED OUTPUT CONTOUR_PGO_IPO_ERROR)
+        if(CONTOUR_PGO_IPO_SUPPORTED)
+            set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+        else()
+            message(STATUS "[PGO] LTO not supported, building with PGO only: ${CONTOUR_PGO_IPO_ERROR}")
+        endif()
+    endif()
+
+    message(STATUS "[PGO] phase: ${CONTOUR_PGO}, profile directory: ${CONTOUR_PGO_PROFILE_DIR}")
+endif()
@@ -0,0 +1,66 @@
+#! /usr/bin/env python3
+# Compares two crispy_bench JSON outputs and fails on performance regressions.
+#
+# Usage: compare-benchmarks.py BASELINE.json CURRENT.json [--threshold PERCENT]
+#
+# Record a baseline on a quiet machine:
+#     ./crispy_bench > baseline.json
+# and gate a change against it:
+#     ./crispy_bench > current.json
+#     scripts/compare-benchmarks.py baseline.json current.json
+#
+# Exits non-zero if any benchmark's ns/op worsened by more than the threshold
+# (default: 10%). Benchmarks present in only one of the two files are reported
+# but do not fail the comparison.
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        doc = json.load(f)
+    return {b["name"]: b for b in doc["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare two crispy_bench runs.")
+    parser.add_argument("baseline", help="JSON output of the baseline run")
+    parser.add_argument("current", help="JSON output of the run to check")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="maximum tolerated ns/op increase in percent (default: 10)")
+    args = parser.parse_args()
+
+    baseline = load(args.baseline)
+    current = load(args.current)
+
+    regressions = []
+    name_width = max(len(name) for name in baseline.keys() | current.keys())
+    print(f"{'benchmark':<{name_width}}  {'baseline':>12}  {'current':>12}  {'delta':>8}")
+
+    for name in sorted(baseline.keys() | current.keys()):
+        if name not in baseline:
+            print(f"{name:<{name_width}}  {'-':>12}  {current[name]['ns_per_op']:>10.2f}ns  {'new':>8}")
+            continue
+        if name not in current:
+            print(f"{name:<{name_width}}  {baseline[name]['ns_per_op']:>10.2f}ns  {'-':>12}  {'gone':>8}")
+            continue
+
+        old = baseline[name]["ns_per_op"]
+        new = current[name]["ns_per_op"]
+        delta = (new - old) / old * 100.0
+        marker = " <-- REGRESSION" if delta > args.threshold else ""
+        print(f"{name:<{name_width}}  {old:>10.2f}ns  {new:>10.2f}ns  {delta:>+7.1f}%{marker}")
+        if delta > args.threshold:
+            regressions.append(name)
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) regressed by more than "
+              f"{args.threshold:.1f}%: {', '.join(regressions)}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,67 @@
+#!/usr/bin/env bash
+#
+# Two-phase profile-guided optimization build.
+#
+# Phase 1 builds bench-headless with instrumentation (CONTOUR_PGO=generate)
+# and trains it on representative VT workloads: the synthetic termbench
+# streams (short lines, long lines, SGR-heavy) plus every PTY stream
+# recording found in test/pgo-corpus/ (vim session, htop, colored build
+# log, ... - see test/pgo-corpus/README.md for how to capture them).
+#
+# Phase 2 merges the profiles and rebuilds everything with
+# CONTOUR_PGO=use, which also turns on LTO where supported.
+#
+# Usage: scripts/pgo-build.sh [source-dir] [extra cmake args...]
+
+set -e
+
+SOURCE_DIR="${1:-$(pwd)}"
+shift || true
+
+TRAIN_BUILD_DIR="${SOURCE_DIR}/build-pgo-generate"
+FINAL_BUILD_DIR="${SOURCE_DIR}/build-pgo-use"
+PROFILE_DIR="${TRAIN_BUILD_DIR}/pgo-profiles"
+CORPUS_DIR="${SOURCE_DIR}/test/pgo-corpus"
+NPROC=$(nproc 2>/dev/null || sysctl -n hw.ncpu)
+
+# Phase 1: instrumented build of the headless trainer (no GUI needed).
+cmake -S "${SOURCE_DIR}" -B "${TRAIN_BUILD_DIR}" \
+    -DCMAKE_BUILD_TYPE=Release \
+    -DCONTOUR_PGO=generate \
+    -DCONTOUR_PGO_PROFILE_DIR="${PROFILE_DIR}" \
+    -DCONTOUR_FRONTEND_GUI=OFF \
+    -DCONTOUR_TESTING=ON \
+    "$@"
+cmake --build "${TRAIN_BUILD_DIR}" -j"${NPROC}" --target bench-headless
+
+BENCH="${TRAIN_BUILD_DIR}/src/terminal/bench-headless"
+
+# Training: synthetic termbench streams through parser and full screen.
+"${BENCH}" parser size 16
+"${BENCH}" grid size 16
+
+# Training: captured real-world recordings, if any are present.
+if [ -d "${CORPUS_DIR}" ]; then
+    for recording in "${CORPUS_DIR}"/*.vtr; do
+        [ -e "${recording}" ] || continue
+        echo "Replaying corpus recording: ${recording}"
+        "${BENCH}" replay file "${recording}"
+    done
+fi
+
+# Merge raw profiles (Clang only; GCC reads its .gcda files directly).
+if ls "${PROFILE_DIR}"/*.profraw >/dev/null 2>&1; then
+    LLVM_PROFDATA=$(command -v llvm-profdata)
+    "${LLVM_PROFDATA}" merge -output="${PROFILE_DIR}/contour.profdata" "${PROFILE_DIR}"/*.profraw
+fi
+
+# Phase 2: optimized build consuming the trained profiles.
+cmake -S "${SOURCE_DIR}" -B "${FINAL_BUILD_DIR}" \
+    -DCMAKE_BUILD_TYPE=Release \
+    -DCONTOUR_PGO=use \
+    -DCONTOUR_PGO_PROFILE_DIR="${PROFILE_DIR}" \
+    "$@"
+cmake --build "${FINAL_BUILD_DIR}" -j"${NPROC}"
+
+echo
+echo "PGO build finished: ${FINAL_BUILD_DIR}"
@@ -73,9 +73,11 @@ optional<Action> fromString(string const& _name)
         mapAction<actions::ScrollToBottom>("ScrollToBottom"),
         mapAction<actions::ScrollToTop>("ScrollToTop"),
         mapAction<actions::ScrollUp>("ScrollUp"),
+        mapAction<actions::SelectPerformancePreset>("SelectPerformancePreset"),
         mapAction<actions::SendChars>("SendChars"),
         mapAction<actions::ToggleAllKeyMaps>("ToggleAllKeyMaps"),
         mapAction<actions::ToggleFullscreen>("ToggleFullscreen"),
+        mapAction<actions::ToggleStatisticsOverlay>("ToggleStatisticsOverlay"),
         mapAction<actions::WriteScreen>("WriteScreen"),
     };
 
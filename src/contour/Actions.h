@@ -53,9 +53,11 @@ struct ScrollPageUp{};
 struct ScrollToBottom{};
 struct ScrollToTop{};
 struct ScrollUp{};
+struct SelectPerformancePreset{ std::string name; };
 struct SendChars{ std::string chars; };
 struct ToggleAllKeyMaps{};
 struct ToggleFullscreen{};
+struct ToggleStatisticsOverlay{};
 struct WriteScreen{ std::string chars; }; // "\033[2J\033[3J"
 // CloseTab
 // FocusNextTab
@@ -93,9 +95,11 @@ using Action = std::variant<CancelSelection,
                             ScrollToBottom,
                             ScrollToTop,
                             ScrollUp,
+                            SelectPerformancePreset,
                             SendChars,
                             ToggleAllKeyMaps,
                             ToggleFullscreen,
+                            ToggleStatisticsOverlay,
                             WriteScreen>;
 
 std::optional<Action> fromString(std::string const& _name);
@@ -152,9 +156,11 @@ DECLARE_ACTION_FMT(ScrollPageUp)
 DECLARE_ACTION_FMT(ScrollToBottom)
 DECLARE_ACTION_FMT(ScrollToTop)
 DECLARE_ACTION_FMT(ScrollUp)
+DECLARE_ACTION_FMT(SelectPerformancePreset)
 DECLARE_ACTION_FMT(SendChars)
 DECLARE_ACTION_FMT(ToggleAllKeyMaps)
 DECLARE_ACTION_FMT(ToggleFullscreen)
+DECLARE_ACTION_FMT(ToggleStatisticsOverlay)
 DECLARE_ACTION_FMT(WriteScreen)
 // }}}
 #undef DECLARE_ACTION_FMT
@@ -209,9 +215,11 @@ struct formatter<contour::actions::Action>
         HANDLE_ACTION(ScrollToBottom);
         HANDLE_ACTION(ScrollToTop);
         HANDLE_ACTION(ScrollUp);
+        HANDLE_ACTION(SelectPerformancePreset);
         HANDLE_ACTION(SendChars);
         HANDLE_ACTION(ToggleAllKeyMaps);
         HANDLE_ACTION(ToggleFullscreen);
+        HANDLE_ACTION(ToggleStatisticsOverlay);
         HANDLE_ACTION(WriteScreen);
         // }}}
         return format_to(ctx.out(), "UNKNOWN ACTION");
@@ -13,6 +13,8 @@
  */
 #include "Config.h"
 
+#include <contour/ConfigCache.h>
+
 #include <terminal/ControlCode.h>
 #include <terminal/InputGenerator.h>
 #include <terminal/Process.h>
@@ -71,6 +73,10 @@ namespace contour::config
 namespace
 {
     auto const ConfigLog = logstore::Category("config", "Logs configuration file loading.");
+
+    // Non-null while the YAML pass is running, recording every file being
+    // read so the resulting Config can be cached keyed by their hashes.
+    ConfigCacheCollector* configCacheCollector = nullptr;
 }
 
 using actions::Action;
@@ -712,6 +718,17 @@ namespace // {{{ helper
                 return action;
         }
 
+        if (holds_alternative<actions::SelectPerformancePreset>(action))
+        {
+            if (auto name = _parent["name"]; name.IsScalar())
+            {
+                _usedKeys.emplace(_prefix + ".name");
+                return actions::SelectPerformancePreset { name.as<string>() };
+            }
+            else
+                return nullopt;
+        }
+
         if (holds_alternative<actions::SendChars>(action))
         {
             if (auto chars = _parent["chars"]; chars.IsScalar())
@@ -934,6 +951,8 @@ terminal::ColorPalette loadColorScheme(UsedKeys& _usedKeys, string const& _path,
     // TODO: color palette from 16..255
     // TODO: dim _node (maybe put them into the palette at 256..(256+8)?)
 
+    colors.updateRenderColors();
+
     float opacityValue = 1.0;
     tryLoadValue(_usedKeys, _node, "background_image.opacity", opacityValue);
 
@@ -1084,6 +1103,8 @@ TerminalProfile loadTerminalProfile(UsedKeys& _usedKeys,
                 auto fileContents = readFile(filePath);
                 if (!fileContents)
                     continue;
+                if (configCacheCollector)
+                    configCacheCollector->add(filePath, fileContents.value());
                 YAML::Node subDocument = YAML::Load(fileContents.value());
                 UsedKeys usedColorKeys;
                 profile.colors = loadColorScheme(usedColorKeys, "", subDocument);
@@ -1117,6 +1138,9 @@ TerminalProfile loadTerminalProfile(UsedKeys& _usedKeys,
     tryLoadChild(_usedKeys, _doc, basePath, "fullscreen", profile.fullscreen);
     tryLoadChild(_usedKeys, _doc, basePath, "refresh_rate", profile.refreshRate);
     tryLoadChild(_usedKeys, _doc, basePath, "copy_last_mark_range_offset", profile.copyLastMarkRangeOffset);
+    tryLoadChild(_usedKeys, _doc, basePath, "echo_prediction", profile.echoPrediction);
+    tryLoadChild(_usedKeys, _doc, basePath, "visual_bell", profile.visualBell);
+    tryLoadChild(_usedKeys, _doc, basePath, "dim_when_inactive", profile.dimWhenInactive);
 
     tryLoadChild(_usedKeys, _doc, basePath, "wm_class", profile.wmClass);
 
@@ -1393,6 +1417,9 @@ TerminalProfile loadTerminalProfile(UsedKeys& _usedKeys,
 
     tryLoadChild(_usedKeys, _doc, basePath, "history.auto_scroll_on_update", profile.autoScrollOnUpdate);
     tryLoadChild(_usedKeys, _doc, basePath, "history.scroll_multiplier", profile.historyScrollMultiplier);
+    tryLoadChild(_usedKeys, _doc, basePath, "history.persistent", profile.persistentHistory);
+
+    tryLoadChild(_usedKeys, _doc, basePath, "mouse.max_report_rate", profile.maxMouseReportRate);
 
     float floatValue = 1.0;
     tryLoadChild(_usedKeys, _doc, basePath, "background.opacity", floatValue);
@@ -1428,11 +1455,52 @@ TerminalProfile loadTerminalProfile(UsedKeys& _usedKeys,
 /**
  * @return success or failure of loading the config file.
  */
+unordered_map<string, PerformancePreset> defaultPerformancePresets()
+{
+    auto presets = unordered_map<string, PerformancePreset> {};
+
+    // Conserves power: halved frame rate cap, small atlas caches, compact
+    // scrollback storage.
+    presets["battery"] = PerformancePreset { 30.0,
+                                             crispy::StrongHashtableSize { 2048 },
+                                             crispy::LRUCapacity { 2000 },
+                                             true };
+
+    // The stock configuration's defaults.
+    presets["balanced"] = PerformancePreset {};
+
+    // Big-display workstations: generous atlas caches and no scrollback
+    // compression, trading memory for speed.
+    presets["throughput"] = PerformancePreset { 0.0,
+                                                crispy::StrongHashtableSize { 8192 },
+                                                crispy::LRUCapacity { 8000 },
+                                                false };
+
+    return presets;
+}
+
 void loadConfigFromFile(Config& _config, FileSystem::path const& _fileName)
 {
     LOGSTORE(ConfigLog)("Loading configuration from file: {}", _fileName.string());
     _config.backingFilePath = _fileName;
     createFileIfNotExists(_config.backingFilePath);
+
+    // Fast path: skip the YAML pass entirely if a compiled cache exists whose
+    // recorded input files all still hash to the values seen at write time.
+    if (auto cached = tryLoadCachedConfig(_fileName); cached.has_value())
+    {
+        _config = std::move(cached.value());
+        return;
+    }
+
+    auto cacheCollector = ConfigCacheCollector {};
+    if (auto contents = readFile(_fileName); contents.has_value())
+        cacheCollector.add(_fileName, contents.value());
+    else
+        cacheCollector.cacheable = false;
+    configCacheCollector = &cacheCollector;
+    auto const collectorGuard = crispy::finally { [&]() { configCacheCollector = nullptr; } };
+
     auto usedKeys = UsedKeys {};
 
     YAML::Node doc = YAML::LoadFile(_fileName.string());
@@ -1497,6 +1565,7 @@ void loadConfigFromFile(Config& _config, FileSystem::path const& _fileName)
     }
 
     tryLoadValue(usedKeys, doc, "spawn_new_process", _config.spawnNewProcess);
+    tryLoadValue(usedKeys, doc, "warm_window_pool", _config.warmWindowPool);
 
     tryLoadValue(usedKeys, doc, "images.sixel_scrolling", _config.sixelScrolling);
     tryLoadValue(usedKeys, doc, "images.sixel_cursor_conformance", _config.sixelCursorConformance);
@@ -1531,9 +1600,72 @@ void loadConfigFromFile(Config& _config, FileSystem::path const& _fileName)
             errorlog()("Unknown renderer: {}.", renderingBackendStr);
     }
 
+    string pixelFormatStr;
+    if (tryLoadValue(usedKeys, doc, "renderer.pixel_format", pixelFormatStr))
+    {
+        pixelFormatStr = toUpper(pixelFormatStr);
+        if (pixelFormatStr == "RGB10")
+            _config.outputPixelFormat = OutputPixelFormat::TenBit;
+        else if (pixelFormatStr == "FP16")
+            _config.outputPixelFormat = OutputPixelFormat::HalfFloat;
+        else if (pixelFormatStr != "" && pixelFormatStr != "DEFAULT")
+            errorlog()("Unknown renderer pixel format: {}.", pixelFormatStr);
+    }
+
     tryLoadValue(usedKeys, doc, "renderer.tile_hashtable_slots", _config.textureAtlasHashtableSlots.value);
     tryLoadValue(usedKeys, doc, "renderer.tile_cache_count", _config.textureAtlasTileCount.value);
     tryLoadValue(usedKeys, doc, "renderer.tile_direct_mapping", _config.textureAtlasDirectMapping);
+    tryLoadValue(usedKeys, doc, "renderer.direct_vertex_mapping", _config.directVertexMapping);
+
+    auto maxGpuTextureMemoryMB = _config.maxGpuTextureMemory / (1024 * 1024);
+    tryLoadValue(usedKeys, doc, "renderer.max_gpu_texture_memory_mb", maxGpuTextureMemoryMB);
+    _config.maxGpuTextureMemory = maxGpuTextureMemoryMB * 1024 * 1024;
+
+    if (auto prewarm = doc["renderer"]["prewarm_atlas"]; prewarm && prewarm.IsSequence())
+    {
+        usedKeys.emplace("renderer.prewarm_atlas");
+        _config.atlasPrewarm.clear();
+        for (size_t i = 0; i < prewarm.size(); ++i)
+            _config.atlasPrewarm.emplace_back(prewarm[i].as<string>());
+    }
+
+    auto const loadCpuAffinity = [&](string const& _key, vector<unsigned>& _store) {
+        auto const node = doc["cpu_affinity"][_key];
+        if (!node)
+            return;
+        usedKeys.emplace("cpu_affinity." + _key);
+        _store.clear();
+        if (node.IsSequence())
+            for (size_t i = 0; i < node.size(); ++i)
+                _store.emplace_back(node[i].as<unsigned>());
+        else
+            _store.emplace_back(node.as<unsigned>());
+    };
+    if (doc["cpu_affinity"])
+    {
+        usedKeys.emplace("cpu_affinity");
+        loadCpuAffinity("vt_thread", _config.vtThreadCpuAffinity);
+        loadCpuAffinity("render_thread", _config.renderThreadCpuAffinity);
+    }
+
+    if (auto presets = doc["performance_presets"]; presets.IsMap())
+    {
+        usedKeys.emplace("performance_presets");
+        for (auto i = presets.begin(); i != presets.end(); ++i)
+        {
+            auto const name = i->first.as<string>();
+            auto const path = "performance_presets." + name;
+            usedKeys.emplace(path);
+
+            // Starts off the built-in preset of the same name (if any), so a
+            // configuration file may override individual knobs only.
+            auto& preset = _config.performancePresets[name];
+            tryLoadChild(usedKeys, doc, path, "refresh_rate", preset.refreshRate);
+            tryLoadChild(usedKeys, doc, path, "tile_hashtable_slots", preset.textureAtlasHashtableSlots.value);
+            tryLoadChild(usedKeys, doc, path, "tile_cache_count", preset.textureAtlasTileCount.value);
+            tryLoadChild(usedKeys, doc, path, "compress_scrollback", preset.compressScrollback);
+        }
+    }
 
     if (doc["mock_font_locator"].IsSequence())
     {
@@ -1550,6 +1682,10 @@ void loadConfigFromFile(Config& _config, FileSystem::path const& _fileName)
             registry.emplace_back(move(fds));
         }
         text::mock_font_locator::configure(move(registry));
+        // This registration is a side effect that cannot be replayed from a
+        // serialized Config, so such configurations are parsed every time.
+        if (configCacheCollector)
+            configCacheCollector->cacheable = false;
     }
 
     tryLoadValue(usedKeys, doc, "read_buffer_size", _config.ptyReadBufferSize);
@@ -1559,6 +1695,8 @@ void loadConfigFromFile(Config& _config, FileSystem::path const& _fileName)
         LOGSTORE(ConfigLog)("read_buffer_size must be a multiple of 16.");
     }
 
+    tryLoadValue(usedKeys, doc, "pty_parse_ahead_limit", _config.ptyParseAheadLimit);
+
     tryLoadValue(usedKeys, doc, "reflow_on_resize", _config.reflowOnResize);
 
     if (auto profiles = doc["profiles"]; profiles)
@@ -1590,8 +1728,12 @@ void loadConfigFromFile(Config& _config, FileSystem::path const& _fileName)
                 parseInputMapping(usedKeys, prefix, _config, mapping[i]);
             }
     }
+    _config.inputMappings.compile();
 
     checkForSuperfluousKeys(doc, usedKeys);
+
+    if (cacheCollector.cacheable)
+        writeConfigCache(_config, cacheCollector.dependencies);
 }
 
 optional<std::string> readConfigFile(std::string const& _filename)
@@ -68,11 +68,68 @@ using KeyInputMapping = terminal::InputBinding<terminal::Key, ActionList>;
 using CharInputMapping = terminal::InputBinding<char32_t, ActionList>;
 using MouseInputMapping = terminal::InputBinding<terminal::MouseButton, ActionList>;
 
+/// Lookup index over one kind of input bindings, compiled once after the
+/// configuration has been loaded.
+///
+/// Bindings are bucketed by (input, modifier), preserving declaration order
+/// within a bucket so first-match semantics are kept. Each binding's
+/// tri-state match modes are folded into a (mask, value) pair, reducing the
+/// per-keystroke mode test to a single masked comparison. The index stores
+/// positions rather than pointers into the source vector, so copying a
+/// Config does not invalidate it.
+template <typename Input>
+struct InputBindingIndex
+{
+    struct Candidate
+    {
+        uint8_t modeMask = 0;  // mode flags this binding constrains
+        uint8_t modeValue = 0; // required state of the constrained flags
+        uint32_t bindingIndex = 0;
+    };
+
+    std::unordered_map<uint64_t, std::vector<Candidate>> buckets;
+
+    // Number of bindings the index was compiled from; used to detect a
+    // stale index when the bindings were mutated after compilation.
+    size_t compiledCount = 0;
+
+    static uint64_t makeKey(Input _input, terminal::Modifier _modifier) noexcept
+    {
+        return static_cast<uint64_t>(_input) << 8 | _modifier.value();
+    }
+
+    void compile(std::vector<terminal::InputBinding<Input, ActionList>> const& _mappings)
+    {
+        buckets.clear();
+        for (size_t i = 0; i < _mappings.size(); ++i)
+        {
+            auto const& mapping = _mappings[i];
+            auto const modeMask =
+                static_cast<uint8_t>(mapping.modes.enabled() | mapping.modes.disabled());
+            auto const modeValue = static_cast<uint8_t>(mapping.modes.enabled());
+            buckets[makeKey(mapping.input, mapping.modifier)].push_back(
+                Candidate { modeMask, modeValue, static_cast<uint32_t>(i) });
+        }
+        compiledCount = _mappings.size();
+    }
+};
+
 struct InputMappings
 {
     std::vector<KeyInputMapping> keyMappings;
     std::vector<CharInputMapping> charMappings;
     std::vector<MouseInputMapping> mouseMappings;
+
+    InputBindingIndex<terminal::Key> keyIndex;
+    InputBindingIndex<char32_t> charIndex;
+    InputBindingIndex<terminal::MouseButton> mouseIndex;
+
+    void compile()
+    {
+        keyIndex.compile(keyMappings);
+        charIndex.compile(charMappings);
+        mouseIndex.compile(mouseMappings);
+    }
 };
 
 namespace helper
@@ -124,6 +181,28 @@ std::vector<actions::Action> const* apply(
     return nullptr;
 }
 
+template <typename Input>
+std::vector<actions::Action> const* apply(
+    std::vector<terminal::InputBinding<Input, ActionList>> const& _mappings,
+    InputBindingIndex<Input> const& _index,
+    Input _input,
+    terminal::Modifier _modifier,
+    uint8_t _actualModeFlags)
+{
+    if (_index.compiledCount != _mappings.size())
+        return apply(_mappings, _input, _modifier, _actualModeFlags);
+
+    auto const bucket = _index.buckets.find(InputBindingIndex<Input>::makeKey(_input, _modifier));
+    if (bucket == _index.buckets.end())
+        return nullptr;
+
+    for (auto const& candidate: bucket->second)
+        if ((_actualModeFlags & candidate.modeMask) == candidate.modeValue)
+            return &_mappings[candidate.bindingIndex].binding;
+
+    return nullptr;
+}
+
 using opengl::ShaderConfig;
 
 struct TerminalProfile
@@ -134,6 +213,20 @@ struct TerminalProfile
     double refreshRate = 0.0; // 0=auto
     terminal::LineOffset copyLastMarkRangeOffset = terminal::LineOffset(0);
 
+    // Whether or not to render plain printable keystrokes immediately in a
+    // provisional style before the application's echo arrives (useful on
+    // high-latency links).
+    bool echoPrediction = false;
+
+    // Whether BEL briefly flashes the view. Implemented as a tint over the
+    // finished frame in the render backend's output pass, so neither the
+    // render buffer nor the grid are touched.
+    bool visualBell = false;
+
+    // Whether the view is dimmed while the window is unfocused (same
+    // output-pass tint mechanism as the visual bell).
+    bool dimWhenInactive = false;
+
     std::string wmClass;
 
     terminal::PageSize terminalSize = { terminal::LineCount(10), terminal::ColumnCount(40) };
@@ -141,6 +234,16 @@ struct TerminalProfile
 
     terminal::LineCount maxHistoryLineCount;
     terminal::LineCount historyScrollMultiplier;
+
+    // Whether or not to save the scrollback as plain text when the session
+    // closes and to restore it on the next start of the same profile.
+    bool persistentHistory = false;
+
+    // Maximum rate (reports per second) at which mouse-motion reports are
+    // forwarded to the application; 0 keeps them bound to the display's
+    // frame rate only. Button transitions and the final position are always
+    // delivered.
+    int maxMouseReportRate = 0;
     ScrollBarPosition scrollbarPosition = ScrollBarPosition::Right;
     bool hideScrollbarInAltScreen = true;
 
@@ -181,6 +284,41 @@ enum class RenderingBackend
     OpenGL,
 };
 
+/// Pixel format requested for the output surface (and matched by the
+/// renderer's internal scratch surfaces, so no conversion blit sneaks in).
+enum class OutputPixelFormat
+{
+    Default,   //!< whatever the windowing system hands out (8 bpc)
+    TenBit,    //!< 10-bit color channels, 2-bit alpha (HDR10-class displays)
+    HalfFloat, //!< half-float channels (scRGB-style HDR surfaces)
+};
+
+/// Bundle of performance-relevant knobs, switchable at runtime as a whole via
+/// the SelectPerformancePreset input action (no restart required), so one
+/// configuration file can serve both battery-powered laptops and 4K
+/// workstations.
+///
+/// Presets named "battery", "balanced" and "throughput" are built in (see
+/// defaultPerformancePresets()) and may be overridden or extended in the
+/// `performance_presets` configuration section.
+struct PerformancePreset
+{
+    /// Frame rate cap; 0 follows the display's refresh rate.
+    double refreshRate = 0.0;
+
+    /// Texture atlas dimensioning; see Config::textureAtlasHashtableSlots
+    /// and Config::textureAtlasTileCount. Applying these rebuilds the atlas.
+    crispy::StrongHashtableSize textureAtlasHashtableSlots = crispy::StrongHashtableSize { 4096 };
+    crispy::LRUCapacity textureAtlasTileCount = crispy::LRUCapacity { 4000 };
+
+    /// Whether lines entering the scrollback are demoted to their compact
+    /// storage form; disabling trades memory for scrollback access speed.
+    bool compressScrollback = true;
+};
+
+/// Built-in performance presets ("battery", "balanced", "throughput").
+std::unordered_map<std::string, PerformancePreset> defaultPerformancePresets();
+
 // NB: All strings in here must be UTF8-encoded.
 struct Config
 {
@@ -192,9 +330,21 @@ struct Config
 
     RenderingBackend renderingBackend = RenderingBackend::Default;
 
+    OutputPixelFormat outputPixelFormat = OutputPixelFormat::Default;
+
     /// Enables/disables support for direct mapped texture atlas tiles (e.g. glyphs).
     bool textureAtlasDirectMapping = true;
 
+    /// Experimental: builds the text vertex stream directly inside the mapped
+    /// GPU vertex buffer rather than in a host-side staging vector that is
+    /// uploaded afterwards, saving one full-frame copy per frame.
+    bool directVertexMapping = false;
+
+    /// CPU ids to pin the VT thread / the render (GUI) thread onto.
+    /// Empty means no pinning. Linux-only; ignored on other platforms.
+    std::vector<unsigned> vtThreadCpuAffinity {};
+    std::vector<unsigned> renderThreadCpuAffinity {};
+
     // Number of hashtable slots to map to the texture tiles.
     // Larger values may increase performance, but too large may also decrease.
     // This value is rounted up to a value equal to the power of two.
@@ -209,12 +359,44 @@ struct Config
     /// This value is automatically adjusted if too small.
     crispy::LRUCapacity textureAtlasTileCount = crispy::LRUCapacity { 4000 };
 
+    /// Per-window GPU texture memory budget in bytes. The texture atlas tile
+    /// count is clamped down if the resulting atlas texture would exceed this
+    /// bound, keeping worst-case VRAM usage bounded per window.
+    ///
+    /// Default: 64 MiB.
+    size_t maxGpuTextureMemory = 64u * 1024 * 1024;
+
+    /// Codepoint sequences (UTF-8) to shape and rasterize into the glyph
+    /// atlas at startup, so their first on-screen occurrence does not stall
+    /// a frame on fallback-font probing and color-glyph rasterization.
+    /// Emoji presentation and ZWJ sequences benefit the most; an empty list
+    /// disables the pre-warm.
+    std::vector<std::string> atlasPrewarm {
+        "\U0001F600",             // grinning face
+        "\U0001F602",             // face with tears of joy
+        "\U0001F44D",             // thumbs up
+        "\U00002764\U0000FE0F",   // red heart (emoji presentation)
+        "\U0001F389",             // party popper
+        "\U0001F525",             // fire
+        "\U00002705",             // check mark button
+        "\U0001F680",             // rocket
+        "\U0001F468\U0000200D\U0001F4BB", // man technologist (ZWJ)
+        "\U0001F469\U0000200D\U0001F4BB", // woman technologist (ZWJ)
+    };
+
     // Configures the size of the PTY read buffer.
     // Changing this value may result in better or worse throughput performance.
     //
     // This value must be integer-devisable by 16.
     int ptyReadBufferSize = 16384;
 
+    // Maximum number of PTY bytes parsed ahead of the most recently composed
+    // frame before PTY consumption is paused, leaving the kernel-side buffer
+    // to backpressure the application. Bounds output-to-screen staleness.
+    //
+    // A value of 0 disables the limit (unbounded parse-ahead).
+    size_t ptyParseAheadLimit = 1024 * 1024;
+
     bool reflowOnResize = true;
 
     std::unordered_map<std::string, terminal::ColorPalette> colorschemes;
@@ -238,6 +420,17 @@ struct Config
     TerminalProfile& profile() noexcept { return *profile(defaultProfileName); }
     TerminalProfile const& profile() const noexcept { return *profile(defaultProfileName); }
 
+    /// Performance presets by name; pre-seeded with the built-in ones,
+    /// which the configuration file may override or extend.
+    std::unordered_map<std::string, PerformancePreset> performancePresets = defaultPerformancePresets();
+
+    PerformancePreset const* performancePreset(std::string const& _name) const
+    {
+        if (auto i = performancePresets.find(_name); i != performancePresets.end())
+            return &i->second;
+        return nullptr;
+    }
+
     // selection
     std::string wordDelimiters;
     terminal::Modifier bypassMouseProtocolModifier = terminal::Modifier::Shift;
@@ -249,6 +442,12 @@ struct Config
 
     bool spawnNewProcess = false;
 
+    /// Keeps one fully initialized terminal window (including its shell
+    /// process) pre-spawned and hidden, so opening a new window merely shows
+    /// it. New windows then start in the default working directory instead of
+    /// inheriting the current session's one.
+    bool warmWindowPool = false;
+
     bool sixelScrolling = true;
     bool sixelCursorConformance = true;
     terminal::ImageSize maxImageSize = {}; // default to runtime system screen size.
@@ -0,0 +1,1192 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <contour/ConfigCache.h>
+
+#include <terminal/InputGenerator.h>
+#include <terminal/Process.h>
+
+#include <crispy/hash.h>
+#include <crispy/logstore.h>
+#include <crispy/overloaded.h>
+
+#include <fmt/format.h>
+
+#include <QtCore/QString>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <variant>
+
+using namespace std;
+
+namespace contour::config
+{
+
+namespace
+{
+    auto const CacheLog = logstore::Category("config.cache", "Logs the compiled configuration cache.");
+
+    // Bump whenever the serialized layout of Config (or any type reachable
+    // from it) changes; stale blobs then simply miss and get rewritten.
+    auto constexpr CacheVersion = uint32_t { 12 };
+    auto constexpr CacheMagic = string_view { "contour-config-cache" };
+
+    uint64_t hashContent(string_view _text)
+    {
+        return crispy::hash(_text);
+    }
+
+    optional<string> readFile(FileSystem::path const& _path)
+    {
+        if (!FileSystem::exists(_path))
+            return nullopt;
+
+        auto ifs = ifstream(_path.string(), ios::binary);
+        if (!ifs.good())
+            return nullopt;
+
+        auto const size = FileSystem::file_size(_path);
+        auto text = string {};
+        text.resize(size);
+        ifs.read(text.data(), static_cast<streamsize>(size));
+        return { text };
+    }
+
+    // {{{ binary writer / reader
+    // Little-endian, bounds-checked on read. Any structural mismatch flips
+    // the ok flag and the whole blob is treated as a cache miss; the cache
+    // never has to be correct, only never wrong.
+    struct Writer
+    {
+        string out;
+        bool ok = true;
+
+        void u8(uint8_t _value) { out.push_back(static_cast<char>(_value)); }
+
+        void u32(uint32_t _value)
+        {
+            for (int i = 0; i < 4; ++i)
+                u8(static_cast<uint8_t>(_value >> (8 * i)));
+        }
+
+        void u64(uint64_t _value)
+        {
+            for (int i = 0; i < 8; ++i)
+                u8(static_cast<uint8_t>(_value >> (8 * i)));
+        }
+
+        void f64(double _value)
+        {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &_value, sizeof(bits));
+            u64(bits);
+        }
+
+        void str(string_view _value)
+        {
+            u64(_value.size());
+            out.append(_value.data(), _value.size());
+        }
+    };
+
+    struct Reader
+    {
+        string_view in;
+        size_t pos = 0;
+        bool ok = true;
+
+        uint8_t u8()
+        {
+            if (pos >= in.size())
+            {
+                ok = false;
+                return 0;
+            }
+            return static_cast<uint8_t>(in[pos++]);
+        }
+
+        uint32_t u32()
+        {
+            auto value = uint32_t {};
+            for (int i = 0; i < 4; ++i)
+                value |= static_cast<uint32_t>(u8()) << (8 * i);
+            return value;
+        }
+
+        uint64_t u64()
+        {
+            auto value = uint64_t {};
+            for (int i = 0; i < 8; ++i)
+                value |= static_cast<uint64_t>(u8()) << (8 * i);
+            return value;
+        }
+
+        double f64()
+        {
+            auto const bits = u64();
+            double value = 0;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        string str()
+        {
+            auto const size = u64();
+            if (!ok || in.size() - pos < size)
+            {
+                ok = false;
+                return {};
+            }
+            auto value = string(in.substr(pos, size));
+            pos += size;
+            return value;
+        }
+
+        /// Upper bound for any element count yet to be read; everything
+        /// serializes to at least one byte, so any count beyond this is a
+        /// corrupt blob and must not drive an allocation.
+        bool plausibleCount(uint64_t _count) const noexcept { return _count <= in.size() - pos; }
+
+        bool atEnd() const noexcept { return pos == in.size(); }
+    };
+    // }}}
+
+    // {{{ save/load prototypes
+    // One save/load pair per type reachable from Config. Declared up front
+    // so the container templates below can serialize any element type.
+    template <typename T, enable_if_t<is_integral_v<T>, int> = 0>
+    void save(Writer&, T);
+    template <typename T, enable_if_t<is_integral_v<T>, int> = 0>
+    void load(Reader&, T&);
+    template <typename T, enable_if_t<is_enum_v<T>, int> = 0>
+    void save(Writer&, T);
+    template <typename T, enable_if_t<is_enum_v<T>, int> = 0>
+    void load(Reader&, T&);
+    void save(Writer&, double);
+    void load(Reader&, double&);
+    void save(Writer&, string const&);
+    void load(Reader&, string&);
+    void save(Writer&, QString const&);
+    void load(Reader&, QString&);
+    void save(Writer&, FileSystem::path const&);
+    void load(Reader&, FileSystem::path&);
+    void save(Writer&, chrono::milliseconds);
+    void load(Reader&, chrono::milliseconds&);
+    template <typename T, typename Tag>
+    void save(Writer&, crispy::boxed<T, Tag> const&);
+    template <typename T, typename Tag>
+    void load(Reader&, crispy::boxed<T, Tag>&);
+    void save(Writer&, crispy::StrongHashtableSize);
+    void load(Reader&, crispy::StrongHashtableSize&);
+    void save(Writer&, crispy::LRUCapacity);
+    void load(Reader&, crispy::LRUCapacity&);
+    void save(Writer&, crispy::ImageSize);
+    void load(Reader&, crispy::ImageSize&);
+    void save(Writer&, terminal::PageSize);
+    void load(Reader&, terminal::PageSize&);
+
+    template <typename T>
+    void save(Writer&, optional<T> const&);
+    template <typename T>
+    void load(Reader&, optional<T>&);
+    template <typename T>
+    void save(Writer&, vector<T> const&);
+    template <typename T>
+    void load(Reader&, vector<T>&);
+    void save(Writer&, set<string> const&);
+    void load(Reader&, set<string>&);
+    void save(Writer&, map<string, string> const&);
+    void load(Reader&, map<string, string>&);
+    template <typename T>
+    void save(Writer&, unordered_map<string, T> const&);
+    template <typename T>
+    void load(Reader&, unordered_map<string, T>&);
+
+    void save(Writer&, terminal::RGBColor);
+    void load(Reader&, terminal::RGBColor&);
+    void save(Writer&, terminal::CellRGBColor const&);
+    void load(Reader&, terminal::CellRGBColor&);
+    void save(Writer&, terminal::CursorColor const&);
+    void load(Reader&, terminal::CursorColor&);
+    void save(Writer&, shared_ptr<terminal::BackgroundImage const> const&);
+    void load(Reader&, shared_ptr<terminal::BackgroundImage const>&);
+    void save(Writer&, terminal::ColorPalette const&);
+    void load(Reader&, terminal::ColorPalette&);
+
+    void save(Writer&, text::font_feature);
+    void load(Reader&, vector<text::font_feature>&);
+    void save(Writer&, text::font_description const&);
+    void load(Reader&, text::font_description&);
+    void save(Writer&, text::font_size);
+    void load(Reader&, text::font_size&);
+    void save(Writer&, text::DPI);
+    void load(Reader&, text::DPI&);
+    void save(Writer&, terminal::renderer::FontDescriptions const&);
+    void load(Reader&, terminal::renderer::FontDescriptions&);
+
+    void save(Writer&, ShaderConfig const&);
+    void load(Reader&, ShaderConfig&);
+    void save(Writer&, terminal::Process::ExecInfo const&);
+    void load(Reader&, terminal::Process::ExecInfo&);
+
+    void save(Writer&, terminal::MatchModes);
+    void load(Reader&, terminal::MatchModes&);
+    void save(Writer&, terminal::Modifier);
+    void load(Reader&, terminal::Modifier&);
+    void save(Writer&, actions::Action const&);
+    void load(Reader&, actions::Action&);
+    template <typename Input>
+    void save(Writer&, terminal::InputBinding<Input, ActionList> const&);
+    template <typename Input>
+    void load(Reader&, terminal::InputBinding<Input, ActionList>&);
+    void save(Writer&, InputMappings const&);
+    void load(Reader&, InputMappings&);
+
+    void save(Writer&, TerminalProfile const&);
+    void load(Reader&, TerminalProfile&);
+    void save(Writer&, PerformancePreset const&);
+    void load(Reader&, PerformancePreset&);
+    void save(Writer&, Config const&);
+    void load(Reader&, Config&);
+    // }}}
+
+    // {{{ primitives
+    template <typename T, enable_if_t<is_integral_v<T>, int>>
+    void save(Writer& _writer, T _value)
+    {
+        _writer.u64(static_cast<uint64_t>(static_cast<int64_t>(_value)));
+    }
+
+    template <typename T, enable_if_t<is_integral_v<T>, int>>
+    void load(Reader& _reader, T& _value)
+    {
+        _value = static_cast<T>(static_cast<int64_t>(_reader.u64()));
+    }
+
+    template <typename T, enable_if_t<is_enum_v<T>, int>>
+    void save(Writer& _writer, T _value)
+    {
+        _writer.u32(static_cast<uint32_t>(_value));
+    }
+
+    template <typename T, enable_if_t<is_enum_v<T>, int>>
+    void load(Reader& _reader, T& _value)
+    {
+        _value = static_cast<T>(_reader.u32());
+    }
+
+    void save(Writer& _writer, double _value)
+    {
+        _writer.f64(_value);
+    }
+
+    void load(Reader& _reader, double& _value)
+    {
+        _value = _reader.f64();
+    }
+
+    void save(Writer& _writer, string const& _value)
+    {
+        _writer.str(_value);
+    }
+
+    void load(Reader& _reader, string& _value)
+    {
+        _value = _reader.str();
+    }
+
+    void save(Writer& _writer, QString const& _value)
+    {
+        _writer.str(_value.toStdString());
+    }
+
+    void load(Reader& _reader, QString& _value)
+    {
+        _value = QString::fromStdString(_reader.str());
+    }
+
+    void save(Writer& _writer, FileSystem::path const& _value)
+    {
+        _writer.str(_value.string());
+    }
+
+    void load(Reader& _reader, FileSystem::path& _value)
+    {
+        _value = FileSystem::path(_reader.str());
+    }
+
+    void save(Writer& _writer, chrono::milliseconds _value)
+    {
+        _writer.u64(static_cast<uint64_t>(_value.count()));
+    }
+
+    void load(Reader& _reader, chrono::milliseconds& _value)
+    {
+        _value = chrono::milliseconds(static_cast<int64_t>(_reader.u64()));
+    }
+
+    template <typename T, typename Tag>
+    void save(Writer& _writer, crispy::boxed<T, Tag> const& _value)
+    {
+        save(_writer, _value.value);
+    }
+
+    template <typename T, typename Tag>
+    void load(Reader& _reader, crispy::boxed<T, Tag>& _value)
+    {
+        load(_reader, _value.value);
+    }
+
+    void save(Writer& _writer, crispy::StrongHashtableSize _value)
+    {
+        _writer.u32(_value.value);
+    }
+
+    void load(Reader& _reader, crispy::StrongHashtableSize& _value)
+    {
+        _value.value = _reader.u32();
+    }
+
+    void save(Writer& _writer, crispy::LRUCapacity _value)
+    {
+        _writer.u32(_value.value);
+    }
+
+    void load(Reader& _reader, crispy::LRUCapacity& _value)
+    {
+        _value.value = _reader.u32();
+    }
+
+    void save(Writer& _writer, crispy::ImageSize _value)
+    {
+        save(_writer, _value.width);
+        save(_writer, _value.height);
+    }
+
+    void load(Reader& _reader, crispy::ImageSize& _value)
+    {
+        load(_reader, _value.width);
+        load(_reader, _value.height);
+    }
+
+    void save(Writer& _writer, terminal::PageSize _value)
+    {
+        save(_writer, _value.lines);
+        save(_writer, _value.columns);
+    }
+
+    void load(Reader& _reader, terminal::PageSize& _value)
+    {
+        load(_reader, _value.lines);
+        load(_reader, _value.columns);
+    }
+    // }}}
+
+    // {{{ containers
+    template <typename T>
+    void save(Writer& _writer, optional<T> const& _value)
+    {
+        _writer.u8(_value.has_value() ? 1 : 0);
+        if (_value.has_value())
+            save(_writer, _value.value());
+    }
+
+    template <typename T>
+    void load(Reader& _reader, optional<T>& _value)
+    {
+        if (_reader.u8())
+        {
+            _value.emplace();
+            load(_reader, _value.value());
+        }
+        else
+            _value.reset();
+    }
+
+    template <typename T>
+    void save(Writer& _writer, vector<T> const& _values)
+    {
+        _writer.u64(_values.size());
+        for (T const& value: _values)
+            save(_writer, value);
+    }
+
+    template <typename T>
+    void load(Reader& _reader, vector<T>& _values)
+    {
+        _values.clear();
+        auto const count = _reader.u64();
+        if (!_reader.plausibleCount(count))
+        {
+            _reader.ok = false;
+            return;
+        }
+        _values.resize(count);
+        for (T& value: _values)
+            load(_reader, value);
+    }
+
+    void save(Writer& _writer, set<string> const& _values)
+    {
+        _writer.u64(_values.size());
+        for (string const& value: _values)
+            _writer.str(value);
+    }
+
+    void load(Reader& _reader, set<string>& _values)
+    {
+        _values.clear();
+        auto const count = _reader.u64();
+        if (!_reader.plausibleCount(count))
+        {
+            _reader.ok = false;
+            return;
+        }
+        for (uint64_t i = 0; i < count; ++i)
+            _values.emplace(_reader.str());
+    }
+
+    void save(Writer& _writer, map<string, string> const& _values)
+    {
+        _writer.u64(_values.size());
+        for (auto const& [key, value]: _values)
+        {
+            _writer.str(key);
+            _writer.str(value);
+        }
+    }
+
+    void load(Reader& _reader, map<string, string>& _values)
+    {
+        _values.clear();
+        auto const count = _reader.u64();
+        if (!_reader.plausibleCount(count))
+        {
+            _reader.ok = false;
+            return;
+        }
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            auto key = _reader.str();
+            _values[std::move(key)] = _reader.str();
+        }
+    }
+
+    template <typename T>
+    void save(Writer& _writer, unordered_map<string, T> const& _values)
+    {
+        _writer.u64(_values.size());
+        for (auto const& [key, value]: _values)
+        {
+            _writer.str(key);
+            save(_writer, value);
+        }
+    }
+
+    template <typename T>
+    void load(Reader& _reader, unordered_map<string, T>& _values)
+    {
+        _values.clear();
+        auto const count = _reader.u64();
+        if (!_reader.plausibleCount(count))
+        {
+            _reader.ok = false;
+            return;
+        }
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            auto key = _reader.str();
+            load(_reader, _values[std::move(key)]);
+        }
+    }
+    // }}}
+
+    // {{{ colors
+    void save(Writer& _writer, terminal::RGBColor _value)
+    {
+        _writer.u8(_value.red);
+        _writer.u8(_value.green);
+        _writer.u8(_value.blue);
+    }
+
+    void load(Reader& _reader, terminal::RGBColor& _value)
+    {
+        _value.red = _reader.u8();
+        _value.green = _reader.u8();
+        _value.blue = _reader.u8();
+    }
+
+    void save(Writer& _writer, terminal::CellRGBColor const& _value)
+    {
+        _writer.u8(static_cast<uint8_t>(_value.index()));
+        if (auto const* rgb = get_if<terminal::RGBColor>(&_value))
+            save(_writer, *rgb);
+    }
+
+    void load(Reader& _reader, terminal::CellRGBColor& _value)
+    {
+        switch (_reader.u8())
+        {
+        case 0: {
+            auto color = terminal::RGBColor {};
+            load(_reader, color);
+            _value = color;
+            break;
+        }
+        case 1: _value = terminal::CellForegroundColor {}; break;
+        case 2: _value = terminal::CellBackgroundColor {}; break;
+        default: _reader.ok = false; break;
+        }
+    }
+
+    void save(Writer& _writer, terminal::CursorColor const& _value)
+    {
+        save(_writer, _value.color);
+        save(_writer, _value.textOverrideColor);
+    }
+
+    void load(Reader& _reader, terminal::CursorColor& _value)
+    {
+        load(_reader, _value.color);
+        load(_reader, _value.textOverrideColor);
+    }
+
+    void save(Writer& _writer, shared_ptr<terminal::BackgroundImage const> const& _value)
+    {
+        if (!_value)
+        {
+            _writer.u8(0);
+            return;
+        }
+        // Only path-based background images are cacheable; inline pixel data
+        // (not constructible from YAML anyway) voids the whole blob.
+        auto const* path = get_if<FileSystem::path>(&_value->location);
+        if (!path)
+        {
+            _writer.ok = false;
+            return;
+        }
+        _writer.u8(1);
+        save(_writer, *path);
+        _writer.f64(_value->opacity);
+        _writer.u8(_value->blur ? 1 : 0);
+    }
+
+    void load(Reader& _reader, shared_ptr<terminal::BackgroundImage const>& _value)
+    {
+        if (!_reader.u8())
+        {
+            _value.reset();
+            return;
+        }
+        auto path = FileSystem::path {};
+        load(_reader, path);
+        auto const fileName = path.string();
+
+        // Mirrors loadImage(): the hash is computed over the resolved path.
+        FileSystem::path resolvedFileName;
+        if (!fileName.empty() && fileName[0] == '~')
+            resolvedFileName = terminal::Process::homeDirectory() / fileName.substr(1);
+        else
+            resolvedFileName = path;
+
+        auto backgroundImage = terminal::BackgroundImage {};
+        backgroundImage.location = path;
+        backgroundImage.hash = crispy::StrongHash::compute(resolvedFileName.string());
+        backgroundImage.opacity = static_cast<float>(_reader.f64());
+        backgroundImage.blur = _reader.u8() != 0;
+        _value = make_shared<terminal::BackgroundImage const>(std::move(backgroundImage));
+    }
+
+    void save(Writer& _writer, terminal::ColorPalette const& _value)
+    {
+        for (terminal::RGBColor const color: _value.palette)
+            save(_writer, color);
+        save(_writer, _value.defaultForeground);
+        save(_writer, _value.defaultBackground);
+        save(_writer, _value.selectionForeground);
+        save(_writer, _value.selectionBackground);
+        save(_writer, _value.cursor);
+        save(_writer, _value.mouseForeground);
+        save(_writer, _value.mouseBackground);
+        save(_writer, _value.hyperlinkDecoration.normal);
+        save(_writer, _value.hyperlinkDecoration.hover);
+        save(_writer, _value.backgroundImage);
+    }
+
+    void load(Reader& _reader, terminal::ColorPalette& _value)
+    {
+        for (terminal::RGBColor& color: _value.palette)
+            load(_reader, color);
+        load(_reader, _value.defaultForeground);
+        load(_reader, _value.defaultBackground);
+        load(_reader, _value.selectionForeground);
+        load(_reader, _value.selectionBackground);
+        load(_reader, _value.cursor);
+        load(_reader, _value.mouseForeground);
+        load(_reader, _value.mouseBackground);
+        load(_reader, _value.hyperlinkDecoration.normal);
+        load(_reader, _value.hyperlinkDecoration.hover);
+        load(_reader, _value.backgroundImage);
+        _value.updateRenderColors();
+    }
+    // }}}
+
+    // {{{ fonts
+    void save(Writer& _writer, text::font_feature _value)
+    {
+        for (char const ch: _value.name)
+            _writer.u8(static_cast<uint8_t>(ch));
+    }
+
+    void load(Reader& _reader, vector<text::font_feature>& _values)
+    {
+        // dedicated overload: font_feature is not default-constructible
+        _values.clear();
+        auto const count = _reader.u64();
+        if (!_reader.plausibleCount(count))
+        {
+            _reader.ok = false;
+            return;
+        }
+        _values.reserve(count);
+        for (uint64_t i = 0; i < count; ++i)
+        {
+            auto const a = static_cast<char>(_reader.u8());
+            auto const b = static_cast<char>(_reader.u8());
+            auto const c = static_cast<char>(_reader.u8());
+            auto const d = static_cast<char>(_reader.u8());
+            _values.emplace_back(a, b, c, d);
+        }
+    }
+
+    void save(Writer& _writer, text::font_description const& _value)
+    {
+        // wFamilyName is only ever filled in by the DirectWrite shaper at
+        // runtime and thus intentionally not part of the blob.
+        save(_writer, _value.familyName);
+        save(_writer, _value.weight);
+        save(_writer, _value.slant);
+        save(_writer, _value.spacing);
+        _writer.u8(_value.strict_spacing ? 1 : 0);
+        save(_writer, _value.features);
+    }
+
+    void load(Reader& _reader, text::font_description& _value)
+    {
+        load(_reader, _value.familyName);
+        load(_reader, _value.weight);
+        load(_reader, _value.slant);
+        load(_reader, _value.spacing);
+        _value.strict_spacing = _reader.u8() != 0;
+        load(_reader, _value.features);
+    }
+
+    void save(Writer& _writer, text::font_size _value)
+    {
+        _writer.f64(_value.pt);
+    }
+
+    void load(Reader& _reader, text::font_size& _value)
+    {
+        _value.pt = _reader.f64();
+    }
+
+    void save(Writer& _writer, text::DPI _value)
+    {
+        save(_writer, _value.x);
+        save(_writer, _value.y);
+    }
+
+    void load(Reader& _reader, text::DPI& _value)
+    {
+        load(_reader, _value.x);
+        load(_reader, _value.y);
+    }
+
+    void save(Writer& _writer, terminal::renderer::FontDescriptions const& _value)
+    {
+        _writer.f64(_value.dpiScale);
+        save(_writer, _value.dpi);
+        save(_writer, _value.size);
+        save(_writer, _value.regular);
+        save(_writer, _value.bold);
+        save(_writer, _value.italic);
+        save(_writer, _value.boldItalic);
+        save(_writer, _value.emoji);
+        save(_writer, _value.renderMode);
+        save(_writer, _value.textShapingEngine);
+        save(_writer, _value.fontLocator);
+        _writer.u8(_value.builtinBoxDrawing ? 1 : 0);
+    }
+
+    void load(Reader& _reader, terminal::renderer::FontDescriptions& _value)
+    {
+        _value.dpiScale = _reader.f64();
+        load(_reader, _value.dpi);
+        load(_reader, _value.size);
+        load(_reader, _value.regular);
+        load(_reader, _value.bold);
+        load(_reader, _value.italic);
+        load(_reader, _value.boldItalic);
+        load(_reader, _value.emoji);
+        load(_reader, _value.renderMode);
+        load(_reader, _value.textShapingEngine);
+        load(_reader, _value.fontLocator);
+        _value.builtinBoxDrawing = _reader.u8() != 0;
+    }
+    // }}}
+
+    // {{{ shaders, shell
+    void save(Writer& _writer, ShaderConfig const& _value)
+    {
+        save(_writer, _value.vertexShader.location);
+        save(_writer, _value.vertexShader.contents);
+        save(_writer, _value.fragmentShader.location);
+        save(_writer, _value.fragmentShader.contents);
+    }
+
+    void load(Reader& _reader, ShaderConfig& _value)
+    {
+        load(_reader, _value.vertexShader.location);
+        load(_reader, _value.vertexShader.contents);
+        load(_reader, _value.fragmentShader.location);
+        load(_reader, _value.fragmentShader.contents);
+    }
+
+    void save(Writer& _writer, terminal::Process::ExecInfo const& _value)
+    {
+        save(_writer, _value.program);
+        save(_writer, _value.arguments);
+        save(_writer, _value.workingDirectory);
+        save(_writer, _value.env);
+    }
+
+    void load(Reader& _reader, terminal::Process::ExecInfo& _value)
+    {
+        load(_reader, _value.program);
+        load(_reader, _value.arguments);
+        load(_reader, _value.workingDirectory);
+        load(_reader, _value.env);
+    }
+    // }}}
+
+    // {{{ input mappings
+    void save(Writer& _writer, terminal::MatchModes _value)
+    {
+        _writer.u8(static_cast<uint8_t>(_value.enabled()));
+        _writer.u8(static_cast<uint8_t>(_value.disabled()));
+    }
+
+    void load(Reader& _reader, terminal::MatchModes& _value)
+    {
+        auto const enabled = _reader.u8();
+        auto const disabled = _reader.u8();
+        _value.reset();
+        auto constexpr Flags = array { terminal::MatchModes::AlternateScreen,
+                                       terminal::MatchModes::AppCursor,
+                                       terminal::MatchModes::AppKeypad,
+                                       terminal::MatchModes::Select };
+        for (auto const flag: Flags)
+        {
+            if (enabled & flag)
+                _value.enable(flag);
+            if (disabled & flag)
+                _value.disable(flag);
+        }
+    }
+
+    void save(Writer& _writer, terminal::Modifier _value)
+    {
+        _writer.u32(_value.value());
+    }
+
+    void load(Reader& _reader, terminal::Modifier& _value)
+    {
+        _value = terminal::Modifier(static_cast<terminal::Modifier::Key>(_reader.u32()));
+    }
+
+    // Actions without payload round-trip through their variant index alone.
+    template <typename T>
+    void loadActionPayload(Reader&, T&)
+    {
+    }
+
+    void loadActionPayload(Reader& _reader, actions::ChangeProfile& _action)
+    {
+        load(_reader, _action.name);
+    }
+
+    void loadActionPayload(Reader& _reader, actions::NewTerminal& _action)
+    {
+        load(_reader, _action.profileName);
+    }
+
+    void loadActionPayload(Reader& _reader, actions::ReloadConfig& _action)
+    {
+        load(_reader, _action.profileName);
+    }
+
+    void loadActionPayload(Reader& _reader, actions::SelectPerformancePreset& _action)
+    {
+        load(_reader, _action.name);
+    }
+
+    void loadActionPayload(Reader& _reader, actions::SendChars& _action)
+    {
+        load(_reader, _action.chars);
+    }
+
+    void loadActionPayload(Reader& _reader, actions::WriteScreen& _action)
+    {
+        load(_reader, _action.chars);
+    }
+
+    template <size_t I = 0>
+    void loadActionAt(Reader& _reader, actions::Action& _action, size_t _index)
+    {
+        if constexpr (I < variant_size_v<actions::Action>)
+        {
+            if (_index == I)
+            {
+                auto value = variant_alternative_t<I, actions::Action> {};
+                loadActionPayload(_reader, value);
+                _action = value;
+            }
+            else
+                loadActionAt<I + 1>(_reader, _action, _index);
+        }
+        else
+            _reader.ok = false;
+    }
+
+    void save(Writer& _writer, actions::Action const& _value)
+    {
+        _writer.u32(static_cast<uint32_t>(_value.index()));
+        visit(overloaded {
+                  [&](actions::ChangeProfile const& _action) { save(_writer, _action.name); },
+                  [&](actions::NewTerminal const& _action) { save(_writer, _action.profileName); },
+                  [&](actions::ReloadConfig const& _action) { save(_writer, _action.profileName); },
+                  [&](actions::SelectPerformancePreset const& _action) { save(_writer, _action.name); },
+                  [&](actions::SendChars const& _action) { save(_writer, _action.chars); },
+                  [&](actions::WriteScreen const& _action) { save(_writer, _action.chars); },
+                  [&](auto const&) {},
+              },
+              _value);
+    }
+
+    void load(Reader& _reader, actions::Action& _value)
+    {
+        loadActionAt(_reader, _value, _reader.u32());
+    }
+
+    template <typename Input>
+    void save(Writer& _writer, terminal::InputBinding<Input, ActionList> const& _value)
+    {
+        save(_writer, _value.modes);
+        save(_writer, _value.modifier);
+        save(_writer, _value.input);
+        save(_writer, _value.binding);
+    }
+
+    template <typename Input>
+    void load(Reader& _reader, terminal::InputBinding<Input, ActionList>& _value)
+    {
+        load(_reader, _value.modes);
+        load(_reader, _value.modifier);
+        load(_reader, _value.input);
+        load(_reader, _value.binding);
+    }
+
+    void save(Writer& _writer, InputMappings const& _value)
+    {
+        save(_writer, _value.keyMappings);
+        save(_writer, _value.charMappings);
+        save(_writer, _value.mouseMappings);
+    }
+
+    void load(Reader& _reader, InputMappings& _value)
+    {
+        load(_reader, _value.keyMappings);
+        load(_reader, _value.charMappings);
+        load(_reader, _value.mouseMappings);
+        // The lookup index is not serialized but rebuilt from the bindings.
+        _value.compile();
+    }
+    // }}}
+
+    // {{{ profile and top-level config
+    void save(Writer& _writer, TerminalProfile const& _value)
+    {
+        save(_writer, _value.shell);
+        _writer.u8(_value.maximized ? 1 : 0);
+        _writer.u8(_value.fullscreen ? 1 : 0);
+        _writer.f64(_value.refreshRate);
+        save(_writer, _value.copyLastMarkRangeOffset);
+        _writer.u8(_value.echoPrediction ? 1 : 0);
+        save(_writer, _value.wmClass);
+        save(_writer, _value.terminalSize);
+        save(_writer, _value.terminalId);
+        save(_writer, _value.maxHistoryLineCount);
+        save(_writer, _value.historyScrollMultiplier);
+        _writer.u8(_value.persistentHistory ? 1 : 0);
+        save(_writer, _value.scrollbarPosition);
+        _writer.u8(_value.hideScrollbarInAltScreen ? 1 : 0);
+        _writer.u8(_value.autoScrollOnUpdate ? 1 : 0);
+        save(_writer, _value.fonts);
+        save(_writer, _value.permissions.captureBuffer);
+        save(_writer, _value.permissions.changeFont);
+        save(_writer, _value.colors);
+        save(_writer, _value.cursorShape);
+        save(_writer, _value.cursorDisplay);
+        save(_writer, _value.cursorBlinkInterval);
+        save(_writer, _value.backgroundOpacity);
+        _writer.u8(_value.backgroundBlur ? 1 : 0);
+        save(_writer, _value.backgroundShader);
+        save(_writer, _value.backgroundImageShader);
+        save(_writer, _value.textShader);
+        save(_writer, _value.hyperlinkDecoration.normal);
+        save(_writer, _value.hyperlinkDecoration.hover);
+        _writer.u8(_value.visualBell ? 1 : 0);
+        _writer.u8(_value.dimWhenInactive ? 1 : 0);
+        save(_writer, _value.maxMouseReportRate);
+    }
+
+    void load(Reader& _reader, TerminalProfile& _value)
+    {
+        load(_reader, _value.shell);
+        _value.maximized = _reader.u8() != 0;
+        _value.fullscreen = _reader.u8() != 0;
+        _value.refreshRate = _reader.f64();
+        load(_reader, _value.copyLastMarkRangeOffset);
+        _value.echoPrediction = _reader.u8() != 0;
+        load(_reader, _value.wmClass);
+        load(_reader, _value.terminalSize);
+        load(_reader, _value.terminalId);
+        load(_reader, _value.maxHistoryLineCount);
+        load(_reader, _value.historyScrollMultiplier);
+        _value.persistentHistory = _reader.u8() != 0;
+        load(_reader, _value.scrollbarPosition);
+        _value.hideScrollbarInAltScreen = _reader.u8() != 0;
+        _value.autoScrollOnUpdate = _reader.u8() != 0;
+        load(_reader, _value.fonts);
+        load(_reader, _value.permissions.captureBuffer);
+        load(_reader, _value.permissions.changeFont);
+        load(_reader, _value.colors);
+        load(_reader, _value.cursorShape);
+        load(_reader, _value.cursorDisplay);
+        load(_reader, _value.cursorBlinkInterval);
+        load(_reader, _value.backgroundOpacity);
+        _value.backgroundBlur = _reader.u8() != 0;
+        load(_reader, _value.backgroundShader);
+        load(_reader, _value.backgroundImageShader);
+        load(_reader, _value.textShader);
+        load(_reader, _value.hyperlinkDecoration.normal);
+        load(_reader, _value.hyperlinkDecoration.hover);
+        _value.visualBell = _reader.u8() != 0;
+        _value.dimWhenInactive = _reader.u8() != 0;
+        load(_reader, _value.maxMouseReportRate);
+    }
+
+    void save(Writer& _writer, PerformancePreset const& _value)
+    {
+        _writer.f64(_value.refreshRate);
+        save(_writer, _value.textureAtlasHashtableSlots);
+        save(_writer, _value.textureAtlasTileCount);
+        _writer.u8(_value.compressScrollback ? 1 : 0);
+    }
+
+    void load(Reader& _reader, PerformancePreset& _value)
+    {
+        _value.refreshRate = _reader.f64();
+        load(_reader, _value.textureAtlasHashtableSlots);
+        load(_reader, _value.textureAtlasTileCount);
+        _value.compressScrollback = _reader.u8() != 0;
+    }
+
+    void save(Writer& _writer, Config const& _value)
+    {
+        // backingFilePath is deliberately not serialized; the loader knows
+        // which file it asked the cache for.
+        save(_writer, _value.platformPlugin);
+        save(_writer, _value.renderingBackend);
+        _writer.u8(_value.textureAtlasDirectMapping ? 1 : 0);
+        save(_writer, _value.textureAtlasHashtableSlots);
+        save(_writer, _value.textureAtlasTileCount);
+        save(_writer, _value.ptyReadBufferSize);
+        save(_writer, _value.ptyParseAheadLimit);
+        _writer.u8(_value.reflowOnResize ? 1 : 0);
+        save(_writer, _value.colorschemes);
+        save(_writer, _value.profiles);
+        save(_writer, _value.defaultProfileName);
+        save(_writer, _value.wordDelimiters);
+        save(_writer, _value.bypassMouseProtocolModifier);
+        save(_writer, _value.onMouseSelection);
+        save(_writer, _value.mouseBlockSelectionModifier);
+        save(_writer, _value.inputMappings);
+        _writer.u8(_value.spawnNewProcess ? 1 : 0);
+        _writer.u8(_value.warmWindowPool ? 1 : 0);
+        _writer.u8(_value.sixelScrolling ? 1 : 0);
+        _writer.u8(_value.sixelCursorConformance ? 1 : 0);
+        save(_writer, _value.maxImageSize);
+        save(_writer, _value.maxImageColorRegisters);
+        save(_writer, _value.experimentalFeatures);
+        save(_writer, _value.performancePresets);
+        save(_writer, _value.vtThreadCpuAffinity);
+        save(_writer, _value.renderThreadCpuAffinity);
+        save(_writer, _value.outputPixelFormat);
+        _writer.u8(_value.directVertexMapping ? 1 : 0);
+        save(_writer, _value.maxGpuTextureMemory);
+        save(_writer, _value.atlasPrewarm);
+    }
+
+    void load(Reader& _reader, Config& _value)
+    {
+        load(_reader, _value.platformPlugin);
+        load(_reader, _value.renderingBackend);
+        _value.textureAtlasDirectMapping = _reader.u8() != 0;
+        load(_reader, _value.textureAtlasHashtableSlots);
+        load(_reader, _value.textureAtlasTileCount);
+        load(_reader, _value.ptyReadBufferSize);
+        load(_reader, _value.ptyParseAheadLimit);
+        _value.reflowOnResize = _reader.u8() != 0;
+        load(_reader, _value.colorschemes);
+        load(_reader, _value.profiles);
+        load(_reader, _value.defaultProfileName);
+        load(_reader, _value.wordDelimiters);
+        load(_reader, _value.bypassMouseProtocolModifier);
+        load(_reader, _value.onMouseSelection);
+        load(_reader, _value.mouseBlockSelectionModifier);
+        load(_reader, _value.inputMappings);
+        _value.spawnNewProcess = _reader.u8() != 0;
+        _value.warmWindowPool = _reader.u8() != 0;
+        _value.sixelScrolling = _reader.u8() != 0;
+        _value.sixelCursorConformance = _reader.u8() != 0;
+        load(_reader, _value.maxImageSize);
+        load(_reader, _value.maxImageColorRegisters);
+        load(_reader, _value.experimentalFeatures);
+        load(_reader, _value.performancePresets);
+        load(_reader, _value.vtThreadCpuAffinity);
+        load(_reader, _value.renderThreadCpuAffinity);
+        load(_reader, _value.outputPixelFormat);
+        _value.directVertexMapping = _reader.u8() != 0;
+        load(_reader, _value.maxGpuTextureMemory);
+        load(_reader, _value.atlasPrewarm);
+    }
+    // }}}
+} // namespace
+
+void ConfigCacheCollector::add(FileSystem::path const& _path, string_view _contents)
+{
+    dependencies.emplace_back(ConfigCacheDependency { _path, hashContent(_contents) });
+}
+
+FileSystem::path configCacheFilePath(FileSystem::path const& _configFile)
+{
+    // Keyed by the absolute path of the configuration file, so distinct
+    // configuration files map to distinct cache blobs.
+    auto ec = error_code {};
+    auto const canonicalPath = FileSystem::weakly_canonical(_configFile, ec);
+    auto const pathText = (ec ? _configFile : canonicalPath).string();
+    return configHome("contour") / "cache" / fmt::format("{:016x}.cfg", hashContent(pathText));
+}
+
+optional<Config> tryLoadCachedConfig(FileSystem::path const& _configFile)
+{
+    auto const cacheFile = configCacheFilePath(_configFile);
+    auto const blob = readFile(cacheFile);
+    if (!blob.has_value())
+        return nullopt;
+
+    if (blob->size() < CacheMagic.size() || string_view(blob->data(), CacheMagic.size()) != CacheMagic)
+        return nullopt;
+
+    auto reader = Reader { *blob, CacheMagic.size() };
+    if (reader.u32() != CacheVersion)
+        return nullopt;
+
+    // Revalidate all recorded inputs. Because the key covers every file the
+    // YAML pass read, any edit to any of them is a guaranteed cache miss.
+    auto const dependencyCount = reader.u64();
+    if (!reader.plausibleCount(dependencyCount))
+        return nullopt;
+    for (uint64_t i = 0; i < dependencyCount; ++i)
+    {
+        auto dependencyPath = FileSystem::path {};
+        load(reader, dependencyPath);
+        auto const expectedHash = reader.u64();
+        if (!reader.ok)
+            return nullopt;
+        auto const contents = readFile(dependencyPath);
+        if (!contents.has_value() || hashContent(*contents) != expectedHash)
+            return nullopt;
+    }
+
+    auto config = Config {};
+    load(reader, config);
+    if (!reader.ok || !reader.atEnd())
+        return nullopt;
+
+    config.backingFilePath = _configFile;
+    LOGSTORE(CacheLog)("Loaded configuration from cache: {}", cacheFile.string());
+    return { std::move(config) };
+}
+
+void writeConfigCache(Config const& _config, vector<ConfigCacheDependency> const& _dependencies)
+{
+    auto writer = Writer {};
+    writer.out.append(CacheMagic);
+    writer.u32(CacheVersion);
+    writer.u64(_dependencies.size());
+    for (ConfigCacheDependency const& dependency: _dependencies)
+    {
+        save(writer, dependency.path);
+        writer.u64(dependency.contentHash);
+    }
+    save(writer, _config);
+    if (!writer.ok)
+    {
+        LOGSTORE(CacheLog)("Configuration not serializable; skipping cache write.");
+        return;
+    }
+
+    auto const cacheFile = configCacheFilePath(_config.backingFilePath);
+    auto ec = error_code {};
+    FileSystem::create_directories(cacheFile.parent_path(), ec);
+
+    // Write to a temporary file first, so a concurrently starting instance
+    // never observes a partially written blob.
+    auto const tmpFile = cacheFile.string() + ".tmp";
+    auto ofs = ofstream(tmpFile, ios::binary | ios::trunc);
+    ofs.write(writer.out.data(), static_cast<streamsize>(writer.out.size()));
+    ofs.close();
+    if (!ofs)
+    {
+        LOGSTORE(CacheLog)("Could not write configuration cache: {}", tmpFile);
+        FileSystem::remove(tmpFile, ec);
+        return;
+    }
+    FileSystem::rename(tmpFile, cacheFile, ec);
+    if (ec)
+        LOGSTORE(CacheLog)("Could not move configuration cache into place: {}", ec.message());
+    else
+        LOGSTORE(CacheLog)("Wrote configuration cache: {}", cacheFile.string());
+}
+
+} // namespace contour::config
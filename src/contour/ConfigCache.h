@@ -0,0 +1,67 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <contour/Config.h>
+
+#include <crispy/stdfs.h>
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace contour::config
+{
+
+/// One input file the compiled configuration cache depends on,
+/// identified by its path and the hash of its contents at parse time.
+struct ConfigCacheDependency
+{
+    FileSystem::path path;
+    uint64_t contentHash;
+};
+
+/// Records every file the YAML pass reads (main configuration file plus
+/// any colorscheme includes), so the resulting cache blob can be keyed
+/// by the content hashes of all of its inputs.
+struct ConfigCacheCollector
+{
+    std::vector<ConfigCacheDependency> dependencies;
+
+    /// Some configuration constructs have side effects that cannot be
+    /// replayed from a serialized Config (such as mock_font_locator);
+    /// configurations using them are parsed on every startup.
+    bool cacheable = true;
+
+    void add(FileSystem::path const& _path, std::string_view _contents);
+};
+
+/// Returns the path the compiled cache blob for @p _configFile lives at.
+FileSystem::path configCacheFilePath(FileSystem::path const& _configFile);
+
+/// Attempts to load @p _configFile from its compiled cache.
+///
+/// Returns the deserialized Config iff a cache blob exists, carries the
+/// current format version and every recorded input file still hashes to
+/// the value recorded at write time. Returns std::nullopt otherwise, in
+/// which case the caller falls back to the regular YAML pass.
+std::optional<Config> tryLoadCachedConfig(FileSystem::path const& _configFile);
+
+/// Serializes @p _config into its compiled cache blob, keyed by the
+/// given dependency hashes. The cache is best-effort; failures are
+/// logged and otherwise ignored.
+void writeConfigCache(Config const& _config, std::vector<ConfigCacheDependency> const& _dependencies);
+
+} // namespace contour::config
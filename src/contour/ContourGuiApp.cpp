@@ -20,9 +20,12 @@
 
 #include <text_shaper/font_locator.h>
 
+#include <crispy/ThreadPool.h>
+#include <crispy/affinity.h>
 #include <crispy/logstore.h>
 
 #include <QtCore/QProcess>
+#include <QtCore/QTimer>
 #include <QtGui/QSurfaceFormat>
 #include <QtWidgets/QApplication>
 
@@ -259,6 +262,16 @@ int ContourGuiApp::terminalGuiAction()
     if (!loadConfig("terminal"))
         return EXIT_FAILURE;
 
+    // Size the process-wide worker pool once, before any subsystem
+    // (search, glyph cache persistence, ...) first reaches for it.
+    crispy::ThreadPool::initialize(crispy::ThreadPool::defaultConcurrency());
+
+    // QOpenGLWidget renders on the GUI thread, so pinning that thread covers
+    // rendering as well.
+    if (!config_.renderThreadCpuAffinity.empty()
+        && !crispy::pinCurrentThreadToCpus(config_.renderThreadCpuAffinity))
+        errorlog()("Failed to pin render thread onto configured CPU set.");
+
     switch (config_.renderingBackend)
     {
     case config::RenderingBackend::OpenGL:
@@ -307,11 +320,18 @@ int ContourGuiApp::terminalGuiAction()
     addQtArgIfSet("contour.terminal.display", "-display");
 #endif
 
+    // One shared GL context group for all windows: glyph atlas textures,
+    // linked shader programs and uploaded images then exist once per process
+    // instead of once per window. Both the attribute and the default surface
+    // format must be set before the QApplication is instantiated, as Qt
+    // creates the global share context during application startup.
+    QCoreApplication::setAttribute(Qt::AA_ShareOpenGLContexts);
+    QSurfaceFormat::setDefaultFormat(
+        contour::opengl::TerminalWidget::surfaceFormat(config_.outputPixelFormat));
+
     auto qtArgsCount = static_cast<int>(qtArgsPtr.size());
     QApplication app(qtArgsCount, (char**) qtArgsPtr.data());
 
-    QSurfaceFormat::setDefaultFormat(contour::opengl::TerminalWidget::surfaceFormat());
-
     // auto const HTS = "\033H";
     // auto const TBC = "\033[g";
     // printf("\r%s        %s                        %s\r", TBC, HTS, HTS);
@@ -319,8 +339,12 @@ int ContourGuiApp::terminalGuiAction()
     // Spawn initial window.
     newWindow();
 
+    if (config_.warmWindowPool)
+        scheduleWindowPoolRefill();
+
     auto rv = app.exec();
 
+    pooledWindow_.reset();
     terminalWindows_.clear();
 
     if (exitStatus_.has_value())
@@ -335,8 +359,43 @@ int ContourGuiApp::terminalGuiAction()
     return rv;
 }
 
+TerminalWindow* ContourGuiApp::showPooledWindow()
+{
+    auto window = std::move(pooledWindow_);
+    window->show();
+    terminalWindows_.emplace_back(move(window));
+    scheduleWindowPoolRefill();
+    return terminalWindows_.back().get();
+}
+
+void ContourGuiApp::scheduleWindowPoolRefill()
+{
+    // Deferred into the event loop, so the window just handed out gets onto
+    // the screen before we pay for constructing the next pre-warmed one.
+    QTimer::singleShot(0, [this]() { refillWindowPool(); });
+}
+
+void ContourGuiApp::refillWindowPool()
+{
+    if (!config_.warmWindowPool || pooledWindow_)
+        return;
+
+    auto const liveConfig = parameters().get<bool>("contour.terminal.live-config");
+    pooledWindow_ = make_unique<TerminalWindow>(
+        earlyExitThreshold(), config_, liveConfig, profileName(), argv_[0], *this);
+    // Stays hidden (including its already running shell) until newWindow()
+    // hands it out.
+}
+
 TerminalWindow* ContourGuiApp::newWindow(contour::config::Config const& _config)
 {
+    // A pooled window is already fully initialized, including its shell; it
+    // cannot adopt the working directory carried in _config anymore. Trading
+    // that inheritance for instant window appearance is what warm_window_pool
+    // opts into.
+    if (pooledWindow_)
+        return showPooledWindow();
+
     auto const liveConfig = parameters().get<bool>("contour.terminal.live-config");
     auto mainWindow =
         make_unique<TerminalWindow>(earlyExitThreshold(),
@@ -359,6 +418,9 @@ TerminalWindow* ContourGuiApp::newWindow(contour::config::Config const& _config)
 
 TerminalWindow* ContourGuiApp::newWindow()
 {
+    if (pooledWindow_)
+        return showPooledWindow();
+
     auto const liveConfig = parameters().get<bool>("contour.terminal.live-config");
     auto mainWindow = make_unique<TerminalWindow>(
         earlyExitThreshold(), config_, liveConfig, profileName(), argv_[0], *this);
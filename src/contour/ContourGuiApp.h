@@ -61,6 +61,11 @@ class ContourGuiApp: public ContourApp
     int terminalGuiAction();
     int fontConfigAction();
     std::chrono::seconds earlyExitThreshold() const;
+
+    TerminalWindow* showPooledWindow();
+    void scheduleWindowPoolRefill();
+    void refillWindowPool();
+
     config::Config config_;
 
     int argc_ = 0;
@@ -68,6 +73,10 @@ class ContourGuiApp: public ContourApp
     std::optional<terminal::Process::ExitStatus> exitStatus_;
 
     std::list<std::unique_ptr<TerminalWindow>> terminalWindows_;
+
+    /// Warm pool (see Config::warmWindowPool): one pre-initialized hidden
+    /// window, handed out by newWindow() and refilled via the event loop.
+    std::unique_ptr<TerminalWindow> pooledWindow_;
 };
 
 } // namespace contour
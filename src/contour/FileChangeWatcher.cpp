@@ -33,19 +33,65 @@ FileChangeWatcher::~FileChangeWatcher()
 
 void FileChangeWatcher::watch()
 {
+    // Time between polls while the file is quiet, and the shorter window a
+    // detected change must stay stable for before a notification is sent.
+    auto constexpr PollInterval = chrono::seconds(1);
+    auto constexpr SettleInterval = chrono::milliseconds(100);
+    auto constexpr SettleRounds = 10;
+
     auto lastWriteTime = FileSystem::last_write_time(filePath_);
+    auto erasedReported = false;
+
     while (!exit_)
     {
         if (!FileSystem::exists(filePath_))
-            notifier_(Event::Erased);
+        {
+            // Editors saving via temp+rename let the file vanish for a
+            // moment; treat it as erased only if it stays gone for a full
+            // settle window, and then report that once instead of per poll.
+            auto stillGone = true;
+            for (int i = 0; !exit_ && i < SettleRounds; ++i)
+            {
+                this_thread::sleep_for(SettleInterval);
+                if (FileSystem::exists(filePath_))
+                {
+                    stillGone = false;
+                    break;
+                }
+            }
+            if (stillGone)
+            {
+                if (!exit_ && !erasedReported)
+                {
+                    erasedReported = true;
+                    notifier_(Event::Erased);
+                }
+                this_thread::sleep_for(PollInterval);
+                continue;
+            }
+        }
+        erasedReported = false;
 
         auto lwt = FileSystem::last_write_time(filePath_);
         if (lwt != lastWriteTime)
         {
             lastWriteTime = lwt;
-            notifier_(Event::Modified);
+            // Debounce write bursts: editors typically issue several writes
+            // in quick succession; notify once the timestamp stopped moving.
+            while (!exit_)
+            {
+                this_thread::sleep_for(SettleInterval);
+                if (!FileSystem::exists(filePath_))
+                    break;
+                lwt = FileSystem::last_write_time(filePath_);
+                if (lwt == lastWriteTime)
+                    break;
+                lastWriteTime = lwt;
+            }
+            if (!exit_)
+                notifier_(Event::Modified);
         }
-        this_thread::sleep_for(1s);
+        this_thread::sleep_for(PollInterval);
     }
 }
 
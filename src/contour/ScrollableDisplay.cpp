@@ -81,7 +81,9 @@ void ScrollableDisplay::updateValues()
     if (!scrollBar_->isVisible())
         return;
 
-    scrollBar_->setMaximum(session_.terminal().screen().historyLineCount().as<int>());
+    // The snapshot is published wait-free by the VT thread; reading the
+    // screen directly here would require taking the terminal lock.
+    scrollBar_->setMaximum(session_.terminal().viewportSnapshot().historyLineCount.as<int>());
     auto const s = session_.terminal().viewport().scrollOffset();
     scrollBar_->setValue(scrollBar_->maximum() - s.value);
 }
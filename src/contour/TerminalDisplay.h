@@ -67,6 +67,8 @@ class TerminalDisplay
     virtual void resizeWindow(terminal::Width, terminal::Height) = 0;
     virtual void setBlurBehind(bool _enabled) = 0;
     virtual void setBackgroundImage(std::shared_ptr<terminal::BackgroundImage const> const&) = 0;
+    virtual void setAtlasCacheCapacity(crispy::StrongHashtableSize _hashtableSlots,
+                                       crispy::LRUCapacity _tileCount) = 0;
     virtual void setFonts(terminal::renderer::FontDescriptions _fontDescriptions) = 0;
     virtual void setHyperlinkDecoration(terminal::renderer::Decorator _normal,
                                         terminal::renderer::Decorator _hover) = 0;
@@ -19,7 +19,9 @@
 #include <terminal/Terminal.h>
 #include <terminal/pty/Pty.h>
 #include <terminal/pty/PtyProcess.h>
+#include <terminal/pty/ReadAheadPty.h>
 
+#include <crispy/App.h>
 #include <crispy/StackTrace.h>
 
 #include <range/v3/all.hpp>
@@ -40,6 +42,8 @@
 
 #include <algorithm>
 #include <fstream>
+#include <iterator>
+#include <system_error>
 
 #include <QtNetwork/QHostInfo>
 
@@ -70,6 +74,15 @@ namespace
         return fmt::format("{}: Unhandled exception caught ({}). {}", where, typeid(e).name(), e.what());
     }
 
+    unique_ptr<Pty> maybeWrapReadAhead(unique_ptr<Pty> _pty, config::Config const& _config)
+    {
+        if (!_config.experimentalFeatures.count("pty_read_ahead"))
+            return _pty;
+
+        LOGSTORE(SessionLog)("Enabling PTY read-ahead thread (experimental).");
+        return make_unique<terminal::ReadAheadPty>(move(_pty));
+    }
+
 } // namespace
 
 TerminalSession::TerminalSession(unique_ptr<Pty> _pty,
@@ -91,7 +104,7 @@ TerminalSession::TerminalSession(unique_ptr<Pty> _pty,
     app_ { _app },
     displayInitialized_ { move(_displayInitialized) },
     onExit_ { move(_onExit) },
-    pty_ { move(_pty) },
+    pty_ { maybeWrapReadAhead(move(_pty), config_) },
     terminal_ { *pty_,
                 config_.ptyReadBufferSize,
                 *this,
@@ -119,10 +132,14 @@ TerminalSession::TerminalSession(unique_ptr<Pty> _pty,
 
     profile_ = *config_.profile(profileName_); // XXX do it again. but we've to be more efficient here
     configureTerminal();
+    publishConfigSnapshot();
 }
 
 TerminalSession::~TerminalSession()
 {
+    if (profile_.persistentHistory)
+        saveHistory();
+
     (void)
         display_.release(); // TODO: due to Qt, this is currently not owned by us. That's sad, or is it not?
 }
@@ -133,6 +150,7 @@ void TerminalSession::setDisplay(unique_ptr<TerminalDisplay> _display)
     display_ = move(_display);
 
     profile_ = *config_.profile(profileName_); // XXX do it again. but we've to be more efficient here
+    publishConfigSnapshot();
 }
 
 void TerminalSession::displayInitialized()
@@ -152,9 +170,69 @@ void TerminalSession::displayInitialized()
 
 void TerminalSession::start()
 {
+    if (profile_.persistentHistory)
+        restoreHistory();
+
+    terminal().setMainLoopCpuAffinity(config_.vtThreadCpuAffinity);
     terminal().start();
 }
 
+FileSystem::path TerminalSession::historyFilePath() const
+{
+    return crispy::App::instance()->localStateDir() / "history" / (profileName_ + ".history");
+}
+
+void TerminalSession::restoreHistory()
+{
+    auto const path = historyFilePath();
+    auto in = ifstream(path.string(), ios::binary);
+    if (!in.good())
+        return;
+
+    auto const text = string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    LOGSTORE(SessionLog)
+    ("Restoring {} bytes of persisted session history from {}.", text.size(), path.string());
+    terminal_.writeToScreen(text);
+}
+
+void TerminalSession::saveHistory()
+{
+    if (historySaved_)
+        return;
+    historySaved_ = true;
+
+    // Only the primary screen's scrollback is persisted, and only as plain text,
+    // one logical (unwrapped) line per record, so restoring re-wraps naturally
+    // if the window size changed in between.
+    auto lines = vector<string> {};
+    for (auto const& logicalLine: terminal_.state().grids[0].logicalLines())
+    {
+        auto lineText = logicalLine.text();
+        while (!lineText.empty() && lineText.back() == ' ')
+            lineText.pop_back();
+        lines.emplace_back(move(lineText));
+    }
+    while (!lines.empty() && lines.back().empty())
+        lines.pop_back();
+
+    auto const path = historyFilePath();
+    auto ec = error_code {};
+    FileSystem::create_directories(path.parent_path(), ec);
+    auto out = ofstream(path.string(), ios::binary | ios::trunc);
+    if (!out.good())
+    {
+        LOGSTORE(SessionLog)("Failed to persist session history to {}.", path.string());
+        return;
+    }
+
+    for (auto const& lineText: lines)
+    {
+        out.write(lineText.data(), static_cast<streamsize>(lineText.size()));
+        out.write("\r\n", 2);
+    }
+    LOGSTORE(SessionLog)("Persisted {} lines of session history to {}.", lines.size(), path.string());
+}
+
 void TerminalSession::terminate()
 {
     if (!display_)
@@ -166,10 +244,10 @@ void TerminalSession::terminate()
 // {{{ Events implementations
 void TerminalSession::bell()
 {
-    LOGSTORE(SessionLog)("TODO: Beep!");
-    QApplication::beep();
-    // QApplication::beep() requires Qt Widgets dependency. doesn't suound good.
-    // so maybe just a visual bell then? That would require additional OpenGL/shader work then though.
+    // Invoked on the VT thread; the display decides how to present the bell
+    // (audible beep and/or visual flash), so hop onto the GUI thread first.
+    if (display_)
+        display_->post([this]() { display_->bell(); });
 }
 
 void TerminalSession::bufferChanged(terminal::ScreenType _type)
@@ -190,11 +268,28 @@ void TerminalSession::screenUpdated()
 
 void TerminalSession::flushInput()
 {
-    terminal().flushInput();
+    inputFlushPending_ = false;
+    terminal().flushInputNow();
     if (terminal().hasInput())
         display_->post(bind(&TerminalSession::flushInput, this));
 }
 
+bool TerminalSession::deferInputFlush()
+{
+    // Runs on the GUI thread in between input events. Instead of one PTY
+    // write per UI event, a single flush is posted to the end of the current
+    // event-loop turn, so an event burst (key repeat storm, mouse reporting)
+    // amounts to one write syscall.
+    if (!display_)
+        return false;
+    if (!inputFlushPending_)
+    {
+        inputFlushPending_ = true;
+        display_->post(bind(&TerminalSession::flushInput, this));
+    }
+    return true;
+}
+
 void TerminalSession::renderBufferUpdated()
 {
     if (!display_)
@@ -299,6 +394,9 @@ void TerminalSession::onClosed()
     else
         LOGSTORE(SessionLog)("Process terminated after {} seconds.", diff.count());
 
+    if (profile_.persistentHistory)
+        saveHistory();
+
     if (onExit_)
         onExit_();
 
@@ -370,7 +468,26 @@ void TerminalSession::setWindowTitle(string_view _title)
     if (!display_)
         return;
 
-    display_->post([this, terminalTitle = string(_title)]() { display_->setWindowTitle(terminalTitle); });
+    // Title-spamming applications (e.g. builds reporting every compiled file)
+    // would otherwise queue one closure per change; coalesce all changes of an
+    // event-loop turn into a single display update showing the last title.
+    {
+        auto const _lock = scoped_lock { pendingWindowTitleLock_ };
+        pendingWindowTitle_ = _title;
+        if (windowTitlePending_)
+            return;
+        windowTitlePending_ = true;
+    }
+
+    display_->post([this]() {
+        auto title = string {};
+        {
+            auto const _lock = scoped_lock { pendingWindowTitleLock_ };
+            title = std::move(pendingWindowTitle_);
+            windowTitlePending_ = false;
+        }
+        display_->setWindowTitle(title);
+    });
 }
 
 void TerminalSession::setTerminalProfile(string const& _configProfileName)
@@ -404,7 +521,11 @@ void TerminalSession::sendKeyPressEvent(Key _key, Modifier _modifier, Timestamp
     display_->setMouseCursorShape(MouseCursorShape::Hidden);
 
     if (auto const* actions =
-            config::apply(config_.inputMappings.keyMappings, _key, _modifier, matchModeFlags()))
+            config::apply(config_.inputMappings.keyMappings,
+                          config_.inputMappings.keyIndex,
+                          _key,
+                          _modifier,
+                          matchModeFlags()))
         executeAllActions(*actions);
     else
         terminal().sendKeyPressEvent(_key, _modifier, _now);
@@ -424,7 +545,11 @@ void TerminalSession::sendCharPressEvent(char32_t _value, Modifier _modifier, Ti
     display_->setMouseCursorShape(MouseCursorShape::Hidden);
 
     if (auto const* actions =
-            config::apply(config_.inputMappings.charMappings, _value, _modifier, matchModeFlags()))
+            config::apply(config_.inputMappings.charMappings,
+                          config_.inputMappings.charIndex,
+                          _value,
+                          _modifier,
+                          matchModeFlags()))
         executeAllActions(*actions);
     else
         terminal().sendCharPressEvent(_value, _modifier, _now); // TODO: get rid of Event{} struct here, too!
@@ -437,6 +562,9 @@ void TerminalSession::sendMousePressEvent(Modifier _modifier,
 {
     // LOGSTORE(InputLog)("sendMousePressEvent: {} {} at {}", _button, _modifier, currentMousePosition_);
 
+    // A button event must not overtake a still coalesced motion event.
+    flushPendingMouseMove(true);
+
     // First try to pass the mouse event to the application, as it might have requested that.
     if (terminal().sendMousePressEvent(_modifier, _button, _pixelPosition, _now))
     {
@@ -445,7 +573,11 @@ void TerminalSession::sendMousePressEvent(Modifier _modifier,
     }
 
     if (auto const* actions =
-            config::apply(config_.inputMappings.mouseMappings, _button, _modifier, matchModeFlags()))
+            config::apply(config_.inputMappings.mouseMappings,
+                          config_.inputMappings.mouseIndex,
+                          _button,
+                          _modifier,
+                          matchModeFlags()))
     {
         if (executeAllActions(*actions))
             return;
@@ -458,21 +590,95 @@ void TerminalSession::sendMousePressEvent(Modifier _modifier,
     scheduleRedraw();
 }
 
+void TerminalSession::sendHighPrecisionWheelEvent(Modifier _modifier,
+                                                  int _pixelDelta,
+                                                  MousePixelPosition _pixelPosition,
+                                                  Timestamp _now)
+{
+    // High-precision scroll devices report pixel-granular deltas at event
+    // rates far beyond one wheel click's worth of motion; forwarding each of
+    // them as a full wheel step (scrolling historyScrollMultiplier lines at
+    // once) makes touchpad scrolling jumpy and far too fast. Accumulate the
+    // deltas instead and emit one wheel step per step's worth of scrolled
+    // pixels, so finger motion maps onto content motion. Each resulting step
+    // still runs through the regular wheel path, keeping the mouse protocol
+    // and input mapping semantics intact.
+    auto const cellHeight = display_ ? unbox<int>(display_->cellSize().height) : 0;
+    if (cellHeight <= 0)
+    {
+        if (_pixelDelta != 0)
+            sendMousePressEvent(_modifier,
+                                _pixelDelta > 0 ? MouseButton::WheelUp : MouseButton::WheelDown,
+                                _pixelPosition,
+                                _now);
+        return;
+    }
+
+    // One step scrolls historyScrollMultiplier lines; factor that into the
+    // step size so the multiplier does not amplify touchpad motion.
+    auto const stepSize = cellHeight * max(1, unbox<int>(profile_.historyScrollMultiplier));
+
+    if ((_pixelDelta < 0) != (accumulatedWheelPixels_ < 0))
+        accumulatedWheelPixels_ = 0; // direction reversals start afresh
+    accumulatedWheelPixels_ += _pixelDelta;
+
+    auto const steps = accumulatedWheelPixels_ / stepSize;
+    accumulatedWheelPixels_ -= steps * stepSize;
+
+    auto const button = steps > 0 ? MouseButton::WheelUp : MouseButton::WheelDown;
+    for (auto remaining = steps < 0 ? -steps : steps; remaining > 0; --remaining)
+        sendMousePressEvent(_modifier, button, _pixelPosition, _now);
+}
+
 void TerminalSession::sendMouseMoveEvent(terminal::Modifier _modifier,
                                          terminal::CellLocation _pos,
                                          terminal::MousePixelPosition _pixelPosition,
                                          Timestamp _now)
 {
+    // Mouse motion arrives at the mouse's polling rate, which may be far
+    // beyond the display's frame rate. Only the most recent position is kept
+    // and forwarded to the terminal once per render tick.
+    bool const flushAlreadyScheduled = pendingMouseMove_.has_value();
+    pendingMouseMove_ = PendingMouseMove { _modifier, _pos, _pixelPosition, _now };
+    if (!flushAlreadyScheduled)
+        scheduleRedraw();
+}
+
+void TerminalSession::flushPendingMouseMove(bool _force)
+{
+    if (!pendingMouseMove_)
+        return;
+
+    // Opt-in decimation for high-frequency mice on pixel-precision reporting
+    // modes, where even per-render-tick coalescing can exceed what the
+    // application keeps up with. The position simply stays pending while
+    // throttled (a later tick delivers the final position), and button
+    // transitions force the flush, keeping their ordering exact.
+    if (!_force && profile_.maxMouseReportRate > 0 && terminal().mouseProtocol().has_value())
+    {
+        auto const minInterval = chrono::microseconds { 1'000'000 / profile_.maxMouseReportRate };
+        if (pendingMouseMove_->timestamp - lastMouseReportTime_ < minInterval)
+        {
+            scheduleRedraw(); // ensures a later tick flushes the final position
+            return;
+        }
+    }
+
+    auto const event = *pendingMouseMove_;
+    pendingMouseMove_.reset();
+    lastMouseReportTime_ = event.timestamp;
+
     // NB: This translation depends on the display's margin, so maybe
     //     the display should provide the translation?
 
-    auto const handled = terminal().sendMouseMoveEvent(_modifier, _pos, _pixelPosition, _now);
+    auto const handled =
+        terminal().sendMouseMoveEvent(event.modifier, event.position, event.pixelPosition, event.timestamp);
 
-    if (_pos == currentMousePosition_)
+    if (event.position == currentMousePosition_)
         return;
 
     bool const mouseHoveringHyperlink = terminal().isMouseHoveringHyperlink();
-    currentMousePosition_ = _pos;
+    currentMousePosition_ = event.position;
     if (mouseHoveringHyperlink)
         display_->setMouseCursorShape(MouseCursorShape::PointingHand);
     else
@@ -491,6 +697,9 @@ void TerminalSession::sendMouseReleaseEvent(Modifier _modifier,
                                             MousePixelPosition _pixelPosition,
                                             Timestamp _now)
 {
+    // A button event must not overtake a still coalesced motion event.
+    flushPendingMouseMove(true);
+
     terminal().sendMouseReleaseEvent(_modifier, _button, _pixelPosition, _now);
     scheduleRedraw();
 }
@@ -765,6 +974,28 @@ bool TerminalSession::operator()(actions::ScrollUp)
     return true;
 }
 
+bool TerminalSession::operator()(actions::SelectPerformancePreset const& _action)
+{
+    auto const* preset = config_.performancePreset(_action.name);
+    if (!preset)
+    {
+        errorlog()("Unknown performance preset: \"{}\".", _action.name);
+        return false;
+    }
+
+    LOGSTORE(SessionLog)("Selecting performance preset: {}", _action.name);
+
+    {
+        auto const _l = scoped_lock { terminal_ };
+        terminal_.setRefreshRate(preset->refreshRate != 0.0 ? preset->refreshRate
+                                                            : display_->refreshRate());
+        terminal_.setHistoryCompression(preset->compressScrollback);
+    }
+
+    display_->setAtlasCacheCapacity(preset->textureAtlasHashtableSlots, preset->textureAtlasTileCount);
+    return true;
+}
+
 bool TerminalSession::operator()(actions::SendChars const& _event)
 {
     auto const now = steady_clock::now();
@@ -790,6 +1021,12 @@ bool TerminalSession::operator()(actions::ToggleFullscreen)
     return true;
 }
 
+bool TerminalSession::operator()(actions::ToggleStatisticsOverlay)
+{
+    terminal_.setStatisticsOverlayEnabled(!terminal_.statisticsOverlayEnabled());
+    return true;
+}
+
 bool TerminalSession::operator()(actions::WriteScreen const& _event)
 {
     terminal().writeToScreen(_event.chars);
@@ -816,10 +1053,20 @@ bool TerminalSession::reloadConfig(config::Config _newConfig, string const& _pro
 
     config_ = move(_newConfig);
     activateProfile(_profileName);
+    publishConfigSnapshot();
 
     return true;
 }
 
+void TerminalSession::publishConfigSnapshot()
+{
+    // Builds a fresh immutable snapshot and swaps it in atomically. Readers
+    // keep using whatever snapshot they pinned at frame begin; the previous
+    // one is released with its last reader.
+    auto snapshot = make_shared<ConfigSnapshot const>(ConfigSnapshot { config_, profile_ });
+    std::atomic_store_explicit(&configSnapshot_, std::move(snapshot), std::memory_order_release);
+}
+
 int TerminalSession::executeAllActions(std::vector<actions::Action> const& _actions)
 {
     if (allowKeyMappings_)
@@ -903,6 +1150,7 @@ void TerminalSession::activateProfile(string const& _newProfileName)
     profile_ = *newProfile;
     configureTerminal();
     configureDisplay();
+    publishConfigSnapshot();
 }
 
 void TerminalSession::configureTerminal()
@@ -915,6 +1163,8 @@ void TerminalSession::configureTerminal()
     terminal_.setMouseProtocolBypassModifier(config_.bypassMouseProtocolModifier);
     terminal_.setMouseBlockSelectionModifier(config_.mouseBlockSelectionModifier);
     terminal_.setLastMarkRangeOffset(profile_.copyLastMarkRangeOffset);
+    terminal_.setEchoPrediction(profile_.echoPrediction);
+    terminal_.setParseAheadLimit(config_.ptyParseAheadLimit);
 
     LOGSTORE(SessionLog)("Setting terminal ID to {}.", profile_.terminalId);
     screen.setTerminalId(profile_.terminalId);
@@ -994,6 +1244,7 @@ void TerminalSession::setFontSize(text::font_size _size)
         return;
 
     profile_.fonts.size = _size;
+    publishConfigSnapshot();
 }
 
 bool TerminalSession::reloadConfigWithProfile(string const& _profileName)
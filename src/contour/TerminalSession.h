@@ -24,6 +24,8 @@
 #include <crispy/point.h>
 
 #include <functional>
+#include <memory>
+#include <mutex>
 
 namespace contour
 {
@@ -68,6 +70,26 @@ class TerminalSession: public terminal::Terminal::Events
     config::Config const& config() const noexcept { return config_; }
     config::TerminalProfile const& profile() const noexcept { return profile_; }
 
+    /// Immutable snapshot of the effective configuration and active profile.
+    struct ConfigSnapshot
+    {
+        config::Config config;
+        config::TerminalProfile profile;
+    };
+
+    /// Returns the most recently published configuration snapshot.
+    ///
+    /// A fresh snapshot is published atomically whenever the configuration or
+    /// the active profile changes (live reload, profile switch, font resize).
+    /// Threads other than the GUI thread - most notably the render thread -
+    /// pin the snapshot once per frame and read all values through it, so a
+    /// concurrent reload neither races them nor changes values mid-frame.
+    /// The previous snapshot is released with its last reader.
+    std::shared_ptr<ConfigSnapshot const> configSnapshot() const noexcept
+    {
+        return std::atomic_load_explicit(&configSnapshot_, std::memory_order_acquire);
+    }
+
     double contentScale() const noexcept { return contentScale_; }
     void setContentScale(double value) noexcept { contentScale_ = value; }
 
@@ -85,6 +107,7 @@ class TerminalSession: public terminal::Terminal::Events
     //
     void requestCaptureBuffer(int _absoluteStartLine, int _lineCount) override;
     void bell() override;
+    bool deferInputFlush() override;
     void bufferChanged(terminal::ScreenType) override;
     void renderBufferUpdated() override;
     void screenUpdated() override;
@@ -110,6 +133,12 @@ class TerminalSession: public terminal::Terminal::Events
                              terminal::MouseButton _button,
                              terminal::MousePixelPosition _pixelPosition,
                              Timestamp _now);
+    /// Feeds a pixel-granular scroll delta (touchpads, high-resolution
+    /// wheels), which is accumulated and emitted as discrete wheel steps.
+    void sendHighPrecisionWheelEvent(terminal::Modifier _modifier,
+                                     int _pixelDelta,
+                                     terminal::MousePixelPosition _pixelPosition,
+                                     Timestamp _now);
     void sendMouseMoveEvent(terminal::Modifier _modifier,
                             terminal::CellLocation _pos,
                             terminal::MousePixelPosition _pixelPosition,
@@ -119,6 +148,15 @@ class TerminalSession: public terminal::Terminal::Events
                                terminal::MousePixelPosition _pixelPosition,
                                Timestamp _now);
 
+    /// Forwards the most recently coalesced mouse motion to the terminal.
+    ///
+    /// Invoked by the display once per render tick, so a high-polling-rate
+    /// mouse does not multiply selection and render work by its event rate.
+    /// When the profile limits the mouse report rate, throttled positions
+    /// stay pending for a later tick; @p _force (used by button events)
+    /// bypasses the limit.
+    void flushPendingMouseMove(bool _force = false);
+
     void sendFocusInEvent();
     void sendFocusOutEvent();
 
@@ -153,9 +191,11 @@ class TerminalSession: public terminal::Terminal::Events
     bool operator()(actions::ScrollToBottom);
     bool operator()(actions::ScrollToTop);
     bool operator()(actions::ScrollUp);
+    bool operator()(actions::SelectPerformancePreset const& _action);
     bool operator()(actions::SendChars const& _event);
     bool operator()(actions::ToggleAllKeyMaps);
     bool operator()(actions::ToggleFullscreen);
+    bool operator()(actions::ToggleStatisticsOverlay);
     bool operator()(actions::WriteScreen const& _event);
 
     void scheduleRedraw()
@@ -179,12 +219,16 @@ class TerminalSession: public terminal::Terminal::Events
     void followHyperlink(terminal::HyperlinkInfo const& _hyperlink);
     bool requestPermission(config::Permission _allowedByConfig, std::string_view _topicText);
     void setFontSize(text::font_size _size);
+    void publishConfigSnapshot();
     void onConfigReload(FileChangeWatcher::Event _event);
     void setDefaultCursor();
     void configureTerminal();
     void configureDisplay();
     uint8_t matchModeFlags() const;
     void flushInput();
+    FileSystem::path historyFilePath() const;
+    void restoreHistory();
+    void saveHistory();
 
     // private data
     //
@@ -193,6 +237,7 @@ class TerminalSession: public terminal::Terminal::Events
     config::Config config_;
     std::string profileName_;
     config::TerminalProfile profile_;
+    std::shared_ptr<ConfigSnapshot const> configSnapshot_; // accessed via std::atomic_load/store only
     double contentScale_ = 1.0;
     std::string programPath_;
     ContourGuiApp& app_;
@@ -202,6 +247,7 @@ class TerminalSession: public terminal::Terminal::Events
     std::unique_ptr<terminal::Pty> pty_;
     terminal::Terminal terminal_;
     bool terminatedAndWaitingForKeyPress_ = false;
+    bool historySaved_ = false;
     std::unique_ptr<TerminalDisplay> display_;
 
     std::optional<FileChangeWatcher> configFileChangeWatcher_;
@@ -211,6 +257,38 @@ class TerminalSession: public terminal::Terminal::Events
     terminal::ScreenType currentScreenType_ = terminal::ScreenType::Main;
     terminal::CellLocation currentMousePosition_ = terminal::CellLocation {};
     bool allowKeyMappings_ = true;
+
+    // Most recent mouse motion, coalesced until the next render tick
+    // (see flushPendingMouseMove()). Only ever touched by the GUI thread.
+    struct PendingMouseMove
+    {
+        terminal::Modifier modifier;
+        terminal::CellLocation position;
+        terminal::MousePixelPosition pixelPosition;
+        Timestamp timestamp;
+    };
+    std::optional<PendingMouseMove> pendingMouseMove_;
+
+    // When the most recently flushed mouse-motion report was sent; used to
+    // enforce the profile's maximum mouse report rate.
+    Timestamp lastMouseReportTime_ {};
+
+    // Scroll pixels accumulated from high-precision wheel events that have
+    // not yet amounted to a full wheel step. Only ever touched by the GUI
+    // thread.
+    int accumulatedWheelPixels_ = 0;
+
+    // Whether a coalesced input flush is already posted to the end of the
+    // current event-loop turn (see deferInputFlush()). Only ever touched by
+    // the GUI thread.
+    bool inputFlushPending_ = false;
+
+    // Most recently requested window title, written by the VT thread and
+    // consumed by one coalesced GUI-thread update per event-loop turn
+    // (see setWindowTitle()).
+    std::mutex pendingWindowTitleLock_;
+    std::string pendingWindowTitle_;
+    bool windowTitlePending_ = false;
 };
 
 } // namespace contour
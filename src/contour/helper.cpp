@@ -266,6 +266,18 @@ bool sendKeyEvent(QKeyEvent* _event, TerminalSession& _session)
 
 void sendWheelEvent(QWheelEvent* _event, TerminalSession& _session)
 {
+    // Pixel-granular deltas (touchpads, high-resolution wheels) are
+    // accumulated by the session into discrete wheel steps; classic click
+    // wheels keep the one-step-per-event behavior below.
+    if (auto const pixelDelta = _event->pixelDelta().y(); pixelDelta != 0)
+    {
+        _session.sendHighPrecisionWheelEvent(makeModifier(_event->modifiers()),
+                                             int(double(pixelDelta) * _session.contentScale()),
+                                             makeMousePixelPosition(_event, _session.contentScale()),
+                                             steady_clock::now());
+        return;
+    }
+
     auto const yDelta = mouseWheelDelta(_event);
 
     if (yDelta)
@@ -17,6 +17,8 @@
 
 #include <terminal_renderer/TextureAtlas.h>
 
+#include <crispy/FNV.h>
+#include <crispy/PerfCounters.h>
 #include <crispy/algorithm.h>
 #include <crispy/assert.h>
 #include <crispy/utils.h>
@@ -28,6 +30,7 @@
 #include <algorithm>
 #include <array>
 #include <chrono>
+#include <cstring>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -43,6 +46,7 @@ using std::optional;
 using std::pair;
 using std::shared_ptr;
 using std::string;
+using std::string_view;
 using std::vector;
 
 using terminal::Height;
@@ -53,6 +57,10 @@ using terminal::Width;
 namespace chrono = std::chrono;
 namespace atlas = terminal::renderer::atlas;
 
+// Number of GLfloats one render tile contributes to the text vertex stream
+// (two triangles, 11 floats per vertex; see appendTileVertices()).
+auto constexpr TextVertexFloatsPerTile = size_t { 6 * 11 };
+
 #if !defined(_WIN32)
     #define CRISPY_PACKED __attribute__((packed))
 #else
@@ -173,20 +181,29 @@ OpenGLRenderer::OpenGLRenderer(ShaderConfig const& textShaderConfig,
                                ShaderConfig const& backgroundImageShaderConfig,
                                ImageSize targetSurfaceSize,
                                ImageSize /*textureTileSize*/,
-                               terminal::renderer::PageMargin margin):
+                               terminal::renderer::PageMargin margin,
+                               bool directVertexMapping,
+                               terminal::renderer::PixelFormat pixelFormat):
     _renderTargetSize { targetSurfaceSize },
+    _pixelFormat { pixelFormat },
     _projectionMatrix { ortho(0.0f,
                               unbox<float>(targetSurfaceSize.width), // left, right
                               0.0f,
                               unbox<float>(targetSurfaceSize.height) // bottom, top
                               ) },
     _margin { margin },
-    _textShader { createShader(textShaderConfig) },
-    _textProjectionLocation { _textShader->uniformLocation("vs_projection") },
-    _backgroundShader { createShader(backgroundImageShaderConfig) },
-    _rectShader { createShader(rectShaderConfig) },
-    _rectProjectionLocation { _rectShader->uniformLocation("u_projection") }
+    _directVertexMapping { directVertexMapping }
 {
+    // All construction-time programs are compiled into the variant table
+    // under the "default" name; further variants can be precompiled and
+    // switched to at runtime (see precompileShaderVariant()).
+    precompileShaderVariant(ShaderClass::Text, DefaultShaderVariantName, textShaderConfig);
+    precompileShaderVariant(ShaderClass::Background, DefaultShaderVariantName, rectShaderConfig);
+    precompileShaderVariant(ShaderClass::BackgroundImage, DefaultShaderVariantName, backgroundImageShaderConfig);
+    activateShaderVariant(ShaderClass::Text, DefaultShaderVariantName);
+    activateShaderVariant(ShaderClass::Background, DefaultShaderVariantName);
+    activateShaderVariant(ShaderClass::BackgroundImage, DefaultShaderVariantName);
+
     initialize();
 
     setRenderSize(targetSurfaceSize);
@@ -198,17 +215,106 @@ OpenGLRenderer::OpenGLRenderer(ShaderConfig const& textShaderConfig,
     // glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
     //  //glBlendFunc(GL_SRC1_COLOR, GL_ONE_MINUS_SRC1_COLOR);
 
-    bound(*_textShader, [&]() {
-        CHECKED_GL(_textShader->setUniformValue("fs_textureAtlas", 0)); // GL_TEXTURE0?
-        auto const textureAtlasWidth = unbox<GLfloat>(_textureAtlas.textureSize.width);
-        CHECKED_GL(_textShader->setUniformValue("pixel_x", 1.0f / textureAtlasWidth));
-    });
-
     initializeBackgroundRendering();
     initializeRectRendering();
     initializeTextureRendering();
 }
 
+// {{{ precompiled shader program variants
+string OpenGLRenderer::shaderVariantKey(ShaderClass shaderClass, string_view name)
+{
+    return fmt::format("{}/{}", to_string(shaderClass), name);
+}
+
+QOpenGLShaderProgram*& OpenGLRenderer::activeShaderProgram(ShaderClass shaderClass) noexcept
+{
+    switch (shaderClass)
+    {
+    case ShaderClass::Text: return _textShader;
+    case ShaderClass::Background: return _rectShader;
+    case ShaderClass::BackgroundImage: return _backgroundShader;
+    }
+    crispy::unreachable();
+}
+
+bool OpenGLRenderer::precompileShaderVariant(ShaderClass shaderClass,
+                                             string_view name,
+                                             ShaderConfig const& config)
+{
+    auto const fnv = crispy::FNV<char, uint64_t> {};
+    auto const sourceHash = fnv(fnv(config.vertexShader.contents.toStdString()),
+                                string_view(config.fragmentShader.contents.toStdString()));
+
+    auto const key = shaderVariantKey(shaderClass, name);
+    if (auto const i = _shaderVariants.find(key);
+        i != _shaderVariants.end() && i->second.sourceHash == sourceHash)
+        return true;
+
+    auto program = createShader(config);
+    if (!program)
+        return false;
+
+    auto& variant = _shaderVariants[key];
+    variant.program = std::move(program);
+    variant.sourceHash = sourceHash;
+
+    // An edited variant may be its class's active program; re-point the
+    // active slot then, so no dangling program stays in use.
+    if (string_view(_activeShaderVariants[static_cast<size_t>(shaderClass)]) == name)
+    {
+        activeShaderProgram(shaderClass) = variant.program.get();
+        rebindShaderClassState(shaderClass);
+    }
+    return true;
+}
+
+bool OpenGLRenderer::activateShaderVariant(ShaderClass shaderClass, string_view name)
+{
+    if (string_view(_activeShaderVariants[static_cast<size_t>(shaderClass)]) == name)
+        return true;
+
+    auto const i = _shaderVariants.find(shaderVariantKey(shaderClass, name));
+    if (i == _shaderVariants.end())
+        return false;
+
+    DisplayLog()("Switching {} shader to precompiled variant '{}'.", to_string(shaderClass), name);
+    _activeShaderVariants[static_cast<size_t>(shaderClass)] = name;
+    activeShaderProgram(shaderClass) = i->second.program.get();
+    rebindShaderClassState(shaderClass);
+    return true;
+}
+
+void OpenGLRenderer::rebindShaderClassState(ShaderClass shaderClass)
+{
+    switch (shaderClass)
+    {
+    case ShaderClass::Text:
+        _textProjectionLocation = _textShader->uniformLocation("vs_projection");
+        bound(*_textShader, [&]() {
+            CHECKED_GL(_textShader->setUniformValue("fs_textureAtlas", 0)); // GL_TEXTURE0?
+            auto const textureAtlasWidth = unbox<GLfloat>(_textureAtlas.textureSize.width);
+            CHECKED_GL(_textShader->setUniformValue("pixel_x", 1.0f / textureAtlasWidth));
+        });
+        break;
+    case ShaderClass::Background:
+        _rectProjectionLocation = _rectShader->uniformLocation("u_projection");
+        break;
+    case ShaderClass::BackgroundImage:
+        bound(*_backgroundShader, [&]() {
+            // clang-format off
+            CHECKED_GL(_backgroundShader->setUniformValue("fs_backgroundImage", 0)); // GL_TEXTURE0
+            CHECKED_GL(_backgroundUniformLocations.projection = _backgroundShader->uniformLocation("u_projection"));
+            CHECKED_GL(_backgroundUniformLocations.resolution = _backgroundShader->uniformLocation("u_resolution"));
+            CHECKED_GL(_backgroundUniformLocations.blur = _backgroundShader->uniformLocation("u_blur"));
+            CHECKED_GL(_backgroundUniformLocations.opacity = _backgroundShader->uniformLocation("u_opacity"));
+            CHECKED_GL(_backgroundUniformLocations.time = _backgroundShader->uniformLocation("u_time"));
+            // clang-format on
+        });
+        break;
+    }
+}
+// }}}
+
 void OpenGLRenderer::setRenderSize(ImageSize targetSurfaceSize)
 {
     // glOrtho
@@ -226,9 +332,9 @@ void OpenGLRenderer::setMargin(terminal::renderer::PageMargin margin) noexcept
     _margin = margin;
 }
 
-atlas::AtlasBackend& OpenGLRenderer::textureScheduler()
+terminal::renderer::RenderCommandList& OpenGLRenderer::commandList() noexcept
 {
-    return *this;
+    return _commandList;
 }
 
 void OpenGLRenderer::initializeRectRendering()
@@ -251,6 +357,19 @@ void OpenGLRenderer::initializeRectRendering()
     // 1 (vec4): color buffer
     CHECKED_GL(glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, BufferStride, ColorOffset));
     CHECKED_GL(glEnableVertexAttribArray(1));
+
+    // frame tint quad: same shader and vertex layout, dedicated buffer
+    CHECKED_GL(glGenVertexArrays(1, &_tintVAO));
+    CHECKED_GL(glBindVertexArray(_tintVAO));
+
+    CHECKED_GL(glGenBuffers(1, &_tintVBO));
+    CHECKED_GL(glBindBuffer(GL_ARRAY_BUFFER, _tintVBO));
+    CHECKED_GL(glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_STREAM_DRAW));
+
+    CHECKED_GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, BufferStride, VertexOffset));
+    CHECKED_GL(glEnableVertexAttribArray(0));
+    CHECKED_GL(glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, BufferStride, ColorOffset));
+    CHECKED_GL(glEnableVertexAttribArray(1));
 }
 
 void OpenGLRenderer::initializeTextureRendering()
@@ -279,6 +398,8 @@ void OpenGLRenderer::initializeTextureRendering()
     CHECKED_GL(glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, BufferStride, ColorOffset));
     CHECKED_GL(glEnableVertexAttribArray(2));
 
+    CHECKED_GL(glGenBuffers(1, &_uploadPBO));
+
     // setup EBO
     // glGenBuffers(1, &_ebo);
     // glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _ebo);
@@ -293,9 +414,20 @@ OpenGLRenderer::~OpenGLRenderer()
     LOGSTORE(DisplayLog)("~OpenGLRenderer");
     CHECKED_GL(glDeleteVertexArrays(1, &_rectVAO));
     CHECKED_GL(glDeleteBuffers(1, &_rectVBO));
+    CHECKED_GL(glDeleteVertexArrays(1, &_tintVAO));
+    CHECKED_GL(glDeleteBuffers(1, &_tintVBO));
+    CHECKED_GL(glDeleteBuffers(1, &_uploadPBO));
 
     if (_backgroundImageTexture)
         CHECKED_GL(glDeleteTextures(1, &_backgroundImageTexture));
+
+    if (_blurredBackgroundTexture)
+        CHECKED_GL(glDeleteTextures(1, &_blurredBackgroundTexture));
+
+    if (_scrollScratchTexture)
+        CHECKED_GL(glDeleteTextures(1, &_scrollScratchTexture));
+    if (_scrollScratchFBO)
+        CHECKED_GL(glDeleteFramebuffers(1, &_scrollScratchFBO));
 }
 
 void OpenGLRenderer::initialize()
@@ -329,40 +461,9 @@ int OpenGLRenderer::maxTextureSize()
     return static_cast<int>(value);
 }
 
-// {{{ AtlasBackend impl
-ImageSize OpenGLRenderer::atlasSize() const noexcept
+// {{{ vertex generation from the render command list
+void OpenGLRenderer::appendTileVertices(atlas::RenderTile const& tile, GLfloat* output)
 {
-    return _textureAtlas.textureSize;
-}
-
-void OpenGLRenderer::configureAtlas(atlas::ConfigureAtlas atlas)
-{
-    // schedule atlas creation
-    _scheduledExecutions.configureAtlas.emplace(atlas);
-    _textureAtlas.textureSize = atlas.size;
-    _textureAtlas.properties = atlas.properties;
-
-    // clang-format off
-    LOGSTORE(DisplayLog)("configureAtlas: {} {}", atlas.size, atlas.properties.format);
-    // clang-format on
-}
-
-void OpenGLRenderer::uploadTile(atlas::UploadTile tile)
-{
-    // clang-format off
-    // LOGSTORE(DisplayLog)("uploadTile: atlas {} @ {}:{}",
-    //                      tile.location.atlasID.value,
-    //                      tile.location.x.value,
-    //                      tile.location.y.value);
-    // clang-format on
-
-    _scheduledExecutions.uploadTiles.emplace_back(move(tile));
-}
-
-void OpenGLRenderer::renderTile(atlas::RenderTile tile)
-{
-    RenderBatch& batch = _scheduledExecutions.renderBatch;
-
     // atlas texture Vertices to locate the tile
     auto const x = static_cast<GLfloat>(tile.x.value);
     auto const y = static_cast<GLfloat>(tile.y.value);
@@ -415,8 +516,33 @@ void OpenGLRenderer::renderTile(atlas::RenderTile tile)
     };
     // clang-format on
 
-    batch.renderTiles.emplace_back(tile);
-    crispy::copy(vertices, back_inserter(batch.buffer));
+    std::memcpy(output, vertices, sizeof(vertices));
+}
+
+void OpenGLRenderer::appendRectVertices(terminal::renderer::RenderCommandList::FillRectangle const& rect)
+{
+    auto const x = static_cast<GLfloat>(rect.x);
+    auto const y = static_cast<GLfloat>(rect.y);
+    auto const z = GLfloat { 0.0f };
+    auto const r = unbox<GLfloat>(rect.width);
+    auto const s = unbox<GLfloat>(rect.height);
+    auto const [cr, cg, cb, ca] = atlas::normalize(rect.color);
+
+    // clang-format off
+    GLfloat const vertices[6 * 7] = {
+        // first triangle
+        x,     y + s, z, cr, cg, cb, ca,
+        x,     y,     z, cr, cg, cb, ca,
+        x + r, y,     z, cr, cg, cb, ca,
+
+        // second triangle
+        x,     y + s, z, cr, cg, cb, ca,
+        x + r, y,     z, cr, cg, cb, ca,
+        x + r, y + s, z, cr, cg, cb, ca
+    };
+    // clang-format on
+
+    crispy::copy(vertices, back_inserter(_rectBuffer));
 }
 // }}}
 
@@ -436,6 +562,8 @@ ImageSize OpenGLRenderer::renderBufferSize()
 
 void OpenGLRenderer::execute()
 {
+    CRISPY_PERF_SCOPE("opengl.execute");
+
     static auto lastSize = crispy::ImageSize {};
     if (lastSize != _renderTargetSize)
     {
@@ -450,6 +578,47 @@ void OpenGLRenderer::execute()
     // glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ZERO, GL_ONE);
     // glBlendFunc(GL_SRC1_COLOR, GL_ONE_MINUS_SRC1_COLOR);
 
+    // {{{ scissor the frame to its damage region, when usable
+    // Requires the target to still hold the previous frame's pixels
+    // (QOpenGLWidget::PartialUpdate) at an unchanged size. A background image
+    // repaints the whole target every frame (its blur may be time-animated),
+    // and a changed clear color (e.g. opacity reconfiguration) invalidates
+    // pixels the grid-level damage tracking knows nothing about.
+    // A changing frame tint (e.g. a decaying bell flash) invalidates every
+    // pixel of the previous frame, so such frames compose in full.
+    bool scissoredFrame =
+        _commandList.damage.has_value() && _renderTargetSize == _lastFrameTargetSize
+        && !_backgroundImageTexture && _frameTint == _lastAppliedFrameTint
+        && (!_commandList.clearColor || *_commandList.clearColor == _renderStateCache.backgroundColor);
+    _lastFrameTargetSize = _renderTargetSize;
+
+    // A scrolled frame's rows outside the damage span are on screen already,
+    // but shifted; they are only correct once the blit below moved them into
+    // place. If it cannot run, fall back to composing the whole frame.
+    if (scissoredFrame && _commandList.scroll)
+        scissoredFrame = executeScrollBlit(*_commandList.scroll);
+
+    if (scissoredFrame)
+    {
+        auto const span = *_commandList.damage;
+        CHECKED_GL(glEnable(GL_SCISSOR_TEST));
+        CHECKED_GL(
+            glScissor(0, span.y, unbox<GLsizei>(_renderTargetSize.width), unbox<GLsizei>(span.height)));
+    }
+    // }}}
+
+    // clear the target surface (confined to the scissor region, if any)
+    if (_commandList.clearColor)
+    {
+        if (*_commandList.clearColor != _renderStateCache.backgroundColor)
+        {
+            auto const clearColor = atlas::normalize(*_commandList.clearColor);
+            glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+            _renderStateCache.backgroundColor = *_commandList.clearColor;
+        }
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
     if (_backgroundImageTexture)
     {
         bound(*_backgroundShader, [&]() { executeRenderBackground(); });
@@ -457,22 +626,22 @@ void OpenGLRenderer::execute()
 
     // render filled rects
     //
-    if (!_rectBuffer.empty())
+    if (!_commandList.rectangles.empty())
     {
+        _rectBuffer.clear();
+        for (auto const& rect: _commandList.rectangles)
+            appendRectVertices(rect);
+
         bound(*_rectShader, [&]() {
             _rectShader->setUniformValue(_rectProjectionLocation, _projectionMatrix);
 
             glBindVertexArray(_rectVAO);
             glBindBuffer(GL_ARRAY_BUFFER, _rectVBO);
-            glBufferData(GL_ARRAY_BUFFER,
-                         static_cast<GLsizeiptr>(_rectBuffer.size() * sizeof(GLfloat)),
-                         _rectBuffer.data(),
-                         GL_STREAM_DRAW);
+            uploadVertexDelta(_rectBufferMirror, _rectBuffer);
 
             glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(_rectBuffer.size() / 7));
             glBindVertexArray(0);
         });
-        _rectBuffer.clear();
     }
 
     // render textures
@@ -483,6 +652,44 @@ void OpenGLRenderer::execute()
         executeRenderTextures();
     });
 
+    // {{{ frame tint (visual bell flash, inactive-window dimming)
+    // Blended over the finished frame. Within a scissored frame only the
+    // recomposed damage span needs the quad: an unchanged tint is a scissor
+    // precondition, so all retained pixels carry the same tint already.
+    if (_frameTint.alpha() > 0)
+    {
+        auto const w = unbox<GLfloat>(_renderTargetSize.width);
+        auto const h = unbox<GLfloat>(_renderTargetSize.height);
+        auto const [cr, cg, cb, ca] = atlas::normalize(_frameTint);
+
+        // clang-format off
+        GLfloat const vertices[6 * 7] = {
+            0, h, 0, cr, cg, cb, ca,
+            0, 0, 0, cr, cg, cb, ca,
+            w, 0, 0, cr, cg, cb, ca,
+
+            0, h, 0, cr, cg, cb, ca,
+            w, 0, 0, cr, cg, cb, ca,
+            w, h, 0, cr, cg, cb, ca,
+        };
+        // clang-format on
+
+        bound(*_rectShader, [&]() {
+            _rectShader->setUniformValue(_rectProjectionLocation, _projectionMatrix);
+
+            glBindVertexArray(_tintVAO);
+            glBindBuffer(GL_ARRAY_BUFFER, _tintVBO);
+            CHECKED_GL(glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STREAM_DRAW));
+            glDrawArrays(GL_TRIANGLES, 0, 6);
+            glBindVertexArray(0);
+        });
+    }
+    _lastAppliedFrameTint = _frameTint;
+    // }}}
+
+    if (scissoredFrame)
+        CHECKED_GL(glDisable(GL_SCISSOR_TEST));
+
     if (_pendingScreenshotCallback)
     {
         auto result = takeScreenshot();
@@ -491,37 +698,211 @@ void OpenGLRenderer::execute()
     }
 }
 
+bool OpenGLRenderer::executeScrollBlit(terminal::renderer::RenderCommandList::ScrollBlit const& _scroll)
+{
+    // {{{ (re-)allocate the scratch texture and FBO at render target size
+    if (_scrollScratchSize != _renderTargetSize)
+    {
+        // Mark this target size as attempted up front; a failed attempt leaves
+        // the texture at 0 and scrolled frames are composed in full instead.
+        _scrollScratchSize = _renderTargetSize;
+
+        if (!_scrollScratchTexture)
+            CHECKED_GL(glGenTextures(1, &_scrollScratchTexture));
+        bindTexture(_scrollScratchTexture);
+        CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+        CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+        CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        // The scratch surface format-matches the output surface, so the two
+        // blits below stay pure pixel copies (no per-pixel format conversion).
+        auto const [internalFormat, dataType] = [this]() -> std::pair<GLint, GLenum> {
+            switch (_pixelFormat)
+            {
+            case terminal::renderer::PixelFormat::RGB10A2:
+                return { GL_RGB10_A2, GL_UNSIGNED_INT_2_10_10_10_REV };
+            case terminal::renderer::PixelFormat::RGBA16F: return { GL_RGBA16F, GL_HALF_FLOAT };
+            case terminal::renderer::PixelFormat::RGBA8: break;
+            }
+            return { GL_RGBA, GL_UNSIGNED_BYTE };
+        }();
+        CHECKED_GL(glTexImage2D(GL_TEXTURE_2D,
+                                0,
+                                internalFormat,
+                                unbox<GLsizei>(_renderTargetSize.width),
+                                unbox<GLsizei>(_renderTargetSize.height),
+                                0,
+                                GL_RGBA,
+                                dataType,
+                                nullptr));
+
+        if (!_scrollScratchFBO)
+            CHECKED_GL(glGenFramebuffers(1, &_scrollScratchFBO));
+
+        GLint previousFBO {};
+        CHECKED_GL(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO));
+        CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, _scrollScratchFBO));
+        CHECKED_GL(glFramebufferTexture2D(
+            GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _scrollScratchTexture, 0));
+        bool const complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFBO)));
+
+        if (!complete)
+        {
+            LOGSTORE(DisplayLog)("Scroll blit FBO incomplete; composing scrolled frames in full.");
+            CHECKED_GL(glDeleteTextures(1, &_scrollScratchTexture));
+            _scrollScratchTexture = 0;
+        }
+    }
+
+    if (!_scrollScratchTexture)
+        return false;
+    // }}}
+
+    GLint previousFBO {};
+    CHECKED_GL(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO));
+
+    auto const width = unbox<GLint>(_renderTargetSize.width);
+    auto const sourceY0 = _scroll.source.y;
+    auto const sourceY1 = _scroll.source.y + unbox<int>(_scroll.source.height);
+
+    // Park the moving span in the scratch texture, then write it back at its
+    // shifted position; a direct self-blit with overlapping source and
+    // destination regions is undefined.
+    CHECKED_GL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, _scrollScratchFBO));
+    CHECKED_GL(glBlitFramebuffer(
+        0, sourceY0, width, sourceY1, 0, sourceY0, width, sourceY1, GL_COLOR_BUFFER_BIT, GL_NEAREST));
+
+    CHECKED_GL(glBindFramebuffer(GL_READ_FRAMEBUFFER, _scrollScratchFBO));
+    CHECKED_GL(glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(previousFBO)));
+    CHECKED_GL(glBlitFramebuffer(0,
+                                 sourceY0,
+                                 width,
+                                 sourceY1,
+                                 0,
+                                 sourceY0 + _scroll.pixelDelta,
+                                 width,
+                                 sourceY1 + _scroll.pixelDelta,
+                                 GL_COLOR_BUFFER_BIT,
+                                 GL_NEAREST));
+
+    CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFBO)));
+    return true;
+}
+
+void OpenGLRenderer::uploadVertexDelta(VertexBufferMirror& _mirror, std::vector<GLfloat> const& _buffer)
+{
+    // Growing beyond the VBO's allocation (and the very first frame): orphan
+    // and stream the whole buffer; there is nothing worth diffing against.
+    if (_buffer.size() > _mirror.capacity)
+    {
+        glBufferData(GL_ARRAY_BUFFER,
+                     static_cast<GLsizeiptr>(_buffer.size() * sizeof(GLfloat)),
+                     _buffer.data(),
+                     GL_STREAM_DRAW);
+        _mirror.capacity = _buffer.size();
+        _mirror.contents = _buffer;
+        return;
+    }
+
+    // The mirror covers the full VBO allocation, so every element of the new
+    // buffer has a previous value to compare against. The draw call below only
+    // consumes _buffer.size() floats, hence stale data past that is harmless.
+    auto const count = _buffer.size();
+    size_t dirtyBegin = 0;
+    while (dirtyBegin < count && _buffer[dirtyBegin] == _mirror.contents[dirtyBegin])
+        ++dirtyBegin;
+    if (dirtyBegin == count) // bit-identical frame (e.g. blinking cursor hidden phase)
+        return;
+
+    auto dirtyEnd = count;
+    while (dirtyEnd > dirtyBegin + 1 && _buffer[dirtyEnd - 1] == _mirror.contents[dirtyEnd - 1])
+        --dirtyEnd;
+
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    static_cast<GLintptr>(dirtyBegin * sizeof(GLfloat)),
+                    static_cast<GLsizeiptr>((dirtyEnd - dirtyBegin) * sizeof(GLfloat)),
+                    _buffer.data() + dirtyBegin);
+
+    std::copy(_buffer.begin() + static_cast<ptrdiff_t>(dirtyBegin),
+              _buffer.begin() + static_cast<ptrdiff_t>(dirtyEnd),
+              _mirror.contents.begin() + static_cast<ptrdiff_t>(dirtyBegin));
+}
+
 void OpenGLRenderer::executeRenderTextures()
 {
     // potentially (re-)configure atlas
-    if (_scheduledExecutions.configureAtlas)
-        executeConfigureAtlas(*_scheduledExecutions.configureAtlas);
+    if (_commandList.pendingAtlasConfig)
+        executeConfigureAtlas(*_commandList.pendingAtlasConfig);
 
     // potentially upload any new textures
-    for (auto const& params: _scheduledExecutions.uploadTiles)
-        executeUploadTile(params);
+    executeUploadTiles();
 
     // upload vertices and render
-    RenderBatch& batch = _scheduledExecutions.renderBatch;
-    if (!batch.renderTiles.empty())
+    if (!_commandList.renderTiles.empty())
     {
-        glActiveTexture(static_cast<GLenum>(GL_TEXTURE0 + batch.userdata));
+        auto const vertexFloatCount = _commandList.renderTiles.size() * TextVertexFloatsPerTile;
+
+        glActiveTexture(GL_TEXTURE0);
         bindTexture(_textureAtlas.textureId);
         glBindVertexArray(_textVAO);
-
-        // upload buffer
-        // clang-format off
         glBindBuffer(GL_ARRAY_BUFFER, _textVBO);
-        glBufferData(GL_ARRAY_BUFFER,
-                     static_cast<GLsizei>(batch.buffer.size() * sizeof(GLfloat)),
-                     batch.buffer.data(), GL_STREAM_DRAW);
-        glDrawArrays(GL_TRIANGLES,
-                     0,
-                     static_cast<GLsizei>(batch.renderTiles.size() * 6));
-        // clang-format on
+
+        auto uploaded = false;
+        if (_directVertexMapping)
+            uploaded = streamTileVerticesMapped(vertexFloatCount);
+
+        if (!uploaded)
+        {
+            // Host-side staging plus delta upload: the default path, and the
+            // per-frame fallback whenever mapping the VBO failed.
+            _textBuffer.resize(vertexFloatCount);
+            auto* output = _textBuffer.data();
+            for (auto const& tile: _commandList.renderTiles)
+            {
+                appendTileVertices(tile, output);
+                output += TextVertexFloatsPerTile;
+            }
+            uploadVertexDelta(_textBufferMirror, _textBuffer);
+        }
+
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(_commandList.renderTiles.size() * 6));
     }
 
-    _scheduledExecutions.clear();
+    _commandList.clear();
+}
+
+bool OpenGLRenderer::streamTileVerticesMapped(size_t vertexFloatCount)
+{
+    // Direct-write path: the vertex stream is built straight inside the
+    // driver-visible mapping, skipping the host staging vector and the delta
+    // mirror. GL_MAP_INVALIDATE_BUFFER_BIT orphans the previous frame's data
+    // store, so the write never stalls on a still in-flight draw.
+    auto const byteCount = static_cast<GLsizeiptr>(vertexFloatCount * sizeof(GLfloat));
+    if (vertexFloatCount > _mappedTextCapacity)
+    {
+        glBufferData(GL_ARRAY_BUFFER, byteCount, nullptr, GL_STREAM_DRAW);
+        _mappedTextCapacity = vertexFloatCount;
+    }
+
+    auto* output = static_cast<GLfloat*>(
+        glMapBufferRange(GL_ARRAY_BUFFER, 0, byteCount, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+    if (!output)
+        return false;
+
+    for (auto const& tile: _commandList.renderTiles)
+    {
+        appendTileVertices(tile, output);
+        output += TextVertexFloatsPerTile;
+    }
+
+    // This path writes (and possibly reallocates) the VBO behind the delta
+    // mirror's back; force the staging fallback to fully re-stream.
+    _textBufferMirror.capacity = 0;
+
+    // On GL_FALSE the mapped data store got lost mid-write; re-stream through
+    // the staging path then.
+    return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
 }
 
 void OpenGLRenderer::executeConfigureAtlas(atlas::ConfigureAtlas const& param)
@@ -535,9 +916,8 @@ void OpenGLRenderer::executeConfigureAtlas(atlas::ConfigureAtlas const& param)
     Require(isPowerOfTwo(unbox<uint32_t>(param.size.width)));
     Require(isPowerOfTwo(unbox<uint32_t>(param.size.height)));
 
-    // Already initialized.
-    // _textureAtlas.textureSize = param.size;
-    // _textureAtlas.properties = param.properties;
+    _textureAtlas.textureSize = param.size;
+    _textureAtlas.properties = param.properties;
 
     CHECKED_GL(glTexParameteri(GL_TEXTURE_2D,
                                GL_TEXTURE_MAG_FILTER,
@@ -599,33 +979,60 @@ void OpenGLRenderer::executeConfigureAtlas(atlas::ConfigureAtlas const& param)
                             stub.data()));
 }
 
-void OpenGLRenderer::executeUploadTile(atlas::UploadTile const& param)
+void OpenGLRenderer::executeUploadTiles()
 {
-    auto const textureId = _textureAtlas.textureId;
+    if (_commandList.uploadTiles.empty())
+        return;
 
     auto constexpr target = GL_TEXTURE_2D;
     auto constexpr LevelOfDetail = 0;
     auto constexpr BitmapType = GL_UNSIGNED_BYTE;
 
+    // Collect all pending tile bitmaps into one staging buffer so that the
+    // data crosses over to the GPU in a single transfer. The per-tile
+    // glTexSubImage2D calls below then merely source from the already
+    // uploaded PBO and therefore do not synchronize on client memory.
+    auto totalByteCount = size_t { 0 };
+    for (auto const& param: _commandList.uploadTiles)
+        totalByteCount += param.bitmap.size();
+
+    _uploadStagingBuffer.clear();
+    _uploadStagingBuffer.reserve(totalByteCount);
+    for (auto const& param: _commandList.uploadTiles)
+        _uploadStagingBuffer.insert(_uploadStagingBuffer.end(), param.bitmap.begin(), param.bitmap.end());
+
     // clang-format off
-    // LOGSTORE(DisplayLog)("-> uploadTile: tex {} location {} format {} size {}",
-    //                      textureId, param.location, param.bitmapFormat, param.bitmapSize);
+    // LOGSTORE(DisplayLog)("-> uploadTiles: tex {} count {} bytes {}",
+    //                      _textureAtlas.textureId, _commandList.uploadTiles.size(), totalByteCount);
     // clang-format on
 
-    bindTexture(textureId);
+    CHECKED_GL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _uploadPBO));
+    CHECKED_GL(glBufferData(GL_PIXEL_UNPACK_BUFFER,
+                            static_cast<GLsizeiptr>(totalByteCount),
+                            _uploadStagingBuffer.data(),
+                            GL_STREAM_DRAW));
 
-    // Image row alignment is 1 byte (OpenGL defaults to 4).
-    CHECKED_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, param.rowAlignment));
+    bindTexture(_textureAtlas.textureId);
+
+    auto bufferOffset = uintptr_t { 0 };
+    for (auto const& param: _commandList.uploadTiles)
+    {
+        // Image row alignment is 1 byte (OpenGL defaults to 4).
+        CHECKED_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, param.rowAlignment));
+
+        CHECKED_GL(glTexSubImage2D(target,
+                                   LevelOfDetail,
+                                   param.location.x.value,
+                                   param.location.y.value,
+                                   param.bitmapSize.width.value,
+                                   param.bitmapSize.height.value,
+                                   glFormat(param.bitmapFormat),
+                                   BitmapType,
+                                   reinterpret_cast<void const*>(bufferOffset)));
+        bufferOffset += param.bitmap.size();
+    }
 
-    CHECKED_GL(glTexSubImage2D(target,
-                               LevelOfDetail,
-                               param.location.x.value,
-                               param.location.y.value,
-                               param.bitmapSize.width.value,
-                               param.bitmapSize.height.value,
-                               glFormat(param.bitmapFormat),
-                               BitmapType,
-                               param.bitmap.data()));
+    CHECKED_GL(glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0));
 }
 
 void OpenGLRenderer::executeDestroyAtlas()
@@ -645,28 +1052,7 @@ void OpenGLRenderer::bindTexture(GLuint textureId)
 
 void OpenGLRenderer::renderRectangle(int ix, int iy, Width width, Height height, RGBAColor color)
 {
-    auto const x = static_cast<GLfloat>(ix);
-    auto const y = static_cast<GLfloat>(iy);
-    auto const z = GLfloat { 0.0f };
-    auto const r = unbox<GLfloat>(width);
-    auto const s = unbox<GLfloat>(height);
-    auto const [cr, cg, cb, ca] = atlas::normalize(color);
-
-    // clang-format off
-    GLfloat const vertices[6 * 7] = {
-        // first triangle
-        x,     y + s, z, cr, cg, cb, ca,
-        x,     y,     z, cr, cg, cb, ca,
-        x + r, y,     z, cr, cg, cb, ca,
-
-        // second triangle
-        x,     y + s, z, cr, cg, cb, ca,
-        x + r, y,     z, cr, cg, cb, ca,
-        x + r, y + s, z, cr, cg, cb, ca
-    };
-    // clang-format on
-
-    crispy::copy(vertices, back_inserter(_rectBuffer));
+    _commandList.fillRectangle(ix, iy, width, height, color);
 }
 
 optional<terminal::renderer::AtlasTextureScreenshot> OpenGLRenderer::readAtlas()
@@ -721,14 +1107,9 @@ pair<ImageSize, vector<uint8_t>> OpenGLRenderer::takeScreenshot()
 
 void OpenGLRenderer::clear(terminal::RGBAColor fillColor)
 {
-    if (fillColor != _renderStateCache.backgroundColor)
-    {
-        auto const clearColor = atlas::normalize(fillColor);
-        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
-        _renderStateCache.backgroundColor = fillColor;
-    }
-
-    glClear(GL_COLOR_BUFFER_BIT);
+    // Deferred into execute(), so the clear can be confined to the frame's
+    // damage region (which is only known once the frame has been recorded).
+    _commandList.clearColor = fillColor;
 }
 
 // }}}
@@ -746,16 +1127,7 @@ struct CRISPY_PACKED BackgroundShaderParams
 
 void OpenGLRenderer::initializeBackgroundRendering()
 {
-    bound(*_backgroundShader, [&]() {
-        // clang-format off
-        CHECKED_GL(_backgroundShader->setUniformValue("fs_backgroundImage", 0)); // GL_TEXTURE0
-        CHECKED_GL(_backgroundUniformLocations.projection = _backgroundShader->uniformLocation("u_projection"));
-        CHECKED_GL(_backgroundUniformLocations.resolution = _backgroundShader->uniformLocation("u_resolution"));
-        CHECKED_GL(_backgroundUniformLocations.blur = _backgroundShader->uniformLocation("u_blur"));
-        CHECKED_GL(_backgroundUniformLocations.opacity = _backgroundShader->uniformLocation("u_opacity"));
-        CHECKED_GL(_backgroundUniformLocations.time = _backgroundShader->uniformLocation("u_time"));
-        // clang-format on
-    });
+    rebindShaderClassState(ShaderClass::BackgroundImage);
 
     // Setup VAO
     CHECKED_GL(glGenVertexArrays(1, &_backgroundVAO));
@@ -791,6 +1163,12 @@ void OpenGLRenderer::setBackgroundImage(shared_ptr<terminal::BackgroundImage con
             glDeleteTextures(1, &_backgroundImageTexture);
             _backgroundImageTexture = 0;
         }
+        if (_blurredBackgroundTexture)
+        {
+            glDeleteTextures(1, &_blurredBackgroundTexture);
+            _blurredBackgroundTexture = 0;
+        }
+        _blurredBackgroundSize = {};
     }
 
     if (!backgroundImageOpt)
@@ -870,19 +1248,110 @@ GLuint OpenGLRenderer::createAndUploadImage(ImageSize imageSize,
     return textureId;
 }
 
+void OpenGLRenderer::renderBackgroundQuad(float _width, float _height)
+{
+    // clang-format off
+    auto vertices = array {
+        // triangle 1
+        BackgroundShaderParams{vec3{   0.0f,    0.0f, 0.0f }, vec2 { 0.0f, 1.0f } }, // bottom left
+        BackgroundShaderParams{vec3{ _width,    0.0f, 0.0f }, vec2 { 1.0f, 1.0f } }, // bottom right
+        BackgroundShaderParams{vec3{ _width, _height, 0.0f }, vec2 { 1.0f, 0.0f } }, // top right
+        // riangle 2
+        BackgroundShaderParams{vec3{ _width, _height, 0.0f }, vec2 { 1.0f, 0.0f } }, // top right
+        BackgroundShaderParams{vec3{   0.0f, _height, 0.0f }, vec2 { 0.0f, 0.0f } }, // top left
+        BackgroundShaderParams{vec3{   0.0f,    0.0f, 0.0f }, vec2 { 0.0f, 1.0f } }, // bottom left
+    };
+
+    CHECKED_GL(glBindVertexArray(_backgroundVAO));
+    CHECKED_GL(glBindBuffer(GL_ARRAY_BUFFER, _backgroundVBO));
+
+    CHECKED_GL(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(BackgroundShaderParams), vertices.data(), GL_STREAM_DRAW));
+
+    auto constexpr ElementCount = sizeof(BackgroundShaderParams) / sizeof(float);
+    CHECKED_GL(glDrawArrays(GL_TRIANGLES, 0, 6 * ElementCount));
+    // clang-format on
+}
+
+void OpenGLRenderer::updateBlurredBackgroundCache()
+{
+    auto const w = unbox<float>(_renderTargetSize.width);
+    auto const h = unbox<float>(_renderTargetSize.height);
+
+    // Mark this target size as attempted up front; a failed attempt leaves the
+    // cache texture at 0 and we keep blurring per frame without retrying.
+    _blurredBackgroundSize = _renderTargetSize;
+
+    GLint previousFBO {};
+    CHECKED_GL(glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFBO));
+
+    if (!_blurredBackgroundTexture)
+        CHECKED_GL(glGenTextures(1, &_blurredBackgroundTexture));
+    bindTexture(_blurredBackgroundTexture);
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+    CHECKED_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    CHECKED_GL(glTexImage2D(GL_TEXTURE_2D,
+                            0,
+                            GL_RGBA,
+                            unbox<GLsizei>(_renderTargetSize.width),
+                            unbox<GLsizei>(_renderTargetSize.height),
+                            0,
+                            GL_RGBA,
+                            GL_UNSIGNED_BYTE,
+                            nullptr));
+
+    auto fbo = GLuint {};
+    CHECKED_GL(glGenFramebuffers(1, &fbo));
+    CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, fbo));
+    CHECKED_GL(glFramebufferTexture2D(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _blurredBackgroundTexture, 0));
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        LOGSTORE(DisplayLog)("Blurred background cache FBO incomplete; keeping per-frame blur.");
+        CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFBO)));
+        CHECKED_GL(glDeleteFramebuffers(1, &fbo));
+        CHECKED_GL(glDeleteTextures(1, &_blurredBackgroundTexture));
+        _blurredBackgroundTexture = 0;
+        return;
+    }
+
+    // One-time blur pass: source image in, blurred pixels out, full opacity.
+    _backgroundShader->setUniformValue(_backgroundUniformLocations.projection, _projectionMatrix);
+    _backgroundShader->setUniformValue(_backgroundUniformLocations.resolution, w, h);
+    _backgroundShader->setUniformValue(_backgroundUniformLocations.blur, 1.0f);
+    _backgroundShader->setUniformValue(_backgroundUniformLocations.opacity, 1.0f);
+
+    CHECKED_GL(glActiveTexture(GL_TEXTURE0));
+    CHECKED_GL(bindTexture(_backgroundImageTexture));
+    renderBackgroundQuad(w, h);
+
+    CHECKED_GL(glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFBO)));
+    CHECKED_GL(glDeleteFramebuffers(1, &fbo));
+
+    LOGSTORE(DisplayLog)("Cached blurred background image at {}.", _renderTargetSize);
+}
+
 void OpenGLRenderer::executeRenderBackground()
 {
     Require(_backgroundImageTexture != 0);
 
+    // (Re-)fill the blurred background cache when the image or target size
+    // changed, so the expensive blur kernel runs once instead of per frame.
+    if (_renderStateCache.backgroundImageBlur && _blurredBackgroundSize != _renderTargetSize)
+        updateBlurredBackgroundCache();
+
     auto const w = unbox<float>(_renderTargetSize.width);
     auto const h = unbox<float>(_renderTargetSize.height);
+    bool const sampleBlurCache = _renderStateCache.backgroundImageBlur && _blurredBackgroundTexture != 0;
 
     // {{{ setup uniforms
     auto const opacity =
         float(_renderStateCache.backgroundColor.alpha()) / 255.0f * _renderStateCache.backgroundImageOpacity;
     auto const now = chrono::steady_clock::now().time_since_epoch();
     auto const timestamp = chrono::duration_cast<chrono::milliseconds>(now).count();
-    auto const blur = _renderStateCache.backgroundImageBlur ? 1.0f : 0.0f;
+    auto const blur = _renderStateCache.backgroundImageBlur && !sampleBlurCache ? 1.0f : 0.0f;
 
     _backgroundShader->setUniformValue(_backgroundUniformLocations.projection, _projectionMatrix);
     _backgroundShader->setUniformValue(_backgroundUniformLocations.resolution, w, h);
@@ -892,28 +1361,9 @@ void OpenGLRenderer::executeRenderBackground()
                                        static_cast<float>(static_cast<double>(timestamp) / 1000.0));
     // }}}
 
-    // clang-format off
-    auto vertices = array {
-        // triangle 1
-        BackgroundShaderParams{vec3{ 0.0f, 0.0f, 0.0f }, vec2 { 0.0f, 1.0f } }, // bottom left
-        BackgroundShaderParams{vec3{    w, 0.0f, 0.0f }, vec2 { 1.0f, 1.0f } }, // bottom right
-        BackgroundShaderParams{vec3{    w,    h, 0.0f }, vec2 { 1.0f, 0.0f } }, // top right
-        // riangle 2
-        BackgroundShaderParams{vec3{    w,    h, 0.0f }, vec2 { 1.0f, 0.0f } }, // top right
-        BackgroundShaderParams{vec3{    0,    h, 0.0f }, vec2 { 0.0f, 0.0f } }, // top left
-        BackgroundShaderParams{vec3{ 0.0f,    0, 0.0f }, vec2 { 0.0f, 1.0f } }, // bottom left
-    };
-
     CHECKED_GL(glActiveTexture(GL_TEXTURE0));
-    CHECKED_GL(bindTexture(_backgroundImageTexture));
-    CHECKED_GL(glBindVertexArray(_backgroundVAO));
-    CHECKED_GL(glBindBuffer(GL_ARRAY_BUFFER, _backgroundVBO));
-
-    CHECKED_GL(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(BackgroundShaderParams), vertices.data(), GL_STREAM_DRAW));
-
-    auto constexpr ElementCount = sizeof(BackgroundShaderParams) / sizeof(float);
-    CHECKED_GL(glDrawArrays(GL_TRIANGLES, 0, 6 * ElementCount));
-    // clang-format on
+    CHECKED_GL(bindTexture(sampleBlurCache ? _blurredBackgroundTexture : _backgroundImageTexture));
+    renderBackgroundQuad(w, h);
 }
 // }}}
 
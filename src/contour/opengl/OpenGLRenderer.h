@@ -13,6 +13,8 @@
  */
 #pragma once
 
+#include <contour/opengl/ShaderConfig.h>
+
 #include <terminal/Image.h>
 
 #include <terminal_renderer/RenderTarget.h>
@@ -26,19 +28,17 @@
     #include <QtGui/QOpenGLShaderProgram>
 #endif
 
+#include <array>
 #include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace contour::opengl
 {
 
-struct ShaderConfig;
-
-class OpenGLRenderer final:
-    public terminal::renderer::RenderTarget,
-    public terminal::renderer::atlas::AtlasBackend,
-    public QOpenGLExtraFunctions
+class OpenGLRenderer final: public terminal::renderer::RenderTarget, public QOpenGLExtraFunctions
 {
     using ImageSize = terminal::ImageSize;
 
@@ -62,26 +62,23 @@ class OpenGLRenderer final:
                    ShaderConfig const& backgroundImageShaderConfig,
                    crispy::ImageSize renderSize,
                    crispy::ImageSize textureTileSize,
-                   terminal::renderer::PageMargin margin);
+                   terminal::renderer::PageMargin margin,
+                   bool directVertexMapping = false,
+                   terminal::renderer::PixelFormat pixelFormat = terminal::renderer::PixelFormat::RGBA8);
 
     ~OpenGLRenderer() override;
 
-    // AtlasBackend implementation
-    ImageSize atlasSize() const noexcept override;
-    void configureAtlas(ConfigureAtlas atlas) override;
-    void uploadTile(UploadTile tile) override;
-    void renderTile(RenderTile tile) override;
-
     // RenderTarget implementation
     void setRenderSize(crispy::ImageSize _size) override;
     void setMargin(terminal::renderer::PageMargin _margin) noexcept override;
     std::optional<AtlasTextureScreenshot> readAtlas() override;
-    AtlasBackend& textureScheduler() override;
+    terminal::renderer::RenderCommandList& commandList() noexcept override;
     void scheduleScreenshot(ScreenshotCallback _callback) override;
     void setBackgroundImage(
         std::shared_ptr<terminal::BackgroundImage const> const& _backgroundImage) override;
     void renderRectangle(int x, int y, Width, Height, RGBAColor color) override;
     void clear(terminal::RGBAColor _fillColor) override;
+    void setFrameTint(RGBAColor _tint) noexcept override { _frameTint = _tint; }
     void execute() override;
 
     std::pair<crispy::ImageSize, std::vector<uint8_t>> takeScreenshot();
@@ -90,6 +87,20 @@ class OpenGLRenderer final:
 
     void inspect(std::ostream& output) const override;
 
+    // {{{ precompiled shader program variants
+    /// Compiles and links @p config into the variant table under
+    /// (@p shaderClass, @p name). A no-op while an entry with unchanged
+    /// sources exists; an edited source replaces the entry. Returns false
+    /// if compilation failed, keeping the previous entry (if any) intact.
+    bool precompileShaderVariant(ShaderClass shaderClass, std::string_view name, ShaderConfig const& config);
+
+    /// Makes a previously precompiled variant the active program of its
+    /// shader class - a program re-bind plus re-resolving its uniform
+    /// locations, never a GLSL compile. A no-op when already active;
+    /// returns false if no such variant exists.
+    bool activateShaderVariant(ShaderClass shaderClass, std::string_view name);
+    // }}}
+
   private:
     // private helper methods
     //
@@ -107,67 +118,117 @@ class OpenGLRenderer final:
                                 int rowAlignment,
                                 uint8_t const* pixels);
 
+    /// Shifts the retained render target's pixels as instructed, via an
+    /// intermediate scratch texture (framebuffer self-blits with overlapping
+    /// regions are undefined). Returns false if no usable FBO is available,
+    /// in which case the caller must compose the whole frame.
+    bool executeScrollBlit(terminal::renderer::RenderCommandList::ScrollBlit const& _scroll);
+
     void executeRenderBackground();
+    void renderBackgroundQuad(float _width, float _height);
+    void updateBlurredBackgroundCache();
     void executeRenderTextures();
     void executeConfigureAtlas(ConfigureAtlas const& _param);
-    void executeUploadTile(UploadTile const& _param);
-    void executeRenderTile(RenderTile const& _param);
+    void executeUploadTiles();
     void executeDestroyAtlas();
 
+    void appendTileVertices(RenderTile const& _tile, GLfloat* _output);
+    void appendRectVertices(terminal::renderer::RenderCommandList::FillRectangle const& _rect);
+
+    /// Builds the text vertex stream for the pending render tiles directly
+    /// inside the mapped GL_ARRAY_BUFFER (must be bound), skipping the
+    /// host-side staging vector and the delta mirror.
+    ///
+    /// @returns false if the buffer could not be mapped (or the mapping got
+    ///          lost), in which case the caller must take the staging path.
+    bool streamTileVerticesMapped(size_t _vertexFloatCount);
+
     //? void renderRectangle(int _x, int _y, int _width, int _height, QVector4D const& _color);
 
     void bindTexture(GLuint _textureId);
 
-    // -------------------------------------------------------------------------------------------
-    // private data members
-    //
-
-    // {{{ scheduling data
-    struct RenderBatch
+    // {{{ precompiled shader program variants (private parts)
+    // Every program a session may switch between lives in this table,
+    // compiled and linked ahead of time (the construction-time configs
+    // under the "default" name); switching a shader class's active program
+    // is then a re-bind instead of a GLSL compile+link, which takes
+    // hundreds of milliseconds on some driver stacks and would hitch a
+    // live profile reload mid-session.
+    struct ShaderVariant
     {
-        std::vector<terminal::renderer::atlas::RenderTile> renderTiles;
-        std::vector<GLfloat> buffer;
-        uint32_t userdata = 0;
-
-        void clear()
-        {
-            renderTiles.clear();
-            buffer.clear();
-        }
+        std::unique_ptr<QOpenGLShaderProgram> program;
+        uint64_t sourceHash = 0; //!< FNV over both GLSL sources, to detect edited variants
     };
 
-    struct Scheduler
+    static std::string shaderVariantKey(ShaderClass shaderClass, std::string_view name);
+
+    /// Returns the slot holding @p shaderClass's active program.
+    QOpenGLShaderProgram*& activeShaderProgram(ShaderClass shaderClass) noexcept;
+
+    /// Re-resolves the active program's uniform locations and re-applies
+    /// its static uniforms after a variant switch.
+    void rebindShaderClassState(ShaderClass shaderClass);
+
+    std::unordered_map<std::string, ShaderVariant> _shaderVariants;
+    std::array<std::string, 3> _activeShaderVariants {}; //!< active variant name per ShaderClass
+    // }}}
+
+    // {{{ minimal vertex buffer uploads
+    // CPU-side mirror of a VBO's current contents plus its allocated float count,
+    // used to diff a new frame against the previous one and upload only the
+    // changed byte range instead of re-streaming the whole buffer.
+    struct VertexBufferMirror
     {
-        std::optional<terminal::renderer::atlas::ConfigureAtlas> configureAtlas = std::nullopt;
-        std::vector<terminal::renderer::atlas::UploadTile> uploadTiles {};
-        RenderBatch renderBatch {};
-
-        void clear()
-        {
-            configureAtlas.reset();
-            uploadTiles.clear();
-            renderBatch.clear();
-        }
+        std::vector<GLfloat> contents;
+        size_t capacity = 0;
     };
 
-    Scheduler _scheduledExecutions;
+    /// Uploads @p _buffer into the currently bound GL_ARRAY_BUFFER,
+    /// transferring only the span that differs from the previous frame.
+    void uploadVertexDelta(VertexBufferMirror& _mirror, std::vector<GLfloat> const& _buffer);
+    // }}}
+
+    // -------------------------------------------------------------------------------------------
+    // private data members
+    //
+
+    // {{{ scheduling data
+    // The backend-neutral command list all render subsystems record into;
+    // consumed (and cleared) by execute().
+    terminal::renderer::RenderCommandList _commandList;
     // }}}
 
     bool _initialized = false;
     crispy::ImageSize _renderTargetSize;
+    // Output surface pixel format; internal scratch surfaces are allocated to
+    // match, so blits against the default framebuffer never convert.
+    terminal::renderer::PixelFormat _pixelFormat = terminal::renderer::PixelFormat::RGBA8;
+    crispy::ImageSize _lastFrameTargetSize {}; // target size the previous frame was executed at
     QMatrix4x4 _projectionMatrix;
 
     terminal::renderer::PageMargin _margin {};
 
-    std::unique_ptr<QOpenGLShaderProgram> _textShader;
-    int _textProjectionLocation;
+    QOpenGLShaderProgram* _textShader = nullptr; //!< active text program, owned by _shaderVariants
+    int _textProjectionLocation = -1;
 
     // private data members for rendering textures
     //
     GLuint _textVAO {}; // Vertex Array Object, covering all buffer objects
     GLuint _textVBO {}; // Buffer containing the vertex coordinates
+    std::vector<GLfloat> _textBuffer; // CPU-side vertex staging, rebuilt from the command list per frame
+    VertexBufferMirror _textBufferMirror;
+
+    // Direct vertex streaming (renderer.direct_vertex_mapping): vertices are
+    // written straight into the mapped VBO (see streamTileVerticesMapped()).
+    bool _directVertexMapping = false;
+    size_t _mappedTextCapacity = 0; // allocated text VBO capacity, in floats
     // TODO: GLuint ebo_{};
 
+    // Pixel unpack buffer (PBO) plus its CPU-side staging area, used to batch
+    // all pending atlas tile uploads into a single buffer transfer per frame.
+    GLuint _uploadPBO {};
+    std::vector<uint8_t> _uploadStagingBuffer;
+
     // currently bound texture ID during execution
     GLuint _currentTextureId = std::numeric_limits<GLuint>::max();
 
@@ -175,7 +236,13 @@ class OpenGLRenderer final:
     GLuint _backgroundVAO {};
     GLuint _backgroundVBO {};
     GLuint _backgroundImageTexture {};
-    std::unique_ptr<QOpenGLShaderProgram> _backgroundShader;
+    // Cache texture holding the background image already blurred at target
+    // resolution, so the blur kernel runs once instead of per frame. A texture
+    // of 0 with a non-default size means the cache could not be built (no
+    // usable FBO) and the per-frame blur path remains in effect.
+    GLuint _blurredBackgroundTexture {};
+    crispy::ImageSize _blurredBackgroundSize {};
+    QOpenGLShaderProgram* _backgroundShader = nullptr; //!< active program, owned by _shaderVariants
     struct
     {
         int projection;
@@ -185,6 +252,14 @@ class OpenGLRenderer final:
         int time;
     } _backgroundUniformLocations {};
 
+    // Scratch texture + FBO for the viewport scroll blit, (re-)allocated at
+    // render target size. A texture of 0 with a non-default size means the
+    // allocation failed (no usable FBO) and scrolled frames are composed in
+    // full instead.
+    GLuint _scrollScratchTexture {};
+    GLuint _scrollScratchFBO {};
+    crispy::ImageSize _scrollScratchSize {};
+
     // index equals AtlasID
     struct AtlasAttributes
     {
@@ -197,11 +272,20 @@ class OpenGLRenderer final:
     // private data members for rendering filled rectangles
     //
     std::vector<GLfloat> _rectBuffer;
-    std::unique_ptr<QOpenGLShaderProgram> _rectShader;
-    GLint _rectProjectionLocation;
+    VertexBufferMirror _rectBufferMirror;
+    QOpenGLShaderProgram* _rectShader = nullptr; //!< active rect program, owned by _shaderVariants
+    GLint _rectProjectionLocation = -1;
     GLuint _rectVAO;
     GLuint _rectVBO;
 
+    // Fullscreen quad blended over the finished frame (see setFrameTint());
+    // uses the rect shader but a dedicated VBO, so the rect buffer's
+    // frame-to-frame delta tracking stays intact.
+    GLuint _tintVAO;
+    GLuint _tintVBO;
+    terminal::RGBAColor _frameTint {};
+    terminal::RGBAColor _lastAppliedFrameTint {};
+
     std::optional<ScreenshotCallback> _pendingScreenshotCallback;
 
     // render state cache
@@ -66,9 +66,15 @@ std::unique_ptr<QOpenGLShaderProgram> createShader(ShaderConfig const& _shaderCo
         return { source.location.toStdString(), source.contents.toStdString() };
     };
 
+    // addCacheableShaderFromSourceCode() persists linked program binaries
+    // (via glGetProgramBinary, keyed by driver and source) into Qt's on-disk
+    // cache, so subsequent startups skip the 100-300ms GLSL compile+link some
+    // driver stacks take; on any driver or source mismatch Qt transparently
+    // falls back to compiling from source.
+
     auto [vertexLocation, vertexSource] = extractShaderSource(_shaderConfig.vertexShader);
     LOGSTORE(DisplayLog)("Loading vertex shader: {}", vertexLocation);
-    if (!shader->addShaderFromSourceCode(QOpenGLShader::Vertex, vertexSource.c_str()))
+    if (!shader->addCacheableShaderFromSourceCode(QOpenGLShader::Vertex, vertexSource.c_str()))
     {
         errorlog()("Compiling vertex shader {} failed. {}", vertexLocation, shader->log().toStdString());
         qDebug() << shader->log();
@@ -77,7 +83,7 @@ std::unique_ptr<QOpenGLShaderProgram> createShader(ShaderConfig const& _shaderCo
 
     auto [fragmentLocation, fragmentSource] = extractShaderSource(_shaderConfig.fragmentShader);
     LOGSTORE(DisplayLog)("Loading fragment shader: {}", fragmentLocation);
-    if (!shader->addShaderFromSourceCode(QOpenGLShader::Fragment, fragmentSource.c_str()))
+    if (!shader->addCacheableShaderFromSourceCode(QOpenGLShader::Fragment, fragmentSource.c_str()))
     {
         errorlog()("Compiling fragment shader {} failed. {}", fragmentLocation, shader->log().toStdString());
         qDebug() << shader->log();
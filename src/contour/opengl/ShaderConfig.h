@@ -28,6 +28,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 
 namespace contour::opengl
 {
@@ -39,6 +40,13 @@ enum class ShaderClass
     Text
 };
 
+// Well-known names in OpenGLRenderer's precompiled shader variant table:
+// "default" is whatever the renderer was constructed with, "builtin" the
+// shipped shader and "custom" the profile's override (when configured).
+constexpr inline std::string_view DefaultShaderVariantName = "default";
+constexpr inline std::string_view BuiltinShaderVariantName = "builtin";
+constexpr inline std::string_view CustomShaderVariantName = "custom";
+
 struct ShaderSource
 {
     QString location;
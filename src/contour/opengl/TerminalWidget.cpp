@@ -21,7 +21,9 @@
 #include <terminal/Metrics.h>
 #include <terminal/pty/Pty.h>
 
+#include <crispy/AllocationTracker.h>
 #include <crispy/App.h>
+#include <crispy/PerfCounters.h>
 #include <crispy/logstore.h>
 #include <crispy/stdfs.h>
 
@@ -32,6 +34,7 @@
 #include <QtCore/QProcess>
 #include <QtCore/QStandardPaths>
 #include <QtCore/QTimer>
+#include <QtGui/QAccessible>
 #include <QtGui/QClipboard>
 #include <QtGui/QDesktopServices>
 #include <QtGui/QGuiApplication>
@@ -258,17 +261,26 @@ TerminalWidget::TerminalWidget(TerminalSession& session,
     initializeResourcesForContourFrontendOpenGL();
 
     setMouseTracking(true);
-    setFormat(surfaceFormat());
+    setFormat(surfaceFormat(session_.config().outputPixelFormat));
 
     setAttribute(Qt::WA_InputMethodEnabled, true);
     setAttribute(Qt::WA_OpaquePaintEvent);
 
+    // Keep the widget's framebuffer contents across paintGL() calls, so the
+    // renderer can confine clears and draws to the frame's damage region
+    // (see RenderCommandList::damage) instead of re-compositing all pixels.
+    // The window-system present itself remains in Qt's hands.
+    setUpdateBehavior(QOpenGLWidget::PartialUpdate);
+
     // setAttribute(Qt::WA_TranslucentBackground);
     // setAttribute(Qt::WA_NoSystemBackground, false);
 
     updateTimer_.setSingleShot(true);
     connect(&updateTimer_, &QTimer::timeout, [this]() { scheduleRedraw(); });
 
+    dpiChangeTimer_.setSingleShot(true);
+    connect(&dpiChangeTimer_, &QTimer::timeout, [this]() { applyFontDPI(); });
+
     connect(this, SIGNAL(frameSwapped()), this, SLOT(onFrameSwapped()));
 }
 
@@ -280,7 +292,7 @@ TerminalWidget::~TerminalWidget()
     doneCurrent();
 }
 
-QSurfaceFormat TerminalWidget::surfaceFormat()
+QSurfaceFormat TerminalWidget::surfaceFormat(config::OutputPixelFormat _pixelFormat)
 {
     QSurfaceFormat format;
 
@@ -293,7 +305,28 @@ QSurfaceFormat TerminalWidget::surfaceFormat()
 
     format.setVersion(3, 3);
     format.setProfile(QSurfaceFormat::CoreProfile);
-    format.setAlphaBufferSize(8);
+
+    // A deep surface format makes the windowing system hand out an HDR-capable
+    // default framebuffer; the renderer then composes into it directly (and
+    // format-matches its scratch surfaces), with no conversion pass anywhere.
+    // The driver falls back to the nearest supported format when unavailable.
+    switch (_pixelFormat)
+    {
+    case config::OutputPixelFormat::Default: format.setAlphaBufferSize(8); break;
+    case config::OutputPixelFormat::TenBit:
+        format.setRedBufferSize(10);
+        format.setGreenBufferSize(10);
+        format.setBlueBufferSize(10);
+        format.setAlphaBufferSize(2);
+        break;
+    case config::OutputPixelFormat::HalfFloat:
+        format.setRedBufferSize(16);
+        format.setGreenBufferSize(16);
+        format.setBlueBufferSize(16);
+        format.setAlphaBufferSize(16);
+        break;
+    }
+
     format.setSwapBehavior(QSurfaceFormat::DoubleBuffer);
     format.setSwapInterval(1);
 
@@ -364,6 +397,21 @@ void TerminalWidget::onScreenChanged()
 }
 
 void TerminalWidget::onScreenDpiChanged()
+{
+    if (fontDPI() == lastFontDPI_)
+        return;
+
+    // DPI change notifications arrive in bursts while a window is dragged
+    // across monitors (and KDE's config watcher may fire on top of Qt's
+    // screen signal). Applying one means reloading the font set and
+    // rebuilding the texture atlas - a several-hundred-millisecond stall -
+    // so defer until the reported value has settled; meanwhile frames keep
+    // rendering from the previous metrics and atlas generation.
+    auto constexpr SettleTimeMillis = 500;
+    dpiChangeTimer_.start(SettleTimeMillis);
+}
+
+void TerminalWidget::applyFontDPI()
 {
     auto const newFontDPI = fontDPI();
     if (newFontDPI == lastFontDPI_)
@@ -382,6 +430,10 @@ void TerminalWidget::onScreenDpiChanged()
 
     // Apply resize on same window metrics propagates proper recalculations and repaint.
     applyResize(newPixelSize, session_, *renderer_);
+
+    // The rebuilt atlas generation starts out empty; re-seed it with the
+    // configured pre-warm pack before the first frame renders from it.
+    renderer_->prewarmAtlas(session_.config().atlasPrewarm);
 }
 
 void TerminalWidget::logDisplayTopInfo()
@@ -497,6 +549,7 @@ void TerminalWidget::initializeGL()
                          session_.config().textureAtlasHashtableSlots,
                          session_.config().textureAtlasTileCount,
                          session_.config().textureAtlasDirectMapping,
+                         session_.config().maxGpuTextureMemory,
                          profile().hyperlinkDecoration.normal,
                          profile().hyperlinkDecoration.hover
                          // TODO: , WindowMargin(windowMargin_.left, windowMargin_.bottom);
@@ -512,15 +565,51 @@ void TerminalWidget::initializeGL()
         return uiSize * contentScale();
     }();
 
+    auto const outputPixelFormat = [this]() {
+        switch (session_.config().outputPixelFormat)
+        {
+        case config::OutputPixelFormat::TenBit: return terminal::renderer::PixelFormat::RGB10A2;
+        case config::OutputPixelFormat::HalfFloat: return terminal::renderer::PixelFormat::RGBA16F;
+        case config::OutputPixelFormat::Default: break;
+        }
+        return terminal::renderer::PixelFormat::RGBA8;
+    }();
+    if (outputPixelFormat != terminal::renderer::PixelFormat::RGBA8)
+        DisplayLog()("Rendering into {} surface (R{}G{}B{}A{}).",
+                     outputPixelFormat,
+                     format().redBufferSize(),
+                     format().greenBufferSize(),
+                     format().blueBufferSize(),
+                     format().alphaBufferSize());
+
     renderTarget_ = make_unique<OpenGLRenderer>(
         profile().textShader.value_or(builtinShaderConfig(ShaderClass::Text)),
         profile().backgroundShader.value_or(builtinShaderConfig(ShaderClass::Background)),
         profile().backgroundImageShader.value_or(builtinShaderConfig(ShaderClass::BackgroundImage)),
         precalculatedVieewSize,
         textureTileSize,
-        viewportMargin);
+        viewportMargin,
+        session_.config().directVertexMapping,
+        outputPixelFormat);
+
+    // When the profile overrides a shader class with a custom shader (the
+    // construction-time "default" then), the builtin program is precompiled
+    // alongside it, so a later live reload dropping the override switches
+    // programs without a mid-session GLSL compile hitch.
+    if (profile().textShader)
+        renderTarget_->precompileShaderVariant(
+            ShaderClass::Text, BuiltinShaderVariantName, builtinShaderConfig(ShaderClass::Text));
+    if (profile().backgroundShader)
+        renderTarget_->precompileShaderVariant(ShaderClass::Background,
+                                               BuiltinShaderVariantName,
+                                               builtinShaderConfig(ShaderClass::Background));
+    if (profile().backgroundImageShader)
+        renderTarget_->precompileShaderVariant(ShaderClass::BackgroundImage,
+                                               BuiltinShaderVariantName,
+                                               builtinShaderConfig(ShaderClass::BackgroundImage));
 
     renderer_->setRenderTarget(*renderTarget_);
+    renderer_->prewarmAtlas(session_.config().atlasPrewarm);
 
     session_.setContentScale(contentScale());
 
@@ -550,6 +639,8 @@ void TerminalWidget::paintGL()
 {
     try
     {
+        session_.flushPendingMouseMove();
+
         [[maybe_unused]] auto const lastState = state_.fetchAndClear();
 
 #if defined(CONTOUR_PERF_STATS)
@@ -568,11 +659,20 @@ void TerminalWidget::paintGL()
         }
 #endif
 
+        // Pin one immutable configuration snapshot for the whole frame, so a
+        // concurrent live reload cannot change values mid-frame.
+        auto const config = session_.configSnapshot();
+        auto const& colors = config->profile.colors;
+
+        applyShaderVariants(*config);
+
         renderTarget_->clear(
             terminal().screen().isModeEnabled(terminal::DECMode::ReverseVideo)
-                ? RGBAColor(profile().colors.defaultForeground, uint8_t(renderer_->backgroundOpacity()))
-                : RGBAColor(profile().colors.defaultBackground, uint8_t(renderer_->backgroundOpacity())));
+                ? RGBAColor(colors.defaultForeground, uint8_t(renderer_->backgroundOpacity()))
+                : RGBAColor(colors.defaultBackground, uint8_t(renderer_->backgroundOpacity())));
+        updateFrameTint();
         renderer_->render(terminal(), renderingPressure_);
+        updateAccessibilityFeed();
     }
     catch (exception const& e)
     {
@@ -580,8 +680,93 @@ void TerminalWidget::paintGL()
     }
 }
 
+void TerminalWidget::updateAccessibilityFeed()
+{
+    // Screen readers are fed incrementally from the same per-line modification
+    // generations the render damage tracking uses (see fetchLineTextDeltas()):
+    // with no AT client attached this is one boolean check per frame, and with
+    // one attached only changed lines are extracted and announced - the full
+    // screen text is never re-exported per update.
+    if (!QAccessible::isActive())
+        return;
+
+    // The screen is exposed as one text stream of newline-terminated rows;
+    // page geometry is read from the lock-free viewport snapshot.
+    auto const columns = unbox<int>(terminal().viewportSnapshot().pageSize.columns);
+    for (terminal::Terminal::LineTextDelta const& delta: terminal().fetchLineTextDeltas())
+    {
+        auto const position = unbox<int>(delta.line) * (columns + 1);
+        auto event = QAccessibleTextUpdateEvent(
+            this, position, QString(), QString::fromUtf8(delta.text.data(), int(delta.text.size())));
+        QAccessible::updateAccessibility(&event);
+    }
+}
+
+void TerminalWidget::applyShaderVariants(TerminalSession::ConfigSnapshot const& _config)
+{
+    // Shader selection follows the pinned config snapshot: on a live profile
+    // reload the desired variant is activated from the renderer's
+    // precompiled table - a program re-bind, not a GLSL compile+link. Only a
+    // genuinely new custom shader source still compiles, once
+    // (precompileShaderVariant() no-ops while the sources are unchanged).
+    if (&_config == appliedShaderSnapshot_)
+        return;
+    appliedShaderSnapshot_ = &_config;
+
+    auto const apply = [&](ShaderClass _shaderClass, std::optional<ShaderConfig> const& _custom) {
+        if (_custom)
+        {
+            renderTarget_->precompileShaderVariant(_shaderClass, CustomShaderVariantName, *_custom);
+            renderTarget_->activateShaderVariant(_shaderClass, CustomShaderVariantName);
+        }
+        // The builtin variant only exists when a custom shader was active at
+        // some point; otherwise the construction-time default is the builtin.
+        else if (!renderTarget_->activateShaderVariant(_shaderClass, BuiltinShaderVariantName))
+            renderTarget_->activateShaderVariant(_shaderClass, DefaultShaderVariantName);
+    };
+    apply(ShaderClass::Text, _config.profile.textShader);
+    apply(ShaderClass::Background, _config.profile.backgroundShader);
+    apply(ShaderClass::BackgroundImage, _config.profile.backgroundImageShader);
+}
+
+void TerminalWidget::updateFrameTint()
+{
+    // Both effects are pure render-backend overlay state (see
+    // RenderTarget::setFrameTint): the render buffer and the grid stay
+    // untouched, so a flash or focus change never forces a screen rebuild.
+    auto constexpr FlashDuration = std::chrono::milliseconds(250);
+    auto constexpr FlashMaxAlpha = 96;    // out of 255
+    auto constexpr InactiveDimAlpha = 48; // out of 255
+
+    auto tint = RGBAColor {};
+
+    if (profile().dimWhenInactive && !hasFocus())
+        tint = RGBAColor(0, 0, 0, InactiveDimAlpha);
+
+    if (bellFlashStart_ != std::chrono::steady_clock::time_point {})
+    {
+        auto const elapsed =
+            std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - bellFlashStart_);
+        if (elapsed < FlashDuration)
+        {
+            // The flash dominates the inactive dim while it lasts.
+            auto const alpha = FlashMaxAlpha - FlashMaxAlpha * elapsed.count() / FlashDuration.count();
+            tint = RGBAColor(0xFF, 0xFF, 0xFF, static_cast<uint8_t>(alpha));
+            update(); // keep animating until the flash has fully decayed
+        }
+        else
+            bellFlashStart_ = {};
+    }
+
+    renderTarget_->setFrameTint(tint);
+}
+
 void TerminalWidget::onFrameSwapped()
 {
+    // Feed the vsync timestamp back to the terminal, so the VT thread can pace
+    // its render buffer refreshes to land just before the upcoming vblank.
+    terminal().markFrameSwapped(steady_clock::now());
+
     if (!state_.finish())
         update();
     else if (auto timeout = terminal().nextRender(); timeout.has_value())
@@ -618,13 +803,25 @@ void TerminalWidget::mouseReleaseEvent(QMouseEvent* _event)
 void TerminalWidget::focusInEvent(QFocusEvent* _event)
 {
     QOpenGLWidget::focusInEvent(_event);
-    session_.sendFocusInEvent(); // TODO: paint with "normal" colors
+    session_.sendFocusInEvent();
+
+    if (profile().dimWhenInactive)
+    {
+        setScreenDirty();
+        update();
+    }
 }
 
 void TerminalWidget::focusOutEvent(QFocusEvent* _event)
 {
     QOpenGLWidget::focusOutEvent(_event);
-    session_.sendFocusOutEvent(); // TODO maybe paint with "faint" colors
+    session_.sendFocusOutEvent();
+
+    if (profile().dimWhenInactive)
+    {
+        setScreenDirty();
+        update();
+    }
 }
 
 void TerminalWidget::inputMethodEvent(QInputMethodEvent* _event)
@@ -818,6 +1015,13 @@ terminal::FontDef TerminalWidget::getFontDef()
 void TerminalWidget::bell()
 {
     QApplication::beep();
+
+    if (profile().visualBell)
+    {
+        bellFlashStart_ = steady_clock::now();
+        setScreenDirty();
+        update();
+    }
 }
 
 void TerminalWidget::copyToClipboard(std::string_view _data)
@@ -860,6 +1064,12 @@ void TerminalWidget::doDumpState()
             auto os = std::stringstream {};
             terminal().screen().inspect("Screen state dump.", os);
             renderer_->inspect(os);
+#if defined(CONTOUR_PERF_COUNTERS)
+            crispy::perf::inspect(os);
+#endif
+#if defined(CONTOUR_ALLOCATION_TRACKER)
+            crispy::alloc::inspect(os);
+#endif
             return os.str();
         }();
 
@@ -1018,6 +1228,17 @@ void TerminalWidget::resizeWindow(terminal::LineCount _lines, terminal::ColumnCo
     adaptSize_();
 }
 
+void TerminalWidget::setAtlasCacheCapacity(crispy::StrongHashtableSize _hashtableSlots,
+                                           crispy::LRUCapacity _tileCount)
+{
+    if (!renderer_.is_initialized())
+        return;
+
+    makeCurrent(); // ensure GL context is current, as the atlas is rebuilt
+    renderer_->setAtlasCacheCapacity(_hashtableSlots, _tileCount);
+    scheduleRedraw();
+}
+
 void TerminalWidget::setFonts(terminal::renderer::FontDescriptions fonts)
 {
     if (applyFontDescription(gridMetrics().cellSize, pageSize(), pixelSize(), fontDPI(), *renderer_, fonts))
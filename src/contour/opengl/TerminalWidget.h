@@ -18,6 +18,7 @@
 #include <contour/TerminalDisplay.h>
 #include <contour/TerminalSession.h>
 #include <contour/helper.h>
+#include <contour/opengl/OpenGLRenderer.h>
 
 #include <terminal/Color.h>
 #include <terminal/Metrics.h>
@@ -42,6 +43,7 @@
 #include <QtWidgets/QSystemTrayIcon>
 
 #include <atomic>
+#include <chrono>
 #include <fstream>
 #include <memory>
 #include <optional>
@@ -64,7 +66,8 @@ class TerminalWidget: public QOpenGLWidget, public TerminalDisplay, private QOpe
     ~TerminalWidget() override;
 
     // {{{ OpenGL rendering handling
-    static QSurfaceFormat surfaceFormat();
+    static QSurfaceFormat surfaceFormat(
+        config::OutputPixelFormat _pixelFormat = config::OutputPixelFormat::Default);
     QSize minimumSizeHint() const override;
     QSize sizeHint() const override;
     void initializeGL() override;
@@ -108,6 +111,8 @@ class TerminalWidget: public QOpenGLWidget, public TerminalDisplay, private QOpe
     void notify(std::string_view /*_title*/, std::string_view /*_body*/) override;
     void resizeWindow(terminal::LineCount, terminal::ColumnCount) override;
     void resizeWindow(terminal::Width, terminal::Height) override;
+    void setAtlasCacheCapacity(crispy::StrongHashtableSize _hashtableSlots,
+                               crispy::LRUCapacity _tileCount) override;
     void setFonts(terminal::renderer::FontDescriptions _fontDescriptions) override;
     bool setFontSize(text::font_size _size) override;
     bool setPageSize(terminal::PageSize _newPageSize) override;
@@ -154,6 +159,10 @@ class TerminalWidget: public QOpenGLWidget, public TerminalDisplay, private QOpe
     void logDisplayTopInfo();
     void logDisplayInfo();
     void watchKdeDpiSetting();
+    void applyFontDPI();
+    void updateFrameTint();
+    void updateAccessibilityFeed();
+    void applyShaderVariants(TerminalSession::ConfigSnapshot const& _config);
 
     terminal::PageSize pageSize() const
     {
@@ -193,13 +202,26 @@ class TerminalWidget: public QOpenGLWidget, public TerminalDisplay, private QOpe
     text::DPI lastFontDPI_;
     crispy::deferred<terminal::renderer::Renderer> renderer_;
     bool renderingPressure_ = false;
-    std::unique_ptr<terminal::renderer::RenderTarget> renderTarget_;
+    std::unique_ptr<OpenGLRenderer> renderTarget_;
+    // Config snapshot whose shader selection was last applied, so the
+    // per-frame shader variant sync is a pointer compare (see
+    // applyShaderVariants()).
+    void const* appliedShaderSnapshot_ = nullptr;
     PermissionCache rememberedPermissions_ {};
     bool maximizedState_ = false;
 
     // update() timer used to animate the blinking cursor.
     QTimer updateTimer_;
 
+    // Defers applying a monitor DPI change until the reported value has
+    // settled; until then frames keep rendering with the previous font
+    // metrics and atlas generation (see onScreenDpiChanged()).
+    QTimer dpiChangeTimer_;
+
+    // Start of the currently decaying visual bell flash; default-constructed
+    // when no flash is active (see updateFrameTint()).
+    std::chrono::steady_clock::time_point bellFlashStart_ {};
+
     RenderStateManager state_;
 
     QFileSystemWatcher filesystemWatcher_;
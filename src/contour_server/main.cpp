@@ -0,0 +1,665 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// contour-server: runs one terminal session headless - Terminal plus
+// PtyProcess, no Qt - behind a Unix domain socket, so the session survives
+// display crashes and clients can attach and detach tmux-style.
+//
+// Wire protocol (all integers little endian, see terminal/StateSerializer.h):
+//
+//     frame       = u8 type, u32 payloadSize, payload bytes
+//
+//     server to client:
+//         Snapshot (1)    versioned binary terminal state snapshot in the
+//                         serializer's compact cell encoding; sent once on
+//                         attach, for clients embedding libterminal.
+//         Output (2)      raw PTY output bytes, streamed as they arrive.
+//         ServerExit (3)  session terminated; empty payload.
+//         ScreenDelta (4) changed visible lines only, relative to the last
+//                         delta frame sent to this client (see
+//                         serializer::writeScreenDelta); sent instead of
+//                         Output for clients in delta mode.
+//
+//     client to server:
+//         Input (1)        raw VT input bytes, written to the PTY verbatim.
+//         Resize (2)       u16 lines, u16 columns.
+//         Repaint (3)      requests an Output frame carrying a full-screen
+//                          VT repaint (Screen::screenshot()), for thin
+//                          clients that do not decode Snapshot frames.
+//         SetDeltaMode (4) u8 enable; switches this client between the raw
+//                          Output stream and ScreenDelta frames, which stay
+//                          bounded by screen size times update rate no
+//                          matter how much output the application floods.
+//
+// The bundled `attach` subcommand is such a thin client: it forwards raw
+// stdin to the session and Output frames to stdout, detaching on C-\.
+
+#include <terminal/StateSerializer.h>
+#include <terminal/Terminal.h>
+#include <terminal/pty/Pty.h>
+#include <terminal/pty/PtyProcess.h>
+
+#include <crispy/App.h>
+#include <crispy/CLI.h>
+#include <crispy/logstore.h>
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+using std::atomic;
+using std::bind;
+using std::cerr;
+using std::cout;
+using std::lock_guard;
+using std::mutex;
+using std::string;
+using std::string_view;
+using std::thread;
+using std::vector;
+
+using namespace std::string_literals;
+
+namespace CLI = crispy::cli;
+
+namespace
+{
+
+auto const ServerLog = logstore::Category("server", "Logs headless terminal server activity.");
+
+// {{{ wire protocol
+enum class ServerMessage : uint8_t
+{
+    Snapshot = 1,
+    Output = 2,
+    ServerExit = 3,
+    ScreenDelta = 4,
+};
+
+enum class ClientMessage : uint8_t
+{
+    Input = 1,
+    Resize = 2,
+    Repaint = 3,
+    SetDeltaMode = 4,
+};
+
+constexpr size_t FrameHeaderSize = 5; // u8 type + u32 payload size
+
+/// Hard upper bound for client supplied frame sizes, keeping a malformed
+/// or hostile peer from growing the receive buffer unboundedly.
+constexpr size_t MaxFramePayloadSize = 1024 * 1024;
+
+/// Key detaching the thin attach client from the session (C-backslash).
+constexpr char DetachKey = 0x1C;
+
+string encodeFrame(uint8_t _type, string_view _payload)
+{
+    auto writer = terminal::serializer::Writer {};
+    writer.u8(_type);
+    writer.str(_payload);
+    return std::move(writer.data);
+}
+
+bool writeAll(int _fd, string_view _data)
+{
+    while (!_data.empty())
+    {
+        auto const n = ::write(_fd, _data.data(), _data.size());
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        _data.remove_prefix(static_cast<size_t>(n));
+    }
+    return true;
+}
+// }}}
+
+// {{{ server
+class Server: public terminal::Terminal::Events
+{
+  public:
+    Server(string _socketPath,
+           terminal::Process::ExecInfo _shell,
+           terminal::PageSize _pageSize,
+           terminal::LineCount _maxHistoryLineCount):
+        socketPath_ { std::move(_socketPath) },
+        pty_ { _shell, _pageSize },
+        terminal_ { pty_, static_cast<int>(ReadBufferSize), *this, _maxHistoryLineCount }
+    {
+    }
+
+    int run()
+    {
+        if (!listen())
+            return EXIT_FAILURE;
+        if (pipe(wakeupPipe_) < 0)
+        {
+            cerr << fmt::format("Failed to create wakeup pipe. {}\n", strerror(errno));
+            return EXIT_FAILURE;
+        }
+        signal(SIGPIPE, SIG_IGN);
+
+        auto ptyReader = thread { [this]() { ptyReaderLoop(); } };
+        clientLoop();
+        ptyReader.join();
+
+        for (Client const& client: clients_)
+            ::close(client.fd);
+        ::close(listenFd_);
+        ::close(wakeupPipe_[0]);
+        ::close(wakeupPipe_[1]);
+        unlink(socketPath_.c_str());
+        return EXIT_SUCCESS;
+    }
+
+  private:
+    static constexpr size_t ReadBufferSize = 64 * 1024;
+
+    struct Client
+    {
+        int fd;
+        string inputBuffer; //!< partially received frames
+
+        /// With delta mode on, the client receives ScreenDelta frames -
+        /// changed visible lines only, per its own tracker - instead of the
+        /// raw Output byte stream (see SetDeltaMode).
+        bool deltaMode = false;
+        terminal::serializer::ScreenDeltaTracker deltaTracker {};
+    };
+
+    bool listen()
+    {
+        listenFd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd_ < 0)
+        {
+            cerr << fmt::format("Failed to create socket. {}\n", strerror(errno));
+            return false;
+        }
+
+        auto addr = sockaddr_un {};
+        addr.sun_family = AF_UNIX;
+        if (socketPath_.size() >= sizeof(addr.sun_path))
+        {
+            cerr << fmt::format("Socket path too long: {}\n", socketPath_);
+            return false;
+        }
+        memcpy(addr.sun_path, socketPath_.c_str(), socketPath_.size() + 1);
+
+        // A stale socket file from a crashed server would make bind() fail;
+        // only remove it if nobody is listening behind it anymore.
+        if (connect(listenFd_, (sockaddr const*) &addr, sizeof(addr)) == 0)
+        {
+            cerr << fmt::format("Another server is already listening on {}\n", socketPath_);
+            return false;
+        }
+        unlink(socketPath_.c_str());
+
+        if (bind(listenFd_, (sockaddr const*) &addr, sizeof(addr)) < 0
+            || ::listen(listenFd_, SOMAXCONN) < 0)
+        {
+            cerr << fmt::format("Failed to listen on {}. {}\n", socketPath_, strerror(errno));
+            return false;
+        }
+
+        LOGSTORE(ServerLog)("Listening on {}.", socketPath_);
+        return true;
+    }
+
+    /// Blocking-reads the PTY, feeds the terminal and broadcasts the raw
+    /// bytes to all attached clients, until the session process exits.
+    void ptyReaderLoop()
+    {
+        for (;;)
+        {
+            auto const bufOpt = pty_.read(ReadBufferSize, terminal::Pty::NoTimeout);
+            if (!bufOpt)
+            {
+                if (errno == EINTR || errno == EAGAIN)
+                    continue;
+                break;
+            }
+            auto const buf = *bufOpt;
+            if (buf.empty())
+                break;
+
+            // Terminal update and broadcast happen under one lock, so an
+            // attaching client's snapshot and its first Output frame meet
+            // exactly: no chunk is ever missing or applied twice.
+            auto const _lock = lock_guard { sessionLock_ };
+            terminal_.writeToScreen(buf);
+            broadcastOutputLocked(buf);
+        }
+
+        LOGSTORE(ServerLog)("Session process exited.");
+        sessionClosed_ = true;
+        // Wake the client loop out of select().
+        char const dummy = 1;
+        (void) ::write(wakeupPipe_[1], &dummy, 1);
+    }
+
+    /// Accepts clients and dispatches their frames until the session ends.
+    void clientLoop()
+    {
+        while (!sessionClosed_)
+        {
+            auto rfd = fd_set {};
+            FD_ZERO(&rfd);
+            FD_SET(listenFd_, &rfd);
+            FD_SET(wakeupPipe_[0], &rfd);
+            int nfds = std::max(listenFd_, wakeupPipe_[0]);
+            for (Client const& client: clients_)
+            {
+                FD_SET(client.fd, &rfd);
+                nfds = std::max(nfds, client.fd);
+            }
+
+            if (select(nfds + 1, &rfd, nullptr, nullptr, nullptr) < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+
+            if (FD_ISSET(listenFd_, &rfd))
+                acceptClient();
+
+            for (size_t i = 0; i < clients_.size();)
+            {
+                if (FD_ISSET(clients_[i].fd, &rfd) && !receiveFromClient(clients_[i]))
+                {
+                    LOGSTORE(ServerLog)("Client detached.");
+                    auto const _lock = lock_guard { sessionLock_ };
+                    ::close(clients_[i].fd);
+                    clients_.erase(clients_.begin() + static_cast<ptrdiff_t>(i));
+                }
+                else
+                    ++i;
+            }
+        }
+
+        auto const _lock = lock_guard { sessionLock_ };
+        broadcastLocked(ServerMessage::ServerExit, {});
+    }
+
+    void acceptClient()
+    {
+        auto const fd = accept(listenFd_, nullptr, nullptr);
+        if (fd < 0)
+            return;
+
+        LOGSTORE(ServerLog)("Client attached.");
+
+        // The snapshot and the subsequent output stream must not tear: hold
+        // the session lock across both the serialization and the client
+        // registration, so no PTY read slips in between.
+        auto const _lock = lock_guard { sessionLock_ };
+        auto const snapshot = terminal::serializer::serialize(terminal_.state());
+        if (!writeAll(fd, encodeFrame(static_cast<uint8_t>(ServerMessage::Snapshot), snapshot)))
+        {
+            ::close(fd);
+            return;
+        }
+        clients_.push_back(Client { fd, {} });
+    }
+
+    /// Reads pending bytes of the given client and executes every completely
+    /// received frame; returns false once the client disconnected.
+    bool receiveFromClient(Client& _client)
+    {
+        char buf[4096];
+        auto const n = ::read(_client.fd, buf, sizeof(buf));
+        if (n <= 0)
+            return n < 0 && (errno == EINTR || errno == EAGAIN);
+        _client.inputBuffer.append(buf, static_cast<size_t>(n));
+
+        while (_client.inputBuffer.size() >= FrameHeaderSize)
+        {
+            auto reader = terminal::serializer::Reader { _client.inputBuffer };
+            auto const type = reader.u8();
+            auto const payloadSize = reader.u32();
+            if (payloadSize > MaxFramePayloadSize)
+                return false;
+            if (_client.inputBuffer.size() < FrameHeaderSize + payloadSize)
+                break;
+            auto const payload = string_view(_client.inputBuffer).substr(FrameHeaderSize, payloadSize);
+            if (!executeClientFrame(_client, static_cast<ClientMessage>(type), payload))
+                return false;
+            _client.inputBuffer.erase(0, FrameHeaderSize + payloadSize);
+        }
+        return true;
+    }
+
+    bool executeClientFrame(Client& _client, ClientMessage _type, string_view _payload)
+    {
+        switch (_type)
+        {
+        case ClientMessage::Input: return pty_.write(_payload.data(), _payload.size()) >= 0;
+        case ClientMessage::Resize: {
+            auto reader = terminal::serializer::Reader { _payload };
+            auto const lines = terminal::LineCount(reader.u16());
+            auto const columns = terminal::ColumnCount(reader.u16());
+            if (!reader.ok || *lines == 0 || *columns == 0)
+                return false;
+            auto const _lock = lock_guard { sessionLock_ };
+            terminal_.resizeScreen(terminal::PageSize { lines, columns }, std::nullopt);
+            return true;
+        }
+        case ClientMessage::SetDeltaMode: {
+            auto reader = terminal::serializer::Reader { _payload };
+            auto const enable = reader.u8() != 0;
+            if (!reader.ok)
+                return false;
+            auto const _lock = lock_guard { sessionLock_ };
+            _client.deltaMode = enable;
+            _client.deltaTracker = {}; // next delta frame carries the full page
+            return true;
+        }
+        case ClientMessage::Repaint: {
+            auto const repaint = [&]() {
+                auto const _lock = lock_guard { sessionLock_ };
+                return "\033[2J" + terminal_.screen().screenshot();
+            }();
+            return writeAll(_client.fd,
+                            encodeFrame(static_cast<uint8_t>(ServerMessage::Output), repaint));
+        }
+        }
+        return false;
+    }
+
+    /// Sends a frame to all attached clients; sessionLock_ must be held.
+    void broadcastLocked(ServerMessage _type, string_view _payload)
+    {
+        auto const frame = encodeFrame(static_cast<uint8_t>(_type), _payload);
+        for (Client const& client: clients_)
+            (void) writeAll(client.fd, frame); // dead clients reaped via select()
+    }
+
+    /// Propagates a processed PTY chunk to all attached clients - as the raw
+    /// byte stream, or, for delta-mode clients, as the changed visible lines
+    /// relative to what that client has already seen; sessionLock_ must be
+    /// held.
+    void broadcastOutputLocked(string_view _rawOutput)
+    {
+        auto const rawFrame = encodeFrame(static_cast<uint8_t>(ServerMessage::Output), _rawOutput);
+        for (Client& client: clients_)
+        {
+            if (!client.deltaMode)
+            {
+                (void) writeAll(client.fd, rawFrame);
+                continue;
+            }
+            auto writer = terminal::serializer::Writer {};
+            terminal::serializer::writeScreenDelta(
+                writer, terminal_.screen().grid(), terminal_.screen().cursor(), client.deltaTracker);
+            (void) writeAll(client.fd,
+                            encodeFrame(static_cast<uint8_t>(ServerMessage::ScreenDelta), writer.data));
+        }
+    }
+
+    string socketPath_;
+    terminal::PtyProcess pty_;
+    terminal::Terminal terminal_;
+
+    /// Serializes PTY ingestion plus output broadcast against client
+    /// attach (snapshot), resize, and repaint.
+    mutex sessionLock_;
+
+    int listenFd_ = -1;
+    int wakeupPipe_[2] = { -1, -1 };
+    vector<Client> clients_; //!< mutated by clientLoop() only, read under sessionLock_
+    atomic<bool> sessionClosed_ = false;
+};
+// }}}
+
+// {{{ thin attach client
+class RawTerminalMode
+{
+  public:
+    RawTerminalMode()
+    {
+        active_ = tcgetattr(STDIN_FILENO, &saved_) == 0;
+        if (!active_)
+            return;
+        auto raw = saved_;
+        cfmakeraw(&raw);
+        tcsetattr(STDIN_FILENO, TCSANOW, &raw);
+    }
+
+    ~RawTerminalMode()
+    {
+        if (active_)
+            tcsetattr(STDIN_FILENO, TCSANOW, &saved_);
+    }
+
+  private:
+    termios saved_ {};
+    bool active_ = false;
+};
+
+int attachSession(string const& _socketPath)
+{
+    auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    auto addr = sockaddr_un {};
+    addr.sun_family = AF_UNIX;
+    if (_socketPath.size() >= sizeof(addr.sun_path))
+    {
+        cerr << fmt::format("Socket path too long: {}\n", _socketPath);
+        return EXIT_FAILURE;
+    }
+    memcpy(addr.sun_path, _socketPath.c_str(), _socketPath.size() + 1);
+    if (fd < 0 || connect(fd, (sockaddr const*) &addr, sizeof(addr)) < 0)
+    {
+        cerr << fmt::format("Failed to connect to {}. {}\n", _socketPath, strerror(errno));
+        return EXIT_FAILURE;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // Adopt the controlling terminal's size, then ask for a full repaint
+    // (this thin client does not decode Snapshot frames).
+    auto size = winsize {};
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0 && size.ws_row && size.ws_col)
+    {
+        auto writer = terminal::serializer::Writer {};
+        writer.u16(size.ws_row);
+        writer.u16(size.ws_col);
+        writeAll(fd, encodeFrame(static_cast<uint8_t>(ClientMessage::Resize), writer.data));
+    }
+    writeAll(fd, encodeFrame(static_cast<uint8_t>(ClientMessage::Repaint), {}));
+
+    auto const rawMode = RawTerminalMode {};
+    auto receiveBuffer = string {};
+
+    for (;;)
+    {
+        auto rfd = fd_set {};
+        FD_ZERO(&rfd);
+        FD_SET(STDIN_FILENO, &rfd);
+        FD_SET(fd, &rfd);
+        if (select(std::max(fd, STDIN_FILENO) + 1, &rfd, nullptr, nullptr, nullptr) < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (FD_ISSET(STDIN_FILENO, &rfd))
+        {
+            char buf[4096];
+            auto const n = ::read(STDIN_FILENO, buf, sizeof(buf));
+            if (n <= 0)
+                break;
+            if (memchr(buf, DetachKey, static_cast<size_t>(n)))
+            {
+                ::close(fd);
+                cout << "\r\n[detached]\r\n";
+                return EXIT_SUCCESS;
+            }
+            writeAll(fd,
+                     encodeFrame(static_cast<uint8_t>(ClientMessage::Input),
+                                 string_view(buf, static_cast<size_t>(n))));
+        }
+
+        if (FD_ISSET(fd, &rfd))
+        {
+            char buf[16 * 1024];
+            auto const n = ::read(fd, buf, sizeof(buf));
+            if (n <= 0)
+                break;
+            receiveBuffer.append(buf, static_cast<size_t>(n));
+
+            while (receiveBuffer.size() >= FrameHeaderSize)
+            {
+                auto reader = terminal::serializer::Reader { receiveBuffer };
+                auto const type = reader.u8();
+                auto const payloadSize = reader.u32();
+                if (receiveBuffer.size() < FrameHeaderSize + payloadSize)
+                    break;
+                auto const payload = string_view(receiveBuffer).substr(FrameHeaderSize, payloadSize);
+                switch (static_cast<ServerMessage>(type))
+                {
+                case ServerMessage::Output: writeAll(STDOUT_FILENO, payload); break;
+                case ServerMessage::Snapshot: break;    // thin client; repaint requested instead
+                case ServerMessage::ScreenDelta: break; // not requested by the thin client
+                case ServerMessage::ServerExit:
+                    ::close(fd);
+                    cout << "\r\n[session terminated]\r\n";
+                    return EXIT_SUCCESS;
+                }
+                receiveBuffer.erase(0, FrameHeaderSize + payloadSize);
+            }
+        }
+    }
+
+    ::close(fd);
+    cout << "\r\n[connection lost]\r\n";
+    return EXIT_SUCCESS;
+}
+// }}}
+
+class ContourServerApp: public crispy::App
+{
+  public:
+    ContourServerApp(): App("contour-server", "Contour Terminal Server", CONTOUR_VERSION_STRING, "Apache-2.0")
+    {
+        link("contour-server.server", bind(&ContourServerApp::serverAction, this));
+        link("contour-server.attach", bind(&ContourServerApp::attachAction, this));
+    }
+
+    crispy::cli::Command parameterDefinition() const override
+    {
+        auto const socketOption =
+            CLI::Option { "socket", CLI::Value { ""s }, "Path to the session's Unix domain socket.", "PATH" };
+
+        return CLI::Command {
+            "contour-server",
+            "Contour Terminal Server " CONTOUR_VERSION_STRING
+            " - https://github.com/contour-terminal/contour/ ;-)",
+            CLI::OptionList {},
+            CLI::CommandList {
+                CLI::Command { "help", "Shows this help and exits." },
+                CLI::Command { "version", "Shows the version and exits." },
+                CLI::Command { "license",
+                               "Shows the license, and project URL of the used projects and Contour." },
+                CLI::Command {
+                    "server",
+                    "Runs a terminal session headless behind a Unix domain socket.",
+                    CLI::OptionList {
+                        socketOption,
+                        CLI::Option { "shell", CLI::Value { ""s }, "Shell to execute.", "PROGRAM" },
+                        CLI::Option { "lines", CLI::Value { 25u }, "Initial page height.", "COUNT" },
+                        CLI::Option { "columns", CLI::Value { 80u }, "Initial page width.", "COUNT" },
+                        CLI::Option {
+                            "history-lines", CLI::Value { 10000u }, "Scrollback line count.", "COUNT" },
+                    } },
+                CLI::Command { "attach",
+                               "Attaches to a running session; C-\\ detaches.",
+                               CLI::OptionList { socketOption } },
+            }
+        };
+    }
+
+  private:
+    int serverAction()
+    {
+        auto const socketPath = parameters().get<string>("contour-server.server.socket");
+        if (socketPath.empty())
+        {
+            cerr << "No socket path given.\n";
+            return EXIT_FAILURE;
+        }
+
+        auto shell = terminal::Process::ExecInfo {};
+        if (auto const program = parameters().get<string>("contour-server.server.shell"); !program.empty())
+            shell.program = program;
+        else
+        {
+            auto const loginShell = terminal::Process::loginShell();
+            shell.program = loginShell.front();
+            shell.arguments = { std::next(loginShell.begin()), loginShell.end() };
+        }
+        shell.env["TERM"] = "contour";
+
+        auto const pageSize =
+            terminal::PageSize { terminal::LineCount::cast_from(
+                                     parameters().uint("contour-server.server.lines")),
+                                 terminal::ColumnCount::cast_from(
+                                     parameters().uint("contour-server.server.columns")) };
+        auto const historyLineCount =
+            terminal::LineCount::cast_from(parameters().uint("contour-server.server.history-lines"));
+
+        auto server = Server { socketPath, std::move(shell), pageSize, historyLineCount };
+        return server.run();
+    }
+
+    int attachAction()
+    {
+        auto const socketPath = parameters().get<string>("contour-server.attach.socket");
+        if (socketPath.empty())
+        {
+            cerr << "No socket path given.\n";
+            return EXIT_FAILURE;
+        }
+        return attachSession(socketPath);
+    }
+};
+
+} // namespace
+
+int main(int argc, char const* argv[])
+{
+    ContourServerApp app;
+    return app.run(argc, argv);
+}
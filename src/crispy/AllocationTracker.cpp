@@ -0,0 +1,281 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <crispy/AllocationTracker.h>
+#include <crispy/StackTrace.h>
+#include <crispy/logstore.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+namespace
+{
+
+auto AllocationLog = logstore::Category("alloc.frame",
+                                        "Logs allocation counts of instrumented frame scopes.");
+
+} // namespace
+
+#if defined(CONTOUR_ALLOCATION_TRACKER) && !defined(_WIN32)
+
+namespace
+{
+
+// Number of stack frames stored per allocation site. Deep enough to tell
+// container growth sites apart, shallow enough to keep capture cheap.
+constexpr size_t SiteFrames = 8;
+
+// Frames occupied by the capture machinery itself (getFrames, recordAllocation,
+// operator new), skipped so a site starts at the actual allocating caller.
+constexpr size_t SkippedFrames = 3;
+
+// Power of two; open addressing below relies on it for cheap modulo.
+constexpr size_t MaxSites = 1024;
+
+struct Site
+{
+    std::atomic<uint64_t> hash { 0 }; // 0 denotes an empty slot
+    std::atomic<uint64_t> count { 0 };
+    std::atomic<uint64_t> bytes { 0 };
+    std::array<void*, SiteFrames> frames {};
+};
+
+std::atomic<uint64_t> totalAllocations { 0 };
+std::atomic<uint64_t> totalBytes { 0 };
+std::atomic<uint64_t> unattributedAllocations { 0 };
+std::array<Site, MaxSites> sites {};
+
+// Guards against recursion: the stack capture below allocates itself, and
+// those internal allocations must be neither counted nor attributed.
+thread_local bool insideHook = false;
+
+uint64_t hashFrames(std::vector<void*> const& _frames) noexcept
+{
+    // FNV1a over the frame addresses.
+    auto hash = uint64_t { 0xcbf29ce484222325 };
+    for (void* frame: _frames)
+    {
+        hash ^= reinterpret_cast<uintptr_t>(frame);
+        hash *= 0x100000001b3;
+    }
+    return hash ? hash : 1; // 0 is reserved for empty slots
+}
+
+void recordAllocation(size_t _size)
+{
+    if (insideHook)
+        return;
+
+    insideHook = true;
+
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(_size, std::memory_order_relaxed);
+
+    auto const frames = crispy::StackTrace::getFrames(SkippedFrames, SiteFrames);
+    auto const hash = hashFrames(frames);
+
+    auto attributed = false;
+    for (size_t probe = 0; probe < MaxSites; ++probe)
+    {
+        Site& site = sites[(hash + probe) & (MaxSites - 1)];
+        auto expected = uint64_t { 0 };
+        if (site.hash.compare_exchange_strong(expected, hash, std::memory_order_acq_rel))
+            std::copy(frames.begin(), frames.end(), site.frames.begin());
+        else if (expected != hash)
+            continue;
+        site.count.fetch_add(1, std::memory_order_relaxed);
+        site.bytes.fetch_add(_size, std::memory_order_relaxed);
+        attributed = true;
+        break;
+    }
+    if (!attributed)
+        unattributedAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    insideHook = false;
+}
+
+void* allocate(size_t _size)
+{
+    void* pointer = std::malloc(_size ? _size : 1);
+    if (pointer)
+        recordAllocation(_size);
+    return pointer;
+}
+
+} // namespace
+
+// {{{ global operator new/delete replacements
+void* operator new(std::size_t _size)
+{
+    if (void* pointer = allocate(_size))
+        return pointer;
+    throw std::bad_alloc {};
+}
+
+void* operator new[](std::size_t _size)
+{
+    if (void* pointer = allocate(_size))
+        return pointer;
+    throw std::bad_alloc {};
+}
+
+void* operator new(std::size_t _size, std::nothrow_t const&) noexcept
+{
+    return allocate(_size);
+}
+
+void* operator new[](std::size_t _size, std::nothrow_t const&) noexcept
+{
+    return allocate(_size);
+}
+
+void operator delete(void* _pointer) noexcept
+{
+    std::free(_pointer);
+}
+
+void operator delete[](void* _pointer) noexcept
+{
+    std::free(_pointer);
+}
+
+void operator delete(void* _pointer, std::size_t) noexcept
+{
+    std::free(_pointer);
+}
+
+void operator delete[](void* _pointer, std::size_t) noexcept
+{
+    std::free(_pointer);
+}
+
+void operator delete(void* _pointer, std::nothrow_t const&) noexcept
+{
+    std::free(_pointer);
+}
+
+void operator delete[](void* _pointer, std::nothrow_t const&) noexcept
+{
+    std::free(_pointer);
+}
+// }}}
+
+namespace crispy::alloc
+{
+
+bool available() noexcept
+{
+    return true;
+}
+
+Stats stats() noexcept
+{
+    return Stats { totalAllocations.load(std::memory_order_relaxed),
+                   totalBytes.load(std::memory_order_relaxed) };
+}
+
+void inspect(std::ostream& _output)
+{
+    struct Snapshot
+    {
+        uint64_t count;
+        uint64_t bytes;
+        std::array<void*, SiteFrames> frames;
+    };
+
+    auto snapshots = std::vector<Snapshot> {};
+    for (Site const& site: sites)
+        if (site.hash.load(std::memory_order_acquire) != 0)
+            snapshots.push_back(Snapshot { site.count.load(std::memory_order_relaxed),
+                                           site.bytes.load(std::memory_order_relaxed),
+                                           site.frames });
+
+    std::sort(snapshots.begin(), snapshots.end(), [](Snapshot const& a, Snapshot const& b) {
+        return a.count > b.count;
+    });
+
+    auto const total = stats();
+    _output << "Allocation sites (" << total.allocations << " allocations, " << total.bytes
+            << " bytes total, " << unattributedAllocations.load(std::memory_order_relaxed)
+            << " unattributed):\n";
+
+    auto constexpr MaxReportedSites = size_t { 32 };
+    for (size_t i = 0; i < std::min(snapshots.size(), MaxReportedSites); ++i)
+    {
+        Snapshot const& snapshot = snapshots[i];
+        _output << "  #" << i << ": count " << snapshot.count << ", bytes " << snapshot.bytes << "\n";
+        for (void* frame: snapshot.frames)
+        {
+            if (!frame)
+                break;
+            if (auto const debugInfo = StackTrace::getDebugInfoForFrame(frame); debugInfo.has_value())
+                _output << "    " << debugInfo->text << "\n";
+            else
+                _output << "    " << frame << "\n";
+        }
+    }
+}
+
+} // namespace crispy::alloc
+
+#else
+
+namespace crispy::alloc
+{
+
+bool available() noexcept
+{
+    return false;
+}
+
+Stats stats() noexcept
+{
+    return Stats {};
+}
+
+void inspect(std::ostream& _output)
+{
+    _output << "Allocation tracking not compiled in (CONTOUR_ALLOCATION_TRACKER).\n";
+}
+
+} // namespace crispy::alloc
+
+#endif
+
+namespace crispy::alloc
+{
+
+FrameScope::FrameScope(char const* _name) noexcept: name_ { _name }, start_ { stats() }
+{
+}
+
+Stats FrameScope::current() const noexcept
+{
+    auto const now = stats();
+    return Stats { now.allocations - start_.allocations, now.bytes - start_.bytes };
+}
+
+FrameScope::~FrameScope()
+{
+    if (!available())
+        return;
+
+    if (auto const delta = current(); delta.allocations != 0)
+        LOGSTORE(AllocationLog)("{}: {} allocations ({} bytes)", name_, delta.allocations, delta.bytes);
+}
+
+} // namespace crispy::alloc
@@ -0,0 +1,77 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// Opt-in heap allocation tracking for hunting hidden allocations on hot paths.
+//
+// When built with CONTOUR_ALLOCATION_TRACKER (CMake option of the same name,
+// POSIX only), the global operator new/delete pairs are replaced with counting
+// versions that also attribute each allocation to its call site via
+// crispy::StackTrace. Instrumented scopes (CRISPY_ALLOCATION_FRAME) report
+// their allocation count through the "alloc.frame" logstore category when it
+// is nonzero, so a steady-state render loop is expected to stay silent; the
+// per-site breakdown is appended to the state dump (see
+// TerminalWidget::doDumpState) via crispy::alloc::inspect(std::ostream&).
+//
+// Without the option, the hooks are not compiled and everything here is inert.
+
+namespace crispy::alloc
+{
+
+struct Stats
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+/// Returns true iff this binary was built with CONTOUR_ALLOCATION_TRACKER.
+bool available() noexcept;
+
+/// Process-wide allocation counters since program start (all zero if tracking
+/// is unavailable).
+Stats stats() noexcept;
+
+/// Writes the per-call-site allocation breakdown, most frequent sites first.
+void inspect(std::ostream& _output);
+
+/// Measures allocations performed between construction and destruction and
+/// logs them (via "alloc.frame") at destruction if any occurred.
+class FrameScope
+{
+  public:
+    explicit FrameScope(char const* _name) noexcept;
+    ~FrameScope();
+
+    FrameScope(FrameScope const&) = delete;
+    FrameScope& operator=(FrameScope const&) = delete;
+
+    /// Allocations performed since this scope was entered.
+    Stats current() const noexcept;
+
+  private:
+    char const* name_;
+    Stats start_;
+};
+
+} // namespace crispy::alloc
+
+#if defined(CONTOUR_ALLOCATION_TRACKER)
+    #define CRISPY_ALLOCATION_FRAME(name)                                     \
+        auto const _crispyAllocationFrame = crispy::alloc::FrameScope { name }
+#else
+    #define CRISPY_ALLOCATION_FRAME(name) ((void) 0)
+#endif
@@ -0,0 +1,56 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <crispy/AllocationTracker.h>
+
+#include <catch2/catch.hpp>
+
+#include <array>
+#include <memory>
+
+#if defined(CONTOUR_ALLOCATION_TRACKER)
+
+TEST_CASE("alloc.steady_state_is_allocation_free")
+{
+    // A scope that does not allocate must observe a zero delta; this is the
+    // assertion hot paths are held to when the tracker is enabled in CI.
+    auto const before = crispy::alloc::stats();
+    {
+        auto buffer = std::array<char, 64> {};
+        buffer[0] = '\0';
+    }
+    auto const after = crispy::alloc::stats();
+    CHECK(after.allocations == before.allocations);
+}
+
+TEST_CASE("alloc.counts_heap_allocations")
+{
+    auto const scope = crispy::alloc::FrameScope { "alloc_test" };
+    auto const pointer = std::make_unique<char[]>(1024);
+    REQUIRE(pointer.get() != nullptr);
+    auto const delta = scope.current();
+    CHECK(delta.allocations >= 1);
+    CHECK(delta.bytes >= 1024);
+}
+
+#else
+
+TEST_CASE("alloc.unavailable_is_inert")
+{
+    CHECK_FALSE(crispy::alloc::available());
+    auto const stats = crispy::alloc::stats();
+    CHECK(stats.allocations == 0);
+    CHECK(stats.bytes == 0);
+}
+
+#endif
@@ -0,0 +1,175 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <crispy/assert.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace crispy
+{
+
+/// Bump arena for short-lived temporaries with a common lifetime, such as the
+/// scratch buffers a render frame builds up and throws away.
+///
+/// Allocation is a pointer increment into a large block; nothing is freed
+/// individually. reset() recycles all memory at once, so a steady-state caller
+/// (e.g. one reset per frame) performs no heap traffic at all after the arena
+/// has warmed up to its high watermark. Extra blocks acquired on overflow are
+/// coalesced into one appropriately sized block on the next reset().
+///
+/// Not thread-safe; each arena belongs to exactly one thread (or is externally
+/// synchronized, like everything else owned by the render thread).
+class Arena
+{
+  public:
+    static constexpr std::size_t DefaultBlockSize = 64 * 1024;
+
+    explicit Arena(std::size_t _blockSize = DefaultBlockSize): blockSize_ { _blockSize } {}
+
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+    Arena(Arena&&) = default;
+    Arena& operator=(Arena&&) = default;
+
+    /// Carves @p _bytes bytes with the given alignment out of the arena.
+    ///
+    /// The returned memory remains valid until the next reset().
+    void* allocate(std::size_t _bytes, std::size_t _alignment = alignof(std::max_align_t))
+    {
+        Require((_alignment & (_alignment - 1)) == 0);
+
+        if (!blocks_.empty())
+        {
+            auto& block = blocks_.back();
+            auto const offset = alignUp(block.used, _alignment);
+            if (offset + _bytes <= block.capacity)
+            {
+                block.used = offset + _bytes;
+                return block.data.get() + offset;
+            }
+        }
+
+        auto& block = grow(_bytes + _alignment);
+        block.used = alignUp(block.used, _alignment) + _bytes;
+        return block.data.get() + block.used - _bytes;
+    }
+
+    /// Discards all allocations at once, retaining the memory for reuse.
+    ///
+    /// If the previous cycle overflowed into extra blocks, they are replaced
+    /// by one block large enough to hold the observed peak, so subsequent
+    /// cycles of the same size run block-switch-free.
+    void reset()
+    {
+        highWatermark_ = std::max(highWatermark_, bytesUsed());
+
+        if (blocks_.size() > 1)
+        {
+            blocks_.clear();
+            grow(highWatermark_);
+        }
+
+        for (Block& block: blocks_)
+            block.used = 0;
+    }
+
+    /// Number of bytes (including alignment padding) allocated since the last reset().
+    std::size_t bytesUsed() const noexcept
+    {
+        auto sum = std::size_t { 0 };
+        for (Block const& block: blocks_)
+            sum += block.used;
+        return sum;
+    }
+
+    /// Peak bytesUsed() ever observed by reset(), i.e. the steady-state footprint.
+    std::size_t highWatermark() const noexcept { return highWatermark_; }
+
+  private:
+    struct Block
+    {
+        std::unique_ptr<std::byte[]> data;
+        std::size_t capacity = 0;
+        std::size_t used = 0;
+    };
+
+    static constexpr std::size_t alignUp(std::size_t _offset, std::size_t _alignment) noexcept
+    {
+        return (_offset + _alignment - 1) & ~(_alignment - 1);
+    }
+
+    Block& grow(std::size_t _minBytes)
+    {
+        auto const capacity = std::max(blockSize_, _minBytes);
+        blocks_.emplace_back(Block { std::make_unique<std::byte[]>(capacity), capacity, 0 });
+        return blocks_.back();
+    }
+
+    std::vector<Block> blocks_;
+    std::size_t blockSize_;
+    std::size_t highWatermark_ = 0;
+};
+
+/// Standard allocator adapter carving from an Arena; deallocation is a no-op,
+/// as the arena frees everything in bulk on reset().
+template <typename T>
+class ArenaAllocator
+{
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(Arena& _arena) noexcept: arena_ { &_arena } {}
+
+    template <typename U>
+    ArenaAllocator(ArenaAllocator<U> const& _other) noexcept: arena_ { _other.arena() }
+    {
+    }
+
+    T* allocate(std::size_t _count)
+    {
+        return static_cast<T*>(arena_->allocate(_count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept {}
+
+    Arena* arena() const noexcept { return arena_; }
+
+  private:
+    Arena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b) noexcept
+{
+    return a.arena() == b.arena();
+}
+
+template <typename T, typename U>
+bool operator!=(ArenaAllocator<T> const& a, ArenaAllocator<U> const& b) noexcept
+{
+    return !(a == b);
+}
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+template <typename Char>
+using ArenaBasicString = std::basic_string<Char, std::char_traits<Char>, ArenaAllocator<Char>>;
+
+} // namespace crispy
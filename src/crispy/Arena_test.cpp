@@ -0,0 +1,78 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <crispy/Arena.h>
+
+#include <catch2/catch.hpp>
+
+#include <cstdint>
+
+using crispy::Arena;
+using crispy::ArenaAllocator;
+using crispy::ArenaVector;
+
+TEST_CASE("Arena.bump")
+{
+    auto arena = Arena {};
+    auto const a = arena.allocate(16, 8);
+    auto const b = arena.allocate(16, 8);
+    CHECK(a != b);
+    CHECK(arena.bytesUsed() == 32);
+
+    auto const c = arena.allocate(1, 1);
+    auto const d = arena.allocate(8, 8);
+    CHECK(reinterpret_cast<uintptr_t>(c) % 8 == 0); // follows two 8-aligned allocations
+    CHECK(reinterpret_cast<uintptr_t>(d) % 8 == 0); // padded past the 1-byte allocation
+}
+
+TEST_CASE("Arena.reset_reuses_memory")
+{
+    auto arena = Arena {};
+    auto const first = arena.allocate(64, 8);
+    arena.reset();
+    CHECK(arena.bytesUsed() == 0);
+    CHECK(arena.highWatermark() == 64);
+
+    // Same block, same offset: steady-state cycles touch the heap not at all.
+    CHECK(arena.allocate(64, 8) == first);
+}
+
+TEST_CASE("Arena.overflow_coalesces_on_reset")
+{
+    auto arena = Arena { 64 };
+    arena.allocate(48, 8);
+    arena.allocate(48, 8); // does not fit the first 64-byte block
+    auto const peak = arena.bytesUsed();
+    CHECK(peak >= 96);
+
+    // After reset the peak fits a single block again.
+    arena.reset();
+    CHECK(arena.highWatermark() == peak);
+    arena.allocate(peak, 8);
+    CHECK(arena.bytesUsed() == peak);
+}
+
+TEST_CASE("Arena.allocator_adapter")
+{
+    auto arena = Arena {};
+    auto numbers = ArenaVector<int> { ArenaAllocator<int>(arena) };
+    for (int i = 0; i < 100; ++i)
+        numbers.push_back(i);
+    CHECK(numbers.size() == 100);
+    CHECK(numbers[99] == 99);
+    CHECK(arena.bytesUsed() >= 100 * sizeof(int));
+
+    CHECK(ArenaAllocator<int>(arena) == ArenaAllocator<char>(arena));
+    auto other = Arena {};
+    CHECK(ArenaAllocator<int>(arena) != ArenaAllocator<int>(other));
+}
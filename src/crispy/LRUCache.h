@@ -39,7 +39,10 @@ class LRUCache
     using iterator = typename ItemList::iterator;
     using const_iterator = typename ItemList::const_iterator;
 
-    explicit LRUCache(std::size_t _capacity): capacity_ { _capacity } {}
+    explicit LRUCache(std::size_t _capacity): capacity_ { _capacity }
+    {
+        itemByKeyMapping_.reserve(_capacity);
+    }
 
     std::size_t size() const noexcept { return items_.size(); }
     std::size_t capacity() const noexcept { return capacity_; }
@@ -61,9 +64,8 @@ class LRUCache
         if (auto i = itemByKeyMapping_.find(_key); i != itemByKeyMapping_.end())
         {
             // move it to the front, and return it
-            auto i2 = moveItemToFront(i->second);
-            itemByKeyMapping_.at(_key) = i2;
-            return &i2->value;
+            moveItemToFront(i->second);
+            return &i->second->value;
         }
 
         return nullptr;
@@ -154,8 +156,8 @@ class LRUCache
 
     void erase(iterator _iter)
     {
-        items_.erase(_iter);
         itemByKeyMapping_.erase(_iter->key);
+        items_.erase(_iter);
     }
 
     void erase(Key const& _key)
@@ -176,17 +178,24 @@ class LRUCache
         auto newItemIterator = moveItemToFront(keyMappingIterator->second);
         newItemIterator->key = _newKey;
         newItemIterator->value = std::move(_newValue);
-        itemByKeyMapping_.erase(keyMappingIterator);
-        itemByKeyMapping_.emplace(_newKey, newItemIterator);
+
+        // Re-key the existing mapping node in place rather than erase and
+        // re-insert, so eviction does not allocate either.
+        auto mappingNode = itemByKeyMapping_.extract(keyMappingIterator);
+        mappingNode.key() = _newKey;
+        mappingNode.mapped() = newItemIterator;
+        itemByKeyMapping_.insert(std::move(mappingNode));
 
         return newItemIterator;
     }
 
     [[nodiscard]] iterator moveItemToFront(iterator i)
     {
-        items_.emplace_front(std::move(*i));
-        items_.erase(i);
-        return items_.begin();
+        // splice() merely relinks the existing node: no allocation, no move
+        // of the item, and iterators (like the ones held in the key mapping)
+        // remain valid.
+        items_.splice(items_.begin(), items_, i);
+        return i;
     }
 
     iterator emplaceItemToFront(Key _key, Value&& _value)
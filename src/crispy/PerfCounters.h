@@ -0,0 +1,155 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#elif defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// Lightweight scoped wall-time counters for hot paths.
+//
+// Counters are compiled out entirely unless CONTOUR_PERF_COUNTERS is defined
+// (CMake option of the same name), so instrumented code pays nothing in
+// production builds. When enabled, a CRISPY_PERF_SCOPE("name") at the top of a
+// scope accumulates invocation count, total and maximum duration into a
+// process-wide registry, measured in TSC ticks on x86 (a single RDTSC pair per
+// scope) and in steady_clock nanoseconds elsewhere. Accumulation uses relaxed
+// atomics, so scopes may freely run on multiple threads.
+//
+// The collected table is appended to the state dump (see
+// TerminalWidget::doDumpState) via crispy::perf::inspect(std::ostream&).
+
+namespace crispy::perf
+{
+
+inline uint64_t ticks() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER)
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+#endif
+}
+
+constexpr inline char const* ticksUnit() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__) || defined(_MSC_VER)
+    return "tsc-ticks";
+#else
+    return "ns";
+#endif
+}
+
+class Counter
+{
+  public:
+    explicit Counter(char const* _name): name_ { _name } { registry().push_back(this); }
+
+    /// Returns the process-wide counter for the given name.
+    ///
+    /// Intended to be bound to a function-local static (see CRISPY_PERF_SCOPE),
+    /// so the registry lock is only ever taken on first use per call site.
+    static Counter& get(char const* _name)
+    {
+        auto const _l = std::lock_guard { registryLock() };
+        for (Counter* counter: registry())
+            if (std::strcmp(counter->name_, _name) == 0)
+                return *counter;
+        return *new Counter(_name); // NB: intentionally leaked; lives until process exit.
+    }
+
+    void add(uint64_t _elapsed) noexcept
+    {
+        invocations_.fetch_add(1, std::memory_order_relaxed);
+        totalTicks_.fetch_add(_elapsed, std::memory_order_relaxed);
+        auto observedMax = maxTicks_.load(std::memory_order_relaxed);
+        while (_elapsed > observedMax
+               && !maxTicks_.compare_exchange_weak(
+                   observedMax, _elapsed, std::memory_order_relaxed, std::memory_order_relaxed))
+            ;
+    }
+
+    static void inspect(std::ostream& _output)
+    {
+        auto const _l = std::lock_guard { registryLock() };
+        _output << "Performance counters (" << ticksUnit() << "):\n";
+        for (Counter const* counter: registry())
+        {
+            auto const n = counter->invocations_.load(std::memory_order_relaxed);
+            auto const total = counter->totalTicks_.load(std::memory_order_relaxed);
+            _output << "  " << counter->name_ << ": count " << n << ", total " << total << ", avg "
+                    << (n ? total / n : 0) << ", max " << counter->maxTicks_.load(std::memory_order_relaxed)
+                    << "\n";
+        }
+    }
+
+  private:
+    static std::vector<Counter*>& registry()
+    {
+        static std::vector<Counter*> counters;
+        return counters;
+    }
+
+    static std::mutex& registryLock()
+    {
+        static std::mutex lock;
+        return lock;
+    }
+
+    char const* name_;
+    std::atomic<uint64_t> invocations_ { 0 };
+    std::atomic<uint64_t> totalTicks_ { 0 };
+    std::atomic<uint64_t> maxTicks_ { 0 };
+};
+
+class ScopedTimer
+{
+  public:
+    explicit ScopedTimer(Counter& _counter) noexcept: counter_ { _counter }, start_ { ticks() } {}
+    ~ScopedTimer() { counter_.add(ticks() - start_); }
+
+    ScopedTimer(ScopedTimer const&) = delete;
+    ScopedTimer& operator=(ScopedTimer const&) = delete;
+
+  private:
+    Counter& counter_;
+    uint64_t start_;
+};
+
+inline void inspect(std::ostream& _output)
+{
+    Counter::inspect(_output);
+}
+
+} // namespace crispy::perf
+
+#if defined(CONTOUR_PERF_COUNTERS)
+    #define CRISPY_PERF_SCOPE(name)                                           \
+        static auto& _crispyPerfCounter = crispy::perf::Counter::get(name);   \
+        auto const _crispyPerfScope = crispy::perf::ScopedTimer { _crispyPerfCounter }
+#else
+    #define CRISPY_PERF_SCOPE(name) ((void) 0)
+#endif
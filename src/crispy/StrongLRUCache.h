@@ -73,6 +73,11 @@ class StrongLRUCache
     /// counting from zero again.
     LRUHashtableStats fetchAndClearStats() noexcept;
 
+    /// Grows (or shrinks) the cache to the given geometry, retaining the
+    /// cached entries instead of starting over with an empty cache.
+    /// When shrinking, the least recently used entries are dropped first.
+    void resize(StrongHashtableSize hashCount, LRUCapacity entryCount);
+
     /// Clears all entries from the cache.
     void clear();
 
@@ -162,6 +167,12 @@ LRUHashtableStats StrongLRUCache<Key, Value, Hasher>::fetchAndClearStats() noexc
     return _hashtable->fetchAndClearStats();
 }
 
+template <typename Key, typename Value, typename Hasher>
+void StrongLRUCache<Key, Value, Hasher>::resize(StrongHashtableSize hashCount, LRUCapacity entryCount)
+{
+    _hashtable = _hashtable->resized(hashCount, entryCount);
+}
+
 template <typename Key, typename Value, typename Hasher>
 void StrongLRUCache<Key, Value, Hasher>::clear()
 {
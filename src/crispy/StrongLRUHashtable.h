@@ -54,6 +54,15 @@ namespace detail
         v++;
         return v;
     }
+
+    // 8-bit tag of a strong hash, used as a one-byte prefilter in front of
+    // the full 128-bit comparison when walking a collision chain. Taken from
+    // the topmost byte: the slot index consumes the low bits (see
+    // hashTableSlot), which all entries of one chain share anyway.
+    inline uint8_t hashTag(StrongHash const& hash) noexcept
+    {
+        return static_cast<uint8_t>(_mm_extract_epi16(hash.value, 7) >> 8);
+    }
 } // namespace detail
 // }}}
 
@@ -62,6 +71,10 @@ struct LRUHashtableStats
     uint32_t hits;
     uint32_t misses;
     uint32_t recycles;
+
+    // Number of recycles that had to evict an entry already used in the
+    // current generation, i.e. the working set exceeds the capacity.
+    uint32_t overcommits;
 };
 
 // Defines the number of hashes the hashtable can store.
@@ -100,6 +113,18 @@ class StrongLRUHashtable
     template <typename Allocator = std::allocator<unsigned char>>
     static Ptr create(StrongHashtableSize hashCount, LRUCapacity entryCount, std::string name = "");
 
+    /// Creates a hashtable with the given (new) geometry and moves all live
+    /// entries over, least recently used first, such that LRU ordering is
+    /// preserved and no entry is lost unless the new capacity is smaller
+    /// than size().
+    ///
+    /// The single-block memory layout rules out rehashing in place, but
+    /// migrating the values into the new table still avoids the full
+    /// teardown-and-refill a destroy/create cycle would force upon the
+    /// caller.
+    template <typename Allocator = std::allocator<unsigned char>>
+    [[nodiscard]] Ptr resized(StrongHashtableSize hashCount, LRUCapacity entryCount);
+
     /// Returns the actual number of entries currently hold in this hashtable.
     [[nodiscard]] size_t size() const noexcept;
 
@@ -113,6 +138,18 @@ class StrongLRUHashtable
     /// counting from zero again.
     LRUHashtableStats fetchAndClearStats() noexcept;
 
+    /// Starts a new usage generation (typically one render frame).
+    ///
+    /// Entries touched from now on count as part of the current working set:
+    /// on overflow the eviction prefers entries from older generations, so a
+    /// full hashtable does not evict entries that are used again within the
+    /// same generation (see recycle()).
+    void nextGeneration() noexcept
+    {
+        ++_currentGeneration;
+        _generationExhausted = false;
+    }
+
     /// Clears all entries from the hashtable.
     void clear();
 
@@ -207,6 +244,9 @@ class StrongLRUHashtable
         uint32_t nextInLRU = 0;
         uint32_t nextWithSameHash = 0;
 
+        // Usage generation this entry was last touched in (see nextGeneration()).
+        uint32_t generation = 0;
+
         std::optional<Value> value = std::nullopt;
 
 #if defined(DEBUG_STRONG_LRU_HASHTABLE)
@@ -254,12 +294,22 @@ class StrongLRUHashtable
     StrongHashtableSize _hashCount;
     uint32_t _size;
     LRUCapacity _capacity;
+
+    // Current usage generation and whether every entry was already used in
+    // it (in which case recycle() falls back to plain LRU order).
+    uint32_t _currentGeneration = 0;
+    bool _generationExhausted = false;
     std::string _name;
 
     // The hash table maps hash codes to indices into the entry table.
     uint32_t* _hashTable;
     Entry* _entries;
 
+    // One 8-bit tag per entry (parallel to _entries), compared before the
+    // full 128-bit hash when walking a collision chain; see detail::hashTag.
+    // Never cleared: a stale tag merely costs one full comparison.
+    uint8_t* _hashTags;
+
 #if defined(DEBUG_STRONG_LRU_HASHTABLE)
     int _lastLRUCount = 0;
 #endif
@@ -287,13 +337,15 @@ StrongLRUHashtable<Value>::StrongLRUHashtable(StrongHashtableSize hashCount,
         Entry* entryTable = (Entry*) (uintptr_t((char*) hashTableEnd + AlignMask) & ~AlignMask);
 
         return entryTable;
-    }() }
+    }() },
+    _hashTags { (uint8_t*) (_entries + 1 + entryCount.value) }
 {
     Require(detail::isPowerOfTwo(hashCount.value));
     Require(hashCount.value >= 1);
     Require(entryCount.value >= 2);
 
     memset(_hashTable, 0, hashCount.value * sizeof(uint32_t));
+    memset(_hashTags, 0, 1 + entryCount.value);
 
     for (uint32_t entryIndex = 0; entryIndex <= entryCount.value; ++entryIndex)
     {
@@ -319,7 +371,8 @@ constexpr inline size_t StrongLRUHashtable<Value>::requiredMemorySize(StrongHash
 
     auto const hashSize = hashCount.value * sizeof(uint32_t);
     auto const entrySize = (1 + entryCount.value) * sizeof(Entry) + std::alignment_of_v<Entry>;
-    auto const totalSize = sizeof(StrongLRUHashtable) + hashSize + entrySize;
+    auto const tagSize = (1 + entryCount.value) * sizeof(uint8_t);
+    auto const totalSize = sizeof(StrongLRUHashtable) + hashSize + entrySize + tagSize;
     return totalSize;
 }
 
@@ -335,6 +388,7 @@ auto StrongLRUHashtable<Value>::create(StrongHashtableSize hashCount,
     // [object  attribs]
     // uint32_t[] hash table
     // Entry[]    entries
+    // uint8_t[]  hash tags
 
     if (!detail::isPowerOfTwo(hashCount.value))
         hashCount.value = detail::nextPowerOfTwo(hashCount.value);
@@ -359,6 +413,28 @@ auto StrongLRUHashtable<Value>::create(StrongHashtableSize hashCount,
     return Ptr(obj, std::move(deleter));
 }
 
+template <typename Value>
+template <typename Allocator>
+auto StrongLRUHashtable<Value>::resized(StrongHashtableSize hashCount, LRUCapacity entryCount) -> Ptr
+{
+    Ptr target = create<Allocator>(hashCount, entryCount, _name);
+
+    // Walk the LRU chain backwards (sentinel.prevInLRU is the least recently
+    // used entry), so that linking each migrated entry to the target's LRU
+    // chain head reproduces the current ordering. When shrinking, the target
+    // recycles the oldest entries first, exactly as on overflow.
+    Entry& sentinel = sentinelEntry();
+    for (uint32_t entryIndex = sentinel.prevInLRU; entryIndex != 0;)
+    {
+        Entry& entry = _entries[entryIndex];
+        if (entry.value.has_value())
+            (void) target->get_or_emplace(entry.hashValue, [&](uint32_t) { return std::move(*entry.value); });
+        entryIndex = entry.prevInLRU;
+    }
+
+    return target;
+}
+
 template <typename Value>
 inline size_t StrongLRUHashtable<Value>::size() const noexcept
 {
@@ -430,13 +506,14 @@ void StrongLRUHashtable<Value>::remove(StrongHash const& hash)
 {
     uint32_t* slot = hashTableSlot(hash);
     uint32_t entryIndex = *slot;
+    uint8_t const tag = detail::hashTag(hash);
     uint32_t prevWithSameHash = 0;
     Entry* entry = nullptr;
 
     while (entryIndex)
     {
         entry = _entries + entryIndex;
-        if (entry->hashValue == hash)
+        if (_hashTags[entryIndex] == tag && entry->hashValue == hash)
             break;
         prevWithSameHash = entryIndex;
         entryIndex = entry->nextWithSameHash;
@@ -512,10 +589,11 @@ inline Value& StrongLRUHashtable<Value>::peek(StrongHash const& hash)
 {
     uint32_t* slot = hashTableSlot(hash);
     uint32_t entryIndex = *slot;
+    uint8_t const tag = detail::hashTag(hash);
     while (entryIndex)
     {
         Entry& entry = _entries[entryIndex];
-        if (entry.hashValue == hash)
+        if (_hashTags[entryIndex] == tag && entry.hashValue == hash)
             return *entry.value;
         entryIndex = entry.nextWithSameHash;
     }
@@ -556,10 +634,11 @@ inline Value& StrongLRUHashtable<Value>::get_or_emplace(StrongHash const& hash,
     uint32_t* slot = hashTableSlot(hash);
 
     uint32_t entryIndex = *slot;
+    uint8_t const tag = detail::hashTag(hash);
     while (entryIndex)
     {
         Entry& candidateEntry = _entries[entryIndex];
-        if (candidateEntry.hashValue == hash)
+        if (_hashTags[entryIndex] == tag && candidateEntry.hashValue == hash)
         {
             ++_stats.hits;
             unlinkFromLRUChain(candidateEntry);
@@ -587,10 +666,11 @@ inline Value* StrongLRUHashtable<Value>::get_or_try_emplace(StrongHash const& ha
     uint32_t* slot = hashTableSlot(hash);
 
     uint32_t entryIndex = *slot;
+    uint8_t const tag = detail::hashTag(hash);
     while (entryIndex)
     {
         Entry& candidateEntry = _entries[entryIndex];
-        if (candidateEntry.hashValue == hash)
+        if (_hashTags[entryIndex] == tag && candidateEntry.hashValue == hash)
         {
             ++_stats.hits;
             unlinkFromLRUChain(candidateEntry);
@@ -717,11 +797,12 @@ uint32_t StrongLRUHashtable<Value>::findEntry(StrongHash const& hash, bool force
 {
     uint32_t* slot = hashTableSlot(hash);
     uint32_t entryIndex = *slot;
+    uint8_t const tag = detail::hashTag(hash);
     Entry* result = nullptr;
     while (entryIndex)
     {
         Entry& entry = _entries[entryIndex];
-        if (entry.hashValue == hash)
+        if (_hashTags[entryIndex] == tag && entry.hashValue == hash)
         {
             result = &entry;
             break;
@@ -774,6 +855,7 @@ inline void StrongLRUHashtable<Value>::linkToLRUChainHead(uint32_t entryIndex) n
 
     newHead.nextInLRU = sentinel.nextInLRU;
     newHead.prevInLRU = 0;
+    newHead.generation = _currentGeneration;
     oldHead.prevInLRU = entryIndex;
     sentinel.nextInLRU = entryIndex;
 
@@ -803,6 +885,7 @@ uint32_t StrongLRUHashtable<Value>::allocateEntry(StrongHash const& hash, uint32
 
     poppedEntry.value.reset();
     poppedEntry.hashValue = hash;
+    _hashTags[poppedEntryIndex] = detail::hashTag(hash);
     poppedEntry.nextWithSameHash = *slot;
     *slot = poppedEntryIndex;
 
@@ -819,14 +902,29 @@ void StrongLRUHashtable<Value>::recycle()
     Entry& sentinel = sentinelEntry();
     Require(sentinel.prevInLRU != 0);
 
-    uint32_t const entryIndex = sentinel.prevInLRU;
-    Entry& entry = _entries[entryIndex];
-    Entry& prev = _entries[entry.prevInLRU];
+    // Prefer evicting an entry that was not used in the current generation.
+    // Evicting the LRU tail while it is still part of this generation's
+    // working set would only cause it to be re-created later in the very same
+    // generation (eviction thrash whenever the working set slightly exceeds
+    // the capacity). Once the whole chain has been used in this generation,
+    // fall back to plain LRU order and record the overcommit.
+    uint32_t entryIndex = sentinel.prevInLRU;
+    if (!_generationExhausted)
+    {
+        while (entryIndex != 0 && _entries[entryIndex].generation == _currentGeneration)
+            entryIndex = _entries[entryIndex].prevInLRU;
+        if (entryIndex == 0)
+        {
+            _generationExhausted = true;
+            entryIndex = sentinel.prevInLRU;
+        }
+    }
+    if (_generationExhausted)
+        ++_stats.overcommits;
 
-    prev.nextInLRU = 0;
-    sentinel.prevInLRU = entry.prevInLRU;
+    Entry& entry = _entries[entryIndex];
 
-    validateChange(-1);
+    unlinkFromLRUChain(entry);
 
     uint32_t* nextIndex = hashTableSlot(entry.hashValue);
     while (*nextIndex != entryIndex)
@@ -890,10 +988,11 @@ struct formatter<crispy::LRUHashtableStats>
     {
         return format_to(
             ctx.out(),
-            "{} hits, {} misses, {} evictions, {:.3}% hit rate",
+            "{} hits, {} misses, {} evictions ({} overcommits), {:.3}% hit rate",
             stats.hits,
             stats.misses,
             stats.recycles,
+            stats.overcommits,
             stats.hits + stats.misses != 0
                 ? 100.0 * (static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses))
                 : 0.0);
@@ -85,6 +85,29 @@ TEST_CASE("StrongHash", "")
     REQUIRE(a != f);
 }
 
+TEST_CASE("StrongHashBuilder", "")
+{
+    auto const text = "The quick brown fox jumps over the lazy dog"sv;
+    auto const oneShot = StrongHash::compute(text);
+
+    // The builder must produce the same hash regardless of how the
+    // input is split up across update() calls.
+    for (size_t const splitOffset: { size_t { 1 }, size_t { 7 }, size_t { 16 }, size_t { 31 } })
+    {
+        auto builder = StrongHashBuilder {};
+        builder.update(text.substr(0, splitOffset));
+        builder.update(text.substr(splitOffset));
+        REQUIRE(builder.finalize() == oneShot);
+    }
+
+    auto bytewise = StrongHashBuilder {};
+    for (char const ch: text)
+        bytewise.update(string_view(&ch, 1));
+    REQUIRE(bytewise.finalize() == oneShot);
+
+    REQUIRE(StrongHash::compute(""sv) != StrongHash::compute("\0"sv));
+}
+
 TEST_CASE("StrongLRUHashtable.operator_index", "")
 {
     auto cachePtr = StrongLRUHashtable<int>::create(StrongHashtableSize { 8 }, LRUCapacity { 4 });
@@ -140,6 +163,47 @@ TEST_CASE("StrongLRUHashtable.clear", "[lrucache]")
     CHECK(cache.size() == 0);
 }
 
+TEST_CASE("StrongLRUHashtable.resized_grow", "[lrucache]")
+{
+    auto cachePtr = StrongLRUHashtable<int>::create(StrongHashtableSize { 8 }, LRUCapacity { 4 });
+    auto& cache = *cachePtr;
+    for (int i = 1; i <= 4; ++i)
+        cache[h(i)] = 2 * i;
+    REQUIRE(joinHumanReadable(cache.hashes()) == sh(4, 3, 2, 1));
+
+    auto grownPtr = cache.resized(StrongHashtableSize { 16 }, LRUCapacity { 8 });
+    auto& grown = *grownPtr;
+
+    CHECK(grown.size() == 4);
+    CHECK(grown.capacity() == 8);
+    CHECK(joinHumanReadable(grown.hashes()) == sh(4, 3, 2, 1));
+    for (int i = 1; i <= 4; ++i)
+        CHECK(grown.at(h(i)) == 2 * i);
+
+    // The grown table takes new entries without evicting the migrated ones.
+    for (int i = 5; i <= 8; ++i)
+        grown[h(i)] = 2 * i;
+    CHECK(joinHumanReadable(grown.hashes()) == sh(8, 7, 6, 5, 4, 3, 2, 1));
+}
+
+TEST_CASE("StrongLRUHashtable.resized_shrink", "[lrucache]")
+{
+    auto cachePtr = StrongLRUHashtable<int>::create(StrongHashtableSize { 8 }, LRUCapacity { 4 });
+    auto& cache = *cachePtr;
+    for (int i = 1; i <= 4; ++i)
+        cache[h(i)] = 2 * i;
+    REQUIRE(joinHumanReadable(cache.hashes()) == sh(4, 3, 2, 1));
+
+    auto shrunkPtr = cache.resized(StrongHashtableSize { 4 }, LRUCapacity { 2 });
+    auto& shrunk = *shrunkPtr;
+
+    // Only the most recently used entries survive the shrink.
+    CHECK(shrunk.size() == 2);
+    CHECK(joinHumanReadable(shrunk.hashes()) == sh(4, 3));
+    CHECK(shrunk.at(h(3)) == 6);
+    CHECK(shrunk.at(h(4)) == 8);
+}
+
 TEST_CASE("StrongLRUHashtable.touch", "")
 {
     auto cachePtr = StrongLRUHashtable<int>::create(StrongHashtableSize { 8 }, LRUCapacity { 4 });
@@ -422,3 +486,30 @@ TEST_CASE("StrongLRUHashtable.peek", "")
         REQUIRE(joinHumanReadable(cache.hashes()) == sh(4, 3, 2, 1));
     }
 }
+
+TEST_CASE("StrongLRUHashtable.generation_coherent_eviction", "[lrucache]")
+{
+    auto cachePtr = StrongLRUHashtable<int>::create(StrongHashtableSize { 8 }, LRUCapacity { 4 });
+    auto& cache = *cachePtr;
+    for (int i = 1; i <= 4; ++i)
+        cache[h(i)] = 2 * i;
+    REQUIRE(joinHumanReadable(cache.hashes()) == sh(4, 3, 2, 1));
+
+    // Entries used in the current generation are not evicted even when they
+    // sit near the LRU tail: inserting into the full hashtable recycles the
+    // least recently used entry of an older generation instead.
+    cache.nextGeneration();
+    CHECK(cache.at(h(1)) == 2);
+    CHECK(cache.at(h(2)) == 4);
+    cache[h(5)] = 10;
+    CHECK(cache.contains(h(1)));
+    CHECK(cache.contains(h(2)));
+    CHECK_FALSE(cache.contains(h(3)));
+
+    // Once every entry was used in the current generation, eviction falls
+    // back to plain LRU order.
+    CHECK(cache.at(h(4)) == 8);
+    CHECK(cache.at(h(5)) == 10);
+    cache[h(6)] = 12;
+    CHECK_FALSE(cache.contains(h(1)));
+}
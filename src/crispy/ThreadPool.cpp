@@ -0,0 +1,213 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <crispy/ThreadPool.h>
+#include <crispy/assert.h>
+
+#include <algorithm>
+#include <utility>
+
+using std::lock_guard;
+using std::make_unique;
+using std::max;
+using std::move;
+using std::unique_lock;
+using std::unique_ptr;
+
+namespace crispy
+{
+
+namespace
+{
+    // Identifies the pool (and worker slot) the current thread belongs to,
+    // so tasks enqueued from within a worker land on that worker's own deque.
+    thread_local ThreadPool* currentPool = nullptr;
+    thread_local size_t currentWorkerIndex = 0;
+
+    unique_ptr<ThreadPool> processPool;
+} // namespace
+
+ThreadPool::ThreadPool(size_t _threadCount)
+{
+    auto const threadCount = max(size_t { 1 }, _threadCount);
+    workers_.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        workers_.emplace_back(make_unique<Worker>());
+    for (size_t i = 0; i < threadCount; ++i)
+        workers_[i]->thread = std::thread([this, i]() { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        auto const _lock = lock_guard { signalMutex_ };
+        stopping_ = true;
+    }
+    signal_.notify_all();
+    for (unique_ptr<Worker>& worker: workers_)
+        worker->thread.join();
+}
+
+void ThreadPool::enqueue(Task _task, Priority _priority)
+{
+    {
+        auto const _lock = lock_guard { drainMutex_ };
+        ++inflightCount_;
+    }
+
+    if (_priority == Priority::FrameCritical)
+    {
+        auto const _lock = lock_guard { signalMutex_ };
+        frameCriticalTasks_.emplace_back(move(_task));
+        ++pendingCount_;
+    }
+    else
+    {
+        Worker& worker = [&]() -> Worker& {
+            if (currentPool == this)
+                return *workers_[currentWorkerIndex];
+            auto const _lock = lock_guard { signalMutex_ };
+            roundRobinIndex_ = (roundRobinIndex_ + 1) % workers_.size();
+            return *workers_[roundRobinIndex_];
+        }();
+        // Count the task before making it visible: a concurrently scanning
+        // worker may acquire and finish it right away, and its decrement
+        // must never precede this increment (pendingCount_ would underflow).
+        // A worker waking on the transiently raised count merely re-scans
+        // empty deques once and goes back to sleep.
+        {
+            auto const _lock = lock_guard { signalMutex_ };
+            ++pendingCount_;
+        }
+        auto const _lock = lock_guard { worker.mutex };
+        worker.tasks.emplace_back(move(_task));
+    }
+
+    signal_.notify_one();
+}
+
+void ThreadPool::waitUntilDrained()
+{
+    auto lock = unique_lock { drainMutex_ };
+    drained_.wait(lock, [this]() { return inflightCount_ == 0; });
+}
+
+size_t ThreadPool::defaultConcurrency() noexcept
+{
+    auto const cores = static_cast<size_t>(max(std::thread::hardware_concurrency(), 1u));
+    return cores > 3 ? cores - 2 : 1;
+}
+
+void ThreadPool::initialize(size_t _threadCount)
+{
+    Require(!processPool);
+    processPool = make_unique<ThreadPool>(_threadCount);
+}
+
+ThreadPool& ThreadPool::instance()
+{
+    // Expected to be first accessed (or explicitly initialized) on the main
+    // thread before any worker-spawning subsystem is up.
+    if (!processPool)
+        processPool = make_unique<ThreadPool>(defaultConcurrency());
+    return *processPool;
+}
+
+void ThreadPool::workerLoop(size_t _index)
+{
+    currentPool = this;
+    currentWorkerIndex = _index;
+
+    for (;;)
+    {
+        Task task;
+        if (tryAcquireTask(_index, task))
+        {
+            task();
+            finishTask();
+            continue;
+        }
+
+        auto lock = unique_lock { signalMutex_ };
+        signal_.wait(lock, [this]() { return stopping_ || pendingCount_ != 0; });
+        if (stopping_ && pendingCount_ == 0)
+            return;
+    }
+}
+
+bool ThreadPool::tryAcquireTask(size_t _index, Task& _task)
+{
+    auto const takeFrom = [&](std::deque<Task>& tasks, bool fromBack) -> bool {
+        if (tasks.empty())
+            return false;
+        if (fromBack)
+        {
+            _task = move(tasks.back());
+            tasks.pop_back();
+        }
+        else
+        {
+            _task = move(tasks.front());
+            tasks.pop_front();
+        }
+        return true;
+    };
+
+    auto const taskTaken = [&]() -> bool {
+        // Frame-critical work always goes first, regardless of which
+        // worker's deque any background work is sitting on.
+        {
+            auto const _lock = lock_guard { signalMutex_ };
+            if (takeFrom(frameCriticalTasks_, false))
+                return true;
+        }
+
+        // Own deque next, LIFO: the most recently pushed work is the
+        // cache-hottest.
+        {
+            Worker& self = *workers_[_index];
+            auto const _lock = lock_guard { self.mutex };
+            if (takeFrom(self.tasks, true))
+                return true;
+        }
+
+        // Steal from the siblings, FIFO: take their oldest (coldest) work.
+        for (size_t offset = 1; offset < workers_.size(); ++offset)
+        {
+            Worker& victim = *workers_[(_index + offset) % workers_.size()];
+            auto const _lock = lock_guard { victim.mutex };
+            if (takeFrom(victim.tasks, false))
+                return true;
+        }
+
+        return false;
+    }();
+
+    if (taskTaken)
+    {
+        auto const _lock = lock_guard { signalMutex_ };
+        --pendingCount_;
+    }
+
+    return taskTaken;
+}
+
+void ThreadPool::finishTask()
+{
+    auto const _lock = lock_guard { drainMutex_ };
+    --inflightCount_;
+    if (inflightCount_ == 0)
+        drained_.notify_all();
+}
+
+} // namespace crispy
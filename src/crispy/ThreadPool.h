@@ -0,0 +1,110 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace crispy
+{
+
+/// Process-wide pool of worker threads with work-stealing.
+///
+/// Each worker owns a deque it pushes to and pops from at the back; idle
+/// workers steal from the front of their siblings' deques, so unrelated
+/// subsystems (search, glyph cache persistence, ...) share the same fixed
+/// set of threads instead of each spawning its own and oversubscribing
+/// the machine.
+///
+/// Tasks carry one of two priorities. FrameCritical tasks bypass the
+/// per-worker deques and are always acquired first; Background tasks run
+/// whenever no frame-critical work is pending.
+class ThreadPool
+{
+  public:
+    enum class Priority
+    {
+        FrameCritical, //!< a caller (render or VT thread) is blocking on the result
+        Background,    //!< latency tolerant (cache persistence, prewarming, ...)
+    };
+
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(size_t _threadCount);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    /// Number of worker threads in this pool.
+    size_t concurrency() const noexcept { return workers_.size(); }
+
+    /// Schedules @p _task for execution on one of the pool's workers.
+    ///
+    /// Tasks enqueued from within a pool worker go to that worker's own
+    /// deque (and are thus picked up next by the enqueuing worker unless
+    /// stolen); tasks from foreign threads are distributed round-robin.
+    void enqueue(Task _task, Priority _priority = Priority::Background);
+
+    /// Blocks until every task enqueued so far has finished executing.
+    void waitUntilDrained();
+
+    /// Pool size leaving headroom for the render and VT threads,
+    /// which are latency sensitive and must not compete for cores.
+    static size_t defaultConcurrency() noexcept;
+
+    /// Sizes the process-wide pool; to be called once at application
+    /// startup, before the first instance() access.
+    static void initialize(size_t _threadCount);
+
+    /// The process-wide pool shared by all subsystems, lazily created
+    /// with defaultConcurrency() unless initialize() was called before.
+    static ThreadPool& instance();
+
+  private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Task> tasks; //!< owner pushes/pops at the back, thieves steal at the front
+        std::thread thread;
+    };
+
+    void workerLoop(size_t _index);
+    bool tryAcquireTask(size_t _index, Task& _task);
+    void finishTask();
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    std::mutex signalMutex_;
+    std::condition_variable signal_;
+    std::deque<Task> frameCriticalTasks_; //!< guarded by signalMutex_
+    size_t pendingCount_ = 0;             //!< guarded by signalMutex_; tasks not yet acquired
+    bool stopping_ = false;               //!< guarded by signalMutex_
+
+    std::mutex drainMutex_;
+    std::condition_variable drained_;
+    size_t inflightCount_ = 0; //!< guarded by drainMutex_; tasks enqueued but not yet finished
+
+    size_t roundRobinIndex_ = 0; //!< guarded by signalMutex_
+};
+
+} // namespace crispy
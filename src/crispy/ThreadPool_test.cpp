@@ -0,0 +1,112 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <crispy/ThreadPool.h>
+
+#include <catch2/catch.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+using crispy::ThreadPool;
+
+TEST_CASE("ThreadPool.runsAllTasks")
+{
+    auto pool = ThreadPool { 4 };
+    auto counter = std::atomic<int> { 0 };
+
+    for (int i = 0; i < 1000; ++i)
+        pool.enqueue([&]() { ++counter; });
+
+    pool.waitUntilDrained();
+    CHECK(counter == 1000);
+}
+
+TEST_CASE("ThreadPool.tasksEnqueuedFromWorkers")
+{
+    auto pool = ThreadPool { 2 };
+    auto counter = std::atomic<int> { 0 };
+
+    for (int i = 0; i < 100; ++i)
+        pool.enqueue([&]() { pool.enqueue([&]() { ++counter; }); });
+
+    pool.waitUntilDrained();
+    CHECK(counter == 100);
+}
+
+TEST_CASE("ThreadPool.workIsSpreadAcrossThreads")
+{
+    auto pool = ThreadPool { 4 };
+    auto mutex = std::mutex {};
+    auto threadIds = std::set<std::thread::id> {};
+
+    // Tasks long enough that no single worker can grab them all.
+    for (int i = 0; i < 64; ++i)
+        pool.enqueue([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            auto const _lock = std::lock_guard { mutex };
+            threadIds.insert(std::this_thread::get_id());
+        });
+
+    pool.waitUntilDrained();
+    CHECK(threadIds.size() > 1);
+}
+
+TEST_CASE("ThreadPool.frameCriticalRunsBeforeBackground")
+{
+    // With a single worker the execution order is fully deterministic once
+    // the worker is released: all frame-critical tasks must precede the
+    // background ones that were enqueued earlier.
+    auto pool = ThreadPool { 1 };
+    auto gate = std::atomic<bool> { false };
+    auto mutex = std::mutex {};
+    auto order = std::vector<int> {};
+
+    pool.enqueue([&]() {
+        while (!gate)
+            std::this_thread::yield();
+    });
+
+    for (int i = 0; i < 4; ++i)
+        pool.enqueue([&, i]() {
+            auto const _lock = std::lock_guard { mutex };
+            order.push_back(i);
+        });
+    pool.enqueue(
+        [&]() {
+            auto const _lock = std::lock_guard { mutex };
+            order.push_back(42);
+        },
+        ThreadPool::Priority::FrameCritical);
+
+    gate = true;
+    pool.waitUntilDrained();
+
+    REQUIRE(order.size() == 5);
+    CHECK(order.front() == 42);
+}
+
+TEST_CASE("ThreadPool.clampsToAtLeastOneThread")
+{
+    auto pool = ThreadPool { 0 };
+    CHECK(pool.concurrency() == 1);
+
+    auto ran = std::atomic<bool> { false };
+    pool.enqueue([&]() { ran = true; });
+    pool.waitUntilDrained();
+    CHECK(ran);
+}
@@ -0,0 +1,34 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <vector>
+
+namespace crispy
+{
+
+/// Pins the calling thread onto the given set of CPU ids.
+///
+/// Intended for latency-sensitive threads (VT, render) on multi-socket
+/// machines, where an unpinned thread migrating across NUMA nodes keeps
+/// paying remote-memory latency for its working set. Pinning also makes
+/// first-touch page placement effective: memory a pinned thread allocates
+/// and touches ends up on that thread's node.
+///
+/// @returns true if the affinity was applied; false on an empty CPU set,
+///          on failure, or on platforms without thread affinity support
+///          (where this is a no-op).
+bool pinCurrentThreadToCpus(std::vector<unsigned> const& _cpus);
+
+} // namespace crispy
@@ -72,17 +72,37 @@ inline void set_fail_handler(fail_handler_t _handler)
     detail::fail_handler() = std::move(_handler);
 }
 
-#define Require(cond)                                                                       \
-    do                                                                                      \
-    {                                                                                       \
-        ::crispy::detail::check((cond), #cond, "Precondition failed.", __FILE__, __LINE__); \
-    } while (0)
-
-#define Guarantee(cond)                                                                      \
-    do                                                                                       \
-    {                                                                                        \
-        ::crispy::detail::check((cond), #cond, "Postcondition failed.", __FILE__, __LINE__); \
-    } while (0)
+// Max-throughput builds (CONTOUR_MAX_THROUGHPUT) compile the pre- and
+// postcondition checks to nothing: several of them sit in per-cell and
+// per-byte hot loops (grid cell access, parser, atlas caches) where even a
+// well-predicted branch is measurable. The condition is still evaluated for
+// its side-effect-freeness at compile time via sizeof, so expressions do not
+// rot while the checks are disabled.
+#if defined(CONTOUR_MAX_THROUGHPUT)
+    #define Require(cond)                        \
+        do                                       \
+        {                                        \
+            (void) sizeof((cond) ? true : false); \
+        } while (0)
+
+    #define Guarantee(cond)                      \
+        do                                       \
+        {                                        \
+            (void) sizeof((cond) ? true : false); \
+        } while (0)
+#else
+    #define Require(cond)                                                                       \
+        do                                                                                      \
+        {                                                                                       \
+            ::crispy::detail::check((cond), #cond, "Precondition failed.", __FILE__, __LINE__); \
+        } while (0)
+
+    #define Guarantee(cond)                                                                      \
+        do                                                                                       \
+        {                                                                                        \
+            ::crispy::detail::check((cond), #cond, "Postcondition failed.", __FILE__, __LINE__); \
+        } while (0)
+#endif
 
 #if defined(__GNUC__)
 // GCC 4.8+, Clang, Intel and other compilers compatible with GCC (-std=c++0x or above)
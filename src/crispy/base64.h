@@ -13,9 +13,16 @@
  */
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <string_view>
 
+#if defined(__SSSE3__)
+    #include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    #include <arm_neon.h>
+#endif
+
 namespace crispy::base64
 {
 
@@ -43,6 +50,111 @@ namespace detail
         64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64  // 240..255
     };
     // clang-format on
+
+    /// Decodes complete 16-character blocks (12 output bytes each) with shuffle-based
+    /// SIMD, stopping at the first block containing a character outside the base64
+    /// alphabet (such as the '=' padding) and leaving the rest - including the tail -
+    /// to the scalar 4-characters-at-a-time loop.
+    ///
+    /// @returns the number of input characters consumed (always a multiple of 16).
+#if defined(__SSSE3__)
+    inline size_t decodeBulk(char const* _input, size_t _count, char* _output) noexcept
+    {
+        // Muła's pshufb-based decoding: classify each character by its nibbles to
+        // validate it, translate it to its 6-bit value by adding a nibble-indexed
+        // offset, then pack 16 values into 12 bytes via two multiply-adds.
+        auto const lutLo = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                         0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+        auto const lutHi = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                         0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+        auto const lutRoll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        auto const nibbleMask = _mm_set1_epi8(0x0F);
+
+        size_t consumed = 0;
+        while (consumed + 16 <= _count)
+        {
+            auto const in = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_input + consumed));
+            auto const hiNibbles = _mm_and_si128(_mm_srli_epi32(in, 4), nibbleMask);
+            auto const loNibbles = _mm_and_si128(in, nibbleMask);
+            auto const lo = _mm_shuffle_epi8(lutLo, loNibbles);
+            auto const hi = _mm_shuffle_epi8(lutHi, hiNibbles);
+            if (_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0)
+                break;
+
+            auto const eq2F = _mm_cmpeq_epi8(in, _mm_set1_epi8(0x2F));
+            auto const roll = _mm_shuffle_epi8(lutRoll, _mm_add_epi8(eq2F, hiNibbles));
+            auto const values = _mm_add_epi8(in, roll);
+
+            auto const merged = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+            auto const packed = _mm_madd_epi16(merged, _mm_set1_epi32(0x00011000));
+            auto const shuffled = _mm_shuffle_epi8(
+                packed, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+            char buffer[16];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buffer), shuffled);
+            std::memcpy(_output, buffer, 12);
+            _output += 12;
+            consumed += 16;
+        }
+        return consumed;
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    inline size_t decodeBulk(char const* _input, size_t _count, char* _output) noexcept
+    {
+        // NEON port of the pshufb-based decoding above; the multiply-adds are
+        // expressed as shift-and-add within the 16-bit/32-bit lanes.
+        alignas(16) static constexpr uint8_t lutLo[16] = { 0x15, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                                           0x11, 0x11, 0x11, 0x11, 0x13, 0x1A,
+                                                           0x1B, 0x1B, 0x1B, 0x1A };
+        alignas(16) static constexpr uint8_t lutHi[16] = { 0x10, 0x10, 0x01, 0x02, 0x04, 0x08,
+                                                           0x04, 0x08, 0x10, 0x10, 0x10, 0x10,
+                                                           0x10, 0x10, 0x10, 0x10 };
+        alignas(16) static constexpr uint8_t lutRoll[16] = { 0, 16, 19, 4, 191, 191, 185, 185,
+                                                             0, 0,  0,  0, 0,   0,   0,   0 };
+        alignas(16) static constexpr uint8_t packShuffle[16] = { 2,  1,  0,  6,   5,   4,   10,  9,
+                                                                 8,  14, 13, 12,  255, 255, 255, 255 };
+        auto const lutLoV = vld1q_u8(lutLo);
+        auto const lutHiV = vld1q_u8(lutHi);
+        auto const lutRollV = vld1q_u8(lutRoll);
+        auto const packShuffleV = vld1q_u8(packShuffle);
+
+        size_t consumed = 0;
+        while (consumed + 16 <= _count)
+        {
+            auto const in = vld1q_u8(reinterpret_cast<uint8_t const*>(_input + consumed));
+            auto const hiNibbles = vshrq_n_u8(in, 4);
+            auto const loNibbles = vandq_u8(in, vdupq_n_u8(0x0F));
+            auto const lo = vqtbl1q_u8(lutLoV, loNibbles);
+            auto const hi = vqtbl1q_u8(lutHiV, hiNibbles);
+            if (vmaxvq_u8(vandq_u8(lo, hi)) != 0)
+                break;
+
+            auto const eq2F = vceqq_u8(in, vdupq_n_u8(0x2F));
+            auto const roll = vqtbl1q_u8(lutRollV, vaddq_u8(hiNibbles, eq2F));
+            auto const values = vaddq_u8(in, roll);
+
+            auto const pairs = vreinterpretq_u16_u8(values);
+            auto const merged16 =
+                vaddq_u16(vshlq_n_u16(vandq_u16(pairs, vdupq_n_u16(0x00FF)), 6), vshrq_n_u16(pairs, 8));
+            auto const quads = vreinterpretq_u32_u16(merged16);
+            auto const merged32 =
+                vaddq_u32(vshlq_n_u32(vandq_u32(quads, vdupq_n_u32(0xFFFF)), 12), vshrq_n_u32(quads, 16));
+            auto const shuffled = vqtbl1q_u8(vreinterpretq_u8_u32(merged32), packShuffleV);
+
+            uint8_t buffer[16];
+            vst1q_u8(buffer, shuffled);
+            std::memcpy(_output, buffer, 12);
+            _output += 12;
+            consumed += 16;
+        }
+        return consumed;
+    }
+#else
+    inline size_t decodeBulk(char const* /*_input*/, size_t /*_count*/, char* /*_output*/) noexcept
+    {
+        return 0;
+    }
+#endif
 } // namespace detail
 
 template <typename Iterator, typename Alphabet>
@@ -198,6 +310,17 @@ size_t decode(std::string_view const& input, Output output)
     return decode(input.begin(), input.end(), output);
 }
 
+/// Decodes a contiguous base64-encoded string into @p output, handing the bulk of
+/// the payload to the SIMD block decoder and only the (possibly padded) tail to the
+/// scalar loop, so large payloads - e.g. OSC 52 clipboard writes or image
+/// transmissions - decode at memory speed instead of one character at a time.
+inline size_t decode(std::string_view const& input, char* output)
+{
+    auto const consumed = detail::decodeBulk(input.data(), input.size(), output);
+    auto const decoded = (consumed / 4) * 3;
+    return decoded + decode(input.begin() + consumed, input.end(), detail::indexmap, output + decoded);
+}
+
 inline std::string decode(const std::string_view& input)
 {
     std::string output;
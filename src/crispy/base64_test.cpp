@@ -34,3 +34,18 @@ TEST_CASE("base64.decode", "[base64]")
     CHECK("abcd" == base64::decode("YWJjZA=="));
     CHECK("foo:bar" == base64::decode("Zm9vOmJhcg=="));
 }
+
+TEST_CASE("base64.decode.bulk", "[base64]")
+{
+    // Long enough to exercise the SIMD block decoder (16 input chars per block)
+    // for every tail length (0..3 remainder bytes), including all 256 byte values.
+    for (size_t length: { 48u, 49u, 50u, 51u, 256u, 1000u })
+    {
+        auto input = std::string {};
+        input.resize(length);
+        for (size_t i = 0; i < length; ++i)
+            input[i] = static_cast<char>(i & 0xFF);
+
+        CHECK(input == base64::decode(base64::encode(input)));
+    }
+}
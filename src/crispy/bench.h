@@ -0,0 +1,120 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// Tiny micro-benchmark harness shared by the *_bench executables.
+///
+/// Runs each benchmark body in a calibrated loop and collects ns/op plus
+/// throughput, to be emitted as one JSON document that
+/// scripts/compare-benchmarks.py can diff against a recorded baseline.
+namespace crispy::bench
+{
+
+/// Sink for benchmark results, so the compiler cannot optimize the measured
+/// loops away.
+inline volatile uint64_t sink = 0;
+
+struct Result
+{
+    std::string name;
+    double nsPerOp;
+    double opsPerSecond;
+    double megabytesPerSecond; // 0 if not byte-oriented
+};
+
+inline std::vector<Result>& results()
+{
+    static std::vector<Result> store;
+    return store;
+}
+
+/// Runs _body in a calibrated loop and records its timing.
+///
+/// @param _name        benchmark name as reported in the JSON output
+/// @param _bytesPerOp  bytes processed per invocation (0 if not byte-oriented)
+/// @param _body        one benchmark operation; invoked with the iteration number
+template <typename Body>
+void benchmark(std::string _name, std::size_t _bytesPerOp, Body&& _body)
+{
+    using std::chrono::steady_clock;
+
+    // Minimum measuring time per benchmark; short enough to keep the whole
+    // suite interactive, long enough to make scheduler noise negligible.
+    constexpr auto MinDuration = std::chrono::milliseconds(500);
+
+    // Warm up caches and branch predictors before taking the time.
+    for (uint64_t i = 0; i < 10; ++i)
+        _body(i);
+
+    auto iterations = uint64_t { 0 };
+    auto elapsed = steady_clock::duration::zero();
+    auto batchSize = uint64_t { 10 };
+    while (elapsed < MinDuration)
+    {
+        auto const start = steady_clock::now();
+        for (uint64_t i = 0; i < batchSize; ++i)
+            _body(iterations + i);
+        elapsed += steady_clock::now() - start;
+        iterations += batchSize;
+        batchSize *= 2;
+    }
+
+    auto const seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(elapsed).count();
+    auto const opsPerSecond = double(iterations) / seconds;
+    results().emplace_back(Result { std::move(_name),
+                                    seconds * 1e9 / double(iterations),
+                                    opsPerSecond,
+                                    _bytesPerOp ? opsPerSecond * double(_bytesPerOp) / 1e6 : 0.0 });
+}
+
+/// Emits all recorded results whose name contains @p _filter as JSON.
+inline void emitJSON(std::ostream& _out, std::string_view _filter = {})
+{
+    auto const matches = [&](Result const& result) {
+        return result.name.find(_filter) != std::string::npos;
+    };
+
+    auto matching = std::size_t { 0 };
+    for (auto const& result: results())
+        matching += matches(result);
+
+    _out << "{\n  \"benchmarks\": [\n";
+    auto emitted = std::size_t { 0 };
+    for (auto const& result: results())
+    {
+        if (!matches(result))
+            continue;
+        _out << fmt::format("    {{ \"name\": \"{}\", \"ns_per_op\": {:.2f}, \"ops_per_sec\": {:.0f}",
+                            result.name,
+                            result.nsPerOp,
+                            result.opsPerSecond);
+        if (result.megabytesPerSecond > 0.0)
+            _out << fmt::format(", \"mbps\": {:.2f}", result.megabytesPerSecond);
+        _out << (++emitted < matching ? " },\n" : " }\n");
+    }
+    _out << "  ]\n}\n";
+}
+
+} // namespace crispy::bench
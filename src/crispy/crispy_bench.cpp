@@ -0,0 +1,175 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Micro-benchmarks for the crispy container primitives that sit on the
+// terminal's hot paths: StrongHash, LRUCache / StrongLRUHashtable, and ring.
+//
+// Emits one JSON document on stdout, suitable for regression-gating via
+// scripts/compare-benchmarks.py against a previously recorded run.
+
+#include <crispy/FNV.h>
+#include <crispy/LRUCache.h>
+#include <crispy/StrongHash.h>
+#include <crispy/StrongLRUHashtable.h>
+#include <crispy/bench.h>
+#include <crispy/hash.h>
+#include <crispy/ring.h>
+
+#include <fmt/format.h>
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+using crispy::bench::benchmark;
+using crispy::bench::sink;
+
+namespace
+{
+
+void benchStrongHash()
+{
+    auto const makePayload = [](size_t n) {
+        auto payload = string {};
+        payload.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+            payload += char('a' + int(i % 26));
+        return payload;
+    };
+
+    auto const small = makePayload(16);
+    auto const cellRun = makePayload(80);
+    auto const large = makePayload(4096);
+
+    benchmark("strong_hash.16B", small.size(), [&](uint64_t) {
+        sink += uint64_t(_mm_extract_epi32(crispy::StrongHash::compute(small).value, 0));
+    });
+    benchmark("strong_hash.80B", cellRun.size(), [&](uint64_t) {
+        sink += uint64_t(_mm_extract_epi32(crispy::StrongHash::compute(cellRun).value, 0));
+    });
+    benchmark("strong_hash.4KB", large.size(), [&](uint64_t) {
+        sink += uint64_t(_mm_extract_epi32(crispy::StrongHash::compute(large).value, 0));
+    });
+
+    // FNV vs the wyhash-style bulk hasher, over the same payloads - the
+    // numbers justifying which of the two a new call site should pick.
+    auto const fnv = crispy::FNV<char, uint64_t> {};
+    benchmark("fnv.16B", small.size(), [&](uint64_t) { sink += fnv(small); });
+    benchmark("fnv.80B", cellRun.size(), [&](uint64_t) { sink += fnv(cellRun); });
+    benchmark("fnv.4KB", large.size(), [&](uint64_t) { sink += fnv(large); });
+
+    benchmark("hash.16B", small.size(), [&](uint64_t) { sink += crispy::hash(small); });
+    benchmark("hash.80B", cellRun.size(), [&](uint64_t) { sink += crispy::hash(cellRun); });
+    benchmark("hash.4KB", large.size(), [&](uint64_t) { sink += crispy::hash(large); });
+}
+
+void benchLRUCache()
+{
+    auto constexpr Capacity = size_t { 1024 };
+
+    auto cache = crispy::LRUCache<uint64_t, uint64_t> { Capacity };
+    for (uint64_t key = 0; key < Capacity; ++key)
+        cache[key] = key;
+
+    benchmark("lru_cache.hit", 0, [&](uint64_t i) {
+        if (auto const* value = cache.try_get(i % Capacity))
+            sink += *value;
+    });
+
+    // Every access brings in a fresh key, evicting the least recently used
+    // entry; this is the steady-state path of a cache under 100% churn.
+    benchmark("lru_cache.miss_evict", 0, [&](uint64_t i) { sink += (cache[Capacity + i] = i); });
+}
+
+void benchStrongLRUHashtable()
+{
+    auto constexpr Capacity = uint32_t { 1024 };
+
+    auto table = crispy::StrongLRUHashtable<uint64_t>::create(crispy::StrongHashtableSize { 2 * Capacity },
+                                                              crispy::LRUCapacity { Capacity });
+
+    auto hashes = vector<crispy::StrongHash> {};
+    hashes.reserve(2 * Capacity);
+    for (uint64_t key = 0; key < 2 * Capacity; ++key)
+        hashes.emplace_back(crispy::StrongHash::compute(key));
+
+    for (uint64_t key = 0; key < Capacity; ++key)
+        table->emplace(hashes[key], key);
+
+    benchmark("strong_lru_hashtable.hit", 0, [&](uint64_t i) {
+        if (auto const* value = table->try_get(hashes[i % Capacity]))
+            sink += *value;
+    });
+
+    // Cycling through twice the capacity guarantees every lookup misses and
+    // recycles the least recently used slot.
+    benchmark("strong_lru_hashtable.miss_evict", 0, [&](uint64_t i) {
+        sink += table->get_or_emplace(hashes[i % hashes.size()], [i](uint32_t) { return i; });
+    });
+}
+
+void benchRing()
+{
+    auto constexpr N = size_t { 64 * 1024 };
+
+    auto r = crispy::ring<uint64_t>(N, {});
+    for (size_t i = 0; i < N; ++i)
+        r[int(i)] = i;
+    r.rotate_left(N / 3); // exercise the wrap-around path, like a scrolled grid
+
+    benchmark("ring.index", N * sizeof(uint64_t), [&](uint64_t) {
+        auto sum = uint64_t { 0 };
+        for (size_t i = 0; i < N; ++i)
+            sum += r[int(i)];
+        sink += sum;
+    });
+
+    benchmark("ring.iterator", N * sizeof(uint64_t), [&](uint64_t) {
+        auto sum = uint64_t { 0 };
+        for (auto const value: r)
+            sum += value;
+        sink += sum;
+    });
+
+    benchmark("ring.segments", N * sizeof(uint64_t), [&](uint64_t) {
+        auto sum = uint64_t { 0 };
+        auto const [first, second] = r.segments();
+        for (auto const value: first)
+            sum += value;
+        for (auto const value: second)
+            sum += value;
+        sink += sum;
+    });
+}
+
+} // namespace
+
+int main(int argc, char const* argv[])
+{
+    // Optional name filter: run only benchmarks whose name contains the argument.
+    auto const filter = string_view { argc > 1 ? argv[1] : "" };
+
+    benchStrongHash();
+    benchLRUCache();
+    benchStrongLRUHashtable();
+    benchRing();
+
+    crispy::bench::emitJSON(cout, filter);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include <intrin.h>
+#endif
+
+/// Fast non-cryptographic bulk hashing (wyhash-style).
+///
+/// The general-purpose replacement for crispy::FNV on hot paths: FNV
+/// advances one byte per multiply, while the 64x64->128 folding multiply
+/// below consumes 16 bytes per round - an order of magnitude more
+/// throughput on multi-byte keys, at equal or better dispersion.
+/// crispy::FNV remains for constexpr contexts and incremental
+/// few-values-at-a-time hashing.
+namespace crispy
+{
+
+namespace detail
+{
+    inline uint64_t loadWord64(unsigned char const* _p) noexcept
+    {
+        uint64_t v {};
+        std::memcpy(&v, _p, sizeof(v));
+        return v;
+    }
+
+    inline uint64_t loadWord32(unsigned char const* _p) noexcept
+    {
+        uint32_t v {};
+        std::memcpy(&v, _p, sizeof(v));
+        return v;
+    }
+
+    /// The wyhash mixing primitive: a full 64x64->128 multiply whose halves
+    /// are folded together, diffusing every input bit across the result.
+    inline uint64_t foldedMultiply(uint64_t _a, uint64_t _b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        auto const product = static_cast<unsigned __int128>(_a) * _b;
+        return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        uint64_t hi {};
+        uint64_t const lo = _umul128(_a, _b, &hi);
+        return lo ^ hi;
+#else
+        // Portable 64x64->128 via four 32x32->64 partial products.
+        uint64_t const aLo = _a & 0xFFFFFFFF;
+        uint64_t const aHi = _a >> 32;
+        uint64_t const bLo = _b & 0xFFFFFFFF;
+        uint64_t const bHi = _b >> 32;
+        uint64_t const ll = aLo * bLo;
+        uint64_t const lh = aLo * bHi;
+        uint64_t const hl = aHi * bLo;
+        uint64_t const hh = aHi * bHi;
+        uint64_t const cross = lh + (ll >> 32) + (hl & 0xFFFFFFFF);
+        uint64_t const lo = (cross << 32) | (ll & 0xFFFFFFFF);
+        uint64_t const hi = hh + (hl >> 32) + (cross >> 32);
+        return lo ^ hi;
+#endif
+    }
+} // namespace detail
+
+/// Hashes the given byte range.
+inline uint64_t hash(void const* _data, size_t _size) noexcept
+{
+    auto constexpr Secret0 = uint64_t { 0xa0761d6478bd642f };
+    auto constexpr Secret1 = uint64_t { 0xe7037ed1a0b428db };
+    auto constexpr Secret2 = uint64_t { 0x8ebc6af09c88c6e3 };
+    auto constexpr Secret3 = uint64_t { 0x589965cc75374cc3 };
+
+    auto const* p = static_cast<unsigned char const*>(_data);
+    uint64_t seed = Secret0 ^ _size;
+    uint64_t a {};
+    uint64_t b {};
+
+    if (_size <= 16)
+    {
+        // Short keys read two (overlapping) words covering the whole input.
+        if (_size >= 4)
+        {
+            a = (detail::loadWord32(p) << 32) | detail::loadWord32(p + ((_size >> 3) << 2));
+            b = (detail::loadWord32(p + _size - 4) << 32)
+                | detail::loadWord32(p + _size - 4 - ((_size >> 3) << 2));
+        }
+        else if (_size > 0)
+            a = (uint64_t(p[0]) << 16) | (uint64_t(p[_size >> 1]) << 8) | p[_size - 1];
+    }
+    else
+    {
+        size_t remaining = _size;
+        if (remaining > 48)
+        {
+            // Three independent lanes keep the multiply units busy.
+            uint64_t lane1 = seed;
+            uint64_t lane2 = seed;
+            do
+            {
+                seed = detail::foldedMultiply(detail::loadWord64(p) ^ Secret1,
+                                              detail::loadWord64(p + 8) ^ seed);
+                lane1 = detail::foldedMultiply(detail::loadWord64(p + 16) ^ Secret2,
+                                               detail::loadWord64(p + 24) ^ lane1);
+                lane2 = detail::foldedMultiply(detail::loadWord64(p + 32) ^ Secret3,
+                                               detail::loadWord64(p + 40) ^ lane2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (remaining > 16)
+        {
+            seed = detail::foldedMultiply(detail::loadWord64(p) ^ Secret1,
+                                          detail::loadWord64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = detail::loadWord64(p + remaining - 16);
+        b = detail::loadWord64(p + remaining - 8);
+    }
+
+    return detail::foldedMultiply(Secret1 ^ _size, detail::foldedMultiply(a ^ Secret1, b ^ seed));
+}
+
+template <typename T>
+inline uint64_t hash(std::basic_string_view<T> _text) noexcept
+{
+    return hash(_text.data(), _text.size() * sizeof(T));
+}
+
+template <typename T, typename Alloc>
+inline uint64_t hash(std::basic_string<T, Alloc> const& _text) noexcept
+{
+    return hash(_text.data(), _text.size() * sizeof(T));
+}
+
+/// Combines two hash values (or mixes a value into a seed).
+inline uint64_t hashCombine(uint64_t _seed, uint64_t _value) noexcept
+{
+    return detail::foldedMultiply(_seed ^ 0xe7037ed1a0b428db, _value ^ 0x8ebc6af09c88c6e3);
+}
+
+/// Hasher functor for string-keyed standard containers, heterogeneous over
+/// std::string and std::string_view.
+struct StringHasher
+{
+    using is_transparent = void;
+
+    size_t operator()(std::string_view _text) const noexcept { return size_t(hash(_text)); }
+    size_t operator()(std::string const& _text) const noexcept { return size_t(hash(_text)); }
+};
+
+} // namespace crispy
@@ -0,0 +1,65 @@
+/**
+ * This file is part of the "contour" project.
+ *   Copyright (c) 2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <crispy/hash.h>
+
+#include <catch2/catch.hpp>
+
+#include <set>
+#include <string>
+#include <string_view>
+
+using namespace std::string_view_literals;
+
+TEST_CASE("hash.deterministic", "[hash]")
+{
+    auto const text = std::string { "The quick brown fox jumps over the lazy dog" };
+    CHECK(crispy::hash(text) == crispy::hash(text));
+    CHECK(crispy::hash(text) == crispy::hash(std::string_view(text)));
+}
+
+TEST_CASE("hash.dispersion", "[hash]")
+{
+    // Every prefix length of one payload must hash differently - covering
+    // the empty, short (<= 16), mid (<= 48) and looped (> 48) code paths.
+    auto payload = std::string {};
+    auto seen = std::set<uint64_t> {};
+    for (int i = 0; i <= 100; ++i)
+    {
+        seen.insert(crispy::hash(payload));
+        payload += char('a' + i % 26);
+    }
+    CHECK(seen.size() == 101);
+}
+
+TEST_CASE("hash.single_bit_difference", "[hash]")
+{
+    auto a = std::string(64, 'x');
+    auto b = a;
+    b[32] = 'y';
+    CHECK(crispy::hash(a) != crispy::hash(b));
+}
+
+TEST_CASE("hash.combine", "[hash]")
+{
+    auto const h1 = crispy::hash("foo"sv);
+    auto const h2 = crispy::hash("bar"sv);
+    CHECK(crispy::hashCombine(h1, h2) != crispy::hashCombine(h2, h1));
+    CHECK(crispy::hashCombine(h1, h2) == crispy::hashCombine(h1, h2));
+}
+
+TEST_CASE("hash.string_hasher_transparent", "[hash]")
+{
+    auto const hasher = crispy::StringHasher {};
+    CHECK(hasher(std::string { "hello" }) == hasher("hello"sv));
+}
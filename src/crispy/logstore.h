@@ -20,11 +20,15 @@
 
 #include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <iterator>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
 // NB: Don't do that now. It seems to only cause problems, such as
@@ -77,6 +81,36 @@ using source_location = SourceLocation;
 
 #define LOGSTORE(x) (x(::logstore::source_location::current()))
 
+/// Drop-in replacement for MessageBuilder whose operations compile down to nothing.
+struct NullMessageBuilder
+{
+    NullMessageBuilder& append(std::string_view) noexcept { return *this; }
+
+    template <typename... T>
+    NullMessageBuilder& append(fmt::format_string<T...>, T&&...) noexcept
+    {
+        return *this;
+    }
+
+    NullMessageBuilder& operator()(std::string const&) noexcept { return *this; }
+
+    template <typename... T>
+    NullMessageBuilder& operator()(fmt::format_string<T...>, T&&...) noexcept
+    {
+        return *this;
+    }
+};
+
+/// Like LOGSTORE(), but for debug-tier categories, whose call sites are elided
+/// entirely in release builds: neither the enabled-check nor the format
+/// arguments are evaluated then. Define LOGSTORE_KEEP_DEBUG_LOGS to retain
+/// them in release builds, too.
+#if defined(NDEBUG) && !defined(LOGSTORE_KEEP_DEBUG_LOGS)
+    #define LOGSTORE_DEBUG(x) (::logstore::NullMessageBuilder {})
+#else
+    #define LOGSTORE_DEBUG(x) LOGSTORE(x)
+#endif
+
 class MessageBuilder
 {
   private:
@@ -92,28 +126,35 @@ class MessageBuilder
 
     std::string const& text() const noexcept { return _buffer; }
 
+    // Appending to a disabled category is a no-op, so that call sites never
+    // pay for formatting messages that would be discarded anyways.
+
     MessageBuilder& append(std::string_view msg)
     {
-        _buffer += msg;
+        if (_category.is_enabled())
+            _buffer += msg;
         return *this;
     }
 
     template <typename... T>
     MessageBuilder& append(fmt::format_string<T...> fmt, T&&... args)
     {
-        _buffer += fmt::vformat(fmt, fmt::make_format_args(args...));
+        if (_category.is_enabled())
+            _buffer += fmt::vformat(fmt, fmt::make_format_args(args...));
         return *this;
     }
 
     MessageBuilder& operator()(std::string const& msg)
     {
-        _buffer += msg;
+        if (_category.is_enabled())
+            _buffer += msg;
         return *this;
     }
     template <typename... T>
     MessageBuilder& operator()(fmt::format_string<T...> fmt, T&&... args)
     {
-        _buffer += fmt::vformat(fmt, fmt::make_format_args(args...));
+        if (_category.is_enabled())
+            _buffer += fmt::vformat(fmt, fmt::make_format_args(args...));
         return *this;
     }
 
@@ -229,6 +270,33 @@ class Sink
     Writer writer_;
 };
 
+/// A Sink that hands messages over to a background thread for the actual write.
+///
+/// Messages are still formatted on the calling thread (the format arguments are
+/// transient), but the - potentially blocking - write and flush to the target
+/// writer no longer stalls latency sensitive callers, such as the VT screen
+/// thread. The queue is bounded; when full, the oldest pending message is
+/// dropped in favor of the new one and a drop notice is emitted later, so a
+/// slow log consumer can never exert back-pressure on the terminal.
+class AsyncSink: public Sink
+{
+  public:
+    explicit AsyncSink(Writer _target, std::size_t _capacity = 1024);
+    ~AsyncSink();
+
+  private:
+    void enqueue(std::string _message);
+    void threadMain(Writer const& _target);
+
+    std::deque<std::string> queue_;
+    std::size_t droppedCount_ = 0;
+    bool terminating_ = false;
+    std::mutex queueLock_;
+    std::condition_variable queueCondition_;
+    std::size_t capacity_;
+    std::thread thread_; // must be last, so that all other members are initialized before it starts
+};
+
 std::vector<std::reference_wrapper<Category>>& get();
 Category* get(std::string_view categoryName);
 void set_sink(Sink& _sink);
@@ -319,7 +387,8 @@ inline MessageBuilder::MessageBuilder(logstore::Category const& cat, source_loca
 
 inline MessageBuilder::~MessageBuilder()
 {
-    _category.sink().write(*this);
+    if (_category.is_enabled())
+        _category.sink().write(*this);
 }
 
 inline Category::Category(std::string_view name,
@@ -367,6 +436,58 @@ inline void Sink::set_writer(Writer _writer)
 {
     writer_ = std::move(_writer);
 }
+
+inline AsyncSink::AsyncSink(Writer _target, std::size_t _capacity):
+    Sink(true, [this](std::string_view _text) { enqueue(std::string(_text)); }),
+    capacity_ { _capacity },
+    thread_ { [this, target = std::move(_target)]() { threadMain(target); } }
+{
+}
+
+inline AsyncSink::~AsyncSink()
+{
+    {
+        auto const _ = std::lock_guard { queueLock_ };
+        terminating_ = true;
+    }
+    queueCondition_.notify_one();
+    thread_.join();
+}
+
+inline void AsyncSink::enqueue(std::string _message)
+{
+    {
+        auto const _ = std::lock_guard { queueLock_ };
+        if (queue_.size() >= capacity_)
+        {
+            queue_.pop_front();
+            ++droppedCount_;
+        }
+        queue_.emplace_back(std::move(_message));
+    }
+    queueCondition_.notify_one();
+}
+
+inline void AsyncSink::threadMain(Writer const& _target)
+{
+    for (;;)
+    {
+        auto batch = std::deque<std::string> {};
+        auto droppedCount = std::size_t {};
+        {
+            auto lock = std::unique_lock { queueLock_ };
+            queueCondition_.wait(lock, [this]() { return !queue_.empty() || terminating_; });
+            if (queue_.empty() && terminating_)
+                return;
+            std::swap(batch, queue_);
+            std::swap(droppedCount, droppedCount_);
+        }
+        if (droppedCount)
+            _target(fmt::format("[logstore] dropped {} messages on overflow.\n", droppedCount));
+        for (std::string const& message: batch)
+            _target(message);
+    }
+}
 // }}}
 
 auto inline ErrorLog = logstore::Category("error", "Error Logger", Category::State::Enabled);
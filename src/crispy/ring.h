@@ -20,6 +20,7 @@
 #include <cassert>
 #include <iterator>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace crispy
@@ -55,23 +56,11 @@ class basic_ring
 
     explicit basic_ring(Vector storage): _storage(std::move(storage)) {}
 
-    value_type const& operator[](offset_type i) const noexcept
-    {
-        return _storage[size_t(offset_type(_zero + size()) + i) % size()];
-    }
-    value_type& operator[](offset_type i) noexcept
-    {
-        return _storage[size_t(offset_type(_zero + size()) + i) % size()];
-    }
+    value_type const& operator[](offset_type i) const noexcept { return _storage[storage_index(i)]; }
+    value_type& operator[](offset_type i) noexcept { return _storage[storage_index(i)]; }
 
-    value_type const& at(offset_type i) const noexcept
-    {
-        return _storage[size_t(_zero + size() + i) % size()];
-    }
-    value_type& at(offset_type i) noexcept
-    {
-        return _storage[size_t(offset_type(_zero + size()) + i) % size()];
-    }
+    value_type const& at(offset_type i) const noexcept { return _storage[storage_index(i)]; }
+    value_type& at(offset_type i) noexcept { return _storage[storage_index(i)]; }
 
     Vector& storage() noexcept { return _storage; }
     Vector const& storage() const noexcept { return _storage; }
@@ -144,7 +133,73 @@ class basic_ring
         return gsl::make_span(a, b);
     }
 
+    /// Returns the ring's contents as its (at most two) contiguous storage
+    /// segments, in logical order. Bulk operations (searching, serializing,
+    /// memmove-style scrolling) can run over these raw spans and skip the
+    /// per-element index normalization entirely.
+    ///
+    /// Requires contiguous underlying storage (std::vector, std::array).
+    std::pair<gsl::span<value_type>, gsl::span<value_type>> segments() noexcept
+    {
+        return { gsl::span<value_type>(_storage.data() + _zero, size() - _zero),
+                 gsl::span<value_type>(_storage.data(), _zero) };
+    }
+
+    std::pair<gsl::span<value_type const>, gsl::span<value_type const>> segments() const noexcept
+    {
+        return { gsl::span<value_type const>(_storage.data() + _zero, size() - _zero),
+                 gsl::span<value_type const>(_storage.data(), _zero) };
+    }
+
+    /// Invokes @p fn(value_type* data, size_t count) for the contiguous
+    /// storage runs backing the logical range [start, start + count): one run
+    /// in the common case, two when the range crosses the wrap point. Like
+    /// segments(), but for an arbitrary sub-range, so range-based bulk
+    /// consumers pay the index normalization once instead of per element.
+    ///
+    /// Requires contiguous underlying storage and count <= size().
+    template <typename F>
+    void for_each_segment(offset_type start, std::size_t count, F fn)
+    {
+        assert(count <= size());
+        if (count == 0)
+            return;
+        auto const head = storage_index(start);
+        auto const headCount = std::min(count, size() - head);
+        fn(_storage.data() + head, headCount);
+        if (headCount < count)
+            fn(_storage.data(), count - headCount);
+    }
+
+    template <typename F>
+    void for_each_segment(offset_type start, std::size_t count, F fn) const
+    {
+        const_cast<basic_ring*>(this)->for_each_segment(
+            start, count, [&](value_type* data, std::size_t n) {
+                fn(static_cast<value_type const*>(data), n);
+            });
+    }
+
   protected:
+    /// Normalizes a logical offset into [0, size()).
+    ///
+    /// Offsets are virtually always within one ring-length of the valid
+    /// range, so one or two conditional subtractions replace the integer
+    /// division of the general modulo; grid line access is hot enough for
+    /// that division to show up in profiles. (A power-of-two bitmask would
+    /// not fit here: the capacity equals the user-configured page plus
+    /// scrollback line count, which rounding up would materially inflate.)
+    std::size_t storage_index(offset_type i) const noexcept
+    {
+        auto const n = static_cast<offset_type>(size());
+        auto const k = static_cast<offset_type>(_zero) + n + i;
+        if (0 <= k && k < n)
+            return static_cast<std::size_t>(k);
+        if (n <= k && k < 2 * n)
+            return static_cast<std::size_t>(k - n);
+        return std::size_t(k) % size();
+    }
+
     Vector _storage;
     std::size_t _zero = 0;
 };
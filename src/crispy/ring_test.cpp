@@ -18,6 +18,7 @@
 #include <catch2/catch.hpp>
 
 #include <array>
+#include <string>
 
 using crispy::fixed_size_ring;
 using crispy::ring;
@@ -160,6 +161,62 @@ TEST_CASE("ring.fixed_size")
     REQUIRE(r[5] == 'f');
 }
 
+TEST_CASE("ring.segments.unrotated")
+{
+    ring<char> r(4, {});
+    generate_n(r.begin(), r.size(), [c = 'a']() mutable { return c++; });
+
+    auto const [first, second] = r.segments();
+    REQUIRE(first.size() == 4);
+    REQUIRE(second.empty());
+    REQUIRE(first[0] == 'a');
+    REQUIRE(first[3] == 'd');
+}
+
+TEST_CASE("ring.segments.rotated")
+{
+    ring<char> r(4, {});
+    generate_n(r.begin(), r.size(), [c = 'a']() mutable { return c++; });
+    r.rotate_left(1);
+
+    auto const [first, second] = r.segments();
+    REQUIRE(first.size() == 3);
+    REQUIRE(second.size() == 1);
+    REQUIRE(first[0] == 'b');
+    REQUIRE(first[2] == 'd');
+    REQUIRE(second[0] == 'a');
+}
+
+TEST_CASE("ring.for_each_segment")
+{
+    ring<char> r(4, {});
+    generate_n(r.begin(), r.size(), [c = 'a']() mutable { return c++; });
+    r.rotate_left(1);
+    // logical order is now: b c d a
+
+    auto collected = std::string {};
+    auto segmentCount = 0;
+    r.for_each_segment(1, 3, [&](char const* data, size_t n) {
+        collected.append(data, n);
+        ++segmentCount;
+    });
+    REQUIRE(collected == "cda");
+    REQUIRE(segmentCount == 2);
+
+    // A range not crossing the wrap point yields a single segment.
+    collected.clear();
+    segmentCount = 0;
+    r.for_each_segment(0, 3, [&](char const* data, size_t n) {
+        collected.append(data, n);
+        ++segmentCount;
+    });
+    REQUIRE(collected == "bcd");
+    REQUIRE(segmentCount == 1);
+
+    // Empty ranges invoke nothing.
+    r.for_each_segment(2, 0, [&](char const*, size_t) { REQUIRE(false); });
+}
+
 TEST_CASE("ring.offset_negative")
 {
     ring<char> r;
@@ -14,14 +14,14 @@
 #include <terminal/Capabilities.h>
 
 #include <crispy/escape.h>
+#include <crispy/hash.h>
 
 #include <range/v3/action/sort.hpp>
 #include <range/v3/action/transform.hpp>
 #include <range/v3/algorithm/copy.hpp>
-#include <range/v3/view/concat.hpp>
-#include <range/v3/view/transform.hpp>
 
 #include <sstream>
+#include <unordered_map>
 
 using std::nullopt;
 using std::optional;
@@ -449,68 +449,110 @@ namespace
         String { Undefined, "RGB"sv, "8/8/8"sv }); // }}}
 } // namespace
 
+namespace
+{
+    // The capability set is fixed at compile time, so the per-query linear
+    // scans are replaced by hash tables built exactly once: one keyed by the
+    // two-byte termcap code and one keyed by name (which also answers
+    // two-letter termcap codes given as strings).
+    template <typename T, std::size_t N>
+    auto byCode(std::array<Cap<T>, N> const& _caps)
+    {
+        auto map = std::unordered_map<uint16_t, T> {};
+        map.reserve(N);
+        for (auto const& cap: _caps)
+            if (cap.code.code)
+                map.emplace(cap.code.code, cap.value);
+        return map;
+    }
+
+    template <typename T, std::size_t N>
+    auto byName(std::array<Cap<T>, N> const& _caps)
+    {
+        auto map = std::unordered_map<string_view, T, crispy::StringHasher> {};
+        map.reserve(2 * N);
+        for (auto const& cap: _caps)
+            if (!cap.name.empty())
+                map.emplace(cap.name, cap.value);
+        return map;
+    }
+} // namespace
+
 bool StaticDatabase::booleanCapability(Code _cap) const
 {
-    for (auto const& cap: booleanCaps)
-        if (cap.code.code == _cap.code)
-            return cap.value;
+    static auto const codes = byCode(booleanCaps);
+    if (auto const i = codes.find(_cap.code); i != codes.end())
+        return i->second;
 
     return false;
 }
 
 unsigned StaticDatabase::numericCapability(Code _cap) const
 {
-    for (auto const& cap: numericalCaps)
-        if (cap.code.code == _cap.code)
-            return cap.value;
+    static auto const codes = byCode(numericalCaps);
+    if (auto const i = codes.find(_cap.code); i != codes.end())
+        return i->second;
 
     return npos;
 }
 
 string_view StaticDatabase::stringCapability(Code _cap) const
 {
-    for (auto const& cap: stringCaps)
-        if (cap.code.code == _cap.code)
-            return cap.value;
+    static auto const codes = byCode(stringCaps);
+    if (auto const i = codes.find(_cap.code); i != codes.end())
+        return i->second;
 
     return {};
 }
 
 bool StaticDatabase::booleanCapability(string_view _cap) const
 {
-    for (auto const tcap: booleanCaps)
-        if (tcap.name == _cap || tcap.code == _cap)
-            return tcap.value;
+    static auto const names = byName(booleanCaps);
+    if (auto const i = names.find(_cap); i != names.end())
+        return i->second;
+    if (_cap.size() == 2)
+        return booleanCapability(Code(_cap));
 
     return false;
 }
 
 unsigned StaticDatabase::numericCapability(string_view _cap) const
 {
-    for (auto const tcap: numericalCaps)
-        if (tcap.name == _cap || tcap.code == _cap)
-            return tcap.value;
+    static auto const names = byName(numericalCaps);
+    if (auto const i = names.find(_cap); i != names.end())
+        return i->second;
+    if (_cap.size() == 2)
+        return numericCapability(Code(_cap));
 
     return npos;
 }
 
 string_view StaticDatabase::stringCapability(string_view _cap) const
 {
-    for (auto const tcap: stringCaps)
-        if (tcap.name == _cap || tcap.code == _cap)
-            return tcap.value;
+    static auto const names = byName(stringCaps);
+    if (auto const i = names.find(_cap); i != names.end())
+        return i->second;
+    if (_cap.size() == 2)
+        return stringCapability(Code(_cap));
 
     return {};
 }
 
 optional<Code> StaticDatabase::codeFromName(string_view _name) const
 {
-    using ranges::views::concat;
-    using ranges::views::transform;
-    auto const tr = transform([](auto cap) { return std::pair { cap.name, cap.code }; });
-    for (auto const cap: concat(numericalCaps | tr, booleanCaps | tr, stringCaps | tr))
-        if (cap.first == _name)
-            return cap.second;
+    static auto const names = []() {
+        auto map = std::unordered_map<string_view, Code, crispy::StringHasher> {};
+        for (auto const& cap: numericalCaps)
+            map.emplace(cap.name, cap.code);
+        for (auto const& cap: booleanCaps)
+            map.emplace(cap.name, cap.code);
+        for (auto const& cap: stringCaps)
+            map.emplace(cap.name, cap.code);
+        return map;
+    }();
+
+    if (auto const i = names.find(_name); i != names.end())
+        return i->second;
 
     return nullopt;
 }
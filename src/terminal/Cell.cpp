@@ -35,11 +35,12 @@ std::u32string Cell::codepoints() const
 
 std::string Cell::toUtf8() const
 {
-    if (!codepoint_)
+    auto const base = codepoint(0);
+    if (!base)
         return {};
 
     std::string text;
-    text += unicode::convert_to<char>(codepoint_);
+    text += unicode::convert_to<char>(base);
     if (extra_)
         for (char32_t const cp: extra_->codepoints)
             text += unicode::convert_to<char>(cp);
@@ -18,6 +18,7 @@
 #include <terminal/GraphicsAttributes.h>
 #include <terminal/Hyperlink.h>
 #include <terminal/Image.h>
+#include <terminal/UnicodeCache.h>
 #include <terminal/defines.h>
 #include <terminal/primitives.h>
 
@@ -71,7 +72,7 @@ struct CONTOUR_PACKED Owned
     Owned(Owned&& v) noexcept: ptr_ { v.release() } {}
     Owned& operator=(Owned&& v) noexcept
     {
-        ptr_ = v.release();
+        reset(v.release());
         return *this;
     }
 
@@ -89,7 +90,6 @@ struct CellExtra
     HyperlinkId hyperlink = {};
     std::shared_ptr<ImageFragment> imageFragment = nullptr;
     CellFlags flags = CellFlags::None;
-    uint8_t width = 1;
 };
 
 /// Grid cell with character and graphics rendition information.
@@ -160,8 +160,13 @@ class CONTOUR_PACKED Cell
     CellExtra& extra() noexcept;
 
   private:
+    /// Unicode codepoints only occupy the lower 21 bits, so the cell width (minus one)
+    /// is stored in the bits right above, keeping width() free of any extra_ access.
+    static char32_t constexpr CodepointMask = 0x001FFFFF;
+    static unsigned constexpr WidthShift = 21;
+
     // Cell data
-    char32_t codepoint_ = 0; /// Primary Unicode codepoint to be displayed.
+    char32_t codepoint_ = 0; /// Primary Unicode codepoint to be displayed (plus width bits).
     Color foregroundColor_ = DefaultColor();
     Color backgroundColor_ = DefaultColor();
     Owned<CellExtra> extra_ = {};
@@ -222,9 +227,7 @@ inline void Cell::reset(GraphicsAttributes const& _attributes) noexcept
 
 inline void Cell::write(GraphicsAttributes const& _attributes, char32_t _ch, uint8_t _width) noexcept
 {
-    setWidth(_width);
-
-    codepoint_ = _ch;
+    codepoint_ = (_ch & CodepointMask) | (static_cast<char32_t>(_width - 1) << WidthShift);
     if (extra_)
     {
         extra_->codepoints.clear();
@@ -246,9 +249,7 @@ inline void Cell::write(GraphicsAttributes const& _attributes,
                         uint8_t _width,
                         HyperlinkId _hyperlink) noexcept
 {
-    setWidth(_width);
-
-    codepoint_ = _ch;
+    codepoint_ = (_ch & CodepointMask) | (static_cast<char32_t>(_width - 1) << WidthShift);
     if (extra_)
     {
         extra_->codepoints.clear();
@@ -286,52 +287,45 @@ inline void Cell::reset(GraphicsAttributes const& _attributes, HyperlinkId _hype
 // {{{ impl: character
 inline constexpr uint8_t Cell::width() const noexcept
 {
-    return !extra_ ? 1 : extra_->width;
-    // return static_cast<int>((codepoint_ >> 21) & 0x03); //return width_;
+    return static_cast<uint8_t>(((codepoint_ >> WidthShift) & 0x03) + 1);
 }
 
 inline void Cell::setWidth(uint8_t _width) noexcept
 {
-    assert(_width < MaxCodepoints);
-    // codepoint_ = codepoint_ | ((_width << 21) & 0x03);
-    if (_width > 1 || extra_)
-        extra().width = _width;
-    // TODO(perf) use u32_unused_bit_mask()
+    assert(_width >= 1 && _width < MaxCodepoints);
+    codepoint_ = (codepoint_ & CodepointMask) | (static_cast<char32_t>(_width - 1) << WidthShift);
 }
 
 inline void Cell::setCharacter(char32_t _codepoint, uint8_t _width) noexcept
 {
     assert(_codepoint != 0);
 
-    codepoint_ = _codepoint;
+    codepoint_ = (_codepoint & CodepointMask) | (static_cast<char32_t>(_width - 1) << WidthShift);
 
     if (extra_)
     {
         extra_->codepoints.clear();
         extra_->imageFragment = {};
-        extra_->width = _width;
     }
-    else
-        setWidth(_width);
 }
 
 inline void Cell::setCharacter(char32_t _codepoint) noexcept
 {
-    codepoint_ = _codepoint;
+    codepoint_ = _codepoint & CodepointMask;
     if (extra_)
     {
         extra_->codepoints.clear();
         extra_->imageFragment = {};
     }
     if (_codepoint)
-        setWidth(static_cast<uint8_t>(std::max(unicode::width(_codepoint), 1)));
+        setWidth(std::max(codepointWidth(_codepoint), uint8_t { 1 }));
     else
         setWidth(1);
 }
 
 inline int Cell::appendCharacter(char32_t _codepoint) noexcept
 {
-    assert(codepoint_ != 0);
+    assert((codepoint_ & CodepointMask) != 0);
 
     CellExtra& ext = extra();
     if (ext.codepoints.size() < MaxCodepoints - 1)
@@ -345,7 +339,7 @@ inline int Cell::appendCharacter(char32_t _codepoint) noexcept
             {
             case 0xFE0E: return 1;
             case 0xFE0F: return 2;
-            default: return unicode::width(_codepoint);
+            default: return static_cast<int>(codepointWidth(_codepoint));
             }
         }();
 
@@ -361,7 +355,7 @@ inline int Cell::appendCharacter(char32_t _codepoint) noexcept
 
 inline std::size_t Cell::codepointCount() const noexcept
 {
-    if (codepoint_)
+    if (codepoint_ & CodepointMask)
     {
         if (!extra_)
             return 1;
@@ -374,7 +368,7 @@ inline std::size_t Cell::codepointCount() const noexcept
 inline char32_t Cell::codepoint(size_t i) const noexcept
 {
     if (i == 0)
-        return codepoint_;
+        return codepoint_ & CodepointMask;
 
     if (!extra_)
         return 0;
@@ -23,6 +23,12 @@
 namespace terminal
 {
 
+/// Cell styling flags.
+///
+/// The bit positions are part of the renderer contract (and of serialized
+/// snapshots, see StateSerializer): Bold (bit 0) and Italic (bit 2) shift
+/// branchlessly into a TextStyle's low two bits, see
+/// renderer::makeTextStyle().
 enum class CellFlags : uint16_t
 {
     None = 0,
@@ -44,6 +50,12 @@ enum class CellFlags : uint16_t
     Overline = (1 << 14),
 };
 
+/// Returns the raw bit representation.
+constexpr uint16_t underlying(CellFlags _flags) noexcept
+{
+    return static_cast<uint16_t>(_flags);
+}
+
 constexpr CellFlags& operator|=(CellFlags& a, CellFlags b) noexcept
 {
     a = static_cast<CellFlags>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
@@ -85,6 +97,20 @@ constexpr bool operator!(CellFlags a) noexcept
     return static_cast<unsigned>(a) == 0;
 }
 
+/// Flags that select the font face a cell's text is shaped with.
+constexpr inline CellFlags TextStyleFlagsMask = CellFlags::Bold | CellFlags::Italic;
+
+/// Flags rendered as decorations on top of (or around) the cell's text:
+/// underlines, overline, strike-through and frames. The remaining bits
+/// affect font face, colors or visibility and never reach the decoration
+/// stage, so `flags & DecorationFlagsMask` classifies a cell as
+/// decorated/undecorated in a single mask test.
+constexpr inline CellFlags DecorationFlagsMask = CellFlags::Underline | CellFlags::DoublyUnderlined
+                                                 | CellFlags::CurlyUnderlined | CellFlags::DottedUnderline
+                                                 | CellFlags::DashedUnderline | CellFlags::Overline
+                                                 | CellFlags::CrossedOut | CellFlags::Framed
+                                                 | CellFlags::Encircled;
+
 } // namespace terminal
 
 namespace fmt // {{{
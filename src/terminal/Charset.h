@@ -62,17 +62,24 @@ class CharsetMapping
             charsetMap(CharsetId::USASCII),
             charsetMap(CharsetId::USASCII),
             charsetMap(CharsetId::USASCII),
-        }
+        },
+        activeTable_ { *tables_[0] }
     {
     }
 
     char32_t map(char32_t _code) noexcept
     {
-        // TODO: could surely be implemented branchless with a jump-table and computed goto.
+        // The active table is kept flattened into this object (recomputed only
+        // on designation and shift changes), so the per-character hot path
+        // below is a single indexed load.
         if (_code < 127)
         {
-            auto result = map(shift_, static_cast<char>(_code));
-            shift_ = selected_;
+            auto const result = activeTable_[static_cast<uint8_t>(_code)];
+            if (shift_ != selected_) // revert a single shift (SS2/SS3)
+            {
+                shift_ = selected_;
+                updateActiveTable();
+            }
             return result;
         }
         else if (_code != 127)
@@ -90,27 +97,48 @@ class CharsetMapping
         return (*tables_[static_cast<size_t>(_table)])[static_cast<uint8_t>(_code)];
     }
 
-    constexpr void singleShift(CharsetTable _table) noexcept { shift_ = _table; }
+    void singleShift(CharsetTable _table) noexcept
+    {
+        shift_ = _table;
+        updateActiveTable();
+    }
 
-    constexpr void selectDefaultTable(CharsetTable _table) noexcept
+    void selectDefaultTable(CharsetTable _table) noexcept
     {
         selected_ = _table;
         shift_ = _table;
+        updateActiveTable();
     }
 
     void select(CharsetTable _table, CharsetId _id) noexcept
     {
         tables_[static_cast<size_t>(_table)] = charsetMap(_id);
+        updateActiveTable();
     }
 
     constexpr CharsetTable currentTable() const noexcept { return shift_; }
 
+    /// Returns true iff a US-ASCII run would be mapped onto itself,
+    /// i.e. both the current shift and the selected default table are US-ASCII.
+    bool isUsAsciiSelected() const noexcept
+    {
+        auto const* usAscii = charsetMap(CharsetId::USASCII);
+        return tables_[static_cast<size_t>(shift_)] == usAscii
+               && tables_[static_cast<size_t>(selected_)] == usAscii;
+    }
+
   private:
+    void updateActiveTable() noexcept { activeTable_ = *tables_[static_cast<size_t>(shift_)]; }
+
     CharsetTable shift_ = CharsetTable::G0;
     CharsetTable selected_ = CharsetTable::G0;
 
     using Tables = std::array<CharsetMap const*, 4>;
     Tables tables_;
+
+    // Flat copy of the currently shifted-in table, so mapping needs neither
+    // the table pointer indirection nor a branch on the shift state.
+    CharsetMap activeTable_;
 };
 
 } // namespace terminal
@@ -64,14 +64,8 @@ RGBColor apply(ColorPalette const& _profile, Color _color, ColorTarget _target,
     switch (_color.type())
     {
     case ColorType::RGB: return _color.rgb();
-    case ColorType::Indexed: {
-        auto const index = static_cast<size_t>(_color.index());
-        if (_bright && index < 8)
-            return _profile.brightColor(index);
-        else
-            return _profile.indexedColor(index);
-        break;
-    }
+    case ColorType::Indexed:
+        return _profile.indexedColor(static_cast<size_t>(_color.index()), _bright);
     case ColorType::Bright: return _profile.brightColor(static_cast<size_t>(_color.index()));
     case ColorType::Undefined:
     case ColorType::Default: break;
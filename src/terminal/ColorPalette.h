@@ -108,6 +108,26 @@ struct ColorPalette
     }
     ();
 
+    // Flattened lookup table for resolving indexed colors on the render
+    // path: row 0 serves regular cells, row 1 serves bold cells with the
+    // first 8 entries replaced by their bright variants. This turns the
+    // per-cell resolution into a single indexed load instead of branching.
+    using RenderColorLUT = std::array<Palette, 2>;
+
+    RenderColorLUT renderColors = buildRenderColors(palette);
+
+    static RenderColorLUT buildRenderColors(Palette const& _palette) noexcept
+    {
+        auto lut = RenderColorLUT { _palette, _palette };
+        for (size_t i = 0; i < 8; ++i)
+            lut[1][i] = _palette[i + 8];
+        return lut;
+    }
+
+    /// Rebuilds the flattened render color lookup table.
+    /// Must be called after mutating palette entries in place.
+    void updateRenderColors() noexcept { renderColors = buildRenderColors(palette); }
+
     RGBColor normalColor(size_t _index) const noexcept
     {
         assert(_index < 8);
@@ -132,6 +152,14 @@ struct ColorPalette
         return palette.at(_index);
     }
 
+    /// Resolves an indexed color for a regular or bold (bright) cell
+    /// via the precomputed lookup table.
+    RGBColor indexedColor(size_t _index, bool _bright) const noexcept
+    {
+        assert(_index < 256);
+        return renderColors[_bright][_index];
+    }
+
     RGBColor defaultForeground = 0xD0D0D0;
     RGBColor defaultBackground = 0x000000;
     std::optional<RGBColor> selectionForeground = std::nullopt;
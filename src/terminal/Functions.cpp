@@ -28,6 +28,7 @@
 #include <numeric>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 using crispy::for_each;
 using crispy::times;
@@ -44,31 +45,126 @@ using std::stringstream;
 namespace terminal
 {
 
+namespace
+{
+    // {{{ direct-mapped function dispatch table
+    //
+    // Sequence dispatch is on the hot path (SGR/CUP-dense streams resolve
+    // millions of functions per second), so instead of binary-searching the
+    // sorted functions() array, selection is a single indexed load keyed by
+    // the syntactic fields (category, leader, intermediate, final symbol).
+    // Functions that only differ in their parameter-count range (e.g. SCOSC
+    // vs. DECSLRM) share a key; they are adjacent in the sorted array, so the
+    // table stores the first candidate and matching probes at most the few
+    // same-keyed successors. OSC functions are keyed by their numeric code in
+    // a separate table.
+
+    constexpr size_t MaxCategories = 5;   // C0, ESC, CSI, OSC, DCS
+    constexpr size_t MaxLeaders = 5;      // none or 0x3C..0x3F
+    constexpr size_t MaxIntermediates = 17; // none or 0x20..0x2F
+    constexpr size_t MaxFinals = 128;     // 7-bit final symbol (C0 curtails this further)
+    constexpr size_t MaxOscCodes = 1024;
+
+    constexpr uint8_t NoFunction = 0xFF;
+
+    constexpr size_t leaderIndex(char _leader) noexcept
+    {
+        return _leader ? static_cast<size_t>(_leader) - 0x3C + 1 : 0;
+    }
+
+    constexpr size_t intermediateIndex(char _intermediate) noexcept
+    {
+        return _intermediate ? static_cast<size_t>(_intermediate) - 0x20 + 1 : 0;
+    }
+
+    constexpr bool keyable(FunctionCategory _category,
+                           char _leader,
+                           char _intermediate,
+                           char _final) noexcept
+    {
+        return static_cast<size_t>(_category) < MaxCategories
+               && (_leader == 0 || (0x3C <= _leader && _leader <= 0x3F))
+               && (_intermediate == 0 || (0x20 <= _intermediate && _intermediate <= 0x2F))
+               && static_cast<unsigned char>(_final) < MaxFinals;
+    }
+
+    constexpr size_t slotOf(FunctionCategory _category,
+                            char _leader,
+                            char _intermediate,
+                            char _final) noexcept
+    {
+        return ((static_cast<size_t>(_category) * MaxLeaders + leaderIndex(_leader)) * MaxIntermediates
+                + intermediateIndex(_intermediate))
+                   * MaxFinals
+               + static_cast<unsigned char>(_final);
+    }
+
+    struct DispatchTable
+    {
+        std::array<uint8_t, MaxCategories * MaxLeaders * MaxIntermediates * MaxFinals> slots;
+        std::array<uint8_t, MaxOscCodes> oscSlots;
+    };
+
+    DispatchTable const& dispatchTable() noexcept
+    {
+        static auto const table = []() {
+            auto t = DispatchTable {};
+            t.slots.fill(NoFunction);
+            t.oscSlots.fill(NoFunction);
+            auto const& funcs = functions();
+            static_assert(std::tuple_size<std::decay_t<decltype(functions())>>::value < NoFunction);
+            for (auto i = size_t { 0 }; i < funcs.size(); ++i)
+            {
+                FunctionDefinition const& f = funcs[i];
+                if (f.category == FunctionCategory::OSC)
+                    t.oscSlots[f.maximumParameters] = static_cast<uint8_t>(i);
+                else
+                {
+                    // The array is sorted by (category, final, leader,
+                    // intermediate, parameter range), so the first function of
+                    // a shared key wins and its same-keyed successors follow.
+                    auto& slot = t.slots[slotOf(f.category, f.leader, f.intermediate, f.finalSymbol)];
+                    if (slot == NoFunction)
+                        slot = static_cast<uint8_t>(i);
+                }
+            }
+            return t;
+        }();
+        return table;
+    }
+    // }}}
+} // namespace
+
 FunctionDefinition const* select(FunctionSelector const& _selector) noexcept
 {
     auto static const& funcs = functions();
+    auto static const& table = dispatchTable();
+
+    if (_selector.category == FunctionCategory::OSC)
+    {
+        if (!(0 <= _selector.argc && _selector.argc < static_cast<int>(MaxOscCodes)))
+            return nullptr;
+        auto const slot = table.oscSlots[static_cast<size_t>(_selector.argc)];
+        return slot != NoFunction ? &funcs[slot] : nullptr;
+    }
+
+    if (!keyable(_selector.category, _selector.leader, _selector.intermediate, _selector.finalSymbol))
+        return nullptr;
 
-    // std::cout << fmt::format("select: {}\n", _selector);
+    auto i = table.slots[slotOf(
+        _selector.category, _selector.leader, _selector.intermediate, _selector.finalSymbol)];
+    if (i == NoFunction)
+        return nullptr;
 
-    auto a = size_t { 0 };
-    auto b = funcs.size() - 1;
-    while (a <= b)
+    // Probe the (rare) same-keyed successors for the matching parameter range.
+    for (; i < funcs.size(); ++i)
     {
-        auto const i = (a + b) / 2;
-        auto const& I = funcs[i];
-        auto const rel = compare(_selector, I);
-        // std::cout << fmt::format(" - a:{:>2} b:{:>2} i:{} rel:{} I: {}\n", a, b, i, rel < 0 ? '<' : rel > 0
-        // ? '>' : '=', I);
-        if (rel > 0)
-            a = i + 1;
-        else if (rel < 0)
-        {
-            if (i == 0)
-                return nullptr;
-            b = i - 1;
-        }
-        else
-            return &I;
+        FunctionDefinition const& f = funcs[i];
+        if (f.category != _selector.category || f.finalSymbol != _selector.finalSymbol
+            || f.leader != _selector.leader || f.intermediate != _selector.intermediate)
+            break;
+        if (f.minimumParameters <= _selector.argc && _selector.argc <= f.maximumParameters)
+            return &f;
     }
     return nullptr;
 }
@@ -330,6 +330,10 @@ constexpr inline auto HPR         = detail::CSI(std::nullopt, 1, 1, std::nullopt
 constexpr inline auto HVP         = detail::CSI(std::nullopt, 0, 2, std::nullopt, 'f', VTType::VT100, "HVP", "Horizontal and vertical position");
 constexpr inline auto ICH         = detail::CSI(std::nullopt, 0, 1, std::nullopt, '@', VTType::VT420, "ICH", "Insert character");
 constexpr inline auto IL          = detail::CSI(std::nullopt, 0, 1, std::nullopt, 'L', VTType::VT100, "IL",  "Insert lines");
+constexpr inline auto KBDPOP      = detail::CSI('<', 0, 1, std::nullopt, 'u', VTType::VT525 /*Extension*/, "KBDPOP", "Pop keyboard enhancement flags (kitty keyboard protocol).");
+constexpr inline auto KBDPUSH     = detail::CSI('>', 0, 1, std::nullopt, 'u', VTType::VT525 /*Extension*/, "KBDPUSH", "Push keyboard enhancement flags (kitty keyboard protocol).");
+constexpr inline auto KBDQUERY    = detail::CSI('?', 0, 0, std::nullopt, 'u', VTType::VT525 /*Extension*/, "KBDQUERY", "Query keyboard enhancement flags (kitty keyboard protocol).");
+constexpr inline auto KBDSET      = detail::CSI('=', 0, 2, std::nullopt, 'u', VTType::VT525 /*Extension*/, "KBDSET", "Set keyboard enhancement flags (kitty keyboard protocol).");
 constexpr inline auto REP         = detail::CSI(std::nullopt, 1, 1, std::nullopt, 'b', VTType::VT100, "REP", "Repeat the preceding graphic character Ps times");
 constexpr inline auto RM          = detail::CSI(std::nullopt, 1, ArgsMax, std::nullopt, 'l', VTType::VT100, "RM",  "Reset mode");
 constexpr inline auto SCOSC       = detail::CSI(std::nullopt, 0, 0, std::nullopt, 's', VTType::VT100, "SCOSC", "Save Cursor");
@@ -471,6 +475,10 @@ inline auto const& functions() noexcept
             HVP,
             ICH,
             IL,
+            KBDPOP,
+            KBDPUSH,
+            KBDQUERY,
+            KBDSET,
             REP,
             RM,
             SCOSC,
@@ -131,6 +131,9 @@ Grid<Cell>::Grid(PageSize _pageSize, bool _reflowOnResize, LineCount _maxHistory
 template <typename Cell>
 void Grid<Cell>::setMaxHistoryLineCount(LineCount _maxHistoryLineCount)
 {
+    if (maxHistoryLineCount_ == _maxHistoryLineCount)
+        return;
+
     verifyState();
     rezeroBuffers();
     lines_.resize(unbox<size_t>(pageSize_.lines + _maxHistoryLineCount));
@@ -161,23 +164,49 @@ std::string Grid<Cell>::renderAllText() const
     std::string text;
     text.reserve(unbox<size_t>(historyLineCount() + pageSize_.lines) * unbox<size_t>(pageSize_.columns + 1));
 
+    // One buffer reused across all lines; trivial lines bypass it entirely.
+    std::string buffer;
     for (auto y = LineOffset(0); y < LineOffset::cast_from(lines_.size()); ++y)
     {
-        text += lineText(y);
+        auto const& line = lineAt(y);
+        auto const chars = lineText(line, buffer);
+        text += chars;
+        if (line.isTrivialBuffer() && chars.size() < unbox<size_t>(line.size()))
+            text.append(unbox<size_t>(line.size()) - chars.size(), ' ');
         text += '\n';
     }
 
     return text;
 }
 
+template <typename Cell>
+void Grid<Cell>::collectLineDigests(LineOffset _first,
+                                    LineCount _count,
+                                    std::vector<LineDigest>& _output) const
+{
+    _output.clear();
+    _output.reserve(unbox<size_t>(_count));
+
+    auto const first = std::max(_first, -boxed_cast<LineOffset>(historyLineCount()));
+    auto const last = std::min(_first + boxed_cast<LineOffset>(_count) - 1,
+                               boxed_cast<LineOffset>(pageSize_.lines) - 1);
+    for (auto y = first; y <= last; ++y)
+        _output.emplace_back(lineAt(y).digest());
+}
+
 template <typename Cell>
 std::string Grid<Cell>::renderMainPageText() const
 {
     std::string text;
 
-    for (auto line = LineOffset(0); line < unbox<LineOffset>(pageSize_.lines); ++line)
+    std::string buffer;
+    for (auto lineOffset = LineOffset(0); lineOffset < unbox<LineOffset>(pageSize_.lines); ++lineOffset)
     {
-        text += lineText(line);
+        auto const& line = lineAt(lineOffset);
+        auto const chars = lineText(line, buffer);
+        text += chars;
+        if (line.isTrivialBuffer() && chars.size() < unbox<size_t>(line.size()))
+            text.append(unbox<size_t>(line.size()) - chars.size(), ' ');
         text += '\n';
     }
 
@@ -261,22 +290,16 @@ gsl::span<Cell const> Grid<Cell>::lineBufferRightTrimmed(LineOffset _line) const
 template <typename Cell>
 std::string Grid<Cell>::lineText(LineOffset _line) const
 {
-    std::string line;
-    line.reserve(unbox<size_t>(pageSize_.columns));
-
-    for (Cell const& cell: lineBuffer(_line))
-        if (cell.codepointCount())
-            line += cell.toUtf8();
-        else
-            line += ' '; // fill character
-
-    return line;
+    return lineText(lineAt(_line));
 }
 
 template <typename Cell>
 std::string Grid<Cell>::lineTextTrimmed(LineOffset _line) const
 {
-    std::string output = lineText(_line);
+    // The view drops only trailing blanks of trivial lines, which the trim
+    // would strip anyway.
+    std::string buffer;
+    std::string output { lineText(lineAt(_line), buffer) };
     while (!output.empty() && isspace(output.back()))
         output.pop_back();
     return output;
@@ -285,15 +308,40 @@ std::string Grid<Cell>::lineTextTrimmed(LineOffset _line) const
 template <typename Cell>
 std::string Grid<Cell>::lineText(Line<Cell> const& _line) const
 {
-    std::stringstream sstr;
+    std::string buffer;
+    std::string text { lineText(_line, buffer) };
+    // Blank columns past a trivial line's stored text still occupy display
+    // width and render as fill characters, matching the inflated code path.
+    if (_line.isTrivialBuffer() && text.size() < unbox<size_t>(_line.size()))
+        text.append(unbox<size_t>(_line.size()) - text.size(), ' ');
+    return text;
+}
+
+template <typename Cell>
+std::string_view Grid<Cell>::lineText(LineOffset _line, std::string& _buffer) const
+{
+    return lineText(lineAt(_line), _buffer);
+}
+
+template <typename Cell>
+std::string_view Grid<Cell>::lineText(Line<Cell> const& _line, std::string& _buffer) const
+{
+    // A trivial line's US-ASCII text doubles as its UTF-8 rendering, so hand
+    // out a view of the line's own storage - notably without inflating the
+    // line as any access through cells() would.
+    if (_line.isTrivialBuffer())
+        return _line.trivialBuffer().text;
+
+    _buffer.clear();
+    _buffer.reserve(unbox<size_t>(pageSize_.columns));
+
     for (Cell const& cell: lineBuffer(_line))
-    {
-        if (cell.codepointCount() == 0)
-            sstr << ' ';
+        if (cell.codepointCount())
+            _buffer += cell.toUtf8();
         else
-            sstr << cell.toUtf8();
-    }
-    return sstr.str();
+            _buffer += ' '; // fill character
+
+    return _buffer;
 }
 
 template <typename Cell>
@@ -348,20 +396,69 @@ int Grid<Cell>::computeLogicalLineNumberFromBottom(LineCount _n) const noexcept
 }
 // }}}
 // {{{ Grid impl: scrolling
+template <typename Cell>
+void Grid<Cell>::compressNewHistoryLines(LineCount _n)
+{
+    // Lines leaving the active page are rarely accessed again. Demote them to
+    // their compact storage form so that a deep scrollback does not keep
+    // megabytes of inflated Cell vectors alive. Accessing such a line later
+    // (scrollback rendering, search, ...) transparently inflates it again.
+    if (!historyCompressionEnabled_)
+        return;
+
+    auto const n = std::min(_n, historyLineCount());
+    for (auto y = LineOffset(-1); y >= -boxed_cast<LineOffset>(n); --y)
+    {
+        if (pinnedLineRange_ && pinnedLineRange_->first <= y && y <= pinnedLineRange_->second)
+            continue;
+        lineAt(y).compress(bufferPool_);
+    }
+}
+
+template <typename Cell>
+void Grid<Cell>::materializeLineRange(LineOffset _top, LineOffset _bottom)
+{
+    auto const top = std::max(_top, -boxed_cast<LineOffset>(historyLineCount()));
+    auto const bottom = std::min(_bottom, boxed_cast<LineOffset>(pageSize_.lines) - 1);
+    for (auto y = top; y <= bottom; ++y)
+    {
+        auto& line = lineAt(y);
+        if (line.isTrivialBuffer())
+            line.inflatedBuffer(); // inflates in place; content (and generation) unchanged
+    }
+}
+
+template <typename Cell>
+void Grid<Cell>::pinLineRange(LineOffset _top, LineOffset _bottom) noexcept
+{
+    pinnedLineRange_ = std::pair { _top, _bottom };
+}
+
+template <typename Cell>
+void Grid<Cell>::unpinLineRange() noexcept
+{
+    pinnedLineRange_ = std::nullopt;
+}
+
 template <typename Cell>
 LineCount Grid<Cell>::scrollUp(LineCount _n, GraphicsAttributes _defaultAttributes) noexcept
 {
     verifyState();
+
+    // The page gains _n fresh lines at the bottom either way, so the absolute
+    // number of the line at the top of the page advances by exactly _n.
+    absoluteTopLine_ += unbox<uint64_t>(_n);
     if (linesUsed_ == totalLineCount()) // with all grid lines in-use
     {
         // TODO: ensure explicit test for this case
         rotateBuffersLeft(_n);
+        compressNewHistoryLines(_n);
 
         // Initialize (/reset) new lines.
         for (auto y = boxed_cast<LineOffset>(pageSize_.lines - _n);
              y < boxed_cast<LineOffset>(pageSize_.lines);
              ++y)
-            lineAt(y).reset(defaultLineFlags(), _defaultAttributes);
+            lineAt(y).reset(defaultLineFlags(), _defaultAttributes, bufferPool_);
 
         return _n;
     }
@@ -373,10 +470,12 @@ LineCount Grid<Cell>::scrollUp(LineCount _n, GraphicsAttributes _defaultAttribut
         if (n != 0)
         {
             linesUsed_ += LineCount::cast_from(n);
-            fill_n(next(lines_.begin(), *pageSize_.lines),
-                   n,
-                   Line { pageSize_.columns, defaultLineFlags(), Cell { _defaultAttributes } });
+            generate_n(next(lines_.begin(), *pageSize_.lines), n, [&]() {
+                return Line<Cell>(bufferPool_.acquire(pageSize_.columns, Cell { _defaultAttributes }),
+                                  defaultLineFlags());
+            });
             rotateBuffersLeft(LineCount::cast_from(n));
+            compressNewHistoryLines(LineCount::cast_from(n));
         }
         if (n < unbox<size_t>(_n))
         {
@@ -387,7 +486,7 @@ LineCount Grid<Cell>::scrollUp(LineCount _n, GraphicsAttributes _defaultAttribut
             for (auto y = boxed_cast<LineOffset>(pageSize_.lines - _n);
                  y < boxed_cast<LineOffset>(pageSize_.lines);
                  ++y)
-                lineAt(y).reset(defaultLineFlags(), _defaultAttributes);
+                lineAt(y).reset(defaultLineFlags(), _defaultAttributes, bufferPool_);
         }
         return LineCount::cast_from(n);
     }
@@ -430,7 +529,7 @@ LineCount Grid<Cell>::scrollUp(LineCount _n, GraphicsAttributes _defaultAttribut
         for (auto lineNumber = topEmptyLineNr; lineNumber <= bottomLineNumber; ++lineNumber)
         {
             Line<Cell>& line = lines_[lineNumber];
-            line.reset(defaultLineFlags(), _defaultAttributes);
+            line.reset(defaultLineFlags(), _defaultAttributes, bufferPool_);
         }
     }
     else
@@ -449,7 +548,11 @@ LineCount Grid<Cell>::scrollUp(LineCount _n, GraphicsAttributes _defaultAttribut
             auto const sourceLineOffset = targetLineOffset + *n;
             auto t = &useCellAt(targetLineOffset, _margin.horizontal.from);
             auto s = &at(sourceLineOffset, _margin.horizontal.from);
-            std::copy_n(s, columnsToMove, t);
+            // Move instead of copy: every source cell is itself overwritten or
+            // cleared below, and Cell's copy assignment deep-copies the
+            // CellExtra of decorated cells (one heap allocation each), which
+            // the move elides.
+            std::move(s, s + columnsToMove, t);
         }
 
         for (LineOffset line = _margin.vertical.to - *n + 1; line <= _margin.vertical.to; ++line)
@@ -498,7 +601,7 @@ void Grid<Cell>::scrollDown(LineCount v_n,
         rotateBuffersRight(n);
 
         for (Line<Cell>& line: mainPage().subspan(0, unbox<size_t>(n)))
-            line.reset(defaultLineFlags(), _defaultAttributes);
+            line.reset(defaultLineFlags(), _defaultAttributes, bufferPool_);
         return;
     }
 
@@ -510,29 +613,28 @@ void Grid<Cell>::scrollDown(LineCount v_n,
         auto c = std::next(begin(lines_), *_margin.vertical.to + 1);
         std::rotate(a, b, c);
         for (auto const i: ranges::views::iota(*_margin.vertical.from, *_margin.vertical.from + *n))
-            lines_[i].reset(defaultLineFlags(), _defaultAttributes);
+            lines_[i].reset(defaultLineFlags(), _defaultAttributes, bufferPool_);
     }
     else
     {
-        // a full "inside" scroll-down
-        if (n <= _margin.vertical.length())
+        // a full "inside" scroll-down; bottom-up, as source and target rows overlap
+        for (LineOffset line = _margin.vertical.to; line >= _margin.vertical.from + *n; --line)
         {
-            for (LineOffset line = _margin.vertical.to; line >= _margin.vertical.to - *n; --line)
-            {
-                auto s = &at(line - *n, _margin.horizontal.from);
-                auto t = &at(line, _margin.horizontal.from);
-                std::copy_n(s, unbox<size_t>(_margin.horizontal.length()), t);
-            }
+            auto s = &at(line - *n, _margin.horizontal.from);
+            auto t = &at(line, _margin.horizontal.from);
+            // Moved-from source cells are themselves overwritten or cleared
+            // below; moving elides Cell's deep CellExtra copy.
+            std::move(s, s + unbox<size_t>(_margin.horizontal.length()), t);
+        }
 
-            for (LineOffset line = _margin.vertical.from; line < _margin.vertical.from + *n; ++line)
+        for (LineOffset line = _margin.vertical.from; line < _margin.vertical.from + *n; ++line)
+        {
+            auto a = &at(line, _margin.horizontal.from);
+            auto b = &at(line, _margin.horizontal.to + 1);
+            while (a != b)
             {
-                auto a = &at(line, _margin.horizontal.from);
-                auto b = &at(line, _margin.horizontal.to + 1);
-                while (a != b)
-                {
-                    *a = Cell { _defaultAttributes };
-                    a++;
-                }
+                a->reset(_defaultAttributes);
+                a++;
             }
         }
     }
@@ -561,9 +663,10 @@ template <typename Cell>
 void Grid<Cell>::reset()
 {
     linesUsed_ = pageSize_.lines;
+    absoluteTopLine_ = 0;
     lines_.rotate_right(lines_.zero_index());
     for (int i = 0; i < unbox<int>(pageSize_.lines); ++i)
-        lines_[i].reset(defaultLineFlags(), GraphicsAttributes {});
+        lines_[i].reset(defaultLineFlags(), GraphicsAttributes {}, bufferPool_);
     verifyState();
 }
 
@@ -573,7 +676,7 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
     if (pageSize_ == _newSize)
         return _currentCursorPos;
 
-    LOGSTORE(GridLog)("resize {} -> {} (cursor {})", pageSize_, _newSize, _currentCursorPos);
+    LOGSTORE_DEBUG(GridLog)("resize {} -> {} (cursor {})", pageSize_, _newSize, _currentCursorPos);
 
     // Growing in line count with scrollback lines present will move
     // the scrollback lines into the visible area.
@@ -610,7 +713,7 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
         auto const linesFill =
             max(0, unbox<int>(maxHistoryLineCount_ + _newHeight) - static_cast<int>(lines_.size()));
         for ([[maybe_unused]] auto const _: ranges::views::iota(0, linesFill))
-            lines_.emplace_back(pageSize_.columns, wrappableFlag, Cell {});
+            lines_.emplace_back(bufferPool_.acquire(pageSize_.columns), wrappableFlag);
         pageSize_.lines += extendCount;
         linesUsed_ += extendCount;
 
@@ -636,7 +739,7 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
         auto const numLinesToPushUp = numLinesToShrink - cutoffCount;
         auto const numLinesToPushUpCapped = min(numLinesToPushUp, maxHistoryLineCount_);
 
-        LOGSTORE(GridLog)
+        LOGSTORE_DEBUG(GridLog)
         (" -> shrink lines: numLinesToShrink {}, linesAvailableBelowCursorBeforeShrink {}, "
          "cutoff {}, pushUp "
          "{}/{}",
@@ -661,7 +764,7 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
         Require(_newHeight <= pageSize_.lines);
         if (*numLinesToPushUp)
         {
-            LOGSTORE(GridLog)(" -> numLinesToPushUp {}", numLinesToPushUp);
+            LOGSTORE_DEBUG(GridLog)(" -> numLinesToPushUp {}", numLinesToPushUp);
             Require(*_cursor.line + 1 == *pageSize_.lines);
             rotateBuffersLeft(numLinesToPushUp);
             pageSize_.lines -= numLinesToPushUp;
@@ -717,7 +820,7 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
             [[maybe_unused]] auto const logLogicalLine =
                 [&logicalLineBuffer]([[maybe_unused]] LineFlags lineFlags,
                                      [[maybe_unused]] std::string_view msg) {
-                    LOGSTORE(GridLog)
+                    LOGSTORE_DEBUG(GridLog)
                     ("{} |> \"{}\"", msg, Line<Cell>(LineBuffer(logicalLineBuffer), lineFlags).toUtf8());
                 };
 
@@ -728,6 +831,18 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
                 // line.toUtf8()));
                 Require(line.size() >= pageSize_.columns);
 
+                // Fast path: a trivial (compact) line that is not part of any wrapped
+                // logical line does not participate in re-wrapping; it is carried over
+                // as-is with just its width bumped - O(1), no cell inflation.
+                auto const nextLineWrapped = i + 1 < *pageSize_.lines && lines_[i + 1].wrapped();
+                if (line.isTrivialBuffer() && !line.wrapped() && !nextLineWrapped)
+                {
+                    flushLogicalLine();
+                    line.resize(_newColumnCount);
+                    grownLines.emplace_back(std::move(line));
+                    continue;
+                }
+
                 if (line.wrapped())
                 {
                     // logLogicalLine(line.flags(), fmt::format(" - appending: \"{}\"",
@@ -831,6 +946,19 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
             {
                 auto& line = lines_[i];
 
+                // Fast path: a trivial (compact) line whose text still fits into the
+                // new width needs no re-wrapping at all; carry it over with just its
+                // width shrunk - O(1), no cell inflation.
+                if (wrappedColumns.empty() && line.isTrivialBuffer()
+                    && line.trivialBuffer().text.size() <= unbox<size_t>(_newColumnCount))
+                {
+                    previousFlags = line.inheritableFlags();
+                    line.resize(_newColumnCount);
+                    shrinkedLines.emplace_back(std::move(line));
+                    numLinesWritten++;
+                    continue;
+                }
+
                 // do we have previous columns carried?
                 if (!wrappedColumns.empty())
                 {
@@ -890,6 +1018,8 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
 
     CellLocation cursor = _currentCursorPos;
 
+    auto const oldestAbsoluteLine = absoluteLineNumber(-boxed_cast<LineOffset>(historyLineCount()));
+
     // grow/shrink columns
     using crispy::Comparison;
     switch (crispy::strongCompare(_newSize.columns, pageSize_.columns))
@@ -908,6 +1038,11 @@ CellLocation Grid<Cell>::resize(PageSize _newSize, CellLocation _currentCursorPo
     }
 
     Ensures(pageSize_ == _newSize);
+
+    // Rebase the absolute numbering such that the oldest retained line keeps
+    // its number; re-wrapping changes interior line identities anyway.
+    absoluteTopLine_ = oldestAbsoluteLine + unbox<uint64_t>(historyLineCount());
+
     verifyState();
 
     return cursor;
@@ -933,7 +1068,7 @@ void Grid<Cell>::appendNewLines(LineCount _count, GraphicsAttributes _attr)
         {
             auto line = std::move(lines_.front());
             lines_.pop_front();
-            line.reset(defaultLineFlags(), _attr);
+            line.reset(defaultLineFlags(), _attr, bufferPool_);
             lines_.emplace_back(std::move(line));
         }
         return;
@@ -942,7 +1077,7 @@ void Grid<Cell>::appendNewLines(LineCount _count, GraphicsAttributes _attr)
     if (auto const n = std::min(_count, pageSize_.lines); *n > 0)
     {
         generate_n(back_inserter(lines_), *n, [&]() {
-            return Line<Cell>(pageSize_.columns, wrappableFlag, Cell { _attr });
+            return Line<Cell>(bufferPool_.acquire(pageSize_.columns, Cell { _attr }), wrappableFlag);
         });
         clampHistory();
     }
@@ -32,6 +32,7 @@
 
 #include <algorithm>
 #include <array>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -378,6 +379,49 @@ class Grid
 
     LineCount historyLineCount() const noexcept { return linesUsed_ - pageSize_.lines; }
 
+    /// Total number of heap bytes currently held by all line storages (active
+    /// page plus scrollback); cheap enough for periodic statistics sampling.
+    std::size_t memoryUsage() const noexcept
+    {
+        auto sum = std::size_t { 0 };
+        for (Line<Cell> const& line: lines_)
+            sum += line.memoryUsage();
+        return sum;
+    }
+
+    // {{{ absolute line numbering
+    //
+    // 64-bit line numbers that stay stable while the grid scrolls: the line
+    // currently at the top of the page has the number absoluteTopLine(), the
+    // history lines above it have smaller numbers. This allows selections,
+    // search anchors and viewport positions to be remembered without chasing
+    // ring-buffer rotations, and resolved back in O(1). A reflowing resize
+    // rebases the numbering such that the oldest retained line keeps its
+    // number (interior line identities change when re-wrapping anyway), and
+    // reset() restarts it at zero.
+
+    uint64_t absoluteTopLine() const noexcept { return absoluteTopLine_; }
+
+    /// @returns the absolute line number of the line at relative offset @p _line.
+    uint64_t absoluteLineNumber(LineOffset _line) const noexcept
+    {
+        return static_cast<uint64_t>(static_cast<int64_t>(absoluteTopLine_) + unbox<int>(_line));
+    }
+
+    /// Maps an absolute line number back to its current relative line offset.
+    ///
+    /// @returns the offset suitable for lineAt(), or std::nullopt if that line
+    ///          has been scrolled out of (or did not yet enter) the buffer.
+    std::optional<LineOffset> lineOffsetForAbsolute(uint64_t _absoluteLine) const noexcept
+    {
+        auto const relative = static_cast<int64_t>(_absoluteLine) - static_cast<int64_t>(absoluteTopLine_);
+        if (relative < -static_cast<int64_t>(unbox<int>(historyLineCount()))
+            || relative >= static_cast<int64_t>(unbox<int>(pageSize_.lines)))
+            return std::nullopt;
+        return LineOffset::cast_from(relative);
+    }
+    // }}}
+
     bool reflowOnResize() const noexcept { return reflowOnResize_; }
     void setReflowOnResize(bool _enabled) { reflowOnResize_ = _enabled; }
 
@@ -406,6 +450,16 @@ class Grid
     std::string lineTextTrimmed(LineOffset _line) const;
     std::string lineText(Line<Cell> const& _line) const;
 
+    /// Renders the line's text and returns a view of it.
+    ///
+    /// Trivial (compact single-SGR US-ASCII) lines hand out a view of their
+    /// own storage without touching @p _buffer; columns past the stored text
+    /// are blank and not represented. Any other line is rendered into
+    /// @p _buffer (cleared first). Reusing one buffer across many lines makes
+    /// bulk text extraction allocation-free.
+    std::string_view lineText(LineOffset _line, std::string& _buffer) const;
+    std::string_view lineText(Line<Cell> const& _line, std::string& _buffer) const;
+
     void setLineText(LineOffset _line, std::string_view _text);
 
     // void resetLine(LineOffset _line, GraphicsAttributes _attribs) noexcept { lineAt(_line).reset(_attribs);
@@ -417,6 +471,63 @@ class Grid
 
     int computeLogicalLineNumberFromBottom(LineCount _n) const noexcept;
 
+    /// Invokes @p _fn(LineOffset, Line<Cell> const&) for every line in the
+    /// inclusive range [_top, _bottom], walking the ring's (at most two)
+    /// contiguous storage segments directly, so that - unlike per-line
+    /// lineAt() calls - no ring index normalization is paid per line.
+    template <typename F>
+    void forEachLine(LineOffset _top, LineOffset _bottom, F&& _fn) const
+    {
+        Require(_top <= _bottom);
+        auto lineOffset = _top;
+        lines_.for_each_segment(unbox<long>(_top),
+                                static_cast<size_t>(unbox<long>(_bottom) - unbox<long>(_top)) + 1,
+                                [&](Line<Cell> const* _data, size_t _count) {
+                                    for (auto const& line: gsl::span(_data, _count))
+                                    {
+                                        _fn(lineOffset, line);
+                                        ++lineOffset;
+                                    }
+                                });
+    }
+
+    /// Invokes @p _fn(LineOffset, Cell const* data, size_t count) with each
+    /// line's contiguous cell buffer for the inclusive range [_top, _bottom].
+    ///
+    /// Cells are stored per line, so each span covers exactly one line; the
+    /// raw pointers allow consumers to vectorize (memchr/memcpy-style) instead
+    /// of paying iterator arithmetic per cell. Compact (trivial) lines are
+    /// inflated on demand - prefer forEachLine() plus Line::isTrivialBuffer()
+    /// where the compact text form can be consumed directly.
+    template <typename F>
+    void forEachCellSpan(LineOffset _top, LineOffset _bottom, F&& _fn) const
+    {
+        forEachLine(_top, _bottom, [&](LineOffset _line, Line<Cell> const& _lineRef) {
+            auto const cells = _lineRef.cells();
+            _fn(_line, cells.data(), static_cast<size_t>(cells.size()));
+        });
+    }
+
+    /// Eagerly inflates all compact lines in the inclusive range [_top, _bottom]
+    /// (clamped to the valid line range), so that later per-cell access - e.g.
+    /// rendering the next page while scrolling through history - does not pay
+    /// the decompression inside its own frame. The lines' modification
+    /// generations remain untouched, as their content does not change.
+    void materializeLineRange(LineOffset _top, LineOffset _bottom);
+
+    /// Pins the inclusive line range [_top, _bottom] against demotion to the
+    /// compact storage form (see compressNewHistoryLines()), keeping lines
+    /// around the viewport materialized while the user dwells in history.
+    void pinLineRange(LineOffset _top, LineOffset _bottom) noexcept;
+
+    /// Releases a pin established via pinLineRange().
+    void unpinLineRange() noexcept;
+
+    /// Enables/disables demotion of lines entering the scrollback to their
+    /// compact storage form (see compressNewHistoryLines()). Disabling trades
+    /// memory for never paying inflation cost on scrollback access.
+    void setHistoryCompression(bool _enabled) noexcept { historyCompressionEnabled_ = _enabled; }
+
     size_t zero_index() const noexcept { return lines_.zero_index(); }
     // }}}
 
@@ -476,6 +587,12 @@ class Grid
     template <typename RendererT>
     void render(RendererT&& _render, ScrollOffset _scrollOffset = {}) const;
 
+    /// Like render() above, but rows for which @p _skipRow returns true are
+    /// skipped entirely - without touching their line storage, and in
+    /// particular without inflating trivially stored lines into cells.
+    template <typename RendererT, typename RowFilterT>
+    void render(RendererT&& _render, RowFilterT&& _skipRow, ScrollOffset _scrollOffset) const;
+
     /// Takes text-screenshot of the main page.
     std::string renderMainPageText() const;
 
@@ -483,17 +600,32 @@ class Grid
     ///
     /// Empty cells are represented as strings and lines split by LF.
     std::string renderAllText() const;
+
+    /// Collects the minimap digests for @p _count lines starting at @p _first
+    /// (negative offsets addressing the scrollback) into @p _output, one
+    /// entry per line, clearing @p _output first.
+    ///
+    /// Cheap enough to run every frame: compacted scrollback lines are
+    /// digested from their text form without being inflated.
+    void collectLineDigests(LineOffset _first, LineCount _count, std::vector<LineDigest>& _output) const;
     // }}}
 
     constexpr LineFlags defaultLineFlags() const noexcept;
 
     constexpr LineCount linesUsed() const noexcept;
 
+    /// Provides access to the line buffer recycling pool (e.g. for stats inspection).
+    LineBufferPool<Cell> const& bufferPool() const noexcept { return bufferPool_; }
+
   private:
     void verifyState();
     void appendNewLines(LineCount _count, GraphicsAttributes _attr);
     void clampHistory();
 
+    /// Demotes the @p _n lines that have just been rotated from the top of the
+    /// page into the scrollback to their compact storage form, if representable.
+    void compressNewHistoryLines(LineCount _n);
+
     // {{{ buffer helpers
     void resizeBuffers(PageSize _newSize)
     {
@@ -524,6 +656,17 @@ class Grid
 
     // Number of lines used in the Lines buffer.
     LineCount linesUsed_;
+
+    // Absolute number of the line currently at the top of the page.
+    // @see absoluteTopLine()
+    uint64_t absoluteTopLine_ = 0;
+
+    // Recycles retired line cell buffers across scrolling, resize and reflow.
+    LineBufferPool<Cell> bufferPool_;
+
+    // Inclusive line range excluded from compact-storage demotion, if any.
+    std::optional<std::pair<LineOffset, LineOffset>> pinnedLineRange_ {};
+    bool historyCompressionEnabled_ = true;
 };
 
 template <typename Cell>
@@ -555,34 +698,66 @@ bool Grid<Cell>::isLineWrapped(LineOffset _line) const noexcept
 template <typename Cell>
 template <typename RendererT>
 void Grid<Cell>::render(RendererT&& _render, ScrollOffset _scrollOffset) const
+{
+    render(
+        std::forward<RendererT>(_render), [](LineOffset) noexcept { return false; }, _scrollOffset);
+}
+
+template <typename Cell>
+template <typename RendererT, typename RowFilterT>
+void Grid<Cell>::render(RendererT&& _render, RowFilterT&& _skipRow, ScrollOffset _scrollOffset) const
 {
     assert(!_scrollOffset || unbox<LineCount>(_scrollOffset) <= historyLineCount());
 
     auto const static emptyCell = Cell {};
 
-    auto y = LineOffset(0);
-    for (int i = -*_scrollOffset, e = i + *pageSize_.lines; i != e; ++i, ++y)
-    {
-        auto x = ColumnOffset(0);
-        Line<Cell> const& line = lines_[i];
-        if constexpr (Line<Cell>::ColumnOptimized)
+    // Renders the page with the column count passed in as @p columnCount,
+    // which is either the run-time page width or (for the page widths
+    // terminals most commonly run at) a compile-time constant, giving the
+    // compiler a known trip count to unroll and vectorize the per-cell loop
+    // with. Lines not matching that width (e.g. not yet reflowed) take the
+    // run-time bounded loop instead.
+    auto const renderLines = [&](auto const columnCount) {
+        auto y = LineOffset(0);
+        for (int i = -*_scrollOffset, e = i + *pageSize_.lines; i != e; ++i, ++y)
         {
-            Cell const* cell = &*line.begin();
-            Cell const* cellUsedEnd = cell + *line.columnsUsed();
-            Cell const* cellEnd = cell + *line.size();
-            while (cell != cellUsedEnd)
-                _render(*cell++, y, x++);
-            while (cell != cellEnd)
+            if (_skipRow(y))
+                continue;
+            auto x = ColumnOffset(0);
+            Line<Cell> const& line = lines_[i];
+            if constexpr (Line<Cell>::ColumnOptimized)
             {
-                _render(emptyCell, y, x++);
-                ++cell;
+                Cell const* cell = &*line.begin();
+                Cell const* cellUsedEnd = cell + *line.columnsUsed();
+                Cell const* cellEnd = cell + *line.size();
+                while (cell != cellUsedEnd)
+                    _render(*cell++, y, x++);
+                while (cell != cellEnd)
+                {
+                    _render(emptyCell, y, x++);
+                    ++cell;
+                }
+            }
+            else if (auto const cells = line.cells(); cells.size() == static_cast<size_t>(columnCount))
+            {
+                Cell const* cell = cells.data();
+                for (auto k = 0; k < static_cast<int>(columnCount); ++k)
+                    _render(cell[k], y, x++);
+            }
+            else
+            {
+                for (Cell const& cell: cells)
+                    _render(cell, y, x++);
             }
         }
-        else
-        {
-            for (Cell const& cell: line.cells())
-                _render(cell, y, x++);
-        }
+    };
+
+    switch (unbox<int>(pageSize_.columns))
+    {
+    case 80: renderLines(std::integral_constant<int, 80> {}); break;
+    case 120: renderLines(std::integral_constant<int, 120> {}); break;
+    case 200: renderLines(std::integral_constant<int, 200> {}); break;
+    default: renderLines(unbox<int>(pageSize_.columns)); break;
     }
 }
 // }}}
@@ -165,6 +165,162 @@ TEST_CASE("Grid.writeAndScrollUp", "[grid]")
     CHECK(grid.lineText(LineOffset(1)) == "     ");
 }
 
+TEST_CASE("Grid.compressNewHistoryLines", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, true, LineCount(3));
+    grid.setLineText(LineOffset { 0 }, "ABCDE");
+    grid.setLineText(LineOffset { 1 }, "abcde");
+    REQUIRE(!grid.lineAt(LineOffset(0)).isTrivialBuffer());
+
+    grid.scrollUp(LineCount(1));
+
+    // The line scrolled into history got demoted to its compact storage form, ...
+    CHECK(grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+    // ... while accessing it still transparently yields the original content.
+    CHECK(grid.lineText(LineOffset(-1)) == "ABCDE");
+    CHECK(grid.lineText(LineOffset(0)) == "abcde");
+}
+
+TEST_CASE("Grid.lineText.view", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, true, LineCount(3));
+    grid.setLineText(LineOffset { 0 }, "ABCDE");
+    grid.setLineText(LineOffset { 1 }, "abcde");
+    grid.scrollUp(LineCount(1));
+    REQUIRE(grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+    REQUIRE(!grid.lineAt(LineOffset(0)).isTrivialBuffer());
+
+    auto buffer = std::string {};
+
+    // A trivial line hands out a view of its own storage: the buffer stays
+    // untouched and the access does not inflate the line.
+    CHECK(grid.lineText(LineOffset(-1), buffer) == "ABCDE");
+    CHECK(buffer.empty());
+    CHECK(grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+
+    // An inflated line is rendered into the caller-provided buffer.
+    CHECK(grid.lineText(LineOffset(0), buffer) == "abcde");
+    CHECK(buffer == "abcde");
+}
+
+TEST_CASE("Grid.render.width80", "[grid]")
+{
+    // 80 columns takes the render loop instantiation with the column count as
+    // a compile-time constant; ensure it delivers the same cells as the
+    // generic run-time bounded loop does for any other width.
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(80) }, true, LineCount(0));
+    grid.setLineText(LineOffset { 0 }, "ABC");
+
+    auto text = string {};
+    auto cellCount = 0;
+    grid.render([&](Cell const& cell, LineOffset, ColumnOffset) {
+        ++cellCount;
+        if (cell.codepointCount())
+            text += cell.toUtf8();
+    });
+    CHECK(cellCount == 2 * 80);
+    CHECK(text == "ABC");
+}
+
+TEST_CASE("Grid.lineDigest", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, true, LineCount(3));
+    grid.setLineText(LineOffset { 0 }, "ABCDE");
+    grid.scrollUp(LineCount(1));
+    REQUIRE(grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+
+    // Trivial lines are digested from their compact text form; the access
+    // must not inflate them.
+    auto const digest = grid.lineAt(LineOffset(-1)).digest();
+    CHECK(digest.density == 255);
+    CHECK(grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+
+    // Blank page line digests to zero density.
+    CHECK(grid.lineAt(LineOffset(1)).digest().density == 0);
+
+    auto digests = std::vector<LineDigest> {};
+    grid.collectLineDigests(LineOffset(-1), LineCount(3), digests);
+    CHECK(digests.size() == 3);
+    CHECK(digests[0].density == 255);
+}
+
+TEST_CASE("Grid.materializeAndPinLineRange", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, true, LineCount(3));
+    grid.setLineText(LineOffset { 0 }, "ABCDE");
+    grid.setLineText(LineOffset { 1 }, "abcde");
+    grid.scrollUp(LineCount(1));
+    REQUIRE(grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+
+    // Prefetch: the compact history line is inflated in place, keeping its
+    // content and modification generation unchanged.
+    auto const generation = grid.lineAt(LineOffset(-1)).generation();
+    grid.materializeLineRange(LineOffset(-5), LineOffset(-1)); // clamped to the valid range
+    CHECK(!grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+    CHECK(grid.lineAt(LineOffset(-1)).generation() == generation);
+    CHECK(grid.lineText(LineOffset(-1)) == "ABCDE");
+
+    // A pinned line survives the compact-storage demotion on scroll, ...
+    grid.pinLineRange(LineOffset(-3), LineOffset(0));
+    grid.scrollUp(LineCount(1));
+    CHECK(!grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+
+    // ... while unpinned scrolling demotes again as usual.
+    grid.unpinLineRange();
+    grid.setLineText(LineOffset { 0 }, "fghij");
+    grid.scrollUp(LineCount(1));
+    CHECK(grid.lineAt(LineOffset(-1)).isTrivialBuffer());
+    CHECK(grid.lineText(LineOffset(-1)) == "fghij");
+}
+
+TEST_CASE("Grid.absoluteLineNumbering", "[grid]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, true, LineCount(3));
+    grid.setLineText(LineOffset { 0 }, "ABCDE");
+    grid.setLineText(LineOffset { 1 }, "abcde");
+    REQUIRE(grid.absoluteTopLine() == 0);
+
+    // Remember the first line by its absolute number, then scroll twice.
+    auto const anchor = grid.absoluteLineNumber(LineOffset(0));
+    grid.scrollUp(LineCount(1));
+    grid.scrollUp(LineCount(1));
+
+    // The numbering advanced with the page, ...
+    CHECK(grid.absoluteTopLine() == 2);
+    // ... and the anchor still resolves to the very same line.
+    auto const offset = grid.lineOffsetForAbsolute(anchor);
+    REQUIRE(offset.has_value());
+    CHECK(*offset == LineOffset(-2));
+    CHECK(grid.lineText(*offset) == "ABCDE");
+
+    // Lines in front of the retained scrollback (or not yet written) do not resolve.
+    CHECK(!grid.lineOffsetForAbsolute(anchor + 10).has_value());
+
+    grid.scrollUp(LineCount(3));
+    CHECK(!grid.lineOffsetForAbsolute(anchor).has_value());
+}
+
+TEST_CASE("Grid.forEachLine", "[grid]")
+{
+    // setupGrid5x2x2 scrolled twice, so the ring is rotated underneath.
+    auto grid = setupGrid5x2x2();
+
+    auto text = std::string {};
+    grid.forEachLine(LineOffset(-1), LineOffset(1), [&](LineOffset _offset, Line<Cell> const& _line) {
+        text += grid.lineText(_line);
+        text += fmt::format("@{};", *_offset);
+    });
+    CHECK(text == "ABCDE@-1;FGHIJ@0;KLMNO@1;");
+
+    // The cell-span variant surfaces each line's contiguous buffer.
+    auto cellCount = size_t { 0 };
+    grid.forEachCellSpan(LineOffset(0), LineOffset(1), [&](LineOffset, Cell const* _data, size_t _count) {
+        REQUIRE(_data != nullptr);
+        cellCount += _count;
+    });
+    CHECK(cellCount == 10);
+}
+
 TEST_CASE("iteratorAt", "[grid]")
 {
     auto grid = Grid<Cell>(PageSize { LineCount(3), ColumnCount(3) }, true, LineCount(0));
@@ -846,3 +1002,40 @@ TEST_CASE("Grid.reflow.tripple", "[grid]")
     }
 }
 // }}}
+
+TEST_CASE("LineBufferPool.watermarkTrimming", "[line]")
+{
+    auto pool = LineBufferPool<Cell> {};
+
+    // Filling up to just below the high watermark retains every buffer.
+    for (size_t i = 0; i < LineBufferPool<Cell>::HighWatermark - 1; ++i)
+        pool.retire(InflatedLineBuffer<Cell>(10));
+    REQUIRE(pool.size() == LineBufferPool<Cell>::HighWatermark - 1);
+    REQUIRE(pool.stats().discards == 0);
+
+    // Reaching the high watermark releases the whole slack in one bulk pass.
+    pool.retire(InflatedLineBuffer<Cell>(10));
+    CHECK(pool.size() == LineBufferPool<Cell>::LowWatermark);
+    CHECK(pool.stats().discards
+          == LineBufferPool<Cell>::HighWatermark - LineBufferPool<Cell>::LowWatermark);
+}
+
+TEST_CASE("Line.contentHash", "[line]")
+{
+    auto line = Line<Cell> { ColumnCount(10), LineFlags::None };
+    line.reset(LineFlags::None, GraphicsAttributes {});
+    line.appendTrivialText("prompt");
+    auto const initialHash = line.contentHash();
+    auto const initialGeneration = line.generation();
+
+    // Rewriting the identical content bumps the generation but not the hash.
+    line.reset(LineFlags::None, GraphicsAttributes {});
+    line.appendTrivialText("prompt");
+    CHECK(line.generation() != initialGeneration);
+    CHECK(line.contentHash() == initialHash);
+
+    // Actually different content hashes differently.
+    line.reset(LineFlags::None, GraphicsAttributes {});
+    line.appendTrivialText("prompT");
+    CHECK(line.contentHash() != initialHash);
+}
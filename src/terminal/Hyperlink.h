@@ -16,9 +16,12 @@
 #include <crispy/LRUCache.h>
 #include <crispy/boxed.h>
 
+#include <cctype>
+#include <limits>
 #include <list>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace terminal
@@ -40,36 +43,65 @@ using URI = std::string;
 
 struct HyperlinkInfo
 {                       // TODO: rename to Hyperlink
+    /// URI structure, parsed once when the link is interned (OSC 8 commit
+    /// time), so the hover-path accessors below are pure offset lookups
+    /// into the stored URI - no scanning, no malformed-URI handling on the
+    /// frame path. Offsets of zero length denote absent components.
+    struct ParsedURI
+    {
+        uint16_t schemeLength = 0;
+        uint16_t hostOffset = 0;
+        uint16_t hostLength = 0;
+        uint16_t pathOffset = 0; //!< 0: no path component
+        bool valid = false;      //!< has a well-formed "scheme://" prefix
+        bool local = false;      //!< file:// scheme
+    };
+
     std::string userId; //!< application provied ID
     URI uri;
     HyperlinkState state = HyperlinkState::Inactive;
+    ParsedURI parsed {};
+
+    static ParsedURI parseURI(std::string_view _uri) noexcept
+    {
+        auto parsed = ParsedURI {};
+        auto const schemeEnd = _uri.find("://");
+        if (schemeEnd == std::string_view::npos || schemeEnd == 0
+            || _uri.size() > std::numeric_limits<uint16_t>::max())
+            return parsed;
+        for (char const ch: _uri.substr(0, schemeEnd))
+            if (!std::isalnum(static_cast<unsigned char>(ch)) && ch != '+' && ch != '-' && ch != '.')
+                return parsed;
+        parsed.valid = true;
+        parsed.schemeLength = static_cast<uint16_t>(schemeEnd);
+        parsed.local = _uri.substr(0, schemeEnd) == "file";
+        parsed.hostOffset = static_cast<uint16_t>(schemeEnd + 3);
+        if (auto const slash = _uri.find('/', parsed.hostOffset); slash != std::string_view::npos)
+        {
+            parsed.hostLength = static_cast<uint16_t>(slash - parsed.hostOffset);
+            parsed.pathOffset = static_cast<uint16_t>(slash);
+        }
+        return parsed;
+    }
 
-    bool isLocal() const noexcept { return uri.size() >= 7 && uri.substr(0, 7) == "file://"; }
+    bool isLocal() const noexcept { return parsed.local; }
+    bool isValid() const noexcept { return parsed.valid; }
 
     std::string_view host() const noexcept
     {
-        if (auto const i = uri.find("://"); i != uri.npos)
-            if (auto const j = uri.find('/', i + 3); j != uri.npos)
-                return std::string_view { uri.data() + i + 3, j - i - 3 };
-
-        return "";
+        return std::string_view { uri.data() + parsed.hostOffset, parsed.hostLength };
     }
 
     std::string_view path() const noexcept
     {
-        if (auto const i = uri.find("://"); i != uri.npos)
-            if (auto const j = uri.find('/', i + 3); j != uri.npos)
-                return std::string_view { uri.data() + j };
-
-        return "";
+        if (!parsed.pathOffset)
+            return "";
+        return std::string_view { uri.data() + parsed.pathOffset, uri.size() - parsed.pathOffset };
     }
 
     std::string_view scheme() const noexcept
     {
-        if (auto const i = uri.find("://"); i != uri.npos)
-            return std::string_view { uri.data(), i };
-        else
-            return {};
+        return std::string_view { uri.data(), parsed.schemeLength };
     }
 };
 
@@ -88,6 +120,14 @@ using HyperlinkCache = crispy::LRUCache<HyperlinkId, std::shared_ptr<HyperlinkIn
 struct HyperlinkStorage
 {
     HyperlinkCache cache { 1024 };
+
+    /// Interning index: maps a link's identity - the application-provided id,
+    /// or the URI itself for anonymous links - to its assigned HyperlinkId,
+    /// so repeated OSC 8 sequences naming the same target share one entry
+    /// instead of minting fresh ids until the cache churns. Entries are
+    /// validated against the cache on lookup, as the two evict independently.
+    crispy::LRUCache<std::string, HyperlinkId> idByIdentity { 1024 };
+
     HyperlinkId nextHyperlinkId = HyperlinkId(1);
 
     std::shared_ptr<HyperlinkInfo> hyperlinkById(HyperlinkId _id) noexcept
@@ -106,17 +146,23 @@ struct HyperlinkStorage
         return {};
     }
 
-    HyperlinkId hyperlinkIdByUserId(std::string const& _id) noexcept
+    /// Returns the id for the given link, re-using the existing entry if this
+    /// exact link is already known.
+    HyperlinkId intern(std::string _userId, std::string _uri)
     {
-        for (auto& href: cache)
-        {
-            if (href.value->userId == _id)
-            {
-                cache.touch(href.key);
-                return href.key;
-            }
-        }
-        return HyperlinkId {};
+        auto identity = _userId.empty() ? _uri : _userId;
+
+        if (auto const* id = idByIdentity.try_get(identity))
+            if (auto const href = hyperlinkById(*id))
+                if (_userId.empty() ? href->uri == _uri : href->userId == _userId)
+                    return *id;
+
+        auto const id = nextHyperlinkId++;
+        auto info = HyperlinkInfo { std::move(_userId), std::move(_uri) };
+        info.parsed = HyperlinkInfo::parseURI(info.uri);
+        cache.emplace(id, std::make_shared<HyperlinkInfo>(std::move(info)));
+        idByIdentity[std::move(identity)] = id;
+        return id;
     }
 };
 
@@ -57,6 +57,9 @@ ImagePool::ImagePool(OnImageRemove _onImageRemove, ImageId _nextImageId):
     imageNameToImageCache_ { StrongHashtableSize { 1024 },
                              LRUCapacity { 100 },
                              "ImagePool name-to-image mappings" },
+    imageContentCache_ { ContentToImageCache::create(StrongHashtableSize { 1024 },
+                                                     LRUCapacity { 100 },
+                                                     "ImagePool content-to-image mappings") },
     onImageRemove_ { move(_onImageRemove) }
 {
 }
@@ -133,10 +136,25 @@ Image::Data RasterizedImage::fragment(CellLocation _pos) const
 
 shared_ptr<Image const> ImagePool::create(ImageFormat _format, ImageSize _size, Image::Data&& _data)
 {
-    // TODO: This operation should be idempotent, i.e. if that image has been created already, return a
-    // reference to that.
+    // Identical image contents (e.g. a dashboard redrawing the same chart
+    // background every second) are deduplicated at commit time: they share one
+    // Image - and via its stable ImageId also the GPU texture atlas tiles the
+    // renderer has already uploaded for it.
+    auto hashBuilder = crispy::StrongHashBuilder {};
+    hashBuilder.update(_format);
+    hashBuilder.update(_size.width.value);
+    hashBuilder.update(_size.height.value);
+    hashBuilder.update(_data.data(), _data.size());
+    auto const contentHash = hashBuilder.finalize();
+
+    if (auto* cached = imageContentCache_->try_get(contentHash))
+        if (auto image = cached->lock(); image && image->format() == _format && image->size() == _size)
+            return image;
+
     auto const id = nextImageId_++;
-    return make_shared<Image>(id, _format, move(_data), _size, onImageRemove_);
+    auto image = make_shared<Image>(id, _format, move(_data), _size, onImageRemove_);
+    (*imageContentCache_)[contentHash] = image;
+    return image;
 }
 
 shared_ptr<RasterizedImage> ImagePool::rasterize(shared_ptr<Image const> _image,
@@ -171,6 +189,7 @@ void ImagePool::unlink(string const& _name)
 void ImagePool::clear()
 {
     imageNameToImageCache_.clear();
+    imageContentCache_->clear();
 }
 
 void ImagePool::inspect(ostream& os) const
@@ -178,6 +197,7 @@ void ImagePool::inspect(ostream& os) const
     os << "Image pool:\n";
     os << fmt::format("global image stats: {}\n", ImageStats::get());
     imageNameToImageCache_.inspect(os);
+    imageContentCache_->inspect(os);
 }
 
 } // namespace terminal
@@ -18,6 +18,7 @@
 
 #include <crispy/StrongHash.h>
 #include <crispy/StrongLRUCache.h>
+#include <crispy/StrongLRUHashtable.h>
 
 #include <fmt/format.h>
 
@@ -271,11 +272,14 @@ class ImagePool
     void removeRasterizedImage(RasterizedImage* _image); //!< Removes a rasterized image from pool.
 
     using NameToImageIdCache = crispy::StrongLRUCache<std::string, std::shared_ptr<Image const>>;
+    using ContentToImageCache = crispy::StrongLRUHashtable<std::weak_ptr<Image const>>;
 
     // data members
     //
     ImageId nextImageId_;                      //!< ID for next image to be put into the pool
     NameToImageIdCache imageNameToImageCache_; //!< keeps mapping from name to raw image
+    ContentToImageCache::Ptr imageContentCache_; //!< content-hash to image mapping, deduplicating
+                                                 //!< identical image transmissions at commit time
     OnImageRemove const onImageRemove_;        //!< Callback to be invoked when image gets removed from pool.
 };
 
@@ -23,6 +23,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cassert>
+#include <cstring>
 #include <iterator>
 #include <mutex>
 #include <string_view>
@@ -259,10 +261,16 @@ string to_string(MouseButton _button)
     return ""; // should never be reached
 }
 
+InputGenerator::InputGenerator()
+{
+    recompileKeyMappings();
+}
+
 void InputGenerator::reset()
 {
     cursorKeysMode_ = KeyMode::Normal;
     numpadKeysMode_ = KeyMode::Normal;
+    keyboardEnhancementsStack_.assign(1, 0u);
     bracketedPaste_ = false;
     generateFocusEvents_ = false;
     mouseProtocol_ = std::nullopt;
@@ -272,18 +280,22 @@ void InputGenerator::reset()
     // pendingSequence_ = {};
     // currentlyPressedMouseButtons_ = {};
     // currentMousePosition_ = {0, 0}; // current mouse position
+
+    recompileKeyMappings();
 }
 
 void InputGenerator::setCursorKeysMode(KeyMode _mode)
 {
     LOGSTORE(InputLog)("set cursor keys mode: {}", _mode);
     cursorKeysMode_ = _mode;
+    recompileKeyMappings();
 }
 
 void InputGenerator::setNumpadKeysMode(KeyMode _mode)
 {
     LOGSTORE(InputLog)("set numpad keys mode: {}", _mode);
     numpadKeysMode_ = _mode;
+    recompileKeyMappings();
 }
 
 void InputGenerator::setApplicationKeypadMode(bool _enable)
@@ -294,6 +306,43 @@ void InputGenerator::setApplicationKeypadMode(bool _enable)
         numpadKeysMode_ = KeyMode::Normal; // aka. Numeric
 
     LOGSTORE(InputLog)("set application keypad mode: {} -> {}", _enable, numpadKeysMode_);
+    recompileKeyMappings();
+}
+
+void InputGenerator::setKeyboardEnhancements(unsigned _flags, unsigned _mode)
+{
+    auto const flags = _flags & SupportedKeyboardEnhancements;
+    auto& active = keyboardEnhancementsStack_.back();
+    switch (_mode)
+    {
+    case 1: active = flags; break;
+    case 2: active |= flags; break;
+    case 3: active &= ~flags; break;
+    default: return;
+    }
+    LOGSTORE(InputLog)("set keyboard enhancement flags: {:02X}", active);
+    recompileKeyMappings();
+}
+
+void InputGenerator::pushKeyboardEnhancements(unsigned _flags)
+{
+    // Cap the stack depth so that a buggy client cannot grow it unboundedly;
+    // exceeding it drops the oldest entry, as per the kitty spec.
+    auto constexpr MaxStackDepth = size_t { 32 };
+    if (keyboardEnhancementsStack_.size() == MaxStackDepth)
+        keyboardEnhancementsStack_.erase(keyboardEnhancementsStack_.begin());
+
+    keyboardEnhancementsStack_.push_back(_flags & SupportedKeyboardEnhancements);
+    LOGSTORE(InputLog)("push keyboard enhancement flags: {:02X}", keyboardEnhancementsStack_.back());
+    recompileKeyMappings();
+}
+
+void InputGenerator::popKeyboardEnhancements(unsigned _count)
+{
+    while (_count-- && keyboardEnhancementsStack_.size() > 1)
+        keyboardEnhancementsStack_.pop_back();
+    LOGSTORE(InputLog)("pop keyboard enhancement flags; active: {:02X}", keyboardEnhancementsStack_.back());
+    recompileKeyMappings();
 }
 
 bool InputGenerator::generate(u32string const& _characterEvent, Modifier _modifier)
@@ -305,12 +354,64 @@ bool InputGenerator::generate(u32string const& _characterEvent, Modifier _modifi
 
 bool InputGenerator::generate(char32_t _characterEvent, Modifier _modifier)
 {
+    if (static_cast<size_t>(_characterEvent) < NumPrecompiledCharacters)
+    {
+        auto const& mapping = characterMappings_[mappingIndex(_characterEvent, _modifier)];
+        return append(string_view(mapping.sequence, mapping.length));
+    }
+    return append(buildCharSequence(_characterEvent, _modifier));
+}
+
+string InputGenerator::buildCharSequence(char32_t _characterEvent, Modifier _modifier) const
+{
+    auto const enhancements = keyboardEnhancements();
+    auto const reportAll =
+        enhancements & static_cast<unsigned>(KeyboardEnhancements::ReportAllKeysAsEscapeCodes);
+
+    if (enhancements)
+    {
+        // The protocol reports the unshifted key; for the Latin letters that is the
+        // lower-case codepoint, with Shift carried in the modifier field. Unshifting
+        // other keys requires layout information the frontend does not forward.
+        auto const keyCode = [&]() -> uint32_t {
+            if (_characterEvent == 0x08)
+                return 127; // Backspace (see legacy encoding hack below)
+            if (crispy::ascending(char32_t('A'), _characterEvent, char32_t('Z')))
+                return static_cast<uint32_t>(_characterEvent) + 0x20;
+            return static_cast<uint32_t>(_characterEvent);
+        }();
+
+        auto const encodeCsiU = [&]() -> string {
+            if (_modifier.none())
+                return fmt::format("\033[{}u", keyCode);
+            return fmt::format("\033[{};{}u", keyCode, makeVirtualTerminalParam(_modifier));
+        };
+
+        if (reportAll)
+            return encodeCsiU();
+
+        // Disambiguation only: the Esc key and all Ctrl/Alt/Meta-modified keys are
+        // reported unambiguously; Enter, Tab and Backspace keep their legacy
+        // encoding while unmodified, and plain text remains plain text.
+        if (_characterEvent == 0x1B)
+            return encodeCsiU();
+        if (_modifier.control() || _modifier.alt() || _modifier.meta())
+            return encodeCsiU();
+        if (_modifier.some()
+            && (_characterEvent == 0x0D || _characterEvent == 0x09 || _characterEvent == 0x08))
+            return encodeCsiU(); // e.g. Shift+Tab
+        if (_characterEvent == 0x08)
+            return "\x7f";
+        return unicode::convert_to<char>(_characterEvent);
+    }
+
+    auto out = string {};
     char const chr = static_cast<char>(_characterEvent);
 
     // See section "Alt and Meta Keys" in ctlseqs.txt from xterm.
     if (_modifier.alt())
         // NB: There are other modes in xterm to send Alt+Key options or even send ESC on Meta key instead.
-        append("\033");
+        out += '\033';
 
     // Well accepted hack to distinguish between Backspace nad Ctrl+Backspace,
     // - Backspace is emitting 0x7f,
@@ -318,66 +419,94 @@ bool InputGenerator::generate(char32_t _characterEvent, Modifier _modifier)
     if (_characterEvent == 0x08)
     {
         if (!_modifier.control())
-            return append("\x7f");
+            out += '\x7f';
         else
-            return append("\x08");
+            out += '\x08';
+        return out;
     }
 
     if (_modifier == Modifier::Shift && _characterEvent == 0x09)
-        return append("\033[Z"); // introduced by linux_console in 1995, adopted by xterm in 2002
+        return "\033[Z"; // introduced by linux_console in 1995, adopted by xterm in 2002
 
     // raw C0 code
     if (_modifier == Modifier::Control && _characterEvent < 32)
-        return append(static_cast<uint8_t>(_characterEvent));
+        return string(1, chr);
 
     if (_modifier == Modifier::Control && _characterEvent == L' ')
-        return append('\x00');
+        return string(1, '\x00');
 
     if (_modifier == Modifier::Control && crispy::ascending('A', chr, 'Z'))
-        return append(static_cast<char>(chr - 'A' + 1));
+        return string(1, static_cast<char>(chr - 'A' + 1));
 
     if (_modifier == Modifier::Control && _characterEvent >= '[' && _characterEvent <= '_')
-        return append(static_cast<char>(chr - 'A' + 1)); // remaining C0 characters 0x1B .. 0x1F
+        return string(1, static_cast<char>(chr - 'A' + 1)); // remaining C0 characters 0x1B .. 0x1F
 
     if (_modifier.without(Modifier::Alt).none() || _modifier == Modifier::Shift)
-        return append(unicode::convert_to<char>(_characterEvent));
+        return out + unicode::convert_to<char>(_characterEvent);
 
     if (_characterEvent < 0x7F)
-        append(static_cast<char>(_characterEvent));
+        out += chr;
     else
-        append(unicode::convert_to<char>(_characterEvent));
-
-    LOGSTORE(InputLog)
-    ("Sending \"{}\" {}.", crispy::escape(unicode::convert_to<char>(_characterEvent)), _modifier);
-    return true;
+        out += unicode::convert_to<char>(_characterEvent);
+    return out;
 }
 
 bool InputGenerator::generate(Key _key, Modifier _modifier)
 {
-    auto const logged = [_key, _modifier](bool success) -> bool {
-        if (success)
-            LOGSTORE(InputLog)("Sending {} {}.", (unsigned) _key, (unsigned) _modifier);
-        return success;
-    };
+    auto const& mapping = keyMappings_[mappingIndex(static_cast<size_t>(_key), _modifier)];
+    if (!mapping.length)
+        return false;
 
+    append(string_view(mapping.sequence, mapping.length));
+    LOGSTORE(InputLog)("Sending {} {}.", (unsigned) _key, (unsigned) _modifier);
+    return true;
+}
+
+string InputGenerator::buildKeySequence(Key _key, Modifier _modifier) const
+{
     if (_modifier)
     {
         if (auto mapping = tryMap(mappings::functionKeysWithModifiers, _key); mapping)
-            return logged(append(crispy::replace(*mapping, "{}"sv, makeVirtualTerminalParam(_modifier))));
+            return crispy::replace(*mapping, "{}"sv, makeVirtualTerminalParam(_modifier));
     }
 
     if (applicationCursorKeys())
         if (auto mapping = tryMap(mappings::applicationCursorKeys, _key); mapping)
-            return logged(append(*mapping));
+            return string(*mapping);
 
     if (applicationKeypad())
         if (auto mapping = tryMap(mappings::applicationKeypad, _key); mapping)
-            return logged(append(*mapping));
+            return string(*mapping);
 
     if (auto mapping = tryMap(mappings::standard, _key); mapping)
-        return logged(append(*mapping));
+        return string(*mapping);
 
-    return false;
+    return {};
+}
+
+void InputGenerator::recompileKeyMappings()
+{
+    auto const compile = [](string const& _sequence, PrecompiledMapping& _mapping) {
+        assert(_sequence.size() <= sizeof(_mapping.sequence));
+        _mapping.length = static_cast<uint8_t>(min(_sequence.size(), sizeof(_mapping.sequence)));
+        memcpy(_mapping.sequence, _sequence.data(), _mapping.length);
+    };
+
+    for (size_t code = 0; code < NumPrecompiledCharacters; ++code)
+        for (unsigned mods = 0; mods < NumModifierCombinations; ++mods)
+        {
+            auto const modifier = Modifier(static_cast<Modifier::Key>(mods));
+            compile(buildCharSequence(static_cast<char32_t>(code), modifier),
+                    characterMappings_[mappingIndex(code, modifier)]);
+        }
+
+    for (size_t key = 0; key < NumKeys; ++key)
+        for (unsigned mods = 0; mods < NumModifierCombinations; ++mods)
+        {
+            auto const modifier = Modifier(static_cast<Modifier::Key>(mods));
+            compile(buildKeySequence(static_cast<Key>(key), modifier),
+                    keyMappings_[mappingIndex(key, modifier)]);
+        }
 }
 
 void InputGenerator::generatePaste(std::string_view const& _text)
@@ -393,6 +522,13 @@ void InputGenerator::generatePaste(std::string_view const& _text)
         append("\033[201~"sv);
 }
 
+void InputGenerator::generateLatencyProbe(uint64_t _id)
+{
+    append("\033_contour-latency;"sv);
+    append(std::to_string(_id));
+    append("\033\\"sv);
+}
+
 inline bool InputGenerator::append(std::string_view _sequence)
 {
     auto const _l = std::lock_guard { *this };
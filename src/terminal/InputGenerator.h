@@ -20,6 +20,7 @@
 
 #include <unicode/convert.h>
 
+#include <array>
 #include <mutex>
 #include <optional>
 #include <set>
@@ -210,6 +211,18 @@ enum class KeyMode
     Normal,
     Application
 };
+
+/// Progressive enhancement flags of the extended keyboard protocol
+/// (the "kitty keyboard protocol"), negotiated via `CSI = Ps ; Ps u`,
+/// `CSI > Ps u` and `CSI < Ps u`.
+enum class KeyboardEnhancements : unsigned
+{
+    DisambiguateEscapeCodes = 0x01,    //!< Esc and modified keys are reported unambiguously via CSI u.
+    ReportEventTypes = 0x02,           //!< (unsupported) also report key repeat and release events.
+    ReportAlternateKeys = 0x04,        //!< (unsupported) report shifted/base-layout key alongside.
+    ReportAllKeysAsEscapeCodes = 0x08, //!< every key, including plain text, is reported via CSI u.
+    ReportAssociatedText = 0x10,       //!< (unsupported) report the generated text alongside the key.
+};
 // }}}
 // {{{ Mouse
 enum class MouseButton
@@ -245,6 +258,8 @@ class InputGenerator
   public:
     using Sequence = std::vector<char>;
 
+    InputGenerator();
+
     /// Changes the input mode for cursor keys.
     void setCursorKeysMode(KeyMode _mode);
 
@@ -285,6 +300,27 @@ class InputGenerator
     void setGenerateFocusEvents(bool _enable) noexcept { generateFocusEvents_ = _enable; }
     bool generateFocusEvents() const noexcept { return generateFocusEvents_; }
 
+    // {{{ extended keyboard protocol (kitty keyboard protocol)
+    /// KeyboardEnhancements flags that are actually implemented; the others are masked
+    /// out on set/push, as the kitty spec demands for unsupported enhancements.
+    static constexpr unsigned SupportedKeyboardEnhancements =
+        static_cast<unsigned>(KeyboardEnhancements::DisambiguateEscapeCodes)
+        | static_cast<unsigned>(KeyboardEnhancements::ReportAllKeysAsEscapeCodes);
+
+    /// Replaces (mode 1), adds (mode 2), or removes (mode 3) keyboard enhancement
+    /// flags on the currently active stack entry (`CSI = Ps ; Ps u`).
+    void setKeyboardEnhancements(unsigned _flags, unsigned _mode);
+
+    /// Pushes the given keyboard enhancement flags onto the enhancement stack (`CSI > Ps u`).
+    void pushKeyboardEnhancements(unsigned _flags);
+
+    /// Pops @p _count entries off the keyboard enhancement stack (`CSI < Ps u`).
+    void popKeyboardEnhancements(unsigned _count);
+
+    /// Currently active keyboard enhancement flags (top of the enhancement stack).
+    unsigned keyboardEnhancements() const noexcept { return keyboardEnhancementsStack_.back(); }
+    // }}}
+
     bool generate(char32_t _characterEvent, Modifier _modifier);
     bool generate(std::u32string const& _characterEvent, Modifier _modifier);
     bool generate(Key _key, Modifier _modifier);
@@ -302,6 +338,14 @@ class InputGenerator
     bool generateFocusInEvent();
     bool generateFocusOutEvent();
 
+    /// Generates a private-use latency probe sequence (`APC contour-latency;<id> ST`).
+    ///
+    /// The probe is expected to be echoed back verbatim by the application
+    /// (or a test PTY); the terminal recognizes the echo and completes the
+    /// measurement once the resulting frame is handed over for scanout.
+    /// @see Terminal::injectLatencyProbe()
+    void generateLatencyProbe(uint64_t _id);
+
     /// Generates raw input, usually used for sending reply VT sequences.
     bool generateRaw(std::string_view const& _raw);
 
@@ -360,10 +404,46 @@ class InputGenerator
     inline bool append(uint8_t _byte);
     inline bool append(unsigned int _asciiChar);
 
+    // {{{ precompiled keystroke encodings
+    // One encoded byte sequence per (key, modifier set), rebuilt on every keyboard
+    // mode change, so that the per-keystroke hot path in generate() is a mere table
+    // lookup plus a small memcpy instead of re-evaluating mode conditionals.
+    struct PrecompiledMapping
+    {
+        uint8_t length = 0;
+        char sequence[15] = {};
+    };
+
+    static constexpr size_t NumModifierCombinations = 16;
+    static constexpr size_t NumPrecompiledCharacters = 128;
+    static constexpr size_t NumKeys = static_cast<size_t>(Key::Numpad_9) + 1;
+
+    static constexpr size_t mappingIndex(size_t _code, Modifier _modifier) noexcept
+    {
+        return _code * NumModifierCombinations + (_modifier.value() & 0xF);
+    }
+
+    /// Computes the byte sequence for a single character event under the currently
+    /// active keyboard modes; used to fill characterMappings_ and as fallback for
+    /// non-ASCII character events.
+    std::string buildCharSequence(char32_t _characterEvent, Modifier _modifier) const;
+
+    /// Computes the byte sequence for a single special-key event under the currently
+    /// active keyboard modes; used to fill keyMappings_.
+    std::string buildKeySequence(Key _key, Modifier _modifier) const;
+
+    /// Rebuilds characterMappings_ and keyMappings_; invoked on every keyboard mode change.
+    void recompileKeyMappings();
+    // }}}
+
     // private fields
     //
     KeyMode cursorKeysMode_ = KeyMode::Normal;
     KeyMode numpadKeysMode_ = KeyMode::Normal;
+    std::vector<unsigned> keyboardEnhancementsStack_ { 0u }; // never empty; back() is active
+    std::array<PrecompiledMapping, NumPrecompiledCharacters * NumModifierCombinations>
+        characterMappings_ {};
+    std::array<PrecompiledMapping, NumKeys * NumModifierCombinations> keyMappings_ {};
     bool bracketedPaste_ = false;
     bool generateFocusEvents_ = false;
     std::optional<MouseProtocol> mouseProtocol_ = std::nullopt;
@@ -27,6 +27,7 @@
 
 using namespace std;
 using terminal::InputGenerator;
+using terminal::KeyboardEnhancements;
 using terminal::Modifier;
 using Buffer = terminal::InputGenerator::Sequence;
 using crispy::escape;
@@ -122,3 +123,60 @@ TEST_CASE("InputGenerator.all(Ctrl + A..Z)", "[terminal,input]")
         REQUIRE(escape(input.peek()) == escape(c0));
     }
 }
+
+TEST_CASE("InputGenerator.KeyboardEnhancements.disambiguate", "[terminal,input]")
+{
+    auto input = InputGenerator {};
+    input.setKeyboardEnhancements(static_cast<unsigned>(KeyboardEnhancements::DisambiguateEscapeCodes), 1);
+
+    SECTION("Esc key is reported unambiguously")
+    {
+        input.generate(char32_t { 0x1B }, Modifier::None);
+        CHECK(input.peek() == "\033[27u"sv);
+    }
+
+    SECTION("Ctrl-modified keys are reported via CSI u")
+    {
+        input.generate('C', Modifier::Control);
+        CHECK(input.peek() == "\033[99;5u"sv);
+    }
+
+    SECTION("Shift+Tab is reported via CSI u")
+    {
+        input.generate(char32_t { 0x09 }, Modifier::Shift);
+        CHECK(input.peek() == "\033[9;2u"sv);
+    }
+
+    SECTION("plain text and unmodified Enter keep their legacy encoding")
+    {
+        input.generate('a', Modifier::None);
+        input.generate(char32_t { 0x0D }, Modifier::None);
+        CHECK(input.peek() == "a\r"sv);
+    }
+}
+
+TEST_CASE("InputGenerator.KeyboardEnhancements.pushAndPop", "[terminal,input]")
+{
+    auto input = InputGenerator {};
+    REQUIRE(input.keyboardEnhancements() == 0);
+
+    input.pushKeyboardEnhancements(
+        static_cast<unsigned>(KeyboardEnhancements::ReportAllKeysAsEscapeCodes));
+    input.generate('a', Modifier::None);
+    REQUIRE(input.peek() == "\033[97u"sv);
+    input.consume(5);
+
+    input.popKeyboardEnhancements(1);
+    REQUIRE(input.keyboardEnhancements() == 0);
+    input.generate('a', Modifier::None);
+    REQUIRE(input.peek() == "a"sv);
+}
+
+TEST_CASE("InputGenerator.KeyboardEnhancements.unsupportedFlagsAreIgnored", "[terminal,input]")
+{
+    auto input = InputGenerator {};
+    input.setKeyboardEnhancements(static_cast<unsigned>(KeyboardEnhancements::ReportEventTypes)
+                                      | static_cast<unsigned>(KeyboardEnhancements::ReportAssociatedText),
+                                  1);
+    REQUIRE(input.keyboardEnhancements() == 0);
+}
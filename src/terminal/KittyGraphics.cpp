@@ -0,0 +1,153 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/KittyGraphics.h>
+
+#include <crispy/base64.h>
+
+#include <cstdlib>
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <unistd.h>
+
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+using std::nullopt;
+using std::optional;
+using std::string;
+using std::string_view;
+
+namespace terminal
+{
+
+namespace
+{
+    struct ControlData
+    {
+        char action = 't';
+        char medium = 'd';
+        int format = 32;
+        int width = 0;
+        int height = 0;
+    };
+
+    ControlData parseControlData(string_view _controlData) noexcept
+    {
+        auto result = ControlData {};
+        while (!_controlData.empty())
+        {
+            auto const comma = _controlData.find(',');
+            auto const pair = _controlData.substr(0, comma);
+            _controlData.remove_prefix(comma != string_view::npos ? comma + 1 : _controlData.size());
+
+            if (pair.size() < 3 || pair[1] != '=')
+                continue;
+
+            auto const value = pair.substr(2);
+            switch (pair[0])
+            {
+            case 'a': result.action = value[0]; break;
+            case 't': result.medium = value[0]; break;
+            case 'f': result.format = atoi(string(value).c_str()); break;
+            case 's': result.width = atoi(string(value).c_str()); break;
+            case 'v': result.height = atoi(string(value).c_str()); break;
+            default:
+                // Placement, compression, chunking, ... are not implemented (yet).
+                break;
+            }
+        }
+        return result;
+    }
+} // namespace
+
+optional<KittyGraphicsImage> parseKittyGraphics(string_view _data, ImageSize _maxImageSize)
+{
+#if defined(_WIN32)
+    (void) _data;
+    (void) _maxImageSize;
+    return nullopt; // No POSIX shared memory on this platform.
+#else
+    auto const semicolon = _data.find(';');
+    auto const control = parseControlData(_data.substr(0, semicolon));
+    auto const payload = semicolon != string_view::npos ? _data.substr(semicolon + 1) : string_view {};
+
+    if (control.action != 'T' || control.medium != 's')
+        return nullopt; // Only transmit-and-display via shared memory is supported.
+
+    if (control.format != 24 && control.format != 32)
+        return nullopt;
+
+    if (control.width <= 0 || control.height <= 0 || control.width > unbox<int>(_maxImageSize.width)
+        || control.height > unbox<int>(_maxImageSize.height))
+        return nullopt;
+
+    // The payload is the base64-encoded name of the POSIX shared memory object.
+    auto name = crispy::base64::decode(payload);
+    if (name.empty() || name.find('\0') != string::npos)
+        return nullopt;
+    if (name.front() != '/')
+        name.insert(name.begin(), '/');
+    if (name.find('/', 1) != string::npos)
+        return nullopt; // shm names must not contain further slashes.
+
+    auto const fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0)
+        return nullopt;
+
+    // The client hands ownership of the segment over to us;
+    // unlink it regardless of whether consuming it succeeds.
+    shm_unlink(name.c_str());
+
+    auto const bytesPerPixel = control.format == 32 ? size_t(4) : size_t(3);
+    auto const pixelCount = size_t(control.width) * size_t(control.height);
+    auto const requiredByteCount = pixelCount * bytesPerPixel;
+
+    struct stat st {};
+    if (fstat(fd, &st) < 0 || size_t(st.st_size) < requiredByteCount)
+    {
+        close(fd);
+        return nullopt;
+    }
+
+    void* const mapping = mmap(nullptr, requiredByteCount, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return nullopt;
+    auto const* source = static_cast<uint8_t const*>(mapping);
+
+    auto image = KittyGraphicsImage {};
+    image.size = ImageSize { Width::cast_from(control.width), Height::cast_from(control.height) };
+    if (control.format == 32)
+        image.rgba.assign(source, source + requiredByteCount);
+    else
+    {
+        image.rgba.resize(pixelCount * 4);
+        auto* target = image.rgba.data();
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            *target++ = source[i * 3 + 0];
+            *target++ = source[i * 3 + 1];
+            *target++ = source[i * 3 + 2];
+            *target++ = 0xFF;
+        }
+    }
+    munmap(mapping, requiredByteCount);
+
+    return { std::move(image) };
+#endif
+}
+
+} // namespace terminal
@@ -0,0 +1,56 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <terminal/Image.h>
+#include <terminal/primitives.h>
+
+#include <optional>
+#include <string_view>
+
+namespace terminal
+{
+
+/// A decoded kitty graphics protocol image, ready to be committed
+/// into the image pool and placed onto the grid.
+struct KittyGraphicsImage
+{
+    /// Size in pixels for this image.
+    ImageSize size;
+
+    /// RGBA buffer of the image to be rendered.
+    Image::Data rgba;
+};
+
+/// Parses a kitty graphics protocol APC data string,
+/// i.e. the "<control data>;<payload>" part following the 'G' introducer.
+///
+/// Currently implemented is the transmit-and-display action (a=T) with the
+/// shared-memory transport (t=s), whose payload is the base64-encoded name
+/// of a POSIX shared memory object filled by the client. The pixel data is
+/// mapped directly out of the client's shm segment - multi-megapixel frames
+/// thus bypass the VT byte stream entirely - and the segment is unlinked
+/// after consumption, as the protocol demands.
+///
+/// Pixel formats f=32 (RGBA) and f=24 (RGB) are supported.
+///
+/// @param _data         APC data with the leading 'G' already stripped.
+/// @param _maxImageSize image dimension limit; larger transmissions are rejected.
+///
+/// @returns the decoded image, or std::nullopt if the control data is
+///          malformed, unsupported, or the shm segment does not hold
+///          enough pixel data.
+std::optional<KittyGraphicsImage> parseKittyGraphics(std::string_view _data, ImageSize _maxImageSize);
+
+} // namespace terminal
@@ -1,5 +1,8 @@
 #include <terminal/Cell.h>
 #include <terminal/Line.h>
+#include <terminal/UnicodeCache.h>
+
+#include <crispy/FNV.h>
 
 #include <unicode/grapheme_segmenter.h>
 #include <unicode/utf8.h>
@@ -7,6 +10,8 @@
 using std::get;
 using std::holds_alternative;
 using std::min;
+using std::nullopt;
+using std::optional;
 
 namespace terminal
 {
@@ -15,10 +20,12 @@ template <typename Cell, bool Optimize>
 typename Line<Cell, Optimize>::InflatedBuffer Line<Cell, Optimize>::reflow(ColumnCount _newColumnCount)
 {
     using crispy::Comparison;
+    markModified();
+    auto& buffer = inflatedBuffer();
     switch (crispy::strongCompare(_newColumnCount, columnsUsed()))
     {
     case Comparison::Equal: break;
-    case Comparison::Greater: buffer_.resize(unbox<size_t>(_newColumnCount)); break;
+    case Comparison::Greater: buffer.resize(unbox<size_t>(_newColumnCount)); break;
     case Comparison::Less: {
         // TODO: properly handle wide character cells
         // - when cutting in the middle of a wide char, the wide char gets wrapped and an empty
@@ -26,11 +33,11 @@ typename Line<Cell, Optimize>::InflatedBuffer Line<Cell, Optimize>::reflow(Colum
 
         if (wrappable())
         {
-            auto const [reflowStart, reflowEnd] = [this, _newColumnCount]() {
+            auto const [reflowStart, reflowEnd] = [&buffer, _newColumnCount]() {
                 auto const reflowStart =
-                    next(buffer_.begin(), *_newColumnCount /* - buffer_[_newColumnCount].width()*/);
+                    next(buffer.begin(), *_newColumnCount /* - buffer[_newColumnCount].width()*/);
 
-                auto reflowEnd = buffer_.end();
+                auto reflowEnd = buffer.end();
 
                 while (reflowEnd != reflowStart && prev(reflowEnd)->empty())
                     reflowEnd = prev(reflowEnd);
@@ -39,7 +46,7 @@ typename Line<Cell, Optimize>::InflatedBuffer Line<Cell, Optimize>::reflow(Colum
             }();
 
             auto removedColumns = InflatedBuffer(reflowStart, reflowEnd);
-            buffer_.erase(reflowStart, buffer_.end());
+            buffer.erase(reflowStart, buffer.end());
             assert(columnsUsed() == _newColumnCount);
 #if 0
                 if (removedColumns.size() > 0 &&
@@ -56,7 +63,7 @@ typename Line<Cell, Optimize>::InflatedBuffer Line<Cell, Optimize>::reflow(Colum
         }
         else
         {
-            buffer_.resize(unbox<size_t>(_newColumnCount));
+            buffer.resize(unbox<size_t>(_newColumnCount));
             assert(columnsUsed() == _newColumnCount);
             return {};
         }
@@ -69,14 +76,29 @@ template <typename Cell, bool Optimize>
 inline void Line<Cell, Optimize>::resize(ColumnCount _count)
 {
     assert(*_count >= 0);
-    buffer_.resize(unbox<size_t>(_count));
+
+    markModified();
+
+    if (isTrivialBuffer())
+    {
+        // Growing (or shrinking above the text length) only needs a width update;
+        // the padding is materialized on inflation.
+        if (trivialBuffer().text.size() <= unbox<size_t>(_count))
+        {
+            trivialBuffer().width = _count;
+            return;
+        }
+    }
+
+    inflatedBuffer().resize(unbox<size_t>(_count));
 }
 
 template <typename Cell, bool Optimize>
 gsl::span<Cell const> Line<Cell, Optimize>::trim_blank_right() const noexcept
 {
-    auto i = buffer_.data();
-    auto e = buffer_.data() + buffer_.size();
+    auto& buffer = inflatedBuffer();
+    auto i = buffer.data();
+    auto e = buffer.data() + buffer.size();
 
     while (i != e && (e - 1)->empty())
         --e;
@@ -87,8 +109,17 @@ gsl::span<Cell const> Line<Cell, Optimize>::trim_blank_right() const noexcept
 template <typename Cell, bool Optimize>
 std::string Line<Cell, Optimize>::toUtf8() const
 {
+    if (isTrivialBuffer())
+    {
+        auto const& lineBuffer = trivialBuffer();
+        auto str = lineBuffer.text;
+        for (auto i = str.size(); i < unbox<size_t>(lineBuffer.width); ++i)
+            str += ' ';
+        return str;
+    }
+
     std::string str;
-    for (Cell const& cell: buffer_)
+    for (Cell const& cell: inflatedBuffer())
     {
         if (cell.codepointCount() == 0)
             str += ' ';
@@ -107,6 +138,128 @@ std::string Line<Cell, Optimize>::toUtf8Trimmed() const
     return output;
 }
 
+template <typename Cell, bool Optimize>
+bool Line<Cell, Optimize>::compress(LineBufferPool<Cell>& _pool)
+{
+    if (isTrivialBuffer())
+        return true;
+
+    auto& buffer = get<InflatedBuffer>(storage_);
+    auto simple = deflate<Cell>(buffer);
+    if (!simple)
+        return false;
+
+    // Deliberately not marking this line as modified. The content is identical,
+    // it is merely re-encoded, so render damage tracking must not re-trigger.
+    _pool.retire(std::move(buffer));
+    storage_ = std::move(*simple);
+    return true;
+}
+
+template <typename Cell, bool Optimize>
+LineDigest Line<Cell, Optimize>::digest() const noexcept
+{
+    auto const columns = std::max(size_t { 1 }, unbox<size_t>(size()));
+
+    // Trivial lines are digested from their compact text form, so digesting
+    // the scrollback (where compress() made most lines trivial) never
+    // inflates anything.
+    if (isTrivialBuffer())
+    {
+        auto const& simple = trivialBuffer();
+        auto nonBlank = size_t { 0 };
+        for (char const ch: simple.text)
+            if (ch != ' ')
+                ++nonBlank;
+        return LineDigest { simple.attributes.foregroundColor,
+                            simple.attributes.backgroundColor,
+                            static_cast<uint8_t>(255 * nonBlank / columns) };
+    }
+
+    // One linear scan: content density plus a Boyer-Moore majority vote for
+    // the dominant colors. The vote is approximate for lines without an
+    // absolute color majority, which is perfectly fine at minimap resolution.
+    auto digest = LineDigest {};
+    auto nonBlank = size_t { 0 };
+    auto fgVotes = 0;
+    auto bgVotes = 0;
+    for (Cell const& cell: std::get<InflatedBuffer>(storage_))
+    {
+        if (cell.backgroundColor() == digest.backgroundColor)
+            ++bgVotes;
+        else if (--bgVotes < 0)
+        {
+            digest.backgroundColor = cell.backgroundColor();
+            bgVotes = 1;
+        }
+
+        if (cell.empty())
+            continue;
+        ++nonBlank;
+
+        if (cell.foregroundColor() == digest.foregroundColor)
+            ++fgVotes;
+        else if (--fgVotes < 0)
+        {
+            digest.foregroundColor = cell.foregroundColor();
+            fgVotes = 1;
+        }
+    }
+    digest.density = static_cast<uint8_t>(255 * nonBlank / columns);
+    return digest;
+}
+
+template <typename Cell, bool Optimize>
+uint64_t Line<Cell, Optimize>::contentHash() const noexcept
+{
+    if (cachedContentHashGeneration_ == generation_)
+        return cachedContentHash_;
+
+    auto const fnv = crispy::FNV<uint32_t, uint64_t> {};
+    auto hash = fnv(static_cast<uint32_t>(flags_));
+
+    // Trivial lines hash their compact text form directly; inflated lines
+    // take one linear scan over their cells. Neither path allocates. The two
+    // storage forms deliberately hash differently: a form change between two
+    // frames then compares unequal, which merely costs one suppressible
+    // repaint instead of risking a missed one.
+    if (isTrivialBuffer())
+    {
+        auto const& simple = trivialBuffer();
+        hash = fnv(hash, simple.attributes.foregroundColor.content);
+        hash = fnv(hash, simple.attributes.backgroundColor.content);
+        hash = fnv(hash, simple.attributes.underlineColor.content);
+        hash = fnv(hash, static_cast<uint32_t>(simple.attributes.styles));
+        hash = fnv(hash, unbox<uint32_t>(simple.width));
+        for (char const ch: simple.text)
+            hash = fnv(hash, static_cast<uint32_t>(static_cast<uint8_t>(ch)));
+    }
+    else
+    {
+        for (Cell const& cell: std::get<InflatedBuffer>(storage_))
+        {
+            hash = fnv(hash, cell.foregroundColor().content);
+            hash = fnv(hash, cell.backgroundColor().content);
+            hash = fnv(hash, cell.underlineColor().content);
+            hash = fnv(hash, static_cast<uint32_t>(cell.styles()));
+            hash = fnv(hash, static_cast<uint32_t>(cell.width()));
+            hash = fnv(hash, unbox<uint32_t>(cell.hyperlink()));
+            hash = fnv(hash, static_cast<uint32_t>(cell.codepointCount()));
+            for (size_t i = 0; i < cell.codepointCount(); ++i)
+                hash = fnv(hash, static_cast<uint32_t>(cell.codepoint(i)));
+            // Image fragments render by identity, so their pointer value
+            // participates (replacing an image must not be suppressed).
+            auto const fragment = reinterpret_cast<uintptr_t>(cell.imageFragment().get());
+            hash = fnv(hash, static_cast<uint32_t>(fragment));
+            hash = fnv(hash, static_cast<uint32_t>(uint64_t(fragment) >> 32));
+        }
+    }
+
+    cachedContentHash_ = hash;
+    cachedContentHashGeneration_ = generation_;
+    return hash;
+}
+
 template <typename Cell>
 InflatedLineBuffer<Cell> inflate(SimpleLineBuffer const& input)
 {
@@ -131,10 +284,10 @@ InflatedLineBuffer<Cell> inflate(SimpleLineBuffer const& input)
             lastChar < 128 && nextChar < 128; // NB: This is an optimization for US-ASCII text versus grapheme
                                               // cluster segmentation.
 
-        if (!lastChar || isAsciiBreakable || unicode::grapheme_segmenter::breakable(lastChar, nextChar))
+        if (!lastChar || isAsciiBreakable || graphemeBreakable(lastChar, nextChar))
         {
             columns.emplace_back(Cell {});
-            columns.back().write(input.attributes, nextChar, static_cast<uint8_t>(unicode::width(nextChar)));
+            columns.back().write(input.attributes, nextChar, codepointWidth(nextChar));
         }
         else
         {
@@ -156,6 +309,56 @@ InflatedLineBuffer<Cell> inflate(SimpleLineBuffer const& input)
     return columns;
 }
 
+template <typename Cell>
+optional<SimpleLineBuffer> deflate(InflatedLineBuffer<Cell> const& input)
+{
+    if (input.empty())
+        return nullopt;
+
+    auto const attributes = input.front().attributes();
+    auto text = std::string {};
+
+    size_t i = 0;
+    while (i < input.size())
+    {
+        Cell const& cell = input[i];
+        if (cell.attributes() != attributes || !!cell.hyperlink() || cell.imageFragment())
+            return nullopt;
+
+        // Blank cells may only pad the end of the line;
+        // anything after them is checked by the tail loop below.
+        if (cell.codepointCount() == 0)
+            break;
+
+        // The compact form stores one byte per column, and every trivial-line
+        // consumer (rendering, search, selection, text extraction) equates
+        // byte offsets with column offsets. Hence only printable US-ASCII
+        // runs - exactly what writeText()'s fast path produces - may deflate.
+        if (cell.codepointCount() != 1 || cell.width() != 1)
+            return nullopt;
+        auto const ch = cell.codepoint(0);
+        if (ch < 0x20 || ch >= 0x7F)
+            return nullopt;
+
+        text += static_cast<char>(ch);
+        ++i;
+    }
+
+    // Remaining cells must match the blank padding that inflate() appends.
+    for (; i < input.size(); ++i)
+    {
+        Cell const& cell = input[i];
+        if (cell.codepointCount() != 0 || cell.attributes() != attributes || !!cell.hyperlink()
+            || cell.imageFragment())
+            return nullopt;
+    }
+
+    return SimpleLineBuffer { attributes, std::move(text), ColumnCount::cast_from(input.size()) };
+}
+
+template InflatedLineBuffer<Cell> inflate<Cell>(SimpleLineBuffer const& input);
+template optional<SimpleLineBuffer> deflate<Cell>(InflatedLineBuffer<Cell> const& input);
+
 template class Line<Cell, true>;
 template class Line<Cell, false>;
 
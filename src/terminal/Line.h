@@ -22,9 +22,12 @@
 #include <gsl/span>
 #include <gsl/span_ext>
 
+#include <atomic>
 #include <iterator>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <variant>
 #include <vector>
 
 namespace terminal
@@ -55,6 +58,8 @@ struct OptionalProperty<T, true>
 struct SimpleLineBuffer
 {
     GraphicsAttributes attributes;
+    /// Printable US-ASCII only (one byte per column); consumers index this
+    /// by column offset. Enforced by writeText()'s fast path and deflate().
     std::string text;  // TODO: Try std::string_view later to avoid scattered copies.
     ColumnCount width; // page display width
 };
@@ -65,9 +70,99 @@ using InflatedLineBuffer = std::vector<Cell>;
 template <typename Cell>
 InflatedLineBuffer<Cell> inflate(SimpleLineBuffer const& input);
 
+/// Attempts to construct the compact text form from an inflated cell buffer,
+/// i.e. the inverse of inflate().
+///
+/// Returns std::nullopt unless re-inflating the result would reproduce
+/// @p input exactly.
+template <typename Cell>
+std::optional<SimpleLineBuffer> deflate(InflatedLineBuffer<Cell> const& input);
+
 template <typename Cell>
 using LineStorage = std::variant<SimpleLineBuffer, InflatedLineBuffer<Cell>>;
 
+/// O(1) recycling pool for retired InflatedLineBuffer storage.
+///
+/// One instance lives per Grid, so that resize, reflow and scrollback rotation
+/// re-use previously freed cell buffers instead of producing allocator traffic.
+template <typename Cell>
+class LineBufferPool
+{
+  public:
+    /// Retained-buffer watermarks: retire() accepts buffers up to the high
+    /// watermark; once it is reached, the pool is trimmed back down to the
+    /// low watermark in one bulk pass. The slack in between turns the
+    /// steady per-line free of a hard cap into a rare amortized batch
+    /// release - measurable on long `cat`s with bounded history, where
+    /// every scrolled-out line retires a buffer.
+    static constexpr size_t LowWatermark = 4096;
+    static constexpr size_t HighWatermark = 6144;
+
+    struct Stats
+    {
+        uint64_t acquires = 0; //!< number of buffer acquisitions
+        uint64_t reuses = 0;   //!< acquisitions served from the pool
+        uint64_t retires = 0;  //!< number of buffers handed back
+        uint64_t discards = 0; //!< retired buffers freed by watermark trimming
+    };
+
+    /// Acquires a cell buffer of @p _width cells initialized with @p _template,
+    /// re-using retired storage if available.
+    InflatedLineBuffer<Cell> acquire(ColumnCount _width, Cell _template = {})
+    {
+        ++stats_.acquires;
+        if (pool_.empty())
+            return InflatedLineBuffer<Cell>(unbox<size_t>(_width), _template);
+
+        ++stats_.reuses;
+        auto buffer = std::move(pool_.back());
+        pool_.pop_back();
+        buffer.clear();
+        buffer.resize(unbox<size_t>(_width), _template);
+        return buffer;
+    }
+
+    /// Retires a no longer used cell buffer for later re-use.
+    void retire(InflatedLineBuffer<Cell>&& _buffer)
+    {
+        ++stats_.retires;
+        pool_.emplace_back(std::move(_buffer));
+        if (pool_.size() >= HighWatermark)
+            releaseExcess();
+    }
+
+    /// Frees the slack above the low watermark in one bulk pass.
+    void releaseExcess()
+    {
+        if (pool_.size() <= LowWatermark)
+            return;
+        stats_.discards += pool_.size() - LowWatermark;
+        pool_.resize(LowWatermark);
+    }
+
+    Stats const& stats() const noexcept { return stats_; }
+    size_t size() const noexcept { return pool_.size(); }
+    void clear() { pool_.clear(); }
+
+  private:
+    std::vector<InflatedLineBuffer<Cell>> pool_;
+    Stats stats_ {};
+};
+
+/// Compact per-line summary for minimap / scrollbar style rendering:
+/// the line's dominant colors plus its content density.
+///
+/// One digest per line is cheap enough to extract for the whole scrollback
+/// every frame and to upload as a tiny one-texel-per-line texture, without
+/// ever touching full cell data (see Line::digest()). Doubles as the data
+/// source for search-match markers on the scrollbar.
+struct LineDigest
+{
+    Color foregroundColor = DefaultColor();
+    Color backgroundColor = DefaultColor();
+    uint8_t density = 0; //!< 0..255: fraction of columns holding non-blank content.
+};
+
 /**
  * Line<Cell> API.
  *
@@ -92,18 +187,24 @@ class Line
     using const_iterator = typename InflatedBuffer::const_iterator;
 
     Line(ColumnCount _width, LineFlags _flags, Cell _template = {}):
-        buffer_(_width.as<size_t>(), _template /*, _allocator*/), flags_ { static_cast<unsigned>(_flags) }
+        storage_ { InflatedBuffer(_width.as<size_t>(), _template /*, _allocator*/) },
+        flags_ { static_cast<unsigned>(_flags) }
     {
     }
 
     Line(ColumnCount _width, InflatedBuffer _buffer, LineFlags _flags):
-        buffer_ { std::move(_buffer) }, flags_ { static_cast<unsigned>(_flags) }
+        storage_ { std::move(_buffer) }, flags_ { static_cast<unsigned>(_flags) }
     {
-        buffer_.resize(unbox<size_t>(_width));
+        std::get<InflatedBuffer>(storage_).resize(unbox<size_t>(_width));
     }
 
     Line(InflatedBuffer _buffer, LineFlags _flags):
-        buffer_ { std::move(_buffer) }, flags_ { static_cast<unsigned>(_flags) }
+        storage_ { std::move(_buffer) }, flags_ { static_cast<unsigned>(_flags) }
+    {
+    }
+
+    Line(SimpleLineBuffer _buffer, LineFlags _flags):
+        storage_ { std::move(_buffer) }, flags_ { static_cast<unsigned>(_flags) }
     {
     }
 
@@ -112,29 +213,24 @@ class Line
     // This is experimental (aka. buggy) and going to be replaced with another optimization idea soon.
     //#define LINE_AVOID_CELL_RESET 1
 
-    void reset(LineFlags _flags,
-               GraphicsAttributes _attributes) noexcept // TODO: optimize by having no need to O(n) iterate
-                                                        // through all buffer cells.
+    void reset(LineFlags _flags, GraphicsAttributes _attributes)
     {
+        markModified();
         flags_ = static_cast<unsigned>(_flags);
 
-        // if constexpr (ColumnOptimized)
-        // {
-        //     #if !defined(LINE_AVOID_CELL_RESET)
-        //     if (buffer_.back().backgroundColor() != _attributes.backgroundColor)
-        //         // TODO: also styles and UL color
-        //         markUsedFirst(ColumnCount::cast_from(buffer_.size()));
-        //
-        //     for (auto i = 0; i < *columnsUsed(); ++i)
-        //         buffer_[i].reset(_attributes);
-        //     #endif
-        //     markUsedFirst(ColumnCount(0));
-        // }
-        // else
-        {
-            for (Cell& cell: buffer_)
-                cell.reset(_attributes);
-        }
+        // A reset line is the prime candidate for the compact storage form:
+        // it demotes back to a SimpleLineBuffer and only inflates again when
+        // per-cell access is actually required.
+        storage_ = SimpleLineBuffer { _attributes, {}, size() };
+    }
+
+    /// Like reset(LineFlags, GraphicsAttributes), but hands any inflated cell
+    /// storage over to @p _pool for O(1) recycling instead of freeing it.
+    void reset(LineFlags _flags, GraphicsAttributes _attributes, LineBufferPool<Cell>& _pool)
+    {
+        if (std::holds_alternative<InflatedBuffer>(storage_))
+            _pool.retire(std::move(std::get<InflatedBuffer>(storage_)));
+        reset(_flags, _attributes);
     }
 
     void markUsedFirst(ColumnCount /*_n*/) noexcept
@@ -143,14 +239,11 @@ class Line
         //     usedColumns_.value = _n;
     }
 
-    void reset(LineFlags _flags,
-               GraphicsAttributes const& _attributes,
-               char32_t _codepoint,
-               uint8_t _width) noexcept
+    void reset(LineFlags _flags, GraphicsAttributes const& _attributes, char32_t _codepoint, uint8_t _width)
     {
         flags_ = static_cast<unsigned>(_flags);
         markUsedFirst(size());
-        for (Cell& cell: buffer_)
+        for (Cell& cell: editable())
         {
             cell.reset();
             cell.write(_attributes, _codepoint, _width);
@@ -173,7 +266,7 @@ class Line
         auto constexpr ASCII_Width = 1;
         auto const* s = _ascii.data();
 
-        Cell* i = &buffer_[unbox<size_t>(_start)];
+        Cell* i = &buffer[unbox<size_t>(_start)];
         Cell* e = i + _ascii.size();
         while (i != e)
             (i++)->write(_sgr, static_cast<char32_t>(*s++), ASCII_Width);
@@ -195,7 +288,12 @@ class Line
         }
     }
 
-    ColumnCount size() const noexcept { return ColumnCount::cast_from(buffer_.size()); }
+    ColumnCount size() const noexcept
+    {
+        if (std::holds_alternative<SimpleLineBuffer>(storage_))
+            return std::get<SimpleLineBuffer>(storage_).width;
+        return ColumnCount::cast_from(std::get<InflatedBuffer>(storage_).size());
+    }
 
     ColumnCount columnsUsed() const noexcept
     {
@@ -209,47 +307,54 @@ class Line
 
     gsl::span<Cell const> trim_blank_right() const noexcept;
 
-    gsl::span<Cell const> cells() const noexcept { return buffer_; }
+    gsl::span<Cell const> cells() const noexcept { return inflatedBuffer(); }
 
     gsl::span<Cell> useRange(ColumnOffset _start, ColumnCount _count) noexcept
     {
+        markModified();
         markUsedFirst(std::max(columnsUsed(), boxed_cast<ColumnCount>(_start) + _count));
 #if defined(__FreeBSD__)
-        auto const bufferSpan = gsl::span(buffer_);
+        auto const bufferSpan = gsl::span(inflatedBuffer());
         return bufferSpan.subspan(unbox<size_t>(_start), unbox<size_t>(_count));
 #else
         // NOTE: On FreeBSD the line below does not compile.
-        return gsl::span(buffer_).subspan(unbox<size_t>(_start), unbox<size_t>(_count));
+        return gsl::span(inflatedBuffer()).subspan(unbox<size_t>(_start), unbox<size_t>(_count));
 #endif
     }
 
-    iterator begin() noexcept { return buffer_.begin(); }
-    iterator end() noexcept { return std::next(std::begin(buffer_), unbox<int>(columnsUsed())); }
+    iterator begin() noexcept { return inflatedBuffer().begin(); }
+    iterator end() noexcept { return std::next(inflatedBuffer().begin(), unbox<int>(columnsUsed())); }
 
-    const_iterator begin() const noexcept { return buffer_.begin(); }
-    const_iterator end() const noexcept { return std::next(buffer_.begin(), unbox<int>(columnsUsed())); }
+    const_iterator begin() const noexcept { return inflatedBuffer().begin(); }
+    const_iterator end() const noexcept
+    {
+        return std::next(inflatedBuffer().begin(), unbox<int>(columnsUsed()));
+    }
 
-    reverse_iterator rbegin() noexcept { return buffer_.rbegin(); }
-    reverse_iterator rend() noexcept { return buffer_.rend(); }
+    reverse_iterator rbegin() noexcept { return inflatedBuffer().rbegin(); }
+    reverse_iterator rend() noexcept { return inflatedBuffer().rend(); }
 
-    Cell& front() noexcept { return buffer_.front(); }
-    Cell const& front() const noexcept { return buffer_.front(); }
+    Cell& front() noexcept { return inflatedBuffer().front(); }
+    Cell const& front() const noexcept { return inflatedBuffer().front(); }
 
-    Cell& back() noexcept { return *std::next(buffer_.begin(), unbox<int>(columnsUsed() - 1)); }
-    Cell const& back() const noexcept { return *std::next(buffer_.begin(), unbox<int>(columnsUsed() - 1)); }
+    Cell& back() noexcept { return *std::next(inflatedBuffer().begin(), unbox<int>(columnsUsed() - 1)); }
+    Cell const& back() const noexcept
+    {
+        return *std::next(inflatedBuffer().begin(), unbox<int>(columnsUsed() - 1));
+    }
 
     Cell& useCellAt(ColumnOffset _column) noexcept
     {
         Require(ColumnOffset(0) <= _column);
-        Require(_column <= ColumnOffset::cast_from(buffer_.size())); // Allow off-by-one for sentinel.
+        Require(_column <= ColumnOffset::cast_from(size())); // Allow off-by-one for sentinel.
         return editable()[unbox<size_t>(_column)];
     }
 
     Cell const& at(ColumnOffset _column) const noexcept
     {
         Require(ColumnOffset(0) <= _column);
-        Require(_column <= ColumnOffset::cast_from(buffer_.size())); // Allow off-by-one for sentinel.
-        return buffer_[unbox<size_t>(_column)];
+        Require(_column <= ColumnOffset::cast_from(size())); // Allow off-by-one for sentinel.
+        return inflatedBuffer()[unbox<size_t>(_column)];
     }
 
     LineFlags flags() const noexcept { return static_cast<LineFlags>(flags_); }
@@ -290,15 +395,100 @@ class Line
     std::string toUtf8() const;
     std::string toUtf8Trimmed() const;
 
+    /// Returns this line's modification generation.
+    ///
+    /// The generation is refreshed from a global monotonic counter on every
+    /// (potentially) mutating access, so the render buffer refresh can cheaply
+    /// detect lines that did not change since the previously composed frame.
+    uint64_t generation() const noexcept { return generation_; }
+
+    /// Marks this line as modified with respect to render damage tracking.
+    void markModified() noexcept { generation_ = nextGeneration(); }
+
     // Returns a reference to this mutable grid-line buffer.
     //
     // If this line has been stored in an optimized state, then
     // the line will be first unpacked into a vector of grid cells.
-    InflatedBuffer& editable();
+    InflatedBuffer& editable()
+    {
+        markModified();
+        return inflatedBuffer();
+    }
+
+    /// Returns true iff this line is stored in the compact (trivial) text form,
+    /// i.e. a single-SGR run of text without any materialized Cells.
+    bool isTrivialBuffer() const noexcept { return std::holds_alternative<SimpleLineBuffer>(storage_); }
+
+    /// Number of heap bytes currently held by this line's storage, for
+    /// statistics accounting (see Grid::memoryUsage()).
+    std::size_t memoryUsage() const noexcept
+    {
+        if (std::holds_alternative<SimpleLineBuffer>(storage_))
+            return std::get<SimpleLineBuffer>(storage_).text.capacity();
+        return std::get<InflatedBuffer>(storage_).capacity() * sizeof(Cell);
+    }
+
+    /// Attempts to demote this line's storage back into the compact text form,
+    /// handing the inflated cell storage over to @p _pool on success.
+    ///
+    /// This serves as cold-storage compression for lines moving from the active
+    /// page into the scrollback, where the vast majority of lines is plain
+    /// single-SGR text. Any access through inflatedBuffer() transparently
+    /// inflates the line again.
+    ///
+    /// @returns boolean indicating whether or not this line is now stored compactly.
+    bool compress(LineBufferPool<Cell>& _pool);
+
+    /// Computes this line's minimap digest.
+    ///
+    /// Trivial lines are digested from their compact text form without being
+    /// inflated; inflated lines take one allocation-free linear scan over
+    /// their cells (Boyer-Moore majority vote for the dominant colors).
+    LineDigest digest() const noexcept;
+
+    /// Computes a hash over this line's rendered content (text, SGR, flags),
+    /// cached per modification generation.
+    ///
+    /// Matching hashes mean (collisions aside) identical rendering even when
+    /// the modification generations differ, which the render buffer refresh
+    /// uses to recognize lines that were rewritten with unchanged content -
+    /// shells redrawing their prompt line on every keystroke being the
+    /// common case - and keep them out of the damage set.
+    uint64_t contentHash() const noexcept;
+
+    SimpleLineBuffer& trivialBuffer() noexcept { return std::get<SimpleLineBuffer>(storage_); }
+    SimpleLineBuffer const& trivialBuffer() const noexcept { return std::get<SimpleLineBuffer>(storage_); }
+
+    /// Appends a run of US-ASCII text to a trivial line.
+    ///
+    /// The caller is responsible for ensuring that this line is trivial, that the
+    /// run's SGR matches the line's attributes and that the run fits into the line.
+    void appendTrivialText(std::string_view _text)
+    {
+        markModified();
+        trivialBuffer().text += _text;
+    }
+
+    /// Returns the grid cell buffer, inflating the compact text form on demand.
+    InflatedBuffer& inflatedBuffer();
+    InflatedBuffer const& inflatedBuffer() const
+    {
+        return const_cast<Line<Cell, Optimize>*>(this)->inflatedBuffer();
+    }
 
   private:
-    InflatedBuffer buffer_;
+    static uint64_t nextGeneration() noexcept
+    {
+        static std::atomic<uint64_t> counter { 0 };
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
     Storage storage_;
+    uint64_t generation_ = 0;
+    // contentHash() cache, keyed by the modification generation it was
+    // computed at (all-ones meaning: never computed).
+    mutable uint64_t cachedContentHash_ = 0;
+    mutable uint64_t cachedContentHashGeneration_ = ~uint64_t(0);
     unsigned flags_ = 0;
     // OptionalProperty<ColumnCount, ColumnOptimized> usedColumns_;
 };
@@ -319,19 +509,12 @@ constexpr LineFlags operator&(LineFlags a, LineFlags b) noexcept
 }
 
 template <typename Cell, bool Optimize>
-inline typename Line<Cell, Optimize>::InflatedBuffer& Line<Cell, Optimize>::editable()
+inline typename Line<Cell, Optimize>::InflatedBuffer& Line<Cell, Optimize>::inflatedBuffer()
 {
-    // TODO: when we impement the line text buffer optimization,
-    // then this is the place where we want to *promote* a possibly
-    // optimized text buffer to a full grid line buffer.
-#if 0
     if (std::holds_alternative<SimpleLineBuffer>(storage_))
         storage_ = inflate<Cell>(std::get<SimpleLineBuffer>(storage_));
 
     return std::get<InflatedBuffer>(storage_);
-#else
-    return buffer_;
-#endif
 }
 
 } // namespace terminal
@@ -16,8 +16,10 @@
 #include <terminal/Sequencer.h> // Sequence
 
 #include <algorithm>
+#include <chrono>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace terminal
 {
@@ -48,4 +50,34 @@ struct Metrics
     }
 };
 
+/// Collects end-to-end input-to-present latency samples and reports
+/// percentiles over them.
+///
+/// Fed by the latency probe machinery (see Terminal::injectLatencyProbe()):
+/// each sample spans from probe injection into the PTY until the frame
+/// carrying the echoed probe was handed over for scanout.
+struct LatencyStatistics
+{
+    using Duration = std::chrono::steady_clock::duration;
+
+    std::vector<Duration> samples;
+
+    void add(Duration _sample) { samples.push_back(_sample); }
+
+    size_t count() const noexcept { return samples.size(); }
+
+    /// @returns the given percentile (0..100) over all collected samples,
+    ///          or a zero duration if none were collected yet.
+    Duration percentile(double _p) const
+    {
+        if (samples.empty())
+            return Duration::zero();
+        auto sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        auto const rank =
+            static_cast<size_t>(_p / 100.0 * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(rank, sorted.size() - 1)];
+    }
+};
+
 } // namespace terminal
@@ -30,8 +30,12 @@ class MockTerm: public MockScreenEvents
     TerminalState<MockTerm>& state() noexcept { return state_; }
     TerminalState<MockTerm> const& state() const noexcept { return state_; }
 
+    /// Records reflected latency probe ids (see Terminal::injectLatencyProbe()).
+    void latencyProbeReflected(uint64_t _id) { reflectedLatencyProbes.push_back(_id); }
+
     TerminalState<MockTerm> state_;
     Screen<MockTerm> primaryScreen_;
+    std::vector<uint64_t> reflectedLatencyProbes;
 };
 
 } // namespace terminal
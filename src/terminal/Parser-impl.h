@@ -14,11 +14,15 @@
 #pragma once
 
 #include <terminal/Parser.h>
+#include <terminal/logging.h>
 
+#include <crispy/PerfCounters.h>
 #include <crispy/assert.h>
 
-#if defined(__SSE2__)
+#if defined(__AVX2__) || defined(__SSE2__)
     #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
 #endif
 
 namespace terminal::parser
@@ -43,9 +47,26 @@ namespace detail
 
         auto input = _begin;
 
-#if 0 // TODO: defined(__AVX2__)
-      // AVX2 to be implemented directly in NASM file.
+#if defined(__AVX2__)
+        __m256i const ControlCodeMax = _mm256_set1_epi8(0x20); // 0..0x1F
+        __m256i const Complex = _mm256_set1_epi8(static_cast<char>(0x80));
 
+        while (input < _end - sizeof(__m256i))
+        {
+            __m256i batch = _mm256_loadu_si256((__m256i const*) input);
+            __m256i isControl = _mm256_cmpgt_epi8(ControlCodeMax, batch);
+            __m256i isComplex = _mm256_and_si256(batch, Complex);
+            __m256i testPack = _mm256_or_si256(isControl, isComplex);
+            if (unsigned const check = static_cast<unsigned>(_mm256_movemask_epi8(testPack)); check != 0)
+            {
+                int advance = countTrailingZeroBits(check);
+                input += advance;
+                break;
+            }
+            input += 32;
+        }
+
+        return static_cast<size_t>(std::distance(_begin, input));
 #elif defined(__SSE2__)
         __m128i const ControlCodeMax = _mm_set1_epi8(0x20); // 0..0x1F
         __m128i const Complex = _mm_set1_epi8(static_cast<char>(0x80));
@@ -71,9 +92,285 @@ namespace detail
         // while (input != _end && *input >= 0x20 && (*input & 0x80) == 0)
         //     ++input;
 
+        return static_cast<size_t>(std::distance(_begin, input));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        uint8x16_t const ControlCodeMax = vdupq_n_u8(0x20); // 0..0x1F
+        uint8x16_t const Complex = vdupq_n_u8(0x80);
+
+        while (input < _end - sizeof(uint8x16_t))
+        {
+            uint8x16_t batch = vld1q_u8((uint8_t const*) input);
+            uint8x16_t isControl = vcltq_u8(batch, ControlCodeMax);
+            uint8x16_t isComplex = vcgeq_u8(batch, Complex);
+            uint8x16_t testPack = vorrq_u8(isControl, isComplex);
+            // NEON has no movemask; a horizontal max suffices to detect any set lane.
+            if (vmaxvq_u8(testPack) != 0)
+            {
+                while (input != _end && *input >= 0x20 && (*input & 0x80) == 0)
+                    ++input;
+                break;
+            }
+            input += 16;
+        }
+
         return static_cast<size_t>(std::distance(_begin, input));
 #else
-        return 0;
+        while (input != _end && *input >= 0x20 && (*input & 0x80) == 0)
+            ++input;
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#endif
+    }
+
+    /// Counts the number of bytes until the first C0 control character.
+    ///
+    /// In Ground state every byte in 0x20..0xFF maps to the Print action, so a whole
+    /// printable run - including UTF-8 lead and continuation bytes - can be handed to
+    /// ParserEvents::print(std::string_view) in one call and decoded there in bulk.
+    inline size_t countPrintableTextChars(char const* _begin, char const* _end) noexcept
+    {
+        auto input = _begin;
+
+#if defined(__AVX2__)
+        __m256i const C0Max = _mm256_set1_epi8(0x1F);
+
+        while (input < _end - sizeof(__m256i))
+        {
+            __m256i batch = _mm256_loadu_si256((__m256i const*) input);
+            // unsigned (batch <= 0x1F) via min/compare-equal
+            __m256i isC0 = _mm256_cmpeq_epi8(_mm256_min_epu8(batch, C0Max), batch);
+            if (unsigned const check = static_cast<unsigned>(_mm256_movemask_epi8(isC0)); check != 0)
+            {
+                int advance = countTrailingZeroBits(check);
+                input += advance;
+                break;
+            }
+            input += 32;
+        }
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#elif defined(__SSE2__)
+        __m128i const C0Max = _mm_set1_epi8(0x1F);
+
+        while (input < _end - sizeof(__m128i))
+        {
+            __m128i batch = _mm_loadu_si128((__m128i*) input);
+            // unsigned (batch <= 0x1F) via min/compare-equal
+            __m128i isC0 = _mm_cmpeq_epi8(_mm_min_epu8(batch, C0Max), batch);
+            if (int const check = _mm_movemask_epi8(isC0); check != 0)
+            {
+                int advance = countTrailingZeroBits(static_cast<unsigned>(check));
+                input += advance;
+                break;
+            }
+            input += 16;
+        }
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        uint8x16_t const C0Max = vdupq_n_u8(0x20);
+
+        while (input < _end - sizeof(uint8x16_t))
+        {
+            uint8x16_t batch = vld1q_u8((uint8_t const*) input);
+            uint8x16_t isC0 = vcltq_u8(batch, C0Max);
+            if (vmaxvq_u8(isC0) != 0)
+            {
+                while (input != _end && static_cast<uint8_t>(*input) >= 0x20)
+                    ++input;
+                break;
+            }
+            input += 16;
+        }
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#else
+        while (input != _end && static_cast<uint8_t>(*input) >= 0x20)
+            ++input;
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#endif
+    }
+
+    /// Counts the number of APC/PM control string payload bytes.
+    ///
+    /// Stops at any C0 control (covering CAN, SUB, ESC, BEL and the bytes some
+    /// states treat as errors) and at the raw C1 ST terminator, so whole payload
+    /// runs can be forwarded to the listener - or dropped - in one call.
+    inline size_t countStringPayloadChars(char const* _begin, char const* _end) noexcept
+    {
+        auto input = _begin;
+
+#if defined(__AVX2__)
+        __m256i const C0Max = _mm256_set1_epi8(0x1F);
+        __m256i const ST = _mm256_set1_epi8(static_cast<char>(0x9C));
+
+        while (input < _end - sizeof(__m256i))
+        {
+            __m256i batch = _mm256_loadu_si256((__m256i const*) input);
+            // unsigned (batch <= 0x1F) via min/compare-equal
+            __m256i isC0 = _mm256_cmpeq_epi8(_mm256_min_epu8(batch, C0Max), batch);
+            __m256i isST = _mm256_cmpeq_epi8(batch, ST);
+            __m256i testPack = _mm256_or_si256(isC0, isST);
+            if (unsigned const check = static_cast<unsigned>(_mm256_movemask_epi8(testPack)); check != 0)
+            {
+                int advance = countTrailingZeroBits(check);
+                input += advance;
+                break;
+            }
+            input += 32;
+        }
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#elif defined(__SSE2__)
+        __m128i const C0Max = _mm_set1_epi8(0x1F);
+        __m128i const ST = _mm_set1_epi8(static_cast<char>(0x9C));
+
+        while (input < _end - sizeof(__m128i))
+        {
+            __m128i batch = _mm_loadu_si128((__m128i*) input);
+            // unsigned (batch <= 0x1F) via min/compare-equal
+            __m128i isC0 = _mm_cmpeq_epi8(_mm_min_epu8(batch, C0Max), batch);
+            __m128i isST = _mm_cmpeq_epi8(batch, ST);
+            __m128i testPack = _mm_or_si128(isC0, isST);
+            if (int const check = _mm_movemask_epi8(testPack); check != 0)
+            {
+                int advance = countTrailingZeroBits(static_cast<unsigned>(check));
+                input += advance;
+                break;
+            }
+            input += 16;
+        }
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        uint8x16_t const C0Max = vdupq_n_u8(0x20);
+        uint8x16_t const ST = vdupq_n_u8(0x9C);
+
+        while (input < _end - sizeof(uint8x16_t))
+        {
+            uint8x16_t batch = vld1q_u8((uint8_t const*) input);
+            uint8x16_t isC0 = vcltq_u8(batch, C0Max);
+            uint8x16_t isST = vceqq_u8(batch, ST);
+            uint8x16_t testPack = vorrq_u8(isC0, isST);
+            if (vmaxvq_u8(testPack) != 0)
+            {
+                while (input != _end && static_cast<uint8_t>(*input) >= 0x20
+                       && static_cast<uint8_t>(*input) != 0x9C)
+                    ++input;
+                break;
+            }
+            input += 16;
+        }
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#else
+        while (input != _end && static_cast<uint8_t>(*input) >= 0x20
+               && static_cast<uint8_t>(*input) != 0x9C)
+            ++input;
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#endif
+    }
+
+    /// Counts the number of DCS data string payload bytes.
+    ///
+    /// Unlike APC/PM strings, C0 controls are part of a DCS payload and must be
+    /// passed through; only CAN, SUB, ESC terminate (or the ignored DEL and the
+    /// raw C1 range, which includes the ST terminator), so whole payload runs
+    /// can be handed to the hooked sub-parser in one call.
+    inline size_t countDcsPayloadChars(char const* _begin, char const* _end) noexcept
+    {
+        auto const isPayload = [](uint8_t ch) noexcept {
+            return ch < 0x7F && ch != 0x18 && ch != 0x1A && ch != 0x1B;
+        };
+
+#if defined(__AVX2__)
+        auto input = _begin;
+        __m256i const Min7F = _mm256_set1_epi8(0x7F);
+        __m256i const CAN = _mm256_set1_epi8(0x18);
+        __m256i const SUB = _mm256_set1_epi8(0x1A);
+        __m256i const ESC = _mm256_set1_epi8(0x1B);
+
+        while (input < _end - sizeof(__m256i))
+        {
+            __m256i batch = _mm256_loadu_si256((__m256i const*) input);
+            // unsigned (batch >= 0x7F) via max/compare-equal
+            __m256i isHigh = _mm256_cmpeq_epi8(_mm256_max_epu8(batch, Min7F), batch);
+            __m256i isStop = _mm256_or_si256(_mm256_cmpeq_epi8(batch, CAN),
+                                             _mm256_or_si256(_mm256_cmpeq_epi8(batch, SUB),
+                                                             _mm256_cmpeq_epi8(batch, ESC)));
+            __m256i testPack = _mm256_or_si256(isHigh, isStop);
+            if (unsigned const check = static_cast<unsigned>(_mm256_movemask_epi8(testPack)); check != 0)
+            {
+                int advance = countTrailingZeroBits(check);
+                input += advance;
+                break;
+            }
+            input += 32;
+        }
+
+        while (input != _end && isPayload(static_cast<uint8_t>(*input)))
+            ++input;
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#elif defined(__SSE2__)
+        auto input = _begin;
+        __m128i const Min7F = _mm_set1_epi8(0x7F);
+        __m128i const CAN = _mm_set1_epi8(0x18);
+        __m128i const SUB = _mm_set1_epi8(0x1A);
+        __m128i const ESC = _mm_set1_epi8(0x1B);
+
+        while (input < _end - sizeof(__m128i))
+        {
+            __m128i batch = _mm_loadu_si128((__m128i*) input);
+            // unsigned (batch >= 0x7F) via max/compare-equal
+            __m128i isHigh = _mm_cmpeq_epi8(_mm_max_epu8(batch, Min7F), batch);
+            __m128i isStop = _mm_or_si128(
+                _mm_cmpeq_epi8(batch, CAN),
+                _mm_or_si128(_mm_cmpeq_epi8(batch, SUB), _mm_cmpeq_epi8(batch, ESC)));
+            __m128i testPack = _mm_or_si128(isHigh, isStop);
+            if (int const check = _mm_movemask_epi8(testPack); check != 0)
+            {
+                int advance = countTrailingZeroBits(static_cast<unsigned>(check));
+                input += advance;
+                break;
+            }
+            input += 16;
+        }
+
+        while (input != _end && isPayload(static_cast<uint8_t>(*input)))
+            ++input;
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+        auto input = _begin;
+        uint8x16_t const Min7F = vdupq_n_u8(0x7F);
+        uint8x16_t const CAN = vdupq_n_u8(0x18);
+        uint8x16_t const SUB = vdupq_n_u8(0x1A);
+        uint8x16_t const ESC = vdupq_n_u8(0x1B);
+
+        while (input < _end - sizeof(uint8x16_t))
+        {
+            uint8x16_t batch = vld1q_u8((uint8_t const*) input);
+            uint8x16_t isHigh = vcgeq_u8(batch, Min7F);
+            uint8x16_t isStop = vorrq_u8(vceqq_u8(batch, CAN), vorrq_u8(vceqq_u8(batch, SUB), vceqq_u8(batch, ESC)));
+            uint8x16_t testPack = vorrq_u8(isHigh, isStop);
+            if (vmaxvq_u8(testPack) != 0)
+                break;
+            input += 16;
+        }
+
+        while (input != _end && isPayload(static_cast<uint8_t>(*input)))
+            ++input;
+
+        return static_cast<size_t>(std::distance(_begin, input));
+#else
+        auto input = _begin;
+        while (input != _end && isPayload(static_cast<uint8_t>(*input)))
+            ++input;
+
+        return static_cast<size_t>(std::distance(_begin, input));
 #endif
     }
 
@@ -275,6 +572,13 @@ constexpr ParserTable ParserTable::get() // {{{
     return t;
 } // }}}
 
+/// The one standard parser table, fully evaluated at compile time.
+///
+/// Being an inline constexpr namespace-scope object, it lives in .rodata exactly once
+/// (shared across all Parser<> instantiations and, via the text segment, across
+/// processes) instead of being re-materialized per translation unit or instantiation.
+inline constexpr ParserTable StandardParserTable = ParserTable::get();
+
 namespace detail
 {
 
@@ -283,6 +587,8 @@ namespace detail
 template <typename EventListener>
 void Parser<EventListener>::parseFragment(std::string_view _data)
 {
+    CRISPY_PERF_SCOPE("vt.parseFragment");
+
     auto input = _data.data();              // reinterpret_cast<uint8_t const*>(_data.data());
     auto end = _data.data() + _data.size(); // reinterpret_cast<uint8_t const*>(_data.data() + _data.size());
 
@@ -290,27 +596,83 @@ void Parser<EventListener>::parseFragment(std::string_view _data)
     {
         if (state_ == State::Ground)
         {
-            if (auto count = detail::countAsciiTextChars(input, end); count > 0)
+            auto const printableCount = detail::countPrintableTextChars(input, end);
+            if (printableCount > 0)
+            {
+                eventListener_.print(std::string_view { input, printableCount });
+                input += printableCount;
+            }
+
+            // This optimization is for the `cat`-people.
+            // It further optimizes the throughput performance by bypassing
+            // the FSM for the `(TEXT LF+)+`-case, and batches runs of
+            // consecutive linefeeds into one call, so that linefeeding at
+            // the bottom margin collapses into a single multi-line scroll.
+            //
+            // As of bench-headless, the performance incrrease is about 50x.
+            auto lfCount = size_t { 0 };
+            while (input != end && *input == '\n')
             {
-                eventListener_.print(std::string_view { input, count });
-                input += count;
-
-                // This optimization is for the `cat`-people.
-                // It further optimizes the throughput performance by bypassing
-                // the FSM for the `(TEXT LF+)+`-case.
-                //
-                // As of bench-headless, the performance incrrease is about 50x.
-                if (input != end && *input == '\n')
+                ++input;
+                ++lfCount;
+            }
+            if (lfCount == 1)
+                eventListener_.execute('\n');
+            else if (lfCount > 1)
+                eventListener_.executeLinefeeds(lfCount);
+
+            // Likewise for TABs: TSV-style output interleaves text runs with
+            // tab hops, and batching them here keeps the Ground state zipping
+            // through `(TEXT (TAB | LF)+)+` without re-entering the FSM.
+            auto tabCount = size_t { 0 };
+            while (input != end && *input == '\t')
+            {
+                ++input;
+                ++tabCount;
+            }
+            if (tabCount == 1)
+                eventListener_.execute('\t');
+            else if (tabCount > 1)
+                eventListener_.executeTabs(tabCount);
+
+            if (printableCount > 0 || lfCount > 0 || tabCount > 0)
+                continue;
+        }
+        else if (state_ == State::OSC_String || state_ == State::APC_String || state_ == State::PM_String)
+        {
+            // Control strings can carry large payloads (e.g. kitty graphics
+            // protocol probes) that frequently have no consumer, and OSC
+            // title updates arrive in bursts. Forwarding whole runs in one
+            // call replaces per-byte FSM dispatch with a memory scan.
+            if (auto const payloadCount = detail::countStringPayloadChars(input, end); payloadCount > 0)
+            {
+                auto const payload = std::string_view { input, payloadCount };
+                switch (state_)
                 {
-                    eventListener_.execute(*input++);
+                case State::OSC_String: eventListener_.putOSC(payload); break;
+                case State::APC_String: eventListener_.putAPC(payload); break;
+                default: eventListener_.putPM(payload); break;
                 }
+                input += payloadCount;
+                continue;
+            }
+        }
+        else if (state_ == State::DCS_PassThrough)
+        {
+            // DCS-tunneled data (tmux passthrough, sixel image data) can be
+            // megabytes; handing whole runs to the hooked sub-parser straight
+            // from the input span avoids one virtual call per payload byte.
+            if (auto const payloadCount = detail::countDcsPayloadChars(input, end); payloadCount > 0)
+            {
+                eventListener_.put(std::string_view { input, payloadCount });
+                input += payloadCount;
                 continue;
             }
         }
 
         auto const ch = static_cast<uint8_t>(*input++);
         auto const s = static_cast<size_t>(state_);
-        ParserTable static constexpr table = ParserTable::get();
+        auto constexpr& table = StandardParserTable;
 
         if (auto const t = table.transitions[s][static_cast<uint8_t>(ch)]; t != State::Undefined)
         {
@@ -324,11 +686,21 @@ void Parser<EventListener>::parseFragment(std::string_view _data)
         else if (Action const a = table.events[s][ch]; a != Action::Undefined)
             handle(ActionClass::Event, a, ch);
         else
-            eventListener_.error(
-                fmt::format("Parser Error: Unknown action for state/input pair ({}, '{}' 0x{:02X})",
-                            state_,
-                            ch,
-                            static_cast<unsigned>(ch)));
+        {
+            // Tolerated garbage: always counted (see errorCount()), but the
+            // human-readable rendition is only produced when somebody is
+            // actually listening - and compiled out entirely in
+            // max-throughput builds.
+            ++errorCount_;
+#if !defined(CONTOUR_MAX_THROUGHPUT)
+            if (VTParserLog)
+                eventListener_.error(
+                    fmt::format("Parser Error: Unknown action for state/input pair ({}, '{}' 0x{:02X})",
+                                state_,
+                                ch,
+                                static_cast<unsigned>(ch)));
+#endif
+        }
     } while (input != end);
 }
 
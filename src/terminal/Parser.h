@@ -590,12 +590,18 @@ class Parser
 
     State state() const noexcept { return state_; }
 
+    /// Number of input bytes that hit no valid state transition and were
+    /// tolerated as garbage. Always counted, even when the human-readable
+    /// error reporting is disabled or compiled out.
+    uint64_t errorCount() const noexcept { return errorCount_; }
+
   private:
     void handle(ActionClass _actionClass, Action _action, char _char);
 
     // private properties
     //
     State state_ = State::Ground;
+    uint64_t errorCount_ = 0;
     EventListener& eventListener_;
 };
 
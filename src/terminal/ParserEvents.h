@@ -13,6 +13,8 @@
  */
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 
 namespace terminal
@@ -51,6 +53,16 @@ class ParserEvents
      */
     virtual void execute(char _controlCode) = 0;
 
+    /// Optimization that passes a run of consecutive linefeed control
+    /// characters in one call, so the listener can batch the resulting
+    /// cursor movement and scrolling.
+    virtual void executeLinefeeds(size_t _count) = 0;
+
+    /// Optimization that passes a run of consecutive TAB control characters
+    /// in one call, so the listener can batch the tab stop hops (think
+    /// TSV-formatted output).
+    virtual void executeTabs(size_t _count) = 0;
+
     /**
      * This action causes the current private flag, intermediate characters, final character and
      * parameters to be forgotten. This occurs on entry to the escape, csi entry and dcs entry
@@ -115,6 +127,9 @@ class ParserEvents
      */
     virtual void putOSC(char _char) = 0;
 
+    /// Optimization that passes a run of OSC payload bytes in one call.
+    virtual void putOSC(std::string_view _chars) = 0;
+
     /**
      * This action is called when the OSC string is terminated by ST, CAN, SUB or ESC,
      * to allow the OSC handler to finish neatly.
@@ -138,6 +153,11 @@ class ParserEvents
      */
     virtual void put(char _char) = 0;
 
+    /// Optimization that passes a run of DCS payload bytes in one call, so
+    /// DCS-tunneled data (tmux passthrough, large DECSIXEL payloads) reaches
+    /// the hooked handler at raw parse speed instead of per-byte calls.
+    virtual void put(std::string_view _chars) = 0;
+
     /**
      * When a device control string is terminated by ST, CAN, SUB or ESC, this action calls the
      * previously selected handler function with an “end of data” parameter. This allows the
@@ -147,10 +167,19 @@ class ParserEvents
 
     virtual void startAPC() = 0;
     virtual void putAPC(char) = 0;
+
+    /// Optimization that passes a run of APC payload bytes in one call, so a
+    /// listener without a consumer can drop large payloads at memory-scan speed.
+    virtual void putAPC(std::string_view _chars) = 0;
+
     virtual void dispatchAPC() = 0;
 
     virtual void startPM() = 0;
     virtual void putPM(char32_t) = 0;
+
+    /// Optimization that passes a run of PM payload bytes in one call.
+    virtual void putPM(std::string_view _chars) = 0;
+
     virtual void dispatchPM() = 0;
 };
 
@@ -161,6 +190,16 @@ class BasicParserEvents: public ParserEvents
     void print(char) override {}
     void print(std::string_view) override {}
     void execute(char) override {}
+    void executeLinefeeds(size_t _count) override
+    {
+        while (_count--)
+            execute('\n');
+    }
+    void executeTabs(size_t _count) override
+    {
+        while (_count--)
+            execute('\t');
+    }
     void clear() override {}
     void collect(char) override {}
     void collectLeader(char) override {}
@@ -169,15 +208,35 @@ class BasicParserEvents: public ParserEvents
     void dispatchCSI(char) override {}
     void startOSC() override {}
     void putOSC(char) override {}
+    void putOSC(std::string_view _chars) override
+    {
+        for (char const ch: _chars)
+            putOSC(ch);
+    }
     void dispatchOSC() override {}
     void hook(char) override {}
     void put(char) override {}
+    void put(std::string_view _chars) override
+    {
+        for (char const ch: _chars)
+            put(ch);
+    }
     void unhook() override {}
     void startAPC() override {}
     void putAPC(char) override {}
+    void putAPC(std::string_view _chars) override
+    {
+        for (char const ch: _chars)
+            putAPC(ch);
+    }
     void dispatchAPC() override {}
     void startPM() override {}
     void putPM(char32_t) override {}
+    void putPM(std::string_view _chars) override
+    {
+        for (char const ch: _chars)
+            putPM(static_cast<char32_t>(static_cast<uint8_t>(ch)));
+    }
     void dispatchPM() override {}
 };
 } // end namespace terminal
@@ -2,6 +2,7 @@
 
 #include <functional>
 #include <string>
+#include <string_view>
 
 namespace terminal
 {
@@ -18,6 +19,18 @@ class ParserExtension
 
     virtual void start() = 0;
     virtual void pass(char _char) = 0;
+
+    /// Receives a whole run of payload bytes in one call.
+    ///
+    /// The parser delivers DCS payload data in bulk straight from its input
+    /// span; extensions that can consume runs (string collectors, tmux-style
+    /// passthrough) should override this, the default forwards byte-wise.
+    virtual void pass(std::string_view _chars)
+    {
+        for (char const ch: _chars)
+            pass(ch);
+    }
+
     virtual void finalize() = 0;
 };
 
@@ -30,6 +43,8 @@ class SimpleStringCollector: public ParserExtension
 
     void pass(char _char) override { data_.push_back(_char); }
 
+    void pass(std::string_view _chars) override { data_.append(_chars); }
+
     void finalize() override
     {
         if (done_)
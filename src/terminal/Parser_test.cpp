@@ -27,11 +27,20 @@ class MockParserEvents: public terminal::BasicParserEvents
     std::string text;
     std::string apc;
     std::string pm;
+    std::string dcs;
 
     void error(string_view const& _msg) override { INFO(fmt::format("Parser error received. {}", _msg)); }
     void print(char ch) override { text += ch; }
     void print(std::string_view s) override { text += s; }
 
+    using BasicParserEvents::putAPC; // bring bulk overloads back into scope
+    using BasicParserEvents::putPM;
+    using BasicParserEvents::put;
+
+    void hook(char _function) override { (dcs += "{") += _function; }
+    void put(char ch) override { dcs += ch; }
+    void unhook() override { dcs += "}"; }
+
     void startAPC() override { apc += "{"; }
     void putAPC(char ch) override { apc += ch; }
     void dispatchAPC() override { apc += "}"; }
@@ -72,3 +81,28 @@ TEST_CASE("Parser.APC")
     REQUIRE(listener.apc == "{Gi=1,a=q;}");
     REQUIRE(listener.text == "ABCDEF");
 }
+
+TEST_CASE("Parser.DCS.bulk")
+{
+    // Payload larger than one SIMD batch, with an embedded C0 control that -
+    // unlike in APC/PM strings - belongs to the DCS payload.
+    auto const payload = std::string(60, 'x') + '\n' + std::string(60, 'y');
+    MockParserEvents listener;
+    auto p = parser::Parser(listener);
+    p.parseFragment("\033Pq" + payload + "\033\\AB");
+    REQUIRE(p.state() == parser::State::Ground);
+    REQUIRE(listener.dcs == "{q" + payload + "}");
+    REQUIRE(listener.text == "AB");
+}
+
+TEST_CASE("Parser.APC.bulk")
+{
+    // Payload larger than one SIMD batch, exercising the bulk payload scan.
+    auto const payload = std::string(100, 'x');
+    MockParserEvents listener;
+    auto p = parser::Parser(listener);
+    p.parseFragment("\033_G" + payload + "\033\\AB");
+    REQUIRE(p.state() == parser::State::Ground);
+    REQUIRE(listener.apc == "{G" + payload + "}");
+    REQUIRE(listener.text == "AB");
+}
@@ -45,6 +45,25 @@
     #include <errno.h>
 #endif
 
+// posix_spawn() only covers all of the child-side PTY setup (controlling
+// terminal via re-open, chdir, closing leaked fds) with the glibc extensions
+// that arrived in 2.34 (addclosefrom_np); elsewhere we keep the classic
+// fork() path.
+#if defined(__linux__) && defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+    #if __GLIBC_PREREQ(2, 34)
+        #define LIBTERMINAL_USE_POSIX_SPAWN 1
+    #endif
+#endif
+
+#if defined(LIBTERMINAL_USE_POSIX_SPAWN)
+    #include <terminal/pty/UnixPty.h>
+
+    #include <fcntl.h>
+    #include <spawn.h>
+
+extern char** environ;
+#endif
+
 #if defined(_MSC_VER)
     #include <terminal/pty/ConPty.h>
 #endif
@@ -170,6 +189,109 @@ namespace
         argv[argCount + 1] = nullptr;
         return argv;
     }
+
+#if defined(LIBTERMINAL_USE_POSIX_SPAWN)
+    /// Child environment for posix_spawn(), built lazily: entries inherited
+    /// from the parent are referenced as-is and only overridden or added
+    /// variables are materialized.
+    struct SpawnEnvironment
+    {
+        std::vector<string> ownedEntries;
+        std::vector<char*> envp; // NULL-terminated; pointers into environ and ownedEntries
+
+        explicit SpawnEnvironment(Process::Environment const& _overrides)
+        {
+            ownedEntries.reserve(_overrides.size());
+            for (auto const& [name, value]: _overrides)
+                ownedEntries.emplace_back(name + "=" + value);
+
+            auto const isOverridden = [&](char const* entry) {
+                auto const entryView = string_view { entry };
+                auto const equals = entryView.find('=');
+                auto const name = entryView.substr(0, equals != string_view::npos ? equals : 0);
+                return _overrides.count(string(name)) != 0;
+            };
+
+            for (char** env = environ; *env; ++env)
+                if (!isOverridden(*env))
+                    envp.emplace_back(*env);
+            for (auto& entry: ownedEntries)
+                envp.emplace_back(entry.data());
+            envp.emplace_back(nullptr);
+        }
+    };
+
+    pid_t spawnAttachedToPty(string const& _path,
+                             vector<string> const& _args,
+                             FileSystem::path const& _cwd,
+                             Process::Environment const& _env,
+                             UnixPty& _pty)
+    {
+        _pty.prepareSpawnedChildProcess();
+
+        // Re-opening the slave end by path (rather than dup2()ing the fd that
+        // is already open in the parent) makes it the controlling terminal of
+        // the child's fresh session, which a plain dup2() would not.
+        char const* slavePath = ptsname(_pty.masterFd());
+        if (!slavePath)
+            throw runtime_error { "ptsname: "s + getLastErrorAsString() };
+
+        auto const cwd = _cwd.generic_string();
+
+        posix_spawn_file_actions_t fileActions;
+        posix_spawn_file_actions_init(&fileActions);
+        if (!cwd.empty())
+            posix_spawn_file_actions_addchdir_np(&fileActions, cwd.c_str());
+        posix_spawn_file_actions_addopen(&fileActions, STDIN_FILENO, slavePath, O_RDWR, 0);
+        posix_spawn_file_actions_adddup2(&fileActions, STDIN_FILENO, STDOUT_FILENO);
+        posix_spawn_file_actions_adddup2(&fileActions, STDIN_FILENO, STDERR_FILENO);
+        // Closes the pty fds as well as any leaked/inherited descriptors.
+        posix_spawn_file_actions_addclosefrom_np(&fileActions, 3);
+
+        posix_spawnattr_t attr;
+        posix_spawnattr_init(&attr);
+        // reset signal(s) to default that may have been changed in the parent process.
+        sigset_t signalDefaults;
+        sigemptyset(&signalDefaults);
+        sigaddset(&signalDefaults, SIGPIPE);
+        posix_spawnattr_setsigdefault(&attr, &signalDefaults);
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID | POSIX_SPAWN_SETSIGDEF);
+
+        auto const env = SpawnEnvironment { _env };
+
+        auto pid = pid_t { -1 };
+        char** argv = createArgv(_path, _args, 0);
+        auto rv = posix_spawnp(&pid, _path.c_str(), &fileActions, &attr, argv, env.envp.data());
+        delete[] argv;
+
+        if (rv != 0)
+        {
+            // Fallback: Try login shell.
+            auto const message =
+                fmt::format("\r\n\033[31;1mFailed to spawn {}. {}\033[m\r\n\n", _path, strerror(rv));
+            (void) ::write(_pty.slaveFd(), message.data(), message.size());
+
+            if (auto const shell = Process::loginShell(); !shell.empty())
+            {
+                auto shellArgv = vector<char*> {};
+                shellArgv.reserve(shell.size() + 1);
+                for (auto const& arg: shell)
+                    shellArgv.emplace_back(const_cast<char*>(arg.c_str()));
+                shellArgv.emplace_back(nullptr);
+                rv = posix_spawnp(
+                    &pid, shell.front().c_str(), &fileActions, &attr, shellArgv.data(), env.envp.data());
+            }
+        }
+
+        posix_spawn_file_actions_destroy(&fileActions);
+        posix_spawnattr_destroy(&attr);
+
+        if (rv != 0)
+            throw runtime_error { "posix_spawnp: "s + strerror(rv) };
+
+        return pid;
+    }
+#endif
 } // anonymous namespace
 
 Process::Process(string const& _path,
@@ -179,6 +301,18 @@ Process::Process(string const& _path,
                  Pty& _pty)
 {
 #if defined(__unix__) || defined(__APPLE__)
+    #if defined(LIBTERMINAL_USE_POSIX_SPAWN)
+    // Fast path: posix_spawn() avoids duplicating the parent's page tables
+    // (which fork() pays for proportionally to the scrollback already
+    // allocated) and performs the whole PTY setup via file actions.
+    if (auto* unixPty = dynamic_cast<UnixPty*>(&_pty))
+    {
+        pid_ = spawnAttachedToPty(_path, _args, _cwd, _env, *unixPty);
+        _pty.prepareParentProcess();
+        return;
+    }
+    #endif
+
     pid_ = fork();
     switch (pid_)
     {
@@ -15,31 +15,26 @@
 
 #include <fmt/format.h>
 
-#include <mutex>
-
 namespace terminal
 {
 
 bool RenderDoubleBuffer::swapBuffers(std::chrono::steady_clock::time_point _now) noexcept
 {
-    // If the terminal thread (writer) cannot try_lock (w/o wait time)
-    // the front buffer, it'll just flush back buffer instead of swapping
-    // buffers as the front buffer is apparently still in use by the
-    // renderer thread and we want to avoid render-thread imposed
-    // wait times in the terminal thread as much as possible.
-
-    if (!readerLock.try_lock())
-        return false;
-
-    auto const _l = std::lock_guard<decltype(readerLock)>(readerLock, std::adopt_lock);
-
-    for (;;)
+    // Publish the back buffer by swapping it into the middle slot. The reader
+    // thread never touches the back slot and the writer never touches the
+    // front slot, so neither side ever has to wait for the other. If the
+    // previously published frame was not picked up yet, it is simply replaced.
+
+    auto current = bufferState.load(std::memory_order_relaxed);
+    uint32_t next;
+    do
     {
-        auto current = currentBackBufferIndex.load();
-        if (currentBackBufferIndex.compare_exchange_weak(current, (current + 1) % 2))
-            break;
-    }
+        next = (middleOf(current) << BackShift) | (backOf(current) << MiddleShift)
+               | (frontOf(current) << FrontShift) | NewFrameFlag;
+    } while (!bufferState.compare_exchange_weak(
+        current, next, std::memory_order_acq_rel, std::memory_order_relaxed));
 
+    lastWrittenBuffer_ = &buffers[backOf(current)];
     lastUpdate = _now;
     state = RenderBufferState::WaitingForRefresh;
     return true;
@@ -19,18 +19,64 @@
 #include <terminal/Image.h>
 #include <terminal/primitives.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
-#include <mutex>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 namespace terminal
 {
 
+/// Fixed-capacity inline codepoint storage for a single rendered grid cell.
+///
+/// Grid cells already cap their grapheme clusters (see Cell::MaxCodepoints),
+/// so a RenderCell never carries more than a handful of codepoints. Storing
+/// them inline - unlike std::u32string, whose SSO holds very few char32_t's -
+/// keeps composing the render buffer free of per-cell heap allocations.
+struct RenderCellCodepoints
+{
+    /// Matches Cell::MaxCodepoints plus headroom for the trailing variation
+    /// selector of long emoji sequences.
+    static constexpr size_t Capacity = 8;
+
+    constexpr void clear() noexcept { size_ = 0; }
+
+    constexpr void push_back(char32_t _codepoint) noexcept
+    {
+        if (size_ < Capacity)
+            data_[size_++] = _codepoint;
+    }
+
+    constexpr void assign(size_t _count, char32_t _codepoint) noexcept
+    {
+        size_ = static_cast<uint8_t>(_count < Capacity ? _count : Capacity);
+        for (uint8_t i = 0; i < size_; ++i)
+            data_[i] = _codepoint;
+    }
+
+    constexpr size_t size() const noexcept { return size_; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr char32_t operator[](size_t _index) const noexcept { return data_[_index]; }
+
+    constexpr char32_t const* begin() const noexcept { return data_.data(); }
+    constexpr char32_t const* end() const noexcept { return data_.data() + size_; }
+
+    constexpr operator std::u32string_view() const noexcept
+    {
+        return std::u32string_view(data_.data(), size_);
+    }
+
+  private:
+    std::array<char32_t, Capacity> data_ {};
+    uint8_t size_ = 0;
+};
+
 struct RenderCell
 {
-    std::u32string codepoints;
+    RenderCellCodepoints codepoints;
     std::shared_ptr<ImageFragment> image;
     CellLocation position;
     CellFlags flags;
@@ -43,6 +89,25 @@ struct RenderCell
     bool groupEnd = false;
 };
 
+/// A whole display row drawn directly from a trivially stored line's text,
+/// bypassing the per-cell pipeline.
+///
+/// Emitted only for rows whose Line is in SimpleLineBuffer state with fully
+/// default SGR and that are not covered by the cursor, a selection, an
+/// overlay span, or an echo prediction; all other rows take the RenderCell
+/// path. The text is printable US-ASCII, one byte per column starting at
+/// column 0 - the SimpleLineBuffer invariant enforced by writeText()'s
+/// fast path and deflate().
+struct RenderLine
+{
+    std::string text;
+    LineOffset lineOffset {};
+    ColumnCount usedColumns {};
+    RGBColor textColor;
+    RGBColor backgroundColor;
+    CellFlags flags {};
+};
+
 struct RenderCursor
 {
     CellLocation position;
@@ -50,35 +115,81 @@ struct RenderCursor
     int width = 1;
 };
 
+/// A decorative span overlaid on top of grid content at render-buffer compose
+/// time, without mutating any grid cell (search highlights, IME preedit,
+/// URL hover).
+///
+/// Spans are anchored via absolute line numbers (Grid::absoluteLineNumber()),
+/// so they stay attached to their content while the grid scrolls, and only a
+/// changed span set re-emits the covered display rows.
+struct OverlaySpan
+{
+    uint64_t line;            //!< absolute line number of the covered line
+    ColumnOffset beginColumn; //!< first covered column (inclusive)
+    ColumnOffset endColumn;   //!< one past the last covered column (exclusive)
+
+    CellFlags styles {}; //!< additional cell style flags, OR'ed onto the covered cells
+
+    /// Overrides for the resolved cell colors; unset members leave the
+    /// respective cell color untouched.
+    std::optional<RGBColor> foregroundColor {};
+    std::optional<RGBColor> backgroundColor {};
+
+    /// Replacement text drawn instead of the covered cells' content, one
+    /// codepoint per column starting at beginColumn (IME preedit, statistics
+    /// overlay). Covered cells beyond the text keep their grid content;
+    /// empty text keeps all of it.
+    std::u32string text {};
+};
+
 struct RenderBuffer
 {
     std::vector<RenderCell> screen {};
+    std::vector<RenderLine> lines {};
     std::optional<RenderCursor> cursor {};
     uint64_t frameID {};
 
+    /// Inclusive range of display rows that changed relative to the previously
+    /// composed frame (frameID - 1), or std::nullopt if everything must be
+    /// treated as changed. first > second denotes an empty range, i.e. a frame
+    /// that is pixel-identical to its predecessor.
+    ///
+    /// Consumers may use this to confine compositing to the changed region,
+    /// provided they still hold the predecessor frame's pixels.
+    std::optional<std::pair<LineOffset, LineOffset>> damagedLineRange {};
+
+    /// Number of display rows the previously composed frame's content moved
+    /// down by (negative: up), e.g. due to a viewport scroll. Rows outside
+    /// the damaged range are unchanged relative to their *shifted* position
+    /// in the predecessor frame; consumers confining themselves to the
+    /// damaged range must therefore shift the retained pixels accordingly
+    /// first (or compose the whole frame). Only non-zero when
+    /// damagedLineRange is set.
+    int scrolledRows = 0;
+
     void clear()
     {
         screen.clear();
+        lines.clear();
         cursor.reset();
+        damagedLineRange.reset();
+        scrolledRows = 0;
     }
 };
 
-/// Lock-guarded handle to a read-only RenderBuffer object.
+/// Handle to a read-only RenderBuffer object.
+///
+/// The referenced buffer is the triple-buffer's front buffer, which is only
+/// ever re-assigned by the reader (GUI) thread itself, so no lock is needed.
 ///
 /// @see RenderBuffer
 struct RenderBufferRef
 {
     RenderBuffer const& buffer;
-    std::mutex& guard;
 
     RenderBuffer const& get() const noexcept { return buffer; }
 
-    RenderBufferRef(RenderBuffer const& _buf, std::mutex& _lock): buffer { _buf }, guard { _lock }
-    {
-        guard.lock();
-    }
-
-    ~RenderBufferRef() { guard.unlock(); }
+    explicit RenderBufferRef(RenderBuffer const& _buf): buffer { _buf } {}
 };
 
 /// Reflects the current state of a RenderDoubleBuffer object.
@@ -101,28 +212,74 @@ constexpr std::string_view to_string(RenderBufferState _state) noexcept
     return "INVALID";
 }
 
+/// Wait-free single-writer/single-reader triple buffer for RenderBuffer frames.
+///
+/// The VT (writer) thread composes frames into the back buffer and publishes
+/// them via swapBuffers(); the GUI (reader) thread picks up the most recently
+/// published frame via frontBuffer(). Neither side ever blocks on the other:
+/// both merely CAS the packed buffer-index word below.
 struct RenderDoubleBuffer
 {
-    std::mutex mutable readerLock;
-    std::atomic<size_t> currentBackBufferIndex = 0;
-    std::array<RenderBuffer, 2> buffers {};
+    // Packed triple-buffer state: bits 0..1 back, 2..3 middle, 4..5 front
+    // buffer index, bit 6 flags an unconsumed frame in the middle slot.
+    static constexpr uint32_t BackShift = 0;
+    static constexpr uint32_t MiddleShift = 2;
+    static constexpr uint32_t FrontShift = 4;
+    static constexpr uint32_t IndexMask = 0x03;
+    static constexpr uint32_t NewFrameFlag = 1u << 6;
+
+    std::atomic<uint32_t> mutable bufferState = (0u << BackShift) | (1u << MiddleShift) | (2u << FrontShift);
+    std::array<RenderBuffer, 3> buffers {};
     std::atomic<RenderBufferState> state = RenderBufferState::WaitingForRefresh;
     std::chrono::steady_clock::time_point lastUpdate {};
 
-    RenderBuffer& backBuffer() noexcept { return buffers[currentBackBufferIndex]; }
+    static constexpr uint32_t backOf(uint32_t _state) noexcept { return (_state >> BackShift) & IndexMask; }
+    static constexpr uint32_t middleOf(uint32_t _state) noexcept
+    {
+        return (_state >> MiddleShift) & IndexMask;
+    }
+    static constexpr uint32_t frontOf(uint32_t _state) noexcept { return (_state >> FrontShift) & IndexMask; }
 
+    RenderBuffer& backBuffer() noexcept
+    {
+        return buffers[backOf(bufferState.load(std::memory_order_relaxed))];
+    }
+
+    /// Returns the frame most recently published by the writer thread.
+    ///
+    /// May only be invoked by the reader thread; wait-free.
     RenderBufferRef frontBuffer() const
     {
-        // if (state == RenderBufferState::TrySwapBuffers)
-        //     const_cast<RenderDoubleBuffer*>(this)->swapBuffers(lastUpdate);
-        RenderBuffer const& frontBuffer = buffers.at((currentBackBufferIndex + 1) % 2);
-        return RenderBufferRef(frontBuffer, readerLock);
+        auto current = bufferState.load(std::memory_order_relaxed);
+        while (current & NewFrameFlag)
+        {
+            // Take over the freshly published frame by swapping middle with front.
+            auto const next = (backOf(current) << BackShift) | (frontOf(current) << MiddleShift)
+                              | (middleOf(current) << FrontShift);
+            if (bufferState.compare_exchange_weak(
+                    current, next, std::memory_order_acq_rel, std::memory_order_relaxed))
+            {
+                current = next;
+                break;
+            }
+        }
+        return RenderBufferRef(buffers.at(frontOf(current)));
     }
 
+    /// Returns the frame most recently published via swapBuffers(), if any.
+    ///
+    /// May only be accessed by the writer thread. The writer never composes
+    /// into this buffer again before publishing another frame, so it remains
+    /// valid as a damage-tracking reference even if the reader picks it up.
+    RenderBuffer const* lastWrittenBuffer() const noexcept { return lastWrittenBuffer_; }
+
     void clear() { backBuffer().clear(); }
 
-    // Swaps front with back buffer. May only be invoked by the writer thread.
+    // Publishes the back buffer. May only be invoked by the writer thread; wait-free.
     bool swapBuffers(std::chrono::steady_clock::time_point _now) noexcept;
+
+  private:
+    RenderBuffer const* lastWrittenBuffer_ = nullptr;
 };
 
 } // namespace terminal
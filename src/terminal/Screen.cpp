@@ -13,11 +13,13 @@
  */
 #include <terminal/InputGenerator.h>
 #include <terminal/Screen.h>
+#include <terminal/UnicodeCache.h>
 #include <terminal/VTType.h>
 #include <terminal/logging.h>
 
 #include <crispy/App.h>
 #include <crispy/Comparison.h>
+#include <crispy/PerfCounters.h>
 #include <crispy/algorithm.h>
 #include <crispy/escape.h>
 #include <crispy/size.h>
@@ -32,12 +34,14 @@
 #include <range/v3/view.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <iostream>
 #include <iterator>
 #include <sstream>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <variant>
 
 using namespace std::string_view_literals;
@@ -100,6 +104,51 @@ namespace
 
 namespace // {{{ helper
 {
+    // {{{ precomputed device-attribute responses
+    constexpr auto AllVTTypes = std::array<VTType, 10> {
+        VTType::VT100, VTType::VT220, VTType::VT240, VTType::VT330, VTType::VT340,
+        VTType::VT320, VTType::VT420, VTType::VT510, VTType::VT520, VTType::VT525,
+    };
+
+    /// DA1 identification code for the given conformance level.
+    constexpr std::string_view primaryDeviceAttributesId(VTType _id) noexcept
+    {
+        switch (_id)
+        {
+        case VTType::VT100: return "1";
+        case VTType::VT220:
+        case VTType::VT240: return "62";
+        case VTType::VT320:
+        case VTType::VT330:
+        case VTType::VT340: return "63";
+        case VTType::VT420: return "64";
+        case VTType::VT510:
+        case VTType::VT520:
+        case VTType::VT525: return "65";
+        }
+        return "1"; // Should never be reached.
+    }
+
+    /// DECSCL conformance level number for the given terminal id.
+    constexpr int conformanceLevelNumber(VTType _id) noexcept
+    {
+        switch (_id)
+        {
+        case VTType::VT100: return 61;
+        case VTType::VT220:
+        case VTType::VT240: return 62;
+        case VTType::VT320:
+        case VTType::VT330:
+        case VTType::VT340: return 63;
+        case VTType::VT420: return 64;
+        case VTType::VT510:
+        case VTType::VT520:
+        case VTType::VT525: return 65;
+        }
+        return 61; // Should never be reached.
+    }
+    // }}}
+
     std::string vtSequenceParameterString(GraphicsAttributes const& _sgr)
     {
         std::string output;
@@ -447,9 +496,6 @@ void Screen<T>::resizeColumns(ColumnCount _newColumnCount, bool _clear)
 template <typename T>
 void Screen<T>::resize(PageSize _newSize)
 {
-    // NOTE: This will only resize the currently active buffer.
-    // Any other buffer will be resized when it is switched to.
-
     auto const oldCursorPos = _state.cursor.position;
 
     _state.cursor.position = _state.activeGrid->resize(_newSize, oldCursorPos, _state.wrapPending);
@@ -457,6 +503,17 @@ void Screen<T>::resize(PageSize _newSize)
         _state.wrapPending = false;
     _state.pageSize = _newSize;
 
+    // Resize the inactive buffer eagerly, too. Window resizes are rare and
+    // expected to be costly, whereas deferring the work would make the next
+    // buffer switch pay for reflowing the entire primary scrollback right at
+    // the DECSET 1049 transition (e.g. when quitting vim), which should be a
+    // constant-time pointer swap regardless of scrollback size.
+    if (_state.activeGrid == &alternateGrid())
+        _state.savedPrimaryCursor.position =
+            primaryGrid().resize(_newSize, _state.savedPrimaryCursor.position, false);
+    else
+        (void) alternateGrid().resize(_newSize, CellLocation {}, false);
+
     // Reset margin to their default.
     _state.margin = Margin { Margin::Vertical { {}, _newSize.lines.as<LineOffset>() - 1 },
                              Margin::Horizontal { {}, _newSize.columns.as<ColumnOffset>() - 1 } };
@@ -546,6 +603,8 @@ void Screen<T>::write(std::u32string_view _data)
 template <typename T>
 void Screen<T>::writeText(string_view _chars)
 {
+    CRISPY_PERF_SCOPE("screen.writeText");
+
     //#define LIBTERMINAL_BULK_TEXT_OPTIMIZATION 1
 
 #if defined(LIBTERMINAL_BULK_TEXT_OPTIMIZATION)
@@ -682,10 +741,86 @@ void Screen<T>::writeText(string_view _chars)
     }
 #endif
 
+    // Fast path: a plain US-ASCII run appended at the tail of a trivial
+    // (compact) line needs no Cell materialization at all. The text is glued
+    // onto the SimpleLineBuffer and only inflated lazily when per-cell access
+    // is actually required (e.g. by the renderer or a partial rewrite).
+    if (auto& line = currentLine(); line.isTrivialBuffer())
+    {
+        auto const column = _state.cursor.position.column;
+        auto& trivialBuffer = line.trivialBuffer();
+        bool const fitsWithoutWrap =
+            unbox<size_t>(column) + _chars.size() < unbox<size_t>(_state.pageSize.columns);
+        // The line's attributes also paint the blank tail of the row (BCE:
+        // clearing with a colored SGR stores it as the fill), so even an empty
+        // trivial line must match the cursor SGR - overwriting the attributes
+        // would repaint the fill.
+        bool const sgrMatches = trivialBuffer.attributes == _state.cursor.graphicsRendition;
+        // One byte per column: the printable US-ASCII invariant of
+        // SimpleLineBuffer (see deflate()).
+        bool const appendsAtTail = unbox<size_t>(column) == trivialBuffer.text.size();
+
+        if (fitsWithoutWrap && sgrMatches && appendsAtTail && !_state.wrapPending
+            && _state.margin == _state.pageSize && _state.cursor.hyperlink == HyperlinkId {}
+            && _state.cursor.charsets.isUsAsciiSelected()
+            && _chars.find('\x7F') == std::string_view::npos)
+        {
+            line.appendTrivialText(_chars);
+            _state.cursor.position.column += ColumnOffset::cast_from(_chars.size());
+            _state.lastCursorPosition = _state.cursor.position;
+            --_state.lastCursorPosition.column;
+            _terminal.markCellDirty(_state.cursor.position);
+            _state.sequencer.resetInstructionCounter();
+            return;
+        }
+    }
+
+    // Bulk path for a US-ASCII run written into an (already inflated) line:
+    // the SGR and all per-character bookkeeping are hoisted out of the loop,
+    // so consecutive cells sharing the same attributes are written in one
+    // tight splat instead of per-cell via writeText(char32_t).
+    if (auto const column = _state.cursor.position.column;
+        unbox<size_t>(column) + _chars.size() < unbox<size_t>(_state.pageSize.columns)
+        && !_state.wrapPending && _state.margin == _state.pageSize
+        && _state.cursor.charsets.isUsAsciiSelected() && _chars.find('\x7F') == std::string_view::npos)
+    {
+        auto constexpr ASCII_Width = uint8_t { 1 };
+        auto const attributes = _state.cursor.graphicsRendition;
+        auto const hyperlink = _state.cursor.hyperlink;
+        auto const* source = _chars.data();
+        for (Cell& cell: currentLine().useRange(column, ColumnCount::cast_from(_chars.size())))
+            cell.write(attributes, static_cast<char32_t>(*source++), ASCII_Width, hyperlink);
+
+        _state.cursor.position.column += ColumnOffset::cast_from(_chars.size());
+        _state.lastCursorPosition = _state.cursor.position;
+        --_state.lastCursorPosition.column;
+
+        auto const line = _state.cursor.position.line;
+        auto const right = _state.lastCursorPosition.column;
+        auto const area = Rect { Top(*line), Left(*column), Bottom(*line), Right(*right) };
+        _terminal.markRegionDirty(area);
+        _state.sequencer.resetInstructionCounter();
+        return;
+    }
+
     for (char const ch: _chars)
         writeText(static_cast<char32_t>(ch));
 }
 
+template <typename T>
+void Screen<T>::writeText(std::u32string_view _codepoints)
+{
+    // Bulk write of an already decoded codepoint run, as produced by the
+    // sequencer's UTF-8 batching stage. The preceding-graphic-character
+    // bookkeeping is advanced inline so grapheme cluster joining keeps
+    // working within the run.
+    for (char32_t const codepoint: _codepoints)
+    {
+        writeText(codepoint);
+        _state.precedingGraphicCharacter = codepoint;
+    }
+}
+
 template <typename T>
 void Screen<T>::writeText(char32_t _char)
 {
@@ -710,7 +845,7 @@ void Screen<T>::writeText(char32_t _char)
         && codepoint
                < 128; // NB: This is an optimization for US-ASCII text versus grapheme cluster segmentation.
 
-    if (!lastChar || isAsciiBreakable || unicode::grapheme_segmenter::breakable(lastChar, codepoint))
+    if (!lastChar || isAsciiBreakable || graphemeBreakable(lastChar, codepoint))
     {
         writeCharToCurrentAndAdvance(codepoint);
     }
@@ -739,7 +874,7 @@ void Screen<T>::writeCharToCurrentAndAdvance(char32_t _character) noexcept
 
     cell.write(_state.cursor.graphicsRendition,
                _character,
-               (uint8_t) unicode::width(_character),
+               codepointWidth(_character),
                _state.cursor.hyperlink);
 
     _state.lastCursorPosition = _state.cursor.position;
@@ -884,6 +1019,7 @@ template <typename T>
 void Screen<T>::clearAllTabs()
 {
     _state.tabs.clear();
+    _state.nextTabStopCacheDirty = true;
 }
 
 template <typename T>
@@ -905,6 +1041,7 @@ void Screen<T>::clearTabUnderCursor()
             break;
         }
     }
+    _state.nextTabStopCacheDirty = true;
 }
 
 template <typename T>
@@ -912,6 +1049,35 @@ void Screen<T>::setTabUnderCursor()
 {
     _state.tabs.emplace_back(realCursorPosition().column);
     sort(begin(_state.tabs), end(_state.tabs));
+    _state.nextTabStopCacheDirty = true;
+}
+
+template <typename T>
+ColumnOffset Screen<T>::nextTabStop(ColumnOffset _column)
+{
+    auto& cache = _state.nextTabStopCache;
+    auto const columns = unbox<size_t>(_state.pageSize.columns);
+
+    // A page resize invalidates the cache just like HTS/TBC do; detecting it
+    // by size spares every resize path from knowing about tab stops.
+    if (_state.nextTabStopCacheDirty || cache.size() != columns)
+    {
+        cache.assign(columns, ColumnOffset(-1));
+        auto stop = _state.tabs.begin(); // tabs are kept sorted
+        for (size_t column = 0; column < columns; ++column)
+        {
+            while (stop != _state.tabs.end() && *stop <= ColumnOffset::cast_from(column))
+                ++stop;
+            if (stop == _state.tabs.end())
+                break; // remaining entries stay at the none-sentinel
+            cache[column] = *stop;
+        }
+        _state.nextTabStopCacheDirty = false;
+    }
+
+    if (!(ColumnOffset(0) <= _column && unbox<size_t>(_column) < columns))
+        return ColumnOffset(-1);
+    return cache[unbox<size_t>(_column)];
 }
 // }}}
 
@@ -1007,16 +1173,12 @@ void Screen<T>::resetHard()
 template <typename T>
 void Screen<T>::moveCursorTo(LineOffset _line, ColumnOffset _column)
 {
-    auto const [line, column] = [&]() {
-        if (!_state.cursor.originMode)
-            return pair { _line, _column };
-        else
-            return pair { _line + _state.margin.vertical.from, _column + _state.margin.horizontal.from };
-    }();
-
+    // The hottest cursor path (CUP/HVP): origin translation plus clamping,
+    // with no flow beyond what the clamps compile down to.
+    auto const base = origin();
     _state.wrapPending = false;
-    _state.cursor.position.line = clampedLine(line);
-    _state.cursor.position.column = clampedColumn(column);
+    _state.cursor.position.line = clampedLine(_line + base.line);
+    _state.cursor.position.column = clampedColumn(_column + base.column);
 }
 
 template <typename T>
@@ -1124,6 +1286,33 @@ void Screen<T>::linefeed()
         linefeed(realCursorPosition().column);
 }
 
+template <typename T>
+void Screen<T>::linefeeds(LineCount _count)
+{
+    // Batched variant of linefeed() for runs of consecutive LFs: the cursor
+    // moves down to the bottom margin and the overflow folds into a single
+    // multi-line scrollUp(), i.e. one ring rotation and one wrap-around
+    // bookkeeping pass instead of one per line.
+    auto const newColumn = isModeEnabled(AnsiMode::AutomaticNewLine) ? _state.margin.horizontal.from
+                                                                     : realCursorPosition().column;
+    _state.wrapPending = false;
+    _state.cursor.position.column = newColumn;
+
+    auto const bottom = _state.margin.vertical.to;
+    if (*realCursorPosition().line <= *bottom)
+    {
+        auto const stepsUntilMargin = LineCount(*bottom - *realCursorPosition().line);
+        auto const cursorMoves = std::min(stepsUntilMargin, _count);
+        _state.cursor.position.line += boxed_cast<LineOffset>(cursorMoves);
+        if (auto const scrollCount = _count - cursorMoves; *scrollCount > 0)
+            scrollUp(scrollCount, {}, _state.margin);
+    }
+    else
+        // Cursor below the bottom margin: like the per-line code path,
+        // a linefeed only moves the cursor and never scrolls.
+        _state.cursor.position.line += boxed_cast<LineOffset>(_count);
+}
+
 template <typename T>
 void Screen<T>::backspace()
 {
@@ -1161,35 +1350,27 @@ template <typename T>
 void Screen<T>::sendDeviceAttributes()
 {
     // See https://vt100.net/docs/vt510-rm/DA1.html
-
-    auto const id = [&]() -> string_view {
-        switch (_state.terminalId)
-        {
-        case VTType::VT100: return "1";
-        case VTType::VT220:
-        case VTType::VT240: return "62";
-        case VTType::VT320:
-        case VTType::VT330:
-        case VTType::VT340: return "63";
-        case VTType::VT420: return "64";
-        case VTType::VT510:
-        case VTType::VT520:
-        case VTType::VT525: return "65";
-        }
-        return "1"; // Should never be reached.
+    //
+    // The supported feature set is fixed and the identification depends only
+    // on the emulated conformance level, so every possible response is
+    // formatted exactly once and afterwards served as a plain string copy.
+    static auto const responses = []() {
+        auto const attrs = to_params(DeviceAttributes::AnsiColor |
+                                     // DeviceAttributes::AnsiTextLocator |
+                                     DeviceAttributes::CaptureScreenBuffer | DeviceAttributes::Columns132 |
+                                     // TODO: DeviceAttributes::NationalReplacementCharacterSets |
+                                     DeviceAttributes::RectangularEditing |
+                                     // TODO: DeviceAttributes::SelectiveErase |
+                                     DeviceAttributes::SixelGraphics |
+                                     // TODO: DeviceAttributes::TechnicalCharacters |
+                                     DeviceAttributes::UserDefinedKeys);
+        auto map = std::unordered_map<VTType, std::string> {};
+        for (VTType const id: AllVTTypes)
+            map[id] = fmt::format("\033[?{};{}c", primaryDeviceAttributesId(id), attrs);
+        return map;
     }();
 
-    auto const attrs = to_params(DeviceAttributes::AnsiColor |
-                                 // DeviceAttributes::AnsiTextLocator |
-                                 DeviceAttributes::CaptureScreenBuffer | DeviceAttributes::Columns132 |
-                                 // TODO: DeviceAttributes::NationalReplacementCharacterSets |
-                                 DeviceAttributes::RectangularEditing |
-                                 // TODO: DeviceAttributes::SelectiveErase |
-                                 DeviceAttributes::SixelGraphics |
-                                 // TODO: DeviceAttributes::TechnicalCharacters |
-                                 DeviceAttributes::UserDefinedKeys);
-
-    reply("\033[?{};{}c", id, attrs);
+    reply(responses.at(_state.terminalId));
 }
 
 template <typename T>
@@ -1197,19 +1378,25 @@ void Screen<T>::sendTerminalId()
 {
     // Note, this is "Secondary DA".
     // It requests for the terminalID
+    //
+    // Like DA1, the response only varies with the emulated conformance level
+    // and is therefore formatted once per level up front.
+    static auto const responses = []() {
+        // version number
+        // TODO: (PACKAGE_VERSION_MAJOR * 100 + PACKAGE_VERSION_MINOR) * 100 + PACKAGE_VERSION_MICRO
+        auto constexpr Pv =
+            (LIBTERMINAL_VERSION_MAJOR * 100 + LIBTERMINAL_VERSION_MINOR) * 100 + LIBTERMINAL_VERSION_PATCH;
+
+        // ROM cardridge registration number (always 0)
+        auto constexpr Pc = 0;
+
+        auto map = std::unordered_map<VTType, std::string> {};
+        for (VTType const id: AllVTTypes)
+            map[id] = fmt::format("\033[>{};{};{}c", static_cast<unsigned>(id), Pv, Pc);
+        return map;
+    }();
 
-    // terminal protocol type
-    auto const Pp = static_cast<unsigned>(_state.terminalId);
-
-    // version number
-    // TODO: (PACKAGE_VERSION_MAJOR * 100 + PACKAGE_VERSION_MINOR) * 100 + PACKAGE_VERSION_MICRO
-    auto constexpr Pv =
-        (LIBTERMINAL_VERSION_MAJOR * 100 + LIBTERMINAL_VERSION_MINOR) * 100 + LIBTERMINAL_VERSION_PATCH;
-
-    // ROM cardridge registration number (always 0)
-    auto constexpr Pc = 0;
-
-    reply("\033[>{};{};{}c", Pp, Pv, Pc);
+    reply(responses.at(_state.terminalId));
 }
 
 template <typename T>
@@ -1275,6 +1462,14 @@ void Screen<T>::eraseCharacters(ColumnCount _n)
 template <typename T>
 void Screen<T>::clearToEndOfLine()
 {
+    // Clearing from the first column wipes the entire line, which clearLine()
+    // handles in O(1) without materializing any cells.
+    if (*_state.cursor.position.column == 0)
+    {
+        clearLine();
+        return;
+    }
+
     Cell* i = &at(_state.cursor.position);
     Cell* e = i + unbox<int>(_state.pageSize.columns) - unbox<int>(_state.cursor.position.column);
     while (i != e)
@@ -1305,13 +1500,14 @@ void Screen<T>::clearToBeginOfLine()
 template <typename T>
 void Screen<T>::clearLine()
 {
-    Cell* i = &at(_state.cursor.position.line, ColumnOffset(0));
-    Cell* e = i + unbox<int>(_state.pageSize.columns);
-    while (i != e)
-    {
-        i->reset(_state.cursor.graphicsRendition);
-        ++i;
-    }
+    // Erasing the whole line demotes it to the compact storage form instead of
+    // resetting every cell; the cells only materialize again lazily if per-cell
+    // access is actually needed. This keeps full-screen redraw loops of TUIs
+    // (which erase each line before repainting it) from touching the entire
+    // grid memory twice per frame.
+    grid()
+        .lineAt(_state.cursor.position.line)
+        .reset(grid().defaultLineFlags(), _state.cursor.graphicsRendition);
 
     auto const line = _state.cursor.position.line;
     auto const left = ColumnOffset(0);
@@ -1451,7 +1647,7 @@ void Screen<T>::fillArea(char32_t _ch, int _top, int _left, int _bottom, int _ri
     if (!(32 <= _ch && _ch <= 126) && !(160 <= _ch && _ch <= 255))
         return;
 
-    auto const w = static_cast<uint8_t>(unicode::width(_ch));
+    auto const w = codepointWidth(_ch);
     for (int y = _top; y <= _bottom; ++y)
     {
         for (Cell& cell:
@@ -1538,49 +1734,46 @@ void Screen<T>::hyperlink(string _id, string _uri)
 {
     if (_uri.empty())
         _state.cursor.hyperlink = {};
-    else if (!_id.empty())
-        _state.cursor.hyperlink = _state.hyperlinks.hyperlinkIdByUserId(_id);
     else
-    {
-        _state.cursor.hyperlink = _state.hyperlinks.nextHyperlinkId++;
-        _state.hyperlinks.cache.emplace(_state.cursor.hyperlink,
-                                        make_shared<HyperlinkInfo>(HyperlinkInfo { move(_id), move(_uri) }));
-    }
+        _state.cursor.hyperlink = _state.hyperlinks.intern(move(_id), move(_uri));
     // TODO:
-    // Care about eviction.
     // Move hyperlink store into ScreenBuffer, so it gets reset upon every switch into
     // alternate screen (not for main screen!)
 }
 
+// {{{ cursor movement
+// The relative movement family below is deliberately reduced to clamped
+// register arithmetic: load the cursor position and the one margin bound that
+// applies into locals, one clamp, one store. TUIs issue these by the millions
+// per redraw, so anything beyond that (helper calls re-reading state, branchy
+// distance computations) shows up in the screen-apply stage of bench-headless.
+
 template <typename T>
 void Screen<T>::moveCursorUp(LineCount _n)
 {
-    _state.wrapPending = 0;
-    auto const n = min(_n.as<LineOffset>(),
-                       logicalCursorPosition().line > _state.margin.vertical.from
-                           ? logicalCursorPosition().line - _state.margin.vertical.from
-                           : logicalCursorPosition().line);
-
-    _state.cursor.position.line -= n;
+    _state.wrapPending = false;
+    auto const line = _state.cursor.position.line;
+    // A cursor above the top margin (only reachable while unconstrained by
+    // DECOM) stops at the page top instead.
+    auto const topBound = line >= _state.margin.vertical.from ? _state.margin.vertical.from : LineOffset(0);
+    _state.cursor.position.line = max(line - _n.as<LineOffset>(), topBound);
 }
 
 template <typename T>
 void Screen<T>::moveCursorDown(LineCount _n)
 {
-    _state.wrapPending = 0;
-    auto const currentLineNumber = logicalCursorPosition().line;
-    auto const n = min(_n.as<LineOffset>(),
-                       currentLineNumber <= _state.margin.vertical.to
-                           ? _state.margin.vertical.to - currentLineNumber
-                           : (boxed_cast<LineOffset>(_state.pageSize.lines) - 1) - currentLineNumber);
-
-    _state.cursor.position.line += n;
+    _state.wrapPending = false;
+    auto const line = _state.cursor.position.line;
+    auto const bottomBound = line <= _state.margin.vertical.to
+                                 ? _state.margin.vertical.to
+                                 : boxed_cast<LineOffset>(_state.pageSize.lines) - 1;
+    _state.cursor.position.line = min(line + _n.as<LineOffset>(), bottomBound);
 }
 
 template <typename T>
 void Screen<T>::moveCursorForward(ColumnCount _n)
 {
-    _state.wrapPending = 0;
+    _state.wrapPending = false;
     _state.cursor.position.column =
         min(_state.cursor.position.column + _n.as<ColumnOffset>(), _state.margin.horizontal.to);
 }
@@ -1592,9 +1785,12 @@ void Screen<T>::moveCursorBackward(ColumnCount _n)
     _state.wrapPending = false;
 
     // TODO: skip cells that in counting when iterating backwards over a wide cell (such as emoji)
-    auto const n = min(_n.as<ColumnOffset>(), _state.cursor.position.column);
-    setCurrentColumn(_state.cursor.position.column - n);
+    auto const column = _state.cursor.position.column;
+    auto const leftBound =
+        column >= _state.margin.horizontal.from ? _state.margin.horizontal.from : ColumnOffset(0);
+    _state.cursor.position.column = max(column - _n.as<ColumnOffset>(), leftBound);
 }
+// }}}
 
 template <typename T>
 void Screen<T>::moveCursorToColumn(ColumnOffset _column)
@@ -1622,15 +1818,14 @@ void Screen<T>::moveCursorToNextTab()
 
     if (!_state.tabs.empty())
     {
-        // advance to the next tab
-        size_t i = 0;
-        while (i < _state.tabs.size() && realCursorPosition().column >= _state.tabs[i])
-            ++i;
+        // advance to the next tab: O(1) via the column lookup, instead of
+        // re-scanning the stop list for every '\t' of a TSV-heavy dump
+        auto const nextStop = nextTabStop(realCursorPosition().column);
 
         auto const currentCursorColumn = logicalCursorPosition().column;
 
-        if (i < _state.tabs.size())
-            moveCursorForward(boxed_cast<ColumnCount>(_state.tabs[i] - currentCursorColumn));
+        if (nextStop != ColumnOffset(-1))
+            moveCursorForward(boxed_cast<ColumnCount>(nextStop - currentCursorColumn));
         else if (realCursorPosition().column < _state.margin.horizontal.to)
             moveCursorForward(boxed_cast<ColumnCount>(_state.margin.horizontal.to - currentCursorColumn));
         else
@@ -1673,9 +1868,27 @@ void Screen<T>::captureBuffer(int _lineCount, bool _logicalLines)
 {
     // TODO: Unit test case! (for ensuring line numbering and limits are working as expected)
 
+    // Reply frames are emitted as soon as a full frame's worth of text has
+    // accumulated, so capturing a large scrollback streams with bounded
+    // memory instead of first materializing the whole capture in one buffer.
+    auto constexpr FrameSize = size_t { 4096 };
+
     auto capturedBuffer = std::string();
     auto writer = VTWriter([&](auto buf, auto len) { capturedBuffer += string_view(buf, len); });
 
+    // Keeps at least one byte buffered: the logical-line handling above the
+    // flush point pops the previous line's trailing newline again, which must
+    // not have left the building yet.
+    auto const flushFullFrames = [&]() {
+        size_t i = 0;
+        while (capturedBuffer.size() - i > FrameSize)
+        {
+            reply("\033]314;{}\033\\", string_view(capturedBuffer.data() + i, FrameSize));
+            i += FrameSize;
+        }
+        capturedBuffer.erase(0, i);
+    };
+
     // TODO: when capturing _lineCount < screenSize.lines, start at the lowest non-empty line.
     auto const relativeStartLine =
         _logicalLines ? grid().computeLogicalLineNumberFromBottom(LineCount::cast_from(_lineCount))
@@ -1699,32 +1912,43 @@ void Screen<T>::captureBuffer(int _lineCount, bool _logicalLines)
         if (grid().isLineBlank(line))
             continue;
 
-        for (ColumnOffset col = ColumnOffset { 0 }; col < boxed_cast<ColumnOffset>(_state.pageSize.columns);
-             ++col)
+        if (auto const& gridLine = grid().lineAt(line); gridLine.isTrivialBuffer())
         {
-            Cell const& cell = at({ line, col });
-            if (!cell.codepointCount())
-                writer.write(U' ');
-            else
+            // Compact lines hold their US-ASCII text contiguously already;
+            // appending it directly avoids routing every cell through the
+            // UTF-8 writer (and avoids inflating the line).
+            capturedBuffer += gridLine.trivialBuffer().text;
+        }
+        else
+        {
+            for (ColumnOffset col = ColumnOffset { 0 };
+                 col < boxed_cast<ColumnOffset>(_state.pageSize.columns);
+                 ++col)
             {
-                writer.write(cell.codepoint(0));
-                for (size_t i = 1; i < cell.codepointCount(); ++i)
-                    writer.write(cell.codepoint(i));
+                Cell const& cell = at({ line, col });
+                if (!cell.codepointCount())
+                    writer.write(U' ');
+                else
+                {
+                    writer.write(cell.codepoint(0));
+                    for (size_t i = 1; i < cell.codepointCount(); ++i)
+                        writer.write(cell.codepoint(i));
+                }
             }
         }
         trimSpaceRight(capturedBuffer);
 
         writer.write('\n');
+        flushFullFrames();
     }
 
     while (crispy::endsWith(string_view(capturedBuffer), "\n\n"sv)) // TODO: unit test
         capturedBuffer.pop_back();
 
-    auto constexpr PageSize = size_t { 4096 };
-    for (size_t i = 0; i < capturedBuffer.size(); i += PageSize)
+    for (size_t i = 0; i < capturedBuffer.size(); i += FrameSize)
     {
         auto const start = capturedBuffer.data() + i;
-        auto const count = min(PageSize, capturedBuffer.size() - i);
+        auto const count = min(FrameSize, capturedBuffer.size() - i);
         reply("\033]314;{}\033\\", string_view(start, count));
     }
 
@@ -2156,6 +2380,30 @@ void Screen<T>::applicationKeypadMode(bool _enable)
     _terminal.setApplicationkeypadMode(_enable);
 }
 
+template <typename T>
+void Screen<T>::setKeyboardEnhancements(unsigned _flags, unsigned _mode)
+{
+    _terminal.setKeyboardEnhancements(_flags, _mode);
+}
+
+template <typename T>
+void Screen<T>::pushKeyboardEnhancements(unsigned _flags)
+{
+    _terminal.pushKeyboardEnhancements(_flags);
+}
+
+template <typename T>
+void Screen<T>::popKeyboardEnhancements(unsigned _count)
+{
+    _terminal.popKeyboardEnhancements(_count);
+}
+
+template <typename T>
+void Screen<T>::requestKeyboardEnhancements()
+{
+    reply("\033[?{}u", _terminal.keyboardEnhancements());
+}
+
 template <typename T>
 void Screen<T>::designateCharset(CharsetTable _table, CharsetId _charset)
 {
@@ -2377,25 +2625,15 @@ void Screen<T>::requestStatusString(RequestStatusString _value)
         switch (_value)
         {
         case RequestStatusString::DECSCL: {
-            auto level = 61;
-            switch (_state.terminalId)
-            {
-            case VTType::VT525:
-            case VTType::VT520:
-            case VTType::VT510: level = 65; break;
-            case VTType::VT420: level = 64; break;
-            case VTType::VT340:
-            case VTType::VT330:
-            case VTType::VT320: level = 63; break;
-            case VTType::VT240:
-            case VTType::VT220: level = 62; break;
-            case VTType::VT100: level = 61; break;
-            }
-
-            auto const c1TransmittionMode = ControlTransmissionMode::S7C1T;
-            auto const c1t = c1TransmittionMode == ControlTransmissionMode::S7C1T ? 1 : 0;
-
-            return fmt::format("{};{}\"p", level, c1t);
+            // Depends only on the conformance level (C1 transmission mode is
+            // fixed to S7C1T), so all responses are formatted up front.
+            static auto const responses = []() {
+                auto map = std::unordered_map<VTType, std::string> {};
+                for (VTType const id: AllVTTypes)
+                    map[id] = fmt::format("{};1\"p", conformanceLevelNumber(id));
+                return map;
+            }();
+            return responses.at(_state.terminalId);
         }
         case RequestStatusString::DECSCUSR: // Set cursor style (DECSCUSR), VT520
         {
@@ -2477,6 +2715,62 @@ namespace
     }
 } // namespace
 
+template <typename T>
+void Screen<T>::requestCapabilities(std::string_view _hexEncodedCapNames)
+{
+    if (!_state.respondToTCapQuery)
+    {
+        errorlog()("Requesting terminal capabilities ignored. Experimental tcap feature disabled.");
+        return;
+    }
+
+    // Like xterm, all capabilities of one XTGETTCAP query are answered with a
+    // single DCS reply, ';'-separated; Ps is 1 if at least one of them
+    // resolved.
+    string fragments;
+    auto anyValid = false;
+
+    for (auto const hexCap: crispy::split(_hexEncodedCapNames, ';'))
+    {
+        auto const capOpt = crispy::fromHexString(hexCap);
+        if (!capOpt)
+            continue;
+        auto const cap = string_view(capOpt.value());
+
+        auto const fragment = [&]() -> optional<string> {
+            // Contour extension: the most recent session statistics sample
+            // (ingest rate, compose rate, grid memory, renderer cache hit
+            // rates), see Terminal::statisticsLine().
+            if (cap == "contour-session-stats")
+                return fmt::format("{}={}", toHexString(cap), asHex(_state.terminal.statisticsLine()));
+            if (booleanCapability(cap))
+                return toHexString(cap);
+            if (auto const value = numericCapability(cap); value != capabilities::Database::npos)
+            {
+                auto hexValue = fmt::format("{:X}", value);
+                if (hexValue.size() % 2)
+                    hexValue.insert(hexValue.begin(), '0');
+                return fmt::format("{}={}", toHexString(cap), hexValue);
+            }
+            if (auto const value = stringCapability(cap); !value.empty())
+                return fmt::format("{}={}", toHexString(cap), asHex(value));
+            return nullopt;
+        }();
+
+        if (!fragment)
+            continue;
+        if (anyValid)
+            fragments += ';';
+        fragments += *fragment;
+        anyValid = true;
+    }
+
+    if (anyValid)
+        reply("\033P1+r{}\033\\", fragments);
+    else
+        reply("\033P0+r\033\\");
+}
+
 template <typename T>
 void Screen<T>::requestCapability(std::string_view _name)
 {
@@ -2608,6 +2902,7 @@ void Screen<T>::inspect(std::string const& _message, std::ostream& _os) const
         _os << fmt::format("real cursor position : {})\n", toRealCoordinate(_state.cursor.position));
     _os << fmt::format("vertical margins     : {}\n", _state.margin.vertical);
     _os << fmt::format("horizontal margins   : {}\n", _state.margin.horizontal);
+    _os << fmt::format("parser errors        : {}\n", _state.parser.errorCount());
     _os << gridInfoLine(grid());
 
     hline();
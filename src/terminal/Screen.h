@@ -99,6 +99,7 @@ class Screen: public capabilities::StaticDatabase
 
     void writeText(char32_t _char);
     void writeText(std::string_view _chars);
+    void writeText(std::u32string_view _codepoints);
 
     /// Renders the full screen by passing every grid cell to the callback.
     template <typename Renderer>
@@ -107,6 +108,15 @@ class Screen: public capabilities::StaticDatabase
         _state.activeGrid->render(std::forward<Renderer>(_render), _scrollOffset);
     }
 
+    /// Like render() above, but rows for which @p _skipRow returns true are
+    /// skipped without touching their line storage.
+    template <typename Renderer, typename RowFilter>
+    void render(Renderer&& _render, RowFilter&& _skipRow, ScrollOffset _scrollOffset) const
+    {
+        _state.activeGrid->render(
+            std::forward<Renderer>(_render), std::forward<RowFilter>(_skipRow), _scrollOffset);
+    }
+
     /// Renders the full screen as text into the given string. Each line will be terminated by LF.
     std::string renderMainPageText() const;
 
@@ -122,7 +132,8 @@ class Screen: public capabilities::StaticDatabase
     bool focused() const noexcept { return _state.focused; }
 
     // {{{ VT API
-    void linefeed(); // LF
+    void linefeed();                  // LF
+    void linefeeds(LineCount _count); // batched run of LF
 
     void clearToBeginOfLine();
     void clearToEndOfLine();
@@ -180,6 +191,10 @@ class Screen: public capabilities::StaticDatabase
     void requestDynamicColor(DynamicColorName _name);
     void requestCapability(capabilities::Code _code);
     void requestCapability(std::string_view _name);
+
+    /// Answers an XTGETTCAP query for a ';'-separated list of hex-encoded
+    /// capability names with a single batched DCS reply.
+    void requestCapabilities(std::string_view _hexEncodedCapNames);
     void sendDeviceAttributes();
     void sendTerminalId();
 
@@ -204,6 +219,10 @@ class Screen: public capabilities::StaticDatabase
     void screenAlignmentPattern();
     void sendMouseEvents(MouseProtocol _protocol, bool _enable);
     void applicationKeypadMode(bool _enable);
+    void setKeyboardEnhancements(unsigned _flags, unsigned _mode); // CSI = Ps ; Ps u
+    void pushKeyboardEnhancements(unsigned _flags);                // CSI > Ps u
+    void popKeyboardEnhancements(unsigned _count);                 // CSI < Ps u
+    void requestKeyboardEnhancements();                            // CSI ? u
     void designateCharset(CharsetTable _table, CharsetId _charset);
     void singleShiftSelect(CharsetTable _table);
     void requestPixelSize(RequestPixelSize _area);
@@ -474,6 +493,11 @@ class Screen: public capabilities::StaticDatabase
 
     std::shared_ptr<HyperlinkInfo> hyperlinkAt(CellLocation pos) noexcept
     {
+        // Trivial (compact) lines cannot carry hyperlinks; bail out early
+        // instead of inflating them on every mouse-move.
+        if (grid().lineAt(pos.line).isTrivialBuffer())
+            return {};
+
         return _state.hyperlinks.hyperlinkById(at(pos).hyperlink());
     }
 
@@ -487,6 +511,11 @@ class Screen: public capabilities::StaticDatabase
     void clearTabUnderCursor();
     void setTabUnderCursor();
 
+    /// Returns the column of the next configured tab stop right of @p _column,
+    /// or ColumnOffset(-1) if there is none, in O(1) via a lazily rebuilt
+    /// column lookup (see TerminalState::nextTabStopCache).
+    ColumnOffset nextTabStop(ColumnOffset _column);
+
     /// Applies LF but also moves cursor to given column @p _column.
     void linefeed(ColumnOffset _column);
 
@@ -55,6 +55,10 @@ class ScreenEvents
     virtual void resizeWindow(ImageSize) {}
     virtual void setApplicationkeypadMode(bool /*_enabled*/) {}
     virtual void setBracketedPaste(bool /*_enabled*/) {}
+    virtual void setKeyboardEnhancements(unsigned /*_flags*/, unsigned /*_mode*/) {}
+    virtual void pushKeyboardEnhancements(unsigned /*_flags*/) {}
+    virtual void popKeyboardEnhancements(unsigned /*_count*/) {}
+    virtual unsigned keyboardEnhancements() const noexcept { return 0; }
     virtual void setCursorStyle(CursorDisplay, CursorShape) {}
     virtual void setCursorVisibility(bool /*_visible*/) {}
     virtual void setGenerateFocusEvents(bool /*_enabled*/) {}
@@ -1440,30 +1440,33 @@ TEST_CASE("ScrollDown", "[screen]")
         screen.setTopBottomMargin(LineOffset { 1 }, LineOffset { 3 });
         screen.setMode(DECMode::Origin, true);
 
-        // SECTION("SD 1") {
-        //     screen.scrollDown(LineCount(1));
-        //     CHECK("12345\n6   0\nA789E\nFBCDJ\nKLMNO\n" == screen.renderMainPageText());
-        // }
-
-        // SECTION("SD 2") {
-        //     screen.scrollDown(LineCount(2));
-        //     CHECK(
-        //         "12345\n"
-        //         "6   0\n"
-        //         "A   E\n"
-        //         "F789J\n"
-        //         "KLMNO\n" == screen.renderMainPageText());
-        // }
-        //
-        // SECTION("SD 3") {
-        //     screen.scrollDown(LineCount(3));
-        //     CHECK(
-        //         "12345\n"
-        //         "6   0\n"
-        //         "A   E\n"
-        //         "F   J\n"
-        //         "KLMNO\n" == screen.renderMainPageText());
-        // }
+        SECTION("SD 1")
+        {
+            screen.scrollDown(LineCount(1));
+            CHECK("12345\n6   0\nA789E\nFBCDJ\nKLMNO\n" == screen.renderMainPageText());
+        }
+
+        SECTION("SD 2")
+        {
+            screen.scrollDown(LineCount(2));
+            CHECK("12345\n"
+                  "6   0\n"
+                  "A   E\n"
+                  "F789J\n"
+                  "KLMNO\n"
+                  == screen.renderMainPageText());
+        }
+
+        SECTION("SD 3")
+        {
+            screen.scrollDown(LineCount(3));
+            CHECK("12345\n"
+                  "6   0\n"
+                  "A   E\n"
+                  "F   J\n"
+                  "KLMNO\n"
+                  == screen.renderMainPageText());
+        }
     }
 
     SECTION("vertical margins")
@@ -3302,6 +3305,16 @@ TEST_CASE("Screen.tcap.string", "[screen, tcap]")
     REQUIRE(e(term.replyData) == e("\033P1+r687061=1B5B2569257031256447\033\\"));
 }
 
+TEST_CASE("Screen.tcap.multi", "[screen, tcap]")
+{
+    using namespace terminal;
+    auto term = MockTerm(PageSize { LineCount(3), ColumnCount(5) }, LineCount(2));
+    auto& screen = term.screen();
+    // A multi-capability query is answered with one batched reply.
+    screen.write("\033P+q636F6C6F7273;62656C\033\\"); // colors;bel
+    REQUIRE(e(term.replyData) == e("\033P1+r636F6C6F7273=0100;62656C=5E47\033\\"));
+}
+
 TEST_CASE("Sixel.simple", "[screen]")
 {
     auto const pageSize = PageSize { LineCount(10), ColumnCount(10) };
@@ -0,0 +1,215 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/Cell.h>
+#include <terminal/Grid.h>
+#include <terminal/Search.h>
+
+#include <crispy/ThreadPool.h>
+
+#include <unicode/convert.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <variant>
+
+using std::atomic;
+using std::condition_variable;
+using std::holds_alternative;
+using std::lock_guard;
+using std::max;
+using std::min;
+using std::mutex;
+using std::string_view;
+using std::u32string;
+using std::u32string_view;
+using std::unique_lock;
+using std::vector;
+
+namespace terminal
+{
+
+namespace
+{
+    /// Number of grid lines each worker grabs at once.
+    constexpr size_t SearchChunkSize = 4096;
+
+    u32string decodeUtf8(string_view _text)
+    {
+        u32string result;
+        result.reserve(_text.size());
+        auto state = unicode::utf8_decoder_state {};
+        for (char const ch: _text)
+        {
+            unicode::ConvertResult const r = unicode::from_utf8(state, static_cast<uint8_t>(ch));
+            if (holds_alternative<unicode::Success>(r))
+                result.push_back(std::get<unicode::Success>(r).value);
+            else if (holds_alternative<unicode::Invalid>(r))
+                result.push_back(0xFFFD);
+        }
+        return result;
+    }
+
+    template <typename Cell>
+    void searchLine(Line<Cell> const& _line,
+                    LineOffset _lineOffset,
+                    string_view _pattern,
+                    u32string const& _pattern32,
+                    u32string& _text32,
+                    vector<ColumnOffset>& _columns,
+                    vector<SearchMatch>& _out)
+    {
+        if (_line.isTrivialBuffer())
+        {
+            // Compact lines hold one printable US-ASCII byte per column (the
+            // SimpleLineBuffer invariant enforced by deflate()), so byte
+            // offsets are column offsets and the byte-wise find() cannot
+            // partially match a multi-byte sequence; std::string_view::find
+            // is memchr-backed and needs no cell materialization at all.
+            auto const text = string_view(_line.trivialBuffer().text);
+            for (auto pos = text.find(_pattern); pos != string_view::npos; pos = text.find(_pattern, pos + 1))
+                _out.emplace_back(SearchMatch { _lineOffset, ColumnOffset::cast_from(pos) });
+            return;
+        }
+
+        // Rich lines: match on the primary codepoint of each non-padding cell,
+        // remembering the originating column for wide characters.
+        _text32.clear();
+        _columns.clear();
+        auto column = ColumnOffset(0);
+        for (Cell const& cell: _line.cells())
+        {
+            if (auto const codepoint = cell.codepoint(0); codepoint)
+            {
+                _text32.push_back(codepoint);
+                _columns.push_back(column);
+            }
+            ++column;
+        }
+
+        auto const haystack = u32string_view(_text32);
+        for (auto pos = haystack.find(_pattern32); pos != u32string_view::npos;
+             pos = haystack.find(_pattern32, pos + 1))
+            _out.emplace_back(SearchMatch { _lineOffset, _columns[pos] });
+    }
+} // namespace
+
+template <typename Cell>
+void search(Grid<Cell> const& _grid, string_view _pattern, SearchMatchSink const& _sink)
+{
+    if (_pattern.empty())
+        return;
+
+    auto const firstLine = -unbox<int>(_grid.historyLineCount());
+    auto const lastLine = unbox<int>(_grid.pageSize().lines); // exclusive
+    auto const totalLines = static_cast<size_t>(lastLine - firstLine);
+    auto const pattern32 = decodeUtf8(_pattern);
+    auto const chunkCount = (totalLines + SearchChunkSize - 1) / SearchChunkSize;
+
+    auto const scanChunk =
+        [&](size_t _chunk, u32string& _text32, vector<ColumnOffset>& _columns, vector<SearchMatch>& _out) {
+            auto const begin = firstLine + static_cast<int>(_chunk * SearchChunkSize);
+            auto const end = min(lastLine, begin + static_cast<int>(SearchChunkSize));
+            _grid.forEachLine(LineOffset::cast_from(begin),
+                              LineOffset::cast_from(end - 1),
+                              [&](LineOffset _lineOffset, Line<Cell> const& _line) {
+                                  searchLine(_line, _lineOffset, _pattern, pattern32, _text32, _columns, _out);
+                              });
+        };
+
+    auto& pool = crispy::ThreadPool::instance();
+    auto const workerCount = min(pool.concurrency(), chunkCount);
+
+    if (workerCount <= 1)
+    {
+        // Small histories are not worth the scheduling overhead.
+        u32string text32;
+        vector<ColumnOffset> columns;
+        vector<SearchMatch> matches;
+        for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            matches.clear();
+            scanChunk(chunk, text32, columns, matches);
+            if (!matches.empty())
+                _sink(matches);
+        }
+        return;
+    }
+
+    auto chunkResults = vector<vector<SearchMatch>>(chunkCount);
+    auto chunkDone = vector<char>(chunkCount, char(false));
+    auto nextChunk = atomic<size_t> { 0 };
+    auto doneMutex = mutex {};
+    auto doneSignal = condition_variable {};
+    auto activeWorkers = workerCount; // guarded by doneMutex
+
+    auto const worker = [&]() {
+        u32string text32;
+        vector<ColumnOffset> columns;
+        for (;;)
+        {
+            auto const chunk = nextChunk.fetch_add(1);
+            if (chunk >= chunkCount)
+                break;
+            scanChunk(chunk, text32, columns, chunkResults[chunk]);
+            {
+                auto const _lock = lock_guard { doneMutex };
+                chunkDone[chunk] = char(true);
+            }
+            doneSignal.notify_all();
+        }
+        // Notified under the lock so the cv is guaranteed not to be
+        // destroyed (along with search()'s stack frame) mid-notify.
+        auto const _lock = lock_guard { doneMutex };
+        --activeWorkers;
+        doneSignal.notify_all();
+    };
+
+    // The searching thread is blocking on the result, so this counts as
+    // frame-critical work on the shared pool.
+    for (size_t i = 0; i < workerCount; ++i)
+        pool.enqueue(worker, crispy::ThreadPool::Priority::FrameCritical);
+
+    // Stream finished chunks to the sink in line order.
+    for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+    {
+        auto lock = unique_lock { doneMutex };
+        doneSignal.wait(lock, [&]() { return static_cast<bool>(chunkDone[chunk]); });
+        lock.unlock();
+        if (!chunkResults[chunk].empty())
+            _sink(chunkResults[chunk]);
+    }
+
+    // All chunks are done, but the last workers may still be about to
+    // return; their captures must outlive them.
+    auto lock = unique_lock { doneMutex };
+    doneSignal.wait(lock, [&]() { return activeWorkers == 0; });
+}
+
+template <typename Cell>
+vector<SearchMatch> search(Grid<Cell> const& _grid, string_view _pattern)
+{
+    auto all = vector<SearchMatch> {};
+    search(_grid, _pattern, [&](vector<SearchMatch> const& _matches) {
+        all.insert(all.end(), _matches.begin(), _matches.end());
+    });
+    return all;
+}
+
+template void search<Cell>(Grid<Cell> const&, string_view, SearchMatchSink const&);
+template vector<SearchMatch> search<Cell>(Grid<Cell> const&, string_view);
+
+} // namespace terminal
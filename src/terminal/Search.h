@@ -0,0 +1,89 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <terminal/primitives.h>
+
+#include <fmt/format.h>
+
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace terminal
+{
+
+template <typename Cell>
+class Grid;
+
+/// A single search hit inside the grid.
+///
+/// @c line is given in grid coordinates, i.e. negative offsets address
+/// scrollback (history) lines, and @c column is the first cell of the match.
+struct SearchMatch
+{
+    LineOffset line;
+    ColumnOffset column;
+};
+
+constexpr bool operator==(SearchMatch a, SearchMatch b) noexcept
+{
+    return a.line == b.line && a.column == b.column;
+}
+
+constexpr bool operator!=(SearchMatch a, SearchMatch b) noexcept
+{
+    return !(a == b);
+}
+
+/// Receives search results incrementally, one batch per scanned chunk,
+/// ordered from the top of the scrollback towards the bottom of the page.
+using SearchMatchSink = std::function<void(std::vector<SearchMatch> const&)>;
+
+/// Searches the whole grid (scrollback plus main page) for @p _pattern.
+///
+/// The line range is sharded into fixed-size chunks that are scanned by
+/// parallel workers. Compact (trivial) lines are matched directly on their
+/// text run via std::string_view::find; only rich lines are matched per
+/// cell. Finished chunks are streamed to @p _sink in line order, so first
+/// results arrive long before a large history has been fully scanned.
+///
+/// Matches do not span line boundaries. The grid must not be mutated while
+/// the search is running.
+template <typename Cell>
+void search(Grid<Cell> const& _grid, std::string_view _pattern, SearchMatchSink const& _sink);
+
+/// Convenience overload, collecting all matches into one vector.
+template <typename Cell>
+std::vector<SearchMatch> search(Grid<Cell> const& _grid, std::string_view _pattern);
+
+} // namespace terminal
+
+namespace fmt
+{
+template <>
+struct formatter<terminal::SearchMatch>
+{
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext& ctx)
+    {
+        return ctx.begin();
+    }
+    template <typename FormatContext>
+    auto format(terminal::SearchMatch value, FormatContext& ctx)
+    {
+        return format_to(ctx.out(), "({}, {})", value.line, value.column);
+    }
+};
+} // namespace fmt
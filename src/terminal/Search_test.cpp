@@ -0,0 +1,127 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/Cell.h>
+#include <terminal/Grid.h>
+#include <terminal/Search.h>
+
+#include <catch2/catch.hpp>
+
+using namespace terminal;
+using namespace std::string_view_literals;
+using std::string_view;
+using std::vector;
+
+namespace
+{
+Grid<Cell> setupGrid(PageSize _pageSize,
+                     LineCount _maxHistoryLineCount,
+                     std::initializer_list<string_view> init)
+{
+    auto grid = Grid<Cell>(_pageSize, false, _maxHistoryLineCount);
+
+    int cursor = 0;
+    for (string_view line: init)
+    {
+        if (cursor == *_pageSize.lines)
+            grid.scrollUp(LineCount(1));
+        else
+            ++cursor;
+
+        grid.setLineText(LineOffset::cast_from(cursor - 1), line);
+    }
+    return grid;
+}
+} // namespace
+
+TEST_CASE("Search.simple", "[search]")
+{
+    auto const grid = setupGrid(PageSize { LineCount(2), ColumnCount(8) },
+                                LineCount(0),
+                                {
+                                    "herbert"sv,
+                                    "berta"sv,
+                                });
+
+    auto const matches = search(grid, "ber");
+    REQUIRE(matches.size() == 2);
+    CHECK(matches[0] == SearchMatch { LineOffset(0), ColumnOffset(3) });
+    CHECK(matches[1] == SearchMatch { LineOffset(1), ColumnOffset(0) });
+}
+
+TEST_CASE("Search.multipleMatchesPerLine", "[search]")
+{
+    auto const grid = setupGrid(PageSize { LineCount(1), ColumnCount(10) },
+                                LineCount(0),
+                                {
+                                    "abcabcabc"sv,
+                                });
+
+    auto const matches = search(grid, "abc");
+    REQUIRE(matches.size() == 3);
+    CHECK(matches[0].column == ColumnOffset(0));
+    CHECK(matches[1].column == ColumnOffset(3));
+    CHECK(matches[2].column == ColumnOffset(6));
+}
+
+TEST_CASE("Search.history", "[search]")
+{
+    auto const grid = setupGrid(PageSize { LineCount(2), ColumnCount(8) },
+                                LineCount(2),
+                                {
+                                    "one"sv,
+                                    "two"sv,
+                                    "three"sv,
+                                    "four"sv,
+                                });
+    REQUIRE(grid.historyLineCount() == LineCount(2));
+
+    auto const matches = search(grid, "o");
+    REQUIRE(matches.size() == 3);
+    CHECK(matches[0] == SearchMatch { LineOffset(-2), ColumnOffset(0) });
+    CHECK(matches[1] == SearchMatch { LineOffset(-1), ColumnOffset(2) });
+    CHECK(matches[2] == SearchMatch { LineOffset(1), ColumnOffset(1) });
+}
+
+TEST_CASE("Search.noMatch", "[search]")
+{
+    auto const grid = setupGrid(PageSize { LineCount(2), ColumnCount(8) },
+                                LineCount(0),
+                                {
+                                    "hello"sv,
+                                    "world"sv,
+                                });
+
+    CHECK(search(grid, "xyz").empty());
+    CHECK(search(grid, "").empty());
+}
+
+TEST_CASE("Search.sinkReceivesOrderedBatches", "[search]")
+{
+    auto const grid = setupGrid(PageSize { LineCount(3), ColumnCount(8) },
+                                LineCount(0),
+                                {
+                                    "foo"sv,
+                                    "bar"sv,
+                                    "foobar"sv,
+                                });
+
+    auto streamed = vector<SearchMatch> {};
+    search(grid, "foo", [&](vector<SearchMatch> const& _matches) {
+        streamed.insert(streamed.end(), _matches.begin(), _matches.end());
+    });
+
+    REQUIRE(streamed.size() == 2);
+    CHECK(streamed[0] == SearchMatch { LineOffset(0), ColumnOffset(0) });
+    CHECK(streamed[1] == SearchMatch { LineOffset(2), ColumnOffset(0) });
+}
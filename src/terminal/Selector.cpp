@@ -18,6 +18,7 @@
 #include <crispy/times.h>
 
 #include <cassert>
+#include <cstdlib>
 
 using namespace std;
 
@@ -56,12 +57,88 @@ namespace // {{{ helper
 } // namespace
 
 // {{{ Selection
-void Selection::extend(CellLocation _to)
+bool Selection::extend(CellLocation _to)
 {
     assert(state_ != State::Complete
            && "In order extend a selection, the selector must be active (started).");
     state_ = State::InProgress;
+    if (to_ == _to)
+        return false;
+    auto const oldTo = to_;
     to_ = _to;
+    updateSpans(oldTo);
+    return true;
+}
+
+Selection::Range Selection::makeLinearSpan(LineOffset _line) const noexcept
+{
+    auto const rightMargin = boxed_cast<ColumnOffset>(helper_.pageSize().columns - 1);
+    auto const [lo, hi] = from_ <= to_ ? pair { from_, to_ } : pair { to_, from_ };
+    auto const fromColumn = _line == lo.line ? lo.column : ColumnOffset(0);
+    auto const toColumn = _line == hi.line ? min(hi.column, rightMargin) : rightMargin;
+    return Range { _line, fromColumn, toColumn };
+}
+
+void Selection::rebuildSpans() const
+{
+    auto const step = *to_.line >= *from_.line ? 1 : -1;
+    auto const count = static_cast<size_t>(abs(*to_.line - *from_.line)) + 1;
+
+    spans_.clear();
+    spans_.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+        spans_.push_back(makeLinearSpan(from_.line + LineOffset::cast_from(step * static_cast<int>(i))));
+
+    spansAnchor_ = from_;
+    spansEdge_ = to_;
+    spansValid_ = true;
+}
+
+void Selection::ensureSpansValid() const
+{
+    if (!spansValid_ || spansAnchor_ != from_ || spansEdge_ != to_)
+        rebuildSpans();
+}
+
+void Selection::updateSpans(CellLocation _oldTo)
+{
+    // The incremental path requires an up-to-date cache, an unchanged anchor
+    // and the edge staying on the same side of the anchor; everything else
+    // (stale cache, word/line selections adjusting the anchor, the edge
+    // crossing the anchor) falls back to a full rebuild - which is cheap in
+    // exactly those situations, as the edge is near the anchor then.
+    bool const orientationFlipped =
+        (*_oldTo.line - *from_.line < 0) != (*to_.line - *from_.line < 0);
+    if (!spansValid_ || spansAnchor_ != from_ || spansEdge_ != _oldTo || orientationFlipped)
+    {
+        rebuildSpans();
+        return;
+    }
+
+    auto const step = *to_.line >= *from_.line ? 1 : -1;
+    auto const targetCount = static_cast<size_t>(abs(*to_.line - *from_.line)) + 1;
+
+    while (spans_.size() > targetCount)
+        spans_.pop_back();
+
+    // The previous edge line may have become an interior (full-width) line.
+    spans_.back() = makeLinearSpan(spans_.back().line);
+
+    while (spans_.size() < targetCount)
+        spans_.push_back(
+            makeLinearSpan(from_.line + LineOffset::cast_from(step * static_cast<int>(spans_.size()))));
+
+    // Boundary columns on the anchor and edge lines follow the edge's column.
+    spans_.front() = makeLinearSpan(from_.line);
+    spans_.back() = makeLinearSpan(to_.line);
+
+    spansEdge_ = to_;
+}
+
+gsl::span<Selection::Range const> Selection::spans() const
+{
+    ensureSpansValid();
+    return gsl::span(spans_.data(), spans_.size());
 }
 
 void Selection::complete()
@@ -215,17 +292,18 @@ CellLocation WordWiseSelection::extendSelectionForward(CellLocation _pos) const
     return stretchedColumn(helper_, last);
 }
 
-void WordWiseSelection::extend(CellLocation _to)
+bool WordWiseSelection::extend(CellLocation _to)
 {
+    auto const oldFrom = from_;
     if (_to >= from_) // extending to the right
     {
         from_ = extendSelectionBackward(from_);
-        Selection::extend(extendSelectionForward(_to));
+        return Selection::extend(extendSelectionForward(_to)) || from_ != oldFrom;
     }
     else // extending to the left
     {
         from_ = extendSelectionForward(from_);
-        Selection::extend(extendSelectionBackward(_to));
+        return Selection::extend(extendSelectionBackward(_to)) || from_ != oldFrom;
     }
 }
 // }}}
@@ -285,6 +363,29 @@ vector<Selection::Range> RectangularSelection::ranges() const
 
     return result;
 }
+
+gsl::span<Selection::Range const> RectangularSelection::spans() const
+{
+    // A moving edge shifts the column range of every covered line, so there is
+    // no delta to exploit; memoizing per (anchor, edge) pair still avoids the
+    // rebuild on every render pass.
+    if (!spansValid_ || spansAnchor_ != from_ || spansEdge_ != to_)
+    {
+        spans_ = ranges();
+        spansAnchor_ = from_;
+        spansEdge_ = to_;
+        spansValid_ = true;
+    }
+    return gsl::span(spans_.data(), spans_.size());
+}
+
+void RectangularSelection::updateSpans(CellLocation /*_oldTo*/)
+{
+    spans_ = ranges();
+    spansAnchor_ = from_;
+    spansEdge_ = to_;
+    spansValid_ = true;
+}
 // }}}
 // {{{ FullLineSelection
 FullLineSelection::FullLineSelection(SelectionHelper const& _helper, CellLocation _start):
@@ -294,8 +395,9 @@ FullLineSelection::FullLineSelection(SelectionHelper const& _helper, CellLocatio
     to_.column = boxed_cast<ColumnOffset>(helper_.pageSize().columns - 1);
 }
 
-void FullLineSelection::extend(CellLocation _to)
+bool FullLineSelection::extend(CellLocation _to)
 {
+    auto const oldFrom = from_;
     if (_to >= from_)
     {
         from_.column = ColumnOffset(0);
@@ -311,7 +413,7 @@ void FullLineSelection::extend(CellLocation _to)
             --_to.line;
     }
 
-    Selection::extend(_to);
+    return Selection::extend(_to) || from_ != oldFrom;
 }
 // }}}
 
@@ -21,6 +21,9 @@
 
 #include <fmt/format.h>
 
+#include <gsl/span>
+#include <gsl/span_ext>
+
 #include <functional>
 #include <utility>
 #include <vector>
@@ -106,11 +109,24 @@ class Selection
     constexpr State state() const noexcept { return state_; }
 
     /// Extends the selection to the given coordinate.
-    virtual void extend(CellLocation _to);
-
-    /// Constructs a vector of ranges for this selection.
+    ///
+    /// @returns boolean indicating whether or not the selection's covered region actually changed,
+    ///          so callers can avoid needlessly invalidating the render buffer.
+    virtual bool extend(CellLocation _to);
+
+    /// Constructs a vector of ranges for this selection, ascending by line.
+    ///
+    /// This builds a fresh snapshot on every call; the render path uses
+    /// spans() instead, which serves the incrementally maintained cache.
     virtual std::vector<Range> ranges() const;
 
+    /// Returns the selection's spans in anchor-first order, one per line.
+    ///
+    /// The spans are maintained incrementally while the selection is being
+    /// extended (mouse drag): only the moving edge is updated, so a drag
+    /// event costs O(changed lines) instead of O(selected lines).
+    virtual gsl::span<Range const> spans() const;
+
     /// Marks the selection as completed.
     void complete();
 
@@ -120,10 +136,32 @@ class Selection
     static CellLocation stretchedColumn(SelectionHelper const& _helper, CellLocation _coord) noexcept;
 
   protected:
+    /// Computes the span covering @p _line for the current linear geometry.
+    Range makeLinearSpan(LineOffset _line) const noexcept;
+
+    /// Rebuilds the span cache from scratch; O(selected lines).
+    void rebuildSpans() const;
+
+    /// Rebuilds the span cache unless it matches the current (from_, to_) pair.
+    void ensureSpansValid() const;
+
+    /// Applies the edge movement @p _oldTo -> to_ to the span cache.
+    virtual void updateSpans(CellLocation _oldTo);
+
     State state_ = State::Waiting;
     SelectionHelper const& helper_;
     CellLocation from_;
     CellLocation to_;
+
+    // {{{ anchor-ordered span cache
+    // spans_[0] covers the anchor (from_) line and the walk continues toward
+    // to_'s line, so the moving edge of a drag always sits at the back of the
+    // vector and extend() can grow/shrink it in O(changed lines).
+    mutable std::vector<Range> spans_ {};
+    mutable CellLocation spansAnchor_ {};
+    mutable CellLocation spansEdge_ {};
+    mutable bool spansValid_ = false;
+    // }}}
 };
 
 class RectangularSelection: public Selection
@@ -133,6 +171,10 @@ class RectangularSelection: public Selection
     bool contains(CellLocation _coord) const noexcept override;
     bool intersects(Rect _area) const noexcept override;
     std::vector<Range> ranges() const override;
+    gsl::span<Range const> spans() const override;
+
+  protected:
+    void updateSpans(CellLocation _oldTo) override;
 };
 
 class LinearSelection: public Selection
@@ -146,7 +188,7 @@ class WordWiseSelection: public Selection
   public:
     WordWiseSelection(SelectionHelper const& _helper, CellLocation _start);
 
-    void extend(CellLocation _to) override;
+    bool extend(CellLocation _to) override;
 
     CellLocation extendSelectionBackward(CellLocation _pos) const noexcept;
     CellLocation extendSelectionForward(CellLocation _pos) const noexcept;
@@ -156,7 +198,7 @@ class FullLineSelection: public Selection
 {
   public:
     explicit FullLineSelection(SelectionHelper const& _helper, CellLocation _start);
-    void extend(CellLocation _to) override;
+    bool extend(CellLocation _to) override;
 };
 
 template <typename Renderer>
@@ -174,7 +216,7 @@ inline void Selection::applyScroll(LineOffset _value, LineCount _historyLineCoun
 template <typename Renderer>
 void renderSelection(Selection const& _selection, Renderer&& _render)
 {
-    for (Selection::Range const& range: _selection.ranges())
+    for (Selection::Range const& range: _selection.spans())
         for (auto const col: crispy::times(*range.fromColumn, *range.length()))
             _render(CellLocation { range.line, ColumnOffset::cast_from(col) });
 }
@@ -17,6 +17,8 @@
 
 #include <catch2/catch.hpp>
 
+#include <algorithm>
+
 using crispy::Size;
 using namespace std;
 using namespace std::placeholders;
@@ -248,6 +250,43 @@ TEST_CASE("Selector.Linear", "[selector]")
     }
 }
 
+TEST_CASE("Selector.Linear.IncrementalSpans", "[selector]")
+{
+    auto screenEvents = ScreenEvents {};
+    auto term = MockTerm(PageSize { LineCount(5), ColumnCount(11) }, LineCount(5));
+    auto& screen = term.screen();
+    auto selectionHelper = TestSelectionHelper(screen);
+    screen.write("AAAAAAAAAAA"s + "BBBBBBBBBBB"s + "CCCCCCCCCCC"s + "DDDDDDDDDDD"s + "EEEEEEEEEEE"s);
+
+    auto const anchor = CellLocation { LineOffset(2), ColumnOffset(4) };
+    auto selector = LinearSelection(selectionHelper, anchor);
+
+    // The incrementally maintained spans must match a fresh full computation
+    // after every drag step, in both directions and across the anchor.
+    auto const dragSteps = vector<CellLocation> {
+        CellLocation { LineOffset(2), ColumnOffset(7) }, CellLocation { LineOffset(4), ColumnOffset(2) },
+        CellLocation { LineOffset(3), ColumnOffset(9) }, CellLocation { LineOffset(0), ColumnOffset(5) },
+        CellLocation { LineOffset(1), ColumnOffset(0) }, CellLocation { LineOffset(4), ColumnOffset(10) },
+    };
+
+    for (CellLocation const& to: dragSteps)
+    {
+        selector.extend(to);
+
+        auto const expected = selector.ranges(); // full rebuild, ascending by line
+        auto spans = vector<Selection::Range>(selector.spans().begin(), selector.spans().end());
+        sort(spans.begin(), spans.end(), [](auto const& a, auto const& b) { return a.line < b.line; });
+
+        REQUIRE(spans.size() == expected.size());
+        for (size_t i = 0; i < spans.size(); ++i)
+        {
+            CHECK(spans[i].line == expected[i].line);
+            CHECK(spans[i].fromColumn == expected[i].fromColumn);
+            CHECK(spans[i].toColumn == expected[i].toColumn);
+        }
+    }
+}
+
 TEST_CASE("Selector.LinearWordWise", "[selector]")
 {
     // TODO
@@ -62,15 +62,15 @@ string Sequence::text() const
     if (parameterCount() > 1 || (parameterCount() == 1 && parameters_[0][0] != 0))
     {
         sstr << ' '
-             << accumulate(begin(parameters_),
-                           end(parameters_),
+             << accumulate(parameters_.begin(),
+                           parameters_.end(),
                            string {},
                            [](string const& a, auto const& p) -> string {
                                return !a.empty()
                                           ? fmt::format("{};{}",
                                                         a,
-                                                        accumulate(begin(p),
-                                                                   end(p),
+                                                        accumulate(p.begin(),
+                                                                   p.end(),
                                                                    string {},
                                                                    [](string const& x,
                                                                       Sequence::Parameter y) -> string {
@@ -78,8 +78,8 @@ string Sequence::text() const
                                                                                   ? fmt::format("{}:{}", x, y)
                                                                                   : std::to_string(y);
                                                                    }))
-                                          : accumulate(begin(p),
-                                                       end(p),
+                                          : accumulate(p.begin(),
+                                                       p.end(),
                                                        string {},
                                                        [](string const& x, Sequence::Parameter y) -> string {
                                                            return !x.empty() ? fmt::format("{}:{}", x, y)
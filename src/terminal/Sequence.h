@@ -16,7 +16,10 @@
 #include <terminal/Functions.h>
 // #include <terminal/primitives.h>
 
+#include <array>
 #include <cassert>
+#include <cstdint>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -25,12 +28,146 @@
 namespace terminal
 {
 
+/// Fixed-capacity parameter storage of a VT sequence.
+///
+/// Parameters and their colon-separated sub-parameters are stored in a single
+/// flat inline array, with each parameter referencing a contiguous run of it.
+/// This keeps the parse-to-dispatch path free of heap allocations; SGR-heavy
+/// streams construct millions of these. Appends beyond the (generous) inline
+/// capacity are silently dropped, matching how parameters beyond the
+/// supported maximum have always been ignored.
+class SequenceParameters
+{
+  public:
+    using Parameter = unsigned;
+
+    /// Parse-time sequences are capped at Sequence::MaxParameters already; the
+    /// larger capacity here accommodates the coalesced SGR batch
+    /// (see Sequencer::batchSequence).
+    static constexpr size_t MaxParameterCount = 128;
+    static constexpr size_t MaxValueCount = 256;
+
+    /// Read-only view of a single parameter and its sub-parameters.
+    class View
+    {
+      public:
+        View(Parameter const* _values, size_t _count) noexcept: values_ { _values }, count_ { _count } {}
+
+        size_t size() const noexcept { return count_; }
+        Parameter operator[](size_t _index) const noexcept { return values_[_index]; }
+        Parameter const* begin() const noexcept { return values_; }
+        Parameter const* end() const noexcept { return values_ + count_; }
+
+      private:
+        Parameter const* values_;
+        size_t count_;
+    };
+
+    /// Mutable accessor to the most recently appended parameter.
+    class LastParameter
+    {
+      public:
+        explicit LastParameter(SequenceParameters& _parent) noexcept: parent_ { _parent } {}
+
+        size_t size() const noexcept { return parent_.subCounts_[parent_.parameterCount_ - 1]; }
+        void push_back(Parameter _value) noexcept { parent_.appendSubParameter(_value); }
+        Parameter& back() noexcept { return parent_.values_[parent_.valueCount_ - 1]; }
+
+      private:
+        SequenceParameters& parent_;
+    };
+
+    struct const_iterator
+    {
+        using value_type = View;
+        using difference_type = std::ptrdiff_t;
+        using pointer = View const*;
+        using reference = View;
+        using iterator_category = std::forward_iterator_tag;
+
+        SequenceParameters const* parent;
+        size_t index;
+
+        View operator*() const noexcept { return (*parent)[index]; }
+        const_iterator& operator++() noexcept
+        {
+            ++index;
+            return *this;
+        }
+        bool operator==(const_iterator const& _other) const noexcept { return index == _other.index; }
+        bool operator!=(const_iterator const& _other) const noexcept { return index != _other.index; }
+    };
+
+    size_t size() const noexcept { return parameterCount_; }
+    bool empty() const noexcept { return parameterCount_ == 0; }
+
+    /// Total number of values stored, i.e. parameters plus sub-parameters.
+    size_t valueCount() const noexcept { return valueCount_; }
+
+    void clear() noexcept
+    {
+        parameterCount_ = 0;
+        valueCount_ = 0;
+    }
+
+    /// Appends a new parameter holding the single value @p _value.
+    void push_back(Parameter _value) noexcept
+    {
+        if (parameterCount_ == MaxParameterCount || valueCount_ == MaxValueCount)
+            return;
+        begins_[parameterCount_] = static_cast<uint16_t>(valueCount_);
+        subCounts_[parameterCount_] = 1;
+        values_[valueCount_++] = _value;
+        ++parameterCount_;
+    }
+
+    /// Appends a new parameter copying @p _values (parameter plus sub-parameters).
+    void push_back(View _values) noexcept
+    {
+        if (_values.size() == 0 || parameterCount_ == MaxParameterCount
+            || valueCount_ + _values.size() > MaxValueCount)
+            return;
+        begins_[parameterCount_] = static_cast<uint16_t>(valueCount_);
+        subCounts_[parameterCount_] = static_cast<uint8_t>(_values.size());
+        for (Parameter const value: _values)
+            values_[valueCount_++] = value;
+        ++parameterCount_;
+    }
+
+    LastParameter back() noexcept { return LastParameter { *this }; }
+
+    View operator[](size_t _index) const noexcept
+    {
+        return View(values_.data() + begins_[_index], subCounts_[_index]);
+    }
+
+    const_iterator begin() const noexcept { return const_iterator { this, 0 }; }
+    const_iterator end() const noexcept { return const_iterator { this, parameterCount_ }; }
+
+  private:
+    /// Appends @p _value as sub-parameter to the most recently appended parameter,
+    /// which by construction owns the tail of the flat value array.
+    void appendSubParameter(Parameter _value) noexcept
+    {
+        if (valueCount_ == MaxValueCount)
+            return;
+        values_[valueCount_++] = _value;
+        ++subCounts_[parameterCount_ - 1];
+    }
+
+    std::array<Parameter, MaxValueCount> values_ {};
+    std::array<uint16_t, MaxParameterCount> begins_ {};
+    std::array<uint8_t, MaxParameterCount> subCounts_ {};
+    uint16_t parameterCount_ = 0;
+    uint16_t valueCount_ = 0;
+};
+
 /// Helps constructing VT functions as they're being parsed by the VT parser.
 class Sequence
 {
   public:
-    using Parameter = unsigned;
-    using ParameterList = std::vector<std::vector<Parameter>>;
+    using Parameter = SequenceParameters::Parameter;
+    using ParameterList = SequenceParameters;
     using Intermediaries = std::string;
     using DataString = std::string;
 
@@ -47,13 +184,7 @@ class Sequence
     size_t constexpr static MaxSubParameters = 8;
     size_t constexpr static MaxOscLength = 512;
 
-    Sequence()
-    {
-        parameters_.resize(MaxParameters);
-        for (auto& param: parameters_)
-            param.reserve(MaxSubParameters);
-        parameters_.clear();
-    }
+    Sequence() = default;
 
     // mutators
     //
@@ -107,6 +238,7 @@ class Sequence
     // accessors
     //
     FunctionCategory category() const noexcept { return category_; }
+    char leaderSymbol() const noexcept { return leaderSymbol_; }
     Intermediaries const& intermediateCharacters() const noexcept { return intermediateCharacters_; }
     char finalChar() const noexcept { return finalChar_; }
 
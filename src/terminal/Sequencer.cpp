@@ -12,6 +12,7 @@
  * limitations under the License.
  */
 #include <terminal/Functions.h>
+#include <terminal/KittyGraphics.h>
 #include <terminal/Screen.h>
 #include <terminal/Sequencer.h>
 #include <terminal/SixelParser.h>
@@ -29,6 +30,7 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdlib>
 #include <iostream> // error logging
@@ -59,6 +61,7 @@ using std::stoi;
 using std::string;
 using std::string_view;
 using std::stringstream;
+using std::u32string_view;
 using std::unique_ptr;
 using std::vector;
 
@@ -635,6 +638,7 @@ namespace impl
             return ApplyResult::Invalid;
 
         _screen.colorPalette().palette[*index] = _screen.defaultColorPalette().palette[*index];
+        _screen.colorPalette().updateRenderColors();
 
         return ApplyResult::Ok;
     }
@@ -642,6 +646,7 @@ namespace impl
     template <typename TheTerminal>
     ApplyResult SETCOLPAL(Sequence const& _seq, Screen<TheTerminal>& _screen)
     {
+        bool mutated = false;
         bool const ok = queryOrSetColorPalette(
             _seq.intermediateCharacters(),
             [&](uint8_t index) {
@@ -652,7 +657,13 @@ namespace impl
                               static_cast<uint16_t>(color.green) << 8 | color.green,
                               static_cast<uint16_t>(color.blue) << 8 | color.blue);
             },
-            [&](uint8_t index, RGBColor color) { _screen.colorPalette().palette.at(index) = color; });
+            [&](uint8_t index, RGBColor color) {
+                _screen.colorPalette().palette.at(index) = color;
+                mutated = true;
+            });
+
+        if (mutated)
+            _screen.colorPalette().updateRenderColors();
 
         return ok ? ApplyResult::Ok : ApplyResult::Invalid;
     }
@@ -1001,6 +1012,8 @@ void Sequencer<TheTerminal>::error(std::string_view _errorString)
 template <typename TheTerminal>
 void Sequencer<TheTerminal>::print(char _char)
 {
+    flushBatchedSequence();
+
     unicode::ConvertResult const r = unicode::from_utf8(state().utf8DecoderState, (uint8_t) _char);
     if (holds_alternative<unicode::Incomplete>(r))
         return;
@@ -1019,15 +1032,42 @@ void Sequencer<TheTerminal>::print(string_view _chars)
 {
     assert(_chars.size() != 0);
 
-    if (state().utf8DecoderState.expectedLength == 0)
+    flushBatchedSequence();
+
+    auto const isAllAscii = [](string_view chars) noexcept {
+        for (char const ch: chars)
+            if (static_cast<uint8_t>(ch) >= 0x80)
+                return false;
+        return true;
+    };
+
+    if (state().utf8DecoderState.expectedLength == 0 && isAllAscii(_chars))
     {
         state().instructionCounter += _chars.size();
         screen().writeText(_chars);
         state().precedingGraphicCharacter = static_cast<char32_t>(_chars.back());
+        return;
     }
-    else
-        for (char const ch: _chars)
-            print(ch);
+
+    // Decode the whole run into a codepoint buffer first, so the screen sees
+    // one bulk write per run instead of one call per codepoint.
+    static constexpr char32_t ReplacementCharacter { 0xFFFD };
+    codepoints_.clear();
+    for (char const ch: _chars)
+    {
+        unicode::ConvertResult const r = unicode::from_utf8(state().utf8DecoderState, (uint8_t) ch);
+        if (holds_alternative<unicode::Incomplete>(r))
+            continue;
+        codepoints_.push_back(holds_alternative<unicode::Success>(r) ? get<unicode::Success>(r).value
+                                                                     : ReplacementCharacter);
+    }
+
+    if (codepoints_.empty())
+        return;
+
+    state().instructionCounter += codepoints_.size();
+    screen().writeText(u32string_view(codepoints_.data(), codepoints_.size()));
+    state().precedingGraphicCharacter = codepoints_.back();
 }
 
 template <typename TheTerminal>
@@ -1037,6 +1077,36 @@ void Sequencer<TheTerminal>::execute(char _controlCode)
     state().utf8DecoderState = {};
 }
 
+template <typename TheTerminal>
+void Sequencer<TheTerminal>::executeLinefeeds(size_t _count)
+{
+    flushBatchedSequence();
+
+#if defined(LIBTERMINAL_LOG_TRACE)
+    if (VTParserTraceLog)
+        LOGSTORE(VTParserTraceLog)("C0 0x0A (x{})", _count);
+#endif
+
+    state().instructionCounter += _count;
+    screen().linefeeds(LineCount::cast_from(_count));
+    state().utf8DecoderState = {};
+}
+
+template <typename TheTerminal>
+void Sequencer<TheTerminal>::executeTabs(size_t _count)
+{
+    flushBatchedSequence();
+
+#if defined(LIBTERMINAL_LOG_TRACE)
+    if (VTParserTraceLog)
+        LOGSTORE(VTParserTraceLog)("C0 0x09 (x{})", _count);
+#endif
+
+    state().instructionCounter += _count;
+    screen().cursorForwardTab(TabStopCount::cast_from(_count));
+    state().utf8DecoderState = {};
+}
+
 template <typename TheTerminal>
 void Sequencer<TheTerminal>::clear()
 {
@@ -1117,6 +1187,16 @@ void Sequencer<TheTerminal>::putOSC(char _char)
         sequence_.intermediateCharacters().push_back(_char);
 }
 
+template <typename TheTerminal>
+void Sequencer<TheTerminal>::putOSC(string_view _chars)
+{
+    auto& data = sequence_.intermediateCharacters();
+    if (data.size() + 1 >= Sequence::MaxOscLength)
+        return;
+    auto const n = min(_chars.size(), Sequence::MaxOscLength - 1 - data.size());
+    data.append(_chars.data(), n);
+}
+
 template <typename TheTerminal>
 void Sequencer<TheTerminal>::dispatchOSC()
 {
@@ -1130,6 +1210,8 @@ void Sequencer<TheTerminal>::dispatchOSC()
 template <typename TheTerminal>
 void Sequencer<TheTerminal>::hook(char _finalChar)
 {
+    flushBatchedSequence();
+
     state().instructionCounter++;
     sequence_.setCategory(FunctionCategory::DCS);
     sequence_.setFinalChar(_finalChar);
@@ -1161,6 +1243,13 @@ void Sequencer<TheTerminal>::put(char _char)
         hookedParser_->pass(_char);
 }
 
+template <typename TheTerminal>
+void Sequencer<TheTerminal>::put(string_view _chars)
+{
+    if (hookedParser_)
+        hookedParser_->pass(_chars);
+}
+
 template <typename TheTerminal>
 void Sequencer<TheTerminal>::unhook()
 {
@@ -1171,6 +1260,31 @@ void Sequencer<TheTerminal>::unhook()
     }
 }
 
+template <typename TheTerminal>
+void Sequencer<TheTerminal>::dispatchAPC()
+{
+    if (apcData_.empty())
+        return;
+
+    // Private-use latency probe echoed back by the application; completes an
+    // end-to-end measurement (see Terminal::injectLatencyProbe()).
+    auto constexpr LatencyProbePrefix = "contour-latency;"sv;
+    if (apcData_.compare(0, LatencyProbePrefix.size(), LatencyProbePrefix) == 0)
+    {
+        auto const idText = string_view(apcData_).substr(LatencyProbePrefix.size());
+        if (auto const id = crispy::to_integer<10, uint64_t>(idText); id.has_value())
+            terminal_.latencyProbeReflected(id.value());
+        return;
+    }
+
+    // Only the kitty graphics protocol ("G<control data>;<payload>") is handled here.
+    if (apcData_.front() != 'G')
+        return;
+
+    if (auto image = parseKittyGraphics(string_view(apcData_).substr(1), state().maxImageSize))
+        screen().sixelImage(image->size, move(image->rgba));
+}
+
 template <typename TheTerminal>
 unique_ptr<ParserExtension> Sequencer<TheTerminal>::hookSixel(Sequence const& _seq)
 {
@@ -1247,15 +1361,8 @@ unique_ptr<ParserExtension> Sequencer<TheTerminal>::hookXTGETTCAP(Sequence const
     //           The strings are encoded in hexadecimal (2 digits per
     //           character).
 
-    return make_unique<SimpleStringCollector>([this](string_view const& _data) {
-        auto const capsInHex = crispy::split(_data, ';');
-        for (auto hexCap: capsInHex)
-        {
-            string const hexCap8 = unicode::convert_to<char>(hexCap);
-            if (auto const capOpt = crispy::fromHexString(string_view(hexCap8.data(), hexCap8.size())))
-                screen().requestCapability(capOpt.value());
-        }
-    });
+    return make_unique<SimpleStringCollector>(
+        [this](string_view const& _data) { screen().requestCapabilities(_data); });
 }
 
 template <typename TheTerminal>
@@ -1286,6 +1393,8 @@ unique_ptr<ParserExtension> Sequencer<TheTerminal>::hookDECRQSS(Sequence const&
 template <typename TheTerminal>
 void Sequencer<TheTerminal>::executeControlFunction(char _c0)
 {
+    flushBatchedSequence();
+
 #if defined(LIBTERMINAL_LOG_TRACE)
     if (VTParserTraceLog)
         LOGSTORE(VTParserTraceLog)("C0 0x{:02X}", _c0);
@@ -1334,8 +1443,34 @@ void Sequencer<TheTerminal>::handleSequence()
     //         sequence_.functionDefinition() ? sequence_.functionDefinition()->comment : ""sv);
 
     state().instructionCounter++;
+
+    // Write-combining fast path for the CUP+text+CUP redraw pattern full-screen
+    // TUIs emit thousands of times per frame: a plain CUP is applied directly,
+    // skipping the dispatch-table lookup and the apply() switch. Cursor motion
+    // does not observe SGR state, so a pending batched SGR sequence may stay
+    // pending across it and still be flushed only once per text run.
+    if (sequence_.category() == FunctionCategory::CSI && sequence_.finalChar() == 'H'
+        && !sequence_.leaderSymbol() && sequence_.intermediateCharacters().empty()
+        && sequence_.parameterCount() <= 2)
+    {
+        screen().moveCursorTo(LineOffset::cast_from(sequence_.param_or<int>(0, 1) - 1),
+                              ColumnOffset::cast_from(sequence_.param_or<int>(1, 1) - 1));
+        screen().verifyState();
+        return;
+    }
+
     if (FunctionDefinition const* funcSpec = sequence_.functionDefinition(); funcSpec != nullptr)
     {
+        // SGR sequences (very frequent in colorized output) are not applied one by
+        // one but coalesced into a single batched sequence that is dispatched in
+        // bulk right before the next action that could observe their effect.
+        if (funcSpec->id() == SGR.id())
+        {
+            batchSequence();
+            return;
+        }
+
+        flushBatchedSequence();
         applyAndLog(*funcSpec, sequence_);
         screen().verifyState();
     }
@@ -1343,6 +1478,45 @@ void Sequencer<TheTerminal>::handleSequence()
         LOGSTORE(VTParserLog)("Unknown VT sequence: {}", sequence_);
 }
 
+template <typename TheTerminal>
+void Sequencer<TheTerminal>::batchSequence()
+{
+    // Keep the batch bounded for pathological all-SGR streams and within the
+    // inline value capacity of the parameter storage.
+    auto constexpr MaxBatchedParameters = Sequence::ParameterList::MaxParameterCount;
+    if (batchedSequence_.parameters().size() + std::max(sequence_.parameterCount(), size_t { 1 })
+            > MaxBatchedParameters
+        || batchedSequence_.parameters().valueCount() + sequence_.parameters().valueCount()
+               > Sequence::ParameterList::MaxValueCount)
+        flushBatchedSequence();
+
+    if (!batchedSequencePending_)
+    {
+        batchedSequencePending_ = true;
+        batchedSequence_.clear();
+        batchedSequence_.setCategory(FunctionCategory::CSI);
+        batchedSequence_.setFinalChar('m');
+    }
+
+    auto& batchedParameters = batchedSequence_.parameters();
+    if (sequence_.parameterCount() == 0)
+        batchedParameters.push_back({ 0u }); // SGR without parameters implies a full reset
+    else
+        for (auto const& parameter: sequence_.parameters())
+            batchedParameters.push_back(parameter);
+}
+
+template <typename TheTerminal>
+void Sequencer<TheTerminal>::flushBatchedSequence()
+{
+    if (!batchedSequencePending_)
+        return;
+
+    batchedSequencePending_ = false;
+    applyAndLog(SGR, batchedSequence_);
+    screen().verifyState();
+}
+
 template <typename TheTerminal>
 void Sequencer<TheTerminal>::applyAndLog(FunctionDefinition const& _function, Sequence const& _seq)
 {
@@ -1537,6 +1711,13 @@ ApplyResult Sequencer<TheTerminal>::apply(FunctionDefinition const& _function, S
         break; // YES, it's like a CUP!
     case ICH: screen().insertCharacters(_seq.param_or(0, ColumnCount { 1 })); break;
     case IL: screen().insertLines(_seq.param_or(0, LineCount { 1 })); break;
+    case KBDPOP: screen().popKeyboardEnhancements(_seq.param_or(0, Sequence::Parameter { 1 })); break;
+    case KBDPUSH: screen().pushKeyboardEnhancements(_seq.param_or(0, Sequence::Parameter { 0 })); break;
+    case KBDQUERY: screen().requestKeyboardEnhancements(); break;
+    case KBDSET:
+        screen().setKeyboardEnhancements(_seq.param_or(0, Sequence::Parameter { 0 }),
+                                         _seq.param_or(1, Sequence::Parameter { 1 }));
+        break;
     case REP:
         if (state().precedingGraphicCharacter)
         {
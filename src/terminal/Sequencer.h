@@ -23,6 +23,7 @@
 
 #include <unicode/convert.h>
 
+#include <algorithm>
 #include <cassert>
 #include <memory>
 #include <string>
@@ -150,6 +151,8 @@ class Sequencer
     void print(char _text);
     void print(std::string_view _chars);
     void execute(char _controlCode);
+    void executeLinefeeds(size_t _count);
+    void executeTabs(size_t _count);
     void clear();
     void collect(char _char);
     void collectLeader(char _leader);
@@ -158,20 +161,34 @@ class Sequencer
     void dispatchCSI(char _function);
     void startOSC();
     void putOSC(char _char);
+    void putOSC(std::string_view _chars);
     void dispatchOSC();
     void hook(char _function);
     void put(char _char);
+    void put(std::string_view _chars);
     void unhook();
-    void startAPC() {}
-    void putAPC(char) {}
-    void dispatchAPC() {}
+    void startAPC() { apcData_.clear(); }
+    void putAPC(char _char)
+    {
+        if (apcData_.size() < MaxApcDataSize)
+            apcData_.push_back(_char);
+    }
+    void putAPC(std::string_view _chars)
+    {
+        auto const n = std::min(_chars.size(), MaxApcDataSize - apcData_.size());
+        apcData_.append(_chars.data(), n);
+    }
+    void dispatchAPC();
     void startPM() {}
     void putPM(char) {}
+    void putPM(std::string_view) {}
     void dispatchPM() {}
 
   private:
     void executeControlFunction(char _c0);
     void handleSequence();
+    void batchSequence();
+    void flushBatchedSequence();
 
     [[nodiscard]] std::unique_ptr<ParserExtension> hookSTP(Sequence const& _ctx);
     [[nodiscard]] std::unique_ptr<ParserExtension> hookSixel(Sequence const& _ctx);
@@ -188,10 +205,18 @@ class Sequencer
     //
     TheTerminal& terminal_;
     Sequence sequence_ {};
+    Sequence batchedSequence_ {}; // coalesces adjacent SGR sequences for bulk dispatch
+    bool batchedSequencePending_ = false;
+    std::vector<char32_t> codepoints_ {}; // reused buffer for UTF-8 decoded bulk text runs
 
     std::unique_ptr<ParserExtension> hookedParser_;
     std::unique_ptr<SixelImageBuilder> sixelImageBuilder_;
     std::shared_ptr<SixelColorPalette> imageColorPalette_;
+
+    // APC control strings are short (the kitty graphics shm transport carries
+    // only control data plus a base64'd shm name); anything longer is garbage.
+    static constexpr size_t MaxApcDataSize = 4096;
+    std::string apcData_ {};
 };
 
 } // namespace terminal
@@ -14,6 +14,7 @@
 #include <terminal/SixelParser.h>
 
 #include <algorithm>
+#include <cstring>
 
 using std::clamp;
 using std::fill;
@@ -120,9 +121,7 @@ void SixelParser::parse(char _value)
             paramShiftAndAddDigit(toDigit(_value));
         else if (isSixel(_value))
         {
-            auto const sixel = toSixel(_value);
-            for (int i = 0; i < params_[0]; ++i)
-                events_.render(sixel);
+            events_.render(toSixel(_value), params_[0]);
             transitionTo(State::Ground);
         }
         else
@@ -300,31 +299,58 @@ SixelImageBuilder::SixelImageBuilder(ImageSize _maxSize,
     maxSize_ { _maxSize },
     colors_ { std::move(_colorPalette) },
     size_ { _maxSize },
-    buffer_(size_.area() * 4),
+    buffer_ {},
+    background_ { _backgroundColor },
     sixelCursor_ {},
     currentColor_ { 0 },
     aspectRatio_ { _aspectVertical, _aspectHorizontal }
 {
-    clear(_backgroundColor);
 }
 
 void SixelImageBuilder::clear(RGBAColor _fillColor)
 {
     sixelCursor_ = {};
+    background_ = _fillColor;
+    buffer_.clear(); // lazily re-materialized, background-filled, on next use
+}
+
+void SixelImageBuilder::ensureBuffer()
+{
+    if (!buffer_.empty())
+        return;
+
+    if (background_.red() == background_.green() && background_.green() == background_.blue()
+        && background_.blue() == background_.alpha())
+    {
+        // uniform byte value (e.g. fully transparent): one memset-speed pass
+        buffer_.assign(size_.area() * 4, background_.red());
+        return;
+    }
 
-    auto p = &buffer_[0];
-    auto const e = p + size_.area() * 4;
-    while (p != e)
+    // Pattern-fill via doubling memcpy, writing whole pixels at a time instead
+    // of four byte stores per pixel.
+    buffer_.resize(size_.area() * 4);
+    if (buffer_.empty())
+        return;
+    buffer_[0] = background_.red();
+    buffer_[1] = background_.green();
+    buffer_[2] = background_.blue();
+    buffer_[3] = background_.alpha();
+    auto const total = buffer_.size();
+    auto filled = size_t { 4 };
+    while (filled < total)
     {
-        *p++ = _fillColor.red();
-        *p++ = _fillColor.green();
-        *p++ = _fillColor.blue();
-        *p++ = _fillColor.alpha();
+        auto const n = min(filled, total - filled);
+        std::memcpy(&buffer_[filled], &buffer_[0], n);
+        filled += n;
     }
 }
 
 RGBAColor SixelImageBuilder::at(CellLocation _coord) const noexcept
 {
+    if (buffer_.empty())
+        return background_;
+
     auto const line = *_coord.line % *size_.height;
     auto const col = *_coord.column % *size_.width;
     auto const base = line * *size_.width * 4 + col * 4;
@@ -375,7 +401,9 @@ void SixelImageBuilder::setRaster(int _pan, int _pad, ImageSize _imageSize)
     size_.width = clamp(_imageSize.width, Width(0), maxSize_.width);
     size_.height = clamp(_imageSize.height, Height(0), maxSize_.height);
 
-    buffer_.resize(*size_.width * *size_.height * 4);
+    // Raster settings precede pixel data; the buffer is materialized at the
+    // final dimensions on the first rendered sixel.
+    buffer_.clear();
 }
 
 void SixelImageBuilder::render(int8_t _sixel)
@@ -384,6 +412,7 @@ void SixelImageBuilder::render(int8_t _sixel)
     auto const x = sixelCursor_.column;
     if (unbox<int>(x) < unbox<int>(size_.width))
     {
+        ensureBuffer();
         for (int i = 0; i < 6; ++i)
         {
             auto const y = sixelCursor_.line + i;
@@ -397,4 +426,39 @@ void SixelImageBuilder::render(int8_t _sixel)
     }
 }
 
+void SixelImageBuilder::render(int8_t _sixel, int _count)
+{
+    // Splats the whole repeat-run at once: the palette color is resolved once,
+    // and each pinned row is filled as one contiguous pixel run instead of
+    // going through a bounds-checked per-pixel write for every repetition.
+    auto const x0 = unbox<int>(sixelCursor_.column);
+    auto const runLength = min(_count, unbox<int>(size_.width) - x0);
+    if (runLength > 0)
+    {
+        ensureBuffer();
+        auto const color = currentColor();
+        for (int i = 0; i < 6; ++i)
+        {
+            if (!(_sixel & (1 << i)))
+                continue;
+
+            auto const y = unbox<int>(sixelCursor_.line) + i;
+            if (y >= unbox<int>(size_.height))
+                break;
+
+            auto* p = &buffer_[(static_cast<size_t>(y) * unbox<size_t>(size_.width)
+                                + static_cast<size_t>(x0))
+                               * 4];
+            for (int n = 0; n < runLength; ++n)
+            {
+                *p++ = color.red;
+                *p++ = color.green;
+                *p++ = color.blue;
+                *p++ = 0xFF;
+            }
+        }
+    }
+    sixelCursor_.column = ColumnOffset(min(x0 + _count, unbox<int>(size_.width)));
+}
+
 } // namespace terminal
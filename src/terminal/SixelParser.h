@@ -75,6 +75,16 @@ class SixelParser: public ParserExtension
 
         /// renders a given sixel at the current sixel-cursor position.
         virtual void render(int8_t _sixel) = 0;
+
+        /// renders a run of @p _count repetitions of the given sixel (RLE '!'
+        /// operator), starting at the current sixel-cursor position.
+        ///
+        /// Event handlers may override this to splat the whole run at once.
+        virtual void render(int8_t _sixel, int _count)
+        {
+            for (int i = 0; i < _count; ++i)
+                render(_sixel);
+        }
     };
 
     using OnFinalize = std::function<void()>;
@@ -147,6 +157,12 @@ class SixelColorPalette
 /// Sixel Image Builder API
 ///
 /// Implements the SixelParser::Events event listener to construct a Sixel image.
+///
+/// Pixels are decoded straight into the RGBA layout the renderer uploads to the
+/// GPU, so the finished buffer is committed without any post-decode conversion.
+/// The buffer is allocated lazily: raster settings (or the first rendered sixel)
+/// determine its final dimensions, so images smaller than the permitted maximum
+/// never touch a maximum-sized allocation.
 class SixelImageBuilder: public SixelParser::Events
 {
   public:
@@ -167,7 +183,11 @@ class SixelImageBuilder: public SixelParser::Events
     RGBAColor at(CellLocation _coord) const noexcept;
 
     Buffer const& data() const noexcept { return buffer_; }
-    Buffer& data() noexcept { return buffer_; }
+    Buffer& data() noexcept
+    {
+        ensureBuffer();
+        return buffer_;
+    }
 
     void clear(RGBAColor _fillColor);
 
@@ -177,17 +197,23 @@ class SixelImageBuilder: public SixelParser::Events
     void newline() override;
     void setRaster(int _pan, int _pad, ImageSize _imageSize) override;
     void render(int8_t _sixel) override;
+    void render(int8_t _sixel, int _count) override;
 
     CellLocation const& sixelCursor() const noexcept { return sixelCursor_; }
 
   private:
     void write(CellLocation const& _coord, RGBColor const& _value) noexcept;
 
+    /// Materializes the pixel buffer at the current image dimensions,
+    /// background-filled; no-op once allocated.
+    void ensureBuffer();
+
   private:
     ImageSize const maxSize_;
     std::shared_ptr<SixelColorPalette> colors_;
     ImageSize size_;
-    Buffer buffer_; /// RGBA buffer
+    Buffer buffer_; /// RGBA buffer; empty until the first pixel is rendered
+    RGBAColor background_;
     CellLocation sixelCursor_;
     int currentColor_;
     struct
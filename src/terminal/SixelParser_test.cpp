@@ -243,6 +243,35 @@ TEST_CASE("SixelParser.rep", "[sixel]")
     }
 }
 
+TEST_CASE("SixelParser.repClipped", "[sixel]")
+{
+    auto constexpr defaultColor = RGBAColor { 0, 0, 0, 0xFF };
+    auto constexpr pinColor = RGBColor { 0x10, 0x20, 0x30 };
+    auto ib = sixelImageBuilder(ImageSize { Width(8), Height(8) }, defaultColor);
+    auto sp = SixelParser { ib };
+
+    ib.setColor(0, pinColor);
+
+    // The repeat count exceeds the image width; the run must be clipped at the
+    // right border and the sixel cursor must not advance beyond it.
+    sp.parseFragment("!12~");
+
+    CHECK(ib.sixelCursor() == CellLocation { LineOffset(0), ColumnOffset(8) });
+
+    for (int x = 0; x < ib.size().width.as<int>(); ++x)
+    {
+        for (int y = 0; y < ib.size().height.as<int>(); ++y)
+        {
+            auto const& actualColor = ib.at(CellLocation { LineOffset(y), ColumnOffset(x) });
+            auto const pinned = y < 6;
+            if (pinned)
+                CHECK(actualColor.rgb() == pinColor);
+            else
+                CHECK(actualColor == defaultColor);
+        }
+    }
+}
+
 TEST_CASE("SixelParser.setAndUseColor", "[sixel]")
 {
     auto constexpr pinColors = std::array<RGBAColor, 4> { RGBAColor { 255, 0, 0, 255 },
@@ -0,0 +1,415 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/StateSerializer.h>
+
+#include <array>
+#include <string>
+
+using std::array;
+using std::string;
+
+namespace terminal::serializer
+{
+
+namespace
+{
+    // All mode enumerators known to this format version. The on-disk encoding
+    // stores the VT mode numbers, so reordering or extending these lists does
+    // not break compatibility with existing snapshots.
+    auto constexpr AllAnsiModes = array {
+        AnsiMode::KeyboardAction,
+        AnsiMode::Insert,
+        AnsiMode::SendReceive,
+        AnsiMode::AutomaticNewLine,
+    };
+
+    auto constexpr AllDECModes = array {
+        DECMode::UseApplicationCursorKeys,
+        DECMode::DesignateCharsetUSASCII,
+        DECMode::Columns132,
+        DECMode::SmoothScroll,
+        DECMode::ReverseVideo,
+        DECMode::MouseProtocolX10,
+        DECMode::MouseProtocolNormalTracking,
+        DECMode::MouseProtocolHighlightTracking,
+        DECMode::MouseProtocolButtonTracking,
+        DECMode::MouseProtocolAnyEventTracking,
+        DECMode::SaveCursor,
+        DECMode::ExtendedAltScreen,
+        DECMode::Origin,
+        DECMode::AutoWrap,
+        DECMode::PrinterExtend,
+        DECMode::LeftRightMargin,
+        DECMode::ShowToolbar,
+        DECMode::BlinkingCursor,
+        DECMode::VisibleCursor,
+        DECMode::ShowScrollbar,
+        DECMode::AllowColumns80to132,
+        DECMode::DebugLogging,
+        DECMode::UseAlternateScreen,
+        DECMode::BracketedPaste,
+        DECMode::FocusTracking,
+        DECMode::SixelScrolling,
+        DECMode::UsePrivateColorRegisters,
+        DECMode::MouseExtended,
+        DECMode::MouseSGR,
+        DECMode::MouseURXVT,
+        DECMode::MouseSGRPixels,
+        DECMode::MouseAlternateScroll,
+        DECMode::BatchedRendering,
+        DECMode::TextReflow,
+        DECMode::SixelCursorNextToGraphic,
+    };
+
+    void writeColor(Writer& _writer, Color _color)
+    {
+        _writer.u32(_color.content);
+    }
+
+    Color readColor(Reader& _reader)
+    {
+        auto color = Color {};
+        color.content = _reader.u32();
+        return color;
+    }
+
+    void writeAttributes(Writer& _writer, GraphicsAttributes const& _attributes)
+    {
+        writeColor(_writer, _attributes.foregroundColor);
+        writeColor(_writer, _attributes.backgroundColor);
+        writeColor(_writer, _attributes.underlineColor);
+        _writer.u16(static_cast<uint16_t>(_attributes.styles));
+    }
+
+    GraphicsAttributes readAttributes(Reader& _reader)
+    {
+        auto attributes = GraphicsAttributes {};
+        attributes.foregroundColor = readColor(_reader);
+        attributes.backgroundColor = readColor(_reader);
+        attributes.underlineColor = readColor(_reader);
+        attributes.styles = static_cast<CellFlags>(_reader.u16());
+        return attributes;
+    }
+
+    void writeRGB(Writer& _writer, RGBColor _color)
+    {
+        _writer.u32(_color.value());
+    }
+
+    RGBColor readRGB(Reader& _reader)
+    {
+        return RGBColor { _reader.u32() };
+    }
+
+    void writeOptionalRGB(Writer& _writer, std::optional<RGBColor> const& _color)
+    {
+        _writer.u8(_color.has_value() ? 1 : 0);
+        writeRGB(_writer, _color.value_or(RGBColor {}));
+    }
+
+    std::optional<RGBColor> readOptionalRGB(Reader& _reader)
+    {
+        auto const present = _reader.u8() != 0;
+        auto const color = readRGB(_reader);
+        if (!present)
+            return std::nullopt;
+        return color;
+    }
+
+    void writeLine(Writer& _writer, Line<Cell> const& _line)
+    {
+        _writer.u8(static_cast<uint8_t>(_line.flags()));
+
+        if (_line.isTrivialBuffer())
+        {
+            auto const& buffer = _line.trivialBuffer();
+            _writer.u8(0);
+            writeAttributes(_writer, buffer.attributes);
+            _writer.u16(static_cast<uint16_t>(unbox<int>(buffer.width)));
+            _writer.str(buffer.text);
+            return;
+        }
+
+        auto const cells = _line.cells();
+        _writer.u8(1);
+        _writer.u16(static_cast<uint16_t>(cells.size()));
+
+        // SGR-run encoding: each run stores its attributes once, followed by
+        // the codepoints and widths of the cells sharing them.
+        size_t runStart = 0;
+        while (runStart < cells.size())
+        {
+            auto const attributes = cells[runStart].attributes();
+            size_t runEnd = runStart + 1;
+            while (runEnd < cells.size() && cells[runEnd].attributes() == attributes)
+                ++runEnd;
+
+            _writer.u16(static_cast<uint16_t>(runEnd - runStart));
+            writeAttributes(_writer, attributes);
+            for (size_t i = runStart; i < runEnd; ++i)
+            {
+                auto const& cell = cells[i];
+                _writer.u8(static_cast<uint8_t>(cell.codepointCount()));
+                for (size_t k = 0; k < cell.codepointCount(); ++k)
+                    _writer.u32(static_cast<uint32_t>(cell.codepoint(k)));
+                _writer.u8(cell.width());
+            }
+            runStart = runEnd;
+        }
+    }
+
+    bool readLine(Reader& _reader, Line<Cell>& _line)
+    {
+        auto const flags = static_cast<LineFlags>(_reader.u8());
+        auto const tag = _reader.u8();
+
+        if (tag == 0)
+        {
+            auto buffer = SimpleLineBuffer {};
+            buffer.attributes = readAttributes(_reader);
+            buffer.width = ColumnCount(_reader.u16());
+            buffer.text = string(_reader.str());
+            if (!_reader.ok || buffer.text.size() > unbox<size_t>(buffer.width))
+                return false;
+            _line = Line<Cell>(std::move(buffer), flags);
+            return true;
+        }
+
+        auto const cellCount = _reader.u16();
+        auto buffer = InflatedLineBuffer<Cell> {};
+        buffer.reserve(cellCount);
+        while (buffer.size() < cellCount && _reader.ok)
+        {
+            auto const runLength = _reader.u16();
+            auto const attributes = readAttributes(_reader);
+            if (buffer.size() + runLength > cellCount)
+                return false;
+            for (uint16_t i = 0; i < runLength; ++i)
+            {
+                auto const codepointCount = _reader.u8();
+                auto cell = Cell { attributes };
+                for (uint8_t k = 0; k < codepointCount && _reader.ok; ++k)
+                {
+                    auto const codepoint = static_cast<char32_t>(_reader.u32());
+                    if (k == 0)
+                        cell.setCharacter(codepoint);
+                    else
+                        cell.appendCharacter(codepoint);
+                }
+                cell.setAttributes(attributes);
+                cell.setWidth(_reader.u8());
+                buffer.emplace_back(std::move(cell));
+            }
+        }
+        if (!_reader.ok || buffer.size() != cellCount)
+            return false;
+        _line = Line<Cell>(std::move(buffer), flags);
+        return true;
+    }
+} // namespace
+
+void write(Writer& _writer, Cursor const& _cursor)
+{
+    // NB: Charset mappings and hyperlink references are not serialized; they
+    // are reset to their defaults on restore.
+    _writer.u32(static_cast<uint32_t>(unbox<int>(_cursor.position.line)));
+    _writer.u32(static_cast<uint32_t>(unbox<int>(_cursor.position.column)));
+    _writer.u8(_cursor.autoWrap ? 1 : 0);
+    _writer.u8(_cursor.originMode ? 1 : 0);
+    _writer.u8(_cursor.visible ? 1 : 0);
+    writeAttributes(_writer, _cursor.graphicsRendition);
+}
+
+bool read(Reader& _reader, Cursor& _cursor)
+{
+    _cursor = Cursor {};
+    _cursor.position.line = LineOffset(static_cast<int>(_reader.u32()));
+    _cursor.position.column = ColumnOffset(static_cast<int>(_reader.u32()));
+    _cursor.autoWrap = _reader.u8() != 0;
+    _cursor.originMode = _reader.u8() != 0;
+    _cursor.visible = _reader.u8() != 0;
+    _cursor.graphicsRendition = readAttributes(_reader);
+    return _reader.ok;
+}
+
+void write(Writer& _writer, Modes const& _modes)
+{
+    _writer.u16(static_cast<uint16_t>(AllAnsiModes.size()));
+    for (AnsiMode const mode: AllAnsiModes)
+    {
+        _writer.u16(static_cast<uint16_t>(toAnsiModeNum(mode)));
+        _writer.u8(_modes.enabled(mode) ? 1 : 0);
+    }
+
+    _writer.u16(static_cast<uint16_t>(AllDECModes.size()));
+    for (DECMode const mode: AllDECModes)
+    {
+        _writer.u16(static_cast<uint16_t>(toDECModeNum(mode)));
+        _writer.u8(_modes.enabled(mode) ? 1 : 0);
+    }
+}
+
+bool read(Reader& _reader, Modes& _modes)
+{
+    auto const ansiCount = _reader.u16();
+    for (uint16_t i = 0; i < ansiCount && _reader.ok; ++i)
+    {
+        auto const num = _reader.u16();
+        auto const enabled = _reader.u8() != 0;
+        for (AnsiMode const mode: AllAnsiModes)
+            if (toAnsiModeNum(mode) == num)
+                _modes.set(mode, enabled);
+    }
+
+    auto const decCount = _reader.u16();
+    for (uint16_t i = 0; i < decCount && _reader.ok; ++i)
+    {
+        auto const num = _reader.u16();
+        auto const enabled = _reader.u8() != 0;
+        for (DECMode const mode: AllDECModes)
+            if (toDECModeNum(mode) == num)
+                _modes.set(mode, enabled);
+    }
+
+    return _reader.ok;
+}
+
+void write(Writer& _writer, ColorPalette const& _palette)
+{
+    for (RGBColor const color: _palette.palette)
+        writeRGB(_writer, color);
+
+    writeRGB(_writer, _palette.defaultForeground);
+    writeRGB(_writer, _palette.defaultBackground);
+    writeOptionalRGB(_writer, _palette.selectionForeground);
+    writeOptionalRGB(_writer, _palette.selectionBackground);
+    writeRGB(_writer, _palette.mouseForeground);
+    writeRGB(_writer, _palette.mouseBackground);
+    writeRGB(_writer, _palette.hyperlinkDecoration.normal);
+    writeRGB(_writer, _palette.hyperlinkDecoration.hover);
+}
+
+bool read(Reader& _reader, ColorPalette& _palette)
+{
+    for (RGBColor& color: _palette.palette)
+        color = readRGB(_reader);
+    _palette.updateRenderColors();
+
+    _palette.defaultForeground = readRGB(_reader);
+    _palette.defaultBackground = readRGB(_reader);
+    _palette.selectionForeground = readOptionalRGB(_reader);
+    _palette.selectionBackground = readOptionalRGB(_reader);
+    _palette.mouseForeground = readRGB(_reader);
+    _palette.mouseBackground = readRGB(_reader);
+    _palette.hyperlinkDecoration.normal = readRGB(_reader);
+    _palette.hyperlinkDecoration.hover = readRGB(_reader);
+    return _reader.ok;
+}
+
+void write(Writer& _writer, Grid<Cell> const& _grid)
+{
+    _writer.u16(static_cast<uint16_t>(unbox<int>(_grid.pageSize().lines)));
+    _writer.u16(static_cast<uint16_t>(unbox<int>(_grid.pageSize().columns)));
+    _writer.u8(_grid.reflowOnResize() ? 1 : 0);
+    _writer.u32(static_cast<uint32_t>(unbox<int>(_grid.maxHistoryLineCount())));
+    _writer.u32(static_cast<uint32_t>(unbox<int>(_grid.historyLineCount())));
+
+    auto const top = -boxed_cast<LineOffset>(_grid.historyLineCount());
+    auto const bottom = boxed_cast<LineOffset>(_grid.pageSize().lines);
+    for (auto line = top; line < bottom; ++line)
+        writeLine(_writer, _grid.lineAt(line));
+}
+
+void writeScreenDelta(Writer& _writer,
+                      Grid<Cell> const& _grid,
+                      Cursor const& _cursor,
+                      ScreenDeltaTracker& _tracker)
+{
+    auto const pageSize = _grid.pageSize();
+    auto const lineCount = unbox<size_t>(pageSize.lines);
+
+    if (_tracker.pageSize != pageSize)
+    {
+        _tracker.pageSize = pageSize;
+        // Sentinel that never equals a real generation, forcing a full send.
+        _tracker.lineGenerations.assign(lineCount, ~uint64_t(0));
+    }
+
+    _writer.u16(static_cast<uint16_t>(unbox<int>(pageSize.lines)));
+    _writer.u16(static_cast<uint16_t>(unbox<int>(pageSize.columns)));
+    write(_writer, _cursor);
+
+    auto changedCount = uint16_t { 0 };
+    for (size_t i = 0; i < lineCount; ++i)
+        if (_grid.lineAt(LineOffset::cast_from(i)).generation() != _tracker.lineGenerations[i])
+            ++changedCount;
+    _writer.u16(changedCount);
+
+    for (size_t i = 0; i < lineCount; ++i)
+    {
+        auto const& line = _grid.lineAt(LineOffset::cast_from(i));
+        if (line.generation() == _tracker.lineGenerations[i])
+            continue;
+        _tracker.lineGenerations[i] = line.generation();
+        _writer.u16(static_cast<uint16_t>(i));
+        writeLine(_writer, line);
+    }
+}
+
+bool readScreenDelta(Reader& _reader, Grid<Cell>& _grid, Cursor& _cursor)
+{
+    auto const pageSize = PageSize { LineCount(_reader.u16()), ColumnCount(_reader.u16()) };
+    if (!_reader.ok || pageSize != _grid.pageSize())
+        return false;
+
+    if (!read(_reader, _cursor))
+        return false;
+
+    auto const changedCount = _reader.u16();
+    for (uint16_t i = 0; i < changedCount && _reader.ok; ++i)
+    {
+        auto const lineIndex = _reader.u16();
+        if (lineIndex >= unbox<uint16_t>(pageSize.lines))
+            return false;
+        if (!readLine(_reader, _grid.lineAt(LineOffset::cast_from(lineIndex))))
+            return false;
+    }
+    return _reader.ok;
+}
+
+bool read(Reader& _reader, Grid<Cell>& _grid)
+{
+    auto const pageSize = PageSize { LineCount(_reader.u16()), ColumnCount(_reader.u16()) };
+    auto const reflowOnResize = _reader.u8() != 0;
+    auto const maxHistoryLineCount = LineCount(static_cast<int>(_reader.u32()));
+    auto const historyLineCount = LineCount(static_cast<int>(_reader.u32()));
+
+    if (!_reader.ok || historyLineCount > maxHistoryLineCount)
+        return false;
+
+    auto grid = Grid<Cell>(pageSize, reflowOnResize, maxHistoryLineCount);
+    if (historyLineCount > LineCount(0))
+        grid.scrollUp(historyLineCount);
+
+    auto const top = -boxed_cast<LineOffset>(historyLineCount);
+    auto const bottom = boxed_cast<LineOffset>(pageSize.lines);
+    for (auto line = top; line < bottom; ++line)
+        if (!readLine(_reader, grid.lineAt(line)))
+            return false;
+
+    _grid = std::move(grid);
+    return _reader.ok;
+}
+
+} // namespace terminal::serializer
@@ -0,0 +1,282 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <terminal/Cell.h>
+#include <terminal/ColorPalette.h>
+#include <terminal/Grid.h>
+#include <terminal/TerminalState.h>
+#include <terminal/primitives.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace terminal::serializer
+{
+
+// {{{ binary stream primitives
+/// Appends little-endian encoded primitives to a growing byte buffer.
+///
+/// The resulting buffer is a self-contained snapshot, so flushing it to a
+/// file descriptor (or a socket, for session handoff) may happen on any
+/// thread without further synchronization with the VT thread.
+struct Writer
+{
+    std::string data;
+
+    void u8(uint8_t _value) { data.push_back(static_cast<char>(_value)); }
+
+    void u16(uint16_t _value)
+    {
+        u8(static_cast<uint8_t>(_value & 0xFF));
+        u8(static_cast<uint8_t>(_value >> 8));
+    }
+
+    void u32(uint32_t _value)
+    {
+        u16(static_cast<uint16_t>(_value & 0xFFFF));
+        u16(static_cast<uint16_t>(_value >> 16));
+    }
+
+    void u64(uint64_t _value)
+    {
+        u32(static_cast<uint32_t>(_value & 0xFFFFFFFF));
+        u32(static_cast<uint32_t>(_value >> 32));
+    }
+
+    void str(std::string_view _value)
+    {
+        u32(static_cast<uint32_t>(_value.size()));
+        data.append(_value.data(), _value.size());
+    }
+};
+
+/// Consumes little-endian encoded primitives from a byte buffer.
+///
+/// Any out-of-bounds access permanently flips ok to false and yields zero
+/// values, so decoding malformed input degrades into a single failure check
+/// at the end instead of per-field error handling.
+struct Reader
+{
+    std::string_view data;
+    size_t pos = 0;
+    bool ok = true;
+
+    uint8_t u8()
+    {
+        if (pos >= data.size())
+        {
+            ok = false;
+            return 0;
+        }
+        return static_cast<uint8_t>(data[pos++]);
+    }
+
+    uint16_t u16()
+    {
+        auto const lo = u8();
+        auto const hi = u8();
+        return static_cast<uint16_t>(lo | (hi << 8));
+    }
+
+    uint32_t u32()
+    {
+        auto const lo = u16();
+        auto const hi = u16();
+        return static_cast<uint32_t>(lo) | (static_cast<uint32_t>(hi) << 16);
+    }
+
+    uint64_t u64()
+    {
+        auto const lo = u32();
+        auto const hi = u32();
+        return static_cast<uint64_t>(lo) | (static_cast<uint64_t>(hi) << 32);
+    }
+
+    std::string_view str()
+    {
+        auto const size = u32();
+        if (pos + size > data.size())
+        {
+            ok = false;
+            return {};
+        }
+        auto const result = data.substr(pos, size);
+        pos += size;
+        return result;
+    }
+};
+// }}}
+
+auto constexpr Magic = uint32_t { 0x43545353 }; // "CTSS"
+auto constexpr Version = uint32_t { 1 };
+
+// {{{ component encoders/decoders
+void write(Writer& _writer, Cursor const& _cursor);
+bool read(Reader& _reader, Cursor& _cursor);
+
+void write(Writer& _writer, Modes const& _modes);
+bool read(Reader& _reader, Modes& _modes);
+
+void write(Writer& _writer, ColorPalette const& _palette);
+bool read(Reader& _reader, ColorPalette& _palette);
+
+/// Encodes the given grid in O(lines): trivial lines are stored verbatim in
+/// their compact single-SGR text form, inflated lines as SGR runs followed by
+/// per-cell codepoints. Images and hyperlinks are not part of the snapshot.
+void write(Writer& _writer, Grid<Cell> const& _grid);
+bool read(Reader& _reader, Grid<Cell>& _grid);
+// }}}
+
+// {{{ screen deltas
+/// Remembers, per receiver, the modification generation each visible line
+/// had when it was last encoded (see Line::generation()), so consecutive
+/// writeScreenDelta() calls carry only the lines that changed in between.
+struct ScreenDeltaTracker
+{
+    PageSize pageSize { LineCount(0), ColumnCount(0) };
+    std::vector<uint64_t> lineGenerations;
+};
+
+/// Encodes the visible page as a delta against the tracker's previous call:
+/// page size, cursor, and the changed lines only (same per-line SGR-run
+/// encoding as the full snapshot). The first call - and any call after a
+/// page resize - carries all visible lines.
+///
+/// Scrolling currently resends the shifted lines; their generations move
+/// with the line, so a scroll-aware encoding remains possible within this
+/// frame format.
+void writeScreenDelta(Writer& _writer,
+                      Grid<Cell> const& _grid,
+                      Cursor const& _cursor,
+                      ScreenDeltaTracker& _tracker);
+
+/// Applies a delta produced by writeScreenDelta() onto the visible page of
+/// the given grid.
+///
+/// @returns false if the delta's page size does not match the grid's (the
+/// receiver then needs a fresh full snapshot) or the input is malformed.
+bool readScreenDelta(Reader& _reader, Grid<Cell>& _grid, Cursor& _cursor);
+// }}}
+
+/// Serializes the screen-visible portion of the given terminal state —
+/// both grids, modes, tab stops, color palette and cursors — into a
+/// versioned binary snapshot.
+///
+/// Parser state, images, hyperlinks and saved mode stacks are deliberately
+/// not part of the snapshot; they are either transient or re-established by
+/// the application after a session handoff.
+template <typename TheTerminal>
+std::string serialize(TerminalState<TheTerminal> const& _state)
+{
+    auto writer = Writer {};
+    writer.u32(Magic);
+    writer.u32(Version);
+
+    writer.u16(static_cast<uint16_t>(unbox<int>(_state.pageSize.lines)));
+    writer.u16(static_cast<uint16_t>(unbox<int>(_state.pageSize.columns)));
+    writer.u8(_state.screenType == ScreenType::Alternate ? 1 : 0);
+
+    write(writer, _state.modes);
+
+    writer.u16(static_cast<uint16_t>(unbox<int>(_state.tabWidth)));
+    writer.u16(static_cast<uint16_t>(_state.tabs.size()));
+    for (ColumnOffset const tab: _state.tabs)
+        writer.u16(static_cast<uint16_t>(unbox<int>(tab)));
+
+    write(writer, _state.cursor);
+    write(writer, _state.savedCursor);
+    write(writer, _state.savedPrimaryCursor);
+    writer.u8(_state.wrapPending ? 1 : 0);
+
+    write(writer, _state.colorPalette);
+
+    writer.str(_state.windowTitle);
+    writer.str(_state.currentWorkingDirectory);
+
+    write(writer, _state.grids[0]);
+    write(writer, _state.grids[1]);
+
+    return writer.data;
+}
+
+/// Restores a snapshot previously produced by serialize() in a single pass.
+///
+/// @returns true on success; on failure (bad magic, unsupported version,
+/// truncated or malformed input) the state is left untouched.
+template <typename TheTerminal>
+bool deserialize(std::string_view _data, TerminalState<TheTerminal>& _state)
+{
+    auto reader = Reader { _data };
+    if (reader.u32() != Magic || reader.u32() != Version)
+        return false;
+
+    auto const lines = LineCount(reader.u16());
+    auto const columns = ColumnCount(reader.u16());
+    auto const screenType = reader.u8() ? ScreenType::Alternate : ScreenType::Main;
+
+    auto modes = Modes {};
+    if (!read(reader, modes))
+        return false;
+
+    auto const tabWidth = ColumnCount(reader.u16());
+    auto tabs = std::vector<ColumnOffset> {};
+    tabs.resize(reader.u16());
+    for (ColumnOffset& tab: tabs)
+        tab = ColumnOffset(reader.u16());
+
+    auto cursor = Cursor {};
+    auto savedCursor = Cursor {};
+    auto savedPrimaryCursor = Cursor {};
+    if (!read(reader, cursor) || !read(reader, savedCursor) || !read(reader, savedPrimaryCursor))
+        return false;
+    auto const wrapPending = reader.u8() != 0;
+
+    auto colorPalette = _state.colorPalette;
+    if (!read(reader, colorPalette))
+        return false;
+
+    auto const windowTitle = std::string(reader.str());
+    auto const currentWorkingDirectory = std::string(reader.str());
+
+    auto grids = std::array<Grid<Cell>, 2> {};
+    if (!read(reader, grids[0]) || !read(reader, grids[1]) || !reader.ok)
+        return false;
+
+    _state.pageSize = PageSize { lines, columns };
+    _state.screenType = screenType;
+    _state.modes = modes;
+    _state.tabWidth = tabWidth;
+    _state.tabs = std::move(tabs);
+    _state.cursor = cursor;
+    _state.savedCursor = savedCursor;
+    _state.savedPrimaryCursor = savedPrimaryCursor;
+    _state.wrapPending = wrapPending;
+    _state.colorPalette = colorPalette;
+    _state.windowTitle = windowTitle;
+    _state.currentWorkingDirectory = currentWorkingDirectory;
+    _state.grids[0] = std::move(grids[0]);
+    _state.grids[1] = std::move(grids[1]);
+    _state.activeGrid = &_state.grids[screenType == ScreenType::Alternate ? 1 : 0];
+    _state.margin =
+        Margin { Margin::Vertical { {}, lines.as<LineOffset>() - LineOffset(1) },
+                 Margin::Horizontal { {}, columns.as<ColumnOffset>() - ColumnOffset(1) } };
+
+    return true;
+}
+
+} // namespace terminal::serializer
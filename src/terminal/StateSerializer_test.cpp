@@ -0,0 +1,155 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/StateSerializer.h>
+
+#include <catch2/catch.hpp>
+
+using namespace terminal;
+
+TEST_CASE("StateSerializer.Grid.roundtrip", "[serializer]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(3), ColumnCount(5) }, true, LineCount(10));
+    grid.setLineText(LineOffset(0), "Hello");
+    grid.setLineText(LineOffset(1), "World");
+    grid.scrollUp(LineCount(2));
+    grid.setLineText(LineOffset(0), "ABC");
+
+    auto writer = serializer::Writer {};
+    serializer::write(writer, grid);
+
+    auto restored = Grid<Cell>();
+    auto reader = serializer::Reader { writer.data };
+    REQUIRE(serializer::read(reader, restored));
+
+    CHECK(restored.pageSize() == grid.pageSize());
+    CHECK(restored.historyLineCount() == grid.historyLineCount());
+    CHECK(restored.maxHistoryLineCount() == grid.maxHistoryLineCount());
+    CHECK(restored.lineText(LineOffset(-2)) == grid.lineText(LineOffset(-2)));
+    CHECK(restored.lineText(LineOffset(-1)) == grid.lineText(LineOffset(-1)));
+    CHECK(restored.lineText(LineOffset(0)) == grid.lineText(LineOffset(0)));
+}
+
+TEST_CASE("StateSerializer.Grid.attributes", "[serializer]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(4) }, false, LineCount(0));
+    auto sgr = GraphicsAttributes {};
+    sgr.foregroundColor = RGBColor { 0x11, 0x22, 0x33 };
+    sgr.styles = CellFlags::Bold | CellFlags::Underline;
+    grid.lineAt(LineOffset(0)).useCellAt(ColumnOffset(1)).write(sgr, U'x', 1);
+
+    auto writer = serializer::Writer {};
+    serializer::write(writer, grid);
+
+    auto restored = Grid<Cell>();
+    auto reader = serializer::Reader { writer.data };
+    REQUIRE(serializer::read(reader, restored));
+
+    auto const& cell = restored.at(LineOffset(0), ColumnOffset(1));
+    CHECK(cell.codepoint(0) == U'x');
+    CHECK(cell.foregroundColor() == sgr.foregroundColor);
+    CHECK(cell.styles() == sgr.styles);
+}
+
+TEST_CASE("StateSerializer.Modes.roundtrip", "[serializer]")
+{
+    auto modes = Modes {};
+    modes.set(AnsiMode::Insert, true);
+    modes.set(DECMode::AutoWrap, true);
+    modes.set(DECMode::BracketedPaste, true);
+
+    auto writer = serializer::Writer {};
+    serializer::write(writer, modes);
+
+    auto restored = Modes {};
+    auto reader = serializer::Reader { writer.data };
+    REQUIRE(serializer::read(reader, restored));
+
+    CHECK(restored.enabled(AnsiMode::Insert));
+    CHECK(restored.enabled(DECMode::AutoWrap));
+    CHECK(restored.enabled(DECMode::BracketedPaste));
+    CHECK_FALSE(restored.enabled(DECMode::Origin));
+}
+
+TEST_CASE("StateSerializer.truncated", "[serializer]")
+{
+    auto grid = Grid<Cell>(PageSize { LineCount(2), ColumnCount(4) }, false, LineCount(0));
+    auto writer = serializer::Writer {};
+    serializer::write(writer, grid);
+
+    auto truncated = std::string_view(writer.data).substr(0, writer.data.size() / 2);
+    auto restored = Grid<Cell>();
+    auto reader = serializer::Reader { truncated };
+    CHECK_FALSE(serializer::read(reader, restored));
+}
+
+TEST_CASE("StateSerializer.ScreenDelta.roundtrip", "[serializer]")
+{
+    auto const pageSize = PageSize { LineCount(3), ColumnCount(5) };
+    auto grid = Grid<Cell>(pageSize, false, LineCount(0));
+    grid.setLineText(LineOffset(0), "Hello");
+    grid.setLineText(LineOffset(1), "World");
+
+    auto cursor = Cursor {};
+    cursor.position = CellLocation { LineOffset(1), ColumnOffset(2) };
+
+    auto tracker = serializer::ScreenDeltaTracker {};
+    auto mirror = Grid<Cell>(pageSize, false, LineCount(0));
+    auto mirrorCursor = Cursor {};
+
+    // First delta carries the full page.
+    {
+        auto writer = serializer::Writer {};
+        serializer::writeScreenDelta(writer, grid, cursor, tracker);
+        auto reader = serializer::Reader { writer.data };
+        REQUIRE(serializer::readScreenDelta(reader, mirror, mirrorCursor));
+        CHECK(mirror.lineText(LineOffset(0)) == grid.lineText(LineOffset(0)));
+        CHECK(mirror.lineText(LineOffset(1)) == grid.lineText(LineOffset(1)));
+        CHECK(mirrorCursor.position == cursor.position);
+    }
+
+    // An unchanged page yields an empty delta.
+    {
+        auto writer = serializer::Writer {};
+        serializer::writeScreenDelta(writer, grid, cursor, tracker);
+        auto reader = serializer::Reader { writer.data };
+        auto const sizeBefore = writer.data.size();
+        REQUIRE(serializer::readScreenDelta(reader, mirror, mirrorCursor));
+        auto emptyWriter = serializer::Writer {};
+        emptyWriter.u16(3);
+        emptyWriter.u16(5);
+        serializer::write(emptyWriter, cursor);
+        emptyWriter.u16(0);
+        CHECK(sizeBefore == emptyWriter.data.size());
+    }
+
+    // Only the modified line travels.
+    {
+        grid.setLineText(LineOffset(2), "delta");
+        auto writer = serializer::Writer {};
+        serializer::writeScreenDelta(writer, grid, cursor, tracker);
+        auto reader = serializer::Reader { writer.data };
+        REQUIRE(serializer::readScreenDelta(reader, mirror, mirrorCursor));
+        CHECK(mirror.lineText(LineOffset(2)) == "delta");
+        CHECK(mirror.lineText(LineOffset(0)) == grid.lineText(LineOffset(0)));
+    }
+
+    // Page size mismatch is rejected, asking the receiver to resynchronize.
+    {
+        auto small = Grid<Cell>(PageSize { LineCount(2), ColumnCount(5) }, false, LineCount(0));
+        auto writer = serializer::Writer {};
+        serializer::writeScreenDelta(writer, grid, cursor, tracker);
+        auto reader = serializer::Reader { writer.data };
+        CHECK_FALSE(serializer::readScreenDelta(reader, small, mirrorCursor));
+    }
+}
@@ -14,14 +14,23 @@
 #include <terminal/ControlCode.h>
 #include <terminal/InputGenerator.h>
 #include <terminal/Terminal.h>
+#include <terminal/UnicodeCache.h>
+#include <terminal/VTRecorder.h>
 #include <terminal/logging.h>
 
+#include <crispy/AllocationTracker.h>
+#include <crispy/PerfCounters.h>
+#include <crispy/affinity.h>
 #include <crispy/escape.h>
 #include <crispy/stdfs.h>
 
+#include <unicode/width.h>
+
 #include <fmt/chrono.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <signal.h>
 #include <utility>
@@ -41,6 +50,37 @@ namespace terminal
 
 namespace // {{{ helpers
 {
+    // How long a predicted keystroke may stay unconfirmed before it is dropped
+    // again (covers applications that deliberately do not echo, such as
+    // password prompts).
+    constexpr auto EchoPredictionTimeout = chrono::milliseconds { 1000 };
+
+    // Pastes larger than this are queued and trickled into the PTY in chunks
+    // of this size from the main loop rather than written synchronously.
+    constexpr size_t PasteChunkSize = 16 * 1024;
+
+    // Upper bound on how much PTY output is parsed per lock acquisition in
+    // writeToScreen(). Bounds how long a UI-thread query may have to wait
+    // behind the VT thread during an output burst.
+    constexpr size_t WriteChunkSize = 16 * 1024;
+
+    // Output-storm governor: when PTY ingest within one measurement window
+    // exceeds this volume, frames are composed at the storm refresh interval
+    // instead of the configured one, granting the parser longer uninterrupted
+    // quanta; the first quieter window snaps the rate back.
+    constexpr auto IngestMeasurementWindow = chrono::milliseconds(100);
+    constexpr size_t OutputStormBytesPerWindow = 4 * 1024 * 1024; // i.e. >= ~40 MB/s
+    constexpr auto OutputStormRefreshInterval = chrono::milliseconds(100);
+
+    // Longest time PTY consumption stays paused on an exhausted parse-ahead
+    // budget without a frame being composed (e.g. hidden window); after it,
+    // the application's progress wins over frame freshness.
+    constexpr auto ParseAheadPauseLimit = chrono::milliseconds(250);
+
+    // How often the session statistics line (see Terminal::statisticsLine())
+    // is re-sampled from the running counters.
+    constexpr auto StatisticsSampleInterval = chrono::seconds(1);
+
     void trimSpaceRight(string& value)
     {
         while (!value.empty() && value.back() == ' ')
@@ -84,6 +124,34 @@ namespace // {{{ helpers
         return tuple { cursorFg, cursorBg };
     }
 
+    /// One-entry memo for resolved per-cell render colors. Consecutive cells
+    /// usually share their graphics attributes and overlay state (selection,
+    /// cursor), so the branchy color pipeline in makeColors() needs to run
+    /// only once per attribute run instead of once per cell.
+    struct ColorRunMemo
+    {
+        Color fg {};
+        Color bg {};
+        CellFlags flags {};
+        bool selected = false;
+        bool paintCursor = false;
+        bool valid = false;
+        RGBColor resolvedFg {};
+        RGBColor resolvedBg {};
+    };
+
+    /// Compares the palette properties that contribute to per-cell render colors,
+    /// i.e. everything makeColors() and makeRenderCell() may read.
+    bool renderColorsEqual(ColorPalette const& a, ColorPalette const& b) noexcept
+    {
+        return a.palette == b.palette && a.defaultForeground == b.defaultForeground
+               && a.defaultBackground == b.defaultBackground
+               && a.selectionForeground == b.selectionForeground
+               && a.selectionBackground == b.selectionBackground
+               && a.hyperlinkDecoration.normal == b.hyperlinkDecoration.normal
+               && a.hyperlinkDecoration.hover == b.hyperlinkDecoration.hover;
+    }
+
 #if defined(CONTOUR_PERF_STATS)
     void logRenderBufferSwap(bool _success, uint64_t _frameID)
     {
@@ -155,6 +223,11 @@ Terminal::Terminal(Pty& _pty,
     screen().setMode(DECMode::TextReflow, true);
     screen().setMode(DECMode::SixelCursorNextToGraphic, state_.sixelCursorConformance);
 #endif
+
+    if (auto const* recordTarget = getenv("CONTOUR_RECORD_PTY"); recordTarget && *recordTarget)
+        recorder_ = make_unique<VTRecorder>(FileSystem::path(recordTarget));
+
+    publishViewportSnapshot();
 }
 
 Terminal::~Terminal()
@@ -189,6 +262,9 @@ void Terminal::mainLoop()
 {
     mainLoopThreadID_ = this_thread::get_id();
 
+    if (!mainLoopCpuAffinity_.empty() && !crispy::pinCurrentThreadToCpus(mainLoopCpuAffinity_))
+        TerminalLog()("Failed to pin VT thread onto configured CPU set.");
+
     TerminalLog()("Starting main loop with thread id {}", [&]() {
         stringstream sstr;
         sstr << mainLoopThreadID_;
@@ -207,17 +283,63 @@ void Terminal::mainLoop()
 
 bool Terminal::processInputOnce()
 {
-    auto const timeout = renderBuffer_.state == RenderBufferState::WaitingForRefresh && !screenDirty_
-                             ? std::chrono::seconds(4)
-                             //: refreshInterval_ : std::chrono::seconds(0)
-                             : std::chrono::seconds(30);
+    // A fully idle session - nothing dirty, no render refresh pending - parks
+    // the VT thread indefinitely on the PTY fd plus the wakeup pipe, with no
+    // timer at all: many idle sessions then cause zero periodic wakeups.
+    // Everything that could create work while idle (render buffer swaps,
+    // resizing, closing) signals through Pty::wakeupReader(), and blinking
+    // cursors/text are timed on the render thread. Frame pacing resumes with
+    // the first byte read.
+    auto timeout = renderBuffer_.state == RenderBufferState::WaitingForRefresh && !screenDirty_
+                       ? Pty::NoTimeout
+                       : chrono::milliseconds(chrono::seconds(30));
+
+    // With a paste backpressured by the PTY, wake up early to retry, since the
+    // application may drain the pipe without producing any output to read.
+    if (flushPendingPaste())
+        timeout = chrono::milliseconds(10);
+
+#if defined(LIBTERMINAL_PASSIVE_RENDER_BUFFER_UPDATE)
+    // With screen updates pending their refresh, wake up in time for the next
+    // refresh window, so the frame is composed right before the vblank.
+    if (screenDirty_ && renderBuffer_.state == RenderBufferState::WaitingForRefresh)
+        timeout = min(timeout, max(timeUntilRefreshWindow(), chrono::milliseconds(1)));
+#endif
+
+    // Parse-ahead budget: once more bytes were parsed into screen state than
+    // have been shown in a composed frame, stop consuming the PTY - the
+    // kernel-side buffer then provides the actual backpressure towards the
+    // application - until the pending bytes made it into a frame. This makes
+    // the output-to-screen staleness deterministic and tunable instead of
+    // dependent on scheduling luck.
+    if (parseAheadLimit_ != 0 && renderBufferUpdateEnabled_
+        && pendingRenderBytes_.load(std::memory_order_relaxed) >= parseAheadLimit_)
+    {
+        auto const now = chrono::steady_clock::now();
+        if (parseAheadPausedSince_ == chrono::steady_clock::time_point {})
+            parseAheadPausedSince_ = now;
+        if (now - parseAheadPausedSince_ < ParseAheadPauseLimit)
+        {
+            this_thread::sleep_for(
+                clamp(timeUntilRefreshWindow(), chrono::milliseconds(1), chrono::milliseconds(100)));
+            return true;
+        }
+        // No frame was composed for a long time; let the application proceed.
+        pendingRenderBytes_.store(0, std::memory_order_relaxed);
+    }
+    parseAheadPausedSince_ = {};
+
+    return processPtyRead(timeout);
+}
 
-    auto const bufOpt = pty_.read(ptyReadBufferSize_, timeout);
+bool Terminal::processPtyRead(chrono::milliseconds _timeout)
+{
+    auto const bufOpt = pty_.read(ptyReadBufferSize_, _timeout);
     if (!bufOpt)
     {
         if (errno != EINTR && errno != EAGAIN)
         {
-            TerminalLog()("PTY read failed (timeout: {}). {}", timeout, strerror(errno));
+            TerminalLog()("PTY read failed (timeout: {}). {}", _timeout, strerror(errno));
             pty_.close();
         }
         return errno == EINTR || errno == EAGAIN;
@@ -231,6 +353,11 @@ bool Terminal::processInputOnce()
         return true;
     }
 
+    if (recorder_)
+        recorder_->record(buf);
+
+    updateIngestStatistics(buf.size());
+
     writeToScreen(buf);
 
 #if defined(LIBTERMINAL_PASSIVE_RENDER_BUFFER_UPDATE)
@@ -240,6 +367,23 @@ bool Terminal::processInputOnce()
     return true;
 }
 
+bool Terminal::processAvailableInput()
+{
+    if (pty_.isClosed())
+        return false;
+
+    // Retry any paste backpressured by the PTY; an externally driven session
+    // has no 10ms retry timeout to fall back on.
+    flushPendingPaste();
+
+    // A zero timeout makes the underlying select()/read() a pure poll: with
+    // nothing pending, read() returns immediately with EAGAIN.
+    auto const alive = processPtyRead(chrono::milliseconds(0)) && !pty_.isClosed();
+    if (!alive)
+        eventListener_.onClosed();
+    return alive;
+}
+
 // {{{ RenderBuffer synchronization
 void Terminal::breakLoopAndRefreshRenderBuffer()
 {
@@ -259,6 +403,85 @@ bool Terminal::refreshRenderBuffer(bool _locked)
     return renderBuffer_.state == RenderBufferState::WaitingForRefresh;
 }
 
+chrono::steady_clock::time_point Terminal::lastFrameSwap() const noexcept
+{
+    return chrono::steady_clock::time_point(
+        chrono::steady_clock::duration(lastFrameSwap_.load(std::memory_order_relaxed)));
+}
+
+bool Terminal::refreshWindowOpen() const noexcept
+{
+    auto const refreshInterval = effectiveRefreshInterval();
+    auto const lastSwap = lastFrameSwap();
+    auto const sinceSwap = currentTime_ - lastSwap;
+
+    // Without recent vsync feedback (startup, hidden or occluded window),
+    // fall back to free-running throttling relative to the last refresh.
+    if (lastSwap.time_since_epoch().count() == 0 || sinceSwap >= 2 * refreshInterval)
+        return currentTime_ - renderBuffer_.lastUpdate >= refreshInterval;
+
+    // At most one refresh per display period.
+    if (renderBuffer_.lastUpdate >= lastSwap)
+        return false;
+
+    // Compose late in the period, so the upcoming frame carries the freshest
+    // possible screen state into the vblank.
+    return sinceSwap * 4 >= refreshInterval * 3;
+}
+
+chrono::milliseconds Terminal::timeUntilRefreshWindow() const noexcept
+{
+    if (refreshWindowOpen())
+        return chrono::milliseconds(0);
+
+    auto const refreshInterval = effectiveRefreshInterval();
+    auto const lastSwap = lastFrameSwap();
+    auto const sinceSwap = currentTime_ - lastSwap;
+
+    if (lastSwap.time_since_epoch().count() == 0 || sinceSwap >= 2 * refreshInterval)
+    {
+        auto const elapsed =
+            chrono::duration_cast<chrono::milliseconds>(currentTime_ - renderBuffer_.lastUpdate);
+        return elapsed < refreshInterval ? refreshInterval - elapsed : chrono::milliseconds(0);
+    }
+
+    auto const windowStart = lastSwap + (refreshInterval * 3) / 4;
+    auto const target = currentTime_ < windowStart ? windowStart : windowStart + refreshInterval;
+    return max(chrono::duration_cast<chrono::milliseconds>(target - currentTime_),
+               chrono::milliseconds(1));
+}
+
+chrono::milliseconds Terminal::effectiveRefreshInterval() const noexcept
+{
+    // An output storm produces more frames than anyone could read; compose
+    // fewer of them and spend the cycles on parsing instead.
+    if (outputStormActive_.load(std::memory_order_relaxed))
+        return max(refreshInterval_, OutputStormRefreshInterval);
+    return refreshInterval_;
+}
+
+void Terminal::updateIngestStatistics(size_t _bytesRead)
+{
+    auto const now = chrono::steady_clock::now();
+    if (now - ingestWindowStart_ >= IngestMeasurementWindow)
+    {
+        auto const stormActive = ingestWindowBytes_ >= OutputStormBytesPerWindow;
+        if (stormActive != outputStormActive_.load(std::memory_order_relaxed))
+        {
+            outputStormActive_.store(stormActive, std::memory_order_relaxed);
+            if (TerminalLog)
+                LOGSTORE(TerminalLog)
+            ("Output-storm governor {} (ingested {} bytes within the last window).",
+             stormActive ? "engaged" : "released",
+             ingestWindowBytes_);
+        }
+        ingestWindowStart_ = now;
+        ingestWindowBytes_ = 0;
+    }
+    ingestWindowBytes_ += _bytesRead;
+    totalIngestedBytes_ += _bytesRead;
+}
+
 bool Terminal::ensureFreshRenderBuffer(bool _locked)
 {
     if (!renderBufferUpdateEnabled_)
@@ -267,8 +490,7 @@ bool Terminal::ensureFreshRenderBuffer(bool _locked)
         return false;
     }
 
-    auto const elapsed = currentTime_ - renderBuffer_.lastUpdate;
-    auto const avoidRefresh = elapsed < refreshInterval_;
+    auto const avoidRefresh = !refreshWindowOpen();
 
     switch (renderBuffer_.state)
     {
@@ -281,12 +503,15 @@ bool Terminal::ensureFreshRenderBuffer(bool _locked)
         if (!_locked)
             refreshRenderBuffer(renderBuffer_.backBuffer());
         else
-            refreshRenderBufferInternal(renderBuffer_.backBuffer());
+            refreshRenderBufferInternal(renderBuffer_.backBuffer(), viewport_);
         renderBuffer_.state = RenderBufferState::TrySwapBuffers;
         [[fallthrough]];
     case RenderBufferState::TrySwapBuffers: {
         [[maybe_unused]] auto const success = renderBuffer_.swapBuffers(currentTime_);
 
+        if (success && latencyProbesArmed_.load(std::memory_order_relaxed))
+            publishLatencyProbes(chrono::steady_clock::now());
+
 #if defined(CONTOUR_PERF_STATS)
         logRenderBufferSwap(success, lastFrameID_);
 #endif
@@ -305,7 +530,22 @@ bool Terminal::ensureFreshRenderBuffer(bool _locked)
 void Terminal::refreshRenderBuffer(RenderBuffer& _output)
 {
     auto const _l = lock_guard { *this };
-    refreshRenderBufferInternal(_output);
+    refreshRenderBufferInternal(_output, viewport_);
+}
+
+Viewport<Terminal>& Terminal::createViewport()
+{
+    // Shares screen/grid state and the PTY; only the scroll position is
+    // per-viewport. Scrolling an additional viewport wakes the event loop the
+    // same way the main viewport does, so its owner gets a fresh frame.
+    extraViewports_.emplace_back(screen_, [this]() { breakLoopAndRefreshRenderBuffer(); });
+    return extraViewports_.back();
+}
+
+void Terminal::renderViewport(Viewport<Terminal> const& _viewport, RenderBuffer& _output)
+{
+    auto const _l = lock_guard { *this };
+    refreshRenderBufferInternal(_output, _viewport);
 }
 
 RenderCell makeRenderCell(ColorPalette const& _colorPalette,
@@ -359,6 +599,18 @@ bool Terminal::SelectionHelper::wordDelimited(CellLocation _pos) const noexcept
     // Word selection may be off by one
     _pos.column = min(_pos.column, boxed_cast<ColumnOffset>(terminal->pageSize().columns - 1));
 
+    // Trivial (compact) lines answer the query right off their US-ASCII text,
+    // avoiding the cell inflation that makes double-clicks in huge scrollbacks hitch.
+    if (auto const& line = terminal->screen().grid().lineAt(_pos.line); line.isTrivialBuffer())
+    {
+        auto const& text = line.trivialBuffer().text;
+        auto const column = unbox<size_t>(_pos.column);
+        if (column >= text.size() || text[column] == ' ')
+            return true;
+        auto const codepoint = static_cast<char32_t>(static_cast<uint8_t>(text[column]));
+        return terminal->wordDelimiters_.find(codepoint) != terminal->wordDelimiters_.npos;
+    }
+
     Cell const& cell = terminal->screen().at(_pos);
     return cell.empty()
            || terminal->wordDelimiters_.find(cell.codepoint(0)) != terminal->wordDelimiters_.npos;
@@ -374,6 +626,13 @@ bool Terminal::SelectionHelper::cellEmpty(CellLocation _pos) const noexcept
     // Word selection may be off by one
     _pos.column = min(_pos.column, boxed_cast<ColumnOffset>(terminal->pageSize().columns - 1));
 
+    if (auto const& line = terminal->screen().grid().lineAt(_pos.line); line.isTrivialBuffer())
+    {
+        auto const& text = line.trivialBuffer().text;
+        auto const column = unbox<size_t>(_pos.column);
+        return column >= text.size() || text[column] == ' ';
+    }
+
     return terminal->screen().at(_pos).empty();
 }
 
@@ -382,21 +641,46 @@ int Terminal::SelectionHelper::cellWidth(CellLocation _pos) const noexcept
     // Word selection may be off by one
     _pos.column = min(_pos.column, boxed_cast<ColumnOffset>(terminal->pageSize().columns - 1));
 
+    // Trivial lines hold US-ASCII text only, i.e. all cells are width 1.
+    if (terminal->screen().grid().lineAt(_pos.line).isTrivialBuffer())
+        return 1;
+
     return terminal->screen().at(_pos).width();
 }
 
-void Terminal::refreshRenderBufferInternal(RenderBuffer& _output)
+void Terminal::refreshRenderBufferInternal(RenderBuffer& _output, Viewport<Terminal> const& _viewport)
 {
+    CRISPY_PERF_SCOPE("terminal.refreshRenderBuffer");
+    CRISPY_ALLOCATION_FRAME("terminal.refreshRenderBuffer");
+
     verifyState();
 
+    // Stale echo predictions must vanish even when no further PTY output
+    // arrives to reconcile them against.
+    if (!echoPredictions_.empty()
+        && echoPredictions_.front().createdAt + EchoPredictionTimeout < currentTime_)
+        echoPredictions_.clear();
+
+    // Composing for an additional viewport (split pane) must not consume the
+    // dirty state nor advance the statistics window: the main frame pipeline
+    // still owes its own refresh for the very same screen updates.
+    bool const isMainViewport = &_viewport == &viewport_;
+
     auto const renderHyperlinks = screen_.contains(currentMousePosition_);
 
-    auto const currentMousePositionRel = viewport_.translateScreenToGridCoordinate(currentMousePosition_);
+    auto const currentMousePositionRel = _viewport.translateScreenToGridCoordinate(currentMousePosition_);
 
-    changes_.store(0);
-    screenDirty_ = false;
     ++lastFrameID_;
 
+    if (isMainViewport)
+    {
+        changes_.store(0);
+        screenDirty_ = false;
+        pendingRenderBytes_.store(0, std::memory_order_relaxed);
+        ++composedFrameCount_;
+        updateStatisticsOverlay();
+    }
+
     _output.clear();
     _output.frameID = lastFrameID_;
 
@@ -416,28 +700,221 @@ void Terminal::refreshRenderBufferInternal(RenderBuffer& _output)
     if (href)
         href->state = HyperlinkState::Hover; // TODO: Left-Ctrl pressed?
 
-    _output.cursor = renderCursor();
+    _output.cursor = renderCursor(_viewport);
     auto const reverseVideo = screen_.isModeEnabled(terminal::DECMode::ReverseVideo);
+
+    // {{{ determine which display rows are damaged since the last composed frame
+    auto const scrollOffset = _viewport.scrollOffset();
+    auto const pageLineCount = unbox<size_t>(screen_.pageSize().lines);
+    auto const realCursorDisplayLine =
+        screen_.realCursorPosition().line + boxed_cast<LineOffset>(scrollOffset);
+    auto const shownCursorDisplayLine =
+        _output.cursor ? _output.cursor->position.line : realCursorDisplayLine;
+
+    // A changed scroll offset shifts the previously composed frame's rows by
+    // displayShift rather than invalidating them: the row now displayed at
+    // row r was previously displayed at row r - displayShift.
+    auto const displayShift = unbox<int>(scrollOffset) - unbox<int>(renderedScrollOffset_);
+
+    // {{{ resolve overlay spans to the display rows they cover this frame
+    overlayRowsScratch_.resize(pageLineCount);
+    for (auto& rowOverlays: overlayRowsScratch_)
+        rowOverlays.clear();
+    for (auto const* spans: { &overlaySpans_, &statsOverlaySpans_ })
+        for (OverlaySpan const& span: *spans)
+        {
+            auto const gridOffset = screen_.grid().lineOffsetForAbsolute(span.line);
+            if (!gridOffset)
+                continue;
+            auto const displayLine = *gridOffset + boxed_cast<LineOffset>(scrollOffset);
+            if (LineOffset(0) <= displayLine && unbox<size_t>(displayLine) < pageLineCount)
+                overlayRowsScratch_[unbox<size_t>(displayLine)].push_back(&span);
+        }
+    // }}}
+
+    // {{{ trivial-line rendering bypass
+    // Rows whose Line is still trivially stored (US-ASCII text, fully default
+    // SGR) and that are not touched by the cursor, a selection, an overlay
+    // span, or an echo prediction are emitted as whole RenderLines drawn
+    // straight from their text, bypassing cell inflation and the per-cell
+    // pipeline entirely. On log-scrolling workloads this covers the vast
+    // majority of rows.
+    bypassedRenderLinesScratch_.assign(pageLineCount, false);
+    if (!reverseVideo && !selection_ && !href && echoPredictions_.empty())
+    {
+        for (size_t row = 0; row < pageLineCount; ++row)
+        {
+            auto const displayLine = LineOffset::cast_from(row);
+            if (displayLine == realCursorDisplayLine || displayLine == shownCursorDisplayLine)
+                continue;
+            if (!overlayRowsScratch_[row].empty())
+                continue;
+            auto const& line = screen_.grid().lineAt(displayLine - boxed_cast<LineOffset>(scrollOffset));
+            if (!line.isTrivialBuffer() || line.trivialBuffer().attributes != GraphicsAttributes {})
+                continue;
+            bypassedRenderLinesScratch_[row] = true;
+            if (line.trivialBuffer().text.empty())
+                continue;
+            _output.lines.emplace_back(RenderLine { line.trivialBuffer().text,
+                                                    displayLine,
+                                                    ColumnCount::cast_from(line.trivialBuffer().text.size()),
+                                                    screen_.colorPalette().defaultForeground,
+                                                    screen_.colorPalette().defaultBackground,
+                                                    CellFlags {} });
+        }
+    }
+    // }}}
+
+    bool const trackDamage = renderDamageValid_ && isMainViewport && !selection_ && !href
+                             && echoPredictions_.empty() && &_output == &renderBuffer_.backBuffer()
+                             && renderBuffer_.lastWrittenBuffer() != nullptr
+                             && renderBuffer_.lastWrittenBuffer() != &_output
+                             && size_t(std::abs(displayShift)) < pageLineCount
+                             && reverseVideo == renderedReverseVideo_
+                             && renderedLines_.size() == pageLineCount
+                             && renderColorsEqual(screen_.colorPalette(), renderedColorPalette_);
+
+    dirtyRenderLines_.assign(pageLineCount, !trackDamage);
+    if (trackDamage)
+    {
+        for (size_t row = 0; row < pageLineCount; ++row)
+        {
+            auto const& line =
+                screen_.grid().lineAt(LineOffset::cast_from(row) - boxed_cast<LineOffset>(scrollOffset));
+            auto const sourceRow = static_cast<int>(row) - displayShift;
+            if (!(0 <= sourceRow && size_t(sourceRow) < pageLineCount)
+                || renderedLines_[size_t(sourceRow)].line != &line)
+            {
+                dirtyRenderLines_[row] = true;
+                continue;
+            }
+            // Identical-rewrite suppression: shells with fancy prompts
+            // rewrite the prompt line (CR + EL + same text) dozens of times
+            // per keystroke. A bumped generation with an unchanged content
+            // hash means identical rendering, so the row stays clean; the
+            // hash is cached per generation, making untouched rows one
+            // integer compare.
+            auto const& rendered = renderedLines_[size_t(sourceRow)];
+            dirtyRenderLines_[row] =
+                rendered.generation != line.generation() && rendered.contentHash != line.contentHash();
+        }
+
+        // The cursor is painted into the cells, so its current and previously
+        // rendered rows must always be re-emitted (this also covers blinking).
+        // The previously rendered rows moved along with the shift.
+        auto const markRowDirty = [&](LineOffset _displayLine) {
+            if (auto const row = unbox<int>(_displayLine); 0 <= row && size_t(row) < pageLineCount)
+                dirtyRenderLines_[size_t(row)] = true;
+        };
+        markRowDirty(realCursorDisplayLine);
+        markRowDirty(shownCursorDisplayLine);
+        markRowDirty(renderedCursorLines_[0] + LineOffset(displayShift));
+        markRowDirty(renderedCursorLines_[1] + LineOffset(displayShift));
+
+        // Overlay spans are anchored to absolute line numbers and thus move
+        // along with their content; only a *changed* span set requires
+        // re-emitting the rows covered before and after the change.
+        if (overlayGeneration_ != renderedOverlayGeneration_)
+        {
+            for (size_t row = 0; row < pageLineCount; ++row)
+                if (!overlayRowsScratch_[row].empty())
+                    dirtyRenderLines_[row] = true;
+            for (size_t const row: renderedOverlayRows_)
+                markRowDirty(LineOffset::cast_from(row) + LineOffset(displayShift));
+        }
+
+        // A row drawn via the trivial-line bypass last frame left no cells in
+        // the previously composed frame to stitch back in; falling back to
+        // the cell path therefore forces a re-emit.
+        for (size_t row = 0; row < pageLineCount; ++row)
+        {
+            auto const sourceRow = static_cast<int>(row) - displayShift;
+            if (0 <= sourceRow && size_t(sourceRow) < renderedBypassedLines_.size()
+                && renderedBypassedLines_[size_t(sourceRow)] && !bypassedRenderLinesScratch_[row])
+                dirtyRenderLines_[row] = true;
+        }
+    }
+    // }}}
+
+    // Applies an overlay span's extras onto a just-emitted cell: OR in the
+    // style flags and, where the span carries replacement text, substitute
+    // the cell's content (one codepoint per covered column); the grid cell
+    // itself stays untouched.
+    auto const applyOverlay = [](OverlaySpan const& _span, ColumnOffset _column, RenderCell& _cell) {
+        _cell.flags |= _span.styles;
+        if (_span.text.empty())
+            return;
+        auto const index = unbox<size_t>(_column - _span.beginColumn);
+        _cell.codepoints.clear();
+        if (index < _span.text.size())
+            _cell.codepoints.push_back(_span.text[index]);
+        _cell.width = 1;
+        _cell.image = {};
+    };
+
     screen_.render(
         [this,
          reverseVideo,
+         &applyOverlay,
          &_output,
+         &_viewport,
          prevWidth = 0,
          prevHasCursor = false,
          state = State::Gap,
+         colorRun = ColorRunMemo {},
          lineNr = LineOffset(0)](Cell const& _cell, LineOffset _line, ColumnOffset _column) mutable {
+            if (!dirtyRenderLines_[unbox<size_t>(_line)])
+                return;
+
             // clang-format off
-            auto const selected = isSelected( CellLocation { _line - boxed_cast<LineOffset>(viewport_.scrollOffset()), _column });
+            auto const selected = isSelected( CellLocation { _line - boxed_cast<LineOffset>(_viewport.scrollOffset()), _column });
             auto const pos = CellLocation { _line, _column };
-            auto const gridPosition = viewport_.translateScreenToGridCoordinate(pos);
+            auto const gridPosition = _viewport.translateScreenToGridCoordinate(pos);
             auto const hasCursor = gridPosition == screen_.realCursorPosition();
             bool const paintCursor =
                 (hasCursor || (prevHasCursor && prevWidth == 2))
                     && _output.cursor.has_value()
                     && _output.cursor->shape == CursorShape::Block;
-            auto const [fg, bg] = makeColors(screen_.colorPalette(), _cell, reverseVideo, selected, paintCursor);
             // clang-format on
 
+            // Overlay spans (if any cover this cell) override the resolved
+            // colors and bypass the color-run memo; spans are short, so the
+            // extra makeColors() calls do not matter.
+            OverlaySpan const* overlay = nullptr;
+            for (OverlaySpan const* span: overlayRowsScratch_[unbox<size_t>(_line)])
+                if (span->beginColumn <= _column && _column < span->endColumn)
+                {
+                    overlay = span;
+                    break;
+                }
+
+            auto fg = RGBColor {};
+            auto bg = RGBColor {};
+            if (overlay)
+            {
+                auto const [resolvedFg, resolvedBg] =
+                    makeColors(screen_.colorPalette(), _cell, reverseVideo, selected, paintCursor);
+                fg = overlay->foregroundColor.value_or(resolvedFg);
+                bg = overlay->backgroundColor.value_or(resolvedBg);
+                colorRun.valid = false;
+            }
+            else
+            {
+                if (!colorRun.valid || colorRun.fg != _cell.foregroundColor()
+                    || colorRun.bg != _cell.backgroundColor() || colorRun.flags != _cell.styles()
+                    || colorRun.selected != selected || colorRun.paintCursor != paintCursor)
+                {
+                    auto const [resolvedFg, resolvedBg] =
+                        makeColors(screen_.colorPalette(), _cell, reverseVideo, selected, paintCursor);
+                    colorRun = ColorRunMemo { _cell.foregroundColor(), _cell.backgroundColor(),
+                                              _cell.styles(),          selected,
+                                              paintCursor,             true,
+                                              resolvedFg,              resolvedBg };
+                }
+                fg = colorRun.resolvedFg;
+                bg = colorRun.resolvedBg;
+            }
+
             prevWidth = _cell.width();
             prevHasCursor = hasCursor;
 
@@ -458,7 +935,7 @@ void Terminal::refreshRenderBufferInternal(RenderBuffer& _output)
             switch (state)
             {
             case State::Gap:
-                if (!cellEmpty || customBackground)
+                if (!cellEmpty || customBackground || overlay)
                 {
                     state = State::Sequence;
                     // clang-format off
@@ -471,10 +948,12 @@ void Terminal::refreshRenderBufferInternal(RenderBuffer& _output)
                                                                _column));
                     // clang-format on
                     _output.screen.back().groupStart = true;
+                    if (overlay)
+                        applyOverlay(*overlay, _column, _output.screen.back());
                 }
                 break;
             case State::Sequence:
-                if (cellEmpty && !customBackground)
+                if (cellEmpty && !customBackground && !overlay)
                 {
                     _output.screen.back().groupEnd = true;
                     state = State::Gap;
@@ -493,19 +972,346 @@ void Terminal::refreshRenderBufferInternal(RenderBuffer& _output)
 
                     if (isNewLine)
                         _output.screen.back().groupStart = true;
+                    if (overlay)
+                        applyOverlay(*overlay, _column, _output.screen.back());
                 }
                 break;
             }
         },
-        viewport_.scrollOffset());
+        [this](LineOffset _line) noexcept { return bool(bypassedRenderLinesScratch_[unbox<size_t>(_line)]); },
+        _viewport.scrollOffset());
+
+    // {{{ stitch clean rows from the previously composed frame back in
+    if (trackDamage)
+    {
+        auto const& previousScreen = renderBuffer_.lastWrittenBuffer()->screen;
+        auto& merged = renderCellScratch_;
+        merged.clear();
+        merged.reserve(previousScreen.size() + _output.screen.size());
+        size_t freshIndex = 0;
+        size_t previousIndex = 0;
+        for (size_t row = 0; row < pageLineCount; ++row)
+        {
+            auto const rowOffset = LineOffset::cast_from(row);
+            // A clean row's cells live in the previous frame at the row it was
+            // displayed at back then, i.e. shifted by -displayShift.
+            auto const sourceOffset = LineOffset::cast_from(static_cast<int>(row) - displayShift);
+            auto const rowStart = merged.size();
+            while (previousIndex < previousScreen.size()
+                   && previousScreen[previousIndex].position.line < sourceOffset)
+                ++previousIndex;
+            // Bypassed rows are fully covered by their RenderLine; stitching
+            // the previous frame's cells in as well would draw them twice.
+            if (dirtyRenderLines_[row] || bypassedRenderLinesScratch_[row])
+            {
+                while (freshIndex < _output.screen.size()
+                       && _output.screen[freshIndex].position.line == rowOffset)
+                    merged.emplace_back(std::move(_output.screen[freshIndex++]));
+                while (previousIndex < previousScreen.size()
+                       && previousScreen[previousIndex].position.line == sourceOffset)
+                    ++previousIndex;
+            }
+            else
+            {
+                while (previousIndex < previousScreen.size()
+                       && previousScreen[previousIndex].position.line == sourceOffset)
+                {
+                    merged.push_back(previousScreen[previousIndex++]);
+                    merged.back().position.line = rowOffset;
+                }
+            }
+            // Cell groups never span lines; make the boundary explicit on stitched rows.
+            if (merged.size() != rowStart)
+                merged.back().groupEnd = true;
+        }
+        _output.screen.swap(merged);
+    }
+    // }}}
+
+    // {{{ overlay provisional glyphs for keystrokes whose echo is still in flight
+    for (EchoPrediction const& prediction: echoPredictions_)
+    {
+        auto const displayLine = prediction.position.line + boxed_cast<LineOffset>(scrollOffset);
+        if (!screen_.contains(prediction.position)
+            || !(LineOffset(0) <= displayLine
+                 && displayLine < boxed_cast<LineOffset>(screen_.pageSize().lines)))
+            continue;
+
+        auto& cell = _output.screen.emplace_back();
+        cell.codepoints.assign(1, prediction.codepoint);
+        cell.position = CellLocation { displayLine, prediction.position.column };
+        cell.flags = CellFlags::Underline;
+        cell.foregroundColor = screen_.colorPalette().defaultForeground;
+        cell.backgroundColor = screen_.colorPalette().defaultBackground;
+        cell.decorationColor = screen_.colorPalette().defaultForeground;
+        cell.groupStart = true;
+        cell.groupEnd = true;
+    }
+    // }}}
+
+    // {{{ publish this frame's damage, so the compositor can confine itself to it
+    if (trackDamage)
+    {
+        // NB: an all-clean frame yields the empty range (first > second).
+        auto firstDirty = LineOffset::cast_from(pageLineCount);
+        auto lastDirty = LineOffset(-1);
+        for (size_t row = 0; row < pageLineCount; ++row)
+        {
+            if (!dirtyRenderLines_[row])
+                continue;
+            firstDirty = std::min(firstDirty, LineOffset::cast_from(row));
+            lastDirty = std::max(lastDirty, LineOffset::cast_from(row));
+        }
+        _output.damagedLineRange = pair { firstDirty, lastDirty };
+        _output.scrolledRows = displayShift;
+    }
+    // }}}
+
+    // {{{ remember what this frame was composed of, for the next refresh's damage pass
+    // Frames composed for additional viewports leave the baseline untouched:
+    // it describes the main pipeline's most recent frame, which remains valid.
+    if (isMainViewport)
+    {
+        renderedLines_.resize(pageLineCount);
+        for (size_t row = 0; row < pageLineCount; ++row)
+        {
+            auto const& line =
+                screen_.grid().lineAt(LineOffset::cast_from(row) - boxed_cast<LineOffset>(scrollOffset));
+            renderedLines_[row] = RenderedLine { &line, line.generation(), line.contentHash() };
+        }
+        renderedScrollOffset_ = scrollOffset;
+        renderedReverseVideo_ = reverseVideo;
+        renderedCursorLines_ = { realCursorDisplayLine, shownCursorDisplayLine };
+        renderedOverlayGeneration_ = overlayGeneration_;
+        renderedOverlayRows_.clear();
+        for (size_t row = 0; row < pageLineCount; ++row)
+            if (!overlayRowsScratch_[row].empty())
+                renderedOverlayRows_.push_back(row);
+        renderedBypassedLines_ = bypassedRenderLinesScratch_;
+        renderedColorPalette_ = screen_.colorPalette();
+        renderDamageValid_ =
+            !selection_ && !href && echoPredictions_.empty() && &_output == &renderBuffer_.backBuffer();
+    }
+    // }}}
+
+    // {{{ history scroll prefetch
+    // While the viewport dwells in history, keep its surroundings pinned
+    // against compact-storage demotion and materialize a window of lines ahead
+    // of the scroll direction, so the next Page-Up/Down finds its lines
+    // already inflated instead of decompressing a whole page inside its own
+    // frame. Runs in the frame tail (after composition): inflation mutates
+    // line storage and thus belongs under the terminal lock held here.
+    // Main viewport only: pin windows of multiple panes would fight each
+    // other, and additional viewports inflate their lines on first compose
+    // anyway.
+    if (isMainViewport && *scrollOffset != 0)
+    {
+        auto constexpr PrefetchLineCount = LineOffset(64); // roughly two pages ahead
+        auto const viewportTop = -boxed_cast<LineOffset>(scrollOffset);
+        auto const viewportBottom = viewportTop + unbox<int>(screen_.pageSize().lines) - 1;
+        if (displayShift > 0) // scrolling upwards, deeper into history
+            screen_.grid().materializeLineRange(viewportTop - PrefetchLineCount, viewportTop - 1);
+        else if (displayShift < 0)
+            screen_.grid().materializeLineRange(viewportBottom + 1, viewportBottom + PrefetchLineCount);
+        screen_.grid().pinLineRange(viewportTop - PrefetchLineCount, viewportBottom + PrefetchLineCount);
+    }
+    else if (isMainViewport)
+        screen_.grid().unpinLineRange();
+    // }}}
 
     if (href)
         href->state = HyperlinkState::Inactive;
 }
 
-optional<RenderCursor> Terminal::renderCursor()
+std::vector<Terminal::LineTextDelta> Terminal::fetchLineTextDeltas()
+{
+    auto const _l = lock_guard { *this };
+
+    auto const pageLineCount = unbox<size_t>(screen_.pageSize().lines);
+    auto const scrollOffset = viewport_.scrollOffset();
+
+    // A page resize or a scroll position change shifts what every row shows;
+    // the simplest correct answer then is a one-time full re-report.
+    auto const fullRefresh =
+        accessibleLines_.size() != pageLineCount || accessibleScrollOffset_ != scrollOffset;
+    accessibleLines_.resize(pageLineCount);
+    accessibleScrollOffset_ = scrollOffset;
+
+    auto deltas = std::vector<LineTextDelta> {};
+    for (size_t row = 0; row < pageLineCount; ++row)
+    {
+        auto const displayLine = LineOffset::cast_from(row);
+        auto const& line =
+            screen_.grid().lineAt(displayLine - boxed_cast<LineOffset>(scrollOffset));
+        if (!fullRefresh && accessibleLines_[row].line == &line
+            && accessibleLines_[row].generation == line.generation())
+            continue;
+        accessibleLines_[row] = RenderedLine { &line, line.generation() };
+        // lineText() hands out a trivial line's text without inflating it.
+        deltas.emplace_back(LineTextDelta { displayLine, screen_.grid().lineText(line) });
+    }
+    return deltas;
+}
+
+// {{{ end-to-end latency probing
+uint64_t Terminal::injectLatencyProbe(chrono::steady_clock::time_point _now)
+{
+    auto const id = [&]() {
+        auto const _l = lock_guard { latencyProbesMutex_ };
+        auto const probeId = ++nextLatencyProbeId_;
+        pendingLatencyProbes_.emplace_back(PendingLatencyProbe { probeId, _now });
+        latencyProbesArmed_.store(true, std::memory_order_relaxed);
+        return probeId;
+    }();
+
+    {
+        auto const _l = lock_guard { inputGenerator_ };
+        inputGenerator_.generateLatencyProbe(id);
+    }
+    flushInput();
+    return id;
+}
+
+void Terminal::latencyProbeReflected(uint64_t _id)
+{
+    auto const _l = lock_guard { latencyProbesMutex_ };
+    for (auto& probe: pendingLatencyProbes_)
+        if (probe.id == _id)
+        {
+            probe.reflected = true;
+            break;
+        }
+}
+
+void Terminal::publishLatencyProbes(chrono::steady_clock::time_point _now)
+{
+    auto const _l = lock_guard { latencyProbesMutex_ };
+    for (auto& probe: pendingLatencyProbes_)
+        if (probe.reflected && probe.publishedAt == chrono::steady_clock::time_point {})
+            probe.publishedAt = _now;
+}
+
+void Terminal::completeLatencyProbes(chrono::steady_clock::time_point _now)
 {
-    if (!cursorCurrentlyVisible() || !viewport().isLineVisible(screen_.cursor().position.line))
+    // A probe completes at the first frame-swap whose frame was fetched at or
+    // after the probe's publication; an earlier swap may still present a
+    // frame composed before the echo arrived.
+    auto const fetchTime = chrono::steady_clock::time_point(
+        chrono::steady_clock::duration(lastFrontBufferFetch_.load(std::memory_order_relaxed)));
+
+    auto const _l = lock_guard { latencyProbesMutex_ };
+    auto const complete = [&](PendingLatencyProbe const& probe) {
+        // Hygiene: an unreflected probe (application not echoing) expires
+        // silently instead of keeping the bookkeeping armed forever.
+        if (!probe.reflected && _now - probe.injectedAt > chrono::seconds(10))
+            return true;
+        if (probe.publishedAt == chrono::steady_clock::time_point {} || probe.publishedAt > fetchTime)
+            return false;
+        latencyStatistics_.add(_now - probe.injectedAt);
+        return true;
+    };
+    pendingLatencyProbes_.erase(
+        remove_if(pendingLatencyProbes_.begin(), pendingLatencyProbes_.end(), complete),
+        pendingLatencyProbes_.end());
+    if (pendingLatencyProbes_.empty())
+        latencyProbesArmed_.store(false, std::memory_order_relaxed);
+}
+
+LatencyStatistics Terminal::latencyStatistics() const
+{
+    auto const _l = lock_guard { latencyProbesMutex_ };
+    return latencyStatistics_;
+}
+// }}}
+
+void Terminal::updateStatisticsOverlay()
+{
+    // The window bookkeeping is a handful of integer reads per frame, so it
+    // stays always-on and the DCS query (see Screen::requestCapabilities())
+    // works without the overlay being shown.
+    if (statsWindowStart_ == chrono::steady_clock::time_point {})
+    {
+        statsWindowStart_ = currentTime_;
+        statsWindowIngestBase_ = totalIngestedBytes_;
+        statsWindowFrameBase_ = composedFrameCount_;
+    }
+    else if (currentTime_ - statsWindowStart_ >= StatisticsSampleInterval)
+    {
+        auto const seconds =
+            chrono::duration_cast<chrono::duration<double>>(currentTime_ - statsWindowStart_).count();
+        auto const bytesPerSecond = double(totalIngestedBytes_ - statsWindowIngestBase_) / seconds;
+        auto const framesPerSecond = double(composedFrameCount_ - statsWindowFrameBase_) / seconds;
+
+        auto gridBytes = size_t { 0 };
+        for (auto const& grid: state_.grids)
+            gridBytes += grid.memoryUsage();
+
+        auto const hitPercentage = [](uint32_t _hits, uint32_t _misses) -> unsigned {
+            auto const total = _hits + _misses;
+            return total != 0 ? _hits * 100u / total : 100u;
+        };
+        auto const humanReadableBytes = [](double _value) -> string {
+            if (_value >= 1024.0 * 1024.0)
+                return fmt::format("{:.1f}M", _value / (1024.0 * 1024.0));
+            if (_value >= 1024.0)
+                return fmt::format("{:.1f}K", _value / 1024.0);
+            return fmt::format("{:.0f}", _value);
+        };
+
+        statisticsLine_ = fmt::format(
+            " {}B/s | {:.0f} fps | grid {}B | shape {}% | atlas {}% ",
+            humanReadableBytes(bytesPerSecond),
+            framesPerSecond,
+            humanReadableBytes(double(gridBytes)),
+            hitPercentage(statsWindowCacheStats_.shapingCacheHits, statsWindowCacheStats_.shapingCacheMisses),
+            hitPercentage(statsWindowCacheStats_.atlasTileHits, statsWindowCacheStats_.atlasTileMisses));
+
+        statsWindowStart_ = currentTime_;
+        statsWindowIngestBase_ = totalIngestedBytes_;
+        statsWindowFrameBase_ = composedFrameCount_;
+        statsWindowCacheStats_ = {};
+    }
+
+    if (!statisticsOverlayEnabled_.load(std::memory_order_relaxed))
+    {
+        if (!statsOverlaySpans_.empty())
+        {
+            statsOverlaySpans_.clear();
+            ++overlayGeneration_;
+        }
+        return;
+    }
+
+    if (statisticsLine_.empty())
+        return;
+
+    // Right-aligned in the top viewport row, anchored like any other overlay
+    // span, i.e. by the absolute line number currently displayed there (so
+    // the regular damage rules re-emit it when the viewport scrolls).
+    auto const columns = unbox<int>(screen_.pageSize().columns);
+    auto const visible = min(columns, int(statisticsLine_.size())); // the line is pure US-ASCII
+    auto span = OverlaySpan {};
+    span.line = screen_.grid().absoluteLineNumber(-boxed_cast<LineOffset>(viewport_.scrollOffset()));
+    span.beginColumn = ColumnOffset::cast_from(columns - visible);
+    span.endColumn = ColumnOffset::cast_from(columns);
+    span.styles = CellFlags::Bold;
+    span.foregroundColor = screen_.colorPalette().defaultBackground;
+    span.backgroundColor = screen_.colorPalette().defaultForeground;
+    span.text.assign(statisticsLine_.end() - visible, statisticsLine_.end());
+
+    auto const changed = statsOverlaySpans_.empty() || statsOverlaySpans_.front().line != span.line
+                         || statsOverlaySpans_.front().beginColumn != span.beginColumn
+                         || statsOverlaySpans_.front().text != span.text;
+    if (changed)
+    {
+        statsOverlaySpans_.assign(1, span);
+        ++overlayGeneration_;
+    }
+}
+
+optional<RenderCursor> Terminal::renderCursor(Viewport<Terminal> const& _viewport)
+{
+    if (!state_.cursor.visible || !_viewport.isLineVisible(screen_.cursor().position.line))
         return nullopt;
 
     // TODO: check if CursorStyle has changed, and update render context accordingly.
@@ -515,8 +1321,15 @@ optional<RenderCursor> Terminal::renderCursor()
     auto constexpr InactiveCursorShape = CursorShape::Rectangle; // TODO configurable
     auto const shape = screen_.focused() ? cursorShape() : InactiveCursorShape;
 
+    // The block cursor is painted into the grid cells (fg/bg swap), so its blink
+    // phase must be baked into the composed frame. All other shapes are drawn as
+    // an overlay whose blink phase the renderer applies at paint time, so a
+    // blink flip does not require re-composing the frame at all.
+    if (shape == CursorShape::Block && !cursorCurrentlyVisible())
+        return nullopt;
+
     return RenderCursor { CellLocation { screen_.cursor().position.line
-                                             + viewport_.scrollOffset().as<LineOffset>(),
+                                             + _viewport.scrollOffset().as<LineOffset>(),
                                          screen_.cursor().position.column },
                           shape,
                           cursorCell.width() };
@@ -550,11 +1363,76 @@ bool Terminal::sendCharPressEvent(char32_t _value, Modifier _modifier, Timestamp
 
     auto const success = inputGenerator_.generate(_value, _modifier);
 
+    if (success && echoPredictionEnabled_)
+        predictEcho(_value, _modifier, _now);
+
     flushInput();
     viewport_.scrollToBottom();
     return success;
 }
 
+void Terminal::setEchoPrediction(bool _enabled)
+{
+    echoPredictionEnabled_ = _enabled;
+    echoPredictions_.clear();
+}
+
+void Terminal::predictEcho(char32_t _value, Modifier _modifier, Timestamp _now)
+{
+    // Only plain printable single-width keystrokes on the primary screen are
+    // predictable; control keys, alternate-screen applications (which rarely
+    // echo 1:1) and anything that might wrap at the right margin are passed
+    // through unpredicted.
+    if (_modifier != Modifier::None && _modifier != Modifier::Shift)
+        return;
+    if (_value < 0x20 || _value == 0x7F || codepointWidth(_value) != 1)
+        return;
+
+    auto const _l = lock_guard { *this };
+    if (!screen_.isPrimaryScreen())
+        return;
+
+    auto const position = echoPredictions_.empty()
+                              ? screen_.realCursorPosition()
+                              : CellLocation { echoPredictions_.back().position.line,
+                                               echoPredictions_.back().position.column + 1 };
+    if (position.column + 1 >= boxed_cast<ColumnOffset>(screen_.pageSize().columns))
+        return;
+
+    echoPredictions_.push_back(EchoPrediction { position, _value, _now });
+    screenDirty_ = true;
+    breakLoopAndRefreshRenderBuffer();
+}
+
+void Terminal::reconcileEchoPredictions()
+{
+    // Retires predictions the real echo has confirmed, front to back. As soon
+    // as the screen disagrees with one, the remainder was predicted relative
+    // to a wrong cursor and is dropped wholesale; likewise when the oldest
+    // prediction stays unconfirmed for too long.
+    while (!echoPredictions_.empty())
+    {
+        auto const& prediction = echoPredictions_.front();
+        if (!screen_.isPrimaryScreen() || !screen_.contains(prediction.position))
+        {
+            echoPredictions_.clear();
+            break;
+        }
+        Cell const& cell = screen_.at(prediction.position);
+        if (cell.codepointCount() == 1 && cell.codepoint(0) == prediction.codepoint)
+        {
+            echoPredictions_.erase(echoPredictions_.begin());
+            continue;
+        }
+        if (!cell.empty() || prediction.createdAt + EchoPredictionTimeout < currentTime_)
+        {
+            echoPredictions_.clear();
+            break;
+        }
+        break; // Echo simply did not arrive yet.
+    }
+}
+
 bool Terminal::sendMousePressEvent(Modifier _modifier,
                                    MouseButton _button,
                                    MousePixelPosition _pixelPosition,
@@ -621,6 +1499,43 @@ void Terminal::clearSelection()
     breakLoopAndRefreshRenderBuffer();
 }
 
+void Terminal::setOverlaySpans(vector<OverlaySpan> _spans)
+{
+    overlaySpans_ = move(_spans);
+    ++overlayGeneration_;
+    screenDirty_ = true;
+    breakLoopAndRefreshRenderBuffer();
+}
+
+void Terminal::clearOverlaySpans()
+{
+    if (overlaySpans_.empty())
+        return;
+    overlaySpans_.clear();
+    ++overlayGeneration_;
+    screenDirty_ = true;
+    breakLoopAndRefreshRenderBuffer();
+}
+
+void Terminal::setStatisticsOverlayEnabled(bool _enabled)
+{
+    if (statisticsOverlayEnabled_.exchange(_enabled) == _enabled)
+        return;
+    // The VT thread picks the change up in updateStatisticsOverlay() on the
+    // next compose; just make sure one happens soon.
+    screenDirty_ = true;
+    breakLoopAndRefreshRenderBuffer();
+}
+
+void Terminal::reportRenderCacheStats(RenderCacheStats const& _stats)
+{
+    auto const _l = lock_guard { *this };
+    statsWindowCacheStats_.shapingCacheHits += _stats.shapingCacheHits;
+    statsWindowCacheStats_.shapingCacheMisses += _stats.shapingCacheMisses;
+    statsWindowCacheStats_.atlasTileHits += _stats.atlasTileHits;
+    statsWindowCacheStats_.atlasTileMisses += _stats.atlasTileMisses;
+}
+
 bool Terminal::sendMouseMoveEvent(Modifier _modifier,
                                   CellLocation newPosition,
                                   MousePixelPosition _pixelPosition,
@@ -656,9 +1571,12 @@ bool Terminal::sendMouseMoveEvent(Modifier _modifier,
 
     if (selectionAvailable() && selector()->state() != Selection::State::Complete)
     {
-        changed = true;
-        selector()->extend(relativePos);
-        breakLoopAndRefreshRenderBuffer();
+        // Only trigger a full render buffer refresh when the selection's covered
+        // region actually changed, i.e. not for mouse moves within the same cell
+        // (such as sub-cell moves with SGR-Pixels mouse reporting enabled) nor for
+        // moves that word-wise/full-line selection snapping maps to the same range.
+        if (selector()->extend(relativePos))
+            breakLoopAndRefreshRenderBuffer();
         return true;
     }
 
@@ -732,8 +1650,30 @@ bool Terminal::sendFocusOutEvent()
 
 void Terminal::sendPaste(string_view _text)
 {
-    inputGenerator_.generatePaste(_text);
-    flushInput();
+    bool const pasteAlreadyPending = [&]() {
+        auto const _l = std::lock_guard { inputGenerator_ };
+        return !pendingPaste_.empty();
+    }();
+
+    if (!pasteAlreadyPending && _text.size() <= PasteChunkSize)
+    {
+        inputGenerator_.generatePaste(_text);
+        flushInput();
+        return;
+    }
+
+    // Frame the paste up front - the bracketed-paste markers belong around
+    // the whole paste, not around each chunk - and let the main loop trickle
+    // it into the PTY (see flushPendingPaste()).
+    {
+        auto const _l = std::lock_guard { inputGenerator_ };
+        if (inputGenerator_.bracketedPaste())
+            pendingPaste_ += "\033[200~"sv;
+        pendingPaste_ += _text;
+        if (inputGenerator_.bracketedPaste())
+            pendingPaste_ += "\033[201~"sv;
+    }
+    pty_.wakeupReader();
 }
 
 void Terminal::sendRaw(string_view _text)
@@ -752,6 +1692,19 @@ size_t Terminal::pendingInputBytes() const noexcept
 }
 
 void Terminal::flushInput()
+{
+    if (!hasInput())
+        return;
+
+    // The listener may take over, coalescing all input generated within this
+    // event-loop turn (key repeat storms, mouse reports) into one PTY write.
+    if (eventListener_.deferInputFlush())
+        return;
+
+    flushInputNow();
+}
+
+void Terminal::flushInputNow()
 {
     auto const _l = std::lock_guard { inputGenerator_ };
     if (inputGenerator_.peek().empty())
@@ -764,10 +1717,76 @@ void Terminal::flushInput()
         inputGenerator_.consume(rv);
 }
 
+bool Terminal::flushPendingPaste()
+{
+    // Chunks are copied out under the lock (the pasting thread may grow
+    // pendingPaste_ concurrently) and written without it, so keystrokes
+    // generated while a paste is draining are not blocked on the PTY.
+    // UnixPty::write() itself gates each chunk on the fd becoming writable,
+    // which is what provides the backpressure here.
+    auto chunk = string {};
+    for (;;)
+    {
+        {
+            auto const _l = std::lock_guard { inputGenerator_ };
+            if (pendingPasteOffset_ == pendingPaste_.size())
+            {
+                pendingPaste_.clear();
+                pendingPasteOffset_ = 0;
+                return false;
+            }
+            chunk.assign(pendingPaste_, pendingPasteOffset_, PasteChunkSize);
+        }
+
+        auto const rv = pty_.write(chunk.data(), chunk.size());
+        if (rv > 0)
+        {
+            auto const _l = std::lock_guard { inputGenerator_ };
+            pendingPasteOffset_ += static_cast<size_t>(rv);
+        }
+        if (rv <= 0 || static_cast<size_t>(rv) < chunk.size())
+            return true; // PTY full; continue once it drained.
+    }
+}
+
 void Terminal::writeToScreen(string_view _data)
 {
+    // Feed the parser in bounded chunks, re-entering the lock through its
+    // entry gate in between, so that a large PTY read (ptyReadBufferSize_ is
+    // user-configurable and may be megabytes) never blocks UI-thread queries
+    // for the whole burst's parse time. The parser carries partial UTF-8 and
+    // escape sequences across write() calls, so chunk boundaries need no
+    // alignment.
+    while (_data.size() > WriteChunkSize)
+    {
+        auto const _l = lock_guard { *this };
+        screen_.write(_data.substr(0, WriteChunkSize));
+        pendingRenderBytes_.fetch_add(WriteChunkSize, std::memory_order_relaxed);
+        _data.remove_prefix(WriteChunkSize);
+    }
+
     auto const _l = lock_guard { *this };
     screen_.write(_data);
+    pendingRenderBytes_.fetch_add(_data.size(), std::memory_order_relaxed);
+    if (!echoPredictions_.empty())
+        reconcileEchoPredictions();
+}
+
+void Terminal::publishViewportSnapshot() noexcept
+{
+    // Callers hold the terminal lock (or, in the constructor, are still
+    // single-threaded), so updates are serialized; the sequence word is odd
+    // exactly while the data below is being replaced.
+    auto const next = ViewportSnapshot { screen_.pageSize(), screen_.historyLineCount() };
+    if (next.pageSize == viewportSnapshotData_.pageSize
+        && next.historyLineCount == viewportSnapshotData_.historyLineCount)
+        return;
+
+    auto const seq = viewportSnapshotSeq_.load(std::memory_order_relaxed);
+    viewportSnapshotSeq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    viewportSnapshotData_ = next;
+    viewportSnapshotSeq_.store(seq + 2, std::memory_order_release);
 }
 
 void Terminal::updateCursorVisibilityState() const
@@ -830,6 +1849,7 @@ void Terminal::resizeScreen(PageSize _cells, optional<ImageSize> _pixels)
     currentMousePosition_.line = min(currentMousePosition_.line, boxed_cast<LineOffset>(_cells.lines - 1));
 
     pty_.resizeScreen(_cells, _pixels);
+    publishViewportSnapshot();
 
     verifyState();
 }
@@ -855,34 +1875,82 @@ void Terminal::setWordDelimiters(string const& _wordDelimiters)
     wordDelimiters_ = unicode::from_utf8(_wordDelimiters);
 }
 
-string Terminal::extractSelectionText() const
+void Terminal::extractSelectionText(std::function<void(string_view)> const& _sink) const
 {
+    // Accumulated text is handed off to the sink whenever it exceeds this
+    // threshold (at line boundaries only), bounding the working set
+    // independently of the selection's size.
+    auto constexpr FlushThreshold = size_t { 64 * 1024 };
+
     using namespace terminal;
-    ColumnOffset lastColumn = {};
     string text;
     string currentLine;
 
-    renderSelection([&](CellLocation const& _pos, Cell const& _cell) {
-        auto const _lock = scoped_lock { *this };
-        auto const isNewLine = _pos.column <= lastColumn;
+    // Locked once around the whole pass: the previous per-cell locking left
+    // the selection-range iteration itself reading cells unguarded.
+    auto const _lock = scoped_lock { *this };
+
+    if (!selection_ || selection_->state() == Selection::State::Waiting)
+        return;
+
+    auto const rightPageColumn = screen_.pageSize().columns.as<ColumnOffset>() - 1;
+
+    // One pass over the grid: every selected line contributes its column slice
+    // in bulk -- a substring copy for trivial (single-SGR ASCII) lines, a
+    // single sweep over the cell span otherwise -- instead of one callback and
+    // one grid lookup per cell. This is what makes rectangular selections over
+    // deep scrollback (column-oriented logs) cheap to yank.
+    auto const ranges = selection_->ranges();
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        auto const& range = ranges[i];
         bool const touchesRightPage =
-            _pos.line.value > 0
-            && isSelected({ _pos.line - 1, screen_.pageSize().columns.as<ColumnOffset>() - 1 });
-        if (isNewLine && (!isLineWrapped(_pos.line) || !touchesRightPage))
+            i != 0 && range.line.value > 0 && ranges[i - 1].toColumn == rightPageColumn;
+        if (i != 0 && (!isLineWrapped(range.line) || !touchesRightPage))
         {
             // TODO: handle logical line in word-selection (don't include LF in wrapped lines)
             trimSpaceRight(currentLine);
             text += currentLine;
             text += '\n';
             currentLine.clear();
+
+            if (text.size() >= FlushThreshold)
+            {
+                _sink(text);
+                text.clear();
+            }
+        }
+
+        auto const& line = screen_.grid().lineAt(range.line);
+        if (line.isTrivialBuffer())
+        {
+            // Columns past the stored text are blank cells and contribute
+            // nothing, exactly like empty cells on the inflated path.
+            auto const& lineText = line.trivialBuffer().text;
+            if (unbox<size_t>(range.fromColumn) < lineText.size())
+                currentLine += string_view(lineText).substr(
+                    unbox<size_t>(range.fromColumn),
+                    min(unbox<size_t>(range.length()), lineText.size() - unbox<size_t>(range.fromColumn)));
+        }
+        else
+        {
+            for (Cell const& cell:
+                 line.cells().subspan(unbox<size_t>(range.fromColumn), unbox<size_t>(range.length())))
+                currentLine += cell.toUtf8();
         }
-        currentLine += _cell.toUtf8();
-        lastColumn = _pos.column;
-    });
+    }
 
     trimSpaceRight(currentLine);
     text += currentLine;
 
+    if (!text.empty())
+        _sink(text);
+}
+
+string Terminal::extractSelectionText() const
+{
+    string text;
+    extractSelectionText([&](string_view _chunk) { text += _chunk; });
     return text;
 }
 
@@ -905,10 +1973,14 @@ string Terminal::extractLastMarkRange() const
 
     string text;
 
+    // One buffer reused across lines; trivial lines are viewed in place.
+    string lineBuffer;
     for (auto lineNum = firstLine; lineNum <= lastLine; ++lineNum)
     {
-        auto const lineText = screen_.grid().lineAt(lineNum).toUtf8Trimmed();
-        text += screen_.grid().lineAt(lineNum).toUtf8Trimmed();
+        auto chars = screen_.grid().lineText(lineNum, lineBuffer);
+        while (!chars.empty() && isspace(chars.back()))
+            chars.remove_suffix(1);
+        text += chars;
         text += '\n';
     }
 
@@ -937,11 +2009,14 @@ void Terminal::scrollbackBufferCleared()
 {
     selection_.reset();
     viewport_.scrollToBottom();
+    publishViewportSnapshot();
     breakLoopAndRefreshRenderBuffer();
 }
 
 void Terminal::screenUpdated()
 {
+    publishViewportSnapshot();
+
     if (!renderBufferUpdateEnabled_)
         return;
 
@@ -982,10 +2057,10 @@ void Terminal::notify(string_view _title, string_view _body)
 
 void Terminal::reply(string_view _reply)
 {
-    // this is invoked from within the terminal thread.
-    // most likely that's not the main thread, which will however write
-    // the actual input events.
-    // TODO: introduce new mutex to guard terminal writes.
+    // This is invoked from within the terminal thread, whereas the actual
+    // input events are written from the main thread. Both paths append
+    // through InputGenerator, which guards its pending-sequence buffer with
+    // its own mutex, so no additional synchronization is needed here.
     sendRaw(_reply);
 }
 
@@ -1009,6 +2084,26 @@ void Terminal::setBracketedPaste(bool _enabled)
     inputGenerator_.setBracketedPaste(_enabled);
 }
 
+void Terminal::setKeyboardEnhancements(unsigned _flags, unsigned _mode)
+{
+    inputGenerator_.setKeyboardEnhancements(_flags, _mode);
+}
+
+void Terminal::pushKeyboardEnhancements(unsigned _flags)
+{
+    inputGenerator_.pushKeyboardEnhancements(_flags);
+}
+
+void Terminal::popKeyboardEnhancements(unsigned _count)
+{
+    inputGenerator_.popKeyboardEnhancements(_count);
+}
+
+unsigned Terminal::keyboardEnhancements() const noexcept
+{
+    return inputGenerator_.keyboardEnhancements();
+}
+
 void Terminal::setCursorStyle(CursorDisplay _display, CursorShape _shape)
 {
     cursorDisplay_ = _display;
@@ -1091,14 +2186,15 @@ void Terminal::synchronizedOutput(bool _enabled)
     if (_enabled)
         return;
 
-    auto const diff = currentTime_ - renderBuffer_.lastUpdate;
-    if (diff < refreshInterval_)
-        return;
-
-    if (renderBuffer_.state == RenderBufferState::TrySwapBuffers)
-        return;
-
-    refreshRenderBuffer(true);
+    // End of a batch: the grid now holds a complete application frame. Do not
+    // compose synchronously here - TUI frameworks emit several batches per
+    // display interval, and composing each of them would render intermediate
+    // complete states nobody gets to see. Marking the screen dirty and waking
+    // the display lets the vsync-aligned pacing (refreshWindowOpen()) compose
+    // exactly one frame - the latest batch's state - per display interval,
+    // and guarantees that the final batch lands even if no further PTY
+    // output follows.
+    screenDirty_ = true;
     eventListener_.screenUpdated();
 }
 
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <terminal/InputGenerator.h>
+#include <terminal/Metrics.h>
 #include <terminal/RenderBuffer.h>
 #include <terminal/ScreenEvents.h>
 #include <terminal/Selector.h>
@@ -23,9 +24,11 @@
 
 #include <fmt/format.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <string_view>
@@ -38,6 +41,8 @@ namespace terminal
 template <typename EventListener>
 class Screen;
 
+class VTRecorder;
+
 /// Terminal API to manage input and output devices of a pseudo terminal, such as keyboard, mouse, and screen.
 ///
 /// With a terminal being attached to a Process, the terminal's screen
@@ -54,6 +59,13 @@ class Terminal
 
         virtual void requestCaptureBuffer(int /*_absoluteStartLine*/, int /*_lineCount*/) {}
         virtual void bell() {}
+
+        /// Invoked by flushInput() when input is pending. Returning true
+        /// defers the PTY write: the listener takes over the responsibility
+        /// to invoke flushInputNow() later (e.g. once at the end of the
+        /// current event-loop turn), so all input generated within one turn
+        /// is written in a single syscall.
+        virtual bool deferInputFlush() { return false; }
         virtual void bufferChanged(ScreenType) {}
         virtual void renderBufferUpdated() {}
         virtual void screenUpdated() {}
@@ -90,9 +102,31 @@ class Terminal
 
     void start();
 
+    /// Pins the VT thread onto the given set of CPU ids; Linux-only, no-op elsewhere.
+    ///
+    /// Must be called before start(). Besides avoiding cross-node thread
+    /// migration, pinning makes first-touch page placement work for the grid:
+    /// scrollback lines and recycled line buffers are allocated on the VT
+    /// thread, so their pages land on the pinned thread's NUMA node.
+    void setMainLoopCpuAffinity(std::vector<unsigned> _cpus) { mainLoopCpuAffinity_ = std::move(_cpus); }
+
     void resetHard();
 
     void setRefreshRate(double _refreshRate);
+
+    /// Sets the maximum number of PTY bytes parsed ahead of the most recently
+    /// composed frame before PTY consumption is paused (0 = unbounded).
+    void setParseAheadLimit(size_t _limit) noexcept { parseAheadLimit_ = _limit; }
+
+    /// Feeds back the timestamp at which the display handed the last frame
+    /// over for scanout (the frame-swap / vsync point), so render buffer
+    /// refreshes can be paced to complete just before the next vblank.
+    void markFrameSwapped(std::chrono::steady_clock::time_point _now) noexcept
+    {
+        lastFrameSwap_.store(_now.time_since_epoch().count(), std::memory_order_relaxed);
+        if (latencyProbesArmed_.load(std::memory_order_relaxed))
+            completeLatencyProbes(_now);
+    }
     void setLastMarkRangeOffset(LineOffset _value) noexcept;
 
     /// Retrieves the time point this terminal instance has been spawned.
@@ -108,6 +142,14 @@ class Terminal
     void setMouseProtocolBypassModifier(Modifier _value) { mouseProtocolBypassModifier_ = _value; }
     void setMouseBlockSelectionModifier(Modifier _value) { mouseBlockSelectionModifier_ = _value; }
 
+    /// Enables or disables local echo prediction.
+    ///
+    /// When enabled, plain printable keystrokes are rendered immediately in a
+    /// provisional (underlined) style and confirmed or dropped once the
+    /// application's real echo arrives, hiding the PTY round-trip latency on
+    /// slow (e.g. SSH) links.
+    void setEchoPrediction(bool _enabled);
+
     // {{{ input proxy
     using Timestamp = std::chrono::steady_clock::time_point;
     bool sendKeyPressEvent(Key _key, Modifier _modifier, Timestamp _now);
@@ -133,10 +175,18 @@ class Terminal
 
     bool applicationCursorKeys() const noexcept { return inputGenerator_.applicationCursorKeys(); }
     bool applicationKeypad() const noexcept { return inputGenerator_.applicationKeypad(); }
+    std::optional<MouseProtocol> mouseProtocol() const noexcept { return inputGenerator_.mouseProtocol(); }
 
     bool hasInput() const noexcept;
     size_t pendingInputBytes() const noexcept;
+
+    /// Flushes pending input to the PTY, unless the event listener defers
+    /// the write to batch this event-loop turn's input (see
+    /// Events::deferInputFlush()).
     void flushInput();
+
+    /// Flushes pending input to the PTY unconditionally.
+    void flushInputNow();
     // }}}
 
     /// Writes a given VT-sequence to screen.
@@ -146,6 +196,26 @@ class Terminal
     Viewport<Terminal>& viewport() noexcept { return viewport_; }
     Viewport<Terminal> const& viewport() const noexcept { return viewport_; }
 
+    // {{{ multi-viewport support (split panes)
+    /// Creates an additional viewport onto this terminal.
+    ///
+    /// Additional viewports share the grid, screen state and the PTY with the
+    /// main viewport; only the scroll position is per-viewport, so split
+    /// panes can show different scrollback positions of one session without
+    /// running a second terminal. The returned viewport is owned by this
+    /// Terminal and stays valid for the Terminal's lifetime.
+    Viewport<Terminal>& createViewport();
+
+    /// Composes a full frame of the screen as seen through @p _viewport into
+    /// @p _output (acquires the terminal lock).
+    ///
+    /// Unlike refreshRenderBuffer(), this neither consumes the dirty state
+    /// nor touches the main viewport's damage-tracking baseline, so the
+    /// triple-buffered main frame pipeline is unaffected; damage tracking for
+    /// additional viewports is left to the caller via RenderBuffer::frameID.
+    void renderViewport(Viewport<Terminal> const& _viewport, RenderBuffer& _output);
+    // }}}
+
     // {{{ Screen Render Proxy
     std::optional<std::chrono::milliseconds> nextRender() const;
 
@@ -198,28 +268,118 @@ class Terminal
     /// @see renderBuffer()
     bool ensureFreshRenderBuffer(bool _locked = false);
 
-    /// Aquuires read-access handle to front render buffer.
+    /// Acquires read-access handle to the front render buffer.
     ///
-    /// This also acquires the reader lock and releases it automatically
-    /// upon RenderBufferRef destruction.
+    /// Wait-free; picks up the most recently published frame, if any.
+    /// May only be called from the render (reader) thread.
     ///
     /// @see ensureFreshRenderBuffer()
     /// @see refreshRenderBuffer()
-    RenderBufferRef renderBuffer() const { return renderBuffer_.frontBuffer(); }
+    RenderBufferRef renderBuffer() const
+    {
+        // The fetch timestamp orders frame publication against frame
+        // presentation for the latency probe machinery; see
+        // completeLatencyProbes().
+        if (latencyProbesArmed_.load(std::memory_order_relaxed))
+            lastFrontBufferFetch_.store(std::chrono::steady_clock::now().time_since_epoch().count(),
+                                        std::memory_order_relaxed);
+        return renderBuffer_.frontBuffer();
+    }
 
     RenderBufferState renderBufferState() const noexcept { return renderBuffer_.state; }
     // }}}
 
+    // {{{ viewport snapshot
+    /// Screen-geometry facts the GUI thread needs without taking the terminal
+    /// lock. Scrollbar range math and coordinate translation only require the
+    /// page size and the scrollback depth - not cell contents - so those are
+    /// published separately from the render buffer frames.
+    struct ViewportSnapshot
+    {
+        PageSize pageSize {};
+        LineCount historyLineCount {};
+    };
+
+    /// Returns the most recently published viewport snapshot.
+    ///
+    /// Wait-free with respect to the VT thread: reads retry only while an
+    /// update is in flight, which is a handful of word stores.
+    ///
+    /// @see publishViewportSnapshot()
+    ViewportSnapshot viewportSnapshot() const noexcept
+    {
+        for (;;)
+        {
+            auto const seq = viewportSnapshotSeq_.load(std::memory_order_acquire);
+            if (seq & 1)
+                continue;
+            auto const copy = viewportSnapshotData_;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (viewportSnapshotSeq_.load(std::memory_order_relaxed) == seq)
+                return copy;
+        }
+    }
+    // }}}
+
+    // {{{ accessibility text feed
+    /// One display line whose text content changed since the previous
+    /// fetchLineTextDeltas() call.
+    struct LineTextDelta
+    {
+        LineOffset line {};  //!< display line, top of the viewport being line 0
+        std::string text {}; //!< the line's full text, blank-padded to page width
+    };
+
+    /// Returns the text of every display line whose content changed since the
+    /// previous call (acquires the terminal lock).
+    ///
+    /// Driven by the same per-line modification generations the render damage
+    /// tracking uses, against a baseline of its own: unchanged lines cost one
+    /// pointer/generation compare each and no text is extracted for them, so
+    /// feeding a consumer stays cheap even during heavy output. The first
+    /// call, a page resize and a scroll position change report all lines
+    /// once. Intended for consumers mirroring screen content incrementally,
+    /// such as a screen-reader bridge; with no consumer calling, no state is
+    /// maintained at all.
+    std::vector<LineTextDelta> fetchLineTextDeltas();
+    // }}}
+
+    // {{{ end-to-end latency probing
+    /// Injects a timestamped private-use probe sequence into the PTY.
+    ///
+    /// The probe (`APC contour-latency;<id> ST`) is expected to be echoed
+    /// back verbatim by the application - `cat` in production, the test PTY's
+    /// stdout buffer in CI. The echo's arrival marks the probe reflected; the
+    /// sample completes with the frame-swap timestamp of the frame composed
+    /// after reflection (see markFrameSwapped()), measuring the full
+    /// input-to-present path: PTY write, application echo, parsing, render
+    /// buffer composition and display presentation.
+    ///
+    /// @returns the probe's id.
+    uint64_t injectLatencyProbe(std::chrono::steady_clock::time_point _now);
+
+    /// Marks the given probe's echo as received (VT thread, via APC dispatch).
+    void latencyProbeReflected(uint64_t _id);
+
+    /// Returns a copy of all completed latency samples collected so far.
+    LatencyStatistics latencyStatistics() const;
+    // }}}
+
+    /// Locks the terminal's screen state for exclusive access.
+    ///
+    /// The outer lock is only a gate serializing the entry: it is dropped
+    /// again once the inner (data) lock is held. This keeps the VT thread,
+    /// which cycles the lock between parse chunks in writeToScreen(), from
+    /// starving UI-thread readers during a large output burst - any thread
+    /// already queued at the gate is admitted before the writer continues
+    /// with its next chunk.
     void lock() const
     {
         outerLock_.lock();
         innerLock_.lock();
-    }
-    void unlock() const
-    {
         outerLock_.unlock();
-        innerLock_.unlock();
     }
+    void unlock() const { innerLock_.unlock(); }
 
     /// Only access this when having the terminal object locked.
     Screen<Terminal> const& screen() const noexcept { return screen_; }
@@ -303,7 +463,63 @@ class Terminal
     bool selectionAvailable() const noexcept { return !!selection_; }
     // }}}
 
+    // {{{ overlay spans
+    /// Replaces the current set of decorative overlay spans (search
+    /// highlights, IME preedit, URL hover). The spans are resolved at
+    /// render-buffer compose time and never touch any grid cell, so changing
+    /// them only re-emits the covered display rows.
+    ///
+    /// Must be invoked with the terminal object locked.
+    void setOverlaySpans(std::vector<OverlaySpan> _spans);
+
+    /// Removes all overlay spans. Must be invoked with the terminal object locked.
+    void clearOverlaySpans();
+
+    std::vector<OverlaySpan> const& overlaySpans() const noexcept { return overlaySpans_; }
+    // }}}
+
+    // {{{ session statistics
+    /// The most recent once-per-second statistics sample (PTY ingest rate,
+    /// frame compose rate, grid memory, renderer cache hit rates), formatted
+    /// as one line of text. Also the reply payload of the XTGETTCAP
+    /// "contour-session-stats" query.
+    ///
+    /// Must be accessed with the terminal object locked.
+    std::string const& statisticsLine() const noexcept { return statisticsLine_; }
+
+    /// Enables/disables the statistics line as an overlay span in the top
+    /// right corner of the viewport.
+    void setStatisticsOverlayEnabled(bool _enabled);
+    bool statisticsOverlayEnabled() const noexcept
+    {
+        return statisticsOverlayEnabled_.load(std::memory_order_relaxed);
+    }
+
+    /// Cache hit/miss counters the renderer accumulated since its previous
+    /// report (see reportRenderCacheStats()).
+    struct RenderCacheStats
+    {
+        uint32_t shapingCacheHits = 0;
+        uint32_t shapingCacheMisses = 0;
+        uint32_t atlasTileHits = 0;
+        uint32_t atlasTileMisses = 0;
+    };
+
+    /// Feeds renderer-side cache counters into the current statistics
+    /// sampling window. Invoked by the render thread; acquires the lock.
+    void reportRenderCacheStats(RenderCacheStats const& _stats);
+    // }}}
+
+    /// Streams the currently selected text into @p _sink in bounded-size
+    /// chunks, so arbitrarily large selections (e.g. the entire scrollback)
+    /// never materialize as one string. Chunks split at line boundaries only;
+    /// the sink is invoked with the terminal object locked.
+    void extractSelectionText(std::function<void(std::string_view)> const& _sink) const;
+
+    /// Convenience overload accumulating the selected text into one string,
+    /// for sinks (like the clipboard) that need it contiguous anyway.
     std::string extractSelectionText() const;
+
     std::string extractLastMarkRange() const;
 
     /// Tests whether or not the mouse is currently hovering a hyperlink.
@@ -311,6 +527,20 @@ class Terminal
 
     bool processInputOnce();
 
+    /// Externally driven alternative to start()/mainLoop(): performs one
+    /// non-blocking PTY read plus screen update, never waiting for data.
+    ///
+    /// Intended for embedders multiplexing many sessions over few threads
+    /// (e.g. PtyMultiplexer readiness callbacks dispatched onto a worker
+    /// pool): instead of each Terminal owning a thread that blocks in
+    /// read(), the driver calls this whenever the PTY signals readability.
+    /// At most one thread may drive a given Terminal at a time.
+    ///
+    /// Invokes Events::onClosed() and returns false once the session
+    /// terminated; returns true while the session stays alive (including
+    /// when no data was pending).
+    bool processAvailableInput();
+
     void markScreenDirty() { screenDirty_ = true; }
     bool screenDirty() const noexcept { return screenDirty_; }
 
@@ -340,6 +570,10 @@ class Terminal
     void resizeWindow(ImageSize);
     void setApplicationkeypadMode(bool _enabled);
     void setBracketedPaste(bool _enabled);
+    void setKeyboardEnhancements(unsigned _flags, unsigned _mode);
+    void pushKeyboardEnhancements(unsigned _flags);
+    void popKeyboardEnhancements(unsigned _count);
+    unsigned keyboardEnhancements() const noexcept;
     void setCursorStyle(CursorDisplay _display, CursorShape _shape);
     void setCursorVisibility(bool _visible);
     void setGenerateFocusEvents(bool _enabled);
@@ -358,6 +592,14 @@ class Terminal
 
     void setMaxImageColorRegisters(unsigned value) noexcept { state_.maxImageColorRegisters = value; }
 
+    /// Enables/disables compact-form demotion of lines entering the scrollback
+    /// (see Grid::compressNewHistoryLines()).
+    void setHistoryCompression(bool _enabled) noexcept
+    {
+        for (auto& grid: state_.grids)
+            grid.setHistoryCompression(_enabled);
+    }
+
     void verifyState();
 
     TerminalState<Terminal>& state() noexcept { return state_; }
@@ -365,11 +607,49 @@ class Terminal
 
   private:
     void mainLoop();
+
+    /// Reads once from the PTY with the given timeout and feeds the result
+    /// into the screen; shared tail of processInputOnce() and
+    /// processAvailableInput(). Returns false on a fatal PTY error.
+    bool processPtyRead(std::chrono::milliseconds _timeout);
+
     void refreshRenderBuffer(RenderBuffer& _output); // <- acquires the lock
-    void refreshRenderBufferInternal(RenderBuffer& _output);
-    std::optional<RenderCursor> renderCursor();
+    void refreshRenderBufferInternal(RenderBuffer& _output, Viewport<Terminal> const& _viewport);
+
+    /// Advances the statistics sampling window and maintains the statistics
+    /// overlay span; invoked once per composed frame (under the lock).
+    void updateStatisticsOverlay();
+    std::optional<RenderCursor> renderCursor(Viewport<Terminal> const& _viewport);
     void updateCursorVisibilityState() const;
     bool updateCursorHoveringState();
+    void predictEcho(char32_t _value, Modifier _modifier, Timestamp _now);
+    void reconcileEchoPredictions();
+
+    /// Writes as much of a queued paste as the PTY currently accepts,
+    /// one bounded chunk at a time.
+    ///
+    /// @retval true  paste data is still pending (the PTY applied backpressure).
+    /// @retval false the paste queue is fully drained.
+    bool flushPendingPaste();
+
+    // {{{ vsync-aligned refresh pacing
+    std::chrono::steady_clock::time_point lastFrameSwap() const noexcept;
+
+    /// Tells whether the current time falls into the window in which the
+    /// render buffer should be composed for the upcoming vblank.
+    bool refreshWindowOpen() const noexcept;
+
+    /// Time to sleep until the next refresh window opens (0 if open).
+    std::chrono::milliseconds timeUntilRefreshWindow() const noexcept;
+
+    /// Returns the refresh interval currently in effect, which may be longer
+    /// than the configured one while an output storm is being ingested.
+    std::chrono::milliseconds effectiveRefreshInterval() const noexcept;
+
+    /// Accounts PTY ingest volume and toggles the output-storm governor
+    /// (see effectiveRefreshInterval()).
+    void updateIngestStatistics(size_t _bytesRead);
+    // }}}
 
     template <typename Renderer, typename... RemainingPasses>
     void renderPass(Renderer&& pass, RemainingPasses... remainingPasses) const
@@ -391,11 +671,110 @@ class Terminal
     Events& eventListener_;
 
     std::chrono::milliseconds refreshInterval_;
+
+    // {{{ output-storm governor state
+    // Window accounting is touched by the VT thread only; the resulting flag
+    // is read lock-free by whoever paces the next refresh.
+    std::chrono::steady_clock::time_point ingestWindowStart_ {};
+    size_t ingestWindowBytes_ = 0;
+    std::atomic<bool> outputStormActive_ = false;
+    // }}}
+
+    // {{{ PTY parse-ahead budget (see processInputOnce())
+    // Bytes parsed into screen state but not yet part of a composed frame.
+    // Written under the terminal lock, read lock-free for pacing decisions.
+    std::atomic<size_t> pendingRenderBytes_ = 0;
+    size_t parseAheadLimit_ = 1024 * 1024;
+    std::chrono::steady_clock::time_point parseAheadPausedSince_ {};
+    // }}}
+
+    /// Timestamp of the most recent frame swap (vsync), fed back by the
+    /// display via markFrameSwapped(). Stored as raw clock ticks to keep
+    /// the cross-thread hand-over lock-free.
+    std::atomic<std::chrono::steady_clock::rep> lastFrameSwap_ = 0;
+
     bool screenDirty_ = false;
     RenderDoubleBuffer renderBuffer_ {};
 
+    // {{{ Damage tracking state for render buffer refreshes.
+    //
+    // Remembers, per display row, which Line object (at which modification
+    // generation) the most recently composed frame was built from, so that
+    // a refresh only re-emits damaged rows and re-uses the clean ones.
+    struct RenderedLine
+    {
+        void const* line = nullptr;
+        uint64_t generation = 0;
+        uint64_t contentHash = 0;
+    };
+    std::vector<RenderedLine> renderedLines_ {};
+    std::vector<bool> dirtyRenderLines_ {};
+    std::vector<RenderCell> renderCellScratch_ {};
+    ScrollOffset renderedScrollOffset_ {};
+    bool renderedReverseVideo_ = false;
+    std::array<LineOffset, 2> renderedCursorLines_ {};
+    ColorPalette renderedColorPalette_ {};
+    bool renderDamageValid_ = false;
+    std::vector<bool> bypassedRenderLinesScratch_ {}; //!< rows emitted as RenderLine this frame
+    std::vector<bool> renderedBypassedLines_ {};      //!< ... and in the last composed frame
+    // }}}
+
+    // {{{ accessibility text feed state (see fetchLineTextDeltas())
+    std::vector<RenderedLine> accessibleLines_ {};
+    ScrollOffset accessibleScrollOffset_ {};
+    // }}}
+
+    // {{{ end-to-end latency probing state (see injectLatencyProbe())
+    /// A probe advances injected -> reflected (echo parsed on the VT thread)
+    /// -> published (a composed frame was swapped to front) and completes at
+    /// the first frame-swap whose frame was fetched after publication.
+    struct PendingLatencyProbe
+    {
+        uint64_t id = 0;
+        std::chrono::steady_clock::time_point injectedAt {};
+        bool reflected = false;
+        std::chrono::steady_clock::time_point publishedAt {};
+    };
+    void publishLatencyProbes(std::chrono::steady_clock::time_point _now);
+    void completeLatencyProbes(std::chrono::steady_clock::time_point _now);
+    mutable std::mutex latencyProbesMutex_;
+    std::vector<PendingLatencyProbe> pendingLatencyProbes_ {};
+    LatencyStatistics latencyStatistics_ {};
+    uint64_t nextLatencyProbeId_ = 0;
+    /// Cheap per-frame gate: all probe bookkeeping outside inject/reflect is
+    /// skipped entirely while no probe is pending.
+    std::atomic<bool> latencyProbesArmed_ = false;
+    std::atomic<std::chrono::steady_clock::duration::rep> mutable lastFrontBufferFetch_ = 0;
+    // }}}
+
+    // {{{ overlay spans (resolved at render-buffer compose time)
+    std::vector<OverlaySpan> overlaySpans_ {};
+    uint64_t overlayGeneration_ = 0;
+    uint64_t renderedOverlayGeneration_ = 0;
+    std::vector<size_t> renderedOverlayRows_ {}; //!< display rows covered in the last composed frame
+    std::vector<std::vector<OverlaySpan const*>> overlayRowsScratch_ {};
+    // }}}
+
+    // {{{ session statistics (see statisticsLine())
+    // Sampled on the VT thread at compose time from counters maintained
+    // anyway; only the enable flag is read lock-free by the render thread.
+    std::atomic<bool> statisticsOverlayEnabled_ = false;
+    uint64_t totalIngestedBytes_ = 0;
+    uint64_t composedFrameCount_ = 0;
+    std::chrono::steady_clock::time_point statsWindowStart_ {};
+    uint64_t statsWindowIngestBase_ = 0;
+    uint64_t statsWindowFrameBase_ = 0;
+    RenderCacheStats statsWindowCacheStats_ {};
+    std::string statisticsLine_ {};
+    std::vector<OverlaySpan> statsOverlaySpans_ {};
+    // }}}
+
     Pty& pty_;
 
+    // Optional raw PTY stream recording for post-mortem debugging and
+    // benchmark replays; enabled via $CONTOUR_RECORD_PTY.
+    std::unique_ptr<VTRecorder> recorder_;
+
     std::chrono::steady_clock::time_point startTime_;
     std::chrono::steady_clock::time_point currentTime_;
 
@@ -420,13 +799,52 @@ class Terminal
     InputGenerator inputGenerator_;
     LineOffset copyLastMarkRangeOffset_;
 
+    // {{{ local echo prediction state
+    //
+    // Keystrokes predicted into the grid ahead of the application's echo,
+    // in typing order. Positions are real grid coordinates. Guarded by the
+    // terminal lock (mutated by the input and screen-update threads).
+    struct EchoPrediction
+    {
+        CellLocation position;
+        char32_t codepoint;
+        std::chrono::steady_clock::time_point createdAt;
+    };
+    bool echoPredictionEnabled_ = false;
+    std::vector<EchoPrediction> echoPredictions_ {};
+    // }}}
+
+    // {{{ asynchronous paste state
+    //
+    // Large pastes are staged here (already framed with bracketed-paste
+    // markers) and drained chunk-wise from the main loop, each chunk gated
+    // on the PTY becoming writable, so the pasting (GUI) thread returns
+    // immediately instead of blocking on a full PTY input pipe.
+    // Guarded by the input generator's lock.
+    std::string pendingPaste_ {};
+    size_t pendingPasteOffset_ = 0;
+    // }}}
+
     TerminalState<Terminal> state_;
     Screen<Terminal> screen_;
 
-    std::mutex mutable outerLock_;
-    std::mutex mutable innerLock_;
+    std::mutex mutable outerLock_; //!< entry gate; never held while waiting on work (see lock())
+    std::mutex mutable innerLock_; //!< guards screen/grid state; this is what lock() leaves held
+
+    // {{{ viewport snapshot state
+    //
+    // Seqlock-published copy of the screen geometry (see viewportSnapshot()).
+    // Writers all hold the terminal lock already, which serializes them; the
+    // odd/even sequence word only shields the lock-free readers.
+    std::atomic<uint64_t> mutable viewportSnapshotSeq_ = 0;
+    ViewportSnapshot viewportSnapshotData_ {};
+    void publishViewportSnapshot() noexcept;
+    // }}}
     std::unique_ptr<std::thread> screenUpdateThread_;
+    std::vector<unsigned> mainLoopCpuAffinity_ {};
     Viewport<Terminal> viewport_;
+    // Additional viewports (split panes); std::list for reference stability.
+    std::list<Viewport<Terminal>> extraViewports_;
     std::unique_ptr<Selection> selection_;
     std::atomic<bool> hoveringHyperlink_ = false;
     std::atomic<bool> renderBufferUpdateEnabled_ = true;
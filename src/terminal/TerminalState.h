@@ -486,6 +486,13 @@ struct TerminalState
     ColumnCount tabWidth { 8 };
     std::vector<ColumnOffset> tabs;
 
+    /// Column -> next configured tab stop lookup (entry -1: none to the right),
+    /// derived from `tabs` and the page width. Rebuilt lazily after HTS/TBC
+    /// or resize (see Screen::nextTabStop()), so that TSV-heavy output pays
+    /// O(1) per TAB instead of re-scanning the stop list.
+    std::vector<ColumnOffset> nextTabStopCache;
+    bool nextTabStopCacheDirty = true;
+
     bool allowReflowOnResize;
 
     ScreenType screenType = ScreenType::Main;
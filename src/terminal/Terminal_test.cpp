@@ -23,6 +23,7 @@
 #include <algorithm>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -34,17 +35,19 @@ using terminal::PageSize;
 
 namespace
 {
-/// Takes a textual screenshot using the terminals render buffer.
-vector<string> textScreenshot(terminal::Terminal const& _terminal)
+/// Takes a textual screenshot of an already composed render buffer.
+vector<string> textScreenshot(terminal::RenderBuffer const& _buffer, PageSize _pageSize)
 {
-    terminal::RenderBufferRef renderBuffer = _terminal.renderBuffer();
-
     vector<string> lines;
-    lines.resize(_terminal.pageSize().lines.as<size_t>());
+    lines.resize(_pageSize.lines.as<size_t>());
+
+    // Rows drawn via the trivial-line bypass carry their text as a whole.
+    for (terminal::RenderLine const& line: _buffer.lines)
+        lines.at(unbox<size_t>(line.lineOffset)) = line.text;
 
     terminal::CellLocation lastPos = {};
     size_t lastCount = 0;
-    for (terminal::RenderCell const& cell: renderBuffer.buffer.screen)
+    for (terminal::RenderCell const& cell: _buffer.screen)
     {
         auto const gap = (cell.position.column + static_cast<int>(lastCount) - 1) - lastPos.column;
         auto& currentLine = lines.at(*cell.position.line);
@@ -59,6 +62,12 @@ vector<string> textScreenshot(terminal::Terminal const& _terminal)
     return lines;
 }
 
+/// Takes a textual screenshot using the terminal's front render buffer.
+vector<string> textScreenshot(terminal::Terminal const& _terminal)
+{
+    return textScreenshot(_terminal.renderBuffer().buffer, _terminal.pageSize());
+}
+
 string join(vector<string> const& _lines)
 {
     string output;
@@ -130,6 +139,24 @@ std::string trimmedTextScreenshot(MockTerm const& _mt)
 {
     return trimRight(join(textScreenshot(_mt.terminal())));
 }
+
+struct TestSelectionHelper: public terminal::SelectionHelper
+{
+    terminal::Terminal* term;
+    explicit TestSelectionHelper(terminal::Terminal& _term): term { &_term } {}
+
+    PageSize pageSize() const noexcept override { return term->pageSize(); }
+    bool wordDelimited(terminal::CellLocation /*_pos*/) const noexcept override { return true; }
+    bool wrappedLine(LineOffset _line) const noexcept override { return term->isLineWrapped(_line); }
+    bool cellEmpty(terminal::CellLocation _pos) const noexcept override
+    {
+        return term->screen().at(_pos).empty();
+    }
+    int cellWidth(terminal::CellLocation _pos) const noexcept override
+    {
+        return term->screen().at(_pos).width();
+    }
+};
 } // namespace
 
 // TODO: Test case posibilities:
@@ -138,7 +165,7 @@ std::string trimmedTextScreenshot(MockTerm const& _mt)
 // - [x] Blinking cursor visiblity over time and on input events
 // - [ ] double click word selection
 // - [ ] tripple click line selection
-// - [ ] rectangular block selection
+// - [x] rectangular block selection
 // - [ ] text selection with bypassing enabled application mouse protocol
 // - [ ] extractLastMarkRange
 // - [ ] scroll mark up
@@ -189,6 +216,103 @@ TEST_CASE("Terminal.BlinkingCursor", "[terminal]")
     }
 }
 
+TEST_CASE("Terminal.OverlaySpans", "[terminal]")
+{
+    auto const now = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(10), LineCount(2) };
+    mc.writeToStdout("Hello");
+    mc.terminal().tick(now);
+    mc.terminal().ensureFreshRenderBuffer();
+
+    auto span = terminal::OverlaySpan {};
+    span.line = mc.terminal().screen().grid().absoluteLineNumber(LineOffset(0));
+    span.beginColumn = terminal::ColumnOffset(1);
+    span.endColumn = terminal::ColumnOffset(3);
+    span.styles = terminal::CellFlags::Underline;
+    span.backgroundColor = terminal::RGBColor { 0xFF, 0xFF, 0x00 };
+    mc.terminal().setOverlaySpans({ span });
+
+    mc.terminal().tick(now + chrono::milliseconds(100));
+    mc.terminal().ensureFreshRenderBuffer();
+
+    auto covered = 0;
+    for (terminal::RenderCell const& cell: mc.terminal().renderBuffer().buffer.screen)
+    {
+        if (cell.position.line != LineOffset(0) || cell.position.column < span.beginColumn
+            || !(cell.position.column < span.endColumn))
+            continue;
+        ++covered;
+        CHECK(cell.backgroundColor == *span.backgroundColor);
+        CHECK(cell.flags & terminal::CellFlags::Underline);
+    }
+    CHECK(covered == 2);
+
+    // Overlays are resolved at compose time only; the grid cells stay untouched.
+    CHECK_FALSE(mc.terminal().screen().grid().at(LineOffset(0), terminal::ColumnOffset(1)).styles()
+                & terminal::CellFlags::Underline);
+}
+
+TEST_CASE("Terminal.OverlaySpanText", "[terminal]")
+{
+    auto const now = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(10), LineCount(2) };
+    mc.writeToStdout("Hello");
+    mc.terminal().tick(now);
+    mc.terminal().ensureFreshRenderBuffer();
+
+    auto span = terminal::OverlaySpan {};
+    span.line = mc.terminal().screen().grid().absoluteLineNumber(LineOffset(0));
+    span.beginColumn = terminal::ColumnOffset(0);
+    span.endColumn = terminal::ColumnOffset(3);
+    span.text = U"abc";
+    mc.terminal().setOverlaySpans({ span });
+
+    mc.terminal().tick(now + chrono::milliseconds(100));
+    mc.terminal().ensureFreshRenderBuffer();
+
+    auto text = std::u32string {};
+    for (terminal::RenderCell const& cell: mc.terminal().renderBuffer().buffer.screen)
+        if (cell.position.line == LineOffset(0) && cell.position.column < span.endColumn
+            && !cell.codepoints.empty())
+            text += cell.codepoints[0];
+    CHECK(text == U"abc");
+
+    // The replacement text only exists in the composed frame.
+    CHECK(mc.terminal().screen().grid().at(LineOffset(0), terminal::ColumnOffset(0)).codepoint(0) == U'H');
+}
+
+TEST_CASE("Terminal.SessionStatistics", "[terminal]")
+{
+    auto const now = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(20), LineCount(2) };
+    mc.writeToStdout("Hello");
+    mc.terminal().tick(now);
+    mc.terminal().ensureFreshRenderBuffer();
+    CHECK(mc.terminal().statisticsLine().empty());
+
+    // The second compose after a full sampling window produces a sample.
+    mc.terminal().tick(now + chrono::milliseconds(1500));
+    mc.terminal().markScreenDirty();
+    mc.terminal().ensureFreshRenderBuffer();
+    CHECK_FALSE(mc.terminal().statisticsLine().empty());
+}
+
+TEST_CASE("Terminal.RectangularSelectionText", "[terminal]")
+{
+    auto mc = MockTerm { ColumnCount(11), LineCount(3) };
+    mc.writeToStdout("12345,67890\r\n"
+                     "ab,cdefg,hi\r\n"
+                     "ABCDE,FGHIJ");
+
+    auto selectionHelper = TestSelectionHelper { mc.terminal() };
+    mc.terminal().setSelector(make_unique<terminal::RectangularSelection>(
+        selectionHelper, terminal::CellLocation { LineOffset(0), terminal::ColumnOffset(2) }));
+    mc.terminal().selector()->extend(terminal::CellLocation { LineOffset(2), terminal::ColumnOffset(5) });
+    mc.terminal().selector()->complete();
+
+    CHECK(mc.terminal().extractSelectionText() == "345,\n,cde\nCDE,");
+}
+
 TEST_CASE("Terminal.SynchronizedOutput", "[terminal]")
 {
     constexpr auto BatchOn = "\033[?2026h"sv;
@@ -213,3 +337,152 @@ TEST_CASE("Terminal.SynchronizedOutput", "[terminal]")
     mc.terminal().ensureFreshRenderBuffer();
     CHECK("Hello  World" == trimmedTextScreenshot(mc));
 }
+
+TEST_CASE("Terminal.SynchronizedOutputCoalescing", "[terminal]")
+{
+    constexpr auto BatchOn = "\033[?2026h"sv;
+    constexpr auto BatchOff = "\033[?2026l"sv;
+
+    auto const now = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(20), LineCount(1) };
+    mc.terminal().tick(now);
+
+    // Multiple complete batches arriving within one display interval must
+    // yield exactly one composed frame, carrying the latest batch's state.
+    auto const framesBefore = mc.terminal().lastFrameID();
+    mc.writeToStdout(BatchOn);
+    mc.writeToStdout("One");
+    mc.writeToStdout(BatchOff);
+    mc.writeToStdout(BatchOn);
+    mc.writeToStdout("\rTwo");
+    mc.writeToStdout(BatchOff);
+
+    mc.terminal().tick(now + chrono::milliseconds(100));
+    mc.terminal().ensureFreshRenderBuffer();
+    CHECK("Two" == trimmedTextScreenshot(mc));
+    CHECK(mc.terminal().lastFrameID() == framesBefore + 1);
+}
+
+TEST_CASE("Terminal.MultiViewport", "[terminal]")
+{
+    auto const now = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(5), LineCount(2) };
+    mc.writeToStdout("one\r\ntwo\r\nthree\r\nfour");
+    mc.terminal().tick(now);
+    mc.terminal().ensureFreshRenderBuffer();
+    REQUIRE("three\nfour" == trimmedTextScreenshot(mc));
+
+    // An additional viewport shares the grid but scrolls independently.
+    auto& pane = mc.terminal().createViewport();
+    REQUIRE(pane.scrollUp(LineCount(2)));
+    REQUIRE(!mc.terminal().viewport().scrolled());
+
+    auto paneBuffer = terminal::RenderBuffer {};
+    mc.terminal().renderViewport(pane, paneBuffer);
+    CHECK("one\ntwo" == trimRight(join(textScreenshot(paneBuffer, mc.terminal().pageSize()))));
+
+    // The main frame pipeline is unaffected by the pane's compose: the next
+    // refresh still shows the live bottom of the same session.
+    mc.writeToStdout("\r\nfive");
+    mc.terminal().tick(now + chrono::milliseconds(100));
+    mc.terminal().ensureFreshRenderBuffer();
+    CHECK("four\nfive" == trimmedTextScreenshot(mc));
+
+    mc.terminal().renderViewport(pane, paneBuffer);
+    CHECK("two\nthree" == trimRight(join(textScreenshot(paneBuffer, mc.terminal().pageSize()))));
+}
+
+TEST_CASE("Terminal.TrivialLineBypass", "[terminal]")
+{
+    auto const now = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(10), LineCount(3) };
+    mc.writeToStdout("plain\r\n\033[1mbold\033[m\r\ncursor");
+    mc.terminal().tick(now);
+    mc.terminal().ensureFreshRenderBuffer();
+
+    auto const& buffer = mc.terminal().renderBuffer().buffer;
+
+    // The plain row is emitted as a whole RenderLine ...
+    REQUIRE(buffer.lines.size() == 1);
+    CHECK(buffer.lines.front().text == "plain");
+    CHECK(buffer.lines.front().lineOffset == LineOffset(0));
+
+    // ... without its grid line ever being inflated into cells.
+    CHECK(mc.terminal().screen().grid().lineAt(LineOffset(0)).isTrivialBuffer());
+
+    // Styled rows and the cursor's row keep taking the per-cell path.
+    for (terminal::RenderCell const& cell: buffer.screen)
+        CHECK(cell.position.line != LineOffset(0));
+
+    CHECK("plain\nbold\ncursor" == trimmedTextScreenshot(mc));
+}
+
+TEST_CASE("Terminal.LineTextDeltas", "[terminal]")
+{
+    auto mc = MockTerm { ColumnCount(5), LineCount(2) };
+
+    // The first call reports every line once.
+    auto deltas = mc.terminal().fetchLineTextDeltas();
+    REQUIRE(deltas.size() == 2);
+    CHECK(deltas[0].line == LineOffset(0));
+    CHECK(deltas[1].line == LineOffset(1));
+
+    // Nothing changed since: nothing is reported.
+    CHECK(mc.terminal().fetchLineTextDeltas().empty());
+
+    // A single-line change reports exactly that line, blank-padded to page width.
+    mc.writeToStdout("hi");
+    deltas = mc.terminal().fetchLineTextDeltas();
+    REQUIRE(deltas.size() == 1);
+    CHECK(deltas[0].line == LineOffset(0));
+    CHECK(deltas[0].text == "hi   ");
+}
+
+TEST_CASE("Terminal.IdenticalRewriteDamageSuppression", "[terminal]")
+{
+    auto const now = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(10), LineCount(3) };
+    mc.writeToStdout("prompt\033[3;1H");
+    mc.terminal().tick(now);
+    mc.terminal().ensureFreshRenderBuffer();
+
+    // Rewrite the first line with identical content (CR + EL + same text),
+    // the way prompt-redrawing shells do on every keystroke.
+    mc.writeToStdout("\033[1;1H\033[Kprompt\033[3;1H");
+    mc.terminal().tick(now + chrono::seconds(1));
+    mc.terminal().ensureFreshRenderBuffer();
+
+    auto const& buffer = mc.terminal().renderBuffer().buffer;
+    REQUIRE(buffer.damagedLineRange.has_value());
+    // Only the cursor's row is re-emitted; the rewritten-but-identical first
+    // line stays out of the damage set.
+    CHECK(buffer.damagedLineRange->first == LineOffset(2));
+}
+
+TEST_CASE("Terminal.LatencyProbe", "[terminal]")
+{
+    auto const t0 = chrono::steady_clock::now();
+    auto mc = MockTerm { ColumnCount(20), LineCount(2) };
+
+    auto const probeId = mc.terminal().injectLatencyProbe(t0);
+    CHECK(probeId == 1);
+
+    // The probe went out through the PTY; reflect it the way `cat` (or a
+    // test harness) would echo it.
+    auto const echoed = mc.pty().stdinBuffer();
+    REQUIRE(echoed == "\033_contour-latency;1\033\\");
+    mc.pty().stdinBuffer().clear();
+    mc.writeToStdout(echoed);
+
+    mc.terminal().tick(t0);
+    mc.terminal().ensureFreshRenderBuffer();
+    CHECK(trimmedTextScreenshot(mc).empty()); // the probe never shows on screen
+
+    // The renderer fetches the frame carrying the echo and presents it.
+    (void) mc.terminal().renderBuffer();
+    mc.terminal().markFrameSwapped(t0 + chrono::milliseconds(25));
+
+    auto const stats = mc.terminal().latencyStatistics();
+    REQUIRE(stats.count() == 1);
+    CHECK(stats.percentile(50.0) == chrono::milliseconds(25));
+}
@@ -0,0 +1,57 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <terminal/WidthTable.h> // generated by width_table_generator
+
+#include <crispy/LRUCache.h>
+
+#include <unicode/grapheme_segmenter.h>
+
+#include <cstdint>
+
+// Cached frontends to the libunicode property lookups on the per-codepoint
+// write path. Every printed codepoint needs its display width and (for
+// non-ASCII) a grapheme cluster break decision; resolving those through the
+// generic property tables costs a handful of binary-search rounds each, which
+// dominates emoji-heavy output.
+//
+// Codepoint widths are served from a build-time generated two-stage table
+// (two dependent loads into ~15 KiB of read-only data, see WidthTable.h);
+// non-trivial break pairs go through a small per-thread LRU cache, which
+// emoji sequences (few distinct clusters, repeated often) hit nearly always.
+
+namespace terminal
+{
+
+/// Table-driven equivalent of unicode::width(), covering all planes.
+constexpr uint8_t codepointWidth(char32_t _codepoint) noexcept
+{
+    return width_table::width(_codepoint);
+}
+
+/// Cached equivalent of unicode::grapheme_segmenter::breakable().
+///
+/// Callers are expected to have short-circuited the all-ASCII case already
+/// (as the write path does); this only memoizes the expensive pairs.
+inline bool graphemeBreakable(char32_t _previous, char32_t _next)
+{
+    // Codepoints fit 21 bits each, so a pair packs losslessly into the key.
+    auto const key = (static_cast<uint64_t>(_previous) << 21) | static_cast<uint64_t>(_next);
+    thread_local auto breakables = crispy::LRUCache<uint64_t, bool> { 1024 };
+    return breakables.get_or_emplace(
+        key, [=]() { return unicode::grapheme_segmenter::breakable(_previous, _next); });
+}
+
+} // namespace terminal
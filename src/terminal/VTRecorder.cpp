@@ -0,0 +1,111 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/VTRecorder.h>
+#include <terminal/logging.h>
+
+using namespace std;
+
+namespace terminal
+{
+
+namespace
+{
+    template <typename T>
+    void appendPod(string& _buffer, T const& _value)
+    {
+        _buffer.append(reinterpret_cast<char const*>(&_value), sizeof(_value));
+    }
+} // namespace
+
+VTRecorder::VTRecorder(FileSystem::path const& _path):
+    startTime_ { chrono::steady_clock::now() },
+    output_ { _path.string(), ios::binary | ios::trunc },
+    index_ { _path.string() + ".idx", ios::binary | ios::trunc }
+{
+    appendPod(encodeBuffer_, FileMagic);
+    appendPod(encodeBuffer_, FileVersion);
+
+    auto indexHeader = string {};
+    appendPod(indexHeader, IndexMagic);
+    appendPod(indexHeader, FileVersion);
+    index_.write(indexHeader.data(), static_cast<streamsize>(indexHeader.size()));
+
+    writerThread_ = thread { [this]() { writerLoop(); } };
+
+    LOGSTORE(TerminalLog)("Recording PTY stream to {}.", _path.string());
+}
+
+VTRecorder::~VTRecorder()
+{
+    {
+        auto const _l = lock_guard { bufferLock_ };
+        closing_ = true;
+    }
+    bufferCV_.notify_one();
+    writerThread_.join();
+}
+
+uint64_t VTRecorder::elapsedMicroseconds() const
+{
+    return static_cast<uint64_t>(
+        chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime_).count());
+}
+
+void VTRecorder::record(string_view _chunk)
+{
+    if (_chunk.empty())
+        return;
+
+    auto const timestamp = elapsedMicroseconds();
+    {
+        auto const _l = lock_guard { bufferLock_ };
+        appendPod(encodeBuffer_, timestamp);
+        appendPod(encodeBuffer_, static_cast<uint32_t>(_chunk.size()));
+        encodeBuffer_.append(_chunk.data(), _chunk.size());
+    }
+    bufferCV_.notify_one();
+}
+
+void VTRecorder::writerLoop()
+{
+    for (;;)
+    {
+        {
+            auto _l = unique_lock { bufferLock_ };
+            bufferCV_.wait(_l, [this]() { return closing_ || !encodeBuffer_.empty(); });
+            swap(encodeBuffer_, writeBuffer_);
+        }
+        if (writeBuffer_.empty())
+            return; // only reachable when closing down
+
+        // encodeBuffer_ always holds whole records, so after this write
+        // bytesWritten_ again denotes a record boundary.
+        output_.write(writeBuffer_.data(), static_cast<streamsize>(writeBuffer_.size()));
+        output_.flush();
+        bytesWritten_ += writeBuffer_.size();
+        writeBuffer_.clear();
+
+        if (bytesWritten_ >= nextIndexOffset_)
+        {
+            auto entry = string {};
+            appendPod(entry, bytesWritten_);
+            appendPod(entry, elapsedMicroseconds());
+            index_.write(entry.data(), static_cast<streamsize>(entry.size()));
+            index_.flush();
+            nextIndexOffset_ = bytesWritten_ + IndexInterval;
+        }
+    }
+}
+
+} // namespace terminal
@@ -0,0 +1,87 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <crispy/stdfs.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+namespace terminal
+{
+
+/**
+ * Records the raw PTY byte stream into a log file, for post-mortem debugging
+ * of rendering issues and for reproducible benchmark inputs
+ * (replayed via `bench-headless replay`).
+ *
+ * The file starts with a header (FileMagic, FileVersion), followed by one
+ * record per chunk handed to record():
+ *
+ *     uint64_t    timestamp in microseconds since recording start
+ *     uint32_t    chunk length in bytes
+ *     char[...]   raw chunk bytes
+ *
+ * All integers are stored in host byte order.
+ *
+ * record() merely frames the chunk into an in-memory buffer; a dedicated
+ * writer thread swaps that buffer out and performs the file I/O, keeping disk
+ * latency off the PTY processing hot path. Additionally, about every
+ * IndexInterval bytes an entry (file offset, timestamp) is appended to
+ * "<file>.idx", so tools can seek into large recordings without scanning them.
+ */
+class VTRecorder
+{
+  public:
+    static constexpr uint32_t FileMagic = 0x43565452;  // "CVTR"
+    static constexpr uint32_t IndexMagic = 0x43565449; // "CVTI"
+    static constexpr uint32_t FileVersion = 1;
+    static constexpr uint64_t IndexInterval = 16 * 1024 * 1024;
+
+    explicit VTRecorder(FileSystem::path const& _path);
+    ~VTRecorder();
+
+    VTRecorder(VTRecorder const&) = delete;
+    VTRecorder& operator=(VTRecorder const&) = delete;
+
+    /// Appends one chunk of raw PTY output to the recording.
+    void record(std::string_view _chunk);
+
+  private:
+    void writerLoop();
+    uint64_t elapsedMicroseconds() const;
+
+    std::chrono::steady_clock::time_point startTime_;
+    std::ofstream output_;
+    std::ofstream index_;
+
+    std::mutex bufferLock_;
+    std::condition_variable bufferCV_;
+    std::string encodeBuffer_; //!< buffer currently appended to by record()
+    std::string writeBuffer_;  //!< buffer currently flushed by the writer thread
+    bool closing_ = false;
+
+    uint64_t bytesWritten_ = 0;
+    uint64_t nextIndexOffset_ = IndexInterval;
+
+    std::thread writerThread_;
+};
+
+} // namespace terminal
@@ -14,6 +14,7 @@
 #include <terminal/pty/ConPty.h>
 
 #include <Windows.h>
+#include <cerrno>
 #include <utility>
 
 using namespace std;
@@ -42,6 +43,47 @@ string GetLastErrorAsString()
 
     return message;
 }
+
+// Creates a one-directional pipe whose terminal-side end supports overlapped
+// I/O. Anonymous pipes do not, so this uses a uniquely named pipe pair, like
+// CreatePipe() does internally - the console-side end stays synchronous, as
+// it is handed off to ConPTY.
+bool createOverlappedPipe(HANDLE* _overlappedEnd, HANDLE* _consoleEnd, bool _overlappedEndIsRead)
+{
+    static LONG pipeSerial = 0;
+    char pipeName[MAX_PATH];
+    snprintf(pipeName,
+             sizeof(pipeName),
+             "\\\\.\\pipe\\contour-conpty-%lu-%ld",
+             GetCurrentProcessId(),
+             InterlockedIncrement(&pipeSerial));
+
+    auto const serverAccess = _overlappedEndIsRead ? PIPE_ACCESS_INBOUND : PIPE_ACCESS_OUTBOUND;
+    auto const clientAccess = _overlappedEndIsRead ? GENERIC_WRITE : GENERIC_READ;
+
+    HANDLE server = CreateNamedPipeA(pipeName,
+                                     serverAccess | FILE_FLAG_OVERLAPPED,
+                                     PIPE_TYPE_BYTE | PIPE_WAIT,
+                                     1,
+                                     128 * 1024,
+                                     128 * 1024,
+                                     0,
+                                     nullptr);
+    if (server == INVALID_HANDLE_VALUE)
+        return false;
+
+    HANDLE client = CreateFileA(
+        pipeName, clientAccess, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (client == INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(server);
+        return false;
+    }
+
+    *_overlappedEnd = server;
+    *_consoleEnd = client;
+    return true;
+}
 } // anonymous namespace
 
 namespace terminal
@@ -56,16 +98,24 @@ ConPty::ConPty(PageSize const& _windowSize): size_ { _windowSize }
     HANDLE hPipePTYIn { INVALID_HANDLE_VALUE };
     HANDLE hPipePTYOut { INVALID_HANDLE_VALUE };
 
-    // Create the pipes to which the ConPty will connect to
-    if (!CreatePipe(&hPipePTYIn, &output_, NULL, 0))
+    // Create the pipes to which the ConPty will connect to; our ends are
+    // overlapped so read() and write() never block the calling thread.
+    if (!createOverlappedPipe(&output_, &hPipePTYIn, false))
         throw runtime_error { GetLastErrorAsString() };
 
-    if (!CreatePipe(&input_, &hPipePTYOut, NULL, 0))
+    if (!createOverlappedPipe(&input_, &hPipePTYOut, true))
     {
         CloseHandle(hPipePTYIn);
         throw runtime_error { GetLastErrorAsString() };
     }
 
+    readEvent_ = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    writeEvent_ = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    wakeupEvent_ = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+    if (!readEvent_ || !writeEvent_ || !wakeupEvent_)
+        throw runtime_error { GetLastErrorAsString() };
+    readOverlapped_.hEvent = readEvent_;
+
     // Create the Pseudo Console of the required size, attached to the PTY-end of the pipes
     HRESULT hr = CreatePseudoConsole({ unbox<SHORT>(_windowSize.columns), unbox<SHORT>(_windowSize.lines) },
                                      hPipePTYIn,
@@ -82,12 +132,24 @@ ConPty::ConPty(PageSize const& _windowSize): size_ { _windowSize }
     if (hr != S_OK)
         throw runtime_error { GetLastErrorAsString() };
 
-    buffer_.resize(10240);
+    // Same ring-buffer discipline as UnixPty: each read fills the next free
+    // segment, so previously returned views stay valid while the parser is
+    // still draining them.
+    buffer_.resize(4 * 1024 * 1024);
 }
 
 ConPty::~ConPty()
 {
     close();
+
+    for (auto* event: { &readEvent_, &writeEvent_, &wakeupEvent_ })
+    {
+        if (*event)
+        {
+            CloseHandle(*event);
+            *event = nullptr;
+        }
+    }
 }
 
 bool ConPty::isClosed() const
@@ -107,6 +169,9 @@ void ConPty::close()
 
     if (input_ != INVALID_HANDLE_VALUE)
     {
+        // Completes a still-outstanding overlapped read with
+        // ERROR_OPERATION_ABORTED, waking a reader blocked in read().
+        CancelIoEx(input_, nullptr);
         CloseHandle(input_);
         input_ = INVALID_HANDLE_VALUE;
     }
@@ -116,6 +181,9 @@ void ConPty::close()
         CloseHandle(output_);
         output_ = INVALID_HANDLE_VALUE;
     }
+
+    if (wakeupEvent_)
+        SetEvent(wakeupEvent_);
 }
 
 void ConPty::prepareParentProcess()
@@ -128,31 +196,101 @@ void ConPty::prepareChildProcess()
 
 optional<string_view> ConPty::read(size_t _size, std::chrono::milliseconds _timeout)
 {
-    // TODO: wait for _timeout time at most AND got woken up upon wakeupReader() invokcation.
-    (void) _timeout;
+    if (input_ == INVALID_HANDLE_VALUE)
+    {
+        errno = ENODEV;
+        return nullopt;
+    }
 
-    auto const n = static_cast<DWORD>(min(_size, buffer_.size()));
+    if (!readPending_)
+    {
+        // The buffer is used as a ring: fill the next free segment and only
+        // wrap to the front when the remaining tail is too small, keeping
+        // previously returned string_views valid downstream.
+        if (buffer_.size() - bufferCursor_ < _size)
+            bufferCursor_ = 0;
+        pendingReadSize_ = min(_size, buffer_.size() - bufferCursor_);
+
+        ResetEvent(readEvent_);
+        if (!ReadFile(input_,
+                      buffer_.data() + bufferCursor_,
+                      static_cast<DWORD>(pendingReadSize_),
+                      nullptr,
+                      &readOverlapped_)
+            && GetLastError() != ERROR_IO_PENDING)
+        {
+            errno = ENODEV;
+            return nullopt;
+        }
+        readPending_ = true;
+    }
 
-    DWORD nread {};
-    if (!ReadFile(input_, buffer_.data(), n, &nread, nullptr))
+    HANDLE const handles[2] = { readEvent_, wakeupEvent_ };
+    auto const timeoutMillis =
+        _timeout.count() < 0 ? INFINITE : static_cast<DWORD>(_timeout.count());
+
+    switch (WaitForMultipleObjects(2, handles, FALSE, timeoutMillis))
+    {
+    case WAIT_OBJECT_0: // read completed
+        break;
+    case WAIT_OBJECT_0 + 1: // woken up via wakeupReader(); the read stays pending
+        ResetEvent(wakeupEvent_);
+        errno = EINTR;
+        return nullopt;
+    case WAIT_TIMEOUT: // the read stays pending, to be picked up by the next call
+        errno = EAGAIN;
         return nullopt;
+    default: errno = ENODEV; return nullopt;
+    }
+
+    readPending_ = false;
 
-    return string_view { buffer_.data(), nread };
+    DWORD nread {};
+    if (!GetOverlappedResult(input_, &readOverlapped_, &nread, FALSE))
+        return string_view {}; // treat like EOF: the endpoint was closed
+
+    auto* const bufferStart = buffer_.data() + bufferCursor_;
+    bufferCursor_ += static_cast<size_t>(nread);
+    return string_view { bufferStart, static_cast<size_t>(nread) };
 }
 
 void ConPty::wakeupReader()
 {
-    // TODO: Windows ConPTY does *NOT* support non-blocking / overlapped I/O.
-    // How can we make ReadFile() return early? We could maybe WriteFile() to it?
+    SetEvent(wakeupEvent_);
 }
 
 int ConPty::write(char const* buf, size_t size)
 {
+    if (output_ == INVALID_HANDLE_VALUE)
+        return -1;
+
+    auto writeOverlapped = OVERLAPPED {};
+    writeOverlapped.hEvent = writeEvent_;
+    ResetEvent(writeEvent_);
+
+    if (!WriteFile(output_, buf, static_cast<DWORD>(size), nullptr, &writeOverlapped))
+    {
+        if (GetLastError() != ERROR_IO_PENDING)
+            return -1;
+
+        // The pipe applies backpressure (e.g. a large paste): wait a bounded
+        // time, then report "nothing written" so the caller re-queues the
+        // remainder instead of blocking on the full pipe - mirroring the
+        // UnixPty write timeout.
+        if (WaitForSingleObject(writeEvent_, 1000) != WAIT_OBJECT_0)
+        {
+            CancelIoEx(output_, &writeOverlapped);
+            DWORD nwritten {};
+            if (!GetOverlappedResult(output_, &writeOverlapped, &nwritten, TRUE))
+                return 0;
+            return static_cast<int>(nwritten); // the write raced the cancellation
+        }
+    }
+
     DWORD nwritten {};
-    if (WriteFile(output_, buf, static_cast<DWORD>(size), &nwritten, nullptr))
-        return static_cast<int>(nwritten);
-    else
+    if (!GetOverlappedResult(output_, &writeOverlapped, &nwritten, TRUE))
         return -1;
+    return static_cast<int>(nwritten);
 }
 
 PageSize ConPty::pageSize() const noexcept
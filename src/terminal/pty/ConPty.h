@@ -23,6 +23,11 @@ namespace terminal
 {
 
 /// ConPty implementation for newer Windows 10 versions.
+///
+/// The pipes to the pseudo console are opened in overlapped mode, giving
+/// read() the same semantics as UnixPty: bounded by a timeout, interruptible
+/// via wakeupReader(), and feeding the shared ring buffer without ever
+/// parking the VT thread in a blocking ReadFile().
 class ConPty: public Pty
 {
   public:
@@ -50,6 +55,17 @@ class ConPty: public Pty
     HANDLE input_;
     HANDLE output_;
     std::vector<char> buffer_;
+    size_t bufferCursor_ = 0;
+
+    // One outstanding overlapped read at a time; it survives a timed-out or
+    // interrupted read() call and is picked up again by the next one.
+    OVERLAPPED readOverlapped_ {};
+    bool readPending_ = false;
+    size_t pendingReadSize_ = 0;
+
+    HANDLE readEvent_;   //!< completion event of the outstanding read
+    HANDLE writeEvent_;  //!< completion event of the current write
+    HANDLE wakeupEvent_; //!< signalled by wakeupReader() to interrupt read()
 };
 
 } // namespace terminal
@@ -48,11 +48,20 @@ class Pty
     /// That is, the current process must be already the child, i.e. via fork().
     virtual void prepareChildProcess() = 0;
 
+    /// Timeout value for read() to block indefinitely, i.e. until data arrives,
+    /// the PTY is closed, or wakeupReader() is invoked.
+    static constexpr std::chrono::milliseconds NoTimeout { -1 };
+
     /// Reads from the terminal whatever has been written to from the other side of the terminal.
     ///
-    /// @param _size   Capacity of parameter @p buf. At most @p size bytes will be stored into it.
+    /// @param _size    Capacity of parameter @p buf. At most @p size bytes will be stored into it.
+    /// @param _timeout Give up waiting for data after this long; NoTimeout blocks indefinitely.
     ///
     /// @returns view to the consumed buffer.
+    ///
+    /// The returned view points into an implementation-owned ring buffer and remains
+    /// valid across subsequent read() calls until the ring wraps around, enabling
+    /// zero-copy hand-over to the VT parser.
     virtual std::optional<std::string_view> read(size_t _size, std::chrono::milliseconds _timeout) = 0;
 
     /// Inerrupts the read() operation on this PTY if a read() is currently in progress.
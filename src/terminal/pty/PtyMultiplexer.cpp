@@ -0,0 +1,187 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/pty/PtyMultiplexer.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+    #include <sys/epoll.h>
+#else
+    #include <poll.h>
+#endif
+
+using std::lock_guard;
+using std::runtime_error;
+using std::string;
+
+using namespace std::string_literals;
+
+namespace terminal
+{
+
+PtyMultiplexer::PtyMultiplexer()
+{
+    if (pipe(wakeupPipe_) < 0)
+        throw runtime_error { "Failed to create multiplexer pipe. "s + strerror(errno) };
+    for (auto const fd: wakeupPipe_)
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+
+#if defined(__linux__)
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0)
+        throw runtime_error { "Failed to create epoll handle. "s + strerror(errno) };
+
+    epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = wakeupPipe_[0];
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeupPipe_[0], &ev);
+#endif
+}
+
+PtyMultiplexer::~PtyMultiplexer()
+{
+#if defined(__linux__)
+    if (epollFd_ >= 0)
+        ::close(epollFd_);
+#endif
+    for (auto const fd: wakeupPipe_)
+        if (fd >= 0)
+            ::close(fd);
+}
+
+void PtyMultiplexer::add(UnixPty& _pty, std::function<void()> _onReadable)
+{
+    auto const fd = _pty.masterFd();
+    auto const _l = lock_guard { lock_ };
+    handlers_[fd] = std::move(_onReadable);
+
+#if defined(__linux__)
+    epoll_event ev {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+#endif
+}
+
+void PtyMultiplexer::remove(UnixPty& _pty)
+{
+    auto const fd = _pty.masterFd();
+    auto const _l = lock_guard { lock_ };
+    handlers_.erase(fd);
+
+#if defined(__linux__)
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+#endif
+}
+
+size_t PtyMultiplexer::poll(std::chrono::milliseconds _timeout)
+{
+    auto const drainWakeupPipe = [this]() {
+        char drain[256];
+        while (::read(wakeupPipe_[0], drain, sizeof(drain)) > 0)
+            ;
+    };
+
+#if defined(__linux__)
+    epoll_event events[64];
+    auto const n =
+        epoll_wait(epollFd_, events, static_cast<int>(std::size(events)), static_cast<int>(_timeout.count()));
+    if (n <= 0)
+        return 0;
+
+    size_t dispatched = 0;
+    for (int i = 0; i < n; ++i)
+    {
+        if (events[i].data.fd == wakeupPipe_[0])
+        {
+            drainWakeupPipe();
+            continue;
+        }
+
+        // The handler is copied out so a concurrent remove() (or one issued
+        // by the handler itself) does not invalidate what we are invoking.
+        std::function<void()> handler;
+        {
+            auto const _l = lock_guard { lock_ };
+            if (auto const entry = handlers_.find(events[i].data.fd); entry != handlers_.end())
+                handler = entry->second;
+        }
+        if (handler)
+        {
+            handler();
+            ++dispatched;
+        }
+    }
+    return dispatched;
+#else
+    auto watches = std::vector<pollfd> {};
+    {
+        auto const _l = lock_guard { lock_ };
+        watches.reserve(handlers_.size() + 1);
+        watches.push_back(pollfd { wakeupPipe_[0], POLLIN, 0 });
+        for (auto const& [fd, _]: handlers_)
+            watches.push_back(pollfd { fd, POLLIN, 0 });
+    }
+
+    auto const n = ::poll(watches.data(), watches.size(), static_cast<int>(_timeout.count()));
+    if (n <= 0)
+        return 0;
+
+    size_t dispatched = 0;
+    for (auto const& watch: watches)
+    {
+        if (!(watch.revents & (POLLIN | POLLHUP)))
+            continue;
+        if (watch.fd == wakeupPipe_[0])
+        {
+            drainWakeupPipe();
+            continue;
+        }
+
+        std::function<void()> handler;
+        {
+            auto const _l = lock_guard { lock_ };
+            if (auto const entry = handlers_.find(watch.fd); entry != handlers_.end())
+                handler = entry->second;
+        }
+        if (handler)
+        {
+            handler();
+            ++dispatched;
+        }
+    }
+    return dispatched;
+#endif
+}
+
+void PtyMultiplexer::wakeup()
+{
+    char dummy {};
+    auto const rv = ::write(wakeupPipe_[1], &dummy, sizeof(dummy));
+    (void) rv;
+}
+
+size_t PtyMultiplexer::size() const noexcept
+{
+    auto const _l = lock_guard { lock_ };
+    return handlers_.size();
+}
+
+} // namespace terminal
@@ -0,0 +1,76 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <terminal/pty/UnixPty.h>
+
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace terminal
+{
+
+/// Multiplexes read-readiness of any number of UnixPty devices over a single
+/// kernel polling object (epoll on Linux, poll(2) elsewhere).
+///
+/// One driver thread calling poll() replaces N per-terminal reader threads
+/// blocking in UnixPty::read(): whenever a registered PTY becomes readable,
+/// its handler is invoked from within poll(), which typically performs the
+/// (non-blocking) UnixPty::read and feeds the result to the terminal.
+///
+/// The Pty interface itself is untouched, so single-session embeddings keep
+/// working without a multiplexer.
+///
+/// @see docs/session-scheduler.md
+class PtyMultiplexer
+{
+  public:
+    PtyMultiplexer();
+    ~PtyMultiplexer();
+
+    PtyMultiplexer(PtyMultiplexer const&) = delete;
+    PtyMultiplexer& operator=(PtyMultiplexer const&) = delete;
+
+    /// Registers the given PTY, invoking @p _onReadable from within poll()
+    /// whenever its master fd has data pending.
+    void add(UnixPty& _pty, std::function<void()> _onReadable);
+
+    /// Unregisters the given PTY; its handler is not invoked anymore once
+    /// this call returns.
+    void remove(UnixPty& _pty);
+
+    /// Waits up to @p _timeout for registered PTYs to become readable and
+    /// invokes their handlers.
+    ///
+    /// @returns the number of handlers invoked; 0 on timeout or wakeup().
+    size_t poll(std::chrono::milliseconds _timeout);
+
+    /// Interrupts a concurrently blocking poll() call, making it return 0.
+    void wakeup();
+
+    size_t size() const noexcept;
+
+  private:
+#if defined(__linux__)
+    int epollFd_ = -1;
+#endif
+    int wakeupPipe_[2] = { -1, -1 };
+
+    mutable std::mutex lock_;
+    std::unordered_map<int, std::function<void()>> handlers_; // keyed by master fd
+};
+
+} // namespace terminal
@@ -6,6 +6,8 @@
     #include <terminal/pty/UnixPty.h>
 #endif
 
+#include <algorithm>
+
 using namespace std;
 
 namespace terminal
@@ -62,7 +64,22 @@ void PtyProcess::prepareChildProcess()
 
 optional<string_view> PtyProcess::read(size_t _size, std::chrono::milliseconds _timeout)
 {
-    return pty_->read(_size, _timeout);
+    // Adaptive read sizing: when consecutive reads come back full the child is
+    // producing output in bursts, so double the requested size (up to
+    // MaxAdaptiveReadSize) to stay syscall-bound as little as possible.
+    // A mostly-empty read signals interactivity; shrink back towards the
+    // caller-requested baseline to keep latency and cache footprint low.
+    adaptiveReadSize_ = clamp(adaptiveReadSize_, _size, MaxAdaptiveReadSize);
+
+    auto const result = pty_->read(adaptiveReadSize_, _timeout);
+    if (result.has_value())
+    {
+        if (result->size() == adaptiveReadSize_)
+            adaptiveReadSize_ = min(adaptiveReadSize_ * 2, MaxAdaptiveReadSize);
+        else if (result->size() < adaptiveReadSize_ / 4)
+            adaptiveReadSize_ = max(adaptiveReadSize_ / 2, _size);
+    }
+    return result;
 }
 
 void PtyProcess::wakeupReader()
@@ -32,6 +32,9 @@ class PtyProcess: public Pty
 
     Process::ExitStatus waitForProcessExit();
 
+    /// Upper bound for the adaptively grown per-read() buffer size.
+    static constexpr size_t MaxAdaptiveReadSize = 1024 * 1024;
+
     // Pty interface
     //
     void close() override;
@@ -48,6 +51,7 @@ class PtyProcess: public Pty
     std::unique_ptr<Pty> pty_;
     std::unique_ptr<Process> process_;
     std::thread processExitWatcher_;
+    size_t adaptiveReadSize_ = 0; // grows under bursty output, shrinks under interactivity
 };
 
 } // namespace terminal
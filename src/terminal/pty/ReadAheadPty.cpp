@@ -0,0 +1,201 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal/pty/ReadAheadPty.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+using std::lock_guard;
+using std::min;
+using std::nullopt;
+using std::optional;
+using std::string_view;
+using std::unique_lock;
+using std::unique_ptr;
+
+using namespace std::chrono_literals;
+
+namespace terminal
+{
+
+namespace
+{
+    // Ring capacity; bounds how far the reader thread may run ahead of the parser.
+    constexpr size_t RingCapacity = 4 * 1024 * 1024;
+
+    // Upper bound for a single read from the underlying PTY.
+    constexpr size_t ReadChunkSize = 64 * 1024;
+
+    // Timeout for reads on the underlying PTY; only bounds shutdown latency.
+    constexpr auto ReaderTimeout = 1000ms;
+} // namespace
+
+ReadAheadPty::ReadAheadPty(unique_ptr<Pty> _inner): inner_ { std::move(_inner) }
+{
+    ring_.resize(RingCapacity);
+}
+
+ReadAheadPty::~ReadAheadPty()
+{
+    close();
+    if (readerThread_.joinable())
+        readerThread_.join();
+}
+
+void ReadAheadPty::close()
+{
+    {
+        auto const _l = lock_guard { lock_ };
+        closing_ = true;
+    }
+    inner_->close();
+    inner_->wakeupReader();
+    producerCV_.notify_all();
+    consumerCV_.notify_all();
+}
+
+bool ReadAheadPty::isClosed() const
+{
+    return inner_->isClosed();
+}
+
+void ReadAheadPty::prepareParentProcess()
+{
+    inner_->prepareParentProcess();
+}
+
+void ReadAheadPty::prepareChildProcess()
+{
+    inner_->prepareChildProcess();
+}
+
+size_t ReadAheadPty::contiguousFreeSpace() const noexcept
+{
+    return min(ring_.size() - fill_, ring_.size() - writePos_);
+}
+
+void ReadAheadPty::releaseHeldBytes()
+{
+    if (!heldBytes_)
+        return;
+
+    fill_ -= heldBytes_;
+    readPos_ = (readPos_ + heldBytes_) % ring_.size();
+    heldBytes_ = 0;
+    producerCV_.notify_one();
+}
+
+void ReadAheadPty::readerLoop()
+{
+    for (;;)
+    {
+        size_t space = 0;
+        {
+            auto _lock = unique_lock { lock_ };
+            producerCV_.wait(_lock, [this]() { return closing_ || contiguousFreeSpace() != 0; });
+            if (closing_)
+                return;
+            space = contiguousFreeSpace();
+        }
+
+        auto const bufOpt = inner_->read(min(space, ReadChunkSize), ReaderTimeout);
+        if (!bufOpt && (errno == EINTR || errno == EAGAIN))
+            continue;
+
+        if (!bufOpt || bufOpt->empty())
+        {
+            // Underlying PTY reached EOF (or failed); let the consumer drain
+            // what is left in the ring and then observe the EOF.
+            auto const _l = lock_guard { lock_ };
+            eof_ = true;
+            consumerCV_.notify_all();
+            return;
+        }
+
+        auto const buf = *bufOpt;
+        {
+            auto const _l = lock_guard { lock_ };
+            // Free space only grows from the consumer side, so the contiguous
+            // segment reserved above is still available here.
+            std::memcpy(ring_.data() + writePos_, buf.data(), buf.size());
+            writePos_ = (writePos_ + buf.size()) % ring_.size();
+            fill_ += buf.size();
+        }
+        consumerCV_.notify_one();
+    }
+}
+
+optional<string_view> ReadAheadPty::read(size_t _size, std::chrono::milliseconds _timeout)
+{
+    if (!readerThread_.joinable())
+        readerThread_ = std::thread { &ReadAheadPty::readerLoop, this };
+
+    auto _lock = unique_lock { lock_ };
+    releaseHeldBytes();
+
+    auto const wakeup = [this]() { return fill_ != 0 || eof_ || closing_ || wakeupPending_; };
+    if (_timeout.count() < 0)
+        consumerCV_.wait(_lock, wakeup);
+    else if (!consumerCV_.wait_for(_lock, _timeout, wakeup))
+    {
+        errno = EAGAIN;
+        return nullopt;
+    }
+
+    if (fill_ == 0)
+    {
+        if (wakeupPending_)
+        {
+            wakeupPending_ = false;
+            errno = EINTR;
+            return nullopt;
+        }
+        // EOF (or closing): empty view signals end-of-stream to the caller.
+        return string_view {};
+    }
+
+    // Available data satisfies a pending wakeup, too (the caller's loop runs).
+    wakeupPending_ = false;
+
+    auto const n = min({ _size, fill_, ring_.size() - readPos_ });
+    heldBytes_ = n;
+    return string_view { ring_.data() + readPos_, n };
+}
+
+void ReadAheadPty::wakeupReader()
+{
+    {
+        auto const _l = lock_guard { lock_ };
+        wakeupPending_ = true;
+    }
+    consumerCV_.notify_all();
+}
+
+int ReadAheadPty::write(char const* _buf, size_t _size)
+{
+    return inner_->write(_buf, _size);
+}
+
+PageSize ReadAheadPty::pageSize() const noexcept
+{
+    return inner_->pageSize();
+}
+
+void ReadAheadPty::resizeScreen(PageSize _cells, optional<ImageSize> _pixels)
+{
+    inner_->resizeScreen(_cells, _pixels);
+}
+
+} // namespace terminal
@@ -0,0 +1,84 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2020 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <terminal/pty/Pty.h>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace terminal
+{
+
+/// Pty decorator that keeps draining the underlying PTY on a dedicated reader
+/// thread into a bounded ring buffer.
+///
+/// With this decorator in place the kernel-to-userspace copy overlaps with VT
+/// parsing and screen updates on the terminal thread, so read() almost always
+/// finds bytes readily available and the parser gets longer uninterrupted
+/// quanta. The ring is bounded: once it is full the reader thread stops
+/// consuming the underlying PTY, preserving kernel-side backpressure towards
+/// the client application.
+///
+/// The view returned by read() points into the ring and remains valid until
+/// the next read() call, which releases it back to the reader thread.
+class ReadAheadPty: public Pty
+{
+  public:
+    explicit ReadAheadPty(std::unique_ptr<Pty> _inner);
+    ~ReadAheadPty() override;
+
+    void close() override;
+    bool isClosed() const override;
+    void prepareParentProcess() override;
+    void prepareChildProcess() override;
+    std::optional<std::string_view> read(size_t _size, std::chrono::milliseconds _timeout) override;
+    void wakeupReader() override;
+    int write(char const* _buf, size_t _size) override;
+    PageSize pageSize() const noexcept override;
+    void resizeScreen(PageSize _cells, std::optional<ImageSize> _pixels = std::nullopt) override;
+
+  private:
+    void readerLoop();
+
+    /// Number of contiguous free bytes at the current ring write position.
+    size_t contiguousFreeSpace() const noexcept;
+
+    /// Releases the view handed out by the previous read() call back to the
+    /// reader thread.
+    void releaseHeldBytes();
+
+    std::unique_ptr<Pty> inner_;
+
+    mutable std::mutex lock_;
+    std::condition_variable producerCV_;
+    std::condition_variable consumerCV_;
+    std::vector<char> ring_;
+    size_t readPos_ = 0;
+    size_t writePos_ = 0;
+    size_t fill_ = 0;
+    size_t heldBytes_ = 0; //!< size of the view handed out by the last read()
+    bool eof_ = false;
+    bool closing_ = false;
+    bool wakeupPending_ = false;
+
+    // Started lazily upon the first read() so that fork()/exec() setup of the
+    // inner PTY happens before any helper thread exists.
+    std::thread readerThread_;
+};
+
+} // namespace terminal
@@ -201,7 +201,7 @@ optional<string_view> UnixPty::read(size_t _size, std::chrono::milliseconds _tim
         FD_SET(pipe_[0], &rfd);
         auto const nfds = 1 + max(master_, pipe_[0]);
 
-        int rv = select(nfds, &rfd, &wfd, &efd, &tv);
+        int rv = select(nfds, &rfd, &wfd, &efd, _timeout.count() < 0 ? nullptr : &tv);
         if (rv == 0)
         {
             // (Let's not be too verbose here.)
@@ -238,13 +238,21 @@ optional<string_view> UnixPty::read(size_t _size, std::chrono::milliseconds _tim
 
         if (FD_ISSET(master_, &rfd))
         {
-            auto const n = min(_size, buffer_.size());
-            auto const rv = static_cast<int>(::read(master_, buffer_.data(), n));
+            // The internal buffer is used as a ring: each read() fills the next free
+            // segment and only wraps to the front when the remaining tail is too small.
+            // This keeps previously returned string_views valid while the parser is
+            // still draining them, so no intermediate copy is needed downstream.
+            if (buffer_.size() - bufferCursor_ < _size)
+                bufferCursor_ = 0;
+            auto* const bufferStart = buffer_.data() + bufferCursor_;
+            auto const n = min(_size, buffer_.size() - bufferCursor_);
+            auto const rv = static_cast<int>(::read(master_, bufferStart, n));
             if (rv >= 0)
             {
+                bufferCursor_ += static_cast<size_t>(rv);
                 if (PtyInLog)
-                    PtyInLog()("Received: {}", crispy::escape(buffer_.data(), buffer_.data() + rv));
-                return string_view { buffer_.data(), static_cast<size_t>(rv) };
+                    PtyInLog()("Received: {}", crispy::escape(bufferStart, bufferStart + rv));
+                return string_view { bufferStart, static_cast<size_t>(rv) };
             }
             else
             {
@@ -351,4 +359,16 @@ void UnixPty::prepareChildProcess()
         _exit(EXIT_FAILURE);
 }
 
+void UnixPty::prepareSpawnedChildProcess()
+{
+    if (slave_ < 0)
+        return;
+
+    // Terminal settings stick to the device, not the file descriptor, so
+    // applying them here covers the child's freshly opened slave end, too.
+    auto const tio = constructTerminalSettings(slave_);
+    if (tcsetattr(slave_, TCSANOW, &tio) == 0)
+        tcflush(slave_, TCIOFLUSH);
+}
+
 } // namespace terminal
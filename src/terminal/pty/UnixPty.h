@@ -42,9 +42,17 @@ class UnixPty: public Pty
 
     void prepareParentProcess() override;
     void prepareChildProcess() override;
+
+    /// Parent-side counterpart of prepareChildProcess() for posix_spawn()ed
+    /// children: applies the initial terminal settings to the slave end
+    /// up-front, as a spawned child cannot run arbitrary code between clone
+    /// and exec.
+    void prepareSpawnedChildProcess();
+
     void close() override;
     bool isClosed() const override;
     [[nodiscard]] constexpr int masterFd() const noexcept { return master_; }
+    [[nodiscard]] constexpr int slaveFd() const noexcept { return slave_; }
 
   private:
     PageSize size_;
@@ -52,6 +60,7 @@ class UnixPty: public Pty
     int slave_;
     std::array<int, 2> pipe_;
     std::vector<char> buffer_;
+    size_t bufferCursor_ = 0;
 };
 
 } // namespace terminal
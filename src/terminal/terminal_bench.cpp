@@ -0,0 +1,149 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Micro-benchmarks for the Grid data structure: scrolling, resizing with and
+// without reflow, line storage inflation/deflation, and logical-line
+// iteration. These isolate the grid from parsing, complementing the
+// end-to-end throughput numbers of bench-headless.
+//
+// Emits one JSON document on stdout, suitable for regression-gating via
+// scripts/compare-benchmarks.py against a previously recorded run.
+
+#include <terminal/Cell.h>
+#include <terminal/Grid.h>
+
+#include <crispy/bench.h>
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+using namespace std;
+using namespace terminal;
+
+using crispy::bench::benchmark;
+using crispy::bench::sink;
+
+namespace
+{
+
+auto constexpr BenchPageSize = PageSize { LineCount(25), ColumnCount(80) };
+auto constexpr BenchHistoryLineCount = LineCount(4096);
+
+string lineTextOfWidth(size_t n)
+{
+    auto text = string {};
+    text.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        text += char('a' + int(i % 26));
+    return text;
+}
+
+/// Creates a grid whose page and whole scrollback are filled with text lines.
+Grid<Cell> setupFilledGrid(bool _reflowOnResize)
+{
+    auto grid = Grid<Cell>(BenchPageSize, _reflowOnResize, BenchHistoryLineCount);
+    auto const text = lineTextOfWidth(unbox<size_t>(BenchPageSize.columns));
+    auto const totalLineCount = unbox<int>(BenchPageSize.lines) + unbox<int>(BenchHistoryLineCount);
+    for (int i = 0; i < totalLineCount; ++i)
+    {
+        grid.scrollUp(LineCount(1));
+        grid.setLineText(boxed_cast<LineOffset>(BenchPageSize.lines) - 1, text);
+    }
+    return grid;
+}
+
+void benchScrollUp()
+{
+    auto grid = setupFilledGrid(false);
+    auto const text = lineTextOfWidth(unbox<size_t>(BenchPageSize.columns));
+
+    // Steady-state scrolling with a full scrollback: every scroll rotates the
+    // least recently used history line back in as the new bottom-most line.
+    benchmark("grid.scroll_up", unbox<size_t>(BenchPageSize.columns), [&](uint64_t) {
+        grid.scrollUp(LineCount(1));
+        grid.setLineText(boxed_cast<LineOffset>(BenchPageSize.lines) - 1, text);
+        sink += 1;
+    });
+}
+
+void benchResize(bool _reflowOnResize)
+{
+    auto grid = setupFilledGrid(_reflowOnResize);
+    auto const narrow = PageSize { BenchPageSize.lines, ColumnCount(60) };
+    auto const cursor = CellLocation { boxed_cast<LineOffset>(BenchPageSize.lines) - 1, ColumnOffset(0) };
+
+    // Shrink and grow back in one step, so every iteration starts from the
+    // same geometry; with reflow enabled the narrow step wraps every line.
+    benchmark(_reflowOnResize ? "grid.resize.reflow" : "grid.resize.noreflow", 0, [&](uint64_t) {
+        (void) grid.resize(narrow, cursor, false);
+        (void) grid.resize(BenchPageSize, cursor, false);
+        sink += 1;
+    });
+}
+
+void benchInflateDeflate()
+{
+    auto const simple = SimpleLineBuffer { GraphicsAttributes {},
+                                           lineTextOfWidth(unbox<size_t>(BenchPageSize.columns)),
+                                           BenchPageSize.columns };
+
+    benchmark("line.inflate", simple.text.size(), [&](uint64_t) {
+        sink += inflate<Cell>(simple).size(); //
+    });
+
+    auto const inflated = inflate<Cell>(simple);
+    benchmark("line.deflate", simple.text.size(), [&](uint64_t) {
+        if (auto const deflated = deflate<Cell>(inflated))
+            sink += deflated->text.size();
+    });
+}
+
+void benchLogicalLines()
+{
+    auto grid = setupFilledGrid(true);
+
+    // Mark every second line as wrapped (keeping the top-most one unwrapped),
+    // so iteration exercises both the join-continuation and the
+    // new-logical-line paths.
+    for (int offset = -unbox<int>(BenchHistoryLineCount) + 1; offset < unbox<int>(BenchPageSize.lines);
+         offset += 2)
+        grid.lineAt(LineOffset::cast_from(offset)).setWrapped(true);
+
+    benchmark("grid.logical_lines", 0, [&](uint64_t) {
+        auto lineCount = uint64_t { 0 };
+        for (auto const& logicalLine: grid.logicalLines())
+            lineCount += logicalLine.lines.size();
+        sink += lineCount;
+    });
+}
+
+} // namespace
+
+int main(int argc, char const* argv[])
+{
+    // Optional name filter: run only benchmarks whose name contains the argument.
+    auto const filter = string_view { argc > 1 ? argv[1] : "" };
+
+    benchScrollUp();
+    benchResize(false);
+    benchResize(true);
+    benchInflateDeflate();
+    benchLogicalLines();
+
+    crispy::bench::emitJSON(cout, filter);
+
+    return EXIT_SUCCESS;
+}
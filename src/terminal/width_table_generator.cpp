@@ -0,0 +1,131 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Build-time generator for <terminal/WidthTable.h>.
+//
+// Samples unicode::width() for every codepoint and compresses the result into
+// a two-stage table: stage 1 maps a codepoint's block (256 codepoints) to a
+// deduplicated stage-2 block of 2-bit packed width values. Width lookup at
+// runtime is thereby reduced to two dependent loads into ~15 KiB of read-only
+// data, instead of the binary-search rounds of the generic property tables.
+
+#include <unicode/width.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+using std::array;
+using std::ofstream;
+using std::vector;
+
+namespace
+{
+
+auto constexpr MaxCodepoint = uint32_t { 0x110000 };
+auto constexpr BlockSize = uint32_t { 256 };
+auto constexpr BlockCount = MaxCodepoint / BlockSize;
+
+// 256 2-bit values, packed four per byte.
+using PackedBlock = array<uint8_t, BlockSize / 4>;
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2)
+    {
+        std::cerr << "usage: " << argv[0] << " <output-header>\n";
+        return EXIT_FAILURE;
+    }
+
+    auto blockIndex = vector<uint16_t>(BlockCount);
+    auto blocks = vector<PackedBlock> {};
+
+    for (uint32_t block = 0; block < BlockCount; ++block)
+    {
+        auto packed = PackedBlock {};
+        for (uint32_t offset = 0; offset < BlockSize; ++offset)
+        {
+            auto const codepoint = static_cast<char32_t>(block * BlockSize + offset);
+            auto const width = static_cast<unsigned>(unicode::width(codepoint));
+            if (width > 3)
+            {
+                std::cerr << "width(U+" << std::hex << static_cast<uint32_t>(codepoint)
+                          << ") = " << width << " does not fit into 2 bits.\n";
+                return EXIT_FAILURE;
+            }
+            packed[offset / 4] |= static_cast<uint8_t>(width << ((offset % 4) * 2));
+        }
+
+        auto existing = size_t { 0 };
+        while (existing < blocks.size() && blocks[existing] != packed)
+            ++existing;
+        if (existing == blocks.size())
+            blocks.push_back(packed);
+        blockIndex[block] = static_cast<uint16_t>(existing);
+    }
+
+    auto out = ofstream(argv[1]);
+    if (!out)
+    {
+        std::cerr << "Failed to open " << argv[1] << " for writing.\n";
+        return EXIT_FAILURE;
+    }
+
+    out << "// Generated by width_table_generator. DO NOT EDIT.\n"
+           "#pragma once\n"
+           "\n"
+           "#include <array>\n"
+           "#include <cstdint>\n"
+           "\n"
+           "namespace terminal::width_table\n"
+           "{\n"
+           "\n";
+    out << "auto constexpr MaxCodepoint = uint32_t { 0x" << std::hex << MaxCodepoint << std::dec << " };\n";
+    out << "auto constexpr BlockSize = uint32_t { " << BlockSize << " };\n\n";
+
+    out << "inline constexpr std::array<uint16_t, " << BlockCount << "> blockIndex {\n";
+    for (size_t i = 0; i < blockIndex.size(); ++i)
+        out << blockIndex[i] << (i + 1 < blockIndex.size() ? "," : "") << ((i + 1) % 16 ? " " : "\n");
+    out << "};\n\n";
+
+    out << "inline constexpr std::array<std::array<uint8_t, " << BlockSize / 4 << ">, " << blocks.size()
+        << "> blocks {{\n";
+    for (PackedBlock const& block: blocks)
+    {
+        out << "    {{";
+        for (size_t i = 0; i < block.size(); ++i)
+            out << static_cast<unsigned>(block[i]) << (i + 1 < block.size() ? "," : "");
+        out << "}},\n";
+    }
+    out << "}};\n\n";
+
+    out << "/// Two-load display width lookup for any Unicode codepoint.\n"
+           "constexpr uint8_t width(char32_t _codepoint) noexcept\n"
+           "{\n"
+           "    if (static_cast<uint32_t>(_codepoint) >= MaxCodepoint)\n"
+           "        return 1;\n"
+           "    auto const& block = blocks[blockIndex[_codepoint / BlockSize]];\n"
+           "    auto const offset = _codepoint % BlockSize;\n"
+           "    return (block[offset / 4] >> ((offset % 4) * 2)) & 3;\n"
+           "}\n"
+           "\n"
+           "} // namespace terminal::width_table\n";
+
+    return out.good() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
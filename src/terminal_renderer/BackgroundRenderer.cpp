@@ -37,15 +37,48 @@ void BackgroundRenderer::setRenderTarget(RenderTarget& renderTarget,
 void BackgroundRenderer::renderCell(RenderCell const& _cell)
 {
     if (_cell.backgroundColor == defaultColor_)
+    {
+        renderPendingRun();
         return;
+    }
 
-    auto const pos = _gridMetrics.map(_cell.position);
+    // Collapse horizontally adjacent cells with the same background color
+    // into a single rectangle (the dominant case: whitespace runs, cursor
+    // lines, selections), so the vertex stream scales with the number of
+    // color changes rather than the number of cells.
+    if (pendingRun_.columnCount
+        && _cell.position.line == pendingRun_.startPosition.line
+        && *_cell.position.column == *pendingRun_.startPosition.column + pendingRun_.columnCount
+        && _cell.backgroundColor == pendingRun_.color)
+    {
+        ++pendingRun_.columnCount;
+        return;
+    }
+
+    renderPendingRun();
+    pendingRun_ = CellRun { _cell.position, 1, _cell.backgroundColor };
+}
+
+void BackgroundRenderer::finish()
+{
+    renderPendingRun();
+}
+
+void BackgroundRenderer::renderPendingRun()
+{
+    if (!pendingRun_.columnCount)
+        return;
+
+    auto const pos = _gridMetrics.map(pendingRun_.startPosition);
 
     renderTarget().renderRectangle(pos.x,
                                    pos.y,
-                                   _gridMetrics.cellSize.width,
+                                   Width::cast_from(_gridMetrics.cellSize.width.as<int>()
+                                                    * pendingRun_.columnCount),
                                    _gridMetrics.cellSize.height,
-                                   RGBAColor(_cell.backgroundColor, opacity_));
+                                   RGBAColor(pendingRun_.color, opacity_));
+
+    pendingRun_.columnCount = 0;
 }
 
 void BackgroundRenderer::inspect(std::ostream& /*output*/) const
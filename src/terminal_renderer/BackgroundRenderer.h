@@ -45,12 +45,29 @@ class BackgroundRenderer: public Renderable
     /// Queues up a render with given background
     void renderCell(RenderCell const& _cell);
 
+    /// Flushes the pending background run; must be invoked after the last
+    /// renderCell() call of a frame.
+    void finish();
+
     void inspect(std::ostream& output) const override;
 
   private:
+    void renderPendingRun();
+
     // private data
     RGBColor const& defaultColor_;
     uint8_t opacity_ = 255;
+
+    // Horizontal run of adjacent cells sharing one background color,
+    // accumulated so that each run is rendered as a single rectangle
+    // rather than one rectangle per cell.
+    struct CellRun
+    {
+        CellLocation startPosition {};
+        int columnCount = 0;
+        RGBColor color {};
+    };
+    CellRun pendingRun_ {};
 };
 
 } // namespace terminal::renderer
@@ -15,6 +15,8 @@
 #include <terminal_renderer/Pixmap.h>
 #include <terminal_renderer/utils.h>
 
+#include <crispy/StrongHash.h>
+#include <crispy/StrongLRUHashtable.h>
 #include <crispy/logstore.h>
 
 #include <fmt/format.h>
@@ -24,6 +26,7 @@
 #include <range/v3/view/zip.hpp>
 
 #include <array>
+#include <mutex>
 
 using namespace std::string_view_literals;
 
@@ -420,6 +423,23 @@ namespace detail
             }
         }
 
+        // Fast path for the constant filler: each scanline is one contiguous byte
+        // run, so the fill vectorizes instead of invoking the filler per pixel.
+        template <typename Container>
+        constexpr void fillBlock(Container& image, ImageSize size, Ratio from, Ratio to)
+        {
+            auto const h = unbox<int>(size.height) - 1;
+            auto const x0 = int(unbox<double>(size.width) * from.x);
+            auto const x1 = int(unbox<double>(size.width) * to.x);
+            if (x1 <= x0)
+                return;
+
+            for (auto y = int(unbox<double>(size.height) * from.y);
+                 y < int(unbox<double>(size.height) * to.y);
+                 ++y)
+                std::fill_n(&image[(h - y) * *size.width + x0], x1 - x0, uint8_t(0xFF));
+        }
+
         template <size_t N, Inverted Inv>
         auto checker(ImageSize size)
         {
@@ -638,6 +658,34 @@ namespace detail
             return pixmap.take();
         };
 
+        enum class LeftOrRight
+        {
+            Left,
+            Right
+        };
+
+        // Powerline solid arrows (U+E0B0, U+E0B2): the full cell edge as base
+        // and the apex centered on the opposite edge. Unlike the legacy
+        // computing triangles above (whose apex sits at the cell center), the
+        // apex reaches the far edge so the separator closes seamlessly
+        // against the neighbour cell's background.
+        inline atlas::Buffer powerlineArrow(ImageSize size, LeftOrRight pointing)
+        {
+            auto pixmap = blockElement<2>(size);
+            auto const w = unbox<int>(pixmap._size.width) - 1;
+            auto const h = unbox<int>(pixmap._size.height) - 1;
+            auto const base = pointing == LeftOrRight::Right ? 0 : w;
+            auto const apex = Point { w - base, h / 2 };
+            auto const f = linearEq(Point { base, 0 }, apex);
+            auto const g = linearEq(Point { base, h }, apex);
+            auto const fullWidth = unbox<int>(pixmap._size.width);
+            for (auto const y: ranges::views::iota(0, unbox<int>(pixmap._size.height)))
+                for (auto const x: ranges::views::iota(0, fullWidth))
+                    if (min(f(x), g(x)) <= y && y <= max(f(x), g(x)))
+                        pixmap._buffer[(h - y) * fullWidth + x] = 0xFF;
+            return pixmap.take();
+        }
+
         enum class UpperOrLower
         {
             Upper,
@@ -680,14 +728,20 @@ namespace detail
 
         atlas::Buffer operator|(Pixmap a, RatioBlock block)
         {
-            fillBlock(a._buffer, a._size, block.from, block.to, a._filler);
+            if (a._fillerIsConstant)
+                fillBlock(a._buffer, a._size, block.from, block.to);
+            else
+                fillBlock(a._buffer, a._size, block.from, block.to, a._filler);
             return std::move(a._buffer);
         }
 
         atlas::Buffer operator|(Pixmap a, MosaicBlock const& b)
         {
             for (RatioBlock block: b.blocks)
-                fillBlock(a._buffer, a._size, block.from, block.to, a._filler);
+                if (a._fillerIsConstant)
+                    fillBlock(a._buffer, a._size, block.from, block.to);
+                else
+                    fillBlock(a._buffer, a._size, block.from, block.to, a._filler);
             return std::move(a._buffer);
         }
 
@@ -734,7 +788,10 @@ namespace detail
 
         inline Pixmap operator*(Pixmap&& image, RatioBlock block)
         {
-            fillBlock(image._buffer, image._size, block.from, block.to, image._filler);
+            if (image._fillerIsConstant)
+                fillBlock(image._buffer, image._size, block.from, block.to);
+            else
+                fillBlock(image._buffer, image._size, block.from, block.to, image._filler);
             return std::move(image);
         }
 
@@ -818,13 +875,121 @@ void BoxDrawingRenderer::clearCache()
     // to clear here anything. It's done for us already.
 }
 
+namespace
+{
+    // {{{ procedural block elements
+    // The block elements (U+2580..U+259F) are axis-aligned rectangles by
+    // definition, so they skip rasterization and atlas storage entirely and
+    // are emitted as (at most two) solid rectangles straight into the
+    // rectangle pass instead - pixel-exact at every cell size with no CPU
+    // rasterization, no upload and no texture sampling. The shades
+    // (U+2591..U+2593) map to a full-cell rectangle carrying their fill
+    // ratio as alpha.
+
+    struct BlockRect
+    {
+        // bottom-left and top-right corner in cell-eighths, origin at the
+        // cell's bottom-left (matching the render target's coordinate system)
+        uint8_t x0, y0, x1, y1;
+    };
+
+    struct BlockElement
+    {
+        std::array<BlockRect, 2> rects {};
+        uint8_t rectCount = 0;
+        uint8_t alpha = 0xFF;
+    };
+
+    constexpr BlockElement blockElementDefinition(char32_t codepoint) noexcept
+    {
+        auto const one = [](BlockRect a) {
+            return BlockElement { { a, {} }, 1, 0xFF };
+        };
+        auto const two = [](BlockRect a, BlockRect b) {
+            return BlockElement { { a, b }, 2, 0xFF };
+        };
+        auto const shade = [](uint8_t alpha) {
+            return BlockElement { { BlockRect { 0, 0, 8, 8 }, {} }, 1, alpha };
+        };
+
+        switch (codepoint)
+        {
+        case 0x2580: return one({ 0, 4, 8, 8 });                  // ▀ UPPER HALF BLOCK
+        case 0x2581: return one({ 0, 0, 8, 1 });                  // ▁ LOWER ONE EIGHTH BLOCK
+        case 0x2582: return one({ 0, 0, 8, 2 });                  // ▂ LOWER ONE QUARTER BLOCK
+        case 0x2583: return one({ 0, 0, 8, 3 });                  // ▃ LOWER THREE EIGHTHS BLOCK
+        case 0x2584: return one({ 0, 0, 8, 4 });                  // ▄ LOWER HALF BLOCK
+        case 0x2585: return one({ 0, 0, 8, 5 });                  // ▅ LOWER FIVE EIGHTHS BLOCK
+        case 0x2586: return one({ 0, 0, 8, 6 });                  // ▆ LOWER THREE QUARTERS BLOCK
+        case 0x2587: return one({ 0, 0, 8, 7 });                  // ▇ LOWER SEVEN EIGHTHS BLOCK
+        case 0x2588: return one({ 0, 0, 8, 8 });                  // █ FULL BLOCK
+        case 0x2589: return one({ 0, 0, 7, 8 });                  // ▉ LEFT SEVEN EIGHTHS BLOCK
+        case 0x258A: return one({ 0, 0, 6, 8 });                  // ▊ LEFT THREE QUARTERS BLOCK
+        case 0x258B: return one({ 0, 0, 5, 8 });                  // ▋ LEFT FIVE EIGHTHS BLOCK
+        case 0x258C: return one({ 0, 0, 4, 8 });                  // ▌ LEFT HALF BLOCK
+        case 0x258D: return one({ 0, 0, 3, 8 });                  // ▍ LEFT THREE EIGHTHS BLOCK
+        case 0x258E: return one({ 0, 0, 2, 8 });                  // ▎ LEFT ONE QUARTER BLOCK
+        case 0x258F: return one({ 0, 0, 1, 8 });                  // ▏ LEFT ONE EIGHTH BLOCK
+        case 0x2590: return one({ 4, 0, 8, 8 });                  // ▐ RIGHT HALF BLOCK
+        case 0x2591: return shade(0x40);                          // ░ LIGHT SHADE
+        case 0x2592: return shade(0x80);                          // ▒ MEDIUM SHADE
+        case 0x2593: return shade(0xC0);                          // ▓ DARK SHADE
+        case 0x2594: return one({ 0, 7, 8, 8 });                  // ▔ UPPER ONE EIGHTH BLOCK
+        case 0x2595: return one({ 7, 0, 8, 8 });                  // ▕ RIGHT ONE EIGHTH BLOCK
+        case 0x2596: return one({ 0, 0, 4, 4 });                  // ▖ QUADRANT LOWER LEFT
+        case 0x2597: return one({ 4, 0, 8, 4 });                  // ▗ QUADRANT LOWER RIGHT
+        case 0x2598: return one({ 0, 4, 4, 8 });                  // ▘ QUADRANT UPPER LEFT
+        case 0x2599: return two({ 0, 0, 4, 8 }, { 4, 0, 8, 4 }); // ▙ QUADRANT UPPER LEFT AND LOWER LEFT AND LOWER RIGHT
+        case 0x259A: return two({ 0, 4, 4, 8 }, { 4, 0, 8, 4 }); // ▚ QUADRANT UPPER LEFT AND LOWER RIGHT
+        case 0x259B: return two({ 0, 4, 8, 8 }, { 0, 0, 4, 4 }); // ▛ QUADRANT UPPER LEFT AND UPPER RIGHT AND LOWER LEFT
+        case 0x259C: return two({ 0, 4, 8, 8 }, { 4, 0, 8, 4 }); // ▜ QUADRANT UPPER LEFT AND UPPER RIGHT AND LOWER RIGHT
+        case 0x259D: return one({ 4, 4, 8, 8 });                  // ▝ QUADRANT UPPER RIGHT
+        case 0x259E: return two({ 4, 4, 8, 8 }, { 0, 0, 4, 4 }); // ▞ QUADRANT UPPER RIGHT AND LOWER LEFT
+        case 0x259F: return two({ 4, 4, 8, 8 }, { 0, 0, 8, 4 }); // ▟ QUADRANT UPPER RIGHT AND LOWER LEFT AND LOWER RIGHT
+        }
+        return {};
+    }
+    // }}}
+} // namespace
+
+bool BoxDrawingRenderer::renderProcedural(Point _pos, char32_t _codepoint, RGBColor _color)
+{
+    auto const def = blockElementDefinition(_codepoint);
+    if (!def.rectCount)
+        return false;
+
+    auto const w = _gridMetrics.cellSize.width.as<int>();
+    auto const h = _gridMetrics.cellSize.height.as<int>();
+
+    for (uint8_t i = 0; i < def.rectCount; ++i)
+    {
+        auto const& rect = def.rects[i];
+        // Corner coordinates (not extents) are scaled, so adjacent cells and
+        // complementary elements tile seamlessly regardless of rounding.
+        auto const x0 = w * rect.x0 / 8;
+        auto const x1 = w * rect.x1 / 8;
+        auto const y0 = h * rect.y0 / 8;
+        auto const y1 = h * rect.y1 / 8;
+        renderTarget().renderRectangle(_pos.x + x0,
+                                       _pos.y + y0,
+                                       Width::cast_from(x1 - x0),
+                                       Height::cast_from(y1 - y0),
+                                       RGBAColor(_color, def.alpha));
+    }
+    return true;
+}
+
 bool BoxDrawingRenderer::render(LineOffset _line, ColumnOffset _column, char32_t _codepoint, RGBColor _color)
 {
+    auto const pos = _gridMetrics.map(_line, _column);
+
+    if (renderProcedural(pos, _codepoint, _color))
+        return true;
+
     Renderable::AtlasTileAttributes const* data = getOrCreateCachedTileAttributes(_codepoint);
     if (!data)
         return false;
 
-    auto const pos = _gridMetrics.map(_line, _column);
     auto const x = pos.x;
     auto const y = pos.y;
 
@@ -836,7 +1001,7 @@ bool BoxDrawingRenderer::render(LineOffset _line, ColumnOffset _column, char32_t
     renderTile.normalizedLocation = data->metadata.normalizedLocation;
     renderTile.tileLocation = data->location;
 
-    textureScheduler().renderTile(renderTile);
+    commandList().renderTile(renderTile);
     return true;
 }
 
@@ -848,20 +1013,64 @@ constexpr inline bool containsNonCanonicalLines(char32_t codepoint)
     return box.diagonal_ != detail::NoDiagonal || box.arc_ != NoArc;
 }
 
+namespace
+{
+    // Rasterized pixmaps only depend on (codepoint, cell size, line thickness),
+    // so all renderer instances - one per terminal window - share one
+    // process-wide cache instead of each rasterizing its own set.
+    std::mutex pixmapCacheMutex;
+
+    crispy::StrongLRUHashtable<atlas::Buffer>& pixmapCache()
+    {
+        static auto cache = crispy::StrongLRUHashtable<atlas::Buffer>::create(
+            crispy::StrongHashtableSize { 4096 }, crispy::LRUCapacity { 1024 }, "BoxDrawing pixmaps");
+        return *cache;
+    }
+} // namespace
+
 auto BoxDrawingRenderer::createTileData(char32_t codepoint, atlas::TileLocation tileLocation)
     -> optional<TextureAtlas::TileCreateData>
 {
-    if (optional<atlas::Buffer> image = buildElements(codepoint))
+    auto const toTileData = [&](atlas::Buffer pixels) -> TextureAtlas::TileCreateData {
+        return createTileData(tileLocation,
+                              move(pixels),
+                              atlas::Format::Red,
+                              _gridMetrics.cellSize,
+                              RenderTileAttributes::X { 0 },
+                              RenderTileAttributes::Y { 0 },
+                              FRAGMENT_SELECTOR_GLYPH_ALPHA);
+    };
+
+    auto hashBuilder = crispy::StrongHashBuilder {};
+    hashBuilder.update(static_cast<uint32_t>(codepoint));
+    hashBuilder.update(_gridMetrics.cellSize.width.value);
+    hashBuilder.update(_gridMetrics.cellSize.height.value);
+    hashBuilder.update(_gridMetrics.underline.thickness);
+    auto const key = hashBuilder.finalize();
+
+    {
+        auto const _ = std::lock_guard { pixmapCacheMutex };
+        if (auto* cached = pixmapCache().try_get(key))
+            return { toTileData(*cached) };
+    }
+
+    optional<atlas::Buffer> pixels = rasterizePixmap(codepoint);
+    if (!pixels)
+        return nullopt;
+
     {
-        return { createTileData(tileLocation,
-                                move(*image),
-                                atlas::Format::Red,
-                                _gridMetrics.cellSize,
-                                RenderTileAttributes::X { 0 },
-                                RenderTileAttributes::Y { 0 },
-                                FRAGMENT_SELECTOR_GLYPH_ALPHA) };
+        auto const _ = std::lock_guard { pixmapCacheMutex };
+        pixmapCache()[key] = *pixels;
     }
 
+    return { toTileData(move(*pixels)) };
+}
+
+optional<atlas::Buffer> BoxDrawingRenderer::rasterizePixmap(char32_t codepoint)
+{
+    if (optional<atlas::Buffer> image = buildElements(codepoint))
+        return image;
+
     auto const antialiasing = containsNonCanonicalLines(codepoint);
     atlas::Buffer pixels;
     if (antialiasing)
@@ -892,13 +1101,7 @@ auto BoxDrawingRenderer::createTileData(char32_t codepoint, atlas::TileLocation
         pixels = move(*tmp);
     }
 
-    return { createTileData(tileLocation,
-                            move(pixels),
-                            atlas::Format::Red,
-                            _gridMetrics.cellSize,
-                            RenderTileAttributes::X { 0 },
-                            RenderTileAttributes::Y { 0 },
-                            FRAGMENT_SELECTOR_GLYPH_ALPHA) };
+    return { move(pixels) };
 }
 
 Renderable::AtlasTileAttributes const* BoxDrawingRenderer::getOrCreateCachedTileAttributes(char32_t codepoint)
@@ -918,10 +1121,13 @@ bool BoxDrawingRenderer::renderable(char32_t codepoint) const noexcept
 
     return ascending(0x23A1, 0x23A6)      // mathematical square brackets
            || ascending(0x2500, 0x2590)   // box drawing, block elements
+           || ascending(0x2591, 0x2593)   // shades (procedural rectangles)
            || ascending(0x2594, 0x259F)   // Terminal graphic characters
            || ascending(0x1FB00, 0x1FBAF) // more block sextants
            || ascending(0x1FBF0, 0x1FBF9) // digits
-           || codepoint == 0xE0B4 || codepoint == 0xE0B6 || codepoint == 0xE0BC || codepoint == 0xE0BE;
+           || ascending(0xE0B0, 0xE0B4)  // powerline arrows, rounded right cap
+           || codepoint == 0xE0B6        // powerline rounded left cap
+           || ascending(0xE0B8, 0xE0BF); // powerline diagonals
 }
 
 optional<atlas::Buffer> BoxDrawingRenderer::buildElements(char32_t codepoint)
@@ -1384,10 +1590,23 @@ optional<atlas::Buffer> BoxDrawingRenderer::buildElements(char32_t codepoint)
         return segmentArt().segment_bar(1, 2, 3, 4, 5, 6);
         // }}}
 
+    // {{{ E0B0..E0BF powerline symbols
+    case 0xE0B0: return /*  */ powerlineArrow(size, LeftOrRight::Right);
+    case 0xE0B1: return /*  */ lineArt().line({ 0, 0 }, { 1, 1 / 2_th }).line({ 1, 1 / 2_th }, { 0, 1 });
+    case 0xE0B2: return /*  */ powerlineArrow(size, LeftOrRight::Left);
+    case 0xE0B3: return /*  */ lineArt().line({ 1, 0 }, { 0, 1 / 2_th }).line({ 0, 1 / 2_th }, { 1, 1 });
     case 0xE0B4: return /*  */ blockElement<2>(size).halfFilledCircleRight();
     case 0xE0B6: return /*  */ blockElement<2>(size).halfFilledCircleLeft();
+    case 0xE0B8: return /*  */ ld({ 0, 0 }, { 1, 1 });
+    case 0xE0B9: return /*  */ lineArt().line({ 0, 0 }, { 1, 1 });
+    case 0xE0BA: return /*  */ ld({ 0, 1 }, { 1, 0 });
+    case 0xE0BB: return /*  */ lineArt().line({ 0, 1 }, { 1, 0 });
     case 0xE0BC: return /*  */ ud({ 0, 1 }, { 1, 0 });
+    case 0xE0BD: return /*  */ lineArt().line({ 0, 1 }, { 1, 0 });
     case 0xE0BE: return /*  */ ud({ 0, 0 }, { 1, 1 });
+    case 0xE0BF:
+        return /*  */ lineArt().line({ 0, 0 }, { 1, 1 });
+        // }}}
     }
 
     return nullopt;
@@ -53,12 +53,24 @@ class BoxDrawingRenderer: public Renderable
     void inspect(std::ostream& output) const override;
 
   private:
+    /// Renders the analytically rectangular block elements (U+2580..U+259F)
+    /// directly as solid rectangles into the rectangle pass, bypassing
+    /// rasterization and atlas storage entirely.
+    ///
+    /// @returns true if the codepoint was drawn procedurally, false if it
+    ///          must go through the rasterized atlas tile path.
+    bool renderProcedural(crispy::Point _pos, char32_t _codepoint, RGBColor _color);
+
     AtlasTileAttributes const* getOrCreateCachedTileAttributes(char32_t codepoint);
 
     using Renderable::createTileData;
     std::optional<TextureAtlas::TileCreateData> createTileData(char32_t codepoint,
                                                                atlas::TileLocation tileLocation);
 
+    /// Rasterizes the pixmap for the given codepoint with respect to the current
+    /// grid metrics, bypassing the process-wide pixmap cache.
+    std::optional<atlas::Buffer> rasterizePixmap(char32_t codepoint);
+
     std::optional<atlas::Buffer> buildBoxElements(char32_t codepoint, ImageSize _size, int _lineThickness);
     std::optional<atlas::Buffer> buildElements(char32_t codepoint);
 };
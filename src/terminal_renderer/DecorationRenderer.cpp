@@ -53,6 +53,32 @@ DecorationRenderer::DecorationRenderer(GridMetrics const& _gridMetrics,
 
 constexpr inline uint32_t DirectMappedDecorationCount = std::numeric_limits<Decorator>::count();
 
+constexpr inline auto DecoratorMappings = array {
+    pair { CellFlags::Underline, Decorator::Underline },
+    pair { CellFlags::DoublyUnderlined, Decorator::DoubleUnderline },
+    pair { CellFlags::CurlyUnderlined, Decorator::CurlyUnderline },
+    pair { CellFlags::DottedUnderline, Decorator::DottedUnderline },
+    pair { CellFlags::DashedUnderline, Decorator::DashedUnderline },
+    pair { CellFlags::Overline, Decorator::Overline },
+    pair { CellFlags::CrossedOut, Decorator::CrossedOut },
+    pair { CellFlags::Framed, Decorator::Framed },
+    pair { CellFlags::Encircled, Decorator::Encircle },
+};
+
+// The mappings must cover exactly the flags classified as decorations.
+static_assert([]() constexpr {
+    auto flags = CellFlags::None;
+    for (auto const& mapping: DecoratorMappings)
+        flags |= mapping.first;
+    return flags == DecorationFlagsMask;
+}());
+
+constexpr CellFlags decorationFlags(CellFlags _flags) noexcept
+{
+    _flags &= DecorationFlagsMask;
+    return _flags;
+}
+
 void DecorationRenderer::setRenderTarget(RenderTarget& renderTarget,
                                          DirectMappingAllocator& directMappingAllocator)
 {
@@ -90,21 +116,49 @@ void DecorationRenderer::inspect(std::ostream& /*output*/) const
 
 void DecorationRenderer::renderCell(RenderCell const& _cell)
 {
-    auto constexpr mappings = array {
-        pair { CellFlags::Underline, Decorator::Underline },
-        pair { CellFlags::DoublyUnderlined, Decorator::DoubleUnderline },
-        pair { CellFlags::CurlyUnderlined, Decorator::CurlyUnderline },
-        pair { CellFlags::DottedUnderline, Decorator::DottedUnderline },
-        pair { CellFlags::DashedUnderline, Decorator::DashedUnderline },
-        pair { CellFlags::Overline, Decorator::Overline },
-        pair { CellFlags::CrossedOut, Decorator::CrossedOut },
-        pair { CellFlags::Framed, Decorator::Framed },
-        pair { CellFlags::Encircled, Decorator::Encircle },
-    };
+    auto const flags = decorationFlags(_cell.flags);
+    if (flags == CellFlags::None)
+    {
+        renderPendingRun();
+        return;
+    }
+
+    // Collapse horizontally adjacent cells carrying the same decoration set
+    // and color into a single run (the dominant case: underlined words and
+    // hyperlinks), so each decoration is emitted once per run instead of
+    // once per cell.
+    if (pendingRun_.columnCount
+        && _cell.position.line == pendingRun_.startPosition.line
+        && *_cell.position.column == *pendingRun_.startPosition.column + pendingRun_.columnCount
+        && flags == pendingRun_.decorationFlags
+        && _cell.decorationColor == pendingRun_.color)
+    {
+        ++pendingRun_.columnCount;
+        return;
+    }
 
-    for (auto const& mapping: mappings)
-        if (_cell.flags & mapping.first)
-            renderDecoration(mapping.second, _gridMetrics.map(_cell.position), 1, _cell.decorationColor);
+    renderPendingRun();
+    pendingRun_ = DecorationRun { _cell.position, 1, flags, _cell.decorationColor };
+}
+
+void DecorationRenderer::finish()
+{
+    renderPendingRun();
+}
+
+void DecorationRenderer::renderPendingRun()
+{
+    if (!pendingRun_.columnCount)
+        return;
+
+    for (auto const& mapping: DecoratorMappings)
+        if (pendingRun_.decorationFlags & mapping.first)
+            renderDecoration(mapping.second,
+                             _gridMetrics.map(pendingRun_.startPosition),
+                             pendingRun_.columnCount,
+                             pendingRun_.color);
+
+    pendingRun_.columnCount = 0;
 }
 
 auto DecorationRenderer::createTileData(Decorator decoration, atlas::TileLocation tileLocation)
@@ -286,14 +340,17 @@ void DecorationRenderer::renderDecoration(Decorator decoration,
                                           int columnCount,
                                           RGBColor const& color)
 {
+    // The decoration's bitmap was already rasterized into its direct-mapped
+    // atlas tile in initializeDirectMapping(); emitting a run is purely one
+    // cell-sized instance per column. The tile (not a run-wide quad) remains
+    // the instancing unit so that patterned decorations (curly, dotted,
+    // dashed) keep their per-cell period.
+    auto const tileIndex = _directMapping.toTileIndex(static_cast<uint32_t>(decoration));
+    AtlasTileAttributes const& tileAttributes = _textureAtlas->directMapped(tileIndex);
+    auto const cellWidth = unbox<int>(_gridMetrics.cellSize.width);
+
     for (int i = 0; i < columnCount; ++i)
-    {
-        auto const tileIndex = _directMapping.toTileIndex(static_cast<uint32_t>(decoration));
-        auto const tileLocation = _textureAtlas->tileLocation(tileIndex);
-        TextureAtlas::TileCreateData tileData = createTileData(decoration, tileLocation);
-        AtlasTileAttributes const& tileAttributes = _textureAtlas->directMapped(tileIndex);
-        renderTile({ pos.x }, { pos.y }, color, tileAttributes);
-    }
+        renderTile({ pos.x + i * cellWidth }, { pos.y }, color, tileAttributes);
 }
 
 } // namespace terminal::renderer
@@ -49,8 +49,14 @@ class DecorationRenderer: public Renderable
         hyperlinkHover_ = _hover;
     }
 
+    /// Queues up the given cell's decorations, extending the pending
+    /// decoration run if the cell continues it.
     void renderCell(RenderCell const& _cell);
 
+    /// Flushes the pending decoration run; must be invoked after the last
+    /// renderCell() call of a frame.
+    void finish();
+
     void renderDecoration(Decorator _decoration,
                           crispy::Point _pos,
                           int _columnCount,
@@ -64,6 +70,7 @@ class DecorationRenderer: public Renderable
 
   private:
     void initializeDirectMapping();
+    void renderPendingRun();
     using Renderable::createTileData;
     TextureAtlas::TileCreateData createTileData(Decorator decoration, atlas::TileLocation tileLocation);
 
@@ -72,6 +79,18 @@ class DecorationRenderer: public Renderable
     DirectMapping _directMapping;
     Decorator hyperlinkNormal_ = Decorator::DottedUnderline;
     Decorator hyperlinkHover_ = Decorator::Underline;
+
+    // Horizontal run of adjacent cells sharing one decoration set and color,
+    // accumulated so that each decoration is emitted once per run rather
+    // than looked up and emitted once per cell.
+    struct DecorationRun
+    {
+        CellLocation startPosition {};
+        int columnCount = 0;
+        CellFlags decorationFlags {};
+        RGBColor color {};
+    };
+    DecorationRun pendingRun_ {};
 };
 
 } // namespace terminal::renderer
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <terminal/CellFlags.h>
+
 #include <text_shaper/font.h>
 
 #include <crispy/point.h>
@@ -70,6 +72,22 @@ constexpr bool operator<(TextStyle a, TextStyle b) noexcept
     return static_cast<unsigned>(a) < static_cast<unsigned>(b);
 }
 
+/// Classifies a cell's style flags into the TextStyle (font face) rendering it.
+///
+/// TextStyle's low two bits mirror CellFlags::Bold (bit 0) and
+/// CellFlags::Italic (bit 2, shifted down), so the classification is a pure
+/// bit shuffle with no branches to mispredict on style changes.
+constexpr TextStyle makeTextStyle(CellFlags _flags) noexcept
+{
+    auto const bits = unsigned(terminal::underlying(_flags));
+    return static_cast<TextStyle>(0x10u | (bits & 1u) | ((bits >> 1) & 2u));
+}
+
+static_assert(makeTextStyle(CellFlags::None) == TextStyle::Regular);
+static_assert(makeTextStyle(CellFlags::Bold) == TextStyle::Bold);
+static_assert(makeTextStyle(CellFlags::Italic) == TextStyle::Italic);
+static_assert(makeTextStyle(CellFlags::Bold | CellFlags::Italic) == TextStyle::BoldItalic);
+
 } // namespace terminal::renderer
 
 // {{{ fmt formatter
@@ -42,6 +42,7 @@ void ImageRenderer::setRenderTarget(RenderTarget& renderTarget,
 void ImageRenderer::setCellSize(ImageSize _cellSize)
 {
     cellSize_ = _cellSize;
+    cachedImageId_.reset();
     // TODO: recompute rasterized images slices here?
 }
 
@@ -64,15 +65,27 @@ void ImageRenderer::renderImage(crispy::Point _pos, ImageFragment const& fragmen
 Renderable::AtlasTileAttributes const* ImageRenderer::getOrCreateCachedTileAttributes(
     ImageFragment const& fragment)
 {
-    // using crispy::StrongHash;
-    // auto const hash = StrongHash::compute(fragment.rasterizedImage().image().id().value)
-    //                   * fragment.offset().column.value * fragment.offset().line.value
-    //                   * fragment.rasterizedImage().cellSize().width.value
-    //                   * fragment.rasterizedImage().cellSize().height.value;
-    auto const key = ImageFragmentKey { fragment.rasterizedImage().image().id(),
-                                        fragment.offset(),
-                                        fragment.rasterizedImage().cellSize() };
-    auto const hash = crispy::StrongHash::compute(key);
+    // All fragments of one image share the image- and cell-size-dependent part
+    // of their tile key. A full-screen image spans thousands of cells per
+    // frame, so that part is hashed once per image and each fragment derives
+    // its tile hash from it - the same way multi-column glyphs address their
+    // subsequent tiles.
+    auto const imageId = fragment.rasterizedImage().image().id();
+    auto const cellSize = fragment.rasterizedImage().cellSize();
+    if (cachedImageId_ != imageId || cachedImageCellSize_ != cellSize)
+    {
+        auto builder = crispy::StrongHashBuilder {};
+        builder.update(imageId.value);
+        builder.update(cellSize.width.value);
+        builder.update(cellSize.height.value);
+        cachedImageBaseHash_ = builder.finalize();
+        cachedImageId_ = imageId;
+        cachedImageCellSize_ = cellSize;
+    }
+
+    auto const hash = cachedImageBaseHash_
+                      * static_cast<uint32_t>(fragment.offset().line.value + 1)
+                      * static_cast<uint32_t>(fragment.offset().column.value + 1);
 
     return textureAtlas().get_or_try_emplace(
         hash, [&](atlas::TileLocation tileLocation) -> optional<TextureAtlas::TileCreateData> {
@@ -96,6 +109,7 @@ void ImageRenderer::clearCache()
 {
     // We currently don't really clean up anything.
     // Because the GPU texture atlas is resource-guarded by an LRU hashtable.
+    cachedImageId_.reset();
 }
 
 void ImageRenderer::inspect(std::ostream& /*output*/) const
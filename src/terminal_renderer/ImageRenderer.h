@@ -18,36 +18,18 @@
 #include <terminal_renderer/RenderTarget.h>
 
 #include <crispy/FNV.h>
+#include <crispy/StrongHash.h>
 #include <crispy/point.h>
 #include <crispy/size.h>
 
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
 namespace terminal::renderer
 {
 
-// NB: Ensure this struct does NOT contain padding (or adapt strong hash creation).
-struct ImageFragmentKey
-{
-    ImageId const imageId;
-    CellLocation const offset;
-    ImageSize const size;
-
-    bool operator==(ImageFragmentKey const& b) const noexcept
-    {
-        return imageId == b.imageId && offset == b.offset && size == b.size;
-    }
-
-    bool operator!=(ImageFragmentKey const& b) const noexcept { return !(*this == b); }
-
-    bool operator<(ImageFragmentKey const& b) const noexcept
-    {
-        return (imageId < b.imageId) || (imageId == b.imageId && offset < b.offset);
-    }
-};
-
 /// Image Rendering API.
 ///
 /// Can render any arbitrary RGBA image (for example Sixel Graphics images).
@@ -76,6 +58,12 @@ class ImageRenderer: public Renderable
     // private data
     //
     ImageSize cellSize_;
+
+    // Memoized image-level part of the fragment tile hash; all fragments of
+    // the same image derive their per-cell tile hashes from it.
+    std::optional<ImageId> cachedImageId_;
+    ImageSize cachedImageCellSize_ {};
+    crispy::StrongHash cachedImageBaseHash_ {};
 };
 
 } // namespace terminal::renderer
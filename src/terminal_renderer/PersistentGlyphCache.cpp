@@ -0,0 +1,160 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <terminal_renderer/PersistentGlyphCache.h>
+
+#include <cstdint>
+#include <fstream>
+
+using std::ifstream;
+using std::nullopt;
+using std::ofstream;
+using std::optional;
+using std::vector;
+
+using namespace std::ios_base;
+
+namespace terminal::renderer
+{
+
+namespace
+{
+    constexpr uint32_t CacheMagic = 0x43474C59;  // "CGLY"
+    constexpr uint32_t CacheVersion = 1;
+    constexpr uint32_t MaxEntryCount = 0x1000;   // way above the direct-mapped range
+    constexpr uint64_t MaxBitmapByteCount = 1 << 24;
+
+    template <typename T>
+    void writePod(std::ostream& out, T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        out.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool readPod(std::istream& in, T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return static_cast<bool>(in);
+    }
+} // namespace
+
+PersistentGlyphCache::PersistentGlyphCache(FileSystem::path cacheDir): cacheDir_ { std::move(cacheDir) }
+{
+    auto ec = FileSystemError {};
+    FileSystem::create_directories(cacheDir_, ec);
+}
+
+FileSystem::path PersistentGlyphCache::filePathFor(crispy::StrongHash const& key) const
+{
+    return cacheDir_ / fmt::format("glyphs-{}.cache", crispy::to_string(key));
+}
+
+optional<vector<PersistentGlyphCache::Entry>> PersistentGlyphCache::load(crispy::StrongHash const& key) const
+{
+    auto in = ifstream(filePathFor(key).string(), binary);
+    if (!in)
+        return nullopt;
+
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint32_t entryCount = 0;
+    if (!readPod(in, magic) || !readPod(in, version) || !readPod(in, entryCount))
+        return nullopt;
+    if (magic != CacheMagic || version != CacheVersion || entryCount > MaxEntryCount)
+        return nullopt;
+
+    auto entries = vector<Entry> {};
+    entries.reserve(entryCount);
+    for (uint32_t i = 0; i < entryCount; ++i)
+    {
+        auto codepoint = uint32_t {};
+        auto glyphIndex = uint32_t {};
+        auto width = uint32_t {};
+        auto height = uint32_t {};
+        auto positionX = int32_t {};
+        auto positionY = int32_t {};
+        auto format = uint32_t {};
+        auto bitmapByteCount = uint64_t {};
+        if (!readPod(in, codepoint) || !readPod(in, glyphIndex) || !readPod(in, width)
+            || !readPod(in, height) || !readPod(in, positionX) || !readPod(in, positionY)
+            || !readPod(in, format) || !readPod(in, bitmapByteCount))
+            return nullopt;
+
+        if (format > static_cast<uint32_t>(text::bitmap_format::rgba))
+            return nullopt;
+
+        auto entry = Entry {};
+        entry.codepoint = static_cast<char32_t>(codepoint);
+        entry.glyph.index = text::glyph_index { glyphIndex };
+        entry.glyph.bitmapSize =
+            crispy::ImageSize { crispy::Width::cast_from(width), crispy::Height::cast_from(height) };
+        entry.glyph.position = crispy::Point { positionX, positionY };
+        entry.glyph.format = static_cast<text::bitmap_format>(format);
+
+        if (bitmapByteCount > MaxBitmapByteCount
+            || bitmapByteCount != text::pixel_size(entry.glyph.format) * uint64_t(width) * uint64_t(height))
+            return nullopt;
+
+        entry.glyph.bitmap.resize(static_cast<size_t>(bitmapByteCount));
+        in.read(reinterpret_cast<char*>(entry.glyph.bitmap.data()),
+                static_cast<std::streamsize>(bitmapByteCount));
+        if (!in || !entry.glyph.valid())
+            return nullopt;
+
+        entries.emplace_back(std::move(entry));
+    }
+
+    return { std::move(entries) };
+}
+
+void PersistentGlyphCache::save(crispy::StrongHash const& key, vector<Entry> const& entries) const
+{
+    auto const targetPath = filePathFor(key);
+    auto const temporaryPath = FileSystem::path(targetPath.string() + ".tmp");
+
+    {
+        auto out = ofstream(temporaryPath.string(), binary | trunc);
+        if (!out)
+            return;
+
+        writePod(out, CacheMagic);
+        writePod(out, CacheVersion);
+        writePod(out, static_cast<uint32_t>(entries.size()));
+
+        for (Entry const& entry: entries)
+        {
+            writePod(out, static_cast<uint32_t>(entry.codepoint));
+            writePod(out, static_cast<uint32_t>(entry.glyph.index.value));
+            writePod(out, unbox<uint32_t>(entry.glyph.bitmapSize.width));
+            writePod(out, unbox<uint32_t>(entry.glyph.bitmapSize.height));
+            writePod(out, static_cast<int32_t>(entry.glyph.position.x));
+            writePod(out, static_cast<int32_t>(entry.glyph.position.y));
+            writePod(out, static_cast<uint32_t>(entry.glyph.format));
+            writePod(out, static_cast<uint64_t>(entry.glyph.bitmap.size()));
+            out.write(reinterpret_cast<char const*>(entry.glyph.bitmap.data()),
+                      static_cast<std::streamsize>(entry.glyph.bitmap.size()));
+        }
+
+        if (!out)
+            return;
+    }
+
+    auto ec = FileSystemError {};
+    FileSystem::rename(temporaryPath, targetPath, ec);
+    if (ec)
+        FileSystem::remove(temporaryPath, ec);
+}
+
+} // namespace terminal::renderer
@@ -0,0 +1,60 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <text_shaper/shaper.h>
+
+#include <crispy/StrongHash.h>
+#include <crispy/stdfs.h>
+
+#include <optional>
+#include <vector>
+
+namespace terminal::renderer
+{
+
+/// Persists rasterized glyph bitmaps across runs, so a fresh process does
+/// not have to wait for FreeType to re-rasterize the direct-mapped US-ASCII
+/// range before the first frame can be painted.
+///
+/// One cache file is written per font configuration, identified by a
+/// StrongHash over font description, font size, DPI, and render mode,
+/// and stored below the given cache directory. A missing, truncated, or
+/// otherwise implausible file is treated as a cache miss; the caller then
+/// rasterizes as usual and rewrites the file.
+class PersistentGlyphCache
+{
+  public:
+    struct Entry
+    {
+        char32_t codepoint {};
+        text::rasterized_glyph glyph {};
+    };
+
+    explicit PersistentGlyphCache(FileSystem::path cacheDir);
+
+    /// Loads all previously saved glyphs for the given cache key,
+    /// or std::nullopt if no usable cache file exists.
+    [[nodiscard]] std::optional<std::vector<Entry>> load(crispy::StrongHash const& key) const;
+
+    /// Atomically (re)writes the cache file for the given cache key.
+    void save(crispy::StrongHash const& key, std::vector<Entry> const& entries) const;
+
+  private:
+    FileSystem::path filePathFor(crispy::StrongHash const& key) const;
+
+    FileSystem::path cacheDir_;
+};
+
+} // namespace terminal::renderer
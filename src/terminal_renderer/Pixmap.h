@@ -189,6 +189,9 @@ struct Pixmap
     std::function<int(int, int)> _filler = [](int, int) {
         return 0xFF;
     };
+    // Most pixmaps use the default constant filler; flagging that enables
+    // row-contiguous (vectorizable) fills instead of per-pixel filler calls.
+    bool _fillerIsConstant = true;
     int _lineThickness = 1;
     int _baseLine = 0; // baseline position relative to cell bottom.
 
@@ -212,7 +215,15 @@ struct Pixmap
     template <typename... More>
     Pixmap& segment_bar(int which, More... more);
 
-    Pixmap& fill() { return fill(_filler); }
+    Pixmap& fill()
+    {
+        if (_fillerIsConstant)
+        {
+            std::fill(_buffer.begin(), _buffer.end(), uint8_t(0xFF));
+            return *this;
+        }
+        return fill(_filler);
+    }
     template <typename F>
     Pixmap& fill(F const& filler);
 
@@ -238,6 +249,7 @@ Pixmap blockElement(ImageSize size, F f)
 {
     auto p = blockElement<N>(size);
     p._filler = f;
+    p._fillerIsConstant = false;
     return p;
 }
 
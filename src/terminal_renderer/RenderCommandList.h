@@ -0,0 +1,126 @@
+/**
+ * This file is part of the "libterminal" project
+ *   Copyright (c) 2019-2021 Christian Parpart <christian@parpart.family>
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <terminal/Color.h>
+#include <terminal/primitives.h>
+
+#include <terminal_renderer/TextureAtlas.h>
+
+#include <optional>
+#include <vector>
+
+namespace terminal::renderer
+{
+
+/// Backend-neutral, retained list of one frame's render commands.
+///
+/// Render subsystems record their commands into this list (it implements
+/// atlas::AtlasBackend, so it directly serves as the texture scheduler) and a
+/// GPU backend consumes the list wholesale in RenderTarget::execute() - either
+/// by replaying it against an immediate-mode API (OpenGL) or by translating it
+/// into pre-recorded native command buffers (Vulkan/Metal, future).
+///
+/// Being final and concrete, the per-cell recording calls below devirtualize;
+/// the backend is only entered once per frame, not once per draw.
+class RenderCommandList final: public atlas::AtlasBackend
+{
+  public:
+    /// Command structure for filling an axis-aligned rectangle with a solid color.
+    struct FillRectangle
+    {
+        int x;
+        int y;
+        crispy::Width width;
+        crispy::Height height;
+        RGBAColor color;
+    };
+
+    /// Vertical pixel span, bottom-left origin (matching the projection the
+    /// vertex data is generated for).
+    struct VerticalSpan
+    {
+        int y;
+        crispy::Height height;
+    };
+
+    // {{{ recording API
+    ImageSize atlasSize() const noexcept override { return atlasSize_; }
+
+    void configureAtlas(atlas::ConfigureAtlas _atlas) override
+    {
+        pendingAtlasConfig.emplace(_atlas);
+        atlasSize_ = _atlas.size;
+    }
+
+    void uploadTile(atlas::UploadTile _tile) override { uploadTiles.emplace_back(std::move(_tile)); }
+
+    void renderTile(atlas::RenderTile _tile) override { renderTiles.emplace_back(_tile); }
+
+    void fillRectangle(int _x, int _y, crispy::Width _width, crispy::Height _height, RGBAColor _color)
+    {
+        rectangles.push_back(FillRectangle { _x, _y, _width, _height, _color });
+    }
+    // }}}
+
+    // {{{ recorded commands, consumed by the backend in recording order
+    /// Fills the whole render target (or the damage span, if any) with the
+    /// given color before any other command executes.
+    std::optional<RGBAColor> clearColor = std::nullopt;
+
+    /// Vertical region this frame's commands may produce pixels in; everything
+    /// outside is guaranteed unchanged relative to the previously executed
+    /// frame. std::nullopt means the whole render target must be composed.
+    ///
+    /// Backends holding on to the previous frame's pixels may clip clears and
+    /// draws to this span and present only the changed region.
+    std::optional<VerticalSpan> damage = std::nullopt;
+
+    /// Vertical self-blit of the retained render target to be applied before
+    /// any other command: the pixels inside the source span move by
+    /// pixelDelta (bottom-left origin, positive = up). Emitted on viewport
+    /// scrolls, where the rows outside the damage span are unchanged only
+    /// relative to their shifted position. A backend that cannot perform the
+    /// blit must also disregard the damage span and compose the whole frame.
+    struct ScrollBlit
+    {
+        VerticalSpan source;
+        int pixelDelta;
+    };
+    std::optional<ScrollBlit> scroll = std::nullopt;
+
+    std::optional<atlas::ConfigureAtlas> pendingAtlasConfig = std::nullopt;
+    std::vector<atlas::UploadTile> uploadTiles {};
+    std::vector<atlas::RenderTile> renderTiles {};
+    std::vector<FillRectangle> rectangles {};
+    // }}}
+
+    void clear()
+    {
+        clearColor.reset();
+        damage.reset();
+        scroll.reset();
+        pendingAtlasConfig.reset();
+        uploadTiles.clear();
+        renderTiles.clear();
+        rectangles.clear();
+        // NB: atlasSize_ intentionally survives; it describes the current
+        // atlas, not this frame's commands.
+    }
+
+  private:
+    ImageSize atlasSize_ {};
+};
+
+} // namespace terminal::renderer
@@ -26,7 +26,7 @@ Renderable::Renderable(GridMetrics const& gridMetrics): _gridMetrics { gridMetri
 void Renderable::setRenderTarget(RenderTarget& renderTarget, DirectMappingAllocator& directMappingAllocator)
 {
     _renderTarget = &renderTarget;
-    _textureScheduler = &_renderTarget->textureScheduler();
+    _commandList = &_renderTarget->commandList();
     _directMappingAllocator = &directMappingAllocator;
 }
 
@@ -40,7 +40,7 @@ auto Renderable::createTileData(atlas::TileLocation tileLocation,
 {
     // clang-format off
     auto tileData = TextureAtlas::TileCreateData {};
-    auto const atlasSize = _textureScheduler->atlasSize();
+    auto const atlasSize = _commandList->atlasSize();
     Require(!!atlasSize.width);
     Require(!!atlasSize.height);
     Require(bitmap.size() == bitmapSize.area() * atlas::element_count(bitmapFormat));
@@ -102,5 +102,5 @@ void Renderable::renderTile(atlas::RenderTile::X x,
     renderTile.color = atlas::normalize(color);
     renderTile.normalizedLocation = attributes.metadata.normalizedLocation;
     renderTile.tileLocation = attributes.location;
-    textureScheduler().renderTile(renderTile);
+    commandList().renderTile(renderTile);
 }
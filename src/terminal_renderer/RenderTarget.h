@@ -18,6 +18,7 @@
 #include <terminal/primitives.h>
 
 #include <terminal_renderer/GridMetrics.h>
+#include <terminal_renderer/RenderCommandList.h>
 #include <terminal_renderer/TextureAtlas.h>
 #include <terminal_renderer/shared_defines.h>
 
@@ -37,6 +38,18 @@ struct BackgroundImage;
 namespace terminal::renderer
 {
 
+/// Pixel format of the output surface a render target composes into.
+///
+/// Deep formats carry the palette's resolved colors through blending at more
+/// than 8 bits per channel, so HDR/10-bit displays are fed directly - without
+/// a full-screen post-conversion blit per frame.
+enum class PixelFormat
+{
+    RGBA8,   //!< classic 8 bits per channel
+    RGB10A2, //!< 10-bit color channels, 2-bit alpha
+    RGBA16F  //!< half-float channels (scRGB-style HDR surfaces)
+};
+
 /**
  * Contains the read-out of the state of an texture atlas.
  */
@@ -111,7 +124,9 @@ class RenderTarget
 
     virtual void setMargin(PageMargin _margin) = 0;
 
-    virtual atlas::AtlasBackend& textureScheduler() = 0;
+    /// Accesses the backend-neutral command list all render commands of the
+    /// current frame are recorded into and that execute() consumes.
+    virtual RenderCommandList& commandList() noexcept = 0;
 
     virtual void setBackgroundImage(
         std::shared_ptr<terminal::BackgroundImage const> const& _backgroundImage) = 0;
@@ -128,6 +143,12 @@ class RenderTarget
     /// Clears the target surface with the given fill color.
     virtual void clear(terminal::RGBAColor _fillColor) = 0;
 
+    /// Sets a translucent color to be blended over the finished frame
+    /// (visual bell flash, inactive-window dimming). Applied entirely in the
+    /// backend's output pass - neither the render buffer nor the grid are
+    /// involved. An alpha of zero disables the tint.
+    virtual void setFrameTint(RGBAColor _tint) = 0;
+
     /// Executes all previously scheduled render commands.
     virtual void execute() = 0;
 
@@ -194,7 +215,7 @@ class Renderable
         return *_textureAtlas;
     }
 
-    atlas::AtlasBackend& textureScheduler() noexcept { return *_textureScheduler; }
+    RenderCommandList& commandList() noexcept { return *_commandList; }
 
     virtual void inspect(std::ostream& output) const = 0;
 
@@ -203,7 +224,7 @@ class Renderable
     RenderTarget* _renderTarget = nullptr;
     TextureAtlas* _textureAtlas = nullptr;
     atlas::DirectMappingAllocator<RenderTileAttributes>* _directMappingAllocator = nullptr;
-    atlas::AtlasBackend* _textureScheduler = nullptr;
+    RenderCommandList* _commandList = nullptr;
 };
 
 } // namespace terminal::renderer
@@ -211,6 +232,27 @@ class Renderable
 // {{{ fmt
 namespace fmt
 {
+template <>
+struct formatter<terminal::renderer::PixelFormat>
+{
+    template <typename ParseContext>
+    constexpr auto parse(ParseContext& ctx)
+    {
+        return ctx.begin();
+    }
+    template <typename FormatContext>
+    auto format(terminal::renderer::PixelFormat value, FormatContext& ctx)
+    {
+        switch (value)
+        {
+        case terminal::renderer::PixelFormat::RGBA8: return format_to(ctx.out(), "RGBA8");
+        case terminal::renderer::PixelFormat::RGB10A2: return format_to(ctx.out(), "RGB10A2");
+        case terminal::renderer::PixelFormat::RGBA16F: return format_to(ctx.out(), "RGBA16F");
+        }
+        return format_to(ctx.out(), "({})", static_cast<unsigned>(value));
+    }
+};
+
 template <>
 struct formatter<terminal::renderer::RenderTileAttributes>
 {
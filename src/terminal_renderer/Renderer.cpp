@@ -18,6 +18,10 @@
 #include <text_shaper/font_locator.h>
 #include <text_shaper/open_shaper.h>
 
+#include <crispy/PerfCounters.h>
+
+#include <unicode/convert.h>
+
 #if defined(_WIN32)
     #include <text_shaper/directwrite_shaper.h>
 #endif
@@ -122,11 +126,13 @@ Renderer::Renderer(PageSize pageSize,
                    crispy::StrongHashtableSize atlasHashtableSlotCount,
                    crispy::LRUCapacity atlasTileCount,
                    bool atlasDirectMapping,
+                   size_t maxTextureMemory,
                    Decorator hyperlinkNormal,
                    Decorator hyperlinkHover):
     _atlasHashtableSlotCount { crispy::detail::nextPowerOfTwo(atlasHashtableSlotCount.value) },
     _atlasTileCount { std::max(atlasTileCount.value, static_cast<uint32_t>(pageSize.area())) },
     _atlasDirectMapping { atlasDirectMapping },
+    _maxTextureMemory { maxTextureMemory },
     _renderTarget { nullptr },
     //.
     fontDescriptions_ { fontDescriptions },
@@ -193,12 +199,33 @@ void Renderer::configureTextureAtlas()
 
     Require(atlasProperties.tileCount.value > 0);
 
-    textureAtlas_ = make_unique<Renderable::TextureAtlas>(_renderTarget->textureScheduler(), atlasProperties);
+    // GPU memory budgeting: clamp the tile count while the resulting atlas
+    // texture would exceed the per-window budget. Glyphs and image fragments
+    // then simply compete within a smaller shared LRU instead of growing VRAM.
+    auto const atlasTextureBytes = [](atlas::AtlasProperties const& p) {
+        auto const size = atlas::computeAtlasSize(p);
+        return unbox<size_t>(size.width) * unbox<size_t>(size.height) * 4; // RGBA
+    };
+    auto constexpr MinAtlasTileCount = uint32_t { 256 };
+    while (_maxTextureMemory != 0 && atlasTextureBytes(atlasProperties) > _maxTextureMemory
+           && atlasProperties.tileCount.value / 2 >= MinAtlasTileCount)
+        atlasProperties.tileCount.value /= 2;
+
+    if (atlasProperties.tileCount.value < _atlasTileCount.value)
+        RendererLog()("Atlas tile count lowered from {} to {} to fit the {} MiB texture memory budget.",
+                      _atlasTileCount.value,
+                      atlasProperties.tileCount.value,
+                      _maxTextureMemory / (1024 * 1024));
+
+    textureAtlas_ = make_unique<Renderable::TextureAtlas>(_renderTarget->commandList(), atlasProperties);
+    _atlasTextureBytes = unbox<size_t>(textureAtlas_->atlasSize().width)
+                         * unbox<size_t>(textureAtlas_->atlasSize().height) * 4;
 
     // clang-format off
     RendererLog()("Configuring texture atlas.\n", atlasProperties);
     RendererLog()("- Atlas properties     : {}\n", atlasProperties);
     RendererLog()("- Atlas texture size   : {} pixels\n", textureAtlas_->atlasSize());
+    RendererLog()("- Atlas texture memory : {} KiB (budget: {} KiB)\n", _atlasTextureBytes / 1024, _maxTextureMemory / 1024);
     RendererLog()("- Atlas hashtable      : {} slots\n", _atlasHashtableSlotCount.value);
     RendererLog()("- Atlas tile count     : {} = {}x * {}y\n", textureAtlas_->capacity(), textureAtlas_->tilesInX(), textureAtlas_->tilesInY());
     RendererLog()("- Atlas direct mapping : {} (for text rendering)", _atlasDirectMapping ? "enabled" : "disabled");
@@ -208,6 +235,33 @@ void Renderer::configureTextureAtlas()
         renderable.get().setTextureAtlas(*textureAtlas_);
 }
 
+void Renderer::setAtlasCacheCapacity(crispy::StrongHashtableSize atlasHashtableSlotCount,
+                                     crispy::LRUCapacity atlasTileCount)
+{
+    // Same clamping rules as at construction time.
+    auto const slotCount = crispy::detail::nextPowerOfTwo(atlasHashtableSlotCount.value);
+    auto const tileCount =
+        std::max(atlasTileCount.value, static_cast<uint32_t>(gridMetrics_.pageSize.area()));
+
+    if (slotCount == _atlasHashtableSlotCount.value && tileCount == _atlasTileCount.value)
+        return;
+
+    LOGSTORE(RendererLog)
+    ("Changing atlas cache capacity: {} -> {} slots, {} -> {} tiles.",
+     _atlasHashtableSlotCount.value, slotCount, _atlasTileCount.value, tileCount);
+
+    _atlasHashtableSlotCount = crispy::StrongHashtableSize { slotCount };
+    _atlasTileCount = crispy::LRUCapacity { tileCount };
+
+    if (!_renderTarget)
+        return;
+
+    // The atlas is replaced wholesale, so every cached tile reference is
+    // stale; all tiles re-rasterize on demand afterwards.
+    configureTextureAtlas();
+    clearCache();
+}
+
 void Renderer::discardImage(Image const& _image)
 {
     // Defer rendering into the renderer thread & render stage, as this call might have
@@ -285,11 +339,28 @@ void Renderer::updateFontMetrics()
     textRenderer_.updateFontMetrics();
     imageRenderer_.setCellSize(cellSize());
 
-    clearCache();
+    // No blanket clearCache() here: the texture atlas has just been
+    // reconstructed (all tiles rasterize anew on demand) and the text
+    // renderer versions its shaping cache by font generation, so wiping it
+    // would only discard entries that zooming back would re-hit.
+    if (_renderTarget)
+    {
+        _renderTarget->clearCache();
+        for (auto& renderable: renderables())
+            if (&renderable.get() != static_cast<Renderable*>(&textRenderer_))
+                renderable.get().clearCache();
+    }
 }
 
 uint64_t Renderer::render(Terminal& _terminal, bool _pressure)
 {
+    CRISPY_PERF_SCOPE("renderer.render");
+
+    // Per-frame temporaries (such as the prewarm text extraction below)
+    // allocate from this arena; recycling it in bulk here keeps steady-state
+    // frames heap-silent (see CRISPY_ALLOCATION_FRAME audits).
+    frameArena_.reset();
+
     gridMetrics_.pageSize = _terminal.pageSize();
 
     auto const changes = _terminal.tick(steady_clock::now());
@@ -300,22 +371,48 @@ uint64_t Renderer::render(Terminal& _terminal, bool _pressure)
     // Windows 10 (ConPTY) workaround. ConPTY can't handle non-blocking I/O,
     // so we have to explicitly refresh the render buffer
     // from within the render (reader) thread instead ofthe terminal (writer) thread.
-    _terminal.refreshRenderBuffer();
+    //
+    // Pure cursor-blink wakeups do not touch the screen. Unless the blink phase
+    // is baked into the cells (block cursor), the previously composed frame can
+    // be reused as-is and only the cursor overlay's visibility changes below.
+    bool const pureBlinkRepaint = !changes && !_terminal.screenDirty()
+                                  && _terminal.renderBufferState() == RenderBufferState::WaitingForRefresh
+                                  && _terminal.cursorShape() != CursorShape::Block;
+    if (!pureBlinkRepaint)
+        _terminal.refreshRenderBuffer();
 #endif // }}}
 
     optional<terminal::RenderCursor> cursorOpt;
+    if (textureAtlas_)
+        textureAtlas_->beginFrame();
     textRenderer_.beginFrame();
     textRenderer_.setPressure(_pressure && _terminal.screen().isPrimaryScreen());
     {
         RenderBufferRef const renderBuffer = _terminal.renderBuffer();
         cursorOpt = renderBuffer.get().cursor;
+        renderLines(renderBuffer.get().lines);
         renderCells(renderBuffer.get().screen);
+        applyFrameDamage(renderBuffer.get());
     }
     textRenderer_.endFrame();
 
-    if (cursorOpt && cursorOpt.value().shape != CursorShape::Block)
+#if !defined(LIBTERMINAL_PASSIVE_RENDER_BUFFER_UPDATE)
+    if (pureBlinkRepaint && cursorOpt)
+    {
+        // The cursor tiles are prebuilt at metric-change time, so the overlay
+        // below is a single instance write - and everything else in this frame
+        // is pixel-identical to what is already on screen (same frame ID,
+        // previously executed). Present only the cursor's row.
+        auto const cursorBottom = gridMetrics_.map(cursorOpt->position).y;
+        _renderTarget->commandList().damage =
+            RenderCommandList::VerticalSpan { cursorBottom, gridMetrics_.cellSize.height };
+    }
+#endif
+
+    if (cursorOpt && cursorOpt.value().shape != CursorShape::Block && _terminal.cursorCurrentlyVisible())
     {
         // Note. Block cursor is implicitly rendered via standard grid cell rendering.
+        // Non-block cursors have their blink phase applied here, at paint time.
         auto const cursor = *cursorOpt;
         cursorRenderer_.setShape(cursor.shape);
         auto const cursorColor = [&]() {
@@ -331,9 +428,187 @@ uint64_t Renderer::render(Terminal& _terminal, bool _pressure)
 
     _renderTarget->execute();
 
+    // Feed the renderer-side cache counters into the session statistics -
+    // but only while someone consumes them, as fetching clears the counters.
+    if (_terminal.statisticsOverlayEnabled())
+    {
+        auto const shaping = textRenderer_.fetchAndClearShapingCacheStats();
+        auto const atlas =
+            textureAtlas_ ? textureAtlas_->fetchAndClearStats() : crispy::LRUHashtableStats {};
+        _terminal.reportRenderCacheStats(
+            Terminal::RenderCacheStats { shaping.hits, shaping.misses, atlas.hits, atlas.misses });
+    }
+
+    // With the frame submitted, borrow the remaining idle time for pre-shaping
+    // the lines the user is scrolling towards - unless we are already under
+    // rendering pressure.
+    if (!_pressure)
+        prewarmScrollAheadLines(_terminal);
+
     return changes;
 }
 
+void Renderer::prewarmScrollAheadLines(Terminal& _terminal)
+{
+    // Pre-shapes the lines just beyond the viewport edge in the direction the
+    // user is scrolling, so upcoming frames start from shaping-cache (and
+    // glyph-atlas) hits instead of shaping every history line the moment it
+    // becomes visible. This runs on the render thread: neither the text
+    // shaper nor its caches are thread-safe, so a background worker would
+    // require per-thread font instances; the idle time between frames is
+    // sufficient, as only cache misses cost anything.
+    auto constexpr PrewarmLineCount = 16;
+
+    auto const scrollOffset = _terminal.viewport().scrollOffset();
+    auto const delta = *scrollOffset - *lastScrollOffset_;
+    lastScrollOffset_ = scrollOffset;
+    if (delta == 0)
+        return;
+
+    // One entry per grid cell; grapheme clusters must stay together per cell,
+    // as the cluster indices fed to the shaper reflect cell boundaries.
+    // This is frame-local scratch, so it all lives in the frame arena.
+    using PrewarmString = crispy::ArenaBasicString<char32_t>;
+    struct PrewarmCell
+    {
+        PrewarmString codepoints;
+        TextStyle style;
+    };
+    auto const cellAlloc = crispy::ArenaAllocator<char32_t>(frameArena_);
+    auto lines = crispy::ArenaVector<crispy::ArenaVector<PrewarmCell>> {
+        crispy::ArenaAllocator<crispy::ArenaVector<PrewarmCell>>(frameArena_)
+    };
+
+    {
+        // The text is copied out under the terminal lock; the actual shaping
+        // below then runs without it.
+        auto const _l = std::lock_guard { _terminal };
+
+        auto const pageLines = unbox<int>(_terminal.screen().pageSize().lines);
+        auto const historyLines = unbox<int>(_terminal.screen().historyLineCount());
+
+        // Scrolling up (increasing offset) reveals lines above the viewport's
+        // top row, which is grid line -scrollOffset; scrolling down reveals
+        // lines below its bottom row.
+        auto const ahead = [&](int n) {
+            return delta > 0 ? -*scrollOffset - n : pageLines - 1 - *scrollOffset + n;
+        };
+
+        for (int n = 1; n <= PrewarmLineCount; ++n)
+        {
+            auto const lineOffset = ahead(n);
+            if (lineOffset < -historyLines || lineOffset >= pageLines)
+                break;
+
+            auto& prewarmLine = lines.emplace_back(crispy::ArenaAllocator<PrewarmCell>(frameArena_));
+            auto const& line = _terminal.screen().grid().lineAt(LineOffset::cast_from(lineOffset));
+            if (line.isTrivialBuffer())
+            {
+                // Do not inflate compact lines just for prewarming; their text
+                // is US-ASCII with one uniform style.
+                auto const style = makeTextStyle(line.trivialBuffer().attributes.styles);
+                for (char const ch: line.trivialBuffer().text)
+                    prewarmLine.push_back(
+                        PrewarmCell { PrewarmString(1, static_cast<char32_t>(ch), cellAlloc), style });
+            }
+            else
+            {
+                for (Cell const& cell: line.cells())
+                {
+                    auto& prewarmCell = prewarmLine.emplace_back(
+                        PrewarmCell { PrewarmString(cellAlloc), makeTextStyle(cell.styles()) });
+                    for (size_t i = 0; i < cell.codepointCount(); ++i)
+                        prewarmCell.codepoints.push_back(cell.codepoint(i));
+                }
+            }
+        }
+    }
+
+    for (auto const& line: lines)
+    {
+        textRenderer_.beginPrewarm();
+        for (auto const& cell: line)
+            textRenderer_.prewarmCell(cell.codepoints, cell.style);
+        textRenderer_.endPrewarm();
+    }
+}
+
+void Renderer::prewarmAtlas(std::vector<std::string> const& _sequences)
+{
+    // Emoji presentation and ZWJ sequences are among the most expensive
+    // first-use glyphs (fallback font probing plus color-layer
+    // rasterization), so shaping a known-common set up front moves that cost
+    // from the first affected frame into startup. Each sequence is fed as a
+    // single cell, matching how the grid stores a cluster, so the cache key
+    // is identical to the rendered case. This runs on the render thread for
+    // the same reason prewarmScrollAheadLines() does: neither the text
+    // shaper nor its caches are thread-safe.
+    for (auto const& sequence: _sequences)
+    {
+        auto const codepoints = unicode::convert_to<char32_t>(std::string_view(sequence));
+        if (codepoints.empty())
+            continue;
+        textRenderer_.beginPrewarm();
+        textRenderer_.prewarmCell(codepoints, TextStyle::Regular);
+        textRenderer_.endPrewarm();
+    }
+}
+
+void Renderer::applyFrameDamage(RenderBuffer const& _renderBuffer)
+{
+    auto& commandList = _renderTarget->commandList();
+    commandList.damage = nullopt;
+    commandList.scroll = nullopt;
+
+    // The buffer's damage range only describes the delta to the directly
+    // preceding composed frame. If that one was never rendered (the triple
+    // buffer may skip frames), the delta does not apply to what is on screen.
+    // Re-rendering the same frame (e.g. cursor blink phases) is fine, as its
+    // damage range always covers the cursor's row.
+    auto const contiguous = _renderBuffer.frameID == lastRenderedFrameID_
+                            || _renderBuffer.frameID == lastRenderedFrameID_ + 1;
+    auto const firstComposition = _renderBuffer.frameID == lastRenderedFrameID_ + 1;
+    lastRenderedFrameID_ = _renderBuffer.frameID;
+
+    if (!contiguous || !_renderBuffer.damagedLineRange.has_value())
+        return;
+
+    auto [first, last] = *_renderBuffer.damagedLineRange;
+    if (first > last) // pixel-identical frame; nothing to compose
+    {
+        commandList.damage = RenderCommandList::VerticalSpan { 0, Height(0) };
+        return;
+    }
+
+    // Expand by one row to each side, as glyphs may overhang their cell box.
+    first = std::max(LineOffset(0), first - 1);
+    last = std::min(boxed_cast<LineOffset>(gridMetrics_.pageSize.lines) - 1, last + 1);
+
+    // GridMetrics::map() yields a cell's bottom-left pixel in the same
+    // bottom-left-origin coordinate system the vertex data is generated for.
+    auto const bottom = gridMetrics_.map(last, ColumnOffset(0)).y;
+    auto const top = gridMetrics_.map(first, ColumnOffset(0)).y + gridMetrics_.cellSize.height.as<int>();
+    commandList.damage = RenderCommandList::VerticalSpan { bottom, Height::cast_from(top - bottom) };
+
+    if (auto const d = _renderBuffer.scrolledRows; d != 0 && firstComposition)
+    {
+        // The viewport scrolled by d rows: rows outside the damage span are
+        // already on screen, but d rows away from where they belong. Publish
+        // the blit shifting them into place; the damage span above then only
+        // covers the newly exposed rows (plus the cursor's). Re-rendering the
+        // same frame must not shift again - the blit already happened.
+        auto const cellHeight = gridMetrics_.cellSize.height.as<int>();
+        auto const firstKept = LineOffset(std::max(0, -d));
+        auto const lastKept = LineOffset(unbox<int>(gridMetrics_.pageSize.lines) - 1 - std::max(0, d));
+        auto const sourceBottom = gridMetrics_.map(lastKept, ColumnOffset(0)).y;
+        auto const sourceTop = gridMetrics_.map(firstKept, ColumnOffset(0)).y + cellHeight;
+        commandList.scroll = RenderCommandList::ScrollBlit {
+            RenderCommandList::VerticalSpan { sourceBottom, Height::cast_from(sourceTop - sourceBottom) },
+            -d * cellHeight
+        };
+    }
+}
+
 tuple<RGBColor, RGBColor> makeColors(ColorPalette const& _colorPalette,
                                      Cell const& _cell,
                                      bool _reverseVideo,
@@ -375,10 +650,24 @@ void Renderer::renderCells(vector<RenderCell> const& _renderableCells)
         if (cell.image)
             imageRenderer_.renderImage(gridMetrics_.map(cell.position), *cell.image);
     }
+    backgroundRenderer_.finish();
+    decorationRenderer_.finish();
+}
+
+void Renderer::renderLines(vector<RenderLine> const& _renderableLines)
+{
+    // RenderLines carry the default background and no decorations by
+    // construction, so only the text renderer has work to do here.
+    for (RenderLine const& line: _renderableLines)
+        textRenderer_.renderLine(line);
 }
 
 void Renderer::inspect(std::ostream& _textOutput) const
 {
+    _textOutput << fmt::format("GPU texture memory: {} KiB used of {} KiB budget\n",
+                               _atlasTextureBytes / 1024,
+                               _maxTextureMemory / 1024);
+    _textOutput << fmt::format("Frame arena high watermark: {} KiB\n", frameArena_.highWatermark() / 1024);
     textureAtlas_->inspect(_textOutput);
     for (auto const& renderable: renderables())
         renderable.get().inspect(_textOutput);
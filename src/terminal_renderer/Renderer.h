@@ -26,6 +26,7 @@
 #include <terminal_renderer/RenderTarget.h>
 #include <terminal_renderer/TextRenderer.h>
 
+#include <crispy/Arena.h>
 #include <crispy/size.h>
 
 #include <fmt/format.h>
@@ -58,6 +59,8 @@ class Renderer
      * @p projectionMatrix   Projection matrix to apply to the rendered scene when rendering the screen.
      * @p atlasDirectMapping Indicates whether or not direct mapped tiles are allowed.
      * @p atlasTileCount     Number of tiles guaranteed to be available in LRU cache.
+     * @p maxTextureMemory   Per-window GPU texture memory budget in bytes; the atlas
+     *                       tile count is clamped down to stay within this bound.
      */
     Renderer(PageSize screenSize,
              FontDescriptions const& fontDescriptions,
@@ -66,6 +69,7 @@ class Renderer
              crispy::StrongHashtableSize atlasHashtableSlotCount,
              crispy::LRUCapacity atlasTileCount,
              bool atlasDirectMapping,
+             size_t maxTextureMemory,
              Decorator hyperlinkNormal,
              Decorator hyperlinkHover);
 
@@ -87,6 +91,11 @@ class Renderer
 
     GridMetrics const& gridMetrics() const noexcept { return gridMetrics_; }
 
+    /// Re-dimensions the texture atlas caches at runtime (e.g. when switching
+    /// performance presets), rebuilding the atlas and clearing dependent caches.
+    void setAtlasCacheCapacity(crispy::StrongHashtableSize atlasHashtableSlotCount,
+                               crispy::LRUCapacity atlasTileCount);
+
     void setHyperlinkDecoration(Decorator _normal, Decorator _hover)
     {
         decorationRenderer_.setHyperlinkDecoration(_normal, _hover);
@@ -108,6 +117,14 @@ class Renderer
      */
     uint64_t render(Terminal& _terminal, bool _pressure);
 
+    /// Shapes and rasterizes the given codepoint sequences (UTF-8 encoded;
+    /// typically emoji presentation and ZWJ sequences) into the glyph atlas
+    /// ahead of their first use, so the first frame showing them starts from
+    /// cache hits instead of color-glyph rasterization.
+    ///
+    /// Must be called after setRenderTarget() and outside of render().
+    void prewarmAtlas(std::vector<std::string> const& _sequences);
+
     void discardImage(Image const& _image);
 
     void clearCache();
@@ -131,12 +148,24 @@ class Renderer
   private:
     void configureTextureAtlas();
     void renderCells(std::vector<RenderCell> const& _renderableCells);
+    void renderLines(std::vector<RenderLine> const& _renderableLines);
+    void applyFrameDamage(RenderBuffer const& _renderBuffer);
+    void prewarmScrollAheadLines(Terminal& _terminal);
     void executeImageDiscards();
 
     crispy::StrongHashtableSize _atlasHashtableSlotCount;
     crispy::LRUCapacity _atlasTileCount;
     bool _atlasDirectMapping;
 
+    // {{{ GPU memory accounting
+    // All tile-based renderables (text, box drawing, decorations, image
+    // fragments) share the one texture atlas, whose LRU provides the eviction
+    // policy under pressure; bounding per-window VRAM therefore reduces to
+    // bounding the atlas texture itself.
+    size_t _maxTextureMemory;
+    size_t _atlasTextureBytes = 0;
+    // }}}
+
     RenderTarget* _renderTarget;
 
     Renderable::DirectMappingAllocator directMappingAllocator_;
@@ -151,6 +180,13 @@ class Renderer
     ColorPalette const& colorPalette_;
     Opacity backgroundOpacity_;
 
+    crispy::Arena frameArena_; //!< bump arena for per-frame temporaries; recycled at the start
+                               //!< of each render() call (see crispy/Arena.h)
+
+    uint64_t lastRenderedFrameID_ = 0;
+    ScrollOffset lastScrollOffset_ {}; //!< scroll position of the previously rendered frame,
+                                       //!< used to detect the scroll direction for prewarming
+
     std::mutex imageDiscardLock_;            //!< Lock guard for accessing discardImageQueue_.
     std::vector<ImageId> discardImageQueue_; //!< List of images to be discarded.
 
@@ -140,6 +140,8 @@ Making use of reserved glyph slots
     #include <text_shaper/coretext_locator.h>
 #endif
 
+#include <crispy/App.h>
+#include <crispy/ThreadPool.h>
 #include <crispy/algorithm.h>
 #include <crispy/assert.h>
 #include <crispy/indexed.h>
@@ -183,24 +185,22 @@ namespace
 {
     constexpr auto FirstReservedChar = 0x21;
     constexpr auto LastReservedChar = 0x7E;
-    constexpr auto DirectMappedCharsCount = LastReservedChar - FirstReservedChar + 1;
+    constexpr auto CharsPerStyleCount = LastReservedChar - FirstReservedChar + 1;
+
+    // One direct-mapped tile range per style font (regular, bold, italic,
+    // bold-italic), so styled US-ASCII resolves without touching the LRU.
+    constexpr auto DirectMappedStylesCount = 4;
+    constexpr auto DirectMappedCharsCount = DirectMappedStylesCount * CharsPerStyleCount;
 
     StrongHash hashGlyphKeyAndPresentation(text::glyph_key const& glyphKey,
                                            unicode::PresentationStyle presentation) noexcept
     {
-        // return StrongHash::compute(key) * static_cast<uint32_t>(presentation);
-        // clang-format off
-        return StrongHash::compute(glyphKey.font.value)
-               * static_cast<uint32_t>(glyphKey.index.value)
-               * StrongHash::compute(glyphKey.size.pt)
-               * static_cast<uint32_t>(presentation)
-               ;
-        // clang-format on
-    }
-
-    StrongHash hashTextAndStyle(u32string_view text, TextStyle style) noexcept
-    {
-        return StrongHash::compute(text) * static_cast<uint32_t>(style);
+        auto builder = crispy::StrongHashBuilder {};
+        builder.update(glyphKey.font.value);
+        builder.update(glyphKey.index.value);
+        builder.update(glyphKey.size.pt);
+        builder.update(static_cast<uint32_t>(presentation));
+        return builder.finalize();
     }
 
     text::font_key getFontForStyle(FontKeys const& _fonts, TextStyle _style)
@@ -277,6 +277,10 @@ unique_ptr<text::font_locator> createFontLocator(FontLocatorEngine _engine)
 // or even computed based on memory resources available?
 constexpr uint32_t TextShapingCacheSize = 4000;
 
+// Covers a few screens worth of distinct lines; beyond that the LRU refills
+// from the shaping cache quickly enough.
+constexpr uint32_t LineLayoutCacheSize = 1024;
+
 TextRenderer::TextRenderer(GridMetrics const& gridMetrics,
                            text::shaper& _textShaper,
                            FontDescriptions& _fontDescriptions,
@@ -287,15 +291,21 @@ TextRenderer::TextRenderer(GridMetrics const& gridMetrics,
     textShapingCache_ { ShapingResultCache::create(crispy::StrongHashtableSize { 16384 },
                                                    crispy::LRUCapacity { TextShapingCacheSize },
                                                    "Text shaping cache") },
+    lineLayoutCache_ { LineLayoutCache::create(crispy::StrongHashtableSize { 4096 },
+                                               crispy::LRUCapacity { LineLayoutCacheSize },
+                                               "Line layout cache") },
     textShaper_ { _textShaper },
     boxDrawingRenderer_ { _gridMetrics }
 {
+    if (crispy::App const* app = crispy::App::instance())
+        glyphCache_ = std::make_shared<PersistentGlyphCache>(app->localStateDir() / "glyph-cache");
 }
 
 void TextRenderer::inspect(ostream& _textOutput) const
 {
     _textOutput << "TextRenderer:\n";
     textShapingCache_->inspect(_textOutput);
+    lineLayoutCache_->inspect(_textOutput);
     boxDrawingRenderer_.inspect(_textOutput);
 }
 
@@ -323,10 +333,48 @@ void TextRenderer::clearCache()
         initializeDirectMapping();
 
     textShapingCache_->clear();
+    lineLayoutCache_->clear();
 
     boxDrawingRenderer_.clearCache();
 }
 
+crispy::StrongHash TextRenderer::directMappingCacheKey(text::font_description const& fontDescription) const
+{
+    auto builder = crispy::StrongHashBuilder {};
+    auto const fontId = fmt::format("{}", fontDescription);
+    builder.update(std::string_view(fontId));
+    builder.update(fontDescriptions_.size.pt);
+    builder.update(fontDescriptions_.dpi.x);
+    builder.update(fontDescriptions_.dpi.y);
+    builder.update(static_cast<uint32_t>(fontDescriptions_.renderMode));
+    return builder.finalize();
+}
+
+void TextRenderer::setDirectMappingFromRasterizedGlyph(size_t styleSlot,
+                                                       char32_t codepoint,
+                                                       text::rasterized_glyph glyph,
+                                                       unicode::PresentationStyle presentation)
+{
+    auto& glyphKeyToTileIndex = _directMappedGlyphKeyToTileIndex[styleSlot];
+    auto const glyphIndex = glyph.index;
+    if (glyphIndex.value >= glyphKeyToTileIndex.size())
+        glyphKeyToTileIndex.resize(glyphIndex.value
+                                   + (LastReservedChar - static_cast<uint32_t>(codepoint) + 1));
+
+    auto const tileIndex =
+        _directMapping.toTileIndex(static_cast<uint32_t>(styleSlot) * CharsPerStyleCount
+                                   + static_cast<uint32_t>(codepoint) - FirstReservedChar);
+    auto const tileLocation = _textureAtlas->tileLocation(tileIndex);
+    auto tileCreateData = createRasterizedGlyph(tileLocation, move(glyph), presentation);
+    if (!tileCreateData)
+        return;
+
+    // Require(tileCreateData->bitmapSize.width <= textureAtlas().tileSize().width);
+
+    _textureAtlas->setDirectMapping(tileIndex, move(*tileCreateData));
+    glyphKeyToTileIndex[glyphIndex.value] = tileIndex;
+}
+
 void TextRenderer::initializeDirectMapping()
 {
     Require(_textureAtlas);
@@ -334,38 +382,81 @@ void TextRenderer::initializeDirectMapping()
 
     auto constexpr presentation = unicode::PresentationStyle::Text;
 
-    _directMappedGlyphKeyToTileIndex.clear();
-    _directMappedGlyphKeyToTileIndex.resize(LastReservedChar + 1);
+    auto const styleFonts = array<text::font_key, DirectMappedStylesCount> {
+        fonts_.regular,
+        fonts_.bold,
+        fonts_.italic,
+        fonts_.boldItalic,
+    };
+    auto const styleFontDescriptions = array<text::font_description const*, DirectMappedStylesCount> {
+        &fontDescriptions_.regular,
+        &fontDescriptions_.bold,
+        &fontDescriptions_.italic,
+        &fontDescriptions_.boldItalic,
+    };
+
+    for (auto& glyphKeyToTileIndex: _directMappedGlyphKeyToTileIndex)
+    {
+        glyphKeyToTileIndex.clear();
+        glyphKeyToTileIndex.resize(LastReservedChar + 1);
+    }
 
-    for (char codepoint = FirstReservedChar; codepoint <= LastReservedChar; ++codepoint)
+    for (size_t styleSlot = 0; styleSlot < DirectMappedStylesCount; ++styleSlot)
     {
-        optional<text::glyph_position> gposOpt = textShaper_.shape(fonts_.regular, codepoint);
-        if (!gposOpt)
+        // A font description resolving to an already direct-mapped font
+        // (e.g. a font family without a dedicated bold-italic face) is
+        // served by the earlier slot; see directMappingSlotForFont().
+        auto const isDuplicateFont = [&]() {
+            for (size_t i = 0; i < styleSlot; ++i)
+                if (styleFonts[i] == styleFonts[styleSlot])
+                    return true;
+            return false;
+        }();
+        if (isDuplicateFont)
             continue;
-        text::glyph_position& gpos = *gposOpt;
 
-        if (gpos.glyph.index.value >= _directMappedGlyphKeyToTileIndex.size())
-            _directMappedGlyphKeyToTileIndex.resize(gpos.glyph.index.value
-                                                    + (LastReservedChar - codepoint + 1));
+        auto const cacheKey = directMappingCacheKey(*styleFontDescriptions[styleSlot]);
 
-        auto const tileIndex = _directMapping.toTileIndex(codepoint - FirstReservedChar);
-        auto const tileLocation = _textureAtlas->tileLocation(tileIndex);
-        auto tileCreateData = createRasterizedGlyph(tileLocation, gpos.glyph, presentation);
-        if (!tileCreateData)
-            continue;
+        // Warm startup: feed the previously persisted bitmaps straight into
+        // the atlas upload queue without touching FreeType at all.
+        if (glyphCache_)
+        {
+            if (auto cachedGlyphs = glyphCache_->load(cacheKey))
+            {
+                for (PersistentGlyphCache::Entry& entry: *cachedGlyphs)
+                    setDirectMappingFromRasterizedGlyph(
+                        styleSlot, entry.codepoint, move(entry.glyph), presentation);
+                continue;
+            }
+        }
+
+        auto cacheEntries = std::vector<PersistentGlyphCache::Entry> {};
+        for (char codepoint = FirstReservedChar; codepoint <= LastReservedChar; ++codepoint)
+        {
+            optional<text::glyph_position> gposOpt = textShaper_.shape(styleFonts[styleSlot], codepoint);
+            if (!gposOpt)
+                continue;
+
+            optional<text::rasterized_glyph> glyphOpt =
+                textShaper_.rasterize(gposOpt->glyph, fontDescriptions_.renderMode);
+            if (!glyphOpt)
+                continue;
 
-        // Require(tileCreateData->bitmapSize.width <= textureAtlas().tileSize().width);
+            if (glyphCache_)
+                cacheEntries.emplace_back(
+                    PersistentGlyphCache::Entry { static_cast<char32_t>(codepoint), *glyphOpt });
 
-        // fmt::print("Initialize direct mapping {} ({}) for {} {}; {}; {}\n",
-        //            tileIndex,
-        //            tileLocation,
-        //            codepoint,
-        //            gpos.glyph,
-        //            tileCreateData->bitmapSize,
-        //            tileCreateData->metadata);
+            setDirectMappingFromRasterizedGlyph(
+                styleSlot, static_cast<char32_t>(codepoint), move(*glyphOpt), presentation);
+        }
 
-        _textureAtlas->setDirectMapping(tileIndex, move(*tileCreateData));
-        _directMappedGlyphKeyToTileIndex[gpos.glyph.index.value] = tileIndex;
+        // Persisting the bitmaps is pure disk I/O and nothing the first
+        // frame needs to wait for; hand it off to the shared pool.
+        if (glyphCache_)
+            crispy::ThreadPool::instance().enqueue(
+                [cache = glyphCache_, cacheKey, entries = move(cacheEntries)]() {
+                    cache->save(cacheKey, entries);
+                });
     }
 }
 
@@ -374,7 +465,18 @@ void TextRenderer::updateFontMetrics()
     if (!renderTargetAvailable())
         return;
 
-    clearCache();
+    // Font changes (size, DPI, style set) bump the shaping-cache generation
+    // instead of wiping the cache: the generation is part of every cluster
+    // hash, so entries of previous generations simply stop being hit and age
+    // out through the LRU. Zooming back to a recently used font size
+    // (Ctrl+scroll) then re-hits its still-cached shaping results instead of
+    // re-shaping the whole view from scratch.
+    ++fontGeneration_;
+
+    if (_textureAtlas && _directMapping)
+        initializeDirectMapping();
+
+    boxDrawingRenderer_.clearCache();
 }
 
 void TextRenderer::beginFrame()
@@ -390,17 +492,7 @@ void TextRenderer::beginFrame()
 
 void TextRenderer::renderCell(RenderCell const& _cell)
 {
-    auto const style = [](auto mask) constexpr->TextStyle
-    {
-        if (contains_all(mask, CellFlags::Bold | CellFlags::Italic))
-            return TextStyle::BoldItalic;
-        if (mask & CellFlags::Bold)
-            return TextStyle::Bold;
-        if (mask & CellFlags::Italic)
-            return TextStyle::Italic;
-        return TextStyle::Regular;
-    }
-    (_cell.flags);
+    auto const style = makeTextStyle(_cell.flags);
 
     auto const& codepoints = _cell.codepoints;
 
@@ -433,11 +525,114 @@ void TextRenderer::renderCell(RenderCell const& _cell)
         flushTextClusterGroup();
 }
 
+void TextRenderer::renderLine(RenderLine const& _line)
+{
+    auto const style = makeTextStyle(_line.flags);
+    auto const lineOrigin = _gridMetrics.map(CellLocation { _line.lineOffset, ColumnOffset(0) });
+
+    // The layout key is position-independent on purpose: scrolling moves a
+    // line to another row, but its cached layout replays unchanged, merely
+    // translated to the new origin.
+    auto hashBuilder = crispy::StrongHashBuilder {};
+    hashBuilder.update(std::string_view(_line.text));
+    hashBuilder.update(static_cast<uint32_t>(style));
+    hashBuilder.update(fontGeneration_);
+    auto const layoutHash = hashBuilder.finalize();
+
+    if (LineLayout const* cachedLayout = lineLayoutCache_->try_get(layoutHash))
+    {
+        if (replayLineLayout(*cachedLayout, lineOrigin, _line.textColor))
+            return;
+        // A referenced atlas tile has been evicted meanwhile; relayout below.
+        lineLayoutCache_->remove(layoutHash);
+    }
+
+    recordedLineLayout_.clear();
+    recordingLineLayout_ = true;
+    lineOrigin_ = lineOrigin;
+
+    // Segment the text into space-separated runs exactly like the RenderCell
+    // path does with its cell groups, so a line yields identical cluster
+    // groups - and thereby identical shaping-cache keys - no matter which of
+    // the two paths emitted it. The text is US-ASCII by RenderLine's
+    // contract, so no box-drawing check is needed.
+    auto column = ColumnOffset(0);
+    for (char const ch: _line.text)
+    {
+        if (ch == 0x20)
+        {
+            if (textClusterGroup_.cellCount)
+                flushTextClusterGroup();
+        }
+        else
+        {
+            if (!textClusterGroup_.cellCount)
+                textClusterGroup_.initialPenPosition =
+                    _gridMetrics.map(CellLocation { _line.lineOffset, column });
+            auto const codepoint = static_cast<char32_t>(static_cast<uint8_t>(ch));
+            appendCellTextToClusterGroup(u32string_view(&codepoint, 1), style, _line.textColor);
+        }
+        ++column;
+    }
+    flushTextClusterGroup();
+
+    recordingLineLayout_ = false;
+    (void) lineLayoutCache_->get_or_emplace(layoutHash,
+                                            [this](auto) { return std::move(recordedLineLayout_); });
+}
+
+bool TextRenderer::replayLineLayout(LineLayout const& _layout, crispy::Point _origin, RGBColor _color)
+{
+    // Two passes: verify first, then emit - so a line whose tiles were
+    // partially evicted never leaves half its glyphs in the command list
+    // before falling back to the full shaping path.
+    for (LineLayoutTile const& tile: _layout)
+        if (!tile.directMappingIndex && !textureAtlas().try_get(tile.atlasHash))
+            return false;
+
+    for (LineLayoutTile const& tile: _layout)
+    {
+        AtlasTileAttributes const& attributes = tile.directMappingIndex
+                                                    ? _textureAtlas->directMapped(tile.directMappingIndex)
+                                                    : *textureAtlas().try_get(tile.atlasHash);
+        renderTile(atlas::RenderTile::X { _origin.x + tile.offset.x },
+                   atlas::RenderTile::Y { _origin.y + tile.offset.y },
+                   _color,
+                   attributes);
+    }
+    return true;
+}
+
 void TextRenderer::endFrame()
 {
     flushTextClusterGroup();
 }
 
+void TextRenderer::beginPrewarm()
+{
+    Require(textClusterGroup_.codepoints.empty());
+    Require(textClusterGroup_.clusters.empty());
+
+    prewarming_ = true;
+    textClusterGroup_.style = TextStyle::Invalid;
+    textClusterGroup_.color = RGBColor {};
+    textStartFound_ = false;
+}
+
+void TextRenderer::prewarmCell(u32string_view _codepoints, TextStyle _style)
+{
+    // Color never contributes to the shaping-cache key, so a fixed one keeps
+    // the grouping (and thereby the key) identical to the rendered case for
+    // uniformly colored text.
+    appendCellTextToClusterGroup(_codepoints, _style, RGBColor {});
+}
+
+void TextRenderer::endPrewarm()
+{
+    flushTextClusterGroup();
+    prewarming_ = false;
+}
+
 Point TextRenderer::applyGlyphPositionToPen(Point pen,
                                             AtlasTileAttributes const& tileAttributes,
                                             text::glyph_position const& gpos) const noexcept
@@ -500,7 +695,7 @@ void TextRenderer::renderRasterizedGlyph(crispy::Point pen,
     // clang-format on
 }
 
-void TextRenderer::appendCellTextToClusterGroup(u32string const& _codepoints,
+void TextRenderer::appendCellTextToClusterGroup(u32string_view _codepoints,
                                                 TextStyle _style,
                                                 RGBColor _color)
 {
@@ -523,6 +718,7 @@ void TextRenderer::appendCellTextToClusterGroup(u32string const& _codepoints,
     {
         textClusterGroup_.codepoints.emplace_back(codepoint);
         textClusterGroup_.clusters.emplace_back(textClusterGroup_.cellCount);
+        textClusterGroup_.hashBuilder.update(codepoint);
     }
     textClusterGroup_.cellCount++;
 }
@@ -536,22 +732,42 @@ void TextRenderer::flushTextClusterGroup()
 
     if (!textClusterGroup_.codepoints.empty())
     {
-        auto hash = hashTextAndStyle(
-            u32string_view(textClusterGroup_.codepoints.data(), textClusterGroup_.codepoints.size()),
-            textClusterGroup_.style);
+        textClusterGroup_.hashBuilder.update(static_cast<uint32_t>(textClusterGroup_.style));
+        textClusterGroup_.hashBuilder.update(fontGeneration_);
+        auto const hash = textClusterGroup_.hashBuilder.finalize();
         text::shape_result const& glyphPositions = getOrCreateCachedGlyphPositions(hash);
         crispy::Point pen = textClusterGroup_.initialPenPosition;
         auto const advanceX = *_gridMetrics.cellSize.width;
 
+        if (prewarming_)
+        {
+            // Cache warming only: resolve the glyphs' atlas metadata - which
+            // rasterizes and uploads them - but emit no render commands.
+            for (text::glyph_position const& glyphPosition: glyphPositions)
+                if (!isGlyphDirectMapped(glyphPosition.glyph))
+                    getOrCreateRasterizedMetadata(
+                        hashGlyphKeyAndPresentation(glyphPosition.glyph, glyphPosition.presentation),
+                        glyphPosition.glyph,
+                        glyphPosition.presentation);
+
+            textClusterGroup_.resetAndMovePenForward(0);
+            textStartFound_ = false;
+            return;
+        }
+
         for (text::glyph_position const& glyphPosition: glyphPositions)
         {
-            if (isGlyphDirectMapped(glyphPosition.glyph))
+            if (auto const directMappingIndex = directMappedTileIndex(glyphPosition.glyph);
+                directMappingIndex != 0)
             {
-                auto const directMappingIndex =
-                    _directMappedGlyphKeyToTileIndex[glyphPosition.glyph.index.value];
                 AtlasTileAttributes const& attributes = _textureAtlas->directMapped(directMappingIndex);
                 auto const pen1 = applyGlyphPositionToPen(pen, attributes, glyphPosition);
                 renderRasterizedGlyph(pen1, textClusterGroup_.color, attributes);
+                if (recordingLineLayout_)
+                    recordedLineLayout_.push_back(
+                        LineLayoutTile { directMappingIndex,
+                                         {},
+                                         crispy::Point { pen1.x - lineOrigin_.x, pen1.y - lineOrigin_.y } });
                 pen.x += static_cast<decltype(pen.x)>(advanceX);
                 continue;
             }
@@ -565,6 +781,11 @@ void TextRenderer::flushTextClusterGroup()
             {
                 auto const pen1 = applyGlyphPositionToPen(pen, *attributes, glyphPosition);
                 renderRasterizedGlyph(pen1, textClusterGroup_.color, *attributes);
+                if (recordingLineLayout_)
+                    recordedLineLayout_.push_back(
+                        LineLayoutTile { 0,
+                                         hash,
+                                         crispy::Point { pen1.x - lineOrigin_.x, pen1.y - lineOrigin_.y } });
 
                 int xOffset = unbox<int>(textureAtlas().tileSize().width);
                 while (AtlasTileAttributes const* subAttribs = textureAtlas().try_get(hash * xOffset))
@@ -573,6 +794,11 @@ void TextRenderer::flushTextClusterGroup()
                                atlas::RenderTile::Y { pen1.y },
                                textClusterGroup_.color,
                                *subAttribs);
+                    if (recordingLineLayout_)
+                        recordedLineLayout_.push_back(LineLayoutTile {
+                            0,
+                            hash * xOffset,
+                            crispy::Point { pen1.x + xOffset - lineOrigin_.x, pen1.y - lineOrigin_.y } });
                     xOffset += unbox<int>(textureAtlas().tileSize().width);
                 }
             }
@@ -693,7 +919,14 @@ auto TextRenderer::createRasterizedGlyph(atlas::TileLocation tileLocation,
     if (!theGlyphOpt.has_value())
         return nullopt;
 
-    text::rasterized_glyph& glyph = theGlyphOpt.value();
+    return createRasterizedGlyph(tileLocation, move(theGlyphOpt.value()), presentation);
+}
+
+auto TextRenderer::createRasterizedGlyph(atlas::TileLocation tileLocation,
+                                         text::rasterized_glyph glyph,
+                                         unicode::PresentationStyle presentation)
+    -> optional<TextureAtlas::TileCreateData>
+{
     Require(glyph.bitmap.size()
             == text::pixel_size(glyph.format) * unbox<size_t>(glyph.bitmapSize.width)
                    * unbox<size_t>(glyph.bitmapSize.height));
@@ -751,7 +984,7 @@ auto TextRenderer::createRasterizedGlyph(atlas::TileLocation tileLocation,
     if (RasterizerLog)
         LOGSTORE(RasterizerLog)(
             "Inserting {} id {} render mode {} {} yOverflow {} yMin {}.",
-            glyph, glyphKey.index, fontDescriptions_.renderMode, presentation, yOverflow, yMin);
+            glyph, glyph.index, fontDescriptions_.renderMode, presentation, yOverflow, yMin);
     // clang-format on
 
     return { createTileData(tileLocation,
@@ -19,6 +19,7 @@
 
 #include <terminal_renderer/BoxDrawingRenderer.h>
 #include <terminal_renderer/FontDescriptions.h>
+#include <terminal_renderer/PersistentGlyphCache.h>
 #include <terminal_renderer/RenderTarget.h>
 #include <terminal_renderer/TextureAtlas.h>
 
@@ -27,6 +28,7 @@
 
 #include <crispy/FNV.h>
 #include <crispy/LRUCache.h>
+#include <crispy/StrongHash.h>
 #include <crispy/point.h>
 #include <crispy/size.h>
 
@@ -36,9 +38,11 @@
 #include <gsl/span>
 #include <gsl/span_ext>
 
+#include <array>
 #include <functional>
 #include <list>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -83,15 +87,51 @@ class TextRenderer: public Renderable
     /// transformed into a RenderCell.
     void renderCell(RenderCell const& _cell);
 
+    /// Renders a whole display row straight from a trivially stored line's
+    /// text (see RenderLine), bypassing the per-cell pipeline.
+    void renderLine(RenderLine const& _line);
+
     /// Must be invoked when rendering the terminal's text has finished for this frame.
     void endFrame();
 
+    // {{{ shaping-cache prewarming
+    //
+    // Feeds text through the regular shaping pipeline - same grouping, same
+    // cache keys - but emits no render commands, merely populating the
+    // shaping cache and the glyph atlas. Used between frames for lines that
+    // are about to scroll into view, so they start from cache hits once they
+    // become visible. Must be called on the render thread (neither the text
+    // shaper nor the caches are thread-safe) and only between endFrame() and
+    // the next beginFrame().
+    void beginPrewarm();
+    void prewarmCell(std::u32string_view _codepoints, TextStyle _style);
+    void endPrewarm();
+    // }}}
+
+    /// Returns and clears the shaping-cache hit/miss counters accumulated
+    /// since the previous call, for session statistics reporting.
+    crispy::LRUHashtableStats fetchAndClearShapingCacheStats() noexcept
+    {
+        return textShapingCache_->fetchAndClearStats();
+    }
+
   private:
     void initializeDirectMapping();
 
+    /// Identifies one style's font configuration (description, size, DPI,
+    /// render mode) for the persistent glyph cache.
+    crispy::StrongHash directMappingCacheKey(text::font_description const& fontDescription) const;
+
+    /// Uploads an already rasterized glyph into its direct-mapped atlas slot
+    /// within the given style's tile range.
+    void setDirectMappingFromRasterizedGlyph(size_t styleSlot,
+                                             char32_t codepoint,
+                                             text::rasterized_glyph glyph,
+                                             unicode::PresentationStyle presentation);
+
     /// Puts a sequence of codepoints that belong to the same grid cell at @p _pos
     /// at the end of the currently filled line.
-    void appendCellTextToClusterGroup(std::u32string const& _codepoints, TextStyle _style, RGBColor _color);
+    void appendCellTextToClusterGroup(std::u32string_view _codepoints, TextStyle _style, RGBColor _color);
 
     /// Gets the text shaping result of the current text cluster group
     text::shape_result const& getOrCreateCachedGlyphPositions(crispy::StrongHash hash);
@@ -116,6 +156,9 @@ class TextRenderer: public Renderable
     std::optional<TextureAtlas::TileCreateData> createRasterizedGlyph(
         atlas::TileLocation tileLocation, text::glyph_key const& id, unicode::PresentationStyle presentation);
 
+    std::optional<TextureAtlas::TileCreateData> createRasterizedGlyph(
+        atlas::TileLocation tileLocation, text::rasterized_glyph glyph, unicode::PresentationStyle presentation);
+
     crispy::Point applyGlyphPositionToPen(crispy::Point pen,
                                           AtlasTileAttributes const& tileAttributes,
                                           text::glyph_position const& gpos) const noexcept;
@@ -132,25 +175,89 @@ class TextRenderer: public Renderable
     // performance optimizations
     //
     bool pressure_ = false;
+    bool prewarming_ = false; //!< suppresses render-command emission (see beginPrewarm())
 
     using ShapingResultCache = crispy::StrongLRUHashtable<text::shape_result>;
     using ShapingResultCachePtr = ShapingResultCache::Ptr;
 
     ShapingResultCachePtr textShapingCache_;
+
+    // {{{ per-line layout cache
+    // Caches the finished glyph placement of whole RenderLines, keyed by text
+    // content, style and font generation - deliberately not by position: tile
+    // offsets are stored relative to the line's origin and the row's pixel
+    // position is applied at draw time. A vertically scrolled line thus
+    // re-renders as a pure translation of its cached run, skipping
+    // segmentation, hashing and shaping-cache lookups altogether.
+    struct LineLayoutTile
+    {
+        uint32_t directMappingIndex = 0; //!< non-zero for direct-mapped atlas tiles
+        crispy::StrongHash atlasHash {}; //!< atlas key for all other tiles
+        crispy::Point offset {};         //!< tile position relative to the line origin
+    };
+    using LineLayout = std::vector<LineLayoutTile>;
+    using LineLayoutCache = crispy::StrongLRUHashtable<LineLayout>;
+
+    /// Replays a cached line layout translated to the given origin, or
+    /// returns false if a referenced atlas tile has been evicted meanwhile.
+    bool replayLineLayout(LineLayout const& _layout, crispy::Point _origin, RGBColor _color);
+
+    LineLayoutCache::Ptr lineLayoutCache_;
+    LineLayout recordedLineLayout_ {};
+    bool recordingLineLayout_ = false;
+    crispy::Point lineOrigin_ {};
+    // }}}
     // TODO: make unique_ptr, get owned, export cref for other users in Renderer impl.
     text::shaper& textShaper_;
 
     DirectMapping _directMapping {};
 
-    // Maps from glyph index to tile index.
-    std::vector<uint32_t> _directMappedGlyphKeyToTileIndex {};
+    // Optional on-disk cache for the direct-mapped glyph bitmaps,
+    // cutting cold-start time to the first painted frame.
+    // Shared, as cache files are written by background pool tasks that
+    // may outlive this renderer.
+    std::shared_ptr<PersistentGlyphCache> glyphCache_;
+
+    // Maps from glyph index to tile index, one table per direct-mapped
+    // style font (slots assigned by directMappingSlotForFont()).
+    std::array<std::vector<uint32_t>, 4> _directMappedGlyphKeyToTileIndex {};
+
+    /// Maps a font to its direct-mapping style slot,
+    /// or std::nullopt if that font is not direct-mapped.
+    std::optional<size_t> directMappingSlotForFont(text::font_key font) const noexcept
+    {
+        if (font == fonts_.regular)
+            return size_t { 0 };
+        if (font == fonts_.bold)
+            return size_t { 1 };
+        if (font == fonts_.italic)
+            return size_t { 2 };
+        if (font == fonts_.boldItalic)
+            return size_t { 3 };
+        return std::nullopt;
+    }
+
+    /// Returns the glyph's direct-mapped tile index, making the dominant
+    /// (ASCII) glyph lookup a bounds check plus an array load.
+    ///
+    /// Returns 0 if the glyph is not direct-mapped (tile index 0 is never
+    /// handed out to direct mappings).
+    uint32_t directMappedTileIndex(text::glyph_key const& glyph) const noexcept
+    {
+        if (!_directMapping) // Is direct mapping enabled?
+            return 0;
+        auto const slot = directMappingSlotForFont(glyph.font);
+        if (!slot)
+            return 0;
+        auto const& tileIndices = _directMappedGlyphKeyToTileIndex[*slot];
+        if (glyph.index.value >= tileIndices.size())
+            return 0;
+        return tileIndices[glyph.index.value];
+    }
 
     bool isGlyphDirectMapped(text::glyph_key const& glyph) const noexcept
     {
-        return _directMapping                  // Is direct mapping enabled?
-               && glyph.font == fonts_.regular // Only regular font is direct-mapped for now.
-               && glyph.index.value < _directMappedGlyphKeyToTileIndex.size()
-               && _directMappedGlyphKeyToTileIndex[glyph.index.value] != 0;
+        return directMappedTileIndex(glyph) != 0;
     }
 
     // sub-renderer
@@ -176,6 +283,10 @@ class TextRenderer: public Renderable
         // cluster indices for each codepoint
         std::vector<unsigned> clusters;
 
+        // shaping-cache key, built incrementally while codepoints are appended,
+        // so flushing does not need a second pass over the text.
+        crispy::StrongHashBuilder hashBuilder {};
+
         // number of grid cells processed
         int cellCount = 0; // FIXME: EA width vs actual cells
 
@@ -183,12 +294,17 @@ class TextRenderer: public Renderable
         {
             codepoints.clear();
             clusters.clear();
+            hashBuilder = crispy::StrongHashBuilder {};
             cellCount = 0;
             initialPenPosition.x += penIncrementInX;
         }
     };
     TextClusterGroup textClusterGroup_ {};
 
+    // Mixed into every shaping-cache key; bumped on font metric changes so
+    // stale entries expire via the LRU instead of an O(n) cache wipe.
+    uint32_t fontGeneration_ = 0;
+
     bool textStartFound_ = false;
     bool forceCellGroupSplit_ = false;
 };
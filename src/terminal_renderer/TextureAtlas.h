@@ -226,6 +226,10 @@ struct TileAttributes
  * Atlas items are LRU-cached and the possibly passed metadata is
  * going to be destroyed at the time of cache eviction.
  *
+ * Because all tiles share one fixed size, the atlas cannot fragment over
+ * time: a full atlas recycles the least recently used tile slot in O(1)
+ * rather than ever requiring a repack or rebuild.
+ *
  * The total number of of cachable tiles should be at least as large
  * as the terminal's cell count per page.
  * More tiles will most likely improve render performance.
@@ -302,6 +306,15 @@ class TextureAtlas
 
     void inspect(std::ostream& output) const;
 
+    // Returns and clears the tile cache's hit/miss counters accumulated
+    // since the previous call, for session statistics reporting.
+    crispy::LRUHashtableStats fetchAndClearStats() noexcept { return _tileCache->fetchAndClearStats(); }
+
+    // Marks the begin of a render frame for frame-coherent eviction: tiles
+    // referenced from now on belong to this frame's working set and are not
+    // recycled in favor of tiles newly created within the same frame.
+    void beginFrame() noexcept { _tileCache->nextGeneration(); }
+
     uint32_t tilesInX() const noexcept { return _tilesInX; }
     uint32_t tilesInY() const noexcept { return _tilesInY; }
 
@@ -448,15 +461,19 @@ inline ImageSize computeAtlasSize(AtlasProperties const& atlasProperties) noexce
     using std::ceil;
     using std::sqrt;
 
-    // clang-format off
-    auto const totalTileCount = crispy::detail::nextPowerOfTwo(1 + atlasProperties.tileCount.value + atlasProperties.directMappingCount);
-    //auto const totalTileCount = atlasProperties.tileCount.value + atlasProperties.directMappingCount;
+    auto const totalTileCount = 1 + atlasProperties.tileCount.value + atlasProperties.directMappingCount;
     auto const squareEdgeCount = static_cast<uint32_t>(ceil(sqrt(totalTileCount)));
-    auto const width = Width::cast_from(crispy::detail::nextPowerOfTwo(static_cast<uint32_t>(
-        squareEdgeCount * unbox<uint32_t>(atlasProperties.tileSize.width))));
-    auto const height = Height::cast_from(crispy::detail::nextPowerOfTwo(static_cast<uint32_t>(
-        squareEdgeCount * unbox<uint32_t>(atlasProperties.tileSize.height))));
-    // clang-format on
+    auto const width = Width::cast_from(crispy::detail::nextPowerOfTwo(
+        squareEdgeCount * unbox<uint32_t>(atlasProperties.tileSize.width)));
+
+    // Rounding the width up to a power of two usually fits more tiles per
+    // row than the square layout assumed, so recompute the number of rows
+    // actually needed before rounding the height as well. A naive square
+    // pow2-rounding on both axes over-allocates texture memory by up to 4x.
+    auto const tilesInX = unbox<uint32_t>(width) / unbox<uint32_t>(atlasProperties.tileSize.width);
+    auto const tilesInY = (totalTileCount + tilesInX - 1) / tilesInX;
+    auto const height = Height::cast_from(
+        crispy::detail::nextPowerOfTwo(tilesInY * unbox<uint32_t>(atlasProperties.tileSize.height)));
 
     // fmt::print("computeAtlasSize: tiles {}+{}={} -> texture size {}x{} (tile size {})\n",
     //            atlasProperties.tileCount,
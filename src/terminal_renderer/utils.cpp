@@ -147,4 +147,27 @@ vector<uint8_t> downsample(vector<uint8_t> const& _sourceBitmap, ImageSize _targ
     return targetBitmap;
 }
 
+vector<uint8_t> buildMinimapImage(gsl::span<terminal::LineDigest const> _digests,
+                                  terminal::ColorPalette const& _palette)
+{
+    auto image = vector<uint8_t> {};
+    image.resize(_digests.size() * 4);
+
+    auto* output = image.data();
+    for (LineDigest const& digest: _digests)
+    {
+        auto const bg = apply(_palette, digest.backgroundColor, ColorTarget::Background, false);
+        auto const fg = apply(_palette, digest.foregroundColor, ColorTarget::Foreground, false);
+        auto const mix = [&](uint8_t a, uint8_t b) {
+            return static_cast<uint8_t>((a * (255 - digest.density) + b * digest.density) / 255);
+        };
+        *output++ = mix(bg.red, fg.red);
+        *output++ = mix(bg.green, fg.green);
+        *output++ = mix(bg.blue, fg.blue);
+        *output++ = 0xFF;
+    }
+
+    return image;
+}
+
 } // namespace terminal::renderer
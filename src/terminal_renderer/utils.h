@@ -13,12 +13,16 @@
  */
 #pragma once
 
+#include <terminal/ColorPalette.h>
+#include <terminal/Line.h>
 #include <terminal/primitives.h>
 
 #include <terminal_renderer/TextureAtlas.h>
 
 #include <crispy/logstore.h>
 
+#include <gsl/span>
+
 namespace terminal::renderer
 {
 
@@ -35,4 +39,13 @@ std::vector<uint8_t> downsample(std::vector<uint8_t> const& _bitmap,
                                 ImageSize _size,
                                 ImageSize _newSize);
 
+/// Renders a minimap strip from per-line digests (see Grid::collectLineDigests):
+/// one RGBA texel per line, blending each line's dominant background towards
+/// its dominant foreground by content density.
+///
+/// The result is meant to be uploaded as a 1xN texture and stretched over the
+/// scrollbar area by the render backend.
+std::vector<uint8_t> buildMinimapImage(gsl::span<terminal::LineDigest const> _digests,
+                                       terminal::ColorPalette const& _palette);
+
 } // namespace terminal::renderer
@@ -2,6 +2,8 @@
 #include <text_shaper/directwrite_shaper.h>
 #include <text_shaper/font_locator.h>
 
+#include <crispy/hash.h>
+
 #include <algorithm>
 #include <string>
 
@@ -118,6 +120,13 @@ struct directwrite_shaper::Private
     std::unordered_map<font_key, DxFontInfo> fonts;
     std::unordered_map<font_key, bool> fontsHasColor;
 
+    // Per-run fallback resolution cache, keyed by (font, codepoints).
+    // Mirrors open_shaper's glyphFallbackCache_: an entry without a font key
+    // is a negative entry ("no installed font covers this run"), so a run
+    // that repeats while scrolling goes through locator resolution and
+    // font-face creation at most once instead of on every shape call.
+    std::unordered_map<uint64_t, std::optional<font_key>> fallbackRunCache_;
+
     font_key nextFontKey;
 
     Private(DPI dpi, std::unique_ptr<font_locator> _locator): dpi_ { dpi }, locator_ { move(_locator) }
@@ -391,17 +400,30 @@ void directwrite_shaper::shape(font_key _font,
             {
                 // glyphIndices contains 0 means some glyphs are missing from the current font.
                 // Need to perform fallback analysis.
+                auto const runCacheKey = crispy::hashCombine(
+                    crispy::hash(std::u32string_view(_text.data(), _text.size())), uint64_t(_font.value));
+
+                if (auto const cached = d->fallbackRunCache_.find(runCacheKey);
+                    cached != d->fallbackRunCache_.end())
+                {
+                    if (!cached->second.has_value())
+                        break; // negative entry: no installed font covers this run
+                    _font = cached->second.value();
+                    fontInfo = d->fonts.at(_font);
+                    fontFace = fontInfo.fontFace;
+                    continue;
+                }
+
+                optional<font_key> fontKeyOpt;
                 font_source_list sources = d->locator_->resolve(gsl::span(_text.data(), _text.size()));
                 if (sources.size() > 0)
+                    fontKeyOpt = d->add_font(sources[0], fontInfo.description, fontInfo.size);
+                d->fallbackRunCache_[runCacheKey] = fontKeyOpt;
+                if (fontKeyOpt.has_value())
                 {
-                    optional<font_key> fontKeyOpt =
-                        d->add_font(sources[0], fontInfo.description, fontInfo.size);
-                    if (fontKeyOpt.has_value())
-                    {
-                        _font = fontKeyOpt.value();
-                        fontInfo = d->fonts.at(_font);
-                        fontFace = fontInfo.fontFace;
-                    }
+                    _font = fontKeyOpt.value();
+                    fontInfo = d->fonts.at(_font);
+                    fontFace = fontInfo.fontFace;
                 }
                 continue;
             }
@@ -592,7 +614,7 @@ void directwrite_shaper::set_locator(std::unique_ptr<font_locator> _locator)
 
 void directwrite_shaper::clear_cache()
 {
-    // TODO: clear the cache
+    d->fallbackRunCache_.clear();
 }
 
 optional<glyph_position> directwrite_shaper::shape(font_key _font, char32_t _codepoint)
@@ -19,7 +19,7 @@
     #undef GLYPH_KEY_DEBUG
 #endif
 
-#include <crispy/FNV.h>
+#include <crispy/hash.h>
 #include <crispy/logstore.h>
 #include <crispy/point.h>
 
@@ -316,10 +316,9 @@ struct hash<text::font_description>
 {
     std::size_t operator()(text::font_description const& fd) const noexcept
     {
-        auto fnv = crispy::FNV<char>();
-        return size_t(
-            fnv(fnv(fnv(fnv(fnv(fd.familyName), char(fd.weight)), char(fd.slant)), char(fd.spacing)),
-                char(fd.strict_spacing)));
+        auto const attributes = uint64_t(fd.weight) | (uint64_t(fd.slant) << 8)
+                                | (uint64_t(fd.spacing) << 16) | (uint64_t(fd.strict_spacing) << 24);
+        return size_t(crispy::hashCombine(crispy::hash(fd.familyName), attributes));
     }
 };
 } // namespace std
@@ -14,19 +14,28 @@
 #include <text_shaper/font.h>
 #include <text_shaper/fontconfig_locator.h>
 
+#include <crispy/App.h>
+#include <crispy/StrongHash.h>
+#include <crispy/stdfs.h>
+
 #include <range/v3/view/iota.hpp>
 
 #include <fontconfig/fontconfig.h>
 
+#include <fstream>
 #include <string_view>
 
+using std::ifstream;
 using std::nullopt;
+using std::ofstream;
 using std::optional;
 using std::string;
 using std::string_view;
 using std::unique_ptr;
 using std::vector;
 
+using namespace std::ios_base;
+
 using namespace std::string_view_literals;
 
 namespace text
@@ -116,17 +125,56 @@ namespace
         }
     }
 
+    constexpr uint32_t ChainCacheMagic = 0x43464E54; // "CFNT"
+    constexpr uint32_t ChainCacheVersion = 1;
+    constexpr uint32_t MaxChainLength = 1024;
+    constexpr uint32_t MaxChainPathLength = 4096;
+
+    template <typename T>
+    void writePod(std::ostream& out, T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        out.write(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    template <typename T>
+    bool readPod(std::istream& in, T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        in.read(reinterpret_cast<char*>(&value), sizeof(value));
+        return static_cast<bool>(in);
+    }
+
 } // namespace
 
 struct fontconfig_locator::Private
 {
-    // currently empty, maybe later something (such as caching)?
     FcConfig* ftConfig = nullptr;
 
+    // Resolved font chains are persisted across runs (one file per queried
+    // font description), stamped with the fontconfig configuration file
+    // mtimes, so warm starts skip fontconfig queries that can take hundreds
+    // of milliseconds on network-mounted homes. An empty cacheDir_ disables
+    // the cache (e.g. when running without a crispy::App context).
+    FileSystem::path cacheDir_;
+    uint64_t configStamp_ = 0;
+
     Private()
     {
         FcInit();
         ftConfig = FcInitLoadConfigAndFonts(); // Most convenient of all the alternatives
+
+        if (crispy::App const* app = crispy::App::instance())
+        {
+            auto cacheDir = app->localStateDir() / "fontconfig-chains";
+            auto ec = FileSystemError {};
+            FileSystem::create_directories(cacheDir, ec);
+            if (!ec)
+            {
+                cacheDir_ = std::move(cacheDir);
+                configStamp_ = computeConfigStamp();
+            }
+        }
     }
 
     ~Private()
@@ -135,6 +183,121 @@ struct fontconfig_locator::Private
         FcConfigDestroy(ftConfig);
         FcFini();
     }
+
+    /// Folds the fontconfig library version and the mtimes of all loaded
+    /// configuration files into one stamp; any configuration change thus
+    /// invalidates every cached chain.
+    uint64_t computeConfigStamp() const
+    {
+        auto stamp = uint64_t { FcGetVersion() };
+        if (FcStrList* files = FcConfigGetConfigFiles(ftConfig))
+        {
+            while (FcChar8* file = FcStrListNext(files))
+            {
+                auto ec = std::error_code {};
+                auto const mtime =
+                    FileSystem::last_write_time(FileSystem::path((char const*) file), ec);
+                if (!ec)
+                    stamp = stamp * 31 + static_cast<uint64_t>(mtime.time_since_epoch().count());
+            }
+            FcStrListDone(files);
+        }
+        return stamp;
+    }
+
+    FileSystem::path chainCachePathFor(font_description const& fd) const
+    {
+        auto builder = crispy::StrongHashBuilder {};
+        builder.update(string_view(fd.familyName));
+        builder.update(static_cast<uint32_t>(fd.weight));
+        builder.update(static_cast<uint32_t>(fd.slant));
+        builder.update(static_cast<uint32_t>(fd.spacing));
+        builder.update(fd.strict_spacing);
+        return cacheDir_ / fmt::format("chain-{}.cache", crispy::to_string(builder.finalize()));
+    }
+
+    optional<font_source_list> loadCachedChain(font_description const& fd) const
+    {
+        if (cacheDir_.empty())
+            return nullopt;
+
+        auto in = ifstream(chainCachePathFor(fd).string(), binary);
+        if (!in)
+            return nullopt;
+
+        auto magic = uint32_t {};
+        auto version = uint32_t {};
+        auto stamp = uint64_t {};
+        auto chainLength = uint32_t {};
+        if (!readPod(in, magic) || !readPod(in, version) || !readPod(in, stamp)
+            || !readPod(in, chainLength))
+            return nullopt;
+        if (magic != ChainCacheMagic || version != ChainCacheVersion || stamp != configStamp_
+            || chainLength > MaxChainLength)
+            return nullopt;
+
+        auto output = font_source_list {};
+        output.reserve(chainLength);
+        for (uint32_t i = 0; i < chainLength; ++i)
+        {
+            auto pathLength = uint32_t {};
+            if (!readPod(in, pathLength) || pathLength > MaxChainPathLength)
+                return nullopt;
+            auto path = string(pathLength, '\0');
+            in.read(path.data(), static_cast<std::streamsize>(pathLength));
+            if (!in)
+                return nullopt;
+
+            // A font file that vanished since the cache was written
+            // invalidates the whole chain; fall back to a live query.
+            auto ec = std::error_code {};
+            if (!FileSystem::exists(FileSystem::path(path), ec) || ec)
+                return nullopt;
+
+            output.emplace_back(font_path { std::move(path) });
+        }
+
+        return { std::move(output) };
+    }
+
+    void saveCachedChain(font_description const& fd, font_source_list const& chain) const
+    {
+        if (cacheDir_.empty() || chain.empty())
+            return;
+
+        for (font_source const& source: chain)
+            if (!std::holds_alternative<font_path>(source))
+                return;
+
+        auto const targetPath = chainCachePathFor(fd);
+        auto const temporaryPath = FileSystem::path(targetPath.string() + ".tmp");
+
+        {
+            auto out = ofstream(temporaryPath.string(), binary | trunc);
+            if (!out)
+                return;
+
+            writePod(out, ChainCacheMagic);
+            writePod(out, ChainCacheVersion);
+            writePod(out, configStamp_);
+            writePod(out, static_cast<uint32_t>(chain.size()));
+
+            for (font_source const& source: chain)
+            {
+                auto const& path = std::get<font_path>(source).value;
+                writePod(out, static_cast<uint32_t>(path.size()));
+                out.write(path.data(), static_cast<std::streamsize>(path.size()));
+            }
+
+            if (!out)
+                return;
+        }
+
+        auto ec = FileSystemError {};
+        FileSystem::rename(temporaryPath, targetPath, ec);
+        if (ec)
+            FileSystem::remove(temporaryPath, ec);
+    }
 };
 
 fontconfig_locator::fontconfig_locator():
@@ -150,6 +313,13 @@ fontconfig_locator::~fontconfig_locator()
 
 font_source_list fontconfig_locator::locate(font_description const& _fd)
 {
+    if (auto cachedChain = d->loadCachedChain(_fd))
+    {
+        LOGSTORE(LocatorLog)
+        ("Located font chain for {} from cache ({} entries).", _fd, cachedChain->size());
+        return std::move(*cachedChain);
+    }
+
     LOGSTORE(LocatorLog)("Locating font chain for: {}", _fd);
     auto pat =
         unique_ptr<FcPattern, void (*)(FcPattern*)>(FcPatternCreate(), [](auto p) { FcPatternDestroy(p); });
@@ -280,6 +450,8 @@ font_source_list fontconfig_locator::locate(font_description const& _fd)
     #undef FONTDIR
 #endif
 
+    d->saveCachedChain(_fd, output);
+
     return output;
 }
 
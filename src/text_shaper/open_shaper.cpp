@@ -15,8 +15,11 @@
 #include <text_shaper/font_locator.h>
 #include <text_shaper/open_shaper.h>
 
+#include <crispy/StrongHash.h>
+#include <crispy/StrongLRUHashtable.h>
 #include <crispy/algorithm.h>
 #include <crispy/assert.h>
+#include <crispy/hash.h>
 #include <crispy/indexed.h>
 #include <crispy/times.h>
 
@@ -34,6 +37,7 @@
 #include <fontconfig/fontconfig.h>
 
 #include <harfbuzz/hb-ft.h>
+#include <harfbuzz/hb-ot.h>
 #include <harfbuzz/hb.h>
 
 #include <algorithm>
@@ -94,8 +98,8 @@ struct hash<FontPathAndSize>
 {
     size_t operator()(FontPathAndSize const& fd) const noexcept
     {
-        auto fnv = crispy::FNV<char>();
-        return size_t(fnv(fnv(fd.path), to_string(fd.size.pt))); // SSO should kick in.
+        return size_t(crispy::hashCombine(crispy::hash(fd.path),
+                                          crispy::hash(&fd.size.pt, sizeof(fd.size.pt))));
     }
 };
 } // namespace std
@@ -109,6 +113,11 @@ using FtFacePtr = unique_ptr<FT_FaceRec_, void (*)(FT_FaceRec_*)>;
 
 auto constexpr MissingGlyphId = 0xFFFDu;
 
+// Printable US-ASCII range eligible for the certified simple-run fast path.
+auto constexpr FirstSimpleChar = char32_t { 0x20 };
+auto constexpr LastSimpleChar = char32_t { 0x7E };
+auto constexpr SimpleCharsCount = size_t { LastSimpleChar - FirstSimpleChar + 1 };
+
 struct HbFontInfo
 {
     font_source primary;
@@ -118,6 +127,19 @@ struct HbFontInfo
     HbFontPtr hbFont;
     std::optional<font_metrics> metrics {};
     font_description description {};
+    // Font features translated to harfbuzz representation once at load time,
+    // so steady-state shaping does not rebuild this vector per run.
+    std::vector<hb_feature_t> hbFeatures {};
+
+    // Simple-run certification state, determined once on the first shape
+    // request for this face: std::nullopt until then, afterwards whether
+    // printable-ASCII runs may bypass harfbuzz entirely
+    // (see Private::isSimpleRunCertified()).
+    std::optional<bool> simpleRunCertified {};
+
+    // Glyph index per printable-ASCII codepoint (offset by FirstSimpleChar);
+    // only valid when simpleRunCertified holds true.
+    std::array<glyph_index, SimpleCharsCount> simpleGlyphIndices {};
 };
 
 namespace
@@ -160,6 +182,40 @@ namespace
         return _gp.glyph.index.value == 0;
     }
 
+    constexpr bool isSimpleAsciiRun(u32string_view _codepoints) noexcept
+    {
+        for (char32_t const codepoint: _codepoints)
+            if (codepoint < FirstSimpleChar || codepoint > LastSimpleChar)
+                return false;
+        return true;
+    }
+
+    // Checks whether the face carries any GSUB feature that may substitute
+    // glyphs within a plain ASCII run (think programming ligatures such as
+    // "->" or "=>"). Faces with such features must keep going through
+    // harfbuzz unconditionally.
+    bool hasSubstitutionsForSimpleRuns(hb_face_t* _hbFace)
+    {
+        auto constexpr SubstitutionFeatures = std::array<hb_tag_t, 5> {
+            HB_TAG('c', 'a', 'l', 't'), HB_TAG('c', 'l', 'i', 'g'), HB_TAG('d', 'l', 'i', 'g'),
+            HB_TAG('l', 'i', 'g', 'a'), HB_TAG('r', 'l', 'i', 'g'),
+        };
+
+        auto tags = std::array<hb_tag_t, 32> {};
+        auto offset = 0u;
+        while (true)
+        {
+            auto count = static_cast<unsigned>(tags.size());
+            hb_ot_layout_table_get_feature_tags(_hbFace, HB_OT_TAG_GSUB, offset, &count, tags.data());
+            for (auto const i: iota(0u, count))
+                if (ranges::any_of(SubstitutionFeatures, [&](hb_tag_t tag) { return tag == tags[i]; }))
+                    return true;
+            if (count < tags.size())
+                return false;
+            offset += count;
+        }
+    }
+
     constexpr int fcWeight(font_weight _weight) noexcept
     {
         switch (_weight)
@@ -401,18 +457,22 @@ namespace
 
         prepareBuffer(_hbBuf, _codepoints, _clusters, _script);
 
-        vector<hb_feature_t> hbFeatures;
-        for (font_feature const feature: _fontInfo.description.features)
-        {
-            hb_feature_t hbFeature;
-            hbFeature.tag = HB_TAG(feature.name[0], feature.name[1], feature.name[2], feature.name[3]);
-            hbFeature.value = 1;
-            hbFeature.start = 0;
-            hbFeature.end = HB_FEATURE_GLOBAL_END;
-            hbFeatures.emplace_back(hbFeature);
-        }
-
-        hb_shape(_hbFont, _hbBuf, hbFeatures.data(), static_cast<unsigned int>(hbFeatures.size()));
+        vector<hb_feature_t> const& hbFeatures = _fontInfo.hbFeatures;
+
+        // Shape through harfbuzz's shape-plan cache (keyed per face by script,
+        // direction, language, and shaper selection), so the OpenType lookup
+        // accelerator structures are constructed once per (font, script) rather
+        // than on every shape call.
+        hb_segment_properties_t segmentProperties {};
+        hb_buffer_get_segment_properties(_hbBuf, &segmentProperties);
+        hb_shape_plan_t* shapePlan = hb_shape_plan_create_cached(hb_font_get_face(_hbFont),
+                                                                 &segmentProperties,
+                                                                 hbFeatures.data(),
+                                                                 static_cast<unsigned int>(hbFeatures.size()),
+                                                                 nullptr);
+        hb_shape_plan_execute(
+            shapePlan, _hbFont, _hbBuf, hbFeatures.data(), static_cast<unsigned int>(hbFeatures.size()));
+        hb_shape_plan_destroy(shapePlan);
         hb_buffer_normalize_glyphs(_hbBuf); // TODO: lookup again what this one does
 
         auto const glyphCount = hb_buffer_get_length(_hbBuf);
@@ -462,6 +522,21 @@ struct open_shaper::Private // {{{
     HbBufferPtr hb_buf_;
     font_key nextFontKey_;
 
+    // Shaped-word cache, shared across all lines and columns, so that a
+    // token that repeats all over the scrollback (think "INFO" or
+    // timestamps) passes through harfbuzz exactly once per session.
+    // Keyed by (font, script, presentation, codepoints, clusters);
+    // sized in entries, not rows.
+    using ShapedWordCache = crispy::StrongLRUHashtable<shape_result>;
+    ShapedWordCache::Ptr shapedWords_;
+    size_t shapedWordLookups_ = 0;
+
+    // Per-codepoint fallback resolution cache, keyed by (font, codepoint).
+    // A zero glyph index is a negative entry ("no face maps this codepoint"),
+    // preventing a rare codepoint from re-probing - and potentially
+    // re-loading - every fallback face on each occurrence.
+    unordered_map<uint64_t, glyph_index> glyphFallbackCache_;
+
     font_key create_font_key()
     {
         auto result = nextFontKey_;
@@ -524,6 +599,52 @@ struct open_shaper::Private // {{{
         return output;
     }
 
+    bool isSimpleRunCertified(font_key _font, HbFontInfo& _fontInfo)
+    {
+        if (!_fontInfo.simpleRunCertified.has_value())
+            _fontInfo.simpleRunCertified = certifySimpleRuns(_font, _fontInfo);
+        return _fontInfo.simpleRunCertified.value();
+    }
+
+    // Certifies that printable-ASCII runs shape to exactly one glyph per
+    // codepoint with uniform advances on this face, i.e. that full harfbuzz
+    // shaping could only be observed through ligature or contextual
+    // substitutions - which this face does not carry. Certified runs then
+    // map straight from codepoint to glyph index (see shape()).
+    bool certifySimpleRuns(font_key _font, HbFontInfo& _fontInfo)
+    {
+        FT_Face ftFace = _fontInfo.ftFace.get();
+
+        // User-requested font features must keep going through harfbuzz.
+        if (!_fontInfo.hbFeatures.empty())
+            return false;
+
+        if (FT_HAS_COLOR(ftFace))
+            return false;
+
+        if (hasSubstitutionsForSimpleRuns(hb_font_get_face(_fontInfo.hbFont.get())))
+            return false;
+
+        // Verify glyph presence and advance uniformity across all printable
+        // ASCII, so the synthesized positions are identical to what harfbuzz
+        // would have produced.
+        auto const expectedAdvance = metrics(_font).advance;
+        for (char32_t codepoint = FirstSimpleChar; codepoint <= LastSimpleChar; ++codepoint)
+        {
+            auto const glyphIndex = FT_Get_Char_Index(ftFace, codepoint);
+            if (!glyphIndex)
+                return false;
+            if (FT_Load_Glyph(ftFace, glyphIndex, FT_LOAD_DEFAULT) != FT_Err_Ok)
+                return false;
+            if (int(ceil(double(ftFace->glyph->metrics.horiAdvance) / 64.0)) != expectedAdvance)
+                return false;
+            _fontInfo.simpleGlyphIndices[codepoint - FirstSimpleChar] = glyph_index { glyphIndex };
+        }
+
+        LocatorLog()("Certified monospace fast path for {}.", _fontInfo.description);
+        return true;
+    }
+
     Private(DPI _dpi, unique_ptr<font_locator> _locator):
         ftCleanup_ { [this]() {
             FT_Done_FreeType(ft_);
@@ -532,7 +653,9 @@ struct open_shaper::Private // {{{
         locator_ { move(_locator) },
         dpi_ { _dpi },
         hb_buf_(hb_buffer_create(), [](auto p) { hb_buffer_destroy(p); }),
-        nextFontKey_ {}
+        nextFontKey_ {},
+        shapedWords_ { ShapedWordCache::create(
+            crispy::StrongHashtableSize { 8192 }, crispy::LRUCapacity { 4096 }, "Shaped words") }
     {
         if (auto const ec = FT_Init_FreeType(&ft_); ec != FT_Err_Ok)
             throw runtime_error { "freetype: Failed to initialize. "s + ftErrorStr(ec) };
@@ -598,6 +721,22 @@ struct open_shaper::Private // {{{
 
         return false;
     }
+
+    void cacheShapedWord(crispy::StrongHash const& _hash, shape_result const& _result, size_t _offset)
+    {
+        shapedWords_->emplace(
+            _hash, shape_result(std::next(_result.begin(), static_cast<long>(_offset)), _result.end()));
+    }
+
+    void logShapedWordCacheStatsPeriodically()
+    {
+        auto constexpr StatsInterval = size_t { 0x10000 };
+        if (++shapedWordLookups_ % StatsInterval == 0 && TextShapingLog)
+        {
+            auto const stats = shapedWords_->fetchAndClearStats();
+            LOGSTORE(TextShapingLog)("Shaped-word cache: {}", stats);
+        }
+    }
 }; // }}}
 
 open_shaper::open_shaper(DPI _dpi, unique_ptr<font_locator> _locator):
@@ -622,6 +761,8 @@ void open_shaper::clear_cache()
 {
     d->fonts_.clear();
     d->fontPathSizeToKeys.clear();
+    d->shapedWords_->clear();
+    d->glyphFallbackCache_.clear();
 }
 
 optional<font_key> open_shaper::load_font(font_description const& _description, font_size _size)
@@ -640,6 +781,17 @@ optional<font_key> open_shaper::load_font(font_description const& _description,
     fontInfo.fallbacks = move(sources);
     fontInfo.description = _description;
 
+    fontInfo.hbFeatures.clear();
+    for (font_feature const feature: _description.features)
+    {
+        hb_feature_t hbFeature;
+        hbFeature.tag = HB_TAG(feature.name[0], feature.name[1], feature.name[2], feature.name[3]);
+        hbFeature.value = 1;
+        hbFeature.start = 0;
+        hbFeature.end = HB_FEATURE_GLOBAL_END;
+        fontInfo.hbFeatures.emplace_back(hbFeature);
+    }
+
     return fontKeyOpt;
 }
 
@@ -658,19 +810,29 @@ optional<glyph_position> open_shaper::shape(font_key _font, char32_t _codepoint)
 {
     HbFontInfo& fontInfo = d->fonts_.at(_font);
 
-    glyph_index glyphIndex { FT_Get_Char_Index(fontInfo.ftFace.get(), _codepoint) };
-    if (!glyphIndex.value)
+    auto const fallbackCacheKey = (uint64_t(_font.value) << 32) | uint64_t(_codepoint);
+
+    glyph_index glyphIndex {};
+    if (auto const cached = d->glyphFallbackCache_.find(fallbackCacheKey);
+        cached != d->glyphFallbackCache_.end())
+        glyphIndex = cached->second;
+    else
     {
-        for (font_source const& fallbackFont: fontInfo.fallbacks)
+        glyphIndex = glyph_index { FT_Get_Char_Index(fontInfo.ftFace.get(), _codepoint) };
+        if (!glyphIndex.value)
         {
-            optional<font_key> fallbackKeyOpt = d->get_font_key_for(fallbackFont, fontInfo.size);
-            if (!fallbackKeyOpt.has_value())
-                continue;
-            HbFontInfo const& fallbackFontInfo = d->fonts_.at(fallbackKeyOpt.value());
-            glyphIndex = glyph_index { FT_Get_Char_Index(fallbackFontInfo.ftFace.get(), _codepoint) };
-            if (glyphIndex.value)
-                break;
+            for (font_source const& fallbackFont: fontInfo.fallbacks)
+            {
+                optional<font_key> fallbackKeyOpt = d->get_font_key_for(fallbackFont, fontInfo.size);
+                if (!fallbackKeyOpt.has_value())
+                    continue;
+                HbFontInfo const& fallbackFontInfo = d->fonts_.at(fallbackKeyOpt.value());
+                glyphIndex = glyph_index { FT_Get_Char_Index(fallbackFontInfo.ftFace.get(), _codepoint) };
+                if (glyphIndex.value)
+                    break;
+            }
         }
+        d->glyphFallbackCache_[fallbackCacheKey] = glyphIndex;
     }
     if (!glyphIndex.value)
         return nullopt;
@@ -696,6 +858,47 @@ void open_shaper::shape(font_key _font,
     assert(_clusters.size() == _codepoints.size());
 
     HbFontInfo& fontInfo = d->fonts_.at(_font);
+
+    // Certified monospace fast path: on a face verified to shape
+    // printable-ASCII runs 1:1 with uniform advances, go straight from
+    // codepoint to glyph index - no harfbuzz, no shaped-word cache probe.
+    if (_presentation == unicode::PresentationStyle::Text && isSimpleAsciiRun(_codepoints)
+        && d->isSimpleRunCertified(_font, fontInfo))
+    {
+        auto const advance = metrics(_font).advance;
+        for (char32_t const codepoint: _codepoints)
+        {
+            glyph_position gpos {};
+            gpos.glyph =
+                glyph_key { fontInfo.size, _font, fontInfo.simpleGlyphIndices[codepoint - FirstSimpleChar] };
+#if defined(GLYPH_KEY_DEBUG)
+            gpos.glyph.text = std::u32string(1, codepoint);
+#endif
+            gpos.advance.x = advance;
+            gpos.presentation = _presentation;
+            _result.emplace_back(gpos);
+        }
+        return;
+    }
+
+    auto hashBuilder = crispy::StrongHashBuilder {};
+    hashBuilder.update(_font.value);
+    hashBuilder.update(static_cast<uint32_t>(_script));
+    hashBuilder.update(static_cast<uint32_t>(_presentation));
+    hashBuilder.update(_codepoints);
+    hashBuilder.update(_clusters.data(), _clusters.size() * sizeof(unsigned));
+    auto const wordHash = hashBuilder.finalize();
+
+    d->logShapedWordCacheStatsPeriodically();
+
+    if (shape_result const* cachedWord = d->shapedWords_->try_get(wordHash))
+    {
+        _result.insert(_result.end(), cachedWord->begin(), cachedWord->end());
+        return;
+    }
+
+    auto const initialResultOffset = _result.size();
+
     hb_font_t* hbFont = fontInfo.hbFont.get();
     hb_buffer_t* hbBuf = d->hb_buf_.get();
 
@@ -711,7 +914,10 @@ void open_shaper::shape(font_key _font,
 
     if (d->tryShapeWithFallback(
             _font, fontInfo, hbBuf, hbFont, _script, _presentation, _codepoints, _clusters, _result))
+    {
+        d->cacheShapedWord(wordHash, _result, initialResultOffset);
         return;
+    }
 
     LOGSTORE(TextShapingLog)("Shaping failed.");
 
@@ -752,6 +958,9 @@ void open_shaper::shape(font_key _font,
 
     // last resort
     replaceMissingGlyphs(fontInfo.ftFace.get(), _result);
+
+    // The per-cluster reshaping above cleared _result, hence offset 0.
+    d->cacheShapedWord(wordHash, _result, 0);
 }
 
 optional<rasterized_glyph> open_shaper::rasterize(glyph_key _glyph, render_mode _mode)